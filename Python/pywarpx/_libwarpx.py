@@ -110,6 +110,9 @@ else:
 
 dim = libwarpx.warpx_SpaceDim()
 
+libwarpx.warpx_UseGpu.restype = ctypes.c_int
+use_gpu = bool(libwarpx.warpx_UseGpu())
+
 # our particle data type, depends on _ParticleReal_size
 _p_struct = [(d, _numpy_particlereal_dtype) for d in 'xyz'[:dim]] + [('id', 'i4'), ('cpu', 'i4')]
 _p_dtype = np.dtype(_p_struct, align=True)
@@ -151,12 +154,78 @@ def _array1d_from_pointer(pointer, dtype, size):
     return np.frombuffer(buf, dtype=dtype, count=size)
 
 
+class DeviceArray(object):
+    """
+    View of an array in the memory of WarpX, without copy, that exposes the CUDA array
+    interface, so that GPU libraries can work on it in place on the device,
+    e.g. cupy.asarray(a), torch.as_tensor(a, device='cuda') or numba.cuda.as_cuda_array(a).
+
+    Parameters
+    ----------
+
+        pointer : address of the first element
+        dtype   : numpy dtype of the elements
+        shape   : shape of the array
+        strides : strides of the array in bytes (None for a contiguous C-order array)
+    """
+    def __init__(self, pointer, dtype, shape, strides=None):
+        self.pointer = pointer
+        self.dtype = np.dtype(dtype)
+        self.shape = tuple(shape)
+        self.strides = None if strides is None else tuple(strides)
+
+    @property
+    def __cuda_array_interface__(self):
+        return {'shape': self.shape,
+                'typestr': self.dtype.str,
+                'descr': self.dtype.descr,
+                'data': (self.pointer, False),
+                'strides': self.strides,
+                'version': 2}
+
+    def __len__(self):
+        return self.shape[0]
+
+
+def _device_array_from_pointer(pointer, dtype, shape, fortran_order=False, lo_offset=None):
+    """
+    Make a DeviceArray of the memory at pointer, of the given shape.
+    With fortran_order, the array is in Fortran order, like an AMReX FArrayBox.
+    With lo_offset, the view starts lo_offset[d] elements after the start along the
+    direction d, and stops as many elements before the end.
+    """
+    dtype = np.dtype(dtype)
+    address = ctypes.cast(pointer, ctypes.c_void_p).value or 0
+    strides = []
+    stride = dtype.itemsize
+    for n in (shape if fortran_order else shape[::-1]):
+        strides.append(stride)
+        stride *= n
+    if not fortran_order:
+        strides = strides[::-1]
+    shape = list(shape)
+    if lo_offset is not None:
+        for d, n in enumerate(lo_offset):
+            address += n*strides[d]
+            shape[d] -= 2*n
+    return DeviceArray(address, dtype, shape, strides)
+
+
 # set the arg and return types of the wrapped functions
 libwarpx.amrex_init.argtypes = (ctypes.c_int, _LP_LP_c_char)
 libwarpx.amrex_init_with_inited_mpi.argtypes = (ctypes.c_int, _LP_LP_c_char, _MPI_Comm_type)
 libwarpx.warpx_getParticleStructs.restype = _LP_particle_p
 libwarpx.warpx_getParticleArrays.restype = _LP_LP_c_particlereal
 libwarpx.warpx_getParticleCompIndex.restype = ctypes.c_int
+libwarpx.warpx_getParticleTileOffsets.restype = ctypes.c_long
+libwarpx.warpx_gatherParticleArrays.restype = ctypes.c_long
+libwarpx.warpx_gatherParticleArrays.argtypes = (ctypes.c_char_p, ctypes.c_int, ctypes.c_int,
+                                                 ctypes.POINTER(ctypes.c_char_p), ctypes.c_void_p,
+                                                 ctypes.c_long, ctypes.c_int)
+libwarpx.warpx_scatterParticleArrays.restype = ctypes.c_long
+libwarpx.warpx_scatterParticleArrays.argtypes = (ctypes.c_char_p, ctypes.c_int, ctypes.c_int,
+                                                  ctypes.POINTER(ctypes.c_char_p), ctypes.c_void_p,
+                                                  ctypes.c_long, ctypes.c_int)
 libwarpx.warpx_getEfield.restype = _LP_LP_c_real
 libwarpx.warpx_getEfieldLoVects.restype = _LP_c_int
 libwarpx.warpx_getEfieldCP.restype = _LP_LP_c_real
@@ -213,6 +282,7 @@ libwarpx.warpx_getParticleBoundaryBufferSize.restype = ctypes.c_int
 libwarpx.warpx_getParticleBoundaryBufferStructs.restype = _LP_LP_c_particlereal
 libwarpx.warpx_getParticleBoundaryBuffer.restype = _LP_LP_c_particlereal
 libwarpx.warpx_getParticleBoundaryBufferScrapedSteps.restype = _LP_LP_c_int
+libwarpx.warpx_getParticleBoundaryBufferHistogramBins.restype = ctypes.c_int
 
 libwarpx.warpx_getEx_nodal_flag.restype = _LP_c_int
 libwarpx.warpx_getEy_nodal_flag.restype = _LP_c_int
@@ -243,6 +313,12 @@ libwarpx.warpx_addNParticles.argtypes = (ctypes.c_char_p, ctypes.c_int,
                                          ctypes.c_int,
                                          _ndpointer(c_particlereal, flags="C_CONTIGUOUS"),
                                          ctypes.c_int)
+libwarpx.warpx_addNParticlesFromDevice.argtypes = (ctypes.c_char_p, ctypes.c_int,
+                                                   ctypes.c_void_p, ctypes.c_void_p,
+                                                   ctypes.c_void_p, ctypes.c_void_p,
+                                                   ctypes.c_void_p, ctypes.c_void_p,
+                                                   ctypes.c_void_p, ctypes.c_int,
+                                                   _LP_c_void_p)
 
 libwarpx.warpx_getProbLo.restype = c_real
 libwarpx.warpx_getProbHi.restype = c_real
@@ -506,6 +582,77 @@ def add_particles(species_name, x=None, y=None, z=None, ux=None, uy=None, uz=Non
     )
 
 
+def _get_array_pointer(arr, size):
+    """
+    Address of the data of arr, which must be a contiguous array of size elements of
+    ParticleReal, in device memory (exposing the CUDA array interface, like CuPy arrays
+    or the DeviceArrays of this module) or in host memory for CPU builds (numpy arrays).
+    """
+    if hasattr(arr, '__cuda_array_interface__'):
+        interface = arr.__cuda_array_interface__
+        assert np.dtype(interface['typestr']) == np.dtype(_numpy_particlereal_dtype), \
+            "The particle arrays must have the ParticleReal type"
+        assert interface.get('strides') is None or \
+            tuple(interface['strides']) == (np.dtype(_numpy_particlereal_dtype).itemsize,), \
+            "The particle arrays must be contiguous"
+        assert int(np.prod(interface['shape'])) == size, "Length of the arrays do not match"
+        return interface['data'][0]
+    assert not use_gpu, "With GPUs, the particle arrays must be in device memory"
+    assert isinstance(arr, np.ndarray) and arr.dtype == np.dtype(_numpy_particlereal_dtype) \
+        and arr.flags['C_CONTIGUOUS'], "The particle arrays must have the ParticleReal type"
+    assert arr.size == size, "Length of the arrays do not match"
+    return arr.ctypes.data
+
+
+def add_particles_from_device(species_name, x, y, z, ux, uy, uz, w, **kwargs):
+    '''
+
+    A function for adding particles to the WarpX simulation from arrays in
+    device memory, without copy to the host: the particles are written to the
+    particle tiles on the device and their ids are allocated in bulk.
+    Each process adds its own particles, and all processes must call this function.
+
+    Parameters
+    ----------
+
+    species_name     : the species to add the particle to
+    x, y, z          : arrays of the particle positions
+    ux, uy, uz       : arrays of the particle momenta
+    w                : array of the particle weights
+    kwargs           : dictionary containing an entry for the extra particle
+                       attribute arrays. The attributes that are not given
+                       are set to 0.
+
+    All the arrays must be contiguous, of the ParticleReal type, and expose the
+    CUDA array interface (e.g. CuPy arrays) on GPU, or be numpy arrays otherwise.
+
+    '''
+
+    if hasattr(w, '__cuda_array_interface__'):
+        n = int(np.prod(w.__cuda_array_interface__['shape']))
+    else:
+        n = np.size(w)
+    pointers = [_get_array_pointer(arr, n) for arr in (x, y, z, ux, uy, uz, w)]
+
+    # --- The runtime attributes are passed in the order of their components, up to
+    # --- the last one that is given; a null pointer means that the attribute is set to 0.
+    first_runtime = libwarpx.warpx_nComps()
+    attr_arrays = {}
+    for key, val in kwargs.items():
+        comp = get_particle_comp_index(species_name, key)
+        assert comp >= first_runtime, "Only the runtime attributes can be given in kwargs"
+        attr_arrays[comp - first_runtime] = val
+    nattr = max(attr_arrays) + 1 if attr_arrays else 0
+    attr = (ctypes.c_void_p*max(nattr, 1))()
+    for i, val in attr_arrays.items():
+        attr[i] = _get_array_pointer(val, n)
+
+    libwarpx.warpx_addNParticlesFromDevice(
+        ctypes.c_char_p(species_name.encode('utf-8')), n,
+        *pointers, nattr, ctypes.cast(attr, _LP_c_void_p)
+    )
+
+
 def get_particle_count(species_name):
     '''
 
@@ -528,7 +675,7 @@ def get_particle_count(species_name):
     )
 
 
-def get_particle_structs(species_name, level):
+def get_particle_structs(species_name, level, device=False):
     '''
 
     This returns a list of numpy arrays containing the particle struct data
@@ -542,11 +689,13 @@ def get_particle_structs(species_name, level):
     ----------
 
         species_name : the species name that the data will be returned for
+        level        : the refinement level
+        device       : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
 
-        A List of numpy arrays.
+        A List of numpy arrays, or DeviceArrays with device.
 
     '''
 
@@ -559,7 +708,10 @@ def get_particle_structs(species_name, level):
 
     particle_data = []
     for i in range(num_tiles.value):
-        arr = _array1d_from_pointer(data[i], _p_dtype, particles_per_tile[i])
+        if device:
+            arr = _device_array_from_pointer(data[i], _p_dtype, (particles_per_tile[i],))
+        else:
+            arr = _array1d_from_pointer(data[i], _p_dtype, particles_per_tile[i])
         particle_data.append(arr)
 
     _libc.free(particles_per_tile)
@@ -567,7 +719,7 @@ def get_particle_structs(species_name, level):
     return particle_data
 
 
-def get_particle_arrays(species_name, comp_name, level):
+def get_particle_arrays(species_name, comp_name, level, device=False):
     '''
 
     This returns a list of numpy arrays containing the particle array data
@@ -581,11 +733,13 @@ def get_particle_arrays(species_name, comp_name, level):
 
         species_name   : the species name that the data will be returned for
         comp_name      : the component of the array data that will be returned.
+        level          : the refinement level
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
 
-        A List of numpy arrays.
+        A List of numpy arrays, or DeviceArrays with device.
 
     '''
 
@@ -599,6 +753,10 @@ def get_particle_arrays(species_name, comp_name, level):
 
     particle_data = []
     for i in range(num_tiles.value):
+        if device:
+            particle_data.append(_device_array_from_pointer(data[i], _numpy_particlereal_dtype,
+                                                            (particles_per_tile[i],)))
+            continue
         arr = np.ctypeslib.as_array(data[i], (particles_per_tile[i],))
         try:
             # This fails on some versions of numpy
@@ -612,6 +770,97 @@ def get_particle_arrays(species_name, comp_name, level):
     return particle_data
 
 
+def _buffer_address(buffer):
+    """
+    Address of the data of a numpy array, or of an array with the CUDA array interface
+    (e.g. cupy), and whether it is in device memory.
+    """
+    if hasattr(buffer, '__cuda_array_interface__'):
+        return buffer.__cuda_array_interface__['data'][0], True
+    return buffer.ctypes.data, False
+
+
+def get_particle_tile_offsets(species_name, level=0):
+    '''
+
+    This returns the offsets of the tiles of this process in the arrays of
+    get_particle_arrays_bulk: the particles of tile i are between offsets[i]
+    (inclusive) and offsets[i+1] (exclusive).
+
+    '''
+
+    num_tiles = ctypes.c_int(0)
+    offsets_pointer = ctypes.POINTER(ctypes.c_long)()
+    libwarpx.warpx_getParticleTileOffsets(
+        ctypes.c_char_p(species_name.encode('utf-8')), level,
+        ctypes.byref(num_tiles), ctypes.byref(offsets_pointer)
+    )
+    offsets = np.ctypeslib.as_array(offsets_pointer, (num_tiles.value + 1,)).astype(np.int64)
+    _libc.free(offsets_pointer)
+    return offsets
+
+
+def get_particle_arrays_bulk(species_name, comp_names, level=0, buffer=None):
+    '''
+
+    This returns the components comp_names of all the particles of this process at
+    the given level, in one contiguous array of shape (len(comp_names), np), with the
+    tiles concatenated (see get_particle_tile_offsets). The data are copied, with one
+    call to WarpX instead of one numpy array per tile and component.
+
+    Parameters
+    ----------
+
+        species_name   : the species name that the data will be returned for
+        comp_names     : list of the components (e.g. ['w', 'ux', 'uy', 'uz'])
+        level          : the refinement level
+        buffer         : optional preallocated array of particlereal type, in host memory
+                         (numpy) or device memory (e.g. cupy), in which the data are copied
+                         if it has at least len(comp_names)*np elements. It can be reused
+                         across calls to avoid the allocations.
+
+    Returns
+    -------
+
+        An array of shape (len(comp_names), np), which is a view of buffer if it is used.
+
+    '''
+
+    ncomps = len(comp_names)
+    names = (ctypes.c_char_p*ncomps)(*[c.encode('utf-8') for c in comp_names])
+    species = ctypes.c_char_p(species_name.encode('utf-8'))
+
+    np_local = libwarpx.warpx_gatherParticleArrays(species, level, ncomps, names, None, 0, 0)
+    if buffer is None or buffer.size < ncomps*np_local:
+        buffer = np.empty(ncomps*np_local, dtype=_numpy_particlereal_dtype)
+    address, on_device = _buffer_address(buffer)
+    libwarpx.warpx_gatherParticleArrays(species, level, ncomps, names,
+                                        ctypes.c_void_p(address), buffer.size, int(on_device))
+    return buffer.reshape(-1)[:ncomps*np_local].reshape((ncomps, np_local))
+
+
+def set_particle_arrays_bulk(species_name, comp_names, data, level=0):
+    '''
+
+    This copies back the components comp_names of the particles of this process at
+    the given level from data, a contiguous array of shape (len(comp_names), np) in host
+    or device memory, as returned by get_particle_arrays_bulk. The particles must not
+    have been added, removed or redistributed in between.
+
+    '''
+
+    ncomps = len(comp_names)
+    names = (ctypes.c_char_p*ncomps)(*[c.encode('utf-8') for c in comp_names])
+    if not hasattr(data, '__cuda_array_interface__'):
+        data = np.ascontiguousarray(data, dtype=_numpy_particlereal_dtype)
+    address, on_device = _buffer_address(data)
+    np_local = data.size // ncomps if ncomps > 0 else 0
+    libwarpx.warpx_scatterParticleArrays(
+        ctypes.c_char_p(species_name.encode('utf-8')), level, ncomps, names,
+        ctypes.c_void_p(address), np_local, int(on_device)
+    )
+
+
 def get_particle_x(species_name, level=0):
     '''
 
@@ -860,6 +1109,42 @@ def get_particle_boundary_buffer_size(species_name, boundary):
     )
 
 
+def get_particle_boundary_buffer_histogram(species_name, boundary, kind='energy'):
+    '''
+
+    This returns the histogram of the particles scraped so far in the simulation
+    from the specified boundary and of the specified species, summed over all
+    processes and weighted by the particle weights. This requires
+    particles.boundary_buffer_histogram_bins > 0.
+
+    Parameters
+    ----------
+
+        species_name   : the species name that the data will be returned for
+        boundary       : the boundary from which to get the scraped particle data.
+                         In the form x/y/z_hi/lo or eb.
+        kind           : 'energy' for the histogram of the kinetic energy (with bins
+                         over [0, particles.boundary_buffer_histogram_energy_max] eV)
+                         or 'angle' for the histogram of the angle of incidence
+                         (with bins over [0, pi/2], from the normal to the boundary)
+
+    Returns
+    -------
+
+        A numpy array of the values of the histogram in the bins.
+
+    '''
+    assert kind in ['energy', 'angle'], "kind must be 'energy' or 'angle'"
+    nbins = libwarpx.warpx_getParticleBoundaryBufferHistogramBins()
+    histogram = np.zeros(nbins, dtype=_numpy_real_dtype)
+    libwarpx.warpx_getParticleBoundaryBufferHistogram(
+        ctypes.c_char_p(species_name.encode('utf-8')),
+        _get_boundary_number(boundary), int(kind == 'angle'),
+        histogram.ctypes.data_as(_LP_c_real)
+    )
+    return histogram
+
+
 def get_particle_boundary_buffer_structs(species_name, boundary, level):
     '''
 
@@ -962,9 +1247,10 @@ def get_particle_boundary_buffer(species_name, boundary, comp_name, level):
     return particle_data
 
 
-def _get_mesh_field_list(warpx_func, level, direction, include_ghosts):
+def _get_mesh_field_list(warpx_func, level, direction, include_ghosts, device=False):
     """
      Generic routine to fetch the list of field data arrays.
+     With device, the arrays are DeviceArrays, that can be used in place on the GPU.
     """
     shapes = _LP_c_int()
     size = ctypes.c_int(0)
@@ -988,6 +1274,11 @@ def _get_mesh_field_list(warpx_func, level, direction, include_ghosts):
         shapesize += 1
     for i in range(size.value):
         shape = tuple([shapes[shapesize*i + d] for d in range(shapesize)])
+        if device:
+            lo_offset = None if include_ghosts else ngvect
+            grid_data.append(_device_array_from_pointer(data[i], _numpy_real_dtype, shape,
+                                                        fortran_order=True, lo_offset=lo_offset))
+            continue
         # --- The data is stored in Fortran order, hence shape is reversed and a transpose is taken.
         arr = np.ctypeslib.as_array(data[i], shape[::-1]).T
         try:
@@ -1005,7 +1296,7 @@ def _get_mesh_field_list(warpx_func, level, direction, include_ghosts):
     return grid_data
 
 
-def get_mesh_electric_field(level, direction, include_ghosts=True):
+def get_mesh_electric_field(level, direction, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh electric field
@@ -1022,6 +1313,7 @@ def get_mesh_electric_field(level, direction, include_ghosts=True):
         level          : the AMR level to get the data for
         direction      : the component of the data you want
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1030,10 +1322,10 @@ def get_mesh_electric_field(level, direction, include_ghosts=True):
 
     '''
 
-    return _get_mesh_field_list(libwarpx.warpx_getEfield, level, direction, include_ghosts)
+    return _get_mesh_field_list(libwarpx.warpx_getEfield, level, direction, include_ghosts, device)
 
 
-def get_mesh_electric_field_cp(level, direction, include_ghosts=True):
+def get_mesh_electric_field_cp(level, direction, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh electric field
@@ -1049,6 +1341,7 @@ def get_mesh_electric_field_cp(level, direction, include_ghosts=True):
         level          : the AMR level to get the data for
         direction      : the component of the data you want
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1057,10 +1350,10 @@ def get_mesh_electric_field_cp(level, direction, include_ghosts=True):
 
     '''
 
-    return _get_mesh_field_list(libwarpx.warpx_getEfieldCP, level, direction, include_ghosts)
+    return _get_mesh_field_list(libwarpx.warpx_getEfieldCP, level, direction, include_ghosts, device)
 
 
-def get_mesh_electric_field_fp(level, direction, include_ghosts=True):
+def get_mesh_electric_field_fp(level, direction, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh electric field
@@ -1076,6 +1369,7 @@ def get_mesh_electric_field_fp(level, direction, include_ghosts=True):
         level          : the AMR level to get the data for
         direction      : the component of the data you want
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1084,10 +1378,10 @@ def get_mesh_electric_field_fp(level, direction, include_ghosts=True):
 
     '''
 
-    return _get_mesh_field_list(libwarpx.warpx_getEfieldFP, level, direction, include_ghosts)
+    return _get_mesh_field_list(libwarpx.warpx_getEfieldFP, level, direction, include_ghosts, device)
 
 
-def get_mesh_electric_field_cp_pml(level, direction, include_ghosts=True):
+def get_mesh_electric_field_cp_pml(level, direction, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh electric field
@@ -1103,6 +1397,7 @@ def get_mesh_electric_field_cp_pml(level, direction, include_ghosts=True):
         level          : the AMR level to get the data for
         direction      : the component of the data you want
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1112,12 +1407,12 @@ def get_mesh_electric_field_cp_pml(level, direction, include_ghosts=True):
     '''
 
     try:
-        return _get_mesh_field_list(libwarpx.warpx_getEfieldCP_PML, level, direction, include_ghosts)
+        return _get_mesh_field_list(libwarpx.warpx_getEfieldCP_PML, level, direction, include_ghosts, device)
     except ValueError:
         raise Exception('PML not initialized')
 
 
-def get_mesh_electric_field_fp_pml(level, direction, include_ghosts=True):
+def get_mesh_electric_field_fp_pml(level, direction, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh electric field
@@ -1133,6 +1428,7 @@ def get_mesh_electric_field_fp_pml(level, direction, include_ghosts=True):
         level          : the AMR level to get the data for
         direction      : the component of the data you want
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1142,12 +1438,12 @@ def get_mesh_electric_field_fp_pml(level, direction, include_ghosts=True):
     '''
 
     try:
-        return _get_mesh_field_list(libwarpx.warpx_getEfieldFP_PML, level, direction, include_ghosts)
+        return _get_mesh_field_list(libwarpx.warpx_getEfieldFP_PML, level, direction, include_ghosts, device)
     except ValueError:
         raise Exception('PML not initialized')
 
 
-def get_mesh_magnetic_field(level, direction, include_ghosts=True):
+def get_mesh_magnetic_field(level, direction, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh magnetic field
@@ -1164,6 +1460,7 @@ def get_mesh_magnetic_field(level, direction, include_ghosts=True):
         level          : the AMR level to get the data for
         direction      : the component of the data you want
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1172,10 +1469,10 @@ def get_mesh_magnetic_field(level, direction, include_ghosts=True):
 
     '''
 
-    return _get_mesh_field_list(libwarpx.warpx_getBfield, level, direction, include_ghosts)
+    return _get_mesh_field_list(libwarpx.warpx_getBfield, level, direction, include_ghosts, device)
 
 
-def get_mesh_magnetic_field_cp(level, direction, include_ghosts=True):
+def get_mesh_magnetic_field_cp(level, direction, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh magnetic field
@@ -1191,6 +1488,7 @@ def get_mesh_magnetic_field_cp(level, direction, include_ghosts=True):
         level          : the AMR level to get the data for
         direction      : the component of the data you want
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1199,10 +1497,10 @@ def get_mesh_magnetic_field_cp(level, direction, include_ghosts=True):
 
     '''
 
-    return _get_mesh_field_list(libwarpx.warpx_getBfieldCP, level, direction, include_ghosts)
+    return _get_mesh_field_list(libwarpx.warpx_getBfieldCP, level, direction, include_ghosts, device)
 
 
-def get_mesh_magnetic_field_fp(level, direction, include_ghosts=True):
+def get_mesh_magnetic_field_fp(level, direction, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh magnetic field
@@ -1218,6 +1516,7 @@ def get_mesh_magnetic_field_fp(level, direction, include_ghosts=True):
         level          : the AMR level to get the data for
         direction      : the component of the data you want
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1226,10 +1525,10 @@ def get_mesh_magnetic_field_fp(level, direction, include_ghosts=True):
 
     '''
 
-    return _get_mesh_field_list(libwarpx.warpx_getBfieldFP, level, direction, include_ghosts)
+    return _get_mesh_field_list(libwarpx.warpx_getBfieldFP, level, direction, include_ghosts, device)
 
 
-def get_mesh_magnetic_field_cp_pml(level, direction, include_ghosts=True):
+def get_mesh_magnetic_field_cp_pml(level, direction, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh magnetic field
@@ -1245,6 +1544,7 @@ def get_mesh_magnetic_field_cp_pml(level, direction, include_ghosts=True):
         level          : the AMR level to get the data for
         direction      : the component of the data you want
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1254,12 +1554,12 @@ def get_mesh_magnetic_field_cp_pml(level, direction, include_ghosts=True):
     '''
 
     try:
-        return _get_mesh_field_list(libwarpx.warpx_getBfieldCP_PML, level, direction, include_ghosts)
+        return _get_mesh_field_list(libwarpx.warpx_getBfieldCP_PML, level, direction, include_ghosts, device)
     except ValueError:
         raise Exception('PML not initialized')
 
 
-def get_mesh_magnetic_field_fp_pml(level, direction, include_ghosts=True):
+def get_mesh_magnetic_field_fp_pml(level, direction, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh magnetic field
@@ -1275,6 +1575,7 @@ def get_mesh_magnetic_field_fp_pml(level, direction, include_ghosts=True):
         level          : the AMR level to get the data for
         direction      : the component of the data you want
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1284,12 +1585,12 @@ def get_mesh_magnetic_field_fp_pml(level, direction, include_ghosts=True):
     '''
 
     try:
-        return _get_mesh_field_list(libwarpx.warpx_getBfieldFP_PML, level, direction, include_ghosts)
+        return _get_mesh_field_list(libwarpx.warpx_getBfieldFP_PML, level, direction, include_ghosts, device)
     except ValueError:
         raise Exception('PML not initialized')
 
 
-def get_mesh_current_density(level, direction, include_ghosts=True):
+def get_mesh_current_density(level, direction, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh current density
@@ -1304,6 +1605,7 @@ def get_mesh_current_density(level, direction, include_ghosts=True):
         level          : the AMR level to get the data for
         direction      : the component of the data you want
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1312,10 +1614,10 @@ def get_mesh_current_density(level, direction, include_ghosts=True):
 
     '''
 
-    return _get_mesh_field_list(libwarpx.warpx_getCurrentDensity, level, direction, include_ghosts)
+    return _get_mesh_field_list(libwarpx.warpx_getCurrentDensity, level, direction, include_ghosts, device)
 
 
-def get_mesh_current_density_cp(level, direction, include_ghosts=True):
+def get_mesh_current_density_cp(level, direction, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh current density
@@ -1331,6 +1633,7 @@ def get_mesh_current_density_cp(level, direction, include_ghosts=True):
         level          : the AMR level to get the data for
         direction      : the component of the data you want
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1339,10 +1642,10 @@ def get_mesh_current_density_cp(level, direction, include_ghosts=True):
 
     '''
 
-    return _get_mesh_field_list(libwarpx.warpx_getCurrentDensityCP, level, direction, include_ghosts)
+    return _get_mesh_field_list(libwarpx.warpx_getCurrentDensityCP, level, direction, include_ghosts, device)
 
 
-def get_mesh_current_density_fp(level, direction, include_ghosts=True):
+def get_mesh_current_density_fp(level, direction, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh current density
@@ -1358,6 +1661,7 @@ def get_mesh_current_density_fp(level, direction, include_ghosts=True):
         level          : the AMR level to get the data for
         direction      : the component of the data you want
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1366,10 +1670,10 @@ def get_mesh_current_density_fp(level, direction, include_ghosts=True):
 
     '''
 
-    return _get_mesh_field_list(libwarpx.warpx_getCurrentDensityFP, level, direction, include_ghosts)
+    return _get_mesh_field_list(libwarpx.warpx_getCurrentDensityFP, level, direction, include_ghosts, device)
 
 
-def get_mesh_current_density_cp_pml(level, direction, include_ghosts=True):
+def get_mesh_current_density_cp_pml(level, direction, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh current density
@@ -1385,6 +1689,7 @@ def get_mesh_current_density_cp_pml(level, direction, include_ghosts=True):
         level          : the AMR level to get the data for
         direction      : the component of the data you want
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1394,12 +1699,12 @@ def get_mesh_current_density_cp_pml(level, direction, include_ghosts=True):
     '''
 
     try:
-        return _get_mesh_field_list(libwarpx.warpx_getCurrentDensityCP_PML, level, direction, include_ghosts)
+        return _get_mesh_field_list(libwarpx.warpx_getCurrentDensityCP_PML, level, direction, include_ghosts, device)
     except ValueError:
         raise Exception('PML not initialized')
 
 
-def get_mesh_current_density_fp_pml(level, direction, include_ghosts=True):
+def get_mesh_current_density_fp_pml(level, direction, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh current density
@@ -1415,6 +1720,7 @@ def get_mesh_current_density_fp_pml(level, direction, include_ghosts=True):
         level          : the AMR level to get the data for
         direction      : the component of the data you want
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1424,12 +1730,12 @@ def get_mesh_current_density_fp_pml(level, direction, include_ghosts=True):
     '''
 
     try:
-        return _get_mesh_field_list(libwarpx.warpx_getCurrentDensityFP_PML, level, direction, include_ghosts)
+        return _get_mesh_field_list(libwarpx.warpx_getCurrentDensityFP_PML, level, direction, include_ghosts, device)
     except ValueError:
         raise Exception('PML not initialized')
 
 
-def get_mesh_charge_density_cp(level, include_ghosts=True):
+def get_mesh_charge_density_cp(level, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh charge density
@@ -1444,6 +1750,7 @@ def get_mesh_charge_density_cp(level, include_ghosts=True):
 
         level          : the AMR level to get the data for
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1452,10 +1759,10 @@ def get_mesh_charge_density_cp(level, include_ghosts=True):
 
     '''
 
-    return _get_mesh_field_list(libwarpx.warpx_getChargeDensityCP, level, None, include_ghosts)
+    return _get_mesh_field_list(libwarpx.warpx_getChargeDensityCP, level, None, include_ghosts, device)
 
 
-def get_mesh_charge_density_fp(level, include_ghosts=True):
+def get_mesh_charge_density_fp(level, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh charge density
@@ -1470,6 +1777,7 @@ def get_mesh_charge_density_fp(level, include_ghosts=True):
 
         level          : the AMR level to get the data for
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1478,10 +1786,10 @@ def get_mesh_charge_density_fp(level, include_ghosts=True):
 
     '''
 
-    return _get_mesh_field_list(libwarpx.warpx_getChargeDensityFP, level, None, include_ghosts)
+    return _get_mesh_field_list(libwarpx.warpx_getChargeDensityFP, level, None, include_ghosts, device)
 
 
-def get_mesh_phi_fp(level, include_ghosts=True):
+def get_mesh_phi_fp(level, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh electrostatic
@@ -1496,6 +1804,7 @@ def get_mesh_phi_fp(level, include_ghosts=True):
 
         level          : the AMR level to get the data for
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1503,10 +1812,10 @@ def get_mesh_phi_fp(level, include_ghosts=True):
         A List of numpy arrays.
 
     '''
-    return _get_mesh_field_list(libwarpx.warpx_getPhiFP, level, None, include_ghosts)
+    return _get_mesh_field_list(libwarpx.warpx_getPhiFP, level, None, include_ghosts, device)
 
 
-def get_mesh_F_cp(level, include_ghosts=True):
+def get_mesh_F_cp(level, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh F field
@@ -1521,6 +1830,7 @@ def get_mesh_F_cp(level, include_ghosts=True):
 
         level          : the AMR level to get the data for
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1529,10 +1839,10 @@ def get_mesh_F_cp(level, include_ghosts=True):
 
     '''
 
-    return _get_mesh_field_list(libwarpx.warpx_getFfieldCP, level, None, include_ghosts)
+    return _get_mesh_field_list(libwarpx.warpx_getFfieldCP, level, None, include_ghosts, device)
 
 
-def get_mesh_F_fp(level, include_ghosts=True):
+def get_mesh_F_fp(level, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh F field
@@ -1547,6 +1857,7 @@ def get_mesh_F_fp(level, include_ghosts=True):
 
         level          : the AMR level to get the data for
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1555,10 +1866,10 @@ def get_mesh_F_fp(level, include_ghosts=True):
 
     '''
 
-    return _get_mesh_field_list(libwarpx.warpx_getFfieldFP, level, None, include_ghosts)
+    return _get_mesh_field_list(libwarpx.warpx_getFfieldFP, level, None, include_ghosts, device)
 
 
-def get_mesh_F_fp_pml(level, include_ghosts=True):
+def get_mesh_F_fp_pml(level, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh F field
@@ -1573,6 +1884,7 @@ def get_mesh_F_fp_pml(level, include_ghosts=True):
 
         level          : the AMR level to get the data for
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1581,12 +1893,12 @@ def get_mesh_F_fp_pml(level, include_ghosts=True):
 
     '''
     try:
-        return _get_mesh_field_list(libwarpx.warpx_getFfieldFP_PML, level, None, include_ghosts)
+        return _get_mesh_field_list(libwarpx.warpx_getFfieldFP_PML, level, None, include_ghosts, device)
     except ValueError:
         raise Exception('PML not initialized')
 
 
-def get_mesh_F_cp_pml(level, include_ghosts=True):
+def get_mesh_F_cp_pml(level, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh F field
@@ -1601,6 +1913,7 @@ def get_mesh_F_cp_pml(level, include_ghosts=True):
 
         level          : the AMR level to get the data for
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1609,12 +1922,12 @@ def get_mesh_F_cp_pml(level, include_ghosts=True):
 
     '''
     try:
-        return _get_mesh_field_list(libwarpx.warpx_getFfieldCP_PML, level, None, include_ghosts)
+        return _get_mesh_field_list(libwarpx.warpx_getFfieldCP_PML, level, None, include_ghosts, device)
     except ValueError:
         raise Exception('PML not initialized')
 
 
-def get_mesh_G_cp(level, include_ghosts=True):
+def get_mesh_G_cp(level, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh G field
@@ -1629,6 +1942,7 @@ def get_mesh_G_cp(level, include_ghosts=True):
 
         level          : the AMR level to get the data for
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1637,10 +1951,10 @@ def get_mesh_G_cp(level, include_ghosts=True):
 
     '''
 
-    return _get_mesh_field_list(libwarpx.warpx_getGfieldCP, level, None, include_ghosts)
+    return _get_mesh_field_list(libwarpx.warpx_getGfieldCP, level, None, include_ghosts, device)
 
 
-def get_mesh_G_fp(level, include_ghosts=True):
+def get_mesh_G_fp(level, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh G field
@@ -1655,6 +1969,7 @@ def get_mesh_G_fp(level, include_ghosts=True):
 
         level          : the AMR level to get the data for
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1663,10 +1978,10 @@ def get_mesh_G_fp(level, include_ghosts=True):
 
     '''
 
-    return _get_mesh_field_list(libwarpx.warpx_getGfieldFP, level, None, include_ghosts)
+    return _get_mesh_field_list(libwarpx.warpx_getGfieldFP, level, None, include_ghosts, device)
 
 
-def get_mesh_G_cp_pml(level, include_ghosts=True):
+def get_mesh_G_cp_pml(level, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh G field
@@ -1681,6 +1996,7 @@ def get_mesh_G_cp_pml(level, include_ghosts=True):
 
         level          : the AMR level to get the data for
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1689,12 +2005,12 @@ def get_mesh_G_cp_pml(level, include_ghosts=True):
 
     '''
     try:
-        return _get_mesh_field_list(libwarpx.warpx_getGfieldCP_PML, level, None, include_ghosts)
+        return _get_mesh_field_list(libwarpx.warpx_getGfieldCP_PML, level, None, include_ghosts, device)
     except ValueError:
         raise Exception('PML not initialized')
 
 
-def get_mesh_G_fp_pml(level, include_ghosts=True):
+def get_mesh_G_fp_pml(level, include_ghosts=True, device=False):
     '''
 
     This returns a list of numpy arrays containing the mesh G field
@@ -1709,6 +2025,7 @@ def get_mesh_G_fp_pml(level, include_ghosts=True):
 
         level          : the AMR level to get the data for
         include_ghosts : whether to include ghost zones or not
+        device         : whether to return views of the device memory (see DeviceArray)
 
     Returns
     -------
@@ -1717,7 +2034,7 @@ def get_mesh_G_fp_pml(level, include_ghosts=True):
 
     '''
     try:
-        return _get_mesh_field_list(libwarpx.warpx_getGfieldFP_PML, level, None, include_ghosts)
+        return _get_mesh_field_list(libwarpx.warpx_getGfieldFP_PML, level, None, include_ghosts, device)
     except ValueError:
         raise Exception('PML not initialized')
 
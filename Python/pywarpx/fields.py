@@ -76,6 +76,17 @@ class _MultiFABWrapper(object):
         lovects, ngrow = self._getlovects()
         return len(lovects)
 
+    def get_device_arrays(self):
+        """Returns the list of the arrays of the FABs on this process, without copy, as
+        _libwarpx.DeviceArray objects that expose the CUDA array interface, so that they
+        can be modified in place on the GPU, e.g. with cupy.asarray or torch.as_tensor.
+        The arrays are in Fortran order, indexed like [ix, iy, iz] in 3D.
+        """
+        if self.direction is None:
+            return self.get_fabs(self.level, self.include_ghosts, device=True)
+        else:
+            return self.get_fabs(self.level, self.direction, self.include_ghosts, device=True)
+
     def mesh(self, direction):
         """Returns the mesh along the specified direction with the appropriate centering.
         - direction: In 3d, one of 'x', 'y', or 'z'.
@@ -16,6 +16,7 @@
 #include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXConst.H"
 #include "Utils/WarpXProfilerWrapper.H"
+#include "Utils/WarpXUtil.H"
 #include "WarpX.H"
 #include "Parallelization/WarpXCommUtil.H"
 
@@ -40,6 +41,7 @@
 #include <AMReX_ParmParse.H>
 #include <AMReX_RealVect.H>
 #include <AMReX_SPACE.H>
+#include <AMReX_Vector.H>
 #include <AMReX_VisMF.H>
 
 #include <algorithm>
@@ -515,10 +517,16 @@ PML::PML (const int lev, const BoxArray& grid_ba, const DistributionMapping& /*g
         int ngFFt_y = do_nodal ? noy_fft : noy_fft/2;
         int ngFFt_z = do_nodal ? noz_fft : noz_fft/2;
 
+        // The user-defined numbers of guard cells are used in the PML only if
+        // the PML uses the same order as the rest of the domain
         ParmParse pp_psatd("psatd");
-        queryWithParser(pp_psatd, "nx_guard", ngFFt_x);
-        queryWithParser(pp_psatd, "ny_guard", ngFFt_y);
-        queryWithParser(pp_psatd, "nz_guard", ngFFt_z);
+        if (!pp_psatd.contains("pml_nox") && !pp_psatd.contains("pml_noy") &&
+            !pp_psatd.contains("pml_noz"))
+        {
+            queryWithParser(pp_psatd, "nx_guard", ngFFt_x);
+            queryWithParser(pp_psatd, "ny_guard", ngFFt_y);
+            queryWithParser(pp_psatd, "nz_guard", ngFFt_z);
+        }
 
 #if (AMREX_SPACEDIM == 3)
         IntVect ngFFT = IntVect(ngFFt_x, ngFFt_y, ngFFt_z);
@@ -607,6 +615,7 @@ PML::PML (const int lev, const BoxArray& grid_ba, const DistributionMapping& /*g
         // Flags passed to the spectral solver constructor
         const bool in_pml = true;
         const bool periodic_single_box = false;
+        const bool distributed_fft = false;
         const bool update_with_rho = false;
         const bool fft_do_time_averaging = false;
         const RealVect dx{AMREX_D_DECL(geom->CellSize(0), geom->CellSize(1), geom->CellSize(2))};
@@ -617,7 +626,7 @@ PML::PML (const int lev, const BoxArray& grid_ba, const DistributionMapping& /*g
         realspace_ba.enclosedCells().grow(nge); // cell-centered + guard cells
         spectral_solver_fp = std::make_unique<SpectralSolver>(lev, realspace_ba, dm,
             nox_fft, noy_fft, noz_fft, do_nodal, WarpX::fill_guards, v_galilean_zero,
-            v_comoving_zero, dx, dt, in_pml, periodic_single_box, update_with_rho,
+            v_comoving_zero, dx, dt, in_pml, periodic_single_box, distributed_fft, update_with_rho,
             fft_do_time_averaging, J_linear_in_time, m_dive_cleaning, m_divb_cleaning);
 #endif
     }
@@ -718,6 +727,8 @@ PML::PML (const int lev, const BoxArray& grid_ba, const DistributionMapping& /*g
             // Flags passed to the spectral solver constructor
             const bool in_pml = true;
             const bool periodic_single_box = false;
+            const bool distributed_fft = false;
+        const bool distributed_fft = false;
             const bool update_with_rho = false;
             const bool fft_do_time_averaging = false;
             const RealVect cdx{AMREX_D_DECL(cgeom->CellSize(0), cgeom->CellSize(1), cgeom->CellSize(2))};
@@ -728,7 +739,7 @@ PML::PML (const int lev, const BoxArray& grid_ba, const DistributionMapping& /*g
             realspace_cba.enclosedCells().grow(nge); // cell-centered + guard cells
             spectral_solver_cp = std::make_unique<SpectralSolver>(lev, realspace_cba, cdm,
                 nox_fft, noy_fft, noz_fft, do_nodal, WarpX::fill_guards, v_galilean_zero,
-                v_comoving_zero, cdx, dt, in_pml, periodic_single_box, update_with_rho,
+                v_comoving_zero, cdx, dt, in_pml, periodic_single_box, distributed_fft, update_with_rho,
                 fft_do_time_averaging, J_linear_in_time, m_dive_cleaning, m_divb_cleaning);
 #endif
         }
@@ -883,6 +894,29 @@ PML::GetG_cp ()
     return pml_G_cp.get();
 }
 
+amrex::Long
+PML::BytesAllocated () const
+{
+    amrex::Long bytes = 0;
+    for (int i = 0; i < 3; ++i) {
+        bytes += WarpXUtilMem::MultiFabBytes(pml_E_fp[i].get());
+        bytes += WarpXUtilMem::MultiFabBytes(pml_B_fp[i].get());
+        bytes += WarpXUtilMem::MultiFabBytes(pml_j_fp[i].get());
+        bytes += WarpXUtilMem::MultiFabBytes(pml_E_cp[i].get());
+        bytes += WarpXUtilMem::MultiFabBytes(pml_B_cp[i].get());
+        bytes += WarpXUtilMem::MultiFabBytes(pml_j_cp[i].get());
+    }
+    bytes += WarpXUtilMem::MultiFabBytes(pml_F_fp.get());
+    bytes += WarpXUtilMem::MultiFabBytes(pml_F_cp.get());
+    bytes += WarpXUtilMem::MultiFabBytes(pml_G_fp.get());
+    bytes += WarpXUtilMem::MultiFabBytes(pml_G_cp.get());
+#ifdef WARPX_USE_PSATD
+    if (spectral_solver_fp) bytes += spectral_solver_fp->BytesAllocated();
+    if (spectral_solver_cp) bytes += spectral_solver_cp->BytesAllocated();
+#endif
+    return bytes;
+}
+
 void
 PML::ExchangeB (const std::array<amrex::MultiFab*,3>& B_fp,
                 const std::array<amrex::MultiFab*,3>& B_cp,
@@ -1004,6 +1038,7 @@ void
 PML::Exchange (MultiFab& pml, MultiFab& reg, const Geometry& geom,
                 int do_pml_in_domain)
 {
+    WarpXCommUtil::CommSite comm_site("PML::Exchange");
     WARPX_PROFILE("PML::Exchange");
 
     const IntVect& ngr = reg.nGrowVect();
@@ -1076,6 +1111,7 @@ PML::Exchange (MultiFab& pml, MultiFab& reg, const Geometry& geom,
 void
 PML::CopyToPML (MultiFab& pml, MultiFab& reg, const Geometry& geom)
 {
+    WarpXCommUtil::CommSite comm_site("PML::Exchange");
   const IntVect& ngp = pml.nGrowVect();
   const auto& period = geom.periodicity();
 
@@ -1101,6 +1137,7 @@ PML::FillBoundaryE ()
 void
 PML::FillBoundaryE (PatchType patch_type)
 {
+    WarpXCommUtil::CommSite comm_site("PML::FillBoundary");
     if (patch_type == PatchType::fine && pml_E_fp[0] && pml_E_fp[0]->nGrowVect().max() > 0)
     {
         const auto& period = m_geom->periodicity();
@@ -1125,6 +1162,7 @@ PML::FillBoundaryB ()
 void
 PML::FillBoundaryB (PatchType patch_type)
 {
+    WarpXCommUtil::CommSite comm_site("PML::FillBoundary");
     if (patch_type == PatchType::fine && pml_B_fp[0])
     {
         const auto& period = m_geom->periodicity();
@@ -1149,6 +1187,7 @@ PML::FillBoundaryF ()
 void
 PML::FillBoundaryF (PatchType patch_type)
 {
+    WarpXCommUtil::CommSite comm_site("PML::FillBoundary");
     if (patch_type == PatchType::fine && pml_F_fp && pml_F_fp->nGrowVect().max() > 0)
     {
         const auto& period = m_geom->periodicity();
@@ -1171,6 +1210,7 @@ PML::FillBoundaryG ()
 void
 PML::FillBoundaryG (PatchType patch_type)
 {
+    WarpXCommUtil::CommSite comm_site("PML::FillBoundary");
     if (patch_type == PatchType::fine && pml_G_fp && pml_G_fp->nGrowVect().max() > 0)
     {
         const auto& period = m_geom->periodicity();
@@ -1253,79 +1293,45 @@ PushPMLPSATDSinglePatch (
 {
     const SpectralFieldIndex& Idx = solver.m_spectral_index;
 
-    // Perform forward Fourier transforms
-    solver.ForwardTransform(lev, *pml_E[0], Idx.Exy, PMLComp::xy);
-    solver.ForwardTransform(lev, *pml_E[0], Idx.Exz, PMLComp::xz);
-    solver.ForwardTransform(lev, *pml_E[1], Idx.Eyx, PMLComp::yx);
-    solver.ForwardTransform(lev, *pml_E[1], Idx.Eyz, PMLComp::yz);
-    solver.ForwardTransform(lev, *pml_E[2], Idx.Ezx, PMLComp::zx);
-    solver.ForwardTransform(lev, *pml_E[2], Idx.Ezy, PMLComp::zy);
-    solver.ForwardTransform(lev, *pml_B[0], Idx.Bxy, PMLComp::xy);
-    solver.ForwardTransform(lev, *pml_B[0], Idx.Bxz, PMLComp::xz);
-    solver.ForwardTransform(lev, *pml_B[1], Idx.Byx, PMLComp::yx);
-    solver.ForwardTransform(lev, *pml_B[1], Idx.Byz, PMLComp::yz);
-    solver.ForwardTransform(lev, *pml_B[2], Idx.Bzx, PMLComp::zx);
-    solver.ForwardTransform(lev, *pml_B[2], Idx.Bzy, PMLComp::zy);
+    // Components of the PML fields that are transformed to/from spectral space
+    amrex::Vector<SpectralFieldData::TransformComponent> components = {
+        {pml_E[0].get(), Idx.Exy, PMLComp::xy}, {pml_E[0].get(), Idx.Exz, PMLComp::xz},
+        {pml_E[1].get(), Idx.Eyx, PMLComp::yx}, {pml_E[1].get(), Idx.Eyz, PMLComp::yz},
+        {pml_E[2].get(), Idx.Ezx, PMLComp::zx}, {pml_E[2].get(), Idx.Ezy, PMLComp::zy},
+        {pml_B[0].get(), Idx.Bxy, PMLComp::xy}, {pml_B[0].get(), Idx.Bxz, PMLComp::xz},
+        {pml_B[1].get(), Idx.Byx, PMLComp::yx}, {pml_B[1].get(), Idx.Byz, PMLComp::yz},
+        {pml_B[2].get(), Idx.Bzx, PMLComp::zx}, {pml_B[2].get(), Idx.Bzy, PMLComp::zy}};
 
     // WarpX::do_pml_dive_cleaning = true
     if (pml_F)
     {
-        solver.ForwardTransform(lev, *pml_E[0], Idx.Exx, PMLComp::xx);
-        solver.ForwardTransform(lev, *pml_E[1], Idx.Eyy, PMLComp::yy);
-        solver.ForwardTransform(lev, *pml_E[2], Idx.Ezz, PMLComp::zz);
-        solver.ForwardTransform(lev, *pml_F, Idx.Fx, PMLComp::x);
-        solver.ForwardTransform(lev, *pml_F, Idx.Fy, PMLComp::y);
-        solver.ForwardTransform(lev, *pml_F, Idx.Fz, PMLComp::z);
+        components.push_back({pml_E[0].get(), Idx.Exx, PMLComp::xx});
+        components.push_back({pml_E[1].get(), Idx.Eyy, PMLComp::yy});
+        components.push_back({pml_E[2].get(), Idx.Ezz, PMLComp::zz});
+        components.push_back({pml_F.get(), Idx.Fx, PMLComp::x});
+        components.push_back({pml_F.get(), Idx.Fy, PMLComp::y});
+        components.push_back({pml_F.get(), Idx.Fz, PMLComp::z});
     }
 
     // WarpX::do_pml_divb_cleaning = true
     if (pml_G)
     {
-        solver.ForwardTransform(lev, *pml_B[0], Idx.Bxx, PMLComp::xx);
-        solver.ForwardTransform(lev, *pml_B[1], Idx.Byy, PMLComp::yy);
-        solver.ForwardTransform(lev, *pml_B[2], Idx.Bzz, PMLComp::zz);
-        solver.ForwardTransform(lev, *pml_G, Idx.Gx, PMLComp::x);
-        solver.ForwardTransform(lev, *pml_G, Idx.Gy, PMLComp::y);
-        solver.ForwardTransform(lev, *pml_G, Idx.Gz, PMLComp::z);
+        components.push_back({pml_B[0].get(), Idx.Bxx, PMLComp::xx});
+        components.push_back({pml_B[1].get(), Idx.Byy, PMLComp::yy});
+        components.push_back({pml_B[2].get(), Idx.Bzz, PMLComp::zz});
+        components.push_back({pml_G.get(), Idx.Gx, PMLComp::x});
+        components.push_back({pml_G.get(), Idx.Gy, PMLComp::y});
+        components.push_back({pml_G.get(), Idx.Gz, PMLComp::z});
     }
 
+    // Perform forward Fourier transforms
+    // (batched, if WarpX::fft_batch_transforms is set)
+    solver.ForwardTransform(lev, components);
+
     // Advance fields in spectral space
     solver.pushSpectralFields();
 
     // Perform backward Fourier transforms
-    solver.BackwardTransform(lev, *pml_E[0], Idx.Exy, PMLComp::xy);
-    solver.BackwardTransform(lev, *pml_E[0], Idx.Exz, PMLComp::xz);
-    solver.BackwardTransform(lev, *pml_E[1], Idx.Eyx, PMLComp::yx);
-    solver.BackwardTransform(lev, *pml_E[1], Idx.Eyz, PMLComp::yz);
-    solver.BackwardTransform(lev, *pml_E[2], Idx.Ezx, PMLComp::zx);
-    solver.BackwardTransform(lev, *pml_E[2], Idx.Ezy, PMLComp::zy);
-    solver.BackwardTransform(lev, *pml_B[0], Idx.Bxy, PMLComp::xy);
-    solver.BackwardTransform(lev, *pml_B[0], Idx.Bxz, PMLComp::xz);
-    solver.BackwardTransform(lev, *pml_B[1], Idx.Byx, PMLComp::yx);
-    solver.BackwardTransform(lev, *pml_B[1], Idx.Byz, PMLComp::yz);
-    solver.BackwardTransform(lev, *pml_B[2], Idx.Bzx, PMLComp::zx);
-    solver.BackwardTransform(lev, *pml_B[2], Idx.Bzy, PMLComp::zy);
-
-    // WarpX::do_pml_dive_cleaning = true
-    if (pml_F)
-    {
-        solver.BackwardTransform(lev, *pml_E[0], Idx.Exx, PMLComp::xx);
-        solver.BackwardTransform(lev, *pml_E[1], Idx.Eyy, PMLComp::yy);
-        solver.BackwardTransform(lev, *pml_E[2], Idx.Ezz, PMLComp::zz);
-        solver.BackwardTransform(lev, *pml_F, Idx.Fx, PMLComp::x);
-        solver.BackwardTransform(lev, *pml_F, Idx.Fy, PMLComp::y);
-        solver.BackwardTransform(lev, *pml_F, Idx.Fz, PMLComp::z);
-    }
-
-    // WarpX::do_pml_divb_cleaning = true
-    if (pml_G)
-    {
-        solver.BackwardTransform(lev, *pml_B[0], Idx.Bxx, PMLComp::xx);
-        solver.BackwardTransform(lev, *pml_B[1], Idx.Byy, PMLComp::yy);
-        solver.BackwardTransform(lev, *pml_B[2], Idx.Bzz, PMLComp::zz);
-        solver.BackwardTransform(lev, *pml_G, Idx.Gx, PMLComp::x);
-        solver.BackwardTransform(lev, *pml_G, Idx.Gy, PMLComp::y);
-        solver.BackwardTransform(lev, *pml_G, Idx.Gz, PMLComp::z);
-    }
+    solver.BackwardTransform(lev, components);
 }
 #endif
@@ -60,6 +60,9 @@ WarpX::DampPML (int lev, PatchType patch_type)
 
     const bool dive_cleaning = WarpX::do_pml_dive_cleaning;
     const bool divb_cleaning = WarpX::do_pml_divb_cleaning;
+    // With do_pml_fused_damping, E and B are damped in the kernels of
+    // EvolveEPML and EvolveBPML: only F and G are damped here
+    const bool damp_EB = !do_pml_fused_damping;
 
     if (pml[lev]->ok())
     {
@@ -88,6 +91,8 @@ WarpX::DampPML (int lev, PatchType patch_type)
             G_stag = pml_G->ixType().toIntVect();
         }
 
+        if (!damp_EB && !pml_F && !pml_G) return;
+
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
@@ -131,39 +136,41 @@ WarpX::DampPML (int lev, PatchType patch_type)
             int const z_lo = sigba[mfi].sigma_fac[1].lo();
 #endif
 
-            amrex::ParallelFor(tex, tey, tez,
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-                warpx_damp_pml_ex(i, j, k, pml_Exfab, Ex_stag, sigma_fac_x, sigma_fac_y, sigma_fac_z,
-                                  sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z, x_lo, y_lo, z_lo,
-                                  dive_cleaning);
-            },
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-                warpx_damp_pml_ey(i, j, k, pml_Eyfab, Ey_stag, sigma_fac_x, sigma_fac_y, sigma_fac_z,
-                                  sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z, x_lo, y_lo, z_lo,
-                                  dive_cleaning);
-            },
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-                warpx_damp_pml_ez(i, j, k, pml_Ezfab, Ez_stag, sigma_fac_x, sigma_fac_y, sigma_fac_z,
-                                  sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z, x_lo, y_lo, z_lo,
-                                  dive_cleaning);
-            });
-
-            amrex::ParallelFor(tbx, tby, tbz,
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-                warpx_damp_pml_bx(i, j, k, pml_Bxfab, Bx_stag, sigma_fac_x, sigma_fac_y, sigma_fac_z,
-                                  sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z, x_lo, y_lo, z_lo,
-                                  divb_cleaning);
-            },
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-                warpx_damp_pml_by(i, j, k, pml_Byfab, By_stag, sigma_fac_x, sigma_fac_y, sigma_fac_z,
-                                  sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z, x_lo, y_lo, z_lo,
-                                  divb_cleaning);
-            },
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-                warpx_damp_pml_bz(i, j, k, pml_Bzfab, Bz_stag, sigma_fac_x, sigma_fac_y, sigma_fac_z,
-                                  sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z, x_lo, y_lo, z_lo,
-                                  divb_cleaning);
-            });
+            if (damp_EB) {
+                amrex::ParallelFor(tex, tey, tez,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+                    warpx_damp_pml_ex(i, j, k, pml_Exfab, Ex_stag, sigma_fac_x, sigma_fac_y, sigma_fac_z,
+                                      sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z, x_lo, y_lo, z_lo,
+                                      dive_cleaning);
+                },
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+                    warpx_damp_pml_ey(i, j, k, pml_Eyfab, Ey_stag, sigma_fac_x, sigma_fac_y, sigma_fac_z,
+                                      sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z, x_lo, y_lo, z_lo,
+                                      dive_cleaning);
+                },
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+                    warpx_damp_pml_ez(i, j, k, pml_Ezfab, Ez_stag, sigma_fac_x, sigma_fac_y, sigma_fac_z,
+                                      sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z, x_lo, y_lo, z_lo,
+                                      dive_cleaning);
+                });
+
+                amrex::ParallelFor(tbx, tby, tbz,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+                    warpx_damp_pml_bx(i, j, k, pml_Bxfab, Bx_stag, sigma_fac_x, sigma_fac_y, sigma_fac_z,
+                                      sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z, x_lo, y_lo, z_lo,
+                                      divb_cleaning);
+                },
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+                    warpx_damp_pml_by(i, j, k, pml_Byfab, By_stag, sigma_fac_x, sigma_fac_y, sigma_fac_z,
+                                      sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z, x_lo, y_lo, z_lo,
+                                      divb_cleaning);
+                },
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+                    warpx_damp_pml_bz(i, j, k, pml_Bzfab, Bz_stag, sigma_fac_x, sigma_fac_y, sigma_fac_z,
+                                      sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z, x_lo, y_lo, z_lo,
+                                      divb_cleaning);
+                });
+            }
 
             // For warpx_damp_pml_F(), mfi.nodaltilebox is used in the ParallelFor loop and here we
             // use mfi.tilebox. However, it does not matter because in damp_pml, where nodaltilebox
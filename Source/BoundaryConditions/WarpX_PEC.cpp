@@ -14,6 +14,28 @@
 
 using namespace amrex::literals;
 
+namespace
+{
+    /** Whether the (grown) tile box tb reaches a PEC face of the domain of cell-centered
+     *  index bounds [dom_lo, dom_hi], i.e. whether it contains nodes on the face or guard
+     *  cells beyond it. Only such tiles can be modified by SetEfieldOnPEC/SetBfieldOnPEC. */
+    bool TouchesPECBoundary (amrex::Box const& tb,
+                             amrex::IntVect const& dom_lo, amrex::IntVect const& dom_hi,
+                             amrex::GpuArray<int, 3> const& fbndry_lo,
+                             amrex::GpuArray<int, 3> const& fbndry_hi)
+    {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            if (fbndry_lo[idim] == FieldBoundaryType::PEC && tb.smallEnd(idim) <= dom_lo[idim]) {
+                return true;
+            }
+            if (fbndry_hi[idim] == FieldBoundaryType::PEC && tb.bigEnd(idim) > dom_hi[idim]) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
 bool
 PEC::isAnyBoundaryPEC() {
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
@@ -66,6 +88,11 @@ PEC::ApplyPECtoEfield (std::array<std::unique_ptr<amrex::MultiFab>, 3>& Efield,
         amrex::Box const& tey = mfi.tilebox(Efield[1]->ixType().toIntVect(), shape_factor);
         amrex::Box const& tez = mfi.tilebox(Efield[2]->ixType().toIntVect(), shape_factor);
 
+        // Interior tiles are left untouched: skip the launch
+        if (!TouchesPECBoundary(tex, domain_lo, domain_hi, fbndry_lo, fbndry_hi) &&
+            !TouchesPECBoundary(tey, domain_lo, domain_hi, fbndry_lo, fbndry_hi) &&
+            !TouchesPECBoundary(tez, domain_lo, domain_hi, fbndry_lo, fbndry_hi)) continue;
+
         // loop over cells and update fields
         amrex::ParallelFor(
             tex, nComp_x,
@@ -148,6 +175,11 @@ PEC::ApplyPECtoBfield (std::array<std::unique_ptr<amrex::MultiFab>, 3>& Bfield,
         amrex::Box const& tby = mfi.tilebox(Bfield[1]->ixType().toIntVect(), shape_factor);
         amrex::Box const& tbz = mfi.tilebox(Bfield[2]->ixType().toIntVect(), shape_factor);
 
+        // Interior tiles are left untouched: skip the launch
+        if (!TouchesPECBoundary(tbx, domain_lo, domain_hi, fbndry_lo, fbndry_hi) &&
+            !TouchesPECBoundary(tby, domain_lo, domain_hi, fbndry_lo, fbndry_hi) &&
+            !TouchesPECBoundary(tbz, domain_lo, domain_hi, fbndry_lo, fbndry_hi)) continue;
+
         // loop over cells and update fields
         amrex::ParallelFor(
             tbx, nComp_x,
@@ -20,7 +20,6 @@
 #include <AMReX_CoordSys.H>
 #include <AMReX_DistributionMapping.H>
 #include <AMReX_FileSystem.H>
-#include <AMReX_ParallelContext.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_Utility.H>
@@ -81,6 +80,8 @@ void BTDiagnostics::DerivedInitData ()
     // allocate vector to count number of times the buffer multifab
     // has been flushed and refilled
     m_buffer_flush_counter.resize(m_num_buffers);
+    m_snapshot_header.resize(m_num_buffers);
+    m_snapshot_fab_header.resize(m_num_buffers);
     // allocate vector of geometry objects corresponding to each snapshot
     m_geom_snapshot.resize( m_num_buffers );
     m_snapshot_full.resize( m_num_buffers );
@@ -513,7 +514,8 @@ BTDiagnostics::DefineFieldBufferMultiFab (const int i_buffer, const int lev)
         // Unlike FullDiagnostics, "m_format == sensei" option is not included here.
         int ngrow = 0;
         m_mf_output[i_buffer][lev] = amrex::MultiFab ( buffer_ba, buffer_dmap,
-                                                  m_varnames.size(), ngrow ) ;
+                                                  m_varnames.size(), ngrow,
+                                                  amrex::MFInfo().SetArena(WarpXUtilMem::TransientArena()) ) ;
         m_mf_output[i_buffer][lev].setVal(0.);
 
         amrex::IntVect ref_ratio = amrex::IntVect(1);
@@ -660,7 +662,9 @@ void BTDiagnostics::MergeBuffersForPlotfile (int i_snapshot)
 {
     auto & warpx = WarpX::GetInstance();
     const amrex::Vector<int> iteration = warpx.getistep();
-    if (amrex::ParallelContext::IOProcessorSub()) {
+    // The snapshots are distributed over the ranks, so that their merges run in parallel
+    const int merge_rank = i_snapshot % amrex::ParallelDescriptor::NProcs();
+    if (amrex::ParallelDescriptor::MyProc() == merge_rank) {
         // Path to final snapshot plotfiles
         std::string snapshot_path = amrex::Concatenate(m_file_prefix,i_snapshot,5);
         // BTD plotfile have only one level, Level0.
@@ -703,12 +707,19 @@ void BTDiagnostics::MergeBuffersForPlotfile (int i_snapshot)
                         snapshot_FabHeaderFilename.c_str());
             std::rename(recent_Buffer_FabFilename.c_str(),
                         snapshot_FabFilename.c_str());
+            // Read the snapshot headers once, they are then updated in memory
+            m_snapshot_header[i_snapshot] =
+                std::make_unique<BTDPlotfileHeaderImpl>(snapshot_Header_filename);
+            m_snapshot_header[i_snapshot]->ReadHeaderData();
+            m_snapshot_fab_header[i_snapshot] =
+                std::make_unique<BTDMultiFabHeaderImpl>(snapshot_FabHeaderFilename);
+            m_snapshot_fab_header[i_snapshot]->ReadMultiFabHeader();
         } else {
             // Interleave Header file
             InterleaveBufferAndSnapshotHeader(recent_Header_filename,
-                                              snapshot_Header_filename);
+                                              *m_snapshot_header[i_snapshot]);
             InterleaveFabArrayHeader(recent_Buffer_FabHeaderFilename,
-                                     snapshot_FabHeaderFilename,
+                                     *m_snapshot_fab_header[i_snapshot],
                                      new_snapshotFabFilename);
             std::rename(recent_Buffer_FabFilename.c_str(),
                         snapshot_FabFilename.c_str());
@@ -716,17 +727,19 @@ void BTDiagnostics::MergeBuffersForPlotfile (int i_snapshot)
         // Destroying the recently flushed buffer directory since it is already merged.
         amrex::FileSystem::RemoveAll(recent_Buffer_filepath);
 
-    } // ParallelContext if ends
+        // The headers are not needed anymore once the snapshot is complete
+        if (m_snapshot_full[i_snapshot] == 1) {
+            m_snapshot_header[i_snapshot].reset();
+            m_snapshot_fab_header[i_snapshot].reset();
+        }
+    } // merge rank if ends
     amrex::ParallelDescriptor::Barrier();
 }
 
 void
 BTDiagnostics::InterleaveBufferAndSnapshotHeader ( std::string buffer_Header_path,
-                                                   std::string snapshot_Header_path)
+                                                   BTDPlotfileHeaderImpl& snapshot_HeaderImpl)
 {
-    BTDPlotfileHeaderImpl snapshot_HeaderImpl(snapshot_Header_path);
-    snapshot_HeaderImpl.ReadHeaderData();
-
     BTDPlotfileHeaderImpl buffer_HeaderImpl(buffer_Header_path);
     buffer_HeaderImpl.ReadHeaderData();
 
@@ -767,12 +780,9 @@ BTDiagnostics::InterleaveBufferAndSnapshotHeader ( std::string buffer_Header_pat
 
 void
 BTDiagnostics::InterleaveFabArrayHeader(std::string Buffer_FabHeader_path,
-                                        std::string snapshot_FabHeader_path,
+                                        BTDMultiFabHeaderImpl& snapshot_FabHeader,
                                         std::string newsnapshot_FabFilename)
 {
-    BTDMultiFabHeaderImpl snapshot_FabHeader(snapshot_FabHeader_path);
-    snapshot_FabHeader.ReadMultiFabHeader();
-
     BTDMultiFabHeaderImpl Buffer_FabHeader(Buffer_FabHeader_path);
     Buffer_FabHeader.ReadMultiFabHeader();
 
@@ -54,65 +54,43 @@ BackTransformFunctor::operator ()(amrex::MultiFab& mf_dst, int /*dcomp*/, const
         // Perform in-place Lorentz-transform of all the fields stored in the slice.
         LorentzTransformZ( *slice, gamma_boost, beta_boost);
 
-        // Create a 2D box for the slice in the boosted frame
         amrex::Real dx = geom.CellSize(moving_window_dir);
         // index corresponding to z_boost location in the boost-frame
         int i_boost = static_cast<int> ( ( m_current_z_boost[i_buffer]
                                             - geom.ProbLo(moving_window_dir) ) / dx );
-        // z-Slice at i_boost with x,y indices same as buffer_box
-        amrex::Box slice_box = m_buffer_box[i_buffer];
-        slice_box.setSmall(moving_window_dir, i_boost);
-        slice_box.setBig(moving_window_dir, i_boost);
-
-        // Make it a BoxArray
-        amrex::BoxArray slice_ba(slice_box);
-        slice_ba.maxSize( m_max_box_size );
-        // Define MultiFab with the distribution map of the destination multifab and
-        // containing all ten components that were in the slice generated from m_mf_src.
-        std::unique_ptr< amrex::MultiFab > tmp_slice_ptr = nullptr;
-        tmp_slice_ptr = std::make_unique<MultiFab> ( slice_ba, mf_dst.DistributionMap(),
-                                                     slice->nComp(), 0 );
-        tmp_slice_ptr->setVal(0.0);
-        // Parallel copy the lab-frame data from "slice" MultiFab with
-        // ncomp=10 and boosted-frame dmap to "tmp_slice_ptr" MultiFab with
-        // ncomp=10 and dmap of the destination Multifab, which will store the final data
-        WarpXCommUtil::ParallelCopy(*tmp_slice_ptr, *slice, 0, 0, slice->nComp(),
-                                    IntVect(AMREX_D_DECL(0, 0, 0)), IntVect(AMREX_D_DECL(0, 0, 0)));
-        // Now we will cherry pick only the user-defined fields from
-        // tmp_slice_ptr to dst_mf
+        // Cherry pick only the user-defined fields from the slice, into a compact
+        // MultiFab with the distribution map of the slice, whose boxes are shifted from
+        // i_boost to the lab-frame index k_lab of the buffer. Only these fields are then
+        // communicated to the destination MultiFab, which stores the final data.
         const int k_lab = m_k_index_zlab[i_buffer];
         const int ncomp_dst = mf_dst.nComp();
-        amrex::MultiFab& tmp = *tmp_slice_ptr;
-#ifdef AMREX_USE_GPU
-        Gpu::DeviceVector<int> d_map_varnames(m_map_varnames.size());
-        Gpu::copyAsync(Gpu::hostToDevice,
-                       m_map_varnames.begin(), m_map_varnames.end(),
-                       d_map_varnames.begin());
-        Gpu::synchronize();
-        int const* field_map_ptr = d_map_varnames.dataPtr();
-#else
-        int const* field_map_ptr = m_map_varnames.dataPtr();
+        const int shift = k_lab - i_boost;
+        amrex::BoxArray picked_ba = slice->boxArray();
+        picked_ba.shift(moving_window_dir, shift);
+        amrex::MultiFab picked(picked_ba, slice->DistributionMap(), ncomp_dst, 0);
+        int const* field_map_ptr = m_map_varnames_d.dataPtr();
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
-        for (amrex::MFIter mfi(tmp, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        for (amrex::MFIter mfi(picked, TilingIfNotGPU()); mfi.isValid(); ++mfi)
         {
             const Box& tbx = mfi.tilebox();
-            amrex::Array4<amrex::Real> src_arr = tmp[mfi].array();
-            amrex::Array4<amrex::Real> dst_arr = mf_dst[mfi].array();
+            amrex::Array4<amrex::Real const> src_arr = slice->const_array(mfi);
+            amrex::Array4<amrex::Real> dst_arr = picked.array(mfi);
             amrex::ParallelFor( tbx, ncomp_dst,
                 [=] AMREX_GPU_DEVICE(int i, int j, int k, int n)
                 {
                     const int icomp = field_map_ptr[n];
-#if (AMREX_SPACEDIM == 3)
-                    dst_arr(i, j, k_lab, n) = src_arr(i, j, k, icomp);
-#else
-                    dst_arr(i, k_lab, k, n) = src_arr(i, j, k, icomp);
-#endif
+                    amrex::IntVect iv(AMREX_D_DECL(i, j, k));
+                    iv[moving_window_dir] -= shift;
+                    dst_arr(i, j, k, n) = src_arr(iv, icomp);
                 } );
         }
+        WarpXCommUtil::ParallelCopy(mf_dst, picked, 0, 0, ncomp_dst,
+                                    IntVect(AMREX_D_DECL(0, 0, 0)), IntVect(AMREX_D_DECL(0, 0, 0)));
 
         // Reset the temporary MultiFabs generated
         slice = nullptr;
-        tmp_slice_ptr = nullptr;
     }
 
 }
@@ -158,6 +136,11 @@ BackTransformFunctor::InitData ()
     {
         m_map_varnames[i] = m_possible_fields_to_dump[ m_varnames[i] ] ;
     }
+    m_map_varnames_d.resize( m_map_varnames.size() );
+    Gpu::copyAsync(Gpu::hostToDevice,
+                   m_map_varnames.begin(), m_map_varnames.end(),
+                   m_map_varnames_d.begin());
+    Gpu::synchronize();
 
 }
 
@@ -42,19 +42,12 @@ DivEFunctor::operator()(amrex::MultiFab& mf_dst, const int dcomp, const int /*i_
 
 #ifdef WARPX_DIM_RZ
     if (m_convertRZmodes2cartesian) {
-        // In cylindrical geometry, sum real part of all modes of divE in
-        // temporary multifab mf_dst_stag, and cell-center it to mf_dst.
+        // In cylindrical geometry, sum real part of all modes of divE
+        // and cell-center it to mf_dst, in the same kernel.
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
             nComp()==1,
             "The RZ averaging over modes must write into 1 single component");
-        amrex::MultiFab mf_dst_stag(divE.boxArray(), warpx.DistributionMap(m_lev), 1, divE.nGrowVect());
-        // Mode 0
-        amrex::MultiFab::Copy(mf_dst_stag, divE, 0, 0, 1, divE.nGrowVect());
-        for (int ic=1 ; ic < divE.nComp() ; ic += 2) {
-            // Real part of all modes > 0
-            amrex::MultiFab::Add(mf_dst_stag, divE, ic, 0, 1, divE.nGrowVect());
-        }
-        CoarsenIO::Coarsen( mf_dst, mf_dst_stag, dcomp, 0, nComp(), 0,  m_crse_ratio);
+        CoarsenIO::CoarsenSumModes( mf_dst, divE, dcomp, 0, m_crse_ratio);
     } else {
         CoarsenIO::Coarsen( mf_dst, divE, dcomp, 0, nComp(), 0, m_crse_ratio);
     }
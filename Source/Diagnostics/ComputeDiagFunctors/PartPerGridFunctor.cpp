@@ -3,6 +3,7 @@
 #include "Diagnostics/ComputeDiagFunctors/ComputeDiagFunctor.H"
 #include "Particles/MultiParticleContainer.H"
 #include "Utils/CoarsenIO.H"
+#include "Utils/WarpXUtil.H"
 #include "WarpX.H"
 
 #include <AMReX_BLassert.H>
@@ -32,14 +33,20 @@ void
 PartPerGridFunctor::operator()(amrex::MultiFab& mf_dst, const int dcomp, const int /*i_buffer*/) const
 {
     auto& warpx = WarpX::GetInstance();
-    const amrex::Vector<amrex::Long>& npart_in_grid = warpx.GetPartContainer().NumberOfParticlesInGrid(m_lev);
+    // The diagnostics are computed after the redistribution of the particles, so that all the
+    // particles are valid: the sizes of the tiles are used, without a pass over the particles.
+    // Only the local grids are needed.
+    const bool only_valid = false, only_local = true;
+    const amrex::Vector<amrex::Long>& npart_in_grid =
+        warpx.GetPartContainer().NumberOfParticlesInGrid(m_lev, only_valid, only_local);
     // Guard cell is set to 1 for generality. However, for a cell-centered
     // output Multifab, mf_dst, the guard-cell data is not needed especially considering
     // the operations performend in the CoarsenAndInterpolate function.
     constexpr int ng = 1;
     // Temporary MultiFab containing number of particles per grid.
     // (stored as constant for all cells in each grid)
-    amrex::MultiFab ppg_mf(warpx.boxArray(m_lev), warpx.DistributionMap(m_lev), 1, ng);
+    amrex::MultiFab ppg_mf(warpx.boxArray(m_lev), warpx.DistributionMap(m_lev), 1, ng,
+                           amrex::MFInfo().SetArena(WarpXUtilMem::TransientArena()));
 #ifdef AMREX_USE_OMP
 #pragma omp parallel
 #endif
@@ -15,7 +15,16 @@
 #include <AMReX_IntVect.H>
 #include <AMReX_MultiFab.H>
 
+#include <map>
 #include <memory>
+#include <utility>
+
+namespace
+{
+    /** Charge densities deposited at step rho_cache_step, for each (level, species index) */
+    std::map<std::pair<int,int>, std::unique_ptr<amrex::MultiFab>> rho_cache;
+    int rho_cache_step = -1;
+}
 
 RhoFunctor::RhoFunctor (const int lev,
                         const amrex::IntVect crse_ratio,
@@ -32,57 +41,61 @@ void
 RhoFunctor::operator() ( amrex::MultiFab& mf_dst, const int dcomp, const int /*i_buffer*/ ) const
 {
     auto& warpx = WarpX::GetInstance();
-    std::unique_ptr<amrex::MultiFab> rho;
-
-    // Deposit charge density
-    // Call this with local=true since the parallel transfers will be handled
-    // by ApplyFilterandSumBoundaryRho
 
-    // Dump total rho
-    if (m_species_index == -1) {
-        auto& mypc = warpx.GetPartContainer();
-        rho = mypc.GetChargeDensity(m_lev, true);
+    if (warpx.getistep(m_lev) != rho_cache_step) {
+        ClearCache();
+        rho_cache_step = warpx.getistep(m_lev);
     }
-    // Dump rho per species
-    else {
-        auto& mypc = warpx.GetPartContainer().GetParticleContainer(m_species_index);
-        rho = mypc.GetChargeDensity(m_lev, true);
+    std::unique_ptr<amrex::MultiFab>& rho = rho_cache[std::make_pair(m_lev, m_species_index)];
+    // The grids may have changed since the deposition (load balance)
+    if (rho && !(rho->boxArray() == warpx.boxArray(m_lev) &&
+                 rho->DistributionMap() == warpx.DistributionMap(m_lev))) {
+        rho.reset();
     }
 
-    // Handle the parallel transfers of guard cells and
-    // apply the filtering if requested.
-    warpx.ApplyFilterandSumBoundaryRho(m_lev, m_lev, *rho, 0, rho->nComp());
+    if (!rho) {
+        // Deposit charge density
+        // Call this with local=true since the parallel transfers will be handled
+        // by ApplyFilterandSumBoundaryRho
+
+        // Dump total rho
+        if (m_species_index == -1) {
+            auto& mypc = warpx.GetPartContainer();
+            rho = mypc.GetChargeDensity(m_lev, true);
+        }
+        // Dump rho per species
+        else {
+            auto& mypc = warpx.GetPartContainer().GetParticleContainer(m_species_index);
+            rho = mypc.GetChargeDensity(m_lev, true);
+        }
+
+        // Handle the parallel transfers of guard cells and
+        // apply the filtering if requested.
+        warpx.ApplyFilterandSumBoundaryRho(m_lev, m_lev, *rho, 0, rho->nComp());
 
 #if (defined WARPX_DIM_RZ) && (defined WARPX_USE_PSATD)
-    // Apply k-space filtering when using the PSATD solver
-    if (WarpX::maxwell_solver_id == MaxwellSolverAlgo::PSATD)
-    {
-        if (WarpX::use_kspace_filter) {
-            auto & solver = warpx.get_spectral_solver_fp(m_lev);
-            const SpectralFieldIndex& Idx = solver.m_spectral_index;
-            solver.ForwardTransform(m_lev, *rho, Idx.rho_new);
-            solver.ApplyFilter(m_lev, Idx.rho_new);
-            solver.BackwardTransform(m_lev, *rho, Idx.rho_new);
+        // Apply k-space filtering when using the PSATD solver
+        if (WarpX::maxwell_solver_id == MaxwellSolverAlgo::PSATD)
+        {
+            if (WarpX::use_kspace_filter) {
+                auto & solver = warpx.get_spectral_solver_fp(m_lev);
+                const SpectralFieldIndex& Idx = solver.m_spectral_index;
+                solver.ForwardTransform(m_lev, *rho, Idx.rho_new);
+                solver.ApplyFilter(m_lev, Idx.rho_new);
+                solver.BackwardTransform(m_lev, *rho, Idx.rho_new);
+            }
         }
-    }
 #endif
-
+    }
 
 #ifdef WARPX_DIM_RZ
     if (m_convertRZmodes2cartesian) {
-        // In cylindrical geometry, sum real part of all modes of rho in
-        // temporary MultiFab mf_dst_stag, and cell-center it to mf_dst
+        // In cylindrical geometry, sum real part of all modes of rho
+        // and cell-center it to mf_dst, in the same kernel
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
             nComp()==1,
             "The RZ averaging over modes must write into one single component");
-        amrex::MultiFab mf_dst_stag( rho->boxArray(), warpx.DistributionMap(m_lev), 1, rho->nGrowVect() );
-        // Mode 0
-        amrex::MultiFab::Copy( mf_dst_stag, *rho, 0, 0, 1, rho->nGrowVect() );
-        for (int ic=1 ; ic < rho->nComp() ; ic += 2) {
-            // Real part of all modes > 0
-            amrex::MultiFab::Add( mf_dst_stag, *rho, ic, 0, 1, rho->nGrowVect() );
-        }
-        CoarsenIO::Coarsen( mf_dst, mf_dst_stag, dcomp, 0, nComp(), 0, m_crse_ratio );
+        CoarsenIO::CoarsenSumModes( mf_dst, *rho, dcomp, 0, m_crse_ratio );
     } else {
         CoarsenIO::Coarsen( mf_dst, *rho, dcomp, 0, nComp(), 0, m_crse_ratio );
     }
@@ -93,3 +106,10 @@ RhoFunctor::operator() ( amrex::MultiFab& mf_dst, const int dcomp, const int /*i
     amrex::ignore_unused(m_convertRZmodes2cartesian);
 #endif
 }
+
+void
+RhoFunctor::ClearCache ()
+{
+    rho_cache.clear();
+    rho_cache_step = -1;
+}
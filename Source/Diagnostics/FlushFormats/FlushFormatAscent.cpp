@@ -40,6 +40,89 @@ FlushFormatAscent::WriteToFile (
     // const auto step = istep[0];
     // WriteBlueprintFiles(bp_mesh,"bp_export",step,"hdf5");
 
+    PublishAndExecute(bp_mesh);
+
+#else
+    amrex::ignore_unused(varnames, mf, geom, iteration, time,
+        particle_diags, nlev);
+#endif // AMREX_USE_ASCENT
+    amrex::ignore_unused(prefix, plot_raw_fields, plot_raw_fields_guards);
+}
+
+void
+FlushFormatAscent::WriteZeroCopy (
+    const amrex::Vector<std::string>& varnames,
+    const amrex::Vector<amrex::Vector<amrex::MultiFab> >& fields,
+    amrex::Vector<amrex::Geometry>& geom,
+    const amrex::Vector<int>& iteration, const double time,
+    const amrex::Vector<ParticleDiag>& particle_diags, int nlev) const
+{
+#ifdef AMREX_USE_ASCENT
+    WARPX_PROFILE("FlushFormatAscent::WriteZeroCopy()");
+
+    auto & warpx = WarpX::GetInstance();
+
+    // Wrap each field on its own mesh: amrex::MultiLevelToBlueprint only references the
+    // data of the FArrayBoxes (set_external), so that the fields are not copied.
+    // The meshes must stay alive until the actions are executed.
+    WARPX_PROFILE_VAR("FlushFormatAscent::WriteZeroCopy::MultiLevelToBlueprint", prof_ascent_mesh_blueprint);
+    conduit::Node bp_mesh;
+    amrex::Vector<conduit::Node> bp_fields(varnames.size());
+    const char* origin_names[3] = {"origin/x", "origin/y", "origin/z"};
+    const char* spacing_names[3] = {"spacing/dx", "spacing/dy", "spacing/dz"};
+    for (int ivar = 0; ivar < varnames.size(); ++ivar)
+    {
+        const std::string& name = varnames[ivar];
+        conduit::Node& bp_field = bp_fields[ivar];
+        amrex::MultiLevelToBlueprint(
+            nlev, amrex::GetVecOfConstPtrs(fields[ivar]), {name}, geom, time, iteration,
+            warpx.refRatio(), bp_field);
+
+        // The blueprint cells are centered on the points where the field is defined, and
+        // each field gets its own coordset, topology and nestset, since the staggerings differ
+        const amrex::IndexType ixtype = fields[ivar][0].ixType();
+        conduit::NodeIterator itr = bp_field.children();
+        while (itr.has_next())
+        {
+            conduit::Node& domain = itr.next();
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                if (ixtype.nodeCentered(idim) && domain["coordsets/coords"].has_path(origin_names[idim])) {
+                    conduit::Node& origin = domain["coordsets/coords"][origin_names[idim]];
+                    const double spacing = domain["coordsets/coords"][spacing_names[idim]].to_double();
+                    origin.set(origin.to_double() - 0.5*spacing);
+                }
+            }
+            domain["coordsets"].rename_child("coords", "coords_" + name);
+            domain["topologies"].rename_child("topo", "topo_" + name);
+            domain["topologies/topo_" + name + "/coordset"] = "coords_" + name;
+            domain["fields/" + name + "/topology"] = "topo_" + name;
+            if (domain.has_path("fields/ascent_ghosts")) {
+                domain["fields"].rename_child("ascent_ghosts", "ascent_ghosts_" + name);
+                domain["fields/ascent_ghosts_" + name + "/topology"] = "topo_" + name;
+            }
+            if (domain.has_path("nestsets/nest")) {
+                domain["nestsets"].rename_child("nest", "nest_" + name);
+                domain["nestsets/nest_" + name + "/topology"] = "topo_" + name;
+            }
+            bp_mesh[itr.name()].update_external(domain);
+        }
+    }
+    WARPX_PROFILE_VAR_STOP(prof_ascent_mesh_blueprint);
+
+    WARPX_PROFILE_VAR("FlushFormatAscent::WriteZeroCopy::WriteParticles", prof_ascent_particles);
+    WriteParticles(particle_diags, bp_mesh);
+    WARPX_PROFILE_VAR_STOP(prof_ascent_particles);
+
+    PublishAndExecute(bp_mesh);
+#else
+    amrex::ignore_unused(varnames, fields, geom, iteration, time, particle_diags, nlev);
+#endif // AMREX_USE_ASCENT
+}
+
+#ifdef AMREX_USE_ASCENT
+void
+FlushFormatAscent::PublishAndExecute (conduit::Node& bp_mesh) const
+{
     WARPX_PROFILE_VAR("FlushFormatAscent::WriteToFile::publish", prof_ascent_publish);
     ascent::Ascent ascent;
     conduit::Node opts;
@@ -54,15 +137,8 @@ FlushFormatAscent::WriteToFile (
     ascent.execute(actions);
     ascent.close();
     WARPX_PROFILE_VAR_STOP(prof_ascent_execute);
-
-#else
-    amrex::ignore_unused(varnames, mf, geom, iteration, time,
-        particle_diags, nlev);
-#endif // AMREX_USE_ASCENT
-    amrex::ignore_unused(prefix, plot_raw_fields, plot_raw_fields_guards);
 }
 
-#ifdef AMREX_USE_ASCENT
 void
 FlushFormatAscent::WriteParticles(const amrex::Vector<ParticleDiag>& particle_diags, conduit::Node& a_bp_mesh) const
 {
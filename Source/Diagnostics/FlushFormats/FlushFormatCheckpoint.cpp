@@ -1,12 +1,17 @@
 #include "FlushFormatCheckpoint.H"
 
 #include "BoundaryConditions/PML.H"
+#include "Diagnostics/OpenPMDCheckpoint.H"
 #include "Diagnostics/ParticleDiag/ParticleDiag.H"
+#include "Parallelization/WarpXCommUtil.H"
 #include "Particles/WarpXParticleContainer.H"
 #include "Utils/WarpXProfilerWrapper.H"
 #include "WarpX.H"
 
+#include <AMReX_AsyncOut.H>
+#include <AMReX_FileSystem.H>
 #include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
 #include <AMReX_ParticleIO.H>
 #include <AMReX_PlotFileUtil.H>
 #include <AMReX_Print.H>
@@ -14,11 +19,43 @@
 #include <AMReX_Utility.H>
 #include <AMReX_VisMF.H>
 
+#include <fstream>
+#include <string>
+#include <vector>
+
 using namespace amrex;
 
 namespace
 {
     const std::string default_level_prefix {"Level_"};
+
+    /** Whether this rank is the lowest rank of its compute node */
+    bool IsNodeLeader ()
+    {
+        auto const& rank_nodes = WarpXCommUtil::RankNodes();
+        const int myproc = ParallelDescriptor::MyProc();
+        for (int rank = 0; rank < myproc; ++rank) {
+            if (rank_nodes[rank] == rank_nodes[myproc]) return false;
+        }
+        return true;
+    }
+}
+
+FlushFormatCheckpoint::FlushFormatCheckpoint (const std::string& diag_name)
+{
+    amrex::ParmParse pp_diag_name(diag_name);
+    pp_diag_name.query("checkpoint_async", m_async);
+    pp_diag_name.query("checkpoint_skip_averaged_fields", m_skip_averaged_fields);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_async || amrex::AsyncOut::UseAsyncOut(),
+        "<diag>.checkpoint_async requires amrex.async_out = 1");
+    pp_diag_name.query("checkpoint_openpmd", m_openpmd);
+    pp_diag_name.query("checkpoint_local_dir", m_local_dir);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_local_dir.empty() || (!m_async && !m_openpmd),
+        "<diag>.checkpoint_local_dir is not supported with checkpoint_async or checkpoint_openpmd");
+#ifndef WARPX_USE_OPENPMD
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_openpmd,
+        "<diag>.checkpoint_openpmd requires WarpX to be compiled with openPMD support");
+#endif
 }
 
 void
@@ -37,8 +74,6 @@ FlushFormatCheckpoint::WriteToFile (
 {
     WARPX_PROFILE("FlushFormatCheckpoint::WriteToFile()");
 
-    auto & warpx = WarpX::GetInstance();
-
     VisMF::Header::Version current_version = VisMF::GetHeaderVersion();
     VisMF::SetHeaderVersion(amrex::VisMF::Header::NoFabHeader_v1);
 
@@ -53,87 +88,122 @@ FlushFormatCheckpoint::WriteToFile (
 
     WriteJobInfo(checkpointname);
 
+    if (m_openpmd) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(nlev == 1,
+            "<diag>.checkpoint_openpmd does not support mesh refinement");
+        WriteOpenPMD(checkpointname, geom[0], particle_diags);
+        VisMF::SetHeaderVersion(current_version);
+        return;
+    }
+
+    WriteData(checkpointname, particle_diags, nlev);
+
+    VisMF::SetHeaderVersion(current_version);
+
+    if (!m_local_dir.empty()) {
+        WriteLocalCopy(checkpointname, geom, particle_diags, nlev);
+    }
+}
+
+void
+FlushFormatCheckpoint::WriteData (
+    const std::string& checkpointname,
+    const amrex::Vector<ParticleDiag>& particle_diags, int nlev) const
+{
+    auto & warpx = WarpX::GetInstance();
+
+    // With m_async, the data are copied to host buffers and written by the AsyncOut thread,
+    // in the order of the calls (the particles too, with amrex.async_out)
+    const auto WriteMultiFab = [this] (const amrex::MultiFab& mf, const std::string& name)
+    {
+        if (m_async) {
+            VisMF::AsyncWrite(mf, name);
+        } else {
+            VisMF::Write(mf, name);
+        }
+    };
+
     for (int lev = 0; lev < nlev; ++lev)
     {
-        VisMF::Write(warpx.getEfield_fp(lev, 0),
+        WriteMultiFab(warpx.getEfield_fp(lev, 0),
                      amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ex_fp"));
-        VisMF::Write(warpx.getEfield_fp(lev, 1),
+        WriteMultiFab(warpx.getEfield_fp(lev, 1),
                      amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ey_fp"));
-        VisMF::Write(warpx.getEfield_fp(lev, 2),
+        WriteMultiFab(warpx.getEfield_fp(lev, 2),
                      amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ez_fp"));
-        VisMF::Write(warpx.getBfield_fp(lev, 0),
+        WriteMultiFab(warpx.getBfield_fp(lev, 0),
                      amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bx_fp"));
-        VisMF::Write(warpx.getBfield_fp(lev, 1),
+        WriteMultiFab(warpx.getBfield_fp(lev, 1),
                      amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "By_fp"));
-        VisMF::Write(warpx.getBfield_fp(lev, 2),
+        WriteMultiFab(warpx.getBfield_fp(lev, 2),
                      amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bz_fp"));
 
-        if (WarpX::fft_do_time_averaging)
+        if (WarpX::fft_do_time_averaging && !m_skip_averaged_fields)
         {
-            VisMF::Write(warpx.getEfield_avg_fp(lev, 0),
+            WriteMultiFab(warpx.getEfield_avg_fp(lev, 0),
                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ex_avg_fp"));
-            VisMF::Write(warpx.getEfield_avg_fp(lev, 1),
+            WriteMultiFab(warpx.getEfield_avg_fp(lev, 1),
                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ey_avg_fp"));
-            VisMF::Write(warpx.getEfield_avg_fp(lev, 2),
+            WriteMultiFab(warpx.getEfield_avg_fp(lev, 2),
                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ez_avg_fp"));
 
-            VisMF::Write(warpx.getBfield_avg_fp(lev, 0),
+            WriteMultiFab(warpx.getBfield_avg_fp(lev, 0),
                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bx_avg_fp"));
-            VisMF::Write(warpx.getBfield_avg_fp(lev, 1),
+            WriteMultiFab(warpx.getBfield_avg_fp(lev, 1),
                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "By_avg_fp"));
-            VisMF::Write(warpx.getBfield_avg_fp(lev, 2),
+            WriteMultiFab(warpx.getBfield_avg_fp(lev, 2),
                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bz_avg_fp"));
         }
 
         if (warpx.getis_synchronized()) {
             // Need to save j if synchronized because after restart we need j to evolve E by dt/2.
-            VisMF::Write(warpx.getcurrent_fp(lev, 0),
+            WriteMultiFab(warpx.getcurrent_fp(lev, 0),
                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jx_fp"));
-            VisMF::Write(warpx.getcurrent_fp(lev, 1),
+            WriteMultiFab(warpx.getcurrent_fp(lev, 1),
                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jy_fp"));
-            VisMF::Write(warpx.getcurrent_fp(lev, 2),
+            WriteMultiFab(warpx.getcurrent_fp(lev, 2),
                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jz_fp"));
         }
 
         if (lev > 0)
         {
-            VisMF::Write(warpx.getEfield_cp(lev, 0),
+            WriteMultiFab(warpx.getEfield_cp(lev, 0),
                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ex_cp"));
-            VisMF::Write(warpx.getEfield_cp(lev, 1),
+            WriteMultiFab(warpx.getEfield_cp(lev, 1),
                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ey_cp"));
-            VisMF::Write(warpx.getEfield_cp(lev, 2),
+            WriteMultiFab(warpx.getEfield_cp(lev, 2),
                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ez_cp"));
-            VisMF::Write(warpx.getBfield_cp(lev, 0),
+            WriteMultiFab(warpx.getBfield_cp(lev, 0),
                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bx_cp"));
-            VisMF::Write(warpx.getBfield_cp(lev, 1),
+            WriteMultiFab(warpx.getBfield_cp(lev, 1),
                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "By_cp"));
-            VisMF::Write(warpx.getBfield_cp(lev, 2),
+            WriteMultiFab(warpx.getBfield_cp(lev, 2),
                          amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bz_cp"));
 
-            if (WarpX::fft_do_time_averaging)
+            if (WarpX::fft_do_time_averaging && !m_skip_averaged_fields)
             {
-                VisMF::Write(warpx.getEfield_avg_cp(lev, 0),
+                WriteMultiFab(warpx.getEfield_avg_cp(lev, 0),
                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ex_avg_cp"));
-                VisMF::Write(warpx.getEfield_avg_cp(lev, 1),
+                WriteMultiFab(warpx.getEfield_avg_cp(lev, 1),
                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ey_avg_cp"));
-                VisMF::Write(warpx.getEfield_avg_cp(lev, 2),
+                WriteMultiFab(warpx.getEfield_avg_cp(lev, 2),
                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ez_avg_cp"));
 
-                VisMF::Write(warpx.getBfield_avg_cp(lev, 0),
+                WriteMultiFab(warpx.getBfield_avg_cp(lev, 0),
                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bx_avg_cp"));
-                VisMF::Write(warpx.getBfield_avg_cp(lev, 1),
+                WriteMultiFab(warpx.getBfield_avg_cp(lev, 1),
                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "By_avg_cp"));
-                VisMF::Write(warpx.getBfield_avg_cp(lev, 2),
+                WriteMultiFab(warpx.getBfield_avg_cp(lev, 2),
                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bz_avg_cp"));
             }
 
             if (warpx.getis_synchronized()) {
                 // Need to save j if synchronized because after restart we need j to evolve E by dt/2.
-                VisMF::Write(warpx.getcurrent_cp(lev, 0),
+                WriteMultiFab(warpx.getcurrent_cp(lev, 0),
                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jx_cp"));
-                VisMF::Write(warpx.getcurrent_cp(lev, 1),
+                WriteMultiFab(warpx.getcurrent_cp(lev, 1),
                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jy_cp"));
-                VisMF::Write(warpx.getcurrent_cp(lev, 2),
+                WriteMultiFab(warpx.getcurrent_cp(lev, 2),
                              amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jz_cp"));
             }
         }
@@ -147,9 +217,80 @@ FlushFormatCheckpoint::WriteToFile (
     CheckpointParticles(checkpointname, particle_diags);
 
     WriteDMaps(checkpointname, nlev);
+}
+
+void
+FlushFormatCheckpoint::WriteLocalCopy (
+    const std::string& checkpointname, amrex::Vector<amrex::Geometry>& geom,
+    const amrex::Vector<ParticleDiag>& particle_diags, int nlev) const
+{
+    WARPX_PROFILE("FlushFormatCheckpoint::WriteLocalCopy()");
+
+    const std::size_t slash = checkpointname.find_last_of('/');
+    const std::string basename = (slash == std::string::npos) ?
+        checkpointname : checkpointname.substr(slash+1);
+    const std::string local_name = m_local_dir + "/" + basename;
 
+    amrex::Print() << "  Writing node-local copy of the checkpoint in " << local_name << "\n";
+
+    // The directories are created on every node (amrex only creates them on the I/O rank)
+    const bool node_leader = IsNodeLeader();
+    if (node_leader && !amrex::UtilCreateDirectory(m_local_dir, 0755)) {
+        amrex::CreateDirectoryFailed(m_local_dir);
+    }
+    amrex::PreBuildDirectorHierarchy(local_name, default_level_prefix, nlev, true);
+    if (node_leader) {
+        for (int lev = 0; lev < nlev; ++lev) {
+            const std::string level_dir = amrex::LevelFullPath(lev, local_name, default_level_prefix);
+            if (!amrex::UtilCreateDirectory(level_dir, 0755)) amrex::CreateDirectoryFailed(level_dir);
+            for (auto const& part_diag : particle_diags) {
+                const std::string species_dir = amrex::Concatenate(
+                    local_name + "/" + part_diag.getSpeciesName() + "/Level_", lev, 1);
+                if (!amrex::UtilCreateDirectory(species_dir, 0755)) amrex::CreateDirectoryFailed(species_dir);
+            }
+        }
+    }
+    ParallelDescriptor::Barrier();
+
+    VisMF::Header::Version current_version = VisMF::GetHeaderVersion();
+    VisMF::SetHeaderVersion(amrex::VisMF::Header::NoFabHeader_v1);
+
+    WriteWarpXHeader(local_name, geom);
+    WriteJobInfo(local_name);
+
+    // One file per rank, so that each rank reads back only the files written on its node:
+    // the headers are only written and read (then broadcast) by the I/O rank
+    const int nprocs = ParallelDescriptor::NProcs();
+    const int field_nfiles = VisMF::GetNOutFiles();
+    int particle_nfiles = 256;
+    ParmParse pp_particles("particles");
+    pp_particles.query("particles_nfiles", particle_nfiles);
+    VisMF::SetNOutFiles(nprocs);
+    pp_particles.add("particles_nfiles", nprocs);
+
+    WriteData(local_name, particle_diags, nlev);
+
+    VisMF::SetNOutFiles(field_nfiles);
+    pp_particles.add("particles_nfiles", particle_nfiles);
     VisMF::SetHeaderVersion(current_version);
 
+    // Each rank marks its part of the copy as complete
+    {
+        std::ofstream marker(amrex::Concatenate(local_name + "/Rank_", ParallelDescriptor::MyProc(), 5));
+        marker << ParallelDescriptor::MyProc() << "\n";
+    }
+    ParallelDescriptor::Barrier();
+
+    // Only keep the most recent copy
+    if (node_leader) {
+        std::ofstream latest(m_local_dir + "/latest", std::ios::out|std::ios::trunc);
+        latest << basename << " " << nprocs << "\n";
+        latest.close();
+        if (!m_last_local.empty() && m_last_local != local_name) {
+            amrex::FileSystem::RemoveAll(m_last_local);
+        }
+    }
+    m_last_local = local_name;
 }
 
 void
@@ -190,6 +331,34 @@ FlushFormatCheckpoint::CheckpointParticles (
     }
 }
 
+void
+FlushFormatCheckpoint::WriteOpenPMD (
+    const std::string& dir, const amrex::Geometry& geom,
+    const amrex::Vector<ParticleDiag>& particle_diags) const
+{
+    auto & warpx = WarpX::GetInstance();
+    constexpr int lev = 0;
+    const std::vector<std::string> dirs = {"x", "y", "z"};
+
+    OpenPMDCheckpoint writer(dir, false);
+    for (int idir = 0; idir < 3; ++idir) {
+        writer.WriteField("E" + dirs[idir] + "_fp", warpx.getEfield_fp(lev, idir), geom);
+        writer.WriteField("B" + dirs[idir] + "_fp", warpx.getBfield_fp(lev, idir), geom);
+        if (WarpX::fft_do_time_averaging && !m_skip_averaged_fields) {
+            writer.WriteField("E" + dirs[idir] + "_avg_fp", warpx.getEfield_avg_fp(lev, idir), geom);
+            writer.WriteField("B" + dirs[idir] + "_avg_fp", warpx.getBfield_avg_fp(lev, idir), geom);
+        }
+        if (warpx.getis_synchronized()) {
+            // Need to save j if synchronized because after restart we need j to evolve E by dt/2.
+            writer.WriteField("j" + dirs[idir] + "_fp", warpx.getcurrent_fp(lev, idir), geom);
+        }
+    }
+
+    for (const auto& part_diag : particle_diags) {
+        writer.WriteParticles(part_diag.getSpeciesName(), *part_diag.getParticleContainer());
+    }
+}
+
 void
 FlushFormatCheckpoint::WriteDMaps (const std::string& dir, int nlev) const
 {
@@ -60,6 +60,22 @@ FlushFormatOpenPMD::FlushFormatOpenPMD (const std::string& diag_name)
           encoding = openPMD::IterationEncoding::fileBased;
     }
 
+  // streaming (in-transit) output: all steps go through the same, open series
+  if ( openpmd_backend == "sst" )
+    {
+      AMREX_ALWAYS_ASSERT_WITH_MESSAGE(diag_type_str != "BackTransformed",
+          diag_name + ": the sst openPMD backend is not supported for back-transformed diagnostics");
+      if ( openPMD::IterationEncoding::fileBased == encoding )
+      {
+        if ( encodingDefined )
+        {
+          std::string warnMsg = diag_name+" Unable to stream with file based encoding. Using GroupBased ";
+          WarpX::GetInstance().RecordWarning("Diagnostics", warnMsg);
+        }
+        encoding = openPMD::IterationEncoding::groupBased;
+      }
+    }
+
   // ADIOS2 operator type & parameters
   std::string operator_type;
   pp_diag_name.query("adios2_operator.type", operator_type);
@@ -76,11 +92,32 @@ FlushFormatOpenPMD::FlushFormatOpenPMD (const std::string& diag_name)
     operator_parameters.insert({k, v});
   }
 
+  // ADIOS2 engine type & parameters (e.g. the number of aggregators)
+  std::string engine_type;
+  pp_diag_name.query("adios2_engine.type", engine_type);
+  std::string const engine_prefix = diag_name + ".adios2_engine.parameters";
+  auto engine_entr = pp.getEntries(engine_prefix);
+
+  std::map< std::string, std::string > engine_parameters;
+  auto const engine_prefix_len = engine_prefix.size() + 1;
+  for (std::string k : engine_entr) {
+    std::string v;
+    pp.get(k.c_str(), v);
+    k.erase(0, engine_prefix_len);
+    engine_parameters.insert({k, v});
+  }
+
+  // number of particles written per chunk through reused host buffers (0: whole tiles)
+  int particle_staging_size = 0;
+  pp_diag_name.query("openpmd_particle_staging_size", particle_staging_size);
+
   auto & warpx = WarpX::GetInstance();
   m_OpenPMDPlotWriter = std::make_unique<WarpXOpenPMDPlot>(
     encoding, openpmd_backend,
     operator_type, operator_parameters,
-    warpx.getPMLdirections()
+    engine_type, engine_parameters,
+    warpx.getPMLdirections(),
+    particle_staging_size
   );
 }
 
@@ -9,6 +9,7 @@
 #include "WarpX.H"
 
 #include <AMReX.H>
+#include <AMReX_AsyncOut.H>
 #include <AMReX_Box.H>
 #include <AMReX_BoxArray.H>
 #include <AMReX_Config.H>
@@ -35,10 +36,12 @@
 
 #include <algorithm>
 #include <array>
+#include <condition_variable>
 #include <cstring>
 #include <fstream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -47,6 +50,18 @@ using namespace amrex;
 namespace
 {
     const std::string default_level_prefix {"Level_"};
+
+    // Number of plotfiles submitted to the asynchronous IO thread and not written yet
+    // (shared by all the plotfile diagnostics)
+    std::mutex async_mutex;
+    std::condition_variable async_cv;
+    int async_in_flight = 0;
+}
+
+FlushFormatPlotfile::FlushFormatPlotfile ()
+{
+    ParmParse pp_diagnostics("diagnostics");
+    pp_diagnostics.query("async_out_max_in_flight", m_async_max_in_flight);
 }
 
 void
@@ -66,6 +81,17 @@ FlushFormatPlotfile::WriteToFile (
     const std::string& filename = amrex::Concatenate(prefix, iteration[0], file_min_digits);
     amrex::Print() << "  Writing plotfile " << filename << "\n";
 
+    // With asynchronous IO, the data is copied to host buffers and written by a
+    // background thread: bound the memory used by these copies by waiting for the
+    // oldest plotfiles to be written
+    const bool async_out = amrex::AsyncOut::UseAsyncOut();
+    if (async_out && m_async_max_in_flight > 0) {
+        WARPX_PROFILE("FlushFormatPlotfile::WaitAsyncOut()");
+        const int max_in_flight = m_async_max_in_flight;
+        std::unique_lock<std::mutex> lock(async_mutex);
+        async_cv.wait(lock, [max_in_flight] { return async_in_flight < max_in_flight; });
+    }
+
     Vector<std::string> rfs;
     VisMF::Header::Version current_version = VisMF::GetHeaderVersion();
     VisMF::SetHeaderVersion(amrex::VisMF::Header::Version_v1);
@@ -89,6 +115,21 @@ FlushFormatPlotfile::WriteToFile (
     WriteWarpXHeader(filename, geom);
 
     VisMF::SetHeaderVersion(current_version);
+
+    if (async_out) {
+        // This task is executed by the IO thread after the data of this plotfile is written
+        {
+            std::lock_guard<std::mutex> lock(async_mutex);
+            ++async_in_flight;
+        }
+        amrex::AsyncOut::Submit([] {
+            {
+                std::lock_guard<std::mutex> lock(async_mutex);
+                --async_in_flight;
+            }
+            async_cv.notify_all();
+        });
+    }
 }
 
 void
@@ -88,6 +88,44 @@ FlushFormatSensei::WriteToFile (
 #endif
 }
 
+void
+FlushFormatSensei::WriteZeroCopy (
+    const amrex::Vector<std::string>& varnames,
+    const amrex::Vector<amrex::Vector<amrex::MultiFab> >& fields,
+    amrex::Vector<amrex::Geometry>& geom,
+    const amrex::Vector<int>& iteration, const double time,
+    const amrex::Vector<ParticleDiag>& particle_diags, int nlev) const
+{
+    amrex::ignore_unused(geom, nlev);
+
+#ifndef AMREX_USE_SENSEI_INSITU
+    amrex::ignore_unused(varnames, fields, iteration, time, particle_diags);
+#else
+    WARPX_PROFILE("FlushFormatSensei::WriteZeroCopy()");
+
+    // one mesh array per field, since the fields have different staggerings
+    std::vector<amrex::Vector<amrex::MultiFab>*> mesh_states;
+    std::vector<std::vector<std::string>> mesh_names;
+    for (int ivar = 0; ivar < varnames.size(); ++ivar) {
+        mesh_states.push_back(const_cast<amrex::Vector<amrex::MultiFab>*>(&fields[ivar]));
+        mesh_names.push_back({varnames[ivar]});
+    }
+
+    auto particles = particle_diags[0].getParticleContainer();
+    bool didUpdate = m_insitu_bridge->update(
+        iteration[0], time, m_amr_mesh, mesh_states, mesh_names,
+        particles, {}, {}, {{"u",{0,1,2}}}, {});
+
+    if (didUpdate)
+    {
+        amrex::ErrorStream() << "FlushFormatSensei::WriteZeroCopy : "
+            "Failed to update the in situ bridge." << std::endl;
+
+        amrex::Abort();
+    }
+#endif
+}
+
 void
 FlushFormatSensei::WriteParticles (
     const amrex::Vector<ParticleDiag>& particle_diags) const
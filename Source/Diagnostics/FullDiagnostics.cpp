@@ -11,6 +11,7 @@
 #include "FlushFormats/FlushFormat.H"
 #include "Particles/MultiParticleContainer.H"
 #include "Utils/WarpXAlgorithmSelection.H"
+#include "Utils/WarpXUtil.H"
 #include "WarpX.H"
 
 #include <AMReX.H>
@@ -91,6 +92,25 @@ FullDiagnostics::ReadParameters ()
     amrex::ignore_unused(m_dump_rz_modes);
 #endif
 
+    pp_diag_name.query("insitu_zero_copy", m_insitu_zero_copy);
+    pp_diag_name.query("release_buffers", m_release_buffers);
+    if (m_insitu_zero_copy) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+            m_format == "ascent" || m_format == "sensei",
+            "<diag>.insitu_zero_copy is only supported by the ascent and sensei formats");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+            m_crse_ratio == amrex::IntVect(1) && m_dump_rz_modes == false,
+            "<diag>.insitu_zero_copy exposes the simulation fields as they are: "
+            "coarsening_ratio and dump_rz_modes cannot be used");
+        const std::vector<std::string> zero_copy_fields =
+            {"Ex", "Ey", "Ez", "Bx", "By", "Bz", "jx", "jy", "jz", "rho", "F", "G", "phi"};
+        for (const auto& var : m_varnames) {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                std::find(zero_copy_fields.begin(), zero_copy_fields.end(), var) != zero_copy_fields.end(),
+                "<diag>.insitu_zero_copy only supports fields stored in the simulation, not " + var);
+        }
+    }
+
     if (m_format == "checkpoint"){
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
             raw_specified == false &&
@@ -121,17 +141,88 @@ FullDiagnostics::Flush ( int i_buffer )
     // is supported for BackTransformed Diagnostics, in BTDiagnostics class.
     auto & warpx = WarpX::GetInstance();
 
+    if (m_insitu_zero_copy) {
+        // Alias the simulation fields (without copy), with the geometry of the simulation
+        amrex::Vector<amrex::Vector<amrex::MultiFab> > fields(m_varnames.size());
+        for (int ivar = 0; ivar < m_varnames.size(); ++ivar) {
+            for (int lev = 0; lev < nlev_output; ++lev) {
+                // One component: the real part of mode 0 in RZ
+                fields[ivar].push_back(amrex::MultiFab(*GetZeroCopyField(lev, m_varnames[ivar]),
+                                                       amrex::make_alias, 0, 1));
+            }
+        }
+        amrex::Vector<amrex::Geometry> geom(nlev_output);
+        for (int lev = 0; lev < nlev_output; ++lev) geom[lev] = warpx.Geom(lev);
+
+        m_flush_format->WriteZeroCopy(m_varnames, fields, geom, warpx.getistep(),
+                                      warpx.gett_new(0), m_output_species, nlev_output);
+        FlushRaw();
+        return;
+    }
+
     m_flush_format->WriteToFile(
         m_varnames, m_mf_output[i_buffer], m_geom_output[i_buffer], warpx.getistep(),
         warpx.gett_new(0), m_output_species, nlev_output, m_file_prefix, m_file_min_digits,
         m_plot_raw_fields, m_plot_raw_fields_guards);
 
     FlushRaw();
+
+    // The data was written (the flush formats do not keep references to it):
+    // free the output buffers until the next output
+    if (m_release_buffers) {
+        for (int lev = 0; lev < nlev_output; ++lev) {
+            m_mf_output[i_buffer][lev].clear();
+        }
+    }
 }
 
 void
 FullDiagnostics::FlushRaw () {}
 
+amrex::MultiFab*
+FullDiagnostics::GetZeroCopyField (int lev, const std::string& varname) const
+{
+    auto & warpx = WarpX::GetInstance();
+    amrex::MultiFab* mf = nullptr;
+    if      (varname == "Ex") { mf = warpx.get_pointer_Efield_aux(lev, 0); }
+    else if (varname == "Ey") { mf = warpx.get_pointer_Efield_aux(lev, 1); }
+    else if (varname == "Ez") { mf = warpx.get_pointer_Efield_aux(lev, 2); }
+    else if (varname == "Bx") { mf = warpx.get_pointer_Bfield_aux(lev, 0); }
+    else if (varname == "By") { mf = warpx.get_pointer_Bfield_aux(lev, 1); }
+    else if (varname == "Bz") { mf = warpx.get_pointer_Bfield_aux(lev, 2); }
+    else if (varname == "jx") { mf = warpx.get_pointer_current_fp(lev, 0); }
+    else if (varname == "jy") { mf = warpx.get_pointer_current_fp(lev, 1); }
+    else if (varname == "jz") { mf = warpx.get_pointer_current_fp(lev, 2); }
+    else if (varname == "rho") { mf = warpx.get_pointer_rho_fp(lev); }
+    else if (varname == "F") { mf = warpx.get_pointer_F_fp(lev); }
+    else if (varname == "G") { mf = warpx.get_pointer_G_fp(lev); }
+    else if (varname == "phi") { mf = warpx.get_pointer_phi_fp(lev); }
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(mf != nullptr,
+        "<diag>.insitu_zero_copy: the field " + varname + " is not allocated in this simulation");
+    return mf;
+}
+
+void
+FullDiagnostics::ComputeAndPack ()
+{
+    if (m_insitu_zero_copy) {
+        // the fields are used as they are, only their guard cells are filled
+        PrepareFieldDataForOutput();
+        return;
+    }
+    if (m_release_buffers) {
+        // Allocate again the output buffers freed after the previous flush
+        for (int lev = 0; lev < nlev_output; ++lev) {
+            if (!m_mf_output[0][lev].ok()) {
+                m_mf_output[0][lev].define(m_buffer_ba[lev], m_buffer_dmap[lev],
+                                           m_varnames.size(), m_buffer_ngrow,
+                                           amrex::MFInfo().SetArena(WarpXUtilMem::TransientArena()));
+            }
+        }
+    }
+    Diagnostics::ComputeAndPack();
+}
+
 
 bool
 FullDiagnostics::DoDump (int step, int /*i_buffer*/, bool force_flush)
@@ -373,7 +464,21 @@ FullDiagnostics::InitializeFieldBufferData (int i_buffer, int lev ) {
     // Allocate output MultiFab for diagnostics. The data will be stored at cell-centers.
     int ngrow = (m_format == "sensei" || m_format == "ascent") ? 1 : 0;
     // The zero is hard-coded since the number of output buffers = 1 for FullDiagnostics
-    m_mf_output[i_buffer][lev] = amrex::MultiFab(ba, dmap, m_varnames.size(), ngrow);
+    // (it is not needed when the simulation fields are exposed without copy)
+    if (!m_insitu_zero_copy) {
+        if (m_release_buffers) {
+            // Only allocated for the outputs, in ComputeAndPack
+            m_buffer_ba.resize(nmax_lev);
+            m_buffer_dmap.resize(nmax_lev);
+            m_buffer_ba[lev] = ba;
+            m_buffer_dmap[lev] = dmap;
+            m_buffer_ngrow = ngrow;
+            m_mf_output[i_buffer][lev].clear();
+        } else {
+            m_mf_output[i_buffer][lev] = amrex::MultiFab(ba, dmap, m_varnames.size(), ngrow,
+                amrex::MFInfo().SetArena(WarpXUtilMem::TransientArena()));
+        }
+    }
 
 
     if (lev == 0) {
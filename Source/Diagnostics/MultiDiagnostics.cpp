@@ -87,6 +87,15 @@ MultiDiagnostics::FilterComputePackFlushLastTimestep (int step)
     }
 }
 
+bool
+MultiDiagnostics::DoComputeAndPack (int step)
+{
+    for (auto& diag : alldiags){
+        if (diag->DoComputeAndPack(step)) return true;
+    }
+    return false;
+}
+
 void
 MultiDiagnostics::NewIteration ()
 {
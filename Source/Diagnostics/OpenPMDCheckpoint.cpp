@@ -0,0 +1,397 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "OpenPMDCheckpoint.H"
+
+#include "FieldIO.H"
+#include "Particles/WarpXParticleContainer.H"
+
+#include <AMReX.H>
+#include <AMReX_BLassert.H>
+#include <AMReX_Box.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_GpuContainers.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_IntVect.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParallelReduce.H>
+#include <AMReX_Particle.H>
+#include <AMReX_Utility.H>
+#include <AMReX_Vector.H>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace amrex;
+
+#ifdef WARPX_USE_OPENPMD
+namespace
+{
+    /** Box of the chunk of the valid box bx of a field written by its owner: along the
+     *  nodal directions, the last node is shared with the next box (except at the end of
+     *  the domain) and is written by the next box only, so that the chunks do not overlap */
+    Box WrittenBox (Box bx, const Box& domain)
+    {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            if (bx.type(idim) == IndexType::NODE && bx.bigEnd(idim) < domain.bigEnd(idim)) {
+                bx.growHi(idim, -1);
+            }
+        }
+        return bx;
+    }
+
+    /** Axis labels of the meshes, in C order */
+    std::vector<std::string> AxisLabels ()
+    {
+#if (AMREX_SPACEDIM == 3)
+        return {"z", "y", "x"};
+#else
+        return {"z", "x"};
+#endif
+    }
+}
+#endif
+
+std::string
+OpenPMDCheckpoint::SeriesPath (const std::string& dir, bool read)
+{
+    const std::string prefix = dir + "/openpmd_checkpoint.";
+#ifdef WARPX_USE_OPENPMD
+    if (read) {
+        for (const std::string ext : {"bp", "h5", "json"}) {
+            if (amrex::FileExists(prefix + ext)) return prefix + ext;
+        }
+        return "";
+    }
+#if openPMD_HAVE_ADIOS2==1
+    return prefix + "bp";
+#elif openPMD_HAVE_HDF5==1
+    return prefix + "h5";
+#else
+    return prefix + "json";
+#endif
+#else
+    amrex::ignore_unused(prefix, read);
+    return "";
+#endif
+}
+
+bool
+OpenPMDCheckpoint::Exists (const std::string& dir)
+{
+    return !SeriesPath(dir, true).empty();
+}
+
+OpenPMDCheckpoint::OpenPMDCheckpoint (const std::string& dir, bool read)
+{
+#ifdef WARPX_USE_OPENPMD
+    const std::string path = SeriesPath(dir, read);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!path.empty(), "No openPMD checkpoint in " + dir);
+    const auto access = read ? openPMD::Access::READ_ONLY : openPMD::Access::CREATE;
+#if defined(AMREX_USE_MPI)
+    m_series = std::make_unique<openPMD::Series>(path, access, ParallelDescriptor::Communicator());
+#else
+    m_series = std::make_unique<openPMD::Series>(path, access);
+#endif
+    if (!read) {
+        m_series->setIterationEncoding(openPMD::IterationEncoding::groupBased);
+    }
+#else
+    amrex::ignore_unused(dir, read);
+    amrex::Abort("openPMD checkpoints require WarpX to be compiled with openPMD support");
+#endif
+}
+
+OpenPMDCheckpoint::~OpenPMDCheckpoint ()
+{
+#ifdef WARPX_USE_OPENPMD
+    if (m_series) {
+        m_series->flush();
+    }
+#endif
+}
+
+void
+OpenPMDCheckpoint::WriteField (const std::string& name, const amrex::MultiFab& mf,
+                               const amrex::Geometry& geom)
+{
+#ifdef WARPX_USE_OPENPMD
+    const Box domain = amrex::convert(geom.Domain(), mf.ixType());
+    auto mesh = m_series->iterations[m_iteration].meshes[name];
+    mesh.setDataOrder(openPMD::Mesh::DataOrder::C);
+    mesh.setAxisLabels(AxisLabels());
+    mesh.setGridSpacing(getReversedVec(geom.CellSize()));
+    mesh.setGridGlobalOffset(getReversedVec(geom.ProbLo()));
+
+    const auto dataset = openPMD::Dataset(openPMD::determineDatatype<Real>(),
+                                          getReversedVec(domain.size()));
+
+    // host copies of the chunks, kept until they are flushed
+    Vector<std::unique_ptr<FArrayBox> > host_fabs;
+    for (int icomp = 0; icomp < mf.nComp(); ++icomp)
+    {
+        auto mesh_comp = mesh[std::to_string(icomp)];
+        mesh_comp.resetDataset(dataset);
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+        {
+            const Box bx = WrittenBox(mfi.validbox(), domain);
+            if (!bx.ok()) continue;
+            host_fabs.push_back(std::make_unique<FArrayBox>(bx, 1, The_Pinned_Arena()));
+            host_fabs.back()->copy<RunOn::Device>(mf[mfi], bx, icomp, bx, 0, 1);
+            mesh_comp.storeChunk(openPMD::shareRaw(host_fabs.back()->dataPtr()),
+                                 getReversedVec(bx.smallEnd() - domain.smallEnd()),
+                                 getReversedVec(bx.size()));
+        }
+    }
+    Gpu::streamSynchronize();
+    m_series->flush();
+#else
+    amrex::ignore_unused(name, mf, geom);
+#endif
+}
+
+bool
+OpenPMDCheckpoint::HasField (const std::string& name)
+{
+#ifdef WARPX_USE_OPENPMD
+    return m_series->iterations[m_iteration].meshes.contains(name);
+#else
+    amrex::ignore_unused(name);
+    return false;
+#endif
+}
+
+void
+OpenPMDCheckpoint::ReadField (const std::string& name, amrex::MultiFab& mf,
+                              const amrex::Geometry& geom)
+{
+#ifdef WARPX_USE_OPENPMD
+    const Box domain = amrex::convert(geom.Domain(), mf.ixType());
+    auto mesh = m_series->iterations[m_iteration].meshes[name];
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(static_cast<int>(mesh.size()) == mf.nComp(),
+        "openPMD checkpoint: wrong number of components for " + name);
+
+    // each rank only reads the chunks of its own boxes
+    Vector<std::unique_ptr<FArrayBox> > host_fabs;
+    for (int icomp = 0; icomp < mf.nComp(); ++icomp)
+    {
+        auto mesh_comp = mesh[std::to_string(icomp)];
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            host_fabs.push_back(std::make_unique<FArrayBox>(bx, 1, The_Pinned_Arena()));
+            mesh_comp.loadChunk(openPMD::shareRaw(host_fabs.back()->dataPtr()),
+                                getReversedVec(bx.smallEnd() - domain.smallEnd()),
+                                getReversedVec(bx.size()));
+        }
+    }
+    m_series->flush();
+
+    int ifab = 0;
+    for (int icomp = 0; icomp < mf.nComp(); ++icomp) {
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            const Box& bx = mfi.validbox();
+            mf[mfi].copy<RunOn::Device>(*host_fabs[ifab++], bx, 0, bx, icomp, 1);
+        }
+    }
+    Gpu::streamSynchronize();
+#else
+    amrex::ignore_unused(name, mf, geom);
+#endif
+}
+
+void
+OpenPMDCheckpoint::WriteParticles (const std::string& species_name, WarpXParticleContainer& pc)
+{
+#ifdef WARPX_USE_OPENPMD
+    using ParticleType = WarpXParticleContainer::ParticleType;
+    constexpr int lev = 0;
+    const int nreal = pc.NumRealComps();
+    const int nint = pc.NumIntComps();
+
+    // copy the particles of this rank to the host
+    Vector<ParticleType> h_aos;
+    Vector<Vector<ParticleReal> > h_real(nreal);
+    Vector<Vector<int> > h_int(nint);
+    for (WarpXParIter pti(pc, lev); pti.isValid(); ++pti)
+    {
+        const long np = pti.numParticles();
+        if (np == 0) continue;
+        const auto& aos = pti.GetArrayOfStructs();
+        const auto& soa = pti.GetStructOfArrays();
+        const auto old_np = h_aos.size();
+        h_aos.resize(old_np + np);
+        Gpu::copyAsync(Gpu::deviceToHost, aos().begin(), aos().begin() + np, h_aos.begin() + old_np);
+        for (int i = 0; i < nreal; ++i) {
+            h_real[i].resize(old_np + np);
+            Gpu::copyAsync(Gpu::deviceToHost, soa.GetRealData(i).begin(), soa.GetRealData(i).end(),
+                           h_real[i].begin() + old_np);
+        }
+        for (int i = 0; i < nint; ++i) {
+            h_int[i].resize(old_np + np);
+            Gpu::copyAsync(Gpu::deviceToHost, soa.GetIntData(i).begin(), soa.GetIntData(i).end(),
+                           h_int[i].begin() + old_np);
+        }
+    }
+    Gpu::streamSynchronize();
+
+    // offset of the particles of this rank in the global arrays
+    const long np_local = h_aos.size();
+    Vector<long> counts(ParallelDescriptor::NProcs(), 0);
+    ParallelAllGather::AllGather(np_local, counts.data(), ParallelDescriptor::Communicator());
+    long offset = 0;
+    for (int i = 0; i < ParallelDescriptor::MyProc(); ++i) offset += counts[i];
+    long np_total = 0;
+    for (const long c : counts) np_total += c;
+    if (np_total == 0) return;
+
+    auto species = m_series->iterations[m_iteration].particles[species_name];
+    const auto real_dataset = openPMD::Dataset(openPMD::determineDatatype<ParticleReal>(),
+                                               {static_cast<std::uint64_t>(np_total)});
+    const auto int_dataset = openPMD::Dataset(openPMD::determineDatatype<int>(),
+                                              {static_cast<std::uint64_t>(np_total)});
+    const auto id_dataset = openPMD::Dataset(openPMD::determineDatatype<std::uint64_t>(),
+                                             {static_cast<std::uint64_t>(np_total)});
+    const openPMD::Offset chunk_offset = {static_cast<std::uint64_t>(offset)};
+    const openPMD::Extent chunk_extent = {static_cast<std::uint64_t>(np_local)};
+
+    // positions, ids and cpus of the particles
+    Vector<Vector<ParticleReal> > h_pos(AMREX_SPACEDIM, Vector<ParticleReal>(np_local));
+    Vector<std::uint64_t> h_id(np_local);
+    Vector<int> h_cpu(np_local);
+    for (long ip = 0; ip < np_local; ++ip) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) h_pos[idim][ip] = h_aos[ip].pos(idim);
+        h_id[ip] = static_cast<std::uint64_t>(h_aos[ip].id());
+        h_cpu[ip] = h_aos[ip].cpu();
+    }
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const std::string comp = std::to_string(idim);
+        species["positionOffset"][comp].resetDataset(real_dataset);
+        species["positionOffset"][comp].makeConstant(ParticleReal(0.));
+        species["position"][comp].resetDataset(real_dataset);
+        if (np_local > 0) species["position"][comp].storeChunk(openPMD::shareRaw(h_pos[idim].dataPtr()), chunk_offset, chunk_extent);
+    }
+    const auto scalar = openPMD::RecordComponent::SCALAR;
+    species["id"][scalar].resetDataset(id_dataset);
+    species["cpu"][scalar].resetDataset(int_dataset);
+    if (np_local > 0) {
+        species["id"][scalar].storeChunk(openPMD::shareRaw(h_id.dataPtr()), chunk_offset, chunk_extent);
+        species["cpu"][scalar].storeChunk(openPMD::shareRaw(h_cpu.dataPtr()), chunk_offset, chunk_extent);
+    }
+
+    // all the components, compile-time and runtime
+    for (int i = 0; i < nreal; ++i) {
+        auto rc = species["real_" + std::to_string(i)][scalar];
+        rc.resetDataset(real_dataset);
+        if (np_local > 0) rc.storeChunk(openPMD::shareRaw(h_real[i].dataPtr()), chunk_offset, chunk_extent);
+    }
+    for (int i = 0; i < nint; ++i) {
+        auto rc = species["int_" + std::to_string(i)][scalar];
+        rc.resetDataset(int_dataset);
+        if (np_local > 0) rc.storeChunk(openPMD::shareRaw(h_int[i].dataPtr()), chunk_offset, chunk_extent);
+    }
+    m_series->flush();
+#else
+    amrex::ignore_unused(species_name, pc);
+#endif
+}
+
+void
+OpenPMDCheckpoint::ReadParticles (const std::string& species_name, WarpXParticleContainer& pc)
+{
+#ifdef WARPX_USE_OPENPMD
+    using ParticleType = WarpXParticleContainer::ParticleType;
+    auto& particles = m_series->iterations[m_iteration].particles;
+    if (!particles.contains(species_name)) return;
+    auto species = particles[species_name];
+    const auto scalar = openPMD::RecordComponent::SCALAR;
+
+    const int nreal = pc.NumRealComps();
+    const int nint = pc.NumIntComps();
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+        species.contains("real_" + std::to_string(nreal-1)) && !species.contains("real_" + std::to_string(nreal)) &&
+        (nint == 0 || species.contains("int_" + std::to_string(nint-1))) && !species.contains("int_" + std::to_string(nint)),
+        "openPMD checkpoint: the components of species " + species_name + " do not match");
+
+    // even share of the particles read by this rank
+    const long np_total = static_cast<long>(species["id"][scalar].getExtent()[0]);
+    const int nprocs = ParallelDescriptor::NProcs();
+    const int myproc = ParallelDescriptor::MyProc();
+    const long navg = np_total / nprocs;
+    const long nleft = np_total - navg * nprocs;
+    const long ibegin = (myproc < nleft) ? myproc * (navg + 1) : myproc * navg + nleft;
+    const long np = (myproc < nleft) ? navg + 1 : navg;
+    const openPMD::Offset chunk_offset = {static_cast<std::uint64_t>(ibegin)};
+    const openPMD::Extent chunk_extent = {static_cast<std::uint64_t>(np)};
+
+    Vector<Vector<ParticleReal> > h_pos(AMREX_SPACEDIM, Vector<ParticleReal>(np));
+    Vector<std::uint64_t> h_id(np);
+    Vector<int> h_cpu(np);
+    Vector<Vector<ParticleReal> > h_real(nreal, Vector<ParticleReal>(np));
+    Vector<Vector<int> > h_int(nint, Vector<int>(np));
+    if (np > 0) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            species["position"][std::to_string(idim)].loadChunk(
+                openPMD::shareRaw(h_pos[idim].dataPtr()), chunk_offset, chunk_extent);
+        }
+        species["id"][scalar].loadChunk(openPMD::shareRaw(h_id.dataPtr()), chunk_offset, chunk_extent);
+        species["cpu"][scalar].loadChunk(openPMD::shareRaw(h_cpu.dataPtr()), chunk_offset, chunk_extent);
+        for (int i = 0; i < nreal; ++i) {
+            species["real_" + std::to_string(i)][scalar].loadChunk(
+                openPMD::shareRaw(h_real[i].dataPtr()), chunk_offset, chunk_extent);
+        }
+        for (int i = 0; i < nint; ++i) {
+            species["int_" + std::to_string(i)][scalar].loadChunk(
+                openPMD::shareRaw(h_int[i].dataPtr()), chunk_offset, chunk_extent);
+        }
+    }
+    m_series->flush();
+
+    // Add to grid 0 and tile 0, as in WarpXParticleContainer::AddNParticles:
+    // Redistribute() will move them to proper places.
+    Long max_id = 0;
+    if (np > 0)
+    {
+        auto& particle_tile = pc.DefineAndReturnParticleTile(0, 0, 0);
+        using PinnedTile = ParticleTile<WarpXParticleContainer::NStructReal, WarpXParticleContainer::NStructInt,
+                                        WarpXParticleContainer::NArrayReal, WarpXParticleContainer::NArrayInt,
+                                        amrex::PinnedArenaAllocator>;
+        PinnedTile pinned_tile;
+        pinned_tile.define(pc.NumRuntimeRealComps(), pc.NumRuntimeIntComps());
+        for (long ip = 0; ip < np; ++ip) {
+            ParticleType p;
+            // the ids and cpus are kept, so that the particles can still be tracked
+            p.id() = static_cast<int>(h_id[ip]);
+            p.cpu() = h_cpu[ip];
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) p.pos(idim) = h_pos[idim][ip];
+            pinned_tile.push_back(p);
+            max_id = std::max(max_id, static_cast<Long>(h_id[ip]));
+        }
+        for (int i = 0; i < nreal; ++i) {
+            pinned_tile.push_back_real(i, h_real[i].begin(), h_real[i].end());
+        }
+        for (int i = 0; i < nint; ++i) {
+            pinned_tile.push_back_int(i, h_int[i].begin(), h_int[i].end());
+        }
+
+        auto old_np = particle_tile.numParticles();
+        auto new_np = old_np + pinned_tile.numParticles();
+        particle_tile.resize(new_np);
+        amrex::copyParticles(particle_tile, pinned_tile, 0, old_np, pinned_tile.numParticles());
+    }
+
+    // the new particles must get ids that are not used yet
+    ParallelDescriptor::ReduceLongMax(max_id);
+    if (max_id + 1 > ParticleType::NextID()) ParticleType::NextID(max_id + 1);
+
+    pc.Redistribute();
+#else
+    amrex::ignore_unused(species_name, pc);
+#endif
+}
@@ -11,8 +11,11 @@
 #include "Particles/WarpXParticleContainer.H"
 #include "Utils/IntervalsParser.H"
 #include "Utils/WarpXConst.H"
+#include "Utils/WarpXUtil.H"
 #include "WarpX.H"
 
+#include <AMReX_GpuAtomic.H>
+#include <AMReX_GpuContainers.H>
 #include <AMReX_GpuQualifiers.H>
 #include <AMReX_PODVector.H>
 #include <AMReX_ParallelDescriptor.H>
@@ -39,6 +42,16 @@ BeamRelevant::BeamRelevant (std::string rd_name)
     ParmParse pp_rd_name(rd_name);
     pp_rd_name.get("species",m_beam_name);
 
+    // read the z-slices of the slice-resolved quantities
+    queryWithParser(pp_rd_name, "slice_number", m_slice_number);
+    if (m_slice_number > 0)
+    {
+        getWithParser(pp_rd_name, "slice_z_min", m_slice_z_min);
+        getWithParser(pp_rd_name, "slice_z_max", m_slice_z_max);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_slice_z_max > m_slice_z_min,
+            "BeamRelevant: slice_z_max must be larger than slice_z_min");
+    }
+
     // resize data array
 #if (defined WARPX_DIM_3D || defined WARPX_DIM_RZ)
     //  0, 1, 2: mean x,y,z
@@ -49,7 +62,8 @@ BeamRelevant::BeamRelevant (std::string rd_name)
     //       13: rms gamma
     // 14,15,16: emittance x,y,z
     //       17: charge
-    m_data.resize(18, 0.0_rt);
+    // then, for each slice: charge, emittance x,y
+    m_data.resize(18 + 3*m_slice_number, 0.0_rt);
 #elif (defined WARPX_DIM_XZ)
     //     0, 1: mean x,z
     //  2, 3, 4: mean px,py,pz
@@ -59,7 +73,8 @@ BeamRelevant::BeamRelevant (std::string rd_name)
     //       11: rms gamma
     //    12,13: emittance x,z
     //       14: charge
-    m_data.resize(15, 0.0_rt);
+    // then, for each slice: charge, emittance x
+    m_data.resize(15 + 2*m_slice_number, 0.0_rt);
 #endif
 
     if (ParallelDescriptor::IOProcessor())
@@ -91,7 +106,14 @@ BeamRelevant::BeamRelevant (std::string rd_name)
             ofs << "[" << c++ << "]emittance_x(m)";   ofs << m_sep;
             ofs << "[" << c++ << "]emittance_y(m)";   ofs << m_sep;
             ofs << "[" << c++ << "]emittance_z(m)";   ofs << m_sep;
-            ofs << "[" << c++ << "]charge(C)";        ofs << std::endl;
+            ofs << "[" << c++ << "]charge(C)";
+            for (int is = 0; is < m_slice_number; ++is) {
+                const std::string slice = "]slice" + std::to_string(is) + "_";
+                ofs << m_sep << "[" << c++ << slice << "charge(C)";
+                ofs << m_sep << "[" << c++ << slice << "emittance_x(m)";
+                ofs << m_sep << "[" << c++ << slice << "emittance_y(m)";
+            }
+            ofs << std::endl;
 #elif (defined WARPX_DIM_XZ)
             int c = 0;
             ofs << "#";
@@ -111,7 +133,13 @@ BeamRelevant::BeamRelevant (std::string rd_name)
             ofs << "[" << c++ << "]gamma_rms()";      ofs << m_sep;
             ofs << "[" << c++ << "]emittance_x(m)";   ofs << m_sep;
             ofs << "[" << c++ << "]emittance_z(m)";   ofs << m_sep;
-            ofs << "[" << c++ << "]charge(C)";        ofs << std::endl;
+            ofs << "[" << c++ << "]charge(C)";
+            for (int is = 0; is < m_slice_number; ++is) {
+                const std::string slice = "]slice" + std::to_string(is) + "_";
+                ofs << m_sep << "[" << c++ << slice << "charge(C)";
+                ofs << m_sep << "[" << c++ << slice << "emittance_x(m)";
+            }
+            ofs << std::endl;
 #endif
             // close file
             ofs.close();
@@ -145,6 +173,12 @@ void BeamRelevant::ComputeDiags (int step)
     int const index_z = 1;
 #endif
 
+    // z-slices
+    int const n_slices = m_slice_number;
+    Real const slice_z_min = m_slice_z_min;
+    Real const inv_slice_dz = (n_slices > 0) ?
+        n_slices / (m_slice_z_max - m_slice_z_min) : 0.0_rt;
+
     // loop over species
     for (int i_s = 0; i_s < nSpecies; ++i_s)
     {
@@ -160,159 +194,162 @@ void BeamRelevant::ComputeDiags (int step)
 
         using PType = typename WarpXParticleContainer::SuperParticleType;
 
-        amrex::ReduceOps<ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum,
-        ReduceOpSum,ReduceOpSum,ReduceOpSum> reduce_ops;
-        auto r = amrex::ParticleReduce<amrex::ReduceData<ParticleReal,ParticleReal,
-        ParticleReal,ParticleReal,ParticleReal,ParticleReal,ParticleReal,ParticleReal>>(
-            myspc,
-            [=] AMREX_GPU_DEVICE(const PType& p) noexcept -> amrex::GpuTuple
-            <ParticleReal,ParticleReal,ParticleReal,ParticleReal,ParticleReal,
-            ParticleReal,ParticleReal,ParticleReal>
-            {
-                const ParticleReal p_ux = p.rdata(PIdx::ux);
-                const ParticleReal p_uy = p.rdata(PIdx::uy);
-                const ParticleReal p_uz = p.rdata(PIdx::uz);
-                const ParticleReal p_us = p_ux*p_ux + p_uy*p_uy + p_uz*p_uz;
-                const ParticleReal p_pos0 = p.pos(0);
-                const ParticleReal p_w = p.rdata(PIdx::w);
+        // The moments are accumulated in a single pass, relative to the mean values
+        // x, y, z, ux, uy, uz, gamma found by the previous evaluation (m_shift): the
+        // moments about the mean are then obtained without cancellation as long as the
+        // mean does not move by much more than the rms values. Otherwise (e.g. at the
+        // first evaluation), the pass is repeated with the new mean values.
+        // values: 0: w, 1-7: w*d, 8-14: w*d^2, 15-17: w*dx*dux, w*dy*duy, w*dz*duz,
+        // then for each slice: w, w*dx, w*dux, w*dx^2, w*dux^2, w*dx*dux, same for y
+        int constexpr n_values = 18;
+        int constexpr n_slice_values = 11;
+        std::vector<ParticleReal> values(n_values + n_slice_values*n_slices);
+        ParticleReal w_sum = 0._prt;
+        amrex::GpuArray<ParticleReal,7> mean, ms;
+        amrex::GpuArray<ParticleReal,3> cov;
+
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            amrex::GpuArray<ParticleReal,7> const shift = m_shift;
+
+            amrex::Gpu::DeviceVector<ParticleReal> d_slices(n_slice_values*n_slices, 0._prt);
+            ParticleReal* const AMREX_RESTRICT p_slices = d_slices.dataPtr();
+
+            amrex::ReduceOps<ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum,
+            ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum,
+            ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum> reduce_ops;
+            auto r = amrex::ParticleReduce<amrex::ReduceData<ParticleReal,ParticleReal,
+            ParticleReal,ParticleReal,ParticleReal,ParticleReal,ParticleReal,ParticleReal,
+            ParticleReal,ParticleReal,ParticleReal,ParticleReal,ParticleReal,ParticleReal,
+            ParticleReal,ParticleReal,ParticleReal,ParticleReal>>(
+                myspc,
+                [=] AMREX_GPU_DEVICE(const PType& p) noexcept -> amrex::GpuTuple
+                <ParticleReal,ParticleReal,ParticleReal,ParticleReal,ParticleReal,ParticleReal,
+                ParticleReal,ParticleReal,ParticleReal,ParticleReal,ParticleReal,ParticleReal,
+                ParticleReal,ParticleReal,ParticleReal,ParticleReal,ParticleReal,ParticleReal>
+                {
+                    const ParticleReal p_ux = p.rdata(PIdx::ux);
+                    const ParticleReal p_uy = p.rdata(PIdx::uy);
+                    const ParticleReal p_uz = p.rdata(PIdx::uz);
+                    const ParticleReal p_us = p_ux*p_ux + p_uy*p_uy + p_uz*p_uz;
+                    const ParticleReal p_gm = std::sqrt(1.0_rt+p_us*inv_c2);
+                    const ParticleReal p_pos0 = p.pos(0);
+                    const ParticleReal p_w = p.rdata(PIdx::w);
 
 #if (defined WARPX_DIM_RZ)
-                const ParticleReal p_theta = p.rdata(PIdx::theta);
-                const ParticleReal p_x_mean = p_pos0*std::cos(p_theta)*p_w;
-                const ParticleReal p_y_mean = p_pos0*std::sin(p_theta)*p_w;
+                    const ParticleReal p_theta = p.rdata(PIdx::theta);
+                    const ParticleReal p_x = p_pos0*std::cos(p_theta);
+                    const ParticleReal p_y = p_pos0*std::sin(p_theta);
 #else
-                const ParticleReal p_pos1 = p.pos(1);
-                const ParticleReal p_x_mean = p_pos0*p_w;
-                const ParticleReal p_y_mean = p_pos1*p_w;
+                    const ParticleReal p_pos1 = p.pos(1);
+                    const ParticleReal p_x = p_pos0;
+                    const ParticleReal p_y = p_pos1;
 #endif
-                const ParticleReal p_z_mean = p.pos(index_z)*p_w;
-
-                const ParticleReal p_ux_mean = p_ux*p_w;
-                const ParticleReal p_uy_mean = p_uy*p_w;
-                const ParticleReal p_uz_mean = p_uz*p_w;
-                const ParticleReal p_gm_mean = std::sqrt(1.0_rt+p_us*inv_c2)*p_w;
-
-                return {p_w,
-                        p_x_mean, p_y_mean, p_z_mean,
-                        p_ux_mean, p_uy_mean, p_uz_mean,
-                        p_gm_mean};
-            },
-            reduce_ops);
-
-        std::vector<ParticleReal> values_per_rank_1st = {
-            amrex::get<0>(r), // w
-            amrex::get<1>(r), // x_mean
-            amrex::get<2>(r), // y_mean
-            amrex::get<3>(r), // z_mean
-            amrex::get<4>(r), // ux_mean
-            amrex::get<5>(r), // uy_mean
-            amrex::get<6>(r), // uz_mean
-            amrex::get<7>(r), // gm_mean
-        };
-
-        // reduced sum over mpi ranks (allreduce)
-        amrex::ParallelAllReduce::Sum
-        ( values_per_rank_1st.data(), values_per_rank_1st.size(), ParallelDescriptor::Communicator());
-
-        ParticleReal w_sum   = values_per_rank_1st.at(0);
-        ParticleReal x_mean  = values_per_rank_1st.at(1) /= w_sum;
-        ParticleReal y_mean  = values_per_rank_1st.at(2) /= w_sum;
-        ParticleReal z_mean  = values_per_rank_1st.at(3) /= w_sum;
-        ParticleReal ux_mean = values_per_rank_1st.at(4) /= w_sum;
-        ParticleReal uy_mean = values_per_rank_1st.at(5) /= w_sum;
-        ParticleReal uz_mean = values_per_rank_1st.at(6) /= w_sum;
-        ParticleReal gm_mean = values_per_rank_1st.at(7) /= w_sum;
-
-        if (w_sum < std::numeric_limits<Real>::min() )
-        {
-            for (int i = 0; i < static_cast<int>(m_data.size()); ++i){
-                m_data[i] = 0.0_rt;
+                    const ParticleReal p_z = p.pos(index_z);
+
+                    const ParticleReal dx = p_x - shift[0];
+                    const ParticleReal dy = p_y - shift[1];
+                    const ParticleReal dz = p_z - shift[2];
+                    const ParticleReal dux = p_ux - shift[3];
+                    const ParticleReal duy = p_uy - shift[4];
+                    const ParticleReal duz = p_uz - shift[5];
+                    const ParticleReal dgm = p_gm - shift[6];
+
+                    if (n_slices > 0) {
+                        const int is = static_cast<int>(std::floor((p_z - slice_z_min)*inv_slice_dz));
+                        if (is >= 0 && is < n_slices) {
+                            ParticleReal* const AMREX_RESTRICT s = p_slices + n_slice_values*is;
+                            amrex::HostDevice::Atomic::Add(&s[0], p_w);
+                            amrex::HostDevice::Atomic::Add(&s[1], p_w*dx);
+                            amrex::HostDevice::Atomic::Add(&s[2], p_w*dux);
+                            amrex::HostDevice::Atomic::Add(&s[3], p_w*dx*dx);
+                            amrex::HostDevice::Atomic::Add(&s[4], p_w*dux*dux);
+                            amrex::HostDevice::Atomic::Add(&s[5], p_w*dx*dux);
+                            amrex::HostDevice::Atomic::Add(&s[6], p_w*dy);
+                            amrex::HostDevice::Atomic::Add(&s[7], p_w*duy);
+                            amrex::HostDevice::Atomic::Add(&s[8], p_w*dy*dy);
+                            amrex::HostDevice::Atomic::Add(&s[9], p_w*duy*duy);
+                            amrex::HostDevice::Atomic::Add(&s[10], p_w*dy*duy);
+                        }
+                    }
+
+                    return {p_w,
+                            p_w*dx, p_w*dy, p_w*dz, p_w*dux, p_w*duy, p_w*duz, p_w*dgm,
+                            p_w*dx*dx, p_w*dy*dy, p_w*dz*dz,
+                            p_w*dux*dux, p_w*duy*duy, p_w*duz*duz, p_w*dgm*dgm,
+                            p_w*dx*dux, p_w*dy*duy, p_w*dz*duz};
+                },
+                reduce_ops);
+
+            values[0]  = amrex::get<0>(r);
+            values[1]  = amrex::get<1>(r);
+            values[2]  = amrex::get<2>(r);
+            values[3]  = amrex::get<3>(r);
+            values[4]  = amrex::get<4>(r);
+            values[5]  = amrex::get<5>(r);
+            values[6]  = amrex::get<6>(r);
+            values[7]  = amrex::get<7>(r);
+            values[8]  = amrex::get<8>(r);
+            values[9]  = amrex::get<9>(r);
+            values[10] = amrex::get<10>(r);
+            values[11] = amrex::get<11>(r);
+            values[12] = amrex::get<12>(r);
+            values[13] = amrex::get<13>(r);
+            values[14] = amrex::get<14>(r);
+            values[15] = amrex::get<15>(r);
+            values[16] = amrex::get<16>(r);
+            values[17] = amrex::get<17>(r);
+            amrex::Gpu::copy(amrex::Gpu::deviceToHost,
+                d_slices.begin(), d_slices.end(), values.begin() + n_values);
+
+            // reduced sum over mpi ranks (allreduce), since the new shift is needed on all ranks
+            amrex::ParallelAllReduce::Sum
+            ( values.data(), values.size(), ParallelDescriptor::Communicator());
+
+            w_sum = values[0];
+            if (w_sum < std::numeric_limits<Real>::min() )
+            {
+                for (int i = 0; i < static_cast<int>(m_data.size()); ++i){
+                    m_data[i] = 0.0_rt;
+                }
+                return;
             }
-            return;
-        }
-
-        amrex::ReduceOps<ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum,
-        ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum> reduce_ops2;
 
-        auto r2 = amrex::ParticleReduce<amrex::ReduceData<ParticleReal,ParticleReal,
-        ParticleReal,ParticleReal,ParticleReal,ParticleReal,ParticleReal,ParticleReal,
-        ParticleReal,ParticleReal,ParticleReal>>(
-            myspc,
-            [=] AMREX_GPU_DEVICE(const PType& p) noexcept -> amrex::GpuTuple
-            <ParticleReal,ParticleReal,ParticleReal,ParticleReal,ParticleReal,ParticleReal,
-            ParticleReal,ParticleReal,ParticleReal,ParticleReal,ParticleReal>
-            {
-                const ParticleReal p_ux = p.rdata(PIdx::ux);
-                const ParticleReal p_uy = p.rdata(PIdx::uy);
-                const ParticleReal p_uz = p.rdata(PIdx::uz);
-                const ParticleReal p_us = p_ux*p_ux + p_uy*p_uy + p_uz*p_uz;
-                const ParticleReal p_gm = std::sqrt(1.0_rt+p_us*inv_c2);
-                const ParticleReal p_pos0 = p.pos(0);
-                const ParticleReal p_w = p.rdata(PIdx::w);
+            // moments about the mean
+            bool shift_is_far = false;
+            for (int k = 0; k < 7; ++k) {
+                const ParticleReal d_mean = values[1+k] / w_sum;
+                mean[k] = shift[k] + d_mean;
+                ms[k] = std::max(values[8+k] / w_sum - d_mean*d_mean, 0._prt);
+                // about half of the significant digits are lost
+                shift_is_far = shift_is_far || (d_mean*d_mean >
+                    ms[k] / std::sqrt(std::numeric_limits<ParticleReal>::epsilon()));
+            }
+            for (int k = 0; k < 3; ++k) {
+                cov[k] = values[15+k] / w_sum - (values[1+k] / w_sum) * (values[4+k] / w_sum);
+            }
+            m_shift = mean;
+            if (!shift_is_far) break;
+        }
 
-#if (defined WARPX_DIM_RZ)
-                const ParticleReal p_theta = p.rdata(PIdx::theta);
-                const ParticleReal p_x = p_pos0*std::cos(p_theta);
-                const ParticleReal p_y = p_pos0*std::sin(p_theta);
-#else
-                const ParticleReal p_pos1 = p.pos(1);
-                const ParticleReal p_x = p_pos0;
-                const ParticleReal p_y = p_pos1;
-#endif
-                const ParticleReal p_z = p.pos(index_z);
-
-                const ParticleReal p_x_ms = (p_x-x_mean)*(p_x-x_mean)*p_w;
-                const ParticleReal p_y_ms = (p_y-y_mean)*(p_y-y_mean)*p_w;
-                const ParticleReal p_z_ms = (p_z-z_mean)*(p_z-z_mean)*p_w;
-
-                const ParticleReal p_ux_ms = (p_ux-ux_mean)*(p_ux-ux_mean)*p_w;
-                const ParticleReal p_uy_ms = (p_uy-uy_mean)*(p_uy-uy_mean)*p_w;
-                const ParticleReal p_uz_ms = (p_uz-uz_mean)*(p_uz-uz_mean)*p_w;
-                const ParticleReal p_gm_ms = (p_gm-gm_mean)*(p_gm-gm_mean)*p_w;
-
-                const ParticleReal p_xux = (p_x-x_mean)*(p_ux-ux_mean)*p_w;
-                const ParticleReal p_yuy = (p_y-y_mean)*(p_uy-uy_mean)*p_w;
-                const ParticleReal p_zuz = (p_z-z_mean)*(p_uz-uz_mean)*p_w;
-
-                const ParticleReal p_charge = q*p_w;
-
-                return {p_x_ms, p_y_ms, p_z_ms,
-                        p_ux_ms, p_uy_ms, p_uz_ms,
-                        p_gm_ms,
-                        p_xux, p_yuy, p_zuz,
-                        p_charge};
-            },
-            reduce_ops2);
-
-        std::vector<ParticleReal> values_per_rank_2nd = {
-            amrex::get<0>(r2), // x_ms
-            amrex::get<1>(r2), // y_ms
-            amrex::get<2>(r2), // z_ms
-            amrex::get<3>(r2), // ux_ms
-            amrex::get<4>(r2), // uy_ms
-            amrex::get<5>(r2), // uz_ms
-            amrex::get<6>(r2), // gm_ms
-            amrex::get<7>(r2), // xux
-            amrex::get<8>(r2), // yuy
-            amrex::get<9>(r2), // zuz
-            amrex::get<10>(r2) // charge
-        };
-
-        // reduced sum over mpi ranks (reduce to IO rank)
-        ParallelDescriptor::ReduceRealSum
-        ( values_per_rank_2nd.data(), values_per_rank_2nd.size(), ParallelDescriptor::IOProcessorNumber());
-
-        ParticleReal x_ms   = values_per_rank_2nd.at(0) /= w_sum;
-        ParticleReal y_ms   = values_per_rank_2nd.at(1) /= w_sum;
-        ParticleReal z_ms   = values_per_rank_2nd.at(2) /= w_sum;
-        ParticleReal ux_ms  = values_per_rank_2nd.at(3) /= w_sum;
-        ParticleReal uy_ms  = values_per_rank_2nd.at(4) /= w_sum;
-        ParticleReal uz_ms  = values_per_rank_2nd.at(5) /= w_sum;
-        ParticleReal gm_ms  = values_per_rank_2nd.at(6) /= w_sum;
-        ParticleReal xux    = values_per_rank_2nd.at(7) /= w_sum;
-        ParticleReal yuy    = values_per_rank_2nd.at(8) /= w_sum;
-        ParticleReal zuz    = values_per_rank_2nd.at(9) /= w_sum;
-        ParticleReal charge = values_per_rank_2nd.at(10);
+        ParticleReal const x_mean  = mean[0];
+        ParticleReal const y_mean  = mean[1];
+        ParticleReal const z_mean  = mean[2];
+        ParticleReal const ux_mean = mean[3];
+        ParticleReal const uy_mean = mean[4];
+        ParticleReal const uz_mean = mean[5];
+        ParticleReal const gm_mean = mean[6];
+        ParticleReal const x_ms   = ms[0];
+        ParticleReal const y_ms   = ms[1];
+        ParticleReal const z_ms   = ms[2];
+        ParticleReal const ux_ms  = ms[3];
+        ParticleReal const uy_ms  = ms[4];
+        ParticleReal const uz_ms  = ms[5];
+        ParticleReal const gm_ms  = ms[6];
+        ParticleReal const xux    = cov[0];
+        ParticleReal const yuy    = cov[1];
+        ParticleReal const zuz    = cov[2];
+        ParticleReal const charge = q*w_sum;
 
         // save data
 #if (defined WARPX_DIM_3D || defined WARPX_DIM_RZ)
@@ -334,6 +371,7 @@ void BeamRelevant::ComputeDiags (int step)
         m_data[15] = std::sqrt(y_ms*uy_ms-yuy*yuy) / PhysConst::c;
         m_data[16] = std::sqrt(z_ms*uz_ms-zuz*zuz) / PhysConst::c;
         m_data[17] = charge;
+        int const n_slice_outputs = 3;
 #elif (defined WARPX_DIM_XZ)
         m_data[0]  = x_mean;
         m_data[1]  = z_mean;
@@ -350,8 +388,33 @@ void BeamRelevant::ComputeDiags (int step)
         m_data[12] = std::sqrt(x_ms*ux_ms-xux*xux) / PhysConst::c;
         m_data[13] = std::sqrt(z_ms*uz_ms-zuz*zuz) / PhysConst::c;
         m_data[14] = charge;
+        int const n_slice_outputs = 2;
         amrex::ignore_unused(y_mean, y_ms, yuy);
 #endif
+
+        // slice-resolved charge and transverse emittances
+        int const slice_start = static_cast<int>(m_data.size()) - n_slice_outputs*n_slices;
+        for (int is = 0; is < n_slices; ++is)
+        {
+            ParticleReal const* const s = values.data() + n_values + n_slice_values*is;
+            Real* const out = m_data.data() + slice_start + n_slice_outputs*is;
+            ParticleReal const ws = s[0];
+            if (ws < std::numeric_limits<Real>::min()) {
+                for (int k = 0; k < n_slice_outputs; ++k) out[k] = 0.0_rt;
+                continue;
+            }
+            out[0] = q*ws;
+            for (int k = 1; k < n_slice_outputs; ++k) {
+                // 1: x, 2: y
+                ParticleReal const* const sk = s + 1 + 5*(k-1);
+                ParticleReal const d_mean = sk[0]/ws;
+                ParticleReal const du_mean = sk[1]/ws;
+                ParticleReal const d_ms = sk[2]/ws - d_mean*d_mean;
+                ParticleReal const du_ms = sk[3]/ws - du_mean*du_mean;
+                ParticleReal const ddu = sk[4]/ws - d_mean*du_mean;
+                out[k] = std::sqrt(std::max(d_ms*du_ms - ddu*ddu, 0._prt)) / PhysConst::c;
+            }
+        }
     }
     // end loop over species
 }
@@ -0,0 +1,133 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "CommStats.H"
+
+#include "Diagnostics/ReducedDiags/ReducedDiags.H"
+#include "Parallelization/WarpXCommUtil.H"
+#include "Utils/IntervalsParser.H"
+#include "WarpX.H"
+
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_REAL.H>
+
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+using namespace amrex::literals;
+
+// constructor
+CommStats::CommStats (std::string rd_name)
+: ReducedDiags{rd_name}
+{
+    WarpXCommUtil::EnableCommStats(true);
+    // The nodes of the ranks are found collectively, before the first communication is recorded
+    WarpXCommUtil::RankNodes();
+
+    if (amrex::ParallelDescriptor::IOProcessor())
+    {
+        if ( m_IsNotRestart )
+        {
+            // open file
+            std::ofstream ofs{m_path + m_rd_name + "." + m_extension, std::ofstream::out};
+            // write header row
+            int c = 0;
+            ofs << "#";
+            ofs << "[" << c++ << "]step()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]time(s)";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]call_site()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]calls()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]messages()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]bytes(B)";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]bytes_internode(B)";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]time_max(s)";
+            ofs << std::endl;
+            // close file
+            ofs.close();
+        }
+    }
+}
+// end constructor
+
+// function that gathers the communication statistics
+void CommStats::ComputeDiags (int step)
+{
+    // Judge if the diags should be done
+    if (!m_intervals.contains(step+1)) { return; }
+
+    // The communications are collective, so that all the MPI ranks
+    // go through the same call sites, in the same order
+    const auto& stats = WarpXCommUtil::GetCommStats();
+    const int nsites = static_cast<int>(stats.size());
+
+    m_site_names.clear();
+    m_data.assign(m_nDataFields*nsites, 0.0_rt);
+    std::vector<amrex::Real> max_data(2*nsites);
+    std::vector<amrex::Real> sum_data(3*nsites);
+    int i = 0;
+    for (const auto& kv : stats) {
+        m_site_names.push_back(kv.first);
+        max_data[2*i+0] = static_cast<amrex::Real>(kv.second.ncalls);
+        max_data[2*i+1] = static_cast<amrex::Real>(kv.second.time);
+        sum_data[3*i+0] = static_cast<amrex::Real>(kv.second.nmessages);
+        sum_data[3*i+1] = static_cast<amrex::Real>(kv.second.bytes);
+        sum_data[3*i+2] = static_cast<amrex::Real>(kv.second.bytes_internode);
+        ++i;
+    }
+
+    // MPI reduction
+    const int ioproc = amrex::ParallelDescriptor::IOProcessorNumber();
+    amrex::ParallelDescriptor::ReduceRealMax(max_data.data(), 2*nsites, ioproc);
+    amrex::ParallelDescriptor::ReduceRealSum(sum_data.data(), 3*nsites, ioproc);
+
+    for (i = 0; i < nsites; ++i) {
+        m_data[m_nDataFields*i+0] = max_data[2*i+0];
+        m_data[m_nDataFields*i+1] = sum_data[3*i+0];
+        m_data[m_nDataFields*i+2] = sum_data[3*i+1];
+        m_data[m_nDataFields*i+3] = sum_data[3*i+2];
+        m_data[m_nDataFields*i+4] = max_data[2*i+1];
+    }
+
+    // The next output covers the communications since this one
+    WarpXCommUtil::ResetCommStats();
+}
+// end void CommStats::ComputeDiags
+
+// write to file function for the communication statistics
+void CommStats::WriteToFile (int step) const
+{
+    // open file
+    std::ofstream ofs{m_path + m_rd_name + "." + m_extension,
+            std::ofstream::out | std::ofstream::app};
+
+    const amrex::Real time = WarpX::GetInstance().gett_new(0);
+
+    // one line per call site
+    for (int i = 0; i < static_cast<int>(m_site_names.size()); ++i)
+    {
+        ofs << step+1 << m_sep;
+        ofs << std::fixed << std::setprecision(14) << std::scientific;
+        ofs << time << m_sep << m_site_names[i];
+        ofs << std::defaultfloat << std::setprecision(15);
+        for (int n = 0; n < m_nDataFields; ++n) {
+            ofs << m_sep << m_data[m_nDataFields*i+n];
+        }
+        ofs << std::endl;
+    }
+
+    // close file
+    ofs.close();
+}
+// end void CommStats::WriteToFile
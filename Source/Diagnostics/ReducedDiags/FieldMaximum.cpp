@@ -264,17 +264,7 @@ void FieldMaximum::ComputeDiags (int step)
         Real hv_E = amrex::get<0>(reduceE_data.value()); // highest value of |E|**2
         Real hv_B = amrex::get<0>(reduceB_data.value()); // highest value of |B|**2
 
-        // MPI reduce
-        ParallelDescriptor::ReduceRealMax(hv_Ex);
-        ParallelDescriptor::ReduceRealMax(hv_Ey);
-        ParallelDescriptor::ReduceRealMax(hv_Ez);
-        ParallelDescriptor::ReduceRealMax(hv_Bx);
-        ParallelDescriptor::ReduceRealMax(hv_By);
-        ParallelDescriptor::ReduceRealMax(hv_Bz);
-        ParallelDescriptor::ReduceRealMax(hv_E);
-        ParallelDescriptor::ReduceRealMax(hv_B);
-
-        // Fill output array
+        // Fill output array (with the values of this rank, reduced by MultiReducedDiags)
         m_data[lev*noutputs+index_Ex] = hv_Ex;
         m_data[lev*noutputs+index_Ey] = hv_Ey;
         m_data[lev*noutputs+index_Ez] = hv_Ez;
@@ -283,6 +273,7 @@ void FieldMaximum::ComputeDiags (int step)
         m_data[lev*noutputs+index_Bz] = hv_Bz;
         m_data[lev*noutputs+index_absE] = std::sqrt(hv_E);
         m_data[lev*noutputs+index_absB] = std::sqrt(hv_B);
+        DeferReduction(ReductionType::Max, lev*noutputs, noutputs);
     }
     // end loop over refinement levels
 
@@ -175,14 +175,10 @@ void FieldMomentum::ComputeDiags (int step)
                 });
         }
 
-        // MPI reduce
         auto r = reduce_data.value();
         amrex::Real ExB_x = amrex::get<0>(r);
         amrex::Real ExB_y = amrex::get<1>(r);
         amrex::Real ExB_z = amrex::get<2>(r);
-        amrex::ParallelDescriptor::ReduceRealSum(ExB_x);
-        amrex::ParallelDescriptor::ReduceRealSum(ExB_y);
-        amrex::ParallelDescriptor::ReduceRealSum(ExB_z);
 
         // Get cell size
         amrex::Geometry const & geom = warpx.Geom(lev);
@@ -192,10 +188,12 @@ void FieldMomentum::ComputeDiags (int step)
         auto dV = geom.CellSize(0) * geom.CellSize(1) * geom.CellSize(2);
 #endif
 
-        // Save data (offset: 3 values for each refinement level)
+        // Save data (offset: 3 values for each refinement level),
+        // with the values of this rank, summed by MultiReducedDiags
         const int offset = lev*3;
         m_data[offset+0] = PhysConst::ep0 * ExB_x * dV;
         m_data[offset+1] = PhysConst::ep0 * ExB_y * dV;
         m_data[offset+2] = PhysConst::ep0 * ExB_z * dV;
+        DeferReduction(ReductionType::Sum, offset, 3);
     }
 }
@@ -27,13 +27,17 @@
 #include <AMReX_RealVect.H>
 #include <AMReX_Reduce.H>
 #include <AMReX_Geometry.H>
+#include <AMReX_GpuContainers.H>
 #include <AMReX_StructOfArrays.H>
 #include <AMReX_Vector.H>
 
 #include <cmath>
+#include <fstream>
+#include <iomanip>
 #include <ostream>
 #include <string>
 #include <unordered_map>
+#include <utility>
 
 using namespace amrex;
 
@@ -72,9 +76,46 @@ FieldProbe::FieldProbe (std::string rd_name)
      *     Define whether ot not to integrate fields
      */
     amrex::ParmParse pp_rd_name(rd_name);
+
+    std::string probe_geometry_str = "Point";
+    pp_rd_name.query("probe_geometry", probe_geometry_str);
+    if (probe_geometry_str == "Point") {
+        m_probe_geometry = DetectorGeometry::Point;
+    } else if (probe_geometry_str == "Line") {
+        m_probe_geometry = DetectorGeometry::Line;
+    } else if (probe_geometry_str == "Plane") {
+        m_probe_geometry = DetectorGeometry::Plane;
+    } else {
+        amrex::Abort("Unknown FieldProbe probe_geometry: " + probe_geometry_str
+                     + " (should be Point, Line or Plane)");
+    }
+
     getWithParser(pp_rd_name, "x_probe", x_probe);
     getWithParser(pp_rd_name, "y_probe", y_probe);
     getWithParser(pp_rd_name, "z_probe", z_probe);
+    if (m_probe_geometry == DetectorGeometry::Line)
+    {
+        getWithParser(pp_rd_name, "x1_probe", x1_probe);
+        getWithParser(pp_rd_name, "y1_probe", y1_probe);
+        getWithParser(pp_rd_name, "z1_probe", z1_probe);
+        getWithParser(pp_rd_name, "resolution", m_resolution);
+    }
+    else if (m_probe_geometry == DetectorGeometry::Plane)
+    {
+#if (AMREX_SPACEDIM != 3)
+        amrex::Abort("FieldProbe probe_geometry = Plane is only supported in 3D, use a Line in 2D");
+#endif
+        getWithParser(pp_rd_name, "target_normal_x", target_normal_x);
+        getWithParser(pp_rd_name, "target_normal_y", target_normal_y);
+        getWithParser(pp_rd_name, "target_normal_z", target_normal_z);
+        getWithParser(pp_rd_name, "target_up_x", target_up_x);
+        getWithParser(pp_rd_name, "target_up_y", target_up_y);
+        getWithParser(pp_rd_name, "target_up_z", target_up_z);
+        getWithParser(pp_rd_name, "detector_radius", detector_radius);
+        getWithParser(pp_rd_name, "resolution", m_resolution);
+    }
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_resolution > 0,
+                                     "FieldProbe resolution must be positive");
     pp_rd_name.query("integrate", m_field_probe_integrate);
     pp_rd_name.query("raw_fields", raw_fields);
     pp_rd_name.query("interp_order", interp_order);
@@ -84,7 +125,8 @@ FieldProbe::FieldProbe (std::string rd_name)
     // resize data array
     m_data.resize(noutputs, 0.0_rt);
 
-    if (ParallelDescriptor::IOProcessor())
+    // the samples of a line or a plane are written by the ranks that own them
+    if (m_probe_geometry == DetectorGeometry::Point && ParallelDescriptor::IOProcessor())
     {
         if ( m_IsNotRestart )
         {
@@ -158,12 +200,88 @@ void FieldProbe::InitData ()
     amrex::Vector<amrex::ParticleReal> ypos;
     amrex::Vector<amrex::ParticleReal> zpos;
 
-    // for now, only one MPI rank adds a probe particle
+    // only one MPI rank adds the probe particles, that are then redistributed
     if (ParallelDescriptor::IOProcessor())
     {
-        xpos.push_back(x_probe);
-        ypos.push_back(y_probe);
-        zpos.push_back(z_probe);
+        if (m_probe_geometry == DetectorGeometry::Point)
+        {
+            xpos.push_back(x_probe);
+            ypos.push_back(y_probe);
+            zpos.push_back(z_probe);
+        }
+        else if (m_probe_geometry == DetectorGeometry::Line)
+        {
+            // m_resolution points from (x_probe, y_probe, z_probe) to (x1_probe, y1_probe, z1_probe)
+            const amrex::Real ds = (m_resolution > 1) ? 1._rt / (m_resolution - 1) : 0._rt;
+            for (int i = 0; i < m_resolution; ++i)
+            {
+                const amrex::Real s = i * ds;
+                xpos.push_back(x_probe + s * (x1_probe - x_probe));
+                ypos.push_back(y_probe + s * (y1_probe - y_probe));
+                zpos.push_back(z_probe + s * (z1_probe - z_probe));
+            }
+        }
+#if (AMREX_SPACEDIM == 3)
+        else
+        {
+            // square of m_resolution x m_resolution points centered on (x_probe, y_probe, z_probe),
+            // along the "up" direction (made orthogonal to the normal) and the third direction
+            amrex::RealVect normal(target_normal_x, target_normal_y, target_normal_z);
+            amrex::RealVect up(target_up_x, target_up_y, target_up_z);
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(normal.vectorLength() > 0._rt,
+                                             "FieldProbe target_normal must be non zero");
+            normal /= normal.vectorLength();
+            up -= normal.dotProduct(up) * normal;
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(up.vectorLength() > 0._rt,
+                                             "FieldProbe target_up must not be parallel to target_normal");
+            up /= up.vectorLength();
+            const amrex::RealVect side = normal.crossProduct(up);
+
+            const amrex::RealVect center(x_probe, y_probe, z_probe);
+            const amrex::Real ds = (m_resolution > 1) ? 2._rt / (m_resolution - 1) : 0._rt;
+            const amrex::Real s0 = (m_resolution > 1) ? -1._rt : 0._rt;
+            for (int j = 0; j < m_resolution; ++j)
+            {
+                for (int i = 0; i < m_resolution; ++i)
+                {
+                    const amrex::RealVect pos = center + detector_radius *
+                        ((s0 + i * ds) * side + (s0 + j * ds) * up);
+                    xpos.push_back(pos[0]);
+                    ypos.push_back(pos[1]);
+                    zpos.push_back(pos[2]);
+                }
+            }
+        }
+#endif
+
+        // only keep the probes that are in the domain
+        if (m_probe_geometry != DetectorGeometry::Point)
+        {
+            const amrex::Geometry& gm = WarpX::GetInstance().Geom(0);
+            const auto prob_lo = gm.ProbLo();
+            const auto prob_hi = gm.ProbHi();
+            amrex::Vector<amrex::ParticleReal> xin, yin, zin;
+            for (int i = 0; i < static_cast<int>(xpos.size()); ++i)
+            {
+#if (AMREX_SPACEDIM == 2)
+                const bool in_domain = xpos[i] >= prob_lo[0] && xpos[i] < prob_hi[0] &&
+                                       zpos[i] >= prob_lo[1] && zpos[i] < prob_hi[1];
+#else
+                const bool in_domain = xpos[i] >= prob_lo[0] && xpos[i] < prob_hi[0] &&
+                                       ypos[i] >= prob_lo[1] && ypos[i] < prob_hi[1] &&
+                                       zpos[i] >= prob_lo[2] && zpos[i] < prob_hi[2];
+#endif
+                if (in_domain)
+                {
+                    xin.push_back(xpos[i]);
+                    yin.push_back(ypos[i]);
+                    zin.push_back(zpos[i]);
+                }
+            }
+            xpos = std::move(xin);
+            ypos = std::move(yin);
+            zpos = std::move(zin);
+        }
     }
 
     // add np particles on lev 0 to m_probe
@@ -247,17 +365,10 @@ void FieldProbe::ComputeDiags (int step)
         {
             const auto getPosition = GetParticlePosition(pti);
 
-            if( ProbeInDomain() )
+            // the probes of a line or a plane are only created in the domain
+            if( m_probe_geometry != DetectorGeometry::Point || ProbeInDomain() )
             {
                 const auto cell_size = gm.CellSizeArray();
-                const int i_probe = static_cast<int>(amrex::Math::floor((x_probe - prob_lo[0]) / cell_size[0]));
-#if (AMREX_SPACEDIM == 2)
-                const int j_probe = static_cast<int>(amrex::Math::floor((z_probe - prob_lo[1]) / cell_size[1]));
-                const int k_probe = 0;
-#elif(AMREX_SPACEDIM == 3)
-                const int j_probe = static_cast<int>(amrex::Math::floor((y_probe - prob_lo[1]) / cell_size[1]));
-                const int k_probe = static_cast<int>(amrex::Math::floor((z_probe - prob_lo[2]) / cell_size[2]));
-#endif
                 const auto &arrEx = Ex[pti].array();
                 const auto &arrEy = Ey[pti].array();
                 const auto &arrEz = Ez[pti].array();
@@ -310,6 +421,15 @@ void FieldProbe::ComputeDiags (int step)
                     // first gather E and B to the particle positions
                     if (temp_raw_fields)
                     {
+                        // cell containing the probe
+                        const int i_probe = static_cast<int>(amrex::Math::floor((xp - prob_lo[0]) / cell_size[0]));
+#if (AMREX_SPACEDIM == 2)
+                        const int j_probe = static_cast<int>(amrex::Math::floor((zp - prob_lo[1]) / cell_size[1]));
+                        const int k_probe = 0;
+#elif(AMREX_SPACEDIM == 3)
+                        const int j_probe = static_cast<int>(amrex::Math::floor((yp - prob_lo[1]) / cell_size[1]));
+                        const int k_probe = static_cast<int>(amrex::Math::floor((zp - prob_lo[2]) / cell_size[2]));
+#endif
                         Exp = arrEx(i_probe, j_probe, k_probe);
                         Eyp = arrEy(i_probe, j_probe, k_probe);
                         Ezp = arrEz(i_probe, j_probe, k_probe);
@@ -362,7 +482,7 @@ void FieldProbe::ComputeDiags (int step)
 
                 // this check is here because for m_field_probe_integrate == True, we always compute
                 // but we only write when we truly are in an output interval step
-                if (m_intervals.contains(step+1)) {
+                if (m_probe_geometry == DetectorGeometry::Point && m_intervals.contains(step+1)) {
                     for (int ip = 0; ip < np; ip++) {
                         // Fill output array
                         m_data[ip * noutputs + FieldProbePIdx::Ex] = part_Ex[ip];
@@ -389,7 +509,7 @@ void FieldProbe::ComputeDiags (int step)
 
         // this check is here because for m_field_probe_integrate == True, we always compute
         // but we only write when we truly are in an output interval step
-        if (m_intervals.contains(step+1)) {
+        if (m_probe_geometry == DetectorGeometry::Point && m_intervals.contains(step+1)) {
             /*
              * All the processors have probe_proc = -1 except the one that contains the point, which
              * has probe_proc equal to a number >=0. Therefore, ReduceIntMax communicates to all the
@@ -410,11 +530,106 @@ void FieldProbe::ComputeDiags (int step)
             }
         } // send to IO Processor
     }// end loop over refinement levels
+
+    // the samples of a line or a plane are written by the ranks that own them
+    if (m_probe_geometry != DetectorGeometry::Point && m_intervals.contains(step+1)) {
+        WriteDistributedSamples(step);
+    }
 } // end void FieldProbe::ComputeDiags
 
+void FieldProbe::WriteDistributedSamples (int step)
+{
+    // number of probes on this rank
+    long np_local = 0;
+    const int nLevel = m_probe.finestLevel() + 1;
+    for (int lev = 0; lev < nLevel; ++lev) {
+        using MyParIter = FieldProbeParticleContainer::iterator;
+        for (MyParIter pti(m_probe, lev); pti.isValid(); ++pti) {
+            np_local += pti.numParticles();
+        }
+    }
+    if (np_local == 0) return;
+
+    const std::string filename = m_path + m_rd_name + "_rank"
+        + std::to_string(amrex::ParallelDescriptor::MyProc()) + "." + m_extension;
+
+    std::ofstream ofs;
+    if (!m_distributed_file_opened && m_IsNotRestart)
+    {
+        // new file, starting with the header row
+        ofs.open(filename, std::ofstream::out | std::ofstream::trunc);
+        int c = 0;
+        const std::string u_E = m_field_probe_integrate ? "(V*s/m)" : "(V/m)";
+        const std::string u_B = m_field_probe_integrate ? "(T*s)" : "(T)";
+        const std::string u_S = m_field_probe_integrate ? "(W*s/m^2)" : "(W/m^2)";
+        ofs << "#";
+        ofs << "[" << c++ << "]step()" << m_sep;
+        ofs << "[" << c++ << "]time(s)" << m_sep;
+        ofs << "[" << c++ << "]x(m)" << m_sep;
+        ofs << "[" << c++ << "]y(m)" << m_sep;
+        ofs << "[" << c++ << "]z(m)" << m_sep;
+        ofs << "[" << c++ << "]probe_Ex" << u_E << m_sep;
+        ofs << "[" << c++ << "]probe_Ey" << u_E << m_sep;
+        ofs << "[" << c++ << "]probe_Ez" << u_E << m_sep;
+        ofs << "[" << c++ << "]probe_Bx" << u_B << m_sep;
+        ofs << "[" << c++ << "]probe_By" << u_B << m_sep;
+        ofs << "[" << c++ << "]probe_Bz" << u_B << m_sep;
+        ofs << "[" << c++ << "]probe_S" << u_S;
+        ofs << std::endl;
+    }
+    else
+    {
+        ofs.open(filename, std::ofstream::out | std::ofstream::app);
+    }
+    m_distributed_file_opened = true;
+
+    ofs << std::fixed << std::setprecision(14) << std::scientific;
+    const amrex::Real time = WarpX::GetInstance().gett_new(0);
+    for (int lev = 0; lev < nLevel; ++lev) {
+        using MyParIter = FieldProbeParticleContainer::iterator;
+        for (MyParIter pti(m_probe, lev); pti.isValid(); ++pti)
+        {
+            const long np = pti.numParticles();
+            if (np == 0) continue;
+
+            // copy the positions and samples of the probes to the host
+            const auto getPosition = GetParticlePosition(pti);
+            amrex::Gpu::DeviceVector<amrex::ParticleReal> d_pos(3*np);
+            amrex::ParticleReal* const AMREX_RESTRICT pos = d_pos.dataPtr();
+            amrex::ParallelFor( np, [=] AMREX_GPU_DEVICE (long ip)
+            {
+                getPosition(ip, pos[3*ip], pos[3*ip+1], pos[3*ip+2]);
+            });
+            amrex::Vector<amrex::ParticleReal> h_pos(3*np);
+            amrex::Gpu::copyAsync(amrex::Gpu::deviceToHost, d_pos.begin(), d_pos.end(), h_pos.begin());
+
+            auto& attribs = pti.GetStructOfArrays().GetRealData();
+            amrex::Vector<amrex::Vector<amrex::ParticleReal> > h_attribs(noutputs);
+            for (int icomp = 0; icomp < noutputs; ++icomp) {
+                h_attribs[icomp].resize(np);
+                amrex::Gpu::copyAsync(amrex::Gpu::deviceToHost,
+                                      attribs[icomp].begin(), attribs[icomp].end(),
+                                      h_attribs[icomp].begin());
+            }
+            amrex::Gpu::streamSynchronize();
+
+            for (long ip = 0; ip < np; ++ip)
+            {
+                ofs << step+1 << m_sep << time;
+                for (int idim = 0; idim < 3; ++idim) ofs << m_sep << h_pos[3*ip+idim];
+                for (int icomp = 0; icomp < noutputs; ++icomp) ofs << m_sep << h_attribs[icomp][ip];
+                ofs << std::endl;
+            }
+        }
+    }
+    ofs.close();
+}
+
 void FieldProbe::WriteToFile (int step) const
 {
-    if (ProbeInDomain() && amrex::ParallelDescriptor::IOProcessor())
+    // the samples of a line or a plane are written in ComputeDiags, by the ranks that own them
+    if (m_probe_geometry == DetectorGeometry::Point &&
+        ProbeInDomain() && amrex::ParallelDescriptor::IOProcessor())
     {
         ReducedDiags::WriteToFile (step);
     }
@@ -7,16 +7,32 @@
 
 #include "FieldReduction.H"
 
+#include "Utils/CoarsenIO.H"
 #include "Utils/IntervalsParser.H"
 #include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXUtil.H"
+#include "WarpX.H"
 
 #include <AMReX_Algorithm.H>
+#include <AMReX_Array.H>
 #include <AMReX_BLassert.H>
+#include <AMReX_Box.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_GpuControl.H>
+#include <AMReX_GpuQualifiers.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
 #include <AMReX_ParmParse.H>
+#include <AMReX_RealBox.H>
+#include <AMReX_Reduce.H>
+#include <AMReX_Tuple.H>
 #include <AMReX_Vector.H>
 
 #include <algorithm>
+#include <fstream>
+#include <limits>
 #include <ostream>
 
 #include <regex>
@@ -40,27 +56,44 @@ FieldReduction::FieldReduction (std::string rd_name)
     AMREX_ALWAYS_ASSERT_WITH_MESSAGE(nLevel == 0,
         "FieldReduction reduced diagnostics does not work with mesh refinement.");
 
-    constexpr int noutputs = 1; // A single output in the Field reduction diagnostic
+    amrex::ParmParse pp_rd_name(rd_name);
+
+    // read the names of the reduced functions, if several functions are reduced: the function
+    // and reduction type of each are then read with the prefix <rd_name>.<name>
+    std::vector<std::string> function_names;
+    const bool several_functions = pp_rd_name.queryarr("reduced_function_names", function_names);
+    if (!several_functions) function_names.push_back("");
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!function_names.empty(),
+        "FieldReduction reduced diagnostics needs at least one reduced function.");
+
+    const int noutputs = static_cast<int>(function_names.size());
     // resize data array
     m_data.resize(noutputs, 0.0_rt);
 
-    amrex::ParmParse pp_rd_name(rd_name);
+    std::vector<std::string> column_names;
+    for (const auto& function_name : function_names)
+    {
+        amrex::ParmParse pp_function(several_functions ? rd_name + "." + function_name : rd_name);
 
-    // read reduced function with parser
-    std::string parser_string = "";
-    Store_parserString(pp_rd_name,"reduced_function(x,y,z,Ex,Ey,Ez,Bx,By,Bz)",
-                       parser_string);
-    m_parser = std::make_unique<amrex::Parser>(
-        makeParser(parser_string,{"x","y","z","Ex","Ey","Ez","Bx","By","Bz"}));
+        // read reduced function with parser
+        std::string parser_string = "";
+        Store_parserString(pp_function,"reduced_function(x,y,z,Ex,Ey,Ez,Bx,By,Bz)",
+                           parser_string);
+        m_parsers.push_back(std::make_unique<amrex::Parser>(
+            makeParser(parser_string,{"x","y","z","Ex","Ey","Ez","Bx","By","Bz"})));
 
-    // Replace all newlines and possible following whitespaces with a single whitespace. This
-    // should avoid weird formatting when the string is written in the header of the output file.
-    parser_string = std::regex_replace(parser_string, std::regex("\n\\s*"), " ");
+        // Replace all newlines and possible following whitespaces with a single whitespace. This
+        // should avoid weird formatting when the string is written in the header of the output file.
+        parser_string = std::regex_replace(parser_string, std::regex("\n\\s*"), " ");
 
-    // read reduction type
-    std::string reduction_type_string;
-    pp_rd_name.get("reduction_type", reduction_type_string);
-    m_reduction_type = GetAlgorithmInteger (pp_rd_name, "reduction_type");
+        // read reduction type
+        std::string reduction_type_string;
+        pp_function.get("reduction_type", reduction_type_string);
+        m_reduction_types.push_back(GetAlgorithmInteger (pp_function, "reduction_type"));
+
+        column_names.push_back((several_functions ? function_name + ": " : "")
+                               + reduction_type_string + " of " + parser_string + " (SI units)");
+    }
 
     if (amrex::ParallelDescriptor::IOProcessor())
     {
@@ -74,8 +107,11 @@ FieldReduction::FieldReduction (std::string rd_name)
             ofs << "[" << c++ << "]step()";
             ofs << m_sep;
             ofs << "[" << c++ << "]time(s)";
-            ofs << m_sep;
-            ofs << "[" << c++ << "]" + reduction_type_string + " of " + parser_string + " (SI units)";
+            for (const auto& column_name : column_names)
+            {
+                ofs << m_sep;
+                ofs << "[" << c++ << "]" + column_name;
+            }
 
             ofs << std::endl;
             // close file
@@ -85,23 +121,188 @@ FieldReduction::FieldReduction (std::string rd_name)
 }
 // end constructor
 
-// function that does an arbitrary reduction of the electromagnetic fields
+// function that does arbitrary reductions of the electromagnetic fields
 void FieldReduction::ComputeDiags (int step)
 {
     // Judge if the diags should be done
     if (!m_intervals.contains(step+1)) { return; }
 
-    if (m_reduction_type == ReductionType::Maximum)
-    {
-        ComputeFieldReduction<amrex::ReduceOpMax>();
+    ComputeFieldReductions();
+}
+// end void FieldReduction::ComputeDiags
+
+void FieldReduction::ComputeFieldReductions ()
+{
+    using namespace amrex::literals;
+
+    // get a reference to WarpX instance
+    auto & warpx = WarpX::GetInstance();
+
+    constexpr int lev = 0; // This reduced diag currently does not work with mesh refinement
+
+    amrex::Geometry const & geom = warpx.Geom(lev);
+    const amrex::RealBox& real_box = geom.ProbDomain();
+    const auto dx = geom.CellSizeArray();
+#if (AMREX_SPACEDIM==2)
+    const amrex::Real dV = dx[0]*dx[1];
+#else
+    const amrex::Real dV = dx[0]*dx[1]*dx[2];
+#endif
+
+    // get MultiFab data
+    const amrex::MultiFab & Ex = warpx.getEfield(lev,0);
+    const amrex::MultiFab & Ey = warpx.getEfield(lev,1);
+    const amrex::MultiFab & Ez = warpx.getEfield(lev,2);
+    const amrex::MultiFab & Bx = warpx.getBfield(lev,0);
+    const amrex::MultiFab & By = warpx.getBfield(lev,1);
+    const amrex::MultiFab & Bz = warpx.getBfield(lev,2);
+
+    // General preparation of interpolation and reduction operations
+    const amrex::GpuArray<int,3> cellCenteredtype{0,0,0};
+    const amrex::GpuArray<int,3> reduction_coarsening_ratio{1,1,1};
+    constexpr int reduction_comp = 0;
+
+    // Prepare interpolation of field components to cell center
+    // The arrays below store the index type (staggering) of each MultiFab, with the third
+    // component set to zero in the two-dimensional case.
+    auto Extype = amrex::GpuArray<int,3>{0,0,0};
+    auto Eytype = amrex::GpuArray<int,3>{0,0,0};
+    auto Eztype = amrex::GpuArray<int,3>{0,0,0};
+    auto Bxtype = amrex::GpuArray<int,3>{0,0,0};
+    auto Bytype = amrex::GpuArray<int,3>{0,0,0};
+    auto Bztype = amrex::GpuArray<int,3>{0,0,0};
+    for (int i = 0; i < AMREX_SPACEDIM; ++i){
+        Extype[i] = Ex.ixType()[i];
+        Eytype[i] = Ey.ixType()[i];
+        Eztype[i] = Ez.ixType()[i];
+        Bxtype[i] = Bx.ixType()[i];
+        Bytype[i] = By.ixType()[i];
+        Bztype[i] = Bz.ixType()[i];
     }
-    else if (m_reduction_type == ReductionType::Minimum)
-    {
-        ComputeFieldReduction<amrex::ReduceOpMin>();
+
+    // The minima are computed as maxima of the opposite functions, so that each expression
+    // uses either a slot of type Maximum or a slot of type Sum of the fused reduction
+    std::vector<int> max_functions, sum_functions;
+    for (int n = 0; n < static_cast<int>(m_reduction_types.size()); ++n) {
+        if (m_reduction_types[n] == ::ReductionType::Sum) {
+            sum_functions.push_back(n);
+        } else {
+            max_functions.push_back(n);
+        }
     }
-    else if (m_reduction_type == ReductionType::Sum)
+    const int n_max = static_cast<int>(max_functions.size());
+    const int n_sum = static_cast<int>(sum_functions.size());
+    const int npasses = std::max((n_max + m_max_fused - 1) / m_max_fused,
+                                 (n_sum + m_max_fused - 1) / m_max_fused);
+
+    static_assert(m_max_fused == 4, "The reduction tuple below has m_max_fused slots of each type");
+    amrex::ReduceOps<amrex::ReduceOpMax, amrex::ReduceOpMax, amrex::ReduceOpMax, amrex::ReduceOpMax,
+                     amrex::ReduceOpSum, amrex::ReduceOpSum, amrex::ReduceOpSum, amrex::ReduceOpSum>
+        reduce_op;
+
+    for (int ipass = 0; ipass < npasses; ++ipass)
     {
-        ComputeFieldReduction<amrex::ReduceOpSum>();
+        // expressions reduced in this pass
+        const int max_begin = std::min(ipass*m_max_fused, n_max);
+        const int sum_begin = std::min(ipass*m_max_fused, n_sum);
+        const int nmx = std::min(n_max - max_begin, static_cast<int>(m_max_fused));
+        const int nsm = std::min(n_sum - sum_begin, static_cast<int>(m_max_fused));
+        amrex::GpuArray<amrex::ParserExecutor<m_nvars>, m_max_fused> max_parsers;
+        amrex::GpuArray<amrex::ParserExecutor<m_nvars>, m_max_fused> sum_parsers;
+        amrex::GpuArray<amrex::Real, m_max_fused> max_signs;
+        for (int n = 0; n < nmx; ++n) {
+            const int ifunc = max_functions[max_begin + n];
+            max_parsers[n] = m_parsers[ifunc]->compile<m_nvars>();
+            max_signs[n] = (m_reduction_types[ifunc] == ::ReductionType::Minimum) ? -1._rt : 1._rt;
+        }
+        for (int n = 0; n < nsm; ++n) {
+            sum_parsers[n] = m_parsers[sum_functions[sum_begin + n]]->compile<m_nvars>();
+        }
+
+        amrex::ReduceData<amrex::Real, amrex::Real, amrex::Real, amrex::Real,
+                          amrex::Real, amrex::Real, amrex::Real, amrex::Real> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+
+        // MFIter loop to interpolate fields to cell center and perform reduction
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+        for ( amrex::MFIter mfi(Ex, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi )
+        {
+            // Make the box cell centered in preparation for the interpolation (and to avoid
+            // including ghost cells in the calculation)
+            const amrex::Box& box = enclosedCells(mfi.nodaltilebox());
+            const auto& arrEx = Ex[mfi].array();
+            const auto& arrEy = Ey[mfi].array();
+            const auto& arrEz = Ez[mfi].array();
+            const auto& arrBx = Bx[mfi].array();
+            const auto& arrBy = By[mfi].array();
+            const auto& arrBz = Bz[mfi].array();
+
+            reduce_op.eval(box, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+            {
+                 // 0.5 is here because position are computed on the cell centers
+                const amrex::Real x = (i + 0.5_rt)*dx[0] + real_box.lo(0);
+#if (AMREX_SPACEDIM==2)
+                const amrex::Real y = 0._rt;
+                const amrex::Real z = (j + 0.5_rt)*dx[1] + real_box.lo(1);
+#else
+                const amrex::Real y = (j + 0.5_rt)*dx[1] + real_box.lo(1);
+                const amrex::Real z = (k + 0.5_rt)*dx[2] + real_box.lo(2);
+#endif
+                const amrex::Real Ex_interp = CoarsenIO::Interp(arrEx, Extype, cellCenteredtype,
+                                        reduction_coarsening_ratio, i, j, k, reduction_comp);
+                const amrex::Real Ey_interp = CoarsenIO::Interp(arrEy, Eytype, cellCenteredtype,
+                                        reduction_coarsening_ratio, i, j, k, reduction_comp);
+                const amrex::Real Ez_interp = CoarsenIO::Interp(arrEz, Eztype, cellCenteredtype,
+                                        reduction_coarsening_ratio, i, j, k, reduction_comp);
+                const amrex::Real Bx_interp = CoarsenIO::Interp(arrBx, Bxtype, cellCenteredtype,
+                                        reduction_coarsening_ratio, i, j, k, reduction_comp);
+                const amrex::Real By_interp = CoarsenIO::Interp(arrBy, Bytype, cellCenteredtype,
+                                        reduction_coarsening_ratio, i, j, k, reduction_comp);
+                const amrex::Real Bz_interp = CoarsenIO::Interp(arrBz, Bztype, cellCenteredtype,
+                                        reduction_coarsening_ratio, i, j, k, reduction_comp);
+
+                // evaluate all the expressions of this pass with the same interpolated fields
+                amrex::Real vmax[m_max_fused];
+                amrex::Real vsum[m_max_fused];
+                for (int n = 0; n < m_max_fused; ++n) {
+                    vmax[n] = (n < nmx) ?
+                        max_signs[n]*max_parsers[n](x, y, z, Ex_interp, Ey_interp, Ez_interp,
+                                                    Bx_interp, By_interp, Bz_interp)
+                        : std::numeric_limits<amrex::Real>::lowest();
+                    vsum[n] = (n < nsm) ?
+                        sum_parsers[n](x, y, z, Ex_interp, Ey_interp, Ez_interp,
+                                       Bx_interp, By_interp, Bz_interp)
+                        : 0._rt;
+                }
+                return {vmax[0], vmax[1], vmax[2], vmax[3], vsum[0], vsum[1], vsum[2], vsum[3]};
+            });
+        }
+
+        const ReduceTuple values = reduce_data.value();
+        const amrex::GpuArray<amrex::Real, m_max_fused> local_max{
+            amrex::get<0>(values), amrex::get<1>(values), amrex::get<2>(values), amrex::get<3>(values)};
+        const amrex::GpuArray<amrex::Real, m_max_fused> local_sum{
+            amrex::get<4>(values), amrex::get<5>(values), amrex::get<6>(values), amrex::get<7>(values)};
+
+        // Fill output array with the values of this rank, reduced over the MPI ranks by
+        // MultiReducedDiags
+        for (int n = 0; n < nmx; ++n) {
+            const int ifunc = max_functions[max_begin + n];
+            m_data[ifunc] = max_signs[n]*local_max[n];
+            DeferReduction(max_signs[n] > 0._rt ? ReducedDiags::ReductionType::Max
+                                                : ReducedDiags::ReductionType::Min, ifunc);
+        }
+        for (int n = 0; n < nsm; ++n) {
+            const int ifunc = sum_functions[sum_begin + n];
+            // If reduction operation is a sum, multiply the value by the cell volume so that the
+            // result is the integral of the function over the simulation domain.
+            m_data[ifunc] = local_sum[n]*dV;
+            DeferReduction(ReducedDiags::ReductionType::Sum, ifunc);
+        }
     }
+
+    // m_data now contains up-to-date local values of the reduced field quantities
 }
-// end void FieldMaximum::ComputeDiags
@@ -37,6 +37,46 @@ using namespace amrex;
 LoadBalanceCosts::LoadBalanceCosts (std::string rd_name)
     : ReducedDiags{rd_name}
 {
+    auto& warpx = WarpX::GetInstance();
+    if (!warpx.doCostsBreakdown()) return;
+
+    const auto& mypc = warpx.GetPartContainer();
+    const auto species_names = mypc.GetSpeciesNames();
+    const std::vector<std::string> lasers_names = mypc.GetLasersNames();
+    std::vector<std::string> names = species_names;
+    names.insert(names.end(), lasers_names.begin(), lasers_names.end());
+    const int nSpecies = mypc.nSpecies();
+    m_nBreakdownFields = 3 + CostsPhase::NPhases*nSpecies + 1;
+
+    if (ParallelDescriptor::IOProcessor() && m_IsNotRestart)
+    {
+        const char* phase_names[CostsPhase::NPhases] = {"push", "deposit", "ionize", "qed", "collide"};
+        // open file
+        std::ofstream ofs{m_path + m_rd_name + "_breakdown." + m_extension, std::ofstream::out};
+        // write header row
+        int c = 0;
+        ofs << "#";
+        ofs << "[" << c++ << "]step()";
+        ofs << m_sep;
+        ofs << "[" << c++ << "]time(s)";
+        ofs << m_sep;
+        ofs << "[" << c++ << "]lev()";
+        ofs << m_sep;
+        ofs << "[" << c++ << "]box()";
+        ofs << m_sep;
+        ofs << "[" << c++ << "]proc()";
+        for (int phase = 0; phase < CostsPhase::NPhases; ++phase) {
+            for (int i_s = 0; i_s < nSpecies; ++i_s) {
+                ofs << m_sep;
+                ofs << "[" << c++ << "]" << phase_names[phase] << "_" << names[i_s] << "()";
+            }
+        }
+        ofs << m_sep;
+        ofs << "[" << c++ << "]other()";
+        ofs << std::endl;
+        // close file
+        ofs.close();
+    }
 }
 
 // function that gathers costs
@@ -126,6 +166,39 @@ void LoadBalanceCosts::ComputeDiags (int step)
                                       m_data.size(),
                                       ParallelDescriptor::IOProcessorNumber());
 
+    // breakdown of the costs (only recorded with the timers)
+    if (m_nBreakdownFields > 0)
+    {
+        const int nSpecies = warpx.GetPartContainer().nSpecies();
+        m_breakdown_data.assign(static_cast<size_t>(m_nBreakdownFields)*nBoxes, 0.0_rt);
+        int shift = 0;
+        for (int lev = 0; lev < nLevels; ++lev)
+        {
+            const amrex::DistributionMapping& dm = warpx.DistributionMap(lev);
+            for (int i : costs[lev]->IndexArray())
+            {
+                Real* const d = &m_breakdown_data[static_cast<size_t>(shift + i)*m_nBreakdownFields];
+                d[0] = lev;
+                d[1] = i;
+                d[2] = dm[i];
+                Real other = (*costs[lev])[i];
+                for (int phase = 0; phase < CostsPhase::NPhases; ++phase) {
+                    for (int i_s = 0; i_s < nSpecies; ++i_s) {
+                        const auto* cb = WarpX::getCostsBreakdown(lev, phase, i_s);
+                        const Real c = cb ? (*cb)[i] : 0.0_rt;
+                        d[3 + phase*nSpecies + i_s] = c;
+                        other -= c;
+                    }
+                }
+                d[m_nBreakdownFields-1] = std::max(other, 0.0_rt);
+            }
+            shift += costs[lev]->size();
+        }
+        ParallelDescriptor::ReduceRealSum(m_breakdown_data.data(),
+                                          m_breakdown_data.size(),
+                                          ParallelDescriptor::IOProcessorNumber());
+    }
+
 #ifdef AMREX_USE_MPI
     // now parallel reduce to IO proc and get string data (host name) over all procs
     // MPI Gatherv preliminaries
@@ -244,6 +317,25 @@ void LoadBalanceCosts::WriteToFile (int step) const
     // close file
     ofs.close();
 
+    // breakdown of the costs: one line per box
+    if (m_nBreakdownFields > 0 && ParallelDescriptor::IOProcessor())
+    {
+        std::ofstream ofsb{m_path + m_rd_name + "_breakdown." + m_extension,
+                std::ofstream::out | std::ofstream::app};
+        const int nBoxes = static_cast<int>(m_breakdown_data.size())/m_nBreakdownFields;
+        for (int ib = 0; ib < nBoxes; ++ib)
+        {
+            ofsb << step+1 << m_sep;
+            ofsb << std::fixed << std::setprecision(14) << std::scientific;
+            ofsb << WarpX::GetInstance().gett_new(0);
+            for (int n = 0; n < m_nBreakdownFields; ++n) {
+                ofsb << m_sep << m_breakdown_data[static_cast<size_t>(ib)*m_nBreakdownFields + n];
+            }
+            ofsb << std::endl;
+        }
+        ofsb.close();
+    }
+
     // get a reference to WarpX instance
     auto& warpx = WarpX::GetInstance();
 
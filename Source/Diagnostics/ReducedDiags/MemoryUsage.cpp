@@ -0,0 +1,152 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "MemoryUsage.H"
+
+#include "Diagnostics/ReducedDiags/ReducedDiags.H"
+#include "Particles/MultiParticleContainer.H"
+#include "Particles/ParticleCreation/ParticleTileCapacity.H"
+#include "Particles/WarpXParticleContainer.H"
+#include "Utils/IntervalsParser.H"
+#include "Utils/WarpXUtil.H"
+#include "WarpX.H"
+
+#include <AMReX_Arena.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_REAL.H>
+
+#include <algorithm>
+#include <fstream>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+using namespace amrex::literals;
+
+// constructor
+MemoryUsage::MemoryUsage (std::string rd_name)
+: ReducedDiags{rd_name}
+{
+    auto & warpx = WarpX::GetInstance();
+    const auto & mypc = warpx.GetPartContainer();
+    const auto species_names = mypc.GetSpeciesNames();
+
+    // names of the entries: groups of fields, species, and arena (in use and reserved)
+    std::vector<std::string> names;
+    for (const auto& f : warpx.FieldMemoryUsage()) names.push_back(f.first);
+    for (const auto& s : species_names) names.push_back(s);
+    names.push_back("arena_in_use_peak");
+    names.push_back("arena_reserved");
+    names.push_back("arena_free");
+    names.push_back("transient_arena_in_use");
+    names.push_back("transient_arena_reserved");
+
+    // total and max of each entry, minimum of the free device memory, and total and max
+    // of the number of reallocations of the tiles of the product species and of the
+    // number of growths of the arena
+    m_data.resize(m_nDataFields*names.size() + 5, 0.0_rt);
+
+    if (amrex::ParallelDescriptor::IOProcessor())
+    {
+        if ( m_IsNotRestart )
+        {
+            // open file
+            std::ofstream ofs{m_path + m_rd_name + "." + m_extension, std::ofstream::out};
+            // write header row
+            int c = 0;
+            ofs << "#";
+            ofs << "[" << c++ << "]step()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]time(s)";
+            for (const auto& name : names)
+            {
+                ofs << m_sep;
+                ofs << "[" << c++ << "]" << name << "_total(B)";
+                ofs << m_sep;
+                ofs << "[" << c++ << "]" << name << "_max(B)";
+            }
+            ofs << m_sep;
+            ofs << "[" << c++ << "]device_free_min(B)";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]product_tile_reallocations_total()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]product_tile_reallocations_max()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]arena_growths_total()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]arena_growths_max()";
+            ofs << std::endl;
+            // close file
+            ofs.close();
+        }
+    }
+}
+// end constructor
+
+// function that computes the memory usage
+void MemoryUsage::ComputeDiags (int step)
+{
+    // The arena is sampled at every step, to record its peak between two outputs
+    m_arena_peak = std::max(m_arena_peak, WarpXUtilMem::ArenaBytesInUse());
+    // and its reserved memory, to count the steps at which it had to grow
+    // (i.e. allocate device memory in the time loop)
+    const amrex::Long arena_reserved = WarpXUtilMem::ArenaBytesReserved();
+    if (arena_reserved > m_arena_reserved) {
+        if (m_arena_reserved > 0) ++m_arena_growths;
+        m_arena_reserved = arena_reserved;
+    }
+
+    // Judge if the diags should be done
+    if (!m_intervals.contains(step+1)) { return; }
+
+    auto & warpx = WarpX::GetInstance();
+    const auto & mypc = warpx.GetPartContainer();
+
+    std::vector<amrex::Long> bytes;
+    for (const auto& f : warpx.FieldMemoryUsage()) bytes.push_back(f.second);
+    for (int i_s = 0; i_s < mypc.nSpecies(); ++i_s) bytes.push_back(mypc.GetParticleContainer(i_s).BytesAllocated());
+    bytes.push_back(m_arena_peak);
+    bytes.push_back(arena_reserved);
+    bytes.push_back(arena_reserved - WarpXUtilMem::ArenaBytesInUse());
+    amrex::Arena const* transient_arena = WarpXUtilMem::TransientArena();
+    const bool has_transient_arena = (transient_arena != amrex::The_Arena());
+    bytes.push_back(has_transient_arena ? WarpXUtilMem::ArenaBytesInUse(transient_arena) : 0);
+    bytes.push_back(has_transient_arena ? WarpXUtilMem::ArenaBytesReserved(transient_arena) : 0);
+
+    const int n = static_cast<int>(bytes.size());
+    for (int i = 0; i < n; ++i)
+    {
+        m_data[m_nDataFields*i+0] = static_cast<amrex::Real>(bytes[i]);
+        m_data[m_nDataFields*i+1] = static_cast<amrex::Real>(bytes[i]);
+        DeferReduction(ReductionType::Sum, m_nDataFields*i+0);
+        DeferReduction(ReductionType::Max, m_nDataFields*i+1);
+    }
+
+#ifdef AMREX_USE_GPU
+    m_data[m_nDataFields*n] = static_cast<amrex::Real>(amrex::Gpu::Device::freeMemAvailable());
+#else
+    m_data[m_nDataFields*n] = 0.0_rt;
+#endif
+    DeferReduction(ReductionType::Min, m_nDataFields*n);
+
+    // Reallocations of the tiles of the product species since the beginning of the run
+    m_data[m_nDataFields*n+1] = static_cast<amrex::Real>(ParticleTileCapacity::num_reallocations);
+    m_data[m_nDataFields*n+2] = static_cast<amrex::Real>(ParticleTileCapacity::num_reallocations);
+    DeferReduction(ReductionType::Sum, m_nDataFields*n+1);
+    DeferReduction(ReductionType::Max, m_nDataFields*n+2);
+
+    // Growths of the arena since the beginning of the run
+    m_data[m_nDataFields*n+3] = static_cast<amrex::Real>(m_arena_growths);
+    m_data[m_nDataFields*n+4] = static_cast<amrex::Real>(m_arena_growths);
+    DeferReduction(ReductionType::Sum, m_nDataFields*n+3);
+    DeferReduction(ReductionType::Max, m_nDataFields*n+4);
+
+    // The next output records the peak since this one
+    m_arena_peak = WarpXUtilMem::ArenaBytesInUse();
+}
+// end void MemoryUsage::ComputeDiags
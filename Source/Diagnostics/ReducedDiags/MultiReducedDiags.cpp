@@ -7,6 +7,7 @@
 #include "MultiReducedDiags.H"
 
 #include "BeamRelevant.H"
+#include "CommStats.H"
 #include "FieldEnergy.H"
 #include "FieldMaximum.H"
 #include "FieldProbe.H"
@@ -14,11 +15,16 @@
 #include "FieldReduction.H"
 #include "LoadBalanceCosts.H"
 #include "LoadBalanceEfficiency.H"
+#include "MemoryUsage.H"
 #include "ParticleEnergy.H"
 #include "ParticleExtrema.H"
 #include "ParticleHistogram.H"
+#include "ParticleHistogramND.H"
+#include "ParticleMoments.H"
 #include "ParticleMomentum.H"
 #include "ParticleNumber.H"
+#include "PerformanceSummary.H"
+#include "PhaseTimers.H"
 #include "RhoMaximum.H"
 #include "Utils/IntervalsParser.H"
 
@@ -28,9 +34,11 @@
 #include <AMReX_REAL.H>
 
 #include <algorithm>
+#include <array>
 #include <functional>
 #include <iterator>
 #include <map>
+#include <vector>
 
 using namespace amrex;
 
@@ -59,8 +67,13 @@ MultiReducedDiags::MultiReducedDiags ()
             {"LoadBalanceCosts",      [](CS s){return std::make_unique<LoadBalanceCosts>(s);}},
             {"LoadBalanceEfficiency", [](CS s){return std::make_unique<LoadBalanceEfficiency>(s);}},
             {"ParticleHistogram",     [](CS s){return std::make_unique<ParticleHistogram>(s);}},
+            {"ParticleHistogramND",   [](CS s){return std::make_unique<ParticleHistogramND>(s);}},
             {"ParticleNumber",        [](CS s){return std::make_unique<ParticleNumber>(s);}},
-            {"ParticleExtrema",       [](CS s){return std::make_unique<ParticleExtrema>(s);}}
+            {"ParticleExtrema",       [](CS s){return std::make_unique<ParticleExtrema>(s);}},
+            {"CommStats",             [](CS s){return std::make_unique<CommStats>(s);}},
+            {"PhaseTimers",           [](CS s){return std::make_unique<PhaseTimers>(s);}},
+            {"MemoryUsage",           [](CS s){return std::make_unique<MemoryUsage>(s);}},
+            {"PerformanceSummary",    [](CS s){return std::make_unique<PerformanceSummary>(s);}}
         };
     // loop over all reduced diags and fill m_multi_rd with requested reduced diags
     std::transform(m_rd_names.begin(), m_rd_names.end(), std::back_inserter(m_multi_rd),
@@ -100,15 +113,63 @@ void MultiReducedDiags::LoadBalance () {
 // call functions to compute diags
 void MultiReducedDiags::ComputeDiags (int step)
 {
+    // the particle sums shared by the particle reduced diags are computed once per step
+    ParticleMoments::Invalidate();
+
     // loop over all reduced diags
     for (int i_rd = 0; i_rd < static_cast<int>(m_rd_names.size()); ++i_rd)
     {
         m_multi_rd[i_rd] -> ComputeDiags(step);
     }
     // end loop over all reduced diags
+
+    ReduceDeferred();
 }
 // end void MultiReducedDiags::ComputeDiags
 
+void MultiReducedDiags::ReduceDeferred ()
+{
+    using RT = ReducedDiags::ReductionType;
+    const std::array<RT, 3> types = {RT::Sum, RT::Min, RT::Max};
+
+    for (const RT type : types)
+    {
+        // pack the values to reduce of all reduced diags (the same on all ranks)
+        std::vector<Real> buffer;
+        for (const auto& rd : m_multi_rd) {
+            for (const auto& r : rd->m_deferred_reductions) {
+                if (r.type != type) continue;
+                buffer.insert(buffer.end(), rd->m_data.begin() + r.start,
+                              rd->m_data.begin() + r.start + r.n);
+            }
+        }
+        if (buffer.empty()) continue;
+
+        const int n = static_cast<int>(buffer.size());
+        if (type == RT::Sum) {
+            ParallelDescriptor::ReduceRealSum(buffer.data(), n);
+        } else if (type == RT::Min) {
+            ParallelDescriptor::ReduceRealMin(buffer.data(), n);
+        } else {
+            ParallelDescriptor::ReduceRealMax(buffer.data(), n);
+        }
+
+        // unpack, in the same order
+        auto it = buffer.cbegin();
+        for (auto& rd : m_multi_rd) {
+            for (const auto& r : rd->m_deferred_reductions) {
+                if (r.type != type) continue;
+                std::copy(it, it + r.n, rd->m_data.begin() + r.start);
+                it += r.n;
+            }
+        }
+    }
+
+    for (auto& rd : m_multi_rd) {
+        rd->m_deferred_reductions.clear();
+    }
+}
+
 // function to write data
 void MultiReducedDiags::WriteToFile (int step)
 {
@@ -127,3 +188,22 @@ void MultiReducedDiags::WriteToFile (int step)
     // end loop over all reduced diags
 }
 // end void MultiReducedDiags::WriteToFile
+
+void MultiReducedDiags::FinalizeDiags (int step)
+{
+    std::vector<bool> do_write(m_multi_rd.size());
+    for (int i_rd = 0; i_rd < static_cast<int>(m_rd_names.size()); ++i_rd)
+    {
+        do_write[i_rd] = m_multi_rd[i_rd]->ComputeFinalDiags(step);
+    }
+
+    ReduceDeferred();
+
+    // Only the I/O rank does
+    if ( !ParallelDescriptor::IOProcessor() ) { return; }
+
+    for (int i_rd = 0; i_rd < static_cast<int>(m_rd_names.size()); ++i_rd)
+    {
+        if (do_write[i_rd]) m_multi_rd[i_rd]->WriteFinalToFile(step);
+    }
+}
@@ -165,12 +165,20 @@ ParticleExtrema::ParticleExtrema (std::string rd_name)
 // function that computes extrema
 void ParticleExtrema::ComputeDiags (int step)
 {
-    // Judge if the diags should be done
-    if (!m_intervals.contains(step+1)) { return; }
-
     // get MultiParticleContainer class object
     auto & mypc = WarpX::GetInstance().GetPartContainer();
 
+#if (defined WARPX_QED)
+    // Ask the push of the next step to record the extrema of chi, if they are output then
+    if (m_intervals.contains(step+2)) {
+        auto & myspc = mypc.GetParticleContainerFromName(m_species_name);
+        if (myspc.DoQED()) myspc.RequestChiExtrema(step+2);
+    }
+#endif
+
+    // Judge if the diags should be done
+    if (!m_intervals.contains(step+1)) { return; }
+
     // get number of species (int)
     const auto nSpecies = mypc.nSpecies();
 
@@ -210,12 +218,10 @@ void ParticleExtrema::ComputeDiags (int step)
         Real xmin = ReduceMin( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(0)*std::cos(p.rdata(PIdx::theta)); });
-        ParallelDescriptor::ReduceRealMin(xmin);
 #else
         Real xmin = ReduceMin( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(0); });
-        ParallelDescriptor::ReduceRealMin(xmin);
 #endif
 
         // xmax
@@ -223,12 +229,10 @@ void ParticleExtrema::ComputeDiags (int step)
         Real xmax = ReduceMax( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(0)*std::cos(p.rdata(PIdx::theta)); });
-        ParallelDescriptor::ReduceRealMax(xmax);
 #else
         Real xmax = ReduceMax( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(0); });
-        ParallelDescriptor::ReduceRealMax(xmax);
 #endif
 
         // ymin
@@ -236,14 +240,12 @@ void ParticleExtrema::ComputeDiags (int step)
         Real ymin = ReduceMin( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(0)*std::sin(p.rdata(PIdx::theta)); });
-        ParallelDescriptor::ReduceRealMin(ymin);
 #elif (defined WARPX_DIM_XZ)
         Real ymin = 0.0_rt;
 #else
         Real ymin = ReduceMin( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(1); });
-        ParallelDescriptor::ReduceRealMin(ymin);
 #endif
 
         // ymax
@@ -251,63 +253,53 @@ void ParticleExtrema::ComputeDiags (int step)
         Real ymax = ReduceMax( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(0)*std::sin(p.rdata(PIdx::theta)); });
-        ParallelDescriptor::ReduceRealMax(ymax);
 #elif (defined WARPX_DIM_XZ)
         Real ymax = 0.0_rt;
 #else
         Real ymax = ReduceMax( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(1); });
-        ParallelDescriptor::ReduceRealMax(ymax);
 #endif
 
         // zmin
         Real zmin = ReduceMin( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(index_z); });
-        ParallelDescriptor::ReduceRealMin(zmin);
 
         // zmax
         Real zmax = ReduceMax( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.pos(index_z); });
-        ParallelDescriptor::ReduceRealMax(zmax);
 
         // uxmin
         Real uxmin = ReduceMin( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.rdata(PIdx::ux); });
-        ParallelDescriptor::ReduceRealMin(uxmin);
 
         // uxmax
         Real uxmax = ReduceMax( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.rdata(PIdx::ux); });
-        ParallelDescriptor::ReduceRealMax(uxmax);
 
         // uymin
         Real uymin = ReduceMin( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.rdata(PIdx::uy); });
-        ParallelDescriptor::ReduceRealMin(uymin);
 
         // uymax
         Real uymax = ReduceMax( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.rdata(PIdx::uy); });
-        ParallelDescriptor::ReduceRealMax(uymax);
 
         // uzmin
         Real uzmin = ReduceMin( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.rdata(PIdx::uz); });
-        ParallelDescriptor::ReduceRealMin(uzmin);
 
         // uzmax
         Real uzmax = ReduceMax( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.rdata(PIdx::uz); });
-        ParallelDescriptor::ReduceRealMax(uzmax);
 
         // gmin
         Real gmin = 0.0_rt;
@@ -332,7 +324,6 @@ void ParticleExtrema::ComputeDiags (int step)
                 return std::sqrt(1.0_rt + us*inv_c2);
             });
         }
-        ParallelDescriptor::ReduceRealMin(gmin);
 
         // gmax
         Real gmax = 0.0_rt;
@@ -357,19 +348,16 @@ void ParticleExtrema::ComputeDiags (int step)
                 return std::sqrt(1.0_rt + us*inv_c2);
             });
         }
-        ParallelDescriptor::ReduceRealMax(gmax);
 
         // wmin
         Real wmin = ReduceMin( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.rdata(PIdx::w); });
-        ParallelDescriptor::ReduceRealMin(wmin);
 
         // wmax
         Real wmax = ReduceMax( myspc,
         [=] AMREX_GPU_HOST_DEVICE (const PType& p)
         { return p.rdata(PIdx::w); });
-        ParallelDescriptor::ReduceRealMax(wmax);
 
 #if (defined WARPX_QED)
         // get number of level (int)
@@ -381,7 +369,9 @@ void ParticleExtrema::ComputeDiags (int step)
         GetExternalEField get_externalE;
         GetExternalBField get_externalB;
 
-        if (myspc.DoQED())
+        // The extrema of chi recorded by the push of this step, with the fields it gathered,
+        // are used if available: otherwise the fields are gathered again
+        if (myspc.DoQED() && !myspc.GetChiExtrema(step+1, chimin_f, chimax_f))
         {
             // declare chi arrays
             std::vector<Real> chimin, chimax;
@@ -485,8 +475,6 @@ void ParticleExtrema::ComputeDiags (int step)
                 chimin_f = *std::min_element(chimin.begin(), chimin.end());
                 chimax_f = *std::max_element(chimax.begin(), chimax.end());
             }
-            ParallelDescriptor::ReduceRealMin(chimin_f);
-            ParallelDescriptor::ReduceRealMax(chimax_f);
         }
 #endif
         m_data[0]  = xmin;
@@ -512,6 +500,17 @@ void ParticleExtrema::ComputeDiags (int step)
             m_data[17] = chimax_f;
         }
 #endif
+
+        // The values of this rank are reduced by MultiReducedDiags:
+        // the even indices are minima, the odd indices are maxima
+        int nextrema = 16;
+#if (defined WARPX_QED)
+        if (myspc.DoQED()) nextrema = 18;
+#endif
+        for (int i = 0; i < nextrema; i += 2) {
+            DeferReduction(ReductionType::Min, i);
+            DeferReduction(ReductionType::Max, i+1);
+        }
     }
     // end loop over species
 }
@@ -0,0 +1,395 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "ParticleHistogramND.H"
+
+#include "Diagnostics/ReducedDiags/ReducedDiags.H"
+#include "Particles/MultiParticleContainer.H"
+#include "Particles/Pusher/GetAndSetPosition.H"
+#include "Particles/WarpXParticleContainer.H"
+#include "Utils/IntervalsParser.H"
+#include "Utils/WarpXConst.H"
+#include "Utils/WarpXUtil.H"
+#include "WarpX.H"
+
+#include <AMReX.H>
+#include <AMReX_Config.H>
+#include <AMReX_Extension.H>
+#include <AMReX_GpuAtomic.H>
+#include <AMReX_GpuContainers.H>
+#include <AMReX_GpuControl.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_GpuQualifiers.H>
+#include <AMReX_Math.H>
+#include <AMReX_ParIter.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_REAL.H>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+using namespace amrex;
+
+namespace {
+    struct NormalizationType {
+        enum {
+            no_normalization = 0,
+            unity_particle_weight,
+            max_to_unity,
+            area_to_unity
+        };
+    };
+}
+
+// constructor
+ParticleHistogramND::ParticleHistogramND (std::string rd_name)
+: ReducedDiags{rd_name}
+{
+    ParmParse pp_rd_name(rd_name);
+
+    // read species
+    std::string selected_species_name;
+    pp_rd_name.get("species",selected_species_name);
+
+    // read bin parameters: one value per dimension of the histogram
+    std::vector<int> bin_num;
+    std::vector<amrex::Real> bin_min, bin_max;
+    getArrWithParser(pp_rd_name, "bin_number", bin_num);
+    getArrWithParser(pp_rd_name, "bin_max",    bin_max);
+    getArrWithParser(pp_rd_name, "bin_min",    bin_min);
+    m_ndims = static_cast<int>(bin_num.size());
+    WarpXUtilMsg::AlwaysAssert(m_ndims >= 1 && m_ndims <= m_max_dims,
+        "ParticleHistogramND: bin_number must have 1, 2 or 3 values");
+    WarpXUtilMsg::AlwaysAssert(
+        static_cast<int>(bin_min.size()) == m_ndims && static_cast<int>(bin_max.size()) == m_ndims,
+        "ParticleHistogramND: bin_min and bin_max must have as many values as bin_number");
+
+    m_bin_num_total = 1;
+    for (int d = 0; d < m_max_dims; ++d) {
+        if (d < m_ndims) {
+            WarpXUtilMsg::AlwaysAssert(bin_num[d] > 0,
+                "ParticleHistogramND: bin_number must be positive");
+            m_bin_num[d] = bin_num[d];
+            m_bin_min[d] = bin_min[d];
+            m_bin_size[d] = (bin_max[d] - bin_min[d]) / bin_num[d];
+        } else {
+            m_bin_num[d] = 1;
+            m_bin_min[d] = 0.0_rt;
+            m_bin_size[d] = 1.0_rt;
+        }
+        m_bin_num_total *= m_bin_num[d];
+    }
+
+    // read histogram functions, one per dimension
+    for (int d = 0; d < m_ndims; ++d) {
+        std::string function_string = "";
+        Store_parserString(pp_rd_name,
+                           "histogram_function_" + std::to_string(d) + "(t,x,y,z,ux,uy,uz)",
+                           function_string);
+        m_parser[d] = std::make_unique<amrex::Parser>(
+            makeParser(function_string,{"t","x","y","z","ux","uy","uz"}));
+    }
+
+    // read normalization type
+    std::string norm_string = "default";
+    pp_rd_name.query("normalization",norm_string);
+
+    // set normalization type
+    if ( norm_string == "default" ) {
+        m_norm = NormalizationType::no_normalization;
+    } else if ( norm_string == "unity_particle_weight" ) {
+        m_norm = NormalizationType::unity_particle_weight;
+    } else if ( norm_string == "max_to_unity" ) {
+        m_norm = NormalizationType::max_to_unity;
+    } else if ( norm_string == "area_to_unity" ) {
+        m_norm = NormalizationType::area_to_unity;
+    } else {
+        Abort("Unknown ParticleHistogramND normalization type.");
+    }
+
+    // get MultiParticleContainer class object
+    const auto & mypc = WarpX::GetInstance().GetPartContainer();
+    // get species names (std::vector<std::string>)
+    auto const species_names = mypc.GetSpeciesNames();
+    // select species
+    for ( int i = 0; i < mypc.nSpecies(); ++i )
+    {
+        if ( selected_species_name == species_names[i] ){
+            m_selected_species_id = i;
+        }
+    }
+    // if m_selected_species_id is not modified
+    if ( m_selected_species_id == -1 ){
+        Abort("Unknown species for ParticleHistogramND reduced diagnostic.");
+    }
+
+    // Read optional filter
+    std::string buf;
+    m_do_parser_filter = pp_rd_name.query("filter_function(t,x,y,z,ux,uy,uz)", buf);
+    if (m_do_parser_filter) {
+        std::string filter_string = "";
+        Store_parserString(pp_rd_name,"filter_function(t,x,y,z,ux,uy,uz)", filter_string);
+        m_parser_filter = std::make_unique<amrex::Parser>(
+                                     makeParser(filter_string,{"t","x","y","z","ux","uy","uz"}));
+    }
+
+    // resize data array
+    m_data.resize(m_bin_num_total,0.0_rt);
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        if ( m_IsNotRestart )
+        {
+            // open file
+            std::ofstream ofs{m_path + m_rd_name + "." + m_extension, std::ofstream::out};
+            // write header row: bin indices and centers, the first dimension varying fastest
+            int c = 0;
+            ofs << "#";
+            ofs << "[" << c++ << "]step()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]time(s)";
+            for (int i = 0; i < m_bin_num_total; ++i)
+            {
+                std::string indices, centers;
+                int ii = i;
+                for (int d = 0; d < m_ndims; ++d)
+                {
+                    const int id = ii % m_bin_num[d];
+                    ii /= m_bin_num[d];
+                    const Real b = m_bin_min[d] + m_bin_size[d]*(Real(id)+0.5_rt);
+                    if (d > 0) { indices += ","; centers += ","; }
+                    indices += std::to_string(1+id);
+                    centers += std::to_string(b);
+                }
+                ofs << m_sep;
+                ofs << "[" << c++ << "]";
+                ofs << "bin(" + indices + ")=(" + centers + ")()";
+            }
+            ofs << std::endl;
+            // close file
+            ofs.close();
+        }
+    }
+}
+// end constructor
+
+// function that computes the histogram
+void ParticleHistogramND::ComputeDiags (int step)
+{
+    // Judge if the diags should be done
+    if (!m_intervals.contains(step+1)) return;
+
+    // get a reference to WarpX instance
+    auto & warpx = WarpX::GetInstance();
+
+    // get time at level 0
+    auto const t = warpx.gett_new(0);
+
+    // get MultiParticleContainer class object
+    const auto & mypc = warpx.GetPartContainer();
+
+    // get WarpXParticleContainer class object
+    auto & myspc = mypc.GetParticleContainer(m_selected_species_id);
+
+    // get parsers (the unused dimensions have a single bin)
+    auto const fun_partparser0 = compileParser<m_nvars>(m_parser[0].get());
+    auto const fun_partparser1 = compileParser<m_nvars>(m_parser[1].get());
+    auto const fun_partparser2 = compileParser<m_nvars>(m_parser[2].get());
+
+    // get filter parser
+    auto fun_filterparser = compileParser<m_nvars>(m_parser_filter.get());
+
+    // declare local variables
+    int const ndims = m_ndims;
+    auto const num_bins = m_bin_num;
+    int const num_bins_total = m_bin_num_total;
+    auto const bin_min  = m_bin_min;
+    auto const bin_size = m_bin_size;
+    const bool is_unity_particle_weight =
+        (m_norm == NormalizationType::unity_particle_weight) ? true : false;
+
+    bool const do_parser_filter = m_do_parser_filter;
+
+    // zero-out old data on the host
+    std::fill(m_data.begin(), m_data.end(), amrex::Real(0.0));
+    amrex::Gpu::DeviceVector< amrex::Real > d_data( m_data.size(), 0.0 );
+    amrex::Real* const AMREX_RESTRICT dptr_data = d_data.dataPtr();
+
+#if defined(AMREX_USE_CUDA) || defined(AMREX_USE_HIP)
+    // bin in shared memory, if the histogram fits
+    const std::size_t shared_mem_bytes = num_bins_total*sizeof(amrex::Real);
+    const bool use_shared_memory =
+        shared_mem_bytes <= static_cast<std::size_t>(amrex::Gpu::Device::sharedMemPerBlock());
+#endif
+
+    int const nlevs = std::max(0, myspc.finestLevel()+1);
+    for (int lev = 0; lev < nlevs; ++lev) {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+        {
+#ifndef AMREX_USE_GPU
+            // histogram private to this thread
+            std::vector<amrex::Real> local_data(num_bins_total, 0.0_rt);
+            amrex::Real* const AMREX_RESTRICT local_hist = local_data.data();
+#endif
+            for (WarpXParIter pti(myspc, lev); pti.isValid(); ++pti)
+            {
+                auto const GetPosition = GetParticlePosition(pti);
+
+                auto & attribs = pti.GetAttribs();
+                Real* const AMREX_RESTRICT d_w = attribs[PIdx::w].dataPtr();
+                Real* const AMREX_RESTRICT d_ux = attribs[PIdx::ux].dataPtr();
+                Real* const AMREX_RESTRICT d_uy = attribs[PIdx::uy].dataPtr();
+                Real* const AMREX_RESTRICT d_uz = attribs[PIdx::uz].dataPtr();
+
+                long const np = pti.numParticles();
+
+                // flattened bin of particle i (-1 if it is filtered out or out-of-range),
+                // and its contribution to the bin
+                auto const get_bin = [=] AMREX_GPU_HOST_DEVICE (long i, amrex::Real& weight) -> int
+                {
+                    amrex::ParticleReal x, y, z;
+                    GetPosition(i, x, y, z);
+                    auto const ux = d_ux[i] / PhysConst::c;
+                    auto const uy = d_uy[i] / PhysConst::c;
+                    auto const uz = d_uz[i] / PhysConst::c;
+
+                    // don't count a particle if it is filtered out
+                    if (do_parser_filter)
+                        if (!fun_filterparser(t, x, y, z, ux, uy, uz))
+                            return -1;
+
+                    amrex::Real f[m_max_dims] = {0.0_rt, 0.0_rt, 0.0_rt};
+                    f[0] = fun_partparser0(t, x, y, z, ux, uy, uz);
+                    if (ndims > 1) f[1] = fun_partparser1(t, x, y, z, ux, uy, uz);
+                    if (ndims > 2) f[2] = fun_partparser2(t, x, y, z, ux, uy, uz);
+
+                    int bin = 0;
+                    for (int d = ndims-1; d >= 0; --d) {
+                        int const b = int(Math::floor((f[d]-bin_min[d])/bin_size[d]));
+                        if ( b<0 || b>=num_bins[d] ) return -1; // discard if out-of-range
+                        bin = bin*num_bins[d] + b;
+                    }
+                    weight = is_unity_particle_weight ? 1.0_rt : d_w[i];
+                    return bin;
+                };
+
+#if defined(AMREX_USE_CUDA) || defined(AMREX_USE_HIP)
+                if (np == 0) continue;
+                if (use_shared_memory) {
+                    // grid-stride loop over the particles, each block adding its
+                    // histogram in shared memory to the global one at the end
+                    constexpr int threads_per_block = 256;
+                    const long nblocks_max = 4*amrex::Gpu::Device::numMultiProcessors();
+                    const int nblocks = static_cast<int>(std::min(
+                        (np + threads_per_block - 1) / threads_per_block, nblocks_max));
+                    amrex::launch(nblocks, threads_per_block, shared_mem_bytes, amrex::Gpu::gpuStream(),
+                        [=] AMREX_GPU_DEVICE () noexcept
+                        {
+                            amrex::Gpu::SharedMemory<amrex::Real> gsm;
+                            amrex::Real* const shared = gsm.dataPtr();
+                            for (int b = threadIdx.x; b < num_bins_total; b += blockDim.x) {
+                                shared[b] = 0._rt;
+                            }
+                            __syncthreads();
+
+                            for (long i = blockIdx.x*static_cast<long>(blockDim.x) + threadIdx.x;
+                                 i < np; i += static_cast<long>(blockDim.x)*gridDim.x)
+                            {
+                                amrex::Real weight;
+                                int const bin = get_bin(i, weight);
+                                if (bin >= 0) amrex::Gpu::Atomic::Add(&shared[bin], weight);
+                            }
+                            __syncthreads();
+
+                            for (int b = threadIdx.x; b < num_bins_total; b += blockDim.x) {
+                                if (shared[b] != 0._rt) amrex::Gpu::Atomic::Add(&dptr_data[b], shared[b]);
+                            }
+                        });
+                } else {
+                    amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (long i)
+                    {
+                        amrex::Real weight;
+                        int const bin = get_bin(i, weight);
+                        if (bin >= 0) amrex::Gpu::Atomic::Add(&dptr_data[bin], weight);
+                    });
+                }
+#elif defined(AMREX_USE_GPU)
+                amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (long i)
+                {
+                    amrex::Real weight;
+                    int const bin = get_bin(i, weight);
+                    if (bin >= 0) amrex::Gpu::Atomic::Add(&dptr_data[bin], weight);
+                });
+#else
+                for (long i = 0; i < np; ++i)
+                {
+                    amrex::Real weight;
+                    int const bin = get_bin(i, weight);
+                    if (bin >= 0) local_hist[bin] += weight;
+                }
+#endif
+            }
+#ifndef AMREX_USE_GPU
+            // add the histogram of this thread
+#ifdef AMREX_USE_OMP
+#pragma omp critical (particle_histogram_nd_sum)
+#endif
+            for (int b = 0; b < num_bins_total; ++b) {
+                dptr_data[b] += local_hist[b];
+            }
+#endif
+        }
+    }
+
+    // blocking copy from device to host
+    amrex::Gpu::copy(amrex::Gpu::deviceToHost,
+        d_data.begin(), d_data.end(), m_data.begin());
+
+    // reduced sum over mpi ranks
+    ParallelDescriptor::ReduceRealSum
+        (m_data.data(), m_data.size(), ParallelDescriptor::IOProcessorNumber());
+
+    // normalize the maximum value to be one
+    if ( m_norm == NormalizationType::max_to_unity )
+    {
+        Real f_max = 0.0_rt;
+        for ( int i = 0; i < m_bin_num_total; ++i )
+        {
+            if ( m_data[i] > f_max ) f_max = m_data[i];
+        }
+        for ( int i = 0; i < m_bin_num_total; ++i )
+        {
+            if ( f_max > std::numeric_limits<Real>::min() ) m_data[i] /= f_max;
+        }
+        return;
+    }
+
+    // normalize the volume (integral) to be one
+    if ( m_norm == NormalizationType::area_to_unity )
+    {
+        Real bin_volume = 1.0_rt;
+        for ( int d = 0; d < m_ndims; ++d ) bin_volume *= m_bin_size[d];
+        Real f_area = 0.0_rt;
+        for ( int i = 0; i < m_bin_num_total; ++i )
+        {
+            f_area += m_data[i] * bin_volume;
+        }
+        for ( int i = 0; i < m_bin_num_total; ++i )
+        {
+            if ( f_area > std::numeric_limits<Real>::min() ) m_data[i] /= f_area;
+        }
+        return;
+    }
+}
+// end void ParticleHistogramND::ComputeDiags
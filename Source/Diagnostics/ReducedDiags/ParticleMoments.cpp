@@ -0,0 +1,108 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "ParticleMoments.H"
+
+#include "Particles/Algorithms/KineticEnergy.H"
+#include "Particles/MultiParticleContainer.H"
+#include "Particles/SpeciesPhysicalProperties.H"
+#include "Particles/WarpXParticleContainer.H"
+#include "Utils/WarpXConst.H"
+#include "WarpX.H"
+
+#include <AMReX_GpuQualifiers.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParticleReduce.H>
+#include <AMReX_Particles.H>
+#include <AMReX_Reduce.H>
+#include <AMReX_Tuple.H>
+
+using namespace amrex;
+
+ParticleMoments::Data ParticleMoments::m_data;
+bool ParticleMoments::m_valid = false;
+
+namespace
+{
+    /** Local sums (W, W*E, W*Px, W*Py, W*Pz) of the particles of one species */
+    amrex::GpuTuple<Real, Real, Real, Real, Real>
+    ReduceSpecies (const WarpXParticleContainer& myspc)
+    {
+        using PType = typename WarpXParticleContainer::SuperParticleType;
+
+        const bool is_photon = myspc.AmIA<PhysicalSpecies::photon>();
+        // photons have zero mass, but ux, uy, uz are calculated assuming
+        // a mass equal to the electron mass
+        const amrex::Real m = myspc.getMass();
+        const amrex::Real m_mom = is_photon ? PhysConst::m_e : m;
+
+        amrex::ReduceOps<ReduceOpSum, ReduceOpSum, ReduceOpSum, ReduceOpSum, ReduceOpSum> reduce_ops;
+        return amrex::ParticleReduce<amrex::ReduceData<Real, Real, Real, Real, Real>>(
+            myspc,
+            [=] AMREX_GPU_DEVICE(const PType& p) noexcept
+                -> amrex::GpuTuple<Real, Real, Real, Real, Real>
+            {
+                const amrex::Real w  = p.rdata(PIdx::w);
+                const amrex::Real ux = p.rdata(PIdx::ux);
+                const amrex::Real uy = p.rdata(PIdx::uy);
+                const amrex::Real uz = p.rdata(PIdx::uz);
+                const amrex::Real e = is_photon ?
+                    Algorithms::KineticEnergyPhotons(ux,uy,uz) :
+                    Algorithms::KineticEnergy(ux,uy,uz,m);
+                return {w, w*e, w*m_mom*ux, w*m_mom*uy, w*m_mom*uz};
+            },
+            reduce_ops);
+    }
+}
+
+const ParticleMoments::Data&
+ParticleMoments::Get ()
+{
+    if (m_valid) return m_data;
+
+    const auto & mypc = WarpX::GetInstance().GetPartContainer();
+    const int nSpecies = mypc.nSpecies();
+
+    // local sums of all species, packed for a single MPI reduction
+    constexpr int nsums = 5;
+    amrex::Vector<amrex::Real> sums(nsums*nSpecies);
+    m_data.np.resize(nSpecies);
+    for (int i_s = 0; i_s < nSpecies; ++i_s)
+    {
+        const auto & myspc = mypc.GetParticleContainer(i_s);
+        const auto r = ReduceSpecies(myspc);
+        sums[nsums*i_s+0] = amrex::get<0>(r);
+        sums[nsums*i_s+1] = amrex::get<1>(r);
+        sums[nsums*i_s+2] = amrex::get<2>(r);
+        sums[nsums*i_s+3] = amrex::get<3>(r);
+        sums[nsums*i_s+4] = amrex::get<4>(r);
+        m_data.np[i_s] = myspc.TotalNumberOfParticles(true, true);
+    }
+
+    // Reduced sum over MPI ranks
+    ParallelDescriptor::ReduceRealSum(sums.data(), static_cast<int>(sums.size()),
+                                      ParallelDescriptor::IOProcessorNumber());
+    ParallelDescriptor::ReduceLongSum(m_data.np.data(), nSpecies,
+                                      ParallelDescriptor::IOProcessorNumber());
+
+    m_data.w.resize(nSpecies);
+    m_data.energy.resize(nSpecies);
+    m_data.px.resize(nSpecies);
+    m_data.py.resize(nSpecies);
+    m_data.pz.resize(nSpecies);
+    for (int i_s = 0; i_s < nSpecies; ++i_s)
+    {
+        m_data.w[i_s]      = sums[nsums*i_s+0];
+        m_data.energy[i_s] = sums[nsums*i_s+1];
+        m_data.px[i_s]     = sums[nsums*i_s+2];
+        m_data.py[i_s]     = sums[nsums*i_s+3];
+        m_data.pz[i_s]     = sums[nsums*i_s+4];
+    }
+
+    m_valid = true;
+    return m_data;
+}
@@ -7,6 +7,7 @@
 
 #include "ParticleNumber.H"
 
+#include "Diagnostics/ReducedDiags/ParticleMoments.H"
 #include "Diagnostics/ReducedDiags/ReducedDiags.H"
 #include "Particles/MultiParticleContainer.H"
 #include "Particles/WarpXParticleContainer.H"
@@ -16,7 +17,6 @@
 #include <AMReX_GpuQualifiers.H>
 #include <AMReX_PODVector.H>
 #include <AMReX_ParallelDescriptor.H>
-#include <AMReX_ParticleReduce.H>
 #include <AMReX_Particles.H>
 #include <AMReX_REAL.H>
 
@@ -109,27 +109,16 @@ void ParticleNumber::ComputeDiags (int step)
     m_data[idx_total_macroparticles] = 0.0_rt;
     m_data[idx_total_sum_weight] = 0.0_rt;
 
+    const ParticleMoments::Data& moments = ParticleMoments::Get();
+
     // loop over species
     for (int i_s = 0; i_s < nSpecies; ++i_s)
     {
-        // get WarpXParticleContainer class object
-        const auto & myspc = mypc.GetParticleContainer(i_s);
-
         // Save total number of macroparticles for this species
-        m_data[idx_first_species_macroparticles + i_s] = myspc.TotalNumberOfParticles();
-
-        using PType = typename WarpXParticleContainer::SuperParticleType;
-
-        // Reduction to compute sum of weights for this species
-        auto Wtot = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> amrex::Real
-        {
-            return p.rdata(PIdx::w);
-        });
+        m_data[idx_first_species_macroparticles + i_s] = moments.np[i_s];
 
-        // MPI reduction
-        amrex::ParallelDescriptor::ReduceRealSum
-            (Wtot, amrex::ParallelDescriptor::IOProcessorNumber());
+        // Sum of weights for this species, shared with the other particle reduced diagnostics
+        const amrex::Real Wtot = moments.w[i_s];
 
         // Save sum of particles weight for this species
         m_data[idx_first_species_sum_weight + i_s] = Wtot;
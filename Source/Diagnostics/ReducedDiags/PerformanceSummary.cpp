@@ -0,0 +1,237 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "PerformanceSummary.H"
+
+#include "Diagnostics/ReducedDiags/ReducedDiags.H"
+#include "Parallelization/WarpXCommUtil.H"
+#include "Particles/MultiParticleContainer.H"
+#include "Particles/WarpXParticleContainer.H"
+#include "Utils/IntervalsParser.H"
+#include "Utils/WarpXPhaseTimers.H"
+#include "WarpX.H"
+
+#include <AMReX_BoxArray.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_REAL.H>
+#include <AMReX_Utility.H>
+
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+using namespace amrex::literals;
+
+namespace
+{
+    /** Values of the fields read and written per cell by a field update: the three components
+     *  of E, B and J are read, and those of E and B are written (finite-difference solver) */
+    constexpr int field_values_per_cell = 15;
+
+    /** a/b, or 0 if b is not positive (JSON has no infinity) */
+    double ratio (double a, double b)
+    {
+        return (b > 0.) ? a/b : 0.;
+    }
+}
+
+// constructor
+PerformanceSummary::PerformanceSummary (std::string rd_name)
+: ReducedDiags{rd_name}
+{
+    m_extension = "json";
+
+    WarpXPhaseTimers::Enable(true);
+    WarpXCommUtil::EnableCommStats(true);
+    // (collective, at the first call)
+    WarpXCommUtil::RankNodes();
+
+    // counters since the previous output and since the beginning of the run
+    m_data.resize(2*m_nCounters, 0.0_rt);
+}
+// end constructor
+
+void PerformanceSummary::InitData ()
+{
+    // Do not count the initialization
+    m_t_start = amrex::second();
+    m_start.phase_times = WarpXPhaseTimers::GetTotalPhaseTimes();
+    const auto& comm = WarpXCommUtil::GetTotalCommStats();
+    m_start.bytes_sent = comm.bytes;
+    m_start.bytes_internode = comm.bytes_internode;
+}
+
+// function that counts the particles and cells updated at this step
+void PerformanceSummary::ComputeDiags (int step)
+{
+    // Nothing is pushed before the first step
+    if (step < 0) { return; }
+
+    auto & warpx = WarpX::GetInstance();
+    const auto & mypc = warpx.GetPartContainer();
+
+    // The particles of this rank, each read and written once by the push
+    for (int i_s = 0; i_s < mypc.nSpecies(); ++i_s)
+    {
+        const auto& pc = mypc.GetParticleContainer(i_s);
+        const double np = static_cast<double>(pc.TotalNumberOfParticles(true, true));
+        const double particle_size = sizeof(WarpXParticleContainer::ParticleType)
+            + pc.NumRealComps()*sizeof(amrex::ParticleReal) + pc.NumIntComps()*sizeof(int);
+        m_total.particle_pushes += np;
+        m_total.particle_bytes += 2.*np*particle_size;
+    }
+    // The cells of all the levels (of all the ranks)
+    for (int lev = 0; lev <= warpx.finestLevel(); ++lev)
+    {
+        m_total.cell_updates += static_cast<double>(warpx.boxArray(lev).numPts());
+    }
+    m_total.steps += 1.;
+
+    // Judge if the diags should be done
+    if (!m_intervals.contains(step+1)) { return; }
+
+    PackCounters();
+}
+// end void PerformanceSummary::ComputeDiags
+
+bool PerformanceSummary::ComputeFinalDiags (int /*step*/)
+{
+    PackCounters();
+    return true;
+}
+
+void PerformanceSummary::PackCounters ()
+{
+    using namespace WarpXPhaseTimers;
+
+    const auto& comm = WarpXCommUtil::GetTotalCommStats();
+    const auto& phase_times = GetTotalPhaseTimes();
+    m_total.bytes_sent = comm.bytes - m_start.bytes_sent;
+    m_total.bytes_internode = comm.bytes_internode - m_start.bytes_internode;
+    m_total.wall_time = amrex::second() - m_t_start;
+    for (int p = 0; p < nPhases; ++p) {
+        m_total.phase_times[p] = phase_times[p] - m_start.phase_times[p];
+    }
+
+    Counters interval;
+    interval.particle_pushes = m_total.particle_pushes - m_last.particle_pushes;
+    interval.particle_bytes = m_total.particle_bytes - m_last.particle_bytes;
+    interval.bytes_sent = m_total.bytes_sent - m_last.bytes_sent;
+    interval.bytes_internode = m_total.bytes_internode - m_last.bytes_internode;
+    interval.cell_updates = m_total.cell_updates - m_last.cell_updates;
+    interval.steps = m_total.steps - m_last.steps;
+    interval.wall_time = m_total.wall_time - m_last.wall_time;
+    for (int p = 0; p < nPhases; ++p) {
+        interval.phase_times[p] = m_total.phase_times[p] - m_last.phase_times[p];
+    }
+
+    CountersToData(interval, 0);
+    CountersToData(m_total, m_nCounters);
+    for (int start : {0, m_nCounters}) {
+        DeferReduction(ReductionType::Sum, start, m_nSummed);
+        DeferReduction(ReductionType::Max, start + m_nSummed + 3, nPhases);
+    }
+
+    // The next output covers the steps since this one
+    m_last = m_total;
+}
+
+void PerformanceSummary::CountersToData (Counters const& c, int start)
+{
+    amrex::Real* const d = m_data.data() + start;
+    d[0] = static_cast<amrex::Real>(c.particle_pushes);
+    d[1] = static_cast<amrex::Real>(c.particle_bytes);
+    d[2] = static_cast<amrex::Real>(c.bytes_sent);
+    d[3] = static_cast<amrex::Real>(c.bytes_internode);
+    d[4] = static_cast<amrex::Real>(c.cell_updates);
+    d[5] = static_cast<amrex::Real>(c.steps);
+    d[6] = static_cast<amrex::Real>(c.wall_time);
+    for (int p = 0; p < WarpXPhaseTimers::nPhases; ++p) {
+        d[7+p] = static_cast<amrex::Real>(c.phase_times[p]);
+    }
+}
+
+void PerformanceSummary::WriteSection (std::ostream& os, int start) const
+{
+    using namespace WarpXPhaseTimers;
+
+    const amrex::Real* const d = m_data.data() + start;
+    const double nprocs = static_cast<double>(amrex::ParallelDescriptor::NProcs());
+    const double particle_pushes = d[0];
+    const double particle_bytes = d[1];
+    const double cell_updates = d[4];
+    const double wall_time = d[6];
+    const double push_time = d[7+static_cast<int>(Phase::Push)];
+    const double field_solve_time = d[7+static_cast<int>(Phase::FieldSolve)];
+    const double io_time = d[7+static_cast<int>(Phase::Diagnostics)];
+    const double field_bytes = cell_updates*field_values_per_cell*sizeof(amrex::Real);
+
+    os << "{\n";
+    os << "    \"steps\": " << d[5] << ",\n";
+    os << "    \"wall_time\": " << wall_time << ",\n";
+    os << "    \"particles_pushed\": " << particle_pushes << ",\n";
+    os << "    \"particles_pushed_per_second\": " << ratio(particle_pushes, wall_time) << ",\n";
+    os << "    \"particles_pushed_per_second_per_rank\": "
+       << ratio(particle_pushes, wall_time*nprocs) << ",\n";
+    os << "    \"cell_updates\": " << cell_updates << ",\n";
+    os << "    \"cell_updates_per_second\": " << ratio(cell_updates, wall_time) << ",\n";
+    os << "    \"cell_updates_per_second_per_rank\": "
+       << ratio(cell_updates, wall_time*nprocs) << ",\n";
+    os << "    \"bytes_communicated\": " << d[2] << ",\n";
+    os << "    \"bytes_communicated_internode\": " << d[3] << ",\n";
+    os << "    \"io_fraction\": " << ratio(io_time, wall_time) << ",\n";
+    os << "    \"push_bandwidth_estimate\": " << ratio(particle_bytes, push_time) << ",\n";
+    os << "    \"push_bandwidth_estimate_per_rank\": "
+       << ratio(particle_bytes, push_time*nprocs) << ",\n";
+    os << "    \"field_solve_bandwidth_estimate\": " << ratio(field_bytes, field_solve_time) << ",\n";
+    os << "    \"field_solve_bandwidth_estimate_per_rank\": "
+       << ratio(field_bytes, field_solve_time*nprocs) << ",\n";
+    os << "    \"phase_times\": {";
+    for (int p = 0; p < nPhases; ++p)
+    {
+        os << ((p > 0) ? ", " : "") << "\"" << PhaseName(static_cast<Phase>(p)) << "\": " << d[7+p];
+    }
+    os << "}\n";
+    os << "  }";
+}
+
+void PerformanceSummary::WriteSummary (int step, bool final_output) const
+{
+    auto & warpx = WarpX::GetInstance();
+
+    // open file (the summary is overwritten at each output)
+    std::ofstream ofs{m_path + m_rd_name + "." + m_extension, std::ofstream::out};
+    ofs << std::setprecision(14);
+    ofs << "{\n";
+    ofs << "  \"step\": " << step+1 << ",\n";
+    ofs << "  \"time\": " << warpx.gett_new(0) << ",\n";
+    ofs << "  \"final\": " << (final_output ? "true" : "false") << ",\n";
+    ofs << "  \"nprocs\": " << amrex::ParallelDescriptor::NProcs() << ",\n";
+#ifdef AMREX_USE_GPU
+    ofs << "  \"gpu\": true,\n";
+#else
+    ofs << "  \"gpu\": false,\n";
+#endif
+    ofs << "  \"since_previous_output\": ";
+    WriteSection(ofs, 0);
+    ofs << ",\n";
+    ofs << "  \"cumulative\": ";
+    WriteSection(ofs, m_nCounters);
+    ofs << "\n}\n";
+    // close file
+    ofs.close();
+}
+
+void PerformanceSummary::WriteToFile (int step) const
+{
+    WriteSummary(step, false);
+}
+
+void PerformanceSummary::WriteFinalToFile (int step) const
+{
+    WriteSummary(step, true);
+}
@@ -0,0 +1,102 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "PhaseTimers.H"
+
+#include "Diagnostics/ReducedDiags/ReducedDiags.H"
+#include "Utils/IntervalsParser.H"
+#include "Utils/WarpXPhaseTimers.H"
+#include "WarpX.H"
+
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_REAL.H>
+
+#include <algorithm>
+#include <fstream>
+#include <ostream>
+
+using namespace amrex::literals;
+
+// constructor
+PhaseTimers::PhaseTimers (std::string rd_name)
+: ReducedDiags{rd_name}
+{
+    using namespace WarpXPhaseTimers;
+
+    WarpXPhaseTimers::Enable(true);
+
+    // min, avg and max of each phase and of their total
+    m_data.resize(m_nDataFields*(nPhases+1), 0.0_rt);
+
+    if (amrex::ParallelDescriptor::IOProcessor())
+    {
+        if ( m_IsNotRestart )
+        {
+            // open file
+            std::ofstream ofs{m_path + m_rd_name + "." + m_extension, std::ofstream::out};
+            // write header row
+            int c = 0;
+            ofs << "#";
+            ofs << "[" << c++ << "]step()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]time(s)";
+            for (int p = 0; p <= nPhases; ++p)
+            {
+                const std::string name = (p < nPhases) ? PhaseName(static_cast<Phase>(p)) : "total";
+                ofs << m_sep;
+                ofs << "[" << c++ << "]" << name << "_min(s)";
+                ofs << m_sep;
+                ofs << "[" << c++ << "]" << name << "_avg(s)";
+                ofs << m_sep;
+                ofs << "[" << c++ << "]" << name << "_max(s)";
+            }
+            ofs << std::endl;
+            // close file
+            ofs.close();
+        }
+    }
+}
+// end constructor
+
+void PhaseTimers::InitData ()
+{
+    // Do not count the initialization in the first output
+    m_last_step = WarpX::GetInstance().getistep(0);
+    WarpXPhaseTimers::ResetPhaseTimes();
+}
+
+// function that computes the time per step of each phase
+void PhaseTimers::ComputeDiags (int step)
+{
+    using namespace WarpXPhaseTimers;
+
+    // Judge if the diags should be done
+    if (!m_intervals.contains(step+1)) { return; }
+
+    const amrex::Real nsteps = static_cast<amrex::Real>(std::max(step+1 - m_last_step, 1));
+    const amrex::Real nprocs = static_cast<amrex::Real>(amrex::ParallelDescriptor::NProcs());
+    const auto& times = GetPhaseTimes();
+
+    amrex::Real total = 0.0_rt;
+    for (int p = 0; p <= nPhases; ++p)
+    {
+        const amrex::Real t = (p < nPhases) ? static_cast<amrex::Real>(times[p])/nsteps : total;
+        total += t;
+        // the average is the sum over the ranks of t/nprocs
+        m_data[m_nDataFields*p+0] = t;
+        m_data[m_nDataFields*p+1] = t/nprocs;
+        m_data[m_nDataFields*p+2] = t;
+        DeferReduction(ReductionType::Min, m_nDataFields*p+0);
+        DeferReduction(ReductionType::Sum, m_nDataFields*p+1);
+        DeferReduction(ReductionType::Max, m_nDataFields*p+2);
+    }
+
+    // The next output covers the steps since this one
+    ResetPhaseTimes();
+    m_last_step = step+1;
+}
+// end void PhaseTimers::ComputeDiags
@@ -159,8 +159,13 @@ void RhoMaximum::ComputeDiags (int step)
         constexpr int idx_first_species_data = 2;
 
         // Fill output array with min and max of total rho
-        m_data[lev*noutputs_per_level + idx_max_rho_data] = mf_temp.max(icomp);
-        m_data[lev*noutputs_per_level + idx_min_rho_data] = mf_temp.min(icomp);
+        // (of this rank, reduced by MultiReducedDiags)
+        constexpr int nghost = 0;
+        constexpr bool local = true;
+        m_data[lev*noutputs_per_level + idx_max_rho_data] = mf_temp.max(icomp, nghost, local);
+        m_data[lev*noutputs_per_level + idx_min_rho_data] = mf_temp.min(icomp, nghost, local);
+        DeferReduction(ReductionType::Max, lev*noutputs_per_level + idx_max_rho_data);
+        DeferReduction(ReductionType::Min, lev*noutputs_per_level + idx_min_rho_data);
 
         // Loop over all charged species
         for (int i = 0; i < n_charged_species; ++i)
@@ -168,8 +173,11 @@ void RhoMaximum::ComputeDiags (int step)
             // Fill temporary MultiFAB with the species charge density
             m_rho_functors[lev][idx_first_species_functor+i]->operator()(mf_temp, icomp, i_buffer);
             // Fill output array with max |rho| of species
-            m_data[lev*noutputs_per_level + idx_first_species_data + i] = mf_temp.norm0();
+            m_data[lev*noutputs_per_level + idx_first_species_data + i] =
+                mf_temp.norm0(icomp, nghost, local);
         }
+        DeferReduction(ReductionType::Max, lev*noutputs_per_level + idx_first_species_data,
+                       n_charged_species);
     }
     // end loop over refinement levels
 
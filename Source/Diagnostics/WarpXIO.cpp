@@ -9,6 +9,7 @@
  */
 #include "BoundaryConditions/PML.H"
 #include "FieldIO.H"
+#include "OpenPMDCheckpoint.H"
 #include "Particles/MultiParticleContainer.H"
 #include "Utils/CoarsenIO.H"
 #include "Parallelization/WarpXCommUtil.H"
@@ -27,16 +28,19 @@
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_PlotFileUtil.H>
 #include <AMReX_Print.H>
+#include <AMReX_Utility.H>
 #include <AMReX_REAL.H>
 #include <AMReX_RealBox.H>
 #include <AMReX_Vector.H>
 #include <AMReX_VisMF.H>
 
 #include <array>
+#include <fstream>
 #include <istream>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 using namespace amrex;
 
@@ -59,7 +63,10 @@ WarpX::GetRestartDMap (const std::string& chkfile, const amrex::BoxArray& ba, in
     DMFileName = amrex::Concatenate(DMFileName + "Level_", lev, 1);
     DMFileName += "/DM";
 
-    if (!amrex::FileExists(DMFileName)) {
+    // Only the I/O rank is guaranteed to see the file (e.g. for node-local checkpoints)
+    int dm_file_exists = ParallelDescriptor::IOProcessor() ? amrex::FileExists(DMFileName) : 0;
+    ParallelDescriptor::Bcast(&dm_file_exists, 1, ParallelDescriptor::IOProcessorNumber());
+    if (!dm_file_exists) {
         return amrex::DistributionMapping{ba, ParallelDescriptor::NProcs()};
     }
 
@@ -85,6 +92,42 @@ WarpX::GetRestartDMap (const std::string& chkfile, const amrex::BoxArray& ba, in
     return dm;
 }
 
+void
+WarpX::SelectRestartCheckpoint ()
+{
+    if (restart_local_dir.empty()) return;
+
+    // Name and number of ranks of the most recent complete local copy, written by
+    // FlushFormatCheckpoint at the end of the copy
+    std::string local_name;
+    int local_nprocs = 0;
+    if (ParallelDescriptor::IOProcessor()) {
+        std::ifstream latest(restart_local_dir + "/latest");
+        if (!(latest >> local_name >> local_nprocs)) local_name.clear();
+    }
+    int name_size = static_cast<int>(local_name.size());
+    ParallelDescriptor::Bcast(&name_size, 1, ParallelDescriptor::IOProcessorNumber());
+    ParallelDescriptor::Bcast(&local_nprocs, 1, ParallelDescriptor::IOProcessorNumber());
+    local_name.resize(name_size);
+    if (name_size > 0) {
+        ParallelDescriptor::Bcast(&local_name[0], name_size, ParallelDescriptor::IOProcessorNumber());
+    }
+
+    // Each rank reads the files it wrote, so all the ranks must find their own copy
+    const std::string local_chkfile = restart_local_dir + "/" + local_name;
+    bool complete = (name_size > 0) && (local_nprocs == ParallelDescriptor::NProcs()) &&
+        amrex::FileExists(amrex::Concatenate(local_chkfile + "/Rank_", ParallelDescriptor::MyProc(), 5));
+    ParallelDescriptor::ReduceBoolAnd(complete);
+
+    if (complete) {
+        amrex::Print() << "  Found the node-local checkpoint " << local_chkfile << "\n";
+        restart_chkfile = local_chkfile;
+    } else if (!restart_chkfile.empty()) {
+        amrex::Print() << "  No complete node-local checkpoint in " << restart_local_dir
+                       << ", restart from " << restart_chkfile << "\n";
+    }
+}
+
 void
 WarpX::InitFromCheckpoint ()
 {
@@ -92,6 +135,10 @@ WarpX::InitFromCheckpoint ()
 
     amrex::Print() << "  Restart from checkpoint " << restart_chkfile << "\n";
 
+    // With <diag>.checkpoint_openpmd, the fields and particles are read from an openPMD
+    // series, so that the simulation can be restarted on a different number of ranks
+    const bool openpmd = OpenPMDCheckpoint::Exists(restart_chkfile);
+
     // Header
     {
         std::string File(restart_chkfile + "/WarpXHeader");
@@ -194,11 +241,20 @@ WarpX::InitFromCheckpoint ()
 
         ResetProbDomain(RealBox(prob_lo.data(),prob_hi.data()));
 
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!openpmd || nlevs == 1,
+            "openPMD checkpoints do not support mesh refinement");
         for (int lev = 0; lev < nlevs; ++lev) {
             BoxArray ba;
             ba.readFrom(is);
             GotoNextLine(is);
-            DistributionMapping dm = GetRestartDMap(restart_chkfile, ba, lev);
+            DistributionMapping dm;
+            if (openpmd) {
+                // new grids for the current number of ranks
+                ba = MakeBaseGrids();
+                dm = DistributionMapping{ba, ParallelDescriptor::NProcs()};
+            } else {
+                dm = GetRestartDMap(restart_chkfile, ba, lev);
+            }
             SetBoxArray(lev, ba);
             SetDistributionMap(lev, dm);
             AllocLevelData(lev, ba, dm);
@@ -222,6 +278,51 @@ WarpX::InitFromCheckpoint ()
 
     const int nlevs = finestLevel()+1;
 
+    if (openpmd)
+    {
+        OpenPMDCheckpoint reader(restart_chkfile, true);
+        constexpr int lev = 0;
+        const auto ReadField = [&] (MultiFab& mf, const std::string& name)
+        {
+            mf.setVal(0.0);
+            reader.ReadField(name, mf, Geom(lev));
+            WarpXCommUtil::FillBoundary(mf, Geom(lev).periodicity());
+        };
+        const std::vector<std::string> dirs = {"x", "y", "z"};
+        for (int i = 0; i < 3; ++i) {
+            ReadField(*Efield_fp[lev][i], "E" + dirs[i] + "_fp");
+            ReadField(*Bfield_fp[lev][i], "B" + dirs[i] + "_fp");
+            if (WarpX::fft_do_time_averaging) {
+                for (const std::string f : {"E", "B"}) {
+                    MultiFab& mf_avg = (f == "E") ? *Efield_avg_fp[lev][i] : *Bfield_avg_fp[lev][i];
+                    const MultiFab& mf = (f == "E") ? *Efield_fp[lev][i] : *Bfield_fp[lev][i];
+                    if (reader.HasField(f + dirs[i] + "_avg_fp")) {
+                        ReadField(mf_avg, f + dirs[i] + "_avg_fp");
+                    } else {
+                        MultiFab::Copy(mf_avg, mf, 0, 0, mf.nComp(), amrex::min(mf_avg.nGrowVect(), mf.nGrowVect()));
+                    }
+                }
+            }
+            if (is_synchronized) {
+                ReadField(*current_fp[lev][i], "j" + dirs[i] + "_fp");
+            } else {
+                current_fp[lev][i]->setVal(0.0);
+            }
+        }
+
+        InitPML();
+        if (do_pml) {
+            RecordWarning("Restart",
+                "The PML fields are not stored in openPMD checkpoints and restart from zero.");
+        }
+
+        mypc->AllocData();
+        for (int i = 0; i < mypc->nSpecies(); ++i) {
+            reader.ReadParticles(mypc->GetSpeciesNames()[i], mypc->GetParticleContainer(i));
+        }
+        return;
+    }
+
     // Initialize the field data
     for (int lev = 0; lev < nlevs; ++lev)
     {
@@ -242,6 +343,18 @@ WarpX::InitFromCheckpoint ()
             }
         }
 
+        // The time-averaged fields are not in the checkpoint if it was written with
+        // <diag>.checkpoint_skip_averaged_fields: they are then initialized with the fields
+        const auto ReadAvgOrCopy = [&] (MultiFab& mf_avg, const MultiFab& mf, int l, const std::string& name)
+        {
+            const std::string mf_prefix = amrex::MultiFabFileFullPrefix(l, restart_chkfile, level_prefix, name);
+            if (amrex::FileExists(mf_prefix + "_H")) {
+                VisMF::Read(mf_avg, mf_prefix);
+            } else {
+                MultiFab::Copy(mf_avg, mf, 0, 0, mf.nComp(), amrex::min(mf_avg.nGrowVect(), mf.nGrowVect()));
+            }
+        };
+
         VisMF::Read(*Efield_fp[lev][0],
                     amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ex_fp"));
         VisMF::Read(*Efield_fp[lev][1],
@@ -258,19 +371,13 @@ WarpX::InitFromCheckpoint ()
 
         if (WarpX::fft_do_time_averaging)
         {
-            VisMF::Read(*Efield_avg_fp[lev][0],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ex_avg_fp"));
-            VisMF::Read(*Efield_avg_fp[lev][1],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ey_avg_fp"));
-            VisMF::Read(*Efield_avg_fp[lev][2],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ez_avg_fp"));
-
-            VisMF::Read(*Bfield_avg_fp[lev][0],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bx_avg_fp"));
-            VisMF::Read(*Bfield_avg_fp[lev][1],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "By_avg_fp"));
-            VisMF::Read(*Bfield_avg_fp[lev][2],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bz_avg_fp"));
+            ReadAvgOrCopy(*Efield_avg_fp[lev][0], *Efield_fp[lev][0], lev, "Ex_avg_fp");
+            ReadAvgOrCopy(*Efield_avg_fp[lev][1], *Efield_fp[lev][1], lev, "Ey_avg_fp");
+            ReadAvgOrCopy(*Efield_avg_fp[lev][2], *Efield_fp[lev][2], lev, "Ez_avg_fp");
+
+            ReadAvgOrCopy(*Bfield_avg_fp[lev][0], *Bfield_fp[lev][0], lev, "Bx_avg_fp");
+            ReadAvgOrCopy(*Bfield_avg_fp[lev][1], *Bfield_fp[lev][1], lev, "By_avg_fp");
+            ReadAvgOrCopy(*Bfield_avg_fp[lev][2], *Bfield_fp[lev][2], lev, "Bz_avg_fp");
         }
 
         if (is_synchronized) {
@@ -300,19 +407,13 @@ WarpX::InitFromCheckpoint ()
 
             if (WarpX::fft_do_time_averaging)
             {
-                VisMF::Read(*Efield_avg_cp[lev][0],
-                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ex_avg_cp"));
-                VisMF::Read(*Efield_avg_cp[lev][1],
-                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ey_avg_cp"));
-                VisMF::Read(*Efield_avg_cp[lev][2],
-                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Ez_avg_cp"));
-
-                VisMF::Read(*Bfield_avg_cp[lev][0],
-                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bx_avg_cp"));
-                VisMF::Read(*Bfield_avg_cp[lev][1],
-                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "By_avg_cp"));
-                VisMF::Read(*Bfield_avg_cp[lev][2],
-                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bz_avg_cp"));
+                ReadAvgOrCopy(*Efield_avg_cp[lev][0], *Efield_cp[lev][0], lev, "Ex_avg_cp");
+                ReadAvgOrCopy(*Efield_avg_cp[lev][1], *Efield_cp[lev][1], lev, "Ey_avg_cp");
+                ReadAvgOrCopy(*Efield_avg_cp[lev][2], *Efield_cp[lev][2], lev, "Ez_avg_cp");
+
+                ReadAvgOrCopy(*Bfield_avg_cp[lev][0], *Bfield_cp[lev][0], lev, "Bx_avg_cp");
+                ReadAvgOrCopy(*Bfield_avg_cp[lev][1], *Bfield_cp[lev][1], lev, "By_avg_cp");
+                ReadAvgOrCopy(*Bfield_avg_cp[lev][2], *Bfield_cp[lev][2], lev, "Bz_avg_cp");
             }
 
             if (is_synchronized) {
@@ -116,48 +116,87 @@ namespace detail
         return camelString;
     }
 
+    /** Create the JSON list of key-value pairs of parameters
+     *
+     * @param[in] parameters keys and values (as strings)
+     * @param[in] indent number of spaces before each entry
+     * @return entries of a JSON object, without the braces
+     */
+    inline std::string
+    getParameterList (std::map< std::string, std::string > const & parameters, int indent)
+    {
+        std::string list;
+        for (const auto& kv : parameters) {
+            if (!list.empty()) list.append(",\n");
+            list.append(std::string(indent, ' '))         /* just pretty alignment */
+                .append("\"").append(kv.first).append("\": ")    /* key */
+                .append("\"").append(kv.second).append("\""); /* value (as string) */
+        }
+        return list;
+    }
+
     /** Create the option string
      *
+     * @param[in] operator_type ADIOS2 operator (compressor) applied to all datasets
+     * @param[in] operator_parameters parameters of the ADIOS2 operator
+     * @param[in] engine_type ADIOS2 engine (e.g. bp4, sst)
+     * @param[in] engine_parameters parameters of the ADIOS2 engine (e.g. NumAggregators)
      * @return JSON option string for openPMD::Series
      */
     inline std::string
     getSeriesOptions (std::string const & operator_type,
-                      std::map< std::string, std::string > const & operator_parameters)
+                      std::map< std::string, std::string > const & operator_parameters,
+                      std::string const & engine_type,
+                      std::map< std::string, std::string > const & engine_parameters)
     {
-        std::string options;
-
-        std::string op_parameters;
-        for (const auto& kv : operator_parameters) {
-            if (!op_parameters.empty()) op_parameters.append(",\n");
-            op_parameters.append(std::string(12, ' '))         /* just pretty alignment */
-                    .append("\"").append(kv.first).append("\": ")    /* key */
-                    .append("\"").append(kv.second).append("\""); /* value (as string) */
+        if (operator_type.empty() && engine_type.empty() && engine_parameters.empty())
+            return "{}";
+
+        std::string options = R"END(
+{
+  "adios2": {)END";
+
+        if (!engine_type.empty() || !engine_parameters.empty()) {
+            options += R"END(
+    "engine": {)END";
+            if (!engine_type.empty()) {
+                options += R"END(
+      "type": ")END" + engine_type + "\"";
+                if (!engine_parameters.empty()) options += ",";
+            }
+            if (!engine_parameters.empty()) {
+                options += R"END(
+      "parameters": {
+)END" + getParameterList(engine_parameters, 8) + R"END(
+      })END";
+            }
+            options += R"END(
+    })END";
+            if (!operator_type.empty()) options += ",";
         }
+
         if (!operator_type.empty()) {
-            options = R"END(
-{
-  "adios2": {
+            options += R"END(
     "dataset": {
       "operators": [
         {
-          "type": ")END";
-            options += operator_type + "\"";
-        }
-        if (!operator_type.empty() && !op_parameters.empty()) {
-            options += R"END(
-         ,"parameters": {
-)END";
-            options += op_parameters + "}";
-        }
-        if (!operator_type.empty())
+          "type": ")END" + operator_type + "\"";
+            if (!operator_parameters.empty()) {
+                options += R"END(,
+          "parameters": {
+)END" + getParameterList(operator_parameters, 12) + R"END(
+          })END";
+            }
             options += R"END(
         }
       ]
-    }
+    })END";
+        }
+
+        options += R"END(
   }
 }
 )END";
-        if (options.empty()) options = "{}";
         return options;
     }
 
@@ -333,10 +372,14 @@ WarpXOpenPMDPlot::WarpXOpenPMDPlot (
     std::string openPMDFileType,
     std::string operator_type,
     std::map< std::string, std::string > operator_parameters,
-    std::vector<bool> fieldPMLdirections)
+    std::string engine_type,
+    std::map< std::string, std::string > engine_parameters,
+    std::vector<bool> fieldPMLdirections,
+    int particleStagingSize)
   :m_Series(nullptr),
    m_Encoding(ie),
    m_OpenPMDFileType(std::move(openPMDFileType)),
+   m_particleStagingSize(particleStagingSize),
    m_fieldPMLdirections(std::move(fieldPMLdirections))
 {
   // pick first available backend if default is chosen
@@ -351,7 +394,16 @@ WarpXOpenPMDPlot::WarpXOpenPMDPlot (
     m_OpenPMDFileType = "json";
 #endif
 
-    m_OpenPMDoptions = detail::getSeriesOptions(operator_type, operator_parameters);
+  if( m_OpenPMDFileType == "sst" ) {
+#if openPMD_HAVE_ADIOS2==1
+    m_isStreaming = true;
+#else
+    amrex::Abort("openPMD-api not built with ADIOS2 support, needed for the sst backend!");
+#endif
+  }
+
+    m_OpenPMDoptions = detail::getSeriesOptions(operator_type, operator_parameters,
+                                                engine_type, engine_parameters);
 }
 
 WarpXOpenPMDPlot::~WarpXOpenPMDPlot ()
@@ -418,9 +470,18 @@ void WarpXOpenPMDPlot::CloseStep (bool isBTD, bool isLastBTDFlush)
         if (m_Series) {
             GetIteration(m_CurrentStep, isBTD).close();
         }
+        if (isBTD) {
+            for (auto it = m_BTDParticleCount.begin(); it != m_BTDParticleCount.end(); ) {
+                if (it->first.first == m_CurrentStep) {
+                    it = m_BTDParticleCount.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
 
-        // create a little helper file for ParaView 5.9+
-        if (amrex::ParallelDescriptor::IOProcessor())
+        // create a little helper file for ParaView 5.9+ (there is no file to open when streaming)
+        if (amrex::ParallelDescriptor::IOProcessor() && !m_isStreaming)
         {
             // see Init()
             std::string filepath = m_dirPrefix;
@@ -626,6 +687,7 @@ WarpXOpenPMDPlot::DumpToFile (ParticleContainer* pc,
   currSpecies.setAttribute( "currentDeposition", [](){
       switch( WarpX::current_deposition_algo ) {
           case CurrentDepositionAlgo::Esirkepov : return "Esirkepov";
+          case CurrentDepositionAlgo::EsirkepovShared : return "Esirkepov";
           case CurrentDepositionAlgo::Vay : return "Vay";
           default: return "directMorseNielson";
       }
@@ -634,18 +696,29 @@ WarpXOpenPMDPlot::DumpToFile (ParticleContainer* pc,
   //
   // define positions & offsets
   //
-  SetupPos(currSpecies, counter.GetTotalNumParticles(), charge, mass);
-  SetupRealProperties(currSpecies, write_real_comp, real_comp_names, write_int_comp, int_comp_names, counter.GetTotalNumParticles());
+  // BTD: the particles of this flush are appended after the particles of the previous
+  // flushes of the snapshot, by extending the datasets
+  uint64_t const previousNumParticles = isBTD ? m_BTDParticleCount[{iteration, name}] : 0;
+  uint64_t const totalNumParticles = previousNumParticles + counter.GetTotalNumParticles();
+  if (isBTD) m_BTDParticleCount[{iteration, name}] = totalNumParticles;
+  SetupPos(currSpecies, totalNumParticles, charge, mass);
+  SetupRealProperties(currSpecies, write_real_comp, real_comp_names, write_int_comp, int_comp_names, totalNumParticles);
 
   // open files from all processors, in case some will not contribute below
   m_Series->flush();
 
   for (auto currentLevel = 0; currentLevel <= pc->finestLevel(); currentLevel++)
     {
-      uint64_t offset = static_cast<uint64_t>( counter.m_ParticleOffsetAtRank[currentLevel] );
+      uint64_t offset = previousNumParticles
+                      + static_cast<uint64_t>( counter.m_ParticleOffsetAtRank[currentLevel] );
 
       for (ParticleIter pti(*pc, currentLevel); pti.isValid(); ++pti) {
-         auto const numParticleOnTile = pti.numParticles();
+       // With a staging size, the tile is written in chunks, and the series is flushed
+       // after each chunk, so that the host buffers can be reused for the next chunk
+       auto const numParticleOnTot = pti.numParticles();
+       int const chunkSize = (m_particleStagingSize > 0) ? m_particleStagingSize : numParticleOnTot;
+       for (int start = 0; start < numParticleOnTot; start += chunkSize) {
+         auto const numParticleOnTile = std::min(chunkSize, numParticleOnTot - start);
          uint64_t const numParticleOnTile64 = static_cast<uint64_t>( numParticleOnTile );
 
          // get position and particle ID from aos
@@ -657,12 +730,9 @@ WarpXOpenPMDPlot::DumpToFile (ParticleContainer* pc,
            auto const positionComponents = detail::getParticlePositionComponentLabels();
 #if defined(WARPX_DIM_RZ)
            {
-              std::shared_ptr<amrex::ParticleReal> z(
-                      new amrex::ParticleReal[numParticleOnTile],
-                      [](amrex::ParticleReal const *p) { delete[] p; }
-              );
+              std::shared_ptr<amrex::ParticleReal> z = GetParticleRealBuffer(0, numParticleOnTile);
               for (auto i = 0; i < numParticleOnTile; i++)
-                  z.get()[i] = aos[i].pos(1);  // {0: "r", 1: "z"}
+                  z.get()[i] = aos[start+i].pos(1);  // {0: "r", 1: "z"}
               std::string const positionComponent = "z";
               currSpecies["position"]["z"].storeChunk(z, {offset}, {numParticleOnTile64});
            }
@@ -671,33 +741,24 @@ WarpXOpenPMDPlot::DumpToFile (ParticleContainer* pc,
            auto const& soa = pti.GetStructOfArrays();
            amrex::ParticleReal const* theta = soa.GetRealData(PIdx::theta).dataPtr();
            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(theta != nullptr, "openPMD: invalid theta pointer.");
-           AMREX_ALWAYS_ASSERT_WITH_MESSAGE(int(soa.GetRealData(PIdx::theta).size()) == numParticleOnTile,
+           AMREX_ALWAYS_ASSERT_WITH_MESSAGE(int(soa.GetRealData(PIdx::theta).size()) == numParticleOnTot,
                                             "openPMD: theta and tile size do not match");
            {
-               std::shared_ptr< amrex::ParticleReal > x(
-                       new amrex::ParticleReal[numParticleOnTile],
-                       [](amrex::ParticleReal const *p){ delete[] p; }
-               );
-               std::shared_ptr< amrex::ParticleReal > y(
-                       new amrex::ParticleReal[numParticleOnTile],
-                       [](amrex::ParticleReal const *p){ delete[] p; }
-               );
+               std::shared_ptr<amrex::ParticleReal> x = GetParticleRealBuffer(1, numParticleOnTile);
+               std::shared_ptr<amrex::ParticleReal> y = GetParticleRealBuffer(2, numParticleOnTile);
                for (auto i=0; i<numParticleOnTile; i++) {
-                   auto const r = aos[i].pos(0);  // {0: "r", 1: "z"}
-                   x.get()[i] = r * std::cos(theta[i]);
-                   y.get()[i] = r * std::sin(theta[i]);
+                   auto const r = aos[start+i].pos(0);  // {0: "r", 1: "z"}
+                   x.get()[i] = r * std::cos(theta[start+i]);
+                   y.get()[i] = r * std::sin(theta[start+i]);
                }
                currSpecies["position"]["x"].storeChunk(x, {offset}, {numParticleOnTile64});
                currSpecies["position"]["y"].storeChunk(y, {offset}, {numParticleOnTile64});
            }
 #else
            for (auto currDim = 0; currDim < AMREX_SPACEDIM; currDim++) {
-                std::shared_ptr< amrex::ParticleReal > curr(
-                    new amrex::ParticleReal[numParticleOnTile],
-                    [](amrex::ParticleReal const *p){ delete[] p; }
-                );
+                std::shared_ptr<amrex::ParticleReal> curr = GetParticleRealBuffer(currDim, numParticleOnTile);
                 for (auto i=0; i<numParticleOnTile; i++) {
-                     curr.get()[i] = aos[i].pos(currDim);
+                     curr.get()[i] = aos[start+i].pos(currDim);
                 }
                 std::string const positionComponent = positionComponents[currDim];
                 currSpecies["position"][positionComponent].storeChunk(curr, {offset}, {numParticleOnTile64});
@@ -705,12 +766,9 @@ WarpXOpenPMDPlot::DumpToFile (ParticleContainer* pc,
 #endif
 
            // save particle ID after converting it to a globally unique ID
-           std::shared_ptr< uint64_t > ids(
-               new uint64_t[numParticleOnTile],
-               [](uint64_t const *p){ delete[] p; }
-           );
+           std::shared_ptr<uint64_t> ids = GetParticleIdBuffer(numParticleOnTile);
            for (auto i=0; i<numParticleOnTile; i++) {
-               ids.get()[i] = WarpXUtilIO::localIDtoGlobal( aos[i].id(), aos[i].cpu() );
+               ids.get()[i] = WarpXUtilIO::localIDtoGlobal( aos[start+i].id(), aos[start+i].cpu() );
            }
            auto const scalar = openPMD::RecordComponent::SCALAR;
            currSpecies["id"][scalar].storeChunk(ids, {offset}, {numParticleOnTile64});
@@ -720,14 +778,49 @@ WarpXOpenPMDPlot::DumpToFile (ParticleContainer* pc,
              currSpecies,
              offset,
              write_real_comp, real_comp_names,
-             write_int_comp, int_comp_names);
+             write_int_comp, int_comp_names,
+             start, numParticleOnTile);
 
          offset += numParticleOnTile64;
+
+         if (m_particleStagingSize > 0) m_Series->flush();
+       }
       }
     }
     m_Series->flush();
 }
 
+std::shared_ptr<amrex::ParticleReal>
+WarpXOpenPMDPlot::GetParticleRealBuffer (int slot, int np) const
+{
+    if (m_particleStagingSize <= 0) {
+        return std::shared_ptr<amrex::ParticleReal>(
+            new amrex::ParticleReal[np], [](amrex::ParticleReal const *p){ delete[] p; });
+    }
+    if (slot >= static_cast<int>(m_particleStagingReal.size())) {
+        m_particleStagingReal.resize(slot+1);
+    }
+    auto& buffer = m_particleStagingReal[slot];
+    if (!buffer) {
+        buffer = std::shared_ptr<amrex::ParticleReal>(
+            new amrex::ParticleReal[m_particleStagingSize], [](amrex::ParticleReal const *p){ delete[] p; });
+    }
+    return buffer;
+}
+
+std::shared_ptr<uint64_t>
+WarpXOpenPMDPlot::GetParticleIdBuffer (int np) const
+{
+    if (m_particleStagingSize <= 0) {
+        return std::shared_ptr<uint64_t>(new uint64_t[np], [](uint64_t const *p){ delete[] p; });
+    }
+    if (!m_particleStagingId) {
+        m_particleStagingId = std::shared_ptr<uint64_t>(
+            new uint64_t[m_particleStagingSize], [](uint64_t const *p){ delete[] p; });
+    }
+    return m_particleStagingId;
+}
+
 void
 WarpXOpenPMDPlot::SetupRealProperties (openPMD::ParticleSpecies& currSpecies,
                       const amrex::Vector<int>& write_real_comp,
@@ -817,7 +910,8 @@ WarpXOpenPMDPlot::SaveRealProperty (ParticleIter& pti,
                        amrex::Vector<int> const& write_real_comp,
                        amrex::Vector<std::string> const& real_comp_names,
                        amrex::Vector<int> const& write_int_comp,
-                       amrex::Vector<std::string> const& int_comp_names) const
+                       amrex::Vector<std::string> const& int_comp_names,
+                       int const start, int const np) const
 
 {
   int numOutputReal = 0;
@@ -827,7 +921,7 @@ WarpXOpenPMDPlot::SaveRealProperty (ParticleIter& pti,
     if( write_real_comp[i] )
       ++numOutputReal;
 
-  auto const numParticleOnTile = pti.numParticles();
+  auto const numParticleOnTile = np;
   uint64_t const numParticleOnTile64 = static_cast<uint64_t>( numParticleOnTile );
   auto const& aos = pti.GetArrayOfStructs();  // size =  numParticlesOnTile
   auto const& soa = pti.GetStructOfArrays();
@@ -842,13 +936,11 @@ WarpXOpenPMDPlot::SaveRealProperty (ParticleIter& pti,
           auto currRecord = currSpecies[record_name];
           auto currRecordComp = currRecord[component_name];
 
-          std::shared_ptr< amrex::ParticleReal > d(
-              new amrex::ParticleReal[numParticleOnTile],
-              [](amrex::ParticleReal const *p){ delete[] p; }
-          );
+          // slots 0 to 2 are used by the positions
+          std::shared_ptr<amrex::ParticleReal> d = GetParticleRealBuffer(3+idx, numParticleOnTile);
 
           for( auto kk=0; kk<numParticleOnTile; kk++ )
-               d.get()[kk] = aos[kk].rdata(idx);
+               d.get()[kk] = aos[start+kk].rdata(idx);
 
           currRecordComp.storeChunk(d,
                {offset}, {numParticleOnTile64});
@@ -869,7 +961,7 @@ WarpXOpenPMDPlot::SaveRealProperty (ParticleIter& pti,
     for (auto idx=0; idx<real_counter; idx++) {
       auto ii = m_NumAoSRealAttributes + idx;
       if (write_real_comp[ii]) {
-        getComponentRecord(real_comp_names[ii]).storeChunk(openPMD::shareRaw(soa.GetRealData(idx)),
+        getComponentRecord(real_comp_names[ii]).storeChunk(openPMD::shareRaw(soa.GetRealData(idx).dataPtr() + start),
           {offset}, {numParticleOnTile64});
       }
     }
@@ -880,7 +972,7 @@ WarpXOpenPMDPlot::SaveRealProperty (ParticleIter& pti,
     for (auto idx=0; idx<int_counter; idx++) {
       auto ii = m_NumAoSIntAttributes + idx; // jump over AoS names
       if (write_int_comp[ii]) {
-        getComponentRecord(int_comp_names[ii]).storeChunk(openPMD::shareRaw(soa.GetIntData(idx)),
+        getComponentRecord(int_comp_names[ii]).storeChunk(openPMD::shareRaw(soa.GetIntData(idx).dataPtr() + start),
           {offset}, {numParticleOnTile64});
       }
     }
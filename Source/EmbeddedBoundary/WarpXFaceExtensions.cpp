@@ -6,10 +6,254 @@
  */
 
 #include "WarpX.H"
+#include "EmbeddedBoundary/WarpXFaceExtensions.H"
+#include "EmbeddedBoundary/WarpXFaceInfoBox.H"
+
+#include <AMReX_Array.H>
+#include <AMReX_Array4.H>
+#include <AMReX_Dim3.H>
+#include <AMReX_GpuAtomic.H>
+#include <AMReX_GpuQualifiers.H>
 #include <AMReX_Scan.H>
 #include <AMReX_iMultiFab.H>
 #include <AMReX_MultiFab.H>
 
+#include <algorithm>
+
+
+#ifdef AMREX_USE_EB
+namespace {
+    /**
+    * \brief Indices of the neighbor (a, b) of the face of cell pointing in direction idim,
+    *        where a and b are the offsets along the two directions in the plane of the face
+    */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    amrex::Dim3 FaceNeighbor (const amrex::Dim3 cell, const int idim, const int a, const int b) {
+        if (idim == 0) {
+            return amrex::Dim3{cell.x, cell.y + a, cell.z + b};
+        } else if (idim == 1) {
+            return amrex::Dim3{cell.x + a, cell.y, cell.z + b};
+        }
+        return amrex::Dim3{cell.x + a, cell.y + b, cell.z};
+    }
+
+    /**
+    * \brief Area that the face of cell pointing in direction idim needs to borrow to be stable
+    *
+    * \param[in] S \c Array4 storing the area of the faces
+    * \param[in] l1, l2 \c Array4 storing the lengths of the edges along the first and
+    *            second direction in the plane of the face
+    * \param[in] d1, d2 cell sizes along the first and second direction in the plane of the face
+    */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    amrex::Real ComputeExtensionArea (const amrex::Dim3 cell, const int idim,
+                                      const amrex::Array4<amrex::Real>& S,
+                                      const amrex::Array4<amrex::Real>& l1,
+                                      const amrex::Array4<amrex::Real>& l2,
+                                      const amrex::Real d1, const amrex::Real d2) {
+        const amrex::Dim3 c1 = FaceNeighbor(cell, idim, 1, 0);
+        const amrex::Dim3 c2 = FaceNeighbor(cell, idim, 0, 1);
+        const amrex::Real S_stab = 0.5 * std::max({l1(cell.x, cell.y, cell.z) * d2,
+                                                   l1(c2.x, c2.y, c2.z) * d2,
+                                                   l2(cell.x, cell.y, cell.z) * d1,
+                                                   l2(c1.x, c1.y, c1.z) * d1});
+        return S_stab - S(cell.x, cell.y, cell.z);
+    }
+
+    /**
+    * \brief Take the area patch from an intruded face. Several unstable faces can try to
+    *        intrude the same face concurrently, so the area is taken atomically, and given
+    *        back if the intruded face does not have enough area left.
+    *
+    * \param[in,out] S_mod pointer to the area that the intruded face can still give away
+    * \param[in] patch area to take
+    * \return whether the area was taken
+    */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    bool TakeArea (amrex::Real* const S_mod, const amrex::Real patch) {
+        const amrex::Real old = amrex::Gpu::Atomic::Add(S_mod, -patch);
+        if (old - patch > 0) {
+            return true;
+        }
+        amrex::Gpu::Atomic::AddNoRet(S_mod, patch);
+        return false;
+    }
+
+    /**
+    * \brief Total area of the available neighbors of the face of cell pointing in direction idim
+    */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    amrex::Real AvailableArea (const amrex::Dim3 cell, const int idim,
+                               const amrex::Array4<amrex::Real>& S,
+                               const amrex::Array2D<int, 0, 2, 0, 2>& local_avail) {
+        amrex::Real denom = 0.;
+        for (int a = 0; a <= 2; a++) {
+            for (int b = 0; b <= 2; b++) {
+                if (a == 1 && b == 1) continue;
+                const amrex::Dim3 n = FaceNeighbor(cell, idim, a - 1, b - 1);
+                denom += local_avail(a, b) * S(n.x, n.y, n.z);
+            }
+        }
+        return denom;
+    }
+
+    /**
+    * \brief One-way extension of the face of cell pointing in direction idim: the area S_ext
+    *        is borrowed from one of the four (non-diagonal) neighboring faces.
+    *
+    * \param[in] ps index of the first entry of the FaceInfoBox vectors for this face
+    * \return the number of intruded faces (one, or zero if no neighbor could give the area)
+    */
+    AMREX_GPU_DEVICE
+    int OneWayExtension (const amrex::Dim3 cell, const int idim, const amrex::Real S_ext,
+                         const amrex::Array4<amrex::Real>& S_mod,
+                         const amrex::Array4<int>& flag_info_face,
+                         const amrex::Array4<int>& flag_ext_face, const int ps,
+                         int* borrowing_inds, FaceInfoBox::Neighbours* borrowing_neigh_faces,
+                         amrex::Real* borrowing_area) {
+        for (int a = -1; a < 2; a++) {
+            for (int b = -1; b < 2; b++) {
+                //This if makes sure that we don't visit the "diagonal neighbours"
+                if (a == b || a == -b) continue;
+                // Here a face is available if it doesn't need to be extended itself and if its
+                // area exceeds S_ext. We need to take into account if the intruded face
+                // has given away already some area, so we use S_mod rather than S.
+                const amrex::Dim3 n = FaceNeighbor(cell, idim, a, b);
+                const int info = flag_info_face(n.x, n.y, n.z);
+                if ((info == 1 || info == 2) && S_mod(n.x, n.y, n.z) > S_ext
+                    && TakeArea(&S_mod(n.x, n.y, n.z), S_ext)) {
+                    // Insert the index of the face info
+                    borrowing_inds[ps] = ps;
+                    // Store the information about the intruded face in the dataset of the
+                    // faces which are borrowing area
+                    FaceInfoBox::addConnectedNeighbor(a, b, ps, borrowing_neigh_faces);
+                    borrowing_area[ps] = S_ext;
+                    flag_info_face(n.x, n.y, n.z) = 2;
+                    // Add the area to the intruding face.
+                    S_mod(cell.x, cell.y, cell.z) += S_ext;
+                    flag_ext_face(cell.x, cell.y, cell.z) = false;
+                    return 1;
+                }
+            }
+        }
+        return 0;
+    }
+
+    /**
+    * \brief Eight-ways extension of the face of cell pointing in direction idim: the area S_ext
+    *        is borrowed from all the available neighboring faces, proportionally to their area.
+    *        When another unstable face took area from one of the neighbors in the meantime
+    *        (so that it cannot give its patch anymore), the patches already taken are given
+    *        back and the extension is tried again without this neighbor.
+    *
+    * \param[in] ps index of the first entry of the FaceInfoBox vectors for this face
+    * \return the number of intruded faces (zero if the face could not be extended)
+    */
+    AMREX_GPU_DEVICE
+    int EightWaysExtension (const amrex::Dim3 cell, const int idim, const amrex::Real S_ext,
+                            const amrex::Array4<amrex::Real>& S,
+                            const amrex::Array4<amrex::Real>& S_mod,
+                            const amrex::Array4<int>& flag_info_face,
+                            const amrex::Array4<int>& flag_ext_face, const int ps,
+                            int* borrowing_inds, FaceInfoBox::Neighbours* borrowing_neigh_faces,
+                            amrex::Real* borrowing_area) {
+        // Use a local 3x3 array to keep track of which of the neighboring faces is available to be
+        // intruded.
+        amrex::Array2D<int, 0, 2, 0, 2> local_avail{};
+        for (int a = 0; a <= 2; a++) {
+            for (int b = 0; b <= 2; b++) {
+                const amrex::Dim3 n = FaceNeighbor(cell, idim, a - 1, b - 1);
+                local_avail(a, b) = (flag_info_face(n.x, n.y, n.z) == 1
+                                     || flag_info_face(n.x, n.y, n.z) == 2);
+            }
+        }
+        amrex::Array2D<amrex::Real, 0, 2, 0, 2> patches{};
+
+        bool taken = false;
+        while (!taken) {
+            // denom is the total area that can be borrowed from the neighboring faces
+            amrex::Real denom = AvailableArea(cell, idim, S, local_avail);
+
+            // If any of the surrounding faces would be giving away to much area, then we have to
+            // exclude it from the extension process and repeat, until either all the faces
+            // are big enough to be intruded or none of the faces can be intruded (denom = 0).
+            bool neg_face = true;
+            while (denom >= S_ext && neg_face && denom > 0) {
+                neg_face = false;
+                for (int a = 0; a <= 2; a++) {
+                    for (int b = 0; b <= 2; b++) {
+                        if (local_avail(a, b)) {
+                            const amrex::Dim3 n = FaceNeighbor(cell, idim, a - 1, b - 1);
+                            const amrex::Real patch = S_ext * S(n.x, n.y, n.z) / denom;
+                            if (S_mod(n.x, n.y, n.z) - patch <= 0) {
+                                neg_face = true;
+                                local_avail(a, b) = false;
+                            }
+                        }
+                    }
+                }
+                denom = AvailableArea(cell, idim, S, local_avail);
+            }
+
+            if (denom < S_ext) {
+                return 0;
+            }
+
+            // Take the patches from the intruded faces
+            taken = true;
+            for (int a = 0; a <= 2 && taken; a++) {
+                for (int b = 0; b <= 2 && taken; b++) {
+                    patches(a, b) = 0.;
+                    if (local_avail(a, b)) {
+                        const amrex::Dim3 n = FaceNeighbor(cell, idim, a - 1, b - 1);
+                        const amrex::Real patch = S_ext * S(n.x, n.y, n.z) / denom;
+                        if (TakeArea(&S_mod(n.x, n.y, n.z), patch)) {
+                            patches(a, b) = patch;
+                        } else {
+                            local_avail(a, b) = false;
+                            taken = false;
+                        }
+                    }
+                }
+            }
+            if (!taken) {
+                // Give back the patches and try again without the face that was lacking area
+                for (int a = 0; a <= 2; a++) {
+                    for (int b = 0; b <= 2; b++) {
+                        if (patches(a, b) > 0) {
+                            const amrex::Dim3 n = FaceNeighbor(cell, idim, a - 1, b - 1);
+                            amrex::Gpu::Atomic::AddNoRet(&S_mod(n.x, n.y, n.z), patches(a, b));
+                            patches(a, b) = 0.;
+                        }
+                    }
+                }
+            }
+        }
+
+        S_mod(cell.x, cell.y, cell.z) = S(cell.x, cell.y, cell.z);
+        int count = 0;
+        for (int a = 0; a <= 2; a++) {
+            for (int b = 0; b <= 2; b++) {
+                if (local_avail(a, b)) {
+                    const amrex::Dim3 n = FaceNeighbor(cell, idim, a - 1, b - 1);
+                    borrowing_inds[ps + count] = ps + count;
+                    // Store the information about the intruded face in the dataset of the
+                    // faces which are borrowing area
+                    FaceInfoBox::addConnectedNeighbor(a - 1, b - 1, ps + count,
+                                                      borrowing_neigh_faces);
+                    borrowing_area[ps + count] = patches(a, b);
+                    flag_info_face(n.x, n.y, n.z) = 2;
+                    S_mod(cell.x, cell.y, cell.z) += patches(a, b);
+                    count += 1;
+                }
+            }
+        }
+        flag_ext_face(cell.x, cell.y, cell.z) = false;
+        return count;
+    }
+}
+#endif
+
 
 amrex::Array1D<int, 0, 2>
 WarpX::CountExtFaces() {
@@ -88,46 +332,21 @@ WarpX::ComputeFaceExtensions(){
 
 void
 WarpX::InitBorrowing() {
-    int idim = 0;
-    for (amrex::MFIter mfi(*Bfield_fp[maxLevel()][idim]); mfi.isValid(); ++mfi) {
-        amrex::Box const &box = mfi.validbox();
-        auto &borrowing_x = (*m_borrowing[maxLevel()][idim])[mfi];
-        borrowing_x.inds_pointer.resize(box);
-        borrowing_x.size.resize(box);
-        borrowing_x.size.setVal<amrex::RunOn::Device>(0);
-        amrex::Long ncells = box.numPts();
-        // inds, neigh_faces and area are extended to their largest possible size here, but they are
-        // resized to a much smaller size later on, based on the actual number of neighboring
-        // intruded faces for each unstable face.
-        borrowing_x.inds.resize(8*ncells);
-        borrowing_x.neigh_faces.resize(8*ncells);
-        borrowing_x.area.resize(8*ncells);
-    }
-
-    idim = 1;
-    for (amrex::MFIter mfi(*Bfield_fp[maxLevel()][idim]); mfi.isValid(); ++mfi) {
-        amrex::Box const &box = mfi.validbox();
-        auto &borrowing_y = (*m_borrowing[maxLevel()][idim])[mfi];
-        borrowing_y.inds_pointer.resize(box);
-        borrowing_y.size.resize(box);
-        borrowing_y.size.setVal<amrex::RunOn::Device>(0);
-        amrex::Long ncells = box.numPts();
-        borrowing_y.inds.resize(8*ncells);
-        borrowing_y.neigh_faces.resize(8*ncells);
-        borrowing_y.area.resize(8*ncells);
-    }
-
-    idim = 2;
-    for (amrex::MFIter mfi(*Bfield_fp[maxLevel()][idim]); mfi.isValid(); ++mfi) {
-        amrex::Box const &box = mfi.validbox();
-        auto &borrowing_z = (*m_borrowing[maxLevel()][idim])[mfi];
-        borrowing_z.inds_pointer.resize(box);
-        borrowing_z.size.resize(box);
-        borrowing_z.size.setVal<amrex::RunOn::Device>(0);
-        amrex::Long ncells = box.numPts();
-        borrowing_z.inds.resize(8*ncells);
-        borrowing_z.neigh_faces.resize(8*ncells);
-        borrowing_z.area.resize(8*ncells);
+    for (int idim = 0; idim < 3; ++idim) {
+        for (amrex::MFIter mfi(*Bfield_fp[maxLevel()][idim]); mfi.isValid(); ++mfi) {
+            amrex::Box const &box = mfi.validbox();
+            auto &borrowing = (*m_borrowing[maxLevel()][idim])[mfi];
+            borrowing.inds_pointer.resize(box);
+            borrowing.size.resize(box);
+            borrowing.size.setVal<amrex::RunOn::Device>(0);
+            amrex::Long ncells = box.numPts();
+            // inds, neigh_faces and area are extended to their largest possible size here, but they are
+            // resized to a much smaller size later on, based on the actual number of neighboring
+            // intruded faces for each unstable face.
+            borrowing.inds.resize(8*ncells);
+            borrowing.neigh_faces.resize(8*ncells);
+            borrowing.area.resize(8*ncells);
+        }
     }
 }
 
@@ -380,296 +599,68 @@ ComputeNBorrowEightFacesExtension(const amrex::Dim3 cell, const amrex::Real S_ex
 void
 WarpX::ComputeOneWayExtensions() {
 #ifdef AMREX_USE_EB
-    auto const eb_fact = fieldEBFactory(maxLevel());
     auto const &cell_size = CellSize(maxLevel());
 
-    // Do the extensions in the x-plane
-    int idim = 0;
-
-    for (amrex::MFIter mfi(*Bfield_fp[maxLevel()][idim]); mfi.isValid(); ++mfi) {
-
-        amrex::Box const &box = mfi.validbox();
-
-        auto const &Sx = m_face_areas[maxLevel()][idim]->array(mfi);
-        auto const &flag_ext_face_x = m_flag_ext_face[maxLevel()][idim]->array(mfi);
-        auto const &flag_info_face_x = m_flag_info_face[maxLevel()][idim]->array(mfi);
-        auto &borrowing_x = (*m_borrowing[maxLevel()][idim])[mfi];
-        auto const &borrowing_x_inds_pointer = borrowing_x.inds_pointer.array();
-        auto const &borrowing_x_size = borrowing_x.size.array();
-        amrex::Long ncells = box.numPts();
-        int* borrowing_x_inds = borrowing_x.inds.data();
-        FaceInfoBox::Neighbours* borrowing_x_neigh_faces = borrowing_x.neigh_faces.data();
-        amrex::Real* borrowing_x_area = borrowing_x.area.data();
-        int& vecs_size_x = borrowing_x.vecs_size;
-
-        auto const &Sx_mod = m_area_mod[maxLevel()][idim]->array(mfi);
-        const auto &ly = m_edge_lengths[maxLevel()][1]->array(mfi);
-        const auto &lz = m_edge_lengths[maxLevel()][2]->array(mfi);
-        const amrex::Real dy = cell_size[1];
-        const amrex::Real dz = cell_size[2];
-
-        vecs_size_x = amrex::Scan::PrefixSum<int>(ncells,
-        [=] AMREX_GPU_DEVICE (int icell) {
-            const amrex::Dim3 cell = box.atOffset(icell).dim3();
-            const int i = cell.x;
-            const int j = cell.y;
-            const int k = cell.z;
-            // If the face doesn't need to be extended break the loop
-            if (!flag_ext_face_x(i, j, k)) {
-                return 0;
-            }
-
-            amrex::Real Sx_stab = 0.5 * std::max({ly(i, j, k) * dz, ly(i, j, k + 1) * dz,
-                                                  lz(i, j, k) * dy, lz(i, j + 1, k) * dy});
-            amrex::Real Sx_ext = Sx_stab - Sx(i, j, k);
-            int n_borrow = ComputeNBorrowOneFaceExtension(cell, Sx_ext, Sx_mod, flag_info_face_x,
-                                                          flag_ext_face_x, idim);
-
-            borrowing_x_size(i, j, k) = n_borrow;
-            return n_borrow;
-        },
-        [=] AMREX_GPU_DEVICE (int icell, int ps){
-            amrex::Dim3 cell = box.atOffset(icell).dim3();
-            const int i = cell.x;
-            const int j = cell.y;
-            const int k = cell.z;
-            int nborrow = borrowing_x_size(i, j, k);
-            if (nborrow == 0) {
-                borrowing_x_inds_pointer(i, j, k) = nullptr;
-            } else{
-                borrowing_x_inds_pointer(i, j, k) = borrowing_x_inds + ps;
-
-                amrex::Real Sx_stab = 0.5 * std::max({ly(i, j, k) * dz, ly(i, j, k + 1) * dz,
-                                                      lz(i, j, k) * dy, lz(i, j + 1, k) * dy});
-                amrex::Real Sx_ext = Sx_stab - Sx(i, j, k);
-                for (int j_n = -1; j_n < 2; j_n++) {
-                    for (int k_n = -1; k_n < 2; k_n++) {
-                        //This if makes sure that we don't visit the "diagonal neighbours"
-                        if( !(j_n == k_n || j_n == -k_n)){
-                            // Here a face is available if it doesn't need to be extended itself and if its
-                            // area exceeds Sz_ext. Here we need to take into account if the intruded face
-                            // has given away already some area, so we use Sz_red rather than Sz.
-                            // If no face is available we don't do anything and we will need to use the
-                            // multi-face extensions.
-                            if (Sx_mod(i, j + j_n, k + k_n) > Sx_ext
-                                && ( flag_info_face_x(i, j + j_n, k + k_n) == 1
-                                      || flag_info_face_x(i, j + j_n, k + k_n) == 2)
-                                && flag_ext_face_x(i, j, k)) {
-                                Sx_mod(i, j + j_n, k + k_n) -= Sx_ext;
-                                // Insert the index of the face info
-                                borrowing_x_inds[ps] = ps;
-                                // Store the information about the intruded face in the dataset of the
-                                // faces which are borrowing area
-                                FaceInfoBox::addConnectedNeighbor(j_n, k_n, ps,
-                                                                 borrowing_x_neigh_faces);
-
-                                borrowing_x_area[ps] = Sx_ext;
-
-                                flag_info_face_x(i, j + j_n, k + k_n) = 2;
-                                // Add the area to the intruding face.
-                                Sx_mod(i, j, k) += Sx_ext;
-                                flag_ext_face_x(i, j, k) = false;
-                            }
-                        }
-                    }
-                }
-            }
-        }, amrex::Scan::Type::exclusive);
-
+    // Do the extensions in the x-, y- and z-planes
+    for (int idim = 0; idim < 3; ++idim) {
+        // Directions in the plane of the faces
+        const int idim1 = (idim == 0) ? 1 : 0;
+        const int idim2 = (idim == 2) ? 1 : 2;
 
-    }
-    // Do the extensions in the y-plane
-    idim = 1;
-
-    for (amrex::MFIter mfi(*Bfield_fp[maxLevel()][idim]); mfi.isValid(); ++mfi) {
-
-        amrex::Box const &box = mfi.validbox();
-
-        auto const &Sy = m_face_areas[maxLevel()][idim]->array(mfi);
-        auto const &flag_ext_face_y = m_flag_ext_face[maxLevel()][idim]->array(mfi);
-        auto const &flag_info_face_y = m_flag_info_face[maxLevel()][idim]->array(mfi);
-        auto &borrowing_y = (*m_borrowing[maxLevel()][idim])[mfi];
-        auto const &borrowing_y_inds_pointer = borrowing_y.inds_pointer.array();
-        auto const &borrowing_y_size = borrowing_y.size.array();
-        amrex::Long ncells = box.numPts();
-        int* borrowing_y_inds = borrowing_y.inds.data();
-        FaceInfoBox::Neighbours* borrowing_y_neigh_faces = borrowing_y.neigh_faces.data();
-        amrex::Real* borrowing_y_area = borrowing_y.area.data();
-        int& vecs_size_y = borrowing_y.vecs_size;
-
-        auto const &Sy_mod = m_area_mod[maxLevel()][idim]->array(mfi);
-        const auto &lx = m_edge_lengths[maxLevel()][0]->array(mfi);
-        const auto &lz = m_edge_lengths[maxLevel()][2]->array(mfi);
-        const amrex::Real dx = cell_size[0];
-        const amrex::Real dz = cell_size[2];
-
-        vecs_size_y = amrex::Scan::PrefixSum<int>(ncells,
-            [=] AMREX_GPU_DEVICE (int icell) {
-                const amrex::Dim3 cell = box.atOffset(icell).dim3();
-                const int i = cell.x;
-                const int j = cell.y;
-                const int k = cell.z;
-                // If the face doesn't need to be extended break the loop
-                if (!flag_ext_face_y(i, j, k)) {
-                    return 0;
-                }
+        for (amrex::MFIter mfi(*Bfield_fp[maxLevel()][idim]); mfi.isValid(); ++mfi) {
 
-                amrex::Real Sy_stab = 0.5 * std::max({lx(i, j, k) * dz, lx(i, j, k + 1) * dz,
-                                                      lz(i, j, k) * dx, lz(i + 1, j, k) * dx});
-                amrex::Real Sy_ext = Sy_stab - Sy(i, j, k);
-                int n_borrow =
-                    ComputeNBorrowOneFaceExtension(cell, Sy_ext, Sy_mod, flag_info_face_y,
-                                                   flag_ext_face_y, idim);
+            amrex::Box const &box = mfi.validbox();
 
-                borrowing_y_size(i, j, k) = n_borrow;
-                return n_borrow;
-                },
-            [=] AMREX_GPU_DEVICE (int icell, int ps){
-                const amrex::Dim3 cell = box.atOffset(icell).dim3();
-                const int i = cell.x;
-                const int j = cell.y;
-                const int k = cell.z;
-                const int nborrow = borrowing_y_size(i, j, k);
-
-                if (nborrow == 0) {
-                    borrowing_y_inds_pointer(i, j, k) = nullptr;
-                } else{
-                    borrowing_y_inds_pointer(i, j, k) = borrowing_y_inds + ps;
-
-                    amrex::Real Sy_stab = 0.5 * std::max({lx(i, j, k) * dz, lx(i, j, k+1) * dz,
-                                                          lz(i, j, k) * dx, lz(i+1, j, k) * dz});
-                    amrex::Real Sy_ext = Sy_stab - Sy(i, j, k);
-                    for (int i_n = -1; i_n < 2; i_n++) {
-                        for (int k_n = -1; k_n < 2; k_n++) {
-                            //This if makes sure that we don't visit the "diagonal neighbours"
-                            if( !(i_n == k_n || i_n == -k_n)){
-                                // Here a face is available if it doesn't need to be extended itself and if its
-                                // area exceeds Sz_ext. Here we need to take into account if the intruded face
-                                // has given away already some area, so we use Sz_red rather than Sz.
-                                // If no face is available we don't do anything and we will need to use the
-                                // multi-face extensions.
-                                if (Sy_mod(i + i_n, j, k + k_n) > Sy_ext
-                                    && (flag_info_face_y(i + i_n, j, k + k_n) == 1
-                                         || flag_info_face_y(i + i_n, j, k + k_n) == 2)
-                                    && flag_ext_face_y(i, j, k)) {
-                                    Sy_mod(i + i_n, j, k + k_n) -= Sy_ext;
-                                    // Insert the index of the face info
-                                    borrowing_y_inds[ps] = ps;
-                                    // Store the information about the intruded face in the dataset of the
-                                    // faces which are borrowing area
-                                    FaceInfoBox::addConnectedNeighbor(i_n, k_n, ps,
-                                                                      borrowing_y_neigh_faces);
-                                    borrowing_y_area[ps] = Sy_ext;
-
-                                    flag_info_face_y(i + i_n, j, k + k_n) = 2;
-                                    // Add the area to the intruding face.
-                                    Sy_mod(i, j, k) = Sy(i, j, k) + Sy_ext;
-                                    flag_ext_face_y(i, j, k) = false;
-                                }
-                            }
-                        }
+            auto const &S = m_face_areas[maxLevel()][idim]->array(mfi);
+            auto const &S_mod = m_area_mod[maxLevel()][idim]->array(mfi);
+            auto const &flag_ext_face = m_flag_ext_face[maxLevel()][idim]->array(mfi);
+            auto const &flag_info_face = m_flag_info_face[maxLevel()][idim]->array(mfi);
+            auto &borrowing = (*m_borrowing[maxLevel()][idim])[mfi];
+            auto const &borrowing_inds_pointer = borrowing.inds_pointer.array();
+            auto const &borrowing_size = borrowing.size.array();
+            amrex::Long ncells = box.numPts();
+            int* borrowing_inds = borrowing.inds.data();
+            FaceInfoBox::Neighbours* borrowing_neigh_faces = borrowing.neigh_faces.data();
+            amrex::Real* borrowing_area = borrowing.area.data();
+
+            const auto &l1 = m_edge_lengths[maxLevel()][idim1]->array(mfi);
+            const auto &l2 = m_edge_lengths[maxLevel()][idim2]->array(mfi);
+            const amrex::Real d1 = cell_size[idim1];
+            const amrex::Real d2 = cell_size[idim2];
+
+            // The first pass counts the faces that each unstable face needs to intrude,
+            // the second pass intrudes them, all the faces being processed in parallel
+            borrowing.vecs_size = amrex::Scan::PrefixSum<int>(ncells,
+                [=] AMREX_GPU_DEVICE (int icell) {
+                    const amrex::Dim3 cell = box.atOffset(icell).dim3();
+                    // If the face doesn't need to be extended break the loop
+                    if (!flag_ext_face(cell.x, cell.y, cell.z)) {
+                        return 0;
                     }
-                }
-            }, amrex::Scan::Type::exclusive);
-
-    }
-    // Do the extensions in the z-plane
-    idim = 2;
-
-    for (amrex::MFIter mfi(*Bfield_fp[maxLevel()][idim]); mfi.isValid(); ++mfi) {
-
-        amrex::Box const &box = mfi.validbox();
-
-        auto const &Sz = m_face_areas[maxLevel()][idim]->array(mfi);
-        auto const &flag_ext_face_z = m_flag_ext_face[maxLevel()][idim]->array(mfi);
-        auto const &flag_info_face_z = m_flag_info_face[maxLevel()][idim]->array(mfi);
-        auto &borrowing_z = (*m_borrowing[maxLevel()][idim])[mfi];
-        auto const &borrowing_z_inds_pointer = borrowing_z.inds_pointer.array();
-        auto const &borrowing_z_size = borrowing_z.size.array();
-        amrex::Long ncells = box.numPts();
-        int* borrowing_z_inds = borrowing_z.inds.data();
-        FaceInfoBox::Neighbours* borrowing_z_neigh_faces = borrowing_z.neigh_faces.data();
-        amrex::Real* borrowing_z_area = borrowing_z.area.data();
-        int& vecs_size_z = borrowing_z.vecs_size;
-
-        auto const &Sz_mod = m_area_mod[maxLevel()][idim]->array(mfi);
-        const auto &lx = m_edge_lengths[maxLevel()][0]->array(mfi);
-        const auto &ly = m_edge_lengths[maxLevel()][1]->array(mfi);
-        const amrex::Real dx = cell_size[0];
-        const amrex::Real dy = cell_size[1];
-
-        vecs_size_z = amrex::Scan::PrefixSum<int>(ncells,
-            [=] AMREX_GPU_DEVICE (int icell) {
-                const amrex::Dim3 cell = box.atOffset(icell).dim3();
-                const int i = cell.x;
-                const int j = cell.y;
-                const int k = cell.z;
-                // If the face doesn't need to be extended break the loop
-                if (!flag_ext_face_z(i, j, k)) {
-                    return 0;
-                }
-
-                amrex::Real Sz_stab = 0.5 * std::max({lx(i, j, k) * dy, lx(i, j + 1, k) * dy,
-                                                      ly(i, j, k) * dx, ly(i + 1, j, k) * dx});
-                amrex::Real Sz_ext = Sz_stab - Sz(i, j, k);
-                const int n_borrow =
-                    ComputeNBorrowOneFaceExtension(cell, Sz_ext, Sz_mod, flag_info_face_z,
-                                                   flag_ext_face_z, idim);
-
-
-                borrowing_z_size(i, j, k) = n_borrow;
-                return n_borrow;
-            },
-            [=] AMREX_GPU_DEVICE (int icell, int ps){
-                const amrex::Dim3 cell = box.atOffset(icell).dim3();
-                const int i = cell.x;
-                const int j = cell.y;
-                const int k = cell.z;
-                const int nborrow = borrowing_z_size(i, j, k);
-                if (nborrow == 0) {
-                    borrowing_z_inds_pointer(i, j, k) = nullptr;
-                } else{
-                    borrowing_z_inds_pointer(i, j, k) = borrowing_z_inds + ps;
-
-                    amrex::Real Sz_stab = 0.5 * std::max({lx(i, j, k) * dy, lx(i, j + 1, k) * dy,
-                                                          ly(i, j, k) * dx, ly(i + 1, j, k) * dx});
-                    amrex::Real Sz_ext = Sz_stab - Sz(i, j, k);
-                    for (int i_n = -1; i_n < 2; i_n++) {
-                        for (int j_n = -1; j_n < 2; j_n++) {
-                            //This if makes sure that we don't visit the "diagonal neighbours"
-                            if( !(i_n == j_n || i_n == -j_n)){
-                                // Here a face is available if it doesn't need to be extended itself and if its
-                                // area exceeds Sz_ext. Here we need to take into account if the intruded face
-                                // has given away already some area, so we use Sz_red rather than Sz.
-                                // If no face is available we don't do anything and we will need to use the
-                                // multi-face extensions.
-                                if (Sz_mod(i + i_n, j + j_n, k) > Sz_ext
-                                    && (flag_info_face_z(i + i_n, j + j_n, k) == 1
-                                         || flag_info_face_z(i + i_n, j + j_n, k) == 2)
-                                    && flag_ext_face_z(i, j, k)) {
-                                    Sz_mod(i + i_n, j + j_n, k) -= Sz_ext;
-                                    // Insert the index of the face info
-                                    borrowing_z_inds[ps] = ps;
-                                    // Store the information about the intruded face in the dataset of the
-                                    // faces which are borrowing area
-                                    FaceInfoBox::addConnectedNeighbor(i_n, j_n, ps,
-                                                                      borrowing_z_neigh_faces);
-                                    borrowing_z_area[ps] = Sz_ext;
-
-                                    flag_info_face_z(i + i_n, j + j_n, k) = 2;
-                                    // Add the area to the intruding face.
-                                    Sz_mod(i, j, k) = Sz(i, j, k) + Sz_ext;
-                                    flag_ext_face_z(i, j, k) = false;
-                                }
-                            }
-                        }
+                    const amrex::Real S_ext = ComputeExtensionArea(cell, idim, S, l1, l2, d1, d2);
+                    const int n_borrow = ComputeNBorrowOneFaceExtension(cell, S_ext, S_mod,
+                                                                        flag_info_face,
+                                                                        flag_ext_face, idim);
+                    borrowing_size(cell.x, cell.y, cell.z) = n_borrow;
+                    return n_borrow;
+                },
+                [=] AMREX_GPU_DEVICE (int icell, int ps) {
+                    const amrex::Dim3 cell = box.atOffset(icell).dim3();
+                    int n_borrow = borrowing_size(cell.x, cell.y, cell.z);
+                    if (n_borrow > 0) {
+                        const amrex::Real S_ext = ComputeExtensionArea(cell, idim, S, l1, l2, d1, d2);
+                        // This can fail if other faces intruded the same neighbors: the face
+                        // is then left to the eight-ways extension
+                        n_borrow = OneWayExtension(cell, idim, S_ext, S_mod, flag_info_face,
+                                                   flag_ext_face, ps, borrowing_inds,
+                                                   borrowing_neigh_faces, borrowing_area);
+                        borrowing_size(cell.x, cell.y, cell.z) = n_borrow;
                     }
-                }
-            },
-        amrex::Scan::Type::exclusive);
-
+                    borrowing_inds_pointer(cell.x, cell.y, cell.z) =
+                        (n_borrow > 0) ? borrowing_inds + ps : nullptr;
+                }, amrex::Scan::Type::exclusive);
+        }
     }
-
 #endif
 }
 
@@ -677,443 +668,83 @@ WarpX::ComputeOneWayExtensions() {
 void
 WarpX::ComputeEightWaysExtensions() {
 #ifdef AMREX_USE_EB
-
     auto const &cell_size = CellSize(maxLevel());
-    int idim = 0;
-    for (amrex::MFIter mfi(*Bfield_fp[maxLevel()][idim]); mfi.isValid(); ++mfi) {
-
-        amrex::Box const &box = mfi.validbox();
-
-        auto const &Sx = m_face_areas[maxLevel()][idim]->array(mfi);
-        auto const &flag_ext_face_x = m_flag_ext_face[maxLevel()][idim]->array(mfi);
-        auto const &flag_info_face_x = m_flag_info_face[maxLevel()][idim]->array(mfi);
-        auto &borrowing_x = (*m_borrowing[maxLevel()][idim])[mfi];
-        auto const &borrowing_x_inds_pointer = borrowing_x.inds_pointer.array();
-        auto const &borrowing_x_size = borrowing_x.size.array();
-        amrex::Long ncells = box.numPts();
-        int* borrowing_x_inds = borrowing_x.inds.data();
-        FaceInfoBox::Neighbours* borrowing_x_neigh_faces = borrowing_x.neigh_faces.data();
-        amrex::Real* borrowing_x_area = borrowing_x.area.data();
-        int& vecs_size_x = borrowing_x.vecs_size;
-
-        auto const &Sx_mod = m_area_mod[maxLevel()][idim]->array(mfi);
-        const auto &ly = m_edge_lengths[maxLevel()][1]->array(mfi);
-        const auto &lz = m_edge_lengths[maxLevel()][2]->array(mfi);
-        const amrex::Real dy = cell_size[1];
-        const amrex::Real dz = cell_size[2];
-
-        vecs_size_x += amrex::Scan::PrefixSum<int>(ncells,
-            [=] AMREX_GPU_DEVICE (int icell){
-                const amrex::Dim3 cell = box.atOffset(icell).dim3();
-                const int i = cell.x;
-                const int j = cell.y;
-                const int k = cell.z;
-                // If the face doesn't need to be extended break the loop
-                if (!flag_ext_face_x(i, j, k)) {
-                    return 0;
-                }
-                amrex::Real Sx_stab = 0.5 * std::max({ly(i, j, k) * dz, ly(i, j, k + 1) * dz,
-                                                      lz(i, j, k) * dy, lz(i, j + 1, k) * dy});
-                amrex::Real Sx_ext = Sx_stab - Sx(i, j, k);
-                const int n_borrow = ComputeNBorrowEightFacesExtension(cell, Sx_ext, Sx_mod, Sx,
-                                                                 flag_info_face_x, idim);
-
-                borrowing_x_size(i, j, k) = n_borrow;
-                return n_borrow;
-                },
-            [=] AMREX_GPU_DEVICE (int icell, int ps){
-                ps += vecs_size_x;
-
-                const amrex::Dim3 cell = box.atOffset(icell).dim3();
-                const int i = cell.x;
-                const int j = cell.y;
-                const int k = cell.z;
-
-                if (!flag_ext_face_x(i, j, k)) {
-                    return;
-                }
-
-                const int nborrow = borrowing_x_size(i, j, k);
-                if (nborrow == 0) {
-                    borrowing_x_inds_pointer(i, j, k) = nullptr;
-                } else{
-                    borrowing_x_inds_pointer(i, j, k) = borrowing_x_inds + ps;
-                    Sx_mod(i, j, k) = Sx(i, j, k);
-                    amrex::Real Sx_stab = 0.5 * std::max({ly(i, j, k) * dz, ly(i, j, k + 1) * dz,
-                                                  lz(i, j, k) * dy, lz(i, j + 1, k) * dy});
-                    amrex::Real Sx_ext = Sx_stab - Sx(i, j, k);
-                    amrex::Array2D<amrex::Real, 0, 2, 0, 2> local_avail{};
-                    for(int j_loc = 0; j_loc <= 2; j_loc++){
-                        for(int k_loc = 0; k_loc <= 2; k_loc++){
-                            local_avail(j_loc, k_loc) = (flag_info_face_x(i, j  + j_loc - 1, k + k_loc - 1) == 1
-                                                         || flag_info_face_x(i, j  + j_loc - 1, k + k_loc - 1) == 2);
-                        }
-                    }
-
-                    amrex::Real denom = local_avail(0, 1) * Sx(i, j - 1, k) +
-                                        local_avail(2, 1) * Sx(i, j + 1, k) +
-                                        local_avail(1, 0) * Sx(i, j, k - 1) +
-                                        local_avail(1, 2) * Sx(i, j, k + 1) +
-                                        local_avail(0, 0) * Sx(i, j - 1, k - 1) +
-                                        local_avail(2, 0) * Sx(i, j + 1, k - 1) +
-                                        local_avail(0, 2) * Sx(i, j - 1, k + 1) +
-                                        local_avail(2, 2) * Sx(i, j + 1, k + 1);
-
-                    bool neg_face = true;
-
-                    while(denom >= Sx_ext && neg_face && denom > 0){
-                        neg_face = false;
-                        for (int j_n = -1; j_n < 2; j_n++) {
-                            for (int k_n = -1; k_n < 2; k_n++) {
-                                if(local_avail(j_n + 1, k_n + 1)){
-                                    amrex::Real patch = Sx_ext * Sx(i, j + j_n, k+ k_n) / denom;
-                                    if(Sx_mod(i, j + j_n, k + k_n) - patch <= 0) {
-                                        neg_face = true;
-                                        local_avail(j_n + 1, k_n + 1) = false;
-                                    }
-                                }
-                            }
-                        }
-
-                        denom = local_avail(0, 1) * Sx(i, j - 1, k) +
-                                local_avail(2, 1) * Sx(i, j + 1, k) +
-                                local_avail(1, 0) * Sx(i, j, k - 1) +
-                                local_avail(1, 2) * Sx(i, j, k + 1) +
-                                local_avail(0, 0) * Sx(i, j - 1, k - 1) +
-                                local_avail(2, 0) * Sx(i, j + 1, k - 1) +
-                                local_avail(0, 2) * Sx(i, j - 1, k + 1) +
-                                local_avail(2, 2) * Sx(i, j + 1, k + 1);
-                    }
-
-                    if(denom >= Sx_ext){
-                        Sx_mod(i, j, k) = Sx(i, j, k);
-                        int count = 0;
-                        for (int j_n = -1; j_n < 2; j_n++) {
-                            for (int k_n = -1; k_n < 2; k_n++) {
-                                if(local_avail(j_n + 1, k_n + 1)){
-                                    amrex::Real patch = Sx_ext * Sx(i, j + j_n, k + k_n) / denom;
-                                    borrowing_x_inds[ps + count] = ps + count;
-                                    // Store the information about the intruded face in the dataset of the
-                                    // faces which are borrowing area
-                                    FaceInfoBox::addConnectedNeighbor(j_n, k_n, ps + count,
-                                                                      borrowing_x_neigh_faces);
-                                    borrowing_x_area[ps + count] = patch;
-
-                                    flag_info_face_x(i, j + j_n, k + k_n) = 2;
-                                    Sx_mod(i, j, k) += patch;
-                                    Sx_mod(i, j + j_n, k + k_n) -= patch;
-                                    count+=1;
-                                }
-                            }
-                        }
-                        flag_ext_face_x(i, j, k) = false;
-                    }
-                }
-            },
-            amrex::Scan::Type::exclusive);
-
-    }
-
-    idim = 1;
-    for (amrex::MFIter mfi(*Bfield_fp[maxLevel()][idim]); mfi.isValid(); ++mfi) {
-
-        // Do the extensions in the y-plane
-        amrex::Box const &box = mfi.validbox();
-
-        auto const &Sy = m_face_areas[maxLevel()][idim]->array(mfi);
-        auto const &flag_ext_face_y = m_flag_ext_face[maxLevel()][idim]->array(mfi);
-        auto const &flag_info_face_y = m_flag_info_face[maxLevel()][idim]->array(mfi);
-        auto &borrowing_y = (*m_borrowing[maxLevel()][idim])[mfi];
-        auto const &borrowing_y_inds_pointer = borrowing_y.inds_pointer.array();
-        auto const &borrowing_y_size = borrowing_y.size.array();
-        amrex::Long ncells = box.numPts();
-        int* borrowing_y_inds = borrowing_y.inds.data();
-        FaceInfoBox::Neighbours* borrowing_y_neigh_faces = borrowing_y.neigh_faces.data();
-        amrex::Real* borrowing_y_area = borrowing_y.area.data();
-        int& vecs_size_y = borrowing_y.vecs_size;
-
-        auto const &Sy_mod = m_area_mod[maxLevel()][idim]->array(mfi);
-        const auto &lx = m_edge_lengths[maxLevel()][0]->array(mfi);
-        const auto &lz = m_edge_lengths[maxLevel()][2]->array(mfi);
-        amrex::Real dx = cell_size[0];
-        amrex::Real dz = cell_size[2];
-
-        vecs_size_y += amrex::Scan::PrefixSum<int>(ncells,
-            [=] AMREX_GPU_DEVICE (int icell){
-                const amrex::Dim3 cell = box.atOffset(icell).dim3();
-                const int i = cell.x;
-                const int j = cell.y;
-                const int k = cell.z;
-                // If the face doesn't need to be extended break the loop
-                if (!flag_ext_face_y(i, j, k)){
-                    return 0;
-                }
-                amrex::Real Sy_stab = 0.5 * std::max({lx(i, j, k) * dz, lx(i, j, k + 1) * dz,
-                                                    lz(i, j, k) * dx, lz(i + 1, j, k) * dx});
-                amrex::Real Sy_ext = Sy_stab - Sy(i, j, k);
-                const int n_borrow = ComputeNBorrowEightFacesExtension(cell, Sy_ext, Sy_mod, Sy,
-                                                                 flag_info_face_y, idim);
-
-                borrowing_y_size(i, j, k) = n_borrow;
-                return n_borrow;
-            },
-            [=] AMREX_GPU_DEVICE (int icell, int ps) {
-
-                ps += vecs_size_y;
-
-                const amrex::Dim3 cell = box.atOffset(icell).dim3();
-                const int i = cell.x;
-                const int j = cell.y;
-                const int k = cell.z;
-
-                if (!flag_ext_face_y(i, j, k)) {
-                    return;
-                }
-
-                int nborrow = borrowing_y_size(i, j, k);
-                if (nborrow == 0) {
-                    borrowing_y_inds_pointer(i, j, k) = nullptr;
-                } else {
-                    borrowing_y_inds_pointer(i, j, k) = borrowing_y_inds + ps;
-
-                    Sy_mod(i, j, k) = Sy(i, j, k);
-                    amrex::Real Sy_stab = 0.5 * std::max({lx(i, j, k) * dz, lx(i, j, k + 1) * dz,
-                                                          lz(i, j, k) * dx, lz(i + 1, j, k) * dx});
-                    amrex::Real Sy_ext = Sy_stab - Sy(i, j, k);
-                    amrex::Array2D<amrex::Real, 0, 2, 0, 2> local_avail{};
-                    for (int i_loc = 0; i_loc <= 2; i_loc++) {
-                        for (int k_loc = 0; k_loc <= 2; k_loc++) {
-                            local_avail(i_loc, k_loc) = (flag_info_face_y(i + i_loc - 1, j, k + k_loc - 1) == 1
-                                                         || flag_info_face_y(i + i_loc - 1, j, k + k_loc - 1) == 2)   ;
-                        }
-                    }
-
-                    amrex::Real denom = local_avail(0, 1) * Sy(i - 1, j, k) +
-                        local_avail(2, 1) * Sy(i + 1, j, k) +
-                        local_avail(1, 0) * Sy(i, j, k - 1) +
-                        local_avail(1, 2) * Sy(i, j, k + 1) +
-                        local_avail(0, 0) * Sy(i - 1, j, k - 1) +
-                        local_avail(2, 0) * Sy(i + 1, j, k - 1) +
-                        local_avail(0, 2) * Sy(i - 1, j, k + 1) +
-                        local_avail(2, 2) * Sy(i + 1, j, k + 1);
-
-                    bool neg_face = true;
-
-                    while (denom >= Sy_ext && neg_face && denom > 0) {
-                        neg_face = false;
-                        for (int i_n = -1; i_n < 2; i_n++) {
-                            for (int k_n = -1; k_n < 2; k_n++) {
-                                if (local_avail(i_n + 1, k_n + 1)) {
-                                    amrex::Real patch = Sy_ext * Sy(i + i_n, j, k + k_n) / denom;
-                                    if (Sy_mod(i + i_n, j, k + k_n) - patch <= 0) {
-                                        neg_face = true;
-                                        local_avail(i_n + 1, k_n + 1) = false;
-                                    }
-                                }
-                            }
-                        }
-
-                        denom = local_avail(0, 1) * Sy(i - 1, j, k) +
-                            local_avail(2, 1) * Sy(i + 1, j, k) +
-                            local_avail(1, 0) * Sy(i, j, k - 1) +
-                            local_avail(1, 2) * Sy(i, j, k + 1) +
-                            local_avail(0, 0) * Sy(i - 1, j, k - 1) +
-                            local_avail(2, 0) * Sy(i + 1, j, k - 1) +
-                            local_avail(0, 2) * Sy(i - 1, j, k + 1) +
-                            local_avail(2, 2) * Sy(i + 1, j, k + 1);
-                    }
 
-                    if (denom >= Sy_ext) {
-                        Sy_mod(i, j, k) = Sy(i, j, k);
-                        int count = 0;
-                        for (int i_n = -1; i_n < 2; i_n++) {
-                            for (int k_n = -1; k_n < 2; k_n++) {
-                                if (local_avail(i_n + 1, k_n + 1)) {
-                                    amrex::Real patch = Sy_ext * Sy(i + i_n, j, k + k_n) / denom;
-                                    borrowing_y_inds[ps + count] = ps + count;
-                                    FaceInfoBox::addConnectedNeighbor(i_n, k_n, ps + count,
-                                                                      borrowing_y_neigh_faces);
-                                    borrowing_y_area[ps + count] = patch;
-
-                                    flag_info_face_y(i + i_n, j, k + k_n) = 2;
-                                    Sy_mod(i, j, k) += patch;
-                                    Sy_mod(i + i_n, j, k + k_n) -= patch;
-                                    count += 1;
-                                }
-                            }
-                        }
-                        flag_ext_face_y(i, j, k) = false;
-                    }
-                }
-            },
-            amrex::Scan::Type::exclusive);
+    // Do the extensions in the x-, y- and z-planes
+    for (int idim = 0; idim < 3; ++idim) {
+        // Directions in the plane of the faces
+        const int idim1 = (idim == 0) ? 1 : 0;
+        const int idim2 = (idim == 2) ? 1 : 2;
 
-    }
+        for (amrex::MFIter mfi(*Bfield_fp[maxLevel()][idim]); mfi.isValid(); ++mfi) {
 
-    // Do the extensions in the z-plane
-    idim = 2;
-    for (amrex::MFIter mfi(*Bfield_fp[maxLevel()][idim]); mfi.isValid(); ++mfi) {
-
-        amrex::Box const &box = mfi.validbox();
-
-        auto const &Sz = m_face_areas[maxLevel()][idim]->array(mfi);
-        auto const &flag_ext_face_z = m_flag_ext_face[maxLevel()][idim]->array(mfi);
-        auto const &flag_info_face_z = m_flag_info_face[maxLevel()][idim]->array(mfi);
-        auto &borrowing_z = (*m_borrowing[maxLevel()][idim])[mfi];
-        auto const &borrowing_z_inds_pointer = borrowing_z.inds_pointer.array();
-        auto const &borrowing_z_size = borrowing_z.size.array();
-        amrex::Long ncells = box.numPts();
-        int* borrowing_z_inds = borrowing_z.inds.data();
-        FaceInfoBox::Neighbours* borrowing_z_neigh_faces = borrowing_z.neigh_faces.data();
-        amrex::Real* borrowing_z_area = borrowing_z.area.data();
-        int& vecs_size_z = borrowing_z.vecs_size;
-
-        auto const &Sz_mod = m_area_mod[maxLevel()][idim]->array(mfi);
-        const auto &lx = m_edge_lengths[maxLevel()][0]->array(mfi);
-        const auto &ly = m_edge_lengths[maxLevel()][1]->array(mfi);
-        const amrex::Real dx = cell_size[0];
-        const amrex::Real dy = cell_size[1];
-
-        vecs_size_z += amrex::Scan::PrefixSum<int>(ncells,
-            [=] AMREX_GPU_DEVICE (int icell){
-                const amrex::Dim3 cell = box.atOffset(icell).dim3();
-                const int i = cell.x;
-                const int j = cell.y;
-                const int k = cell.z;
-                // If the face doesn't need to be extended break the loop
-                if (!flag_ext_face_z(i, j, k)) {
-                    return 0;
-                }
-                amrex::Real Sz_stab = 0.5 * std::max({lx(i, j, k) * dy, lx(i, j + 1, k) * dy,
-                                                    ly(i, j, k) * dx, ly(i + 1, j, k) * dx});
-                amrex::Real Sz_ext = Sz_stab - Sz(i, j, k);
-                const int n_borrow = ComputeNBorrowEightFacesExtension(cell, Sz_ext, Sz_mod, Sz,
-                                                                 flag_info_face_z, idim);
-
-                borrowing_z_size(i, j, k) = n_borrow;
-                return n_borrow;
-            },
-            [=] AMREX_GPU_DEVICE (int icell, int ps) {
-
-                ps += vecs_size_z;
-
-                const amrex::Dim3 cell = box.atOffset(icell).dim3();
-                const int i = cell.x;
-                const int j = cell.y;
-                const int k = cell.z;
-
-                if (!flag_ext_face_z(i, j, k)) {
-                    return;
-                }
+            amrex::Box const &box = mfi.validbox();
 
-                const int nborrow = borrowing_z_size(i, j, k);
-                if (nborrow == 0) {
-                    borrowing_z_inds_pointer(i, j, k) = nullptr;
-                } else {
-                    borrowing_z_inds_pointer(i, j, k) = borrowing_z_inds + ps;
-
-                    Sz_mod(i, j, k) = Sz(i, j, k);
-                    amrex::Real Sz_stab = 0.5 * std::max({lx(i, j, k) * dy, lx(i, j + 1, k) * dy,
-                                                          ly(i, j, k) * dx, ly(i + 1, j, k) * dx});
-                    amrex::Real Sz_ext = Sz_stab - Sz(i, j, k);
-                    amrex::Array2D<amrex::Real, 0, 2, 0, 2> local_avail{};
-                    for(int i_loc = 0; i_loc <= 2; i_loc++){
-                        for(int j_loc = 0; j_loc <= 2; j_loc++){
-                            local_avail(i_loc, j_loc) = (flag_info_face_z(i + i_loc - 1, j + j_loc - 1, k) == 1
-                                                         || flag_info_face_z(i + i_loc - 1, j + j_loc - 1, k) == 2);
-                        }
+            auto const &S = m_face_areas[maxLevel()][idim]->array(mfi);
+            auto const &S_mod = m_area_mod[maxLevel()][idim]->array(mfi);
+            auto const &flag_ext_face = m_flag_ext_face[maxLevel()][idim]->array(mfi);
+            auto const &flag_info_face = m_flag_info_face[maxLevel()][idim]->array(mfi);
+            auto &borrowing = (*m_borrowing[maxLevel()][idim])[mfi];
+            auto const &borrowing_inds_pointer = borrowing.inds_pointer.array();
+            auto const &borrowing_size = borrowing.size.array();
+            amrex::Long ncells = box.numPts();
+            int* borrowing_inds = borrowing.inds.data();
+            FaceInfoBox::Neighbours* borrowing_neigh_faces = borrowing.neigh_faces.data();
+            amrex::Real* borrowing_area = borrowing.area.data();
+            // The entries of the one-way extensions come first
+            const int offset = borrowing.vecs_size;
+
+            const auto &l1 = m_edge_lengths[maxLevel()][idim1]->array(mfi);
+            const auto &l2 = m_edge_lengths[maxLevel()][idim2]->array(mfi);
+            const amrex::Real d1 = cell_size[idim1];
+            const amrex::Real d2 = cell_size[idim2];
+
+            borrowing.vecs_size += amrex::Scan::PrefixSum<int>(ncells,
+                [=] AMREX_GPU_DEVICE (int icell) {
+                    const amrex::Dim3 cell = box.atOffset(icell).dim3();
+                    // If the face doesn't need to be extended break the loop
+                    if (!flag_ext_face(cell.x, cell.y, cell.z)) {
+                        return 0;
                     }
-
-                    amrex::Real denom = local_avail(0, 1) * Sz(i - 1, j, k) +
-                                        local_avail(2, 1) * Sz(i + 1, j, k) +
-                                        local_avail(1, 0) * Sz(i, j - 1, k) +
-                                        local_avail(1, 2) * Sz(i, j + 1, k) +
-                                        local_avail(0, 0) * Sz(i - 1, j - 1, k) +
-                                        local_avail(2, 0) * Sz(i + 1, j - 1, k) +
-                                        local_avail(0, 2) * Sz(i - 1, j + 1, k) +
-                                        local_avail(2, 2) * Sz(i + 1, j + 1, k);
-
-                    bool neg_face = true;
-
-                    while(denom >= Sz_ext && neg_face && denom > 0){
-                        neg_face = false;
-                        for (int i_n = -1; i_n < 2; i_n++) {
-                            for (int j_n = -1; j_n < 2; j_n++) {
-                                if(local_avail(i_n + 1, j_n + 1)){
-                                    amrex::Real patch = Sz_ext * Sz(i + i_n, j + j_n, k) / denom;
-                                    if(Sz_mod(i + i_n, j + j_n, k) - patch <= 0) {
-                                        neg_face = true;
-                                        local_avail(i_n + 1, j_n + 1) = false;
-                                    }
-                                }
-                            }
-                        }
-
-                        denom = local_avail(0, 1) * Sz(i - 1, j, k) +
-                                local_avail(2, 1) * Sz(i + 1, j, k) +
-                                local_avail(1, 0) * Sz(i, j - 1, k) +
-                                local_avail(1, 2) * Sz(i, j + 1, k) +
-                                local_avail(0, 0) * Sz(i - 1, j - 1, k) +
-                                local_avail(2, 0) * Sz(i + 1, j - 1, k) +
-                                local_avail(0, 2) * Sz(i - 1, j + 1, k) +
-                                local_avail(2, 2) * Sz(i + 1, j + 1, k);
+                    const amrex::Real S_ext = ComputeExtensionArea(cell, idim, S, l1, l2, d1, d2);
+                    const int n_borrow = ComputeNBorrowEightFacesExtension(cell, S_ext, S_mod, S,
+                                                                           flag_info_face, idim);
+                    borrowing_size(cell.x, cell.y, cell.z) = n_borrow;
+                    return n_borrow;
+                },
+                [=] AMREX_GPU_DEVICE (int icell, int ps) {
+                    ps += offset;
+                    const amrex::Dim3 cell = box.atOffset(icell).dim3();
+                    if (!flag_ext_face(cell.x, cell.y, cell.z)) {
+                        return;
                     }
-
-                    if(denom >= Sz_ext){
-                        Sz_mod(i, j, k) = Sz(i, j, k);
-                        int count = 0;
-                        for (int i_n = -1; i_n < 2; i_n++) {
-                            for (int j_n = -1; j_n < 2; j_n++) {
-                                if(local_avail(i_n + 1, j_n + 1)){
-                                    amrex::Real patch = Sz_ext * Sz(i + i_n, j + j_n, k) / denom;
-                                    borrowing_z_inds[ps + count] = ps + count;
-                                    FaceInfoBox::addConnectedNeighbor(i_n, j_n, ps + count,
-                                                                      borrowing_z_neigh_faces);
-                                    borrowing_z_area[ps + count] = patch;
-
-                                    flag_info_face_z(i + i_n, j + j_n, k) = 2;
-
-                                    Sz_mod(i, j, k) += patch;
-                                    Sz_mod(i + i_n, j + j_n, k) -= patch;
-                                    count +=1;
-                                }
-                            }
-                        }
-                        flag_ext_face_z(i, j, k) = false;
+                    int n_borrow = borrowing_size(cell.x, cell.y, cell.z);
+                    if (n_borrow > 0) {
+                        const amrex::Real S_ext = ComputeExtensionArea(cell, idim, S, l1, l2, d1, d2);
+                        // The number of intruded faces can only decrease with respect to the
+                        // first pass, if other faces intruded the same neighbors
+                        n_borrow = EightWaysExtension(cell, idim, S_ext, S, S_mod, flag_info_face,
+                                                      flag_ext_face, ps, borrowing_inds,
+                                                      borrowing_neigh_faces, borrowing_area);
+                        borrowing_size(cell.x, cell.y, cell.z) = n_borrow;
                     }
-                }
-            },
-            amrex::Scan::Type::exclusive);
-
+                    borrowing_inds_pointer(cell.x, cell.y, cell.z) =
+                        (n_borrow > 0) ? borrowing_inds + ps : nullptr;
+                }, amrex::Scan::Type::exclusive);
+        }
     }
-
 #endif
 }
 
 
 void
 WarpX::ShrinkBorrowing() {
-    int idim = 0;
-    for (amrex::MFIter mfi(*Bfield_fp[maxLevel()][idim]); mfi.isValid(); ++mfi) {
-        auto &borrowing_x = (*m_borrowing[maxLevel()][idim])[mfi];
-        borrowing_x.inds.resize(borrowing_x.vecs_size);
-        borrowing_x.neigh_faces.resize(borrowing_x.vecs_size);
-        borrowing_x.area.resize(borrowing_x.vecs_size);
-    }
-
-    idim = 1;
-    for (amrex::MFIter mfi(*Bfield_fp[maxLevel()][idim]); mfi.isValid(); ++mfi) {
-        auto &borrowing_y = (*m_borrowing[maxLevel()][idim])[mfi];
-        borrowing_y.inds.resize(borrowing_y.vecs_size);
-        borrowing_y.neigh_faces.resize(borrowing_y.vecs_size);
-        borrowing_y.area.resize(borrowing_y.vecs_size);
-    }
-
-    idim = 2;
-    for (amrex::MFIter mfi(*Bfield_fp[maxLevel()][idim]); mfi.isValid(); ++mfi) {
-        auto &borrowing_z = (*m_borrowing[maxLevel()][idim])[mfi];
-        borrowing_z.inds.resize(borrowing_z.vecs_size);
-        borrowing_z.neigh_faces.resize(borrowing_z.vecs_size);
-        borrowing_z.area.resize(borrowing_z.vecs_size);
+    for (int idim = 0; idim < 3; ++idim) {
+        for (amrex::MFIter mfi(*Bfield_fp[maxLevel()][idim]); mfi.isValid(); ++mfi) {
+            auto &borrowing = (*m_borrowing[maxLevel()][idim])[mfi];
+            borrowing.inds.resize(borrowing.vecs_size);
+            borrowing.neigh_faces.resize(borrowing.vecs_size);
+            borrowing.area.resize(borrowing.vecs_size);
+        }
     }
 }
@@ -26,18 +26,30 @@
 #  include <AMReX_GpuDevice.H>
 #  include <AMReX_GpuQualifiers.H>
 #  include <AMReX_IntVect.H>
+#  include <AMReX_LayoutData.H>
 #  include <AMReX_Loop.H>
 #  include <AMReX_MFIter.H>
 #  include <AMReX_MultiFab.H>
 #  include <AMReX_iMultiFab.H>
+#  include <AMReX_ParallelDescriptor.H>
 #  include <AMReX_ParmParse.H>
 #  include <AMReX_Parser.H>
 #  include <AMReX_REAL.H>
 #  include <AMReX_SPACE.H>
+#  include <AMReX_Scan.H>
+#  include <AMReX_Utility.H>
 #  include <AMReX_Vector.H>
+#  include <AMReX_VisMF.H>
 
+#  include <algorithm>
+#  include <cstdio>
 #  include <cstdlib>
+#  include <fstream>
+#  include <iomanip>
+#  include <memory>
+#  include <sstream>
 #  include <string>
+#  include <vector>
 
 #endif
 
@@ -73,6 +85,60 @@ namespace {
     private:
         amrex::ParserExecutor<3> m_parser; //! function parser with three arguments (x,y,z)
     };
+
+    /**
+    * \brief Classify the tiles of one field component (see EBTileClasses), based on its
+    *        edge lengths or face areas (an edge or face is covered if its length or area is 0)
+    *
+    * \param[in] mf_tiles MultiFab over which the field solver iterates (defines the tiles)
+    * \param[in] geom_data edge lengths or face areas of this field component
+    * \param[out] classes classification of the tiles
+    */
+    void ClassifyTiles (amrex::MultiFab const& mf_tiles, amrex::MultiFab const& geom_data,
+                        EBTileClasses& classes)
+    {
+        classes.ba = mf_tiles.boxArray();
+        classes.dm = mf_tiles.DistributionMap();
+
+        int ntiles = 0;
+        for (amrex::MFIter mfi(mf_tiles, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            ntiles = std::max(ntiles, mfi.LocalTileIndex()+1);
+        }
+        classes.tile_class.assign(ntiles, EBTileClasses::regular);
+        classes.cut_cells.clear();
+        classes.cut_cells.resize(ntiles);
+
+        for (amrex::MFIter mfi(mf_tiles, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            const amrex::Box tbx = mfi.tilebox(geom_data.ixType().toIntVect());
+            auto const &data = geom_data.const_array(mfi);
+            const int npts = static_cast<int>(tbx.numPts());
+            const int itile = mfi.LocalTileIndex();
+
+            amrex::Gpu::DeviceVector<int> is_open(npts);
+            amrex::Gpu::DeviceVector<int> open_index(npts);
+            int* const p_is_open = is_open.dataPtr();
+            int* const p_open_index = open_index.dataPtr();
+            amrex::ParallelFor(npts, [=] AMREX_GPU_DEVICE (int n) {
+                p_is_open[n] = (data(tbx.atOffset(n)) > 0);
+            });
+            const int nopen = amrex::Scan::ExclusiveSum(npts, p_is_open, p_open_index,
+                                                        amrex::Scan::retSum);
+
+            if (nopen == npts) {
+                classes.tile_class[itile] = EBTileClasses::regular;
+            } else if (nopen == 0) {
+                classes.tile_class[itile] = EBTileClasses::covered;
+            } else {
+                classes.tile_class[itile] = EBTileClasses::cut;
+                classes.cut_cells[itile].resize(nopen);
+                int* const p_cells = classes.cut_cells[itile].dataPtr();
+                amrex::ParallelFor(npts, [=] AMREX_GPU_DEVICE (int n) {
+                    if (p_is_open[n]) p_cells[p_open_index[n]] = n;
+                });
+            }
+            amrex::Gpu::streamSynchronize();
+        }
+    }
 }
 #endif
 
@@ -326,6 +392,22 @@ WarpX::MarkCells(){
 }
 
 
+void
+WarpX::ComputeEBTileClasses () {
+#ifdef AMREX_USE_EB
+    BL_PROFILE("ComputeEBTileClasses");
+
+    const int lev = maxLevel();
+    for (int idim = 0; idim < 3; ++idim) {
+        ClassifyTiles(*m_edge_lengths[lev][0], *m_edge_lengths[lev][idim],
+                      m_edge_tile_classes[lev][idim]);
+        ClassifyTiles(*m_face_areas[lev][0], *m_face_areas[lev][idim],
+                      m_face_tile_classes[lev][idim]);
+    }
+#endif
+}
+
+
 void
 WarpX::ComputeDistanceToEB () {
 #ifdef AMREX_USE_EB
@@ -343,5 +425,145 @@ WarpX::ComputeDistanceToEB () {
     } else {
         m_distance_to_eb[maxLevel()]->setVal(100.0); // some positive value
     }
+    ComputeDistanceToEBMinimum();
+#endif
+}
+
+
+void
+WarpX::ComputeDistanceToEBMinimum () {
+#ifdef AMREX_USE_EB
+    BL_PROFILE("ComputeDistanceToEBMinimum");
+
+    const int lev = maxLevel();
+    const amrex::MultiFab& distance_to_eb = *m_distance_to_eb[lev];
+    m_distance_to_eb_min[lev] = std::make_unique<amrex::LayoutData<amrex::Real> >(
+        distance_to_eb.boxArray(), distance_to_eb.DistributionMap());
+    for (amrex::MFIter mfi(distance_to_eb); mfi.isValid(); ++mfi) {
+        (*m_distance_to_eb_min[lev])[mfi] =
+            distance_to_eb[mfi].min<amrex::RunOn::Device>(mfi.fabbox(), 0);
+    }
 #endif
 }
+
+
+std::string
+WarpX::EBCacheKey () const {
+    std::ostringstream key;
+#ifdef AMREX_USE_EB
+    const int lev = maxLevel();
+    key << std::setprecision(17);
+    key << "dim " << AMREX_SPACEDIM << "\n";
+    key << "maxwell_solver_id " << WarpX::maxwell_solver_id << "\n";
+    key << "ng_alloc_EB " << guard_cells.ng_alloc_EB << "\n";
+
+    // Parameters of the geometry
+    amrex::ParmParse pp_warpx("warpx");
+    std::string impf;
+    pp_warpx.query("eb_implicit_function", impf);
+    key << "eb_implicit_function " << impf << "\n";
+    amrex::ParmParse pp;
+    for (const auto& name : amrex::ParmParse::getEntries("eb2")) {
+        std::vector<std::string> values;
+        pp.queryarr(name.c_str(), values);
+        key << name;
+        for (const auto& v : values) key << " " << v;
+        key << "\n";
+    }
+
+    // Parameters of the grids
+    const amrex::Geometry& geom = Geom(lev);
+    key << "domain " << geom.Domain() << "\n";
+    key << "prob_lo";
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) key << " " << geom.ProbLo(idim);
+    key << "\nprob_hi";
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) key << " " << geom.ProbHi(idim);
+    key << "\nboxarray " << boxArray(lev).size() << "\n";
+    for (int i = 0; i < boxArray(lev).size(); ++i) key << boxArray(lev)[i] << "\n";
+#endif
+    return key.str();
+}
+
+
+bool
+WarpX::ReadEBCache () {
+#ifdef AMREX_USE_EB
+    amrex::ParmParse pp_warpx("warpx");
+    std::string cache_dir;
+    pp_warpx.query("eb_cache_file", cache_dir);
+    if (cache_dir.empty()) return false;
+
+    BL_PROFILE("ReadEBCache");
+
+    const std::string header = cache_dir + "/Header";
+    if (!amrex::FileExists(header)) return false;
+    amrex::Vector<char> file_char;
+    amrex::ParallelDescriptor::ReadAndBcastFile(header, file_char);
+    const std::string cached_key(file_char.dataPtr());
+    if (cached_key != EBCacheKey()) {
+        amrex::Print() << "EB cache " << cache_dir
+                       << " does not match the geometry and grids: recomputing it\n";
+        return false;
+    }
+
+    const int lev = maxLevel();
+    amrex::VisMF::Read(*m_edge_lengths[lev][0], cache_dir + "/edge_lengths_x");
+    amrex::VisMF::Read(*m_edge_lengths[lev][1], cache_dir + "/edge_lengths_y");
+    amrex::VisMF::Read(*m_edge_lengths[lev][2], cache_dir + "/edge_lengths_z");
+    amrex::VisMF::Read(*m_face_areas[lev][0], cache_dir + "/face_areas_x");
+    amrex::VisMF::Read(*m_face_areas[lev][1], cache_dir + "/face_areas_y");
+    amrex::VisMF::Read(*m_face_areas[lev][2], cache_dir + "/face_areas_z");
+    amrex::VisMF::Read(*m_distance_to_eb[lev], cache_dir + "/distance_to_eb");
+    ComputeDistanceToEBMinimum();
+
+    amrex::Print() << "Read the EB data from the cache " << cache_dir << "\n";
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+void
+WarpX::WriteEBCache () {
+#ifdef AMREX_USE_EB
+    amrex::ParmParse pp_warpx("warpx");
+    std::string cache_dir;
+    pp_warpx.query("eb_cache_file", cache_dir);
+    if (cache_dir.empty()) return;
+
+    BL_PROFILE("WriteEBCache");
+
+    // The key is removed first and written last, so that an interrupted write
+    // leaves no valid cache
+    const std::string header_name = cache_dir + "/Header";
+    if (amrex::ParallelDescriptor::IOProcessor()) {
+        if (!amrex::UtilCreateDirectory(cache_dir, 0755)) {
+            amrex::CreateDirectoryFailed(cache_dir);
+        }
+        std::remove(header_name.c_str());
+    }
+    amrex::ParallelDescriptor::Barrier();
+
+    const int lev = maxLevel();
+    amrex::VisMF::Write(*m_edge_lengths[lev][0], cache_dir + "/edge_lengths_x");
+    amrex::VisMF::Write(*m_edge_lengths[lev][1], cache_dir + "/edge_lengths_y");
+    amrex::VisMF::Write(*m_edge_lengths[lev][2], cache_dir + "/edge_lengths_z");
+    amrex::VisMF::Write(*m_face_areas[lev][0], cache_dir + "/face_areas_x");
+    amrex::VisMF::Write(*m_face_areas[lev][1], cache_dir + "/face_areas_y");
+    amrex::VisMF::Write(*m_face_areas[lev][2], cache_dir + "/face_areas_z");
+    amrex::VisMF::Write(*m_distance_to_eb[lev], cache_dir + "/distance_to_eb");
+
+    const std::string key = EBCacheKey();
+    if (amrex::ParallelDescriptor::IOProcessor()) {
+        std::ofstream header(header_name, std::ofstream::trunc);
+        header << key;
+        header.close();
+        if (!header.good()) {
+            amrex::FileOpenFailed(header_name);
+        }
+    }
+    amrex::ParallelDescriptor::Barrier();
+#endif
+}
+
@@ -13,17 +13,21 @@
 #else
 #   include "FieldSolver/FiniteDifferenceSolver/FiniteDifferenceAlgorithms/CylindricalYeeAlgorithm.H"
 #endif
+#include "Particles/MultiParticleContainer.H"
+#include "Particles/WarpXParticleContainer.H"
 #include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXConst.H"
 
 #include <AMReX.H>
 #include <AMReX_Geometry.H>
 #include <AMReX_IntVect.H>
+#include <AMReX_ParallelDescriptor.H>
 #include <AMReX_Print.H>
 #include <AMReX_REAL.H>
 #include <AMReX_Vector.H>
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 
 /**
@@ -78,6 +82,55 @@ WarpX::ComputeDt ()
     }
 }
 
+void
+WarpX::UpdateAdaptiveDt (int step)
+{
+    if (!adaptive_dt || step % adaptive_dt_interval != 0) return;
+
+    // Largest |u| and |rho| of each species, reduced together
+    const int nspecies = mypc->nSpecies();
+    amrex::Vector<amrex::Real> maxima(2*nspecies, 0._rt);
+    for (int ispecies = 0; ispecies < nspecies; ++ispecies) {
+        maxima[ispecies] = mypc->GetParticleContainer(ispecies).maxParticleVelocity(true);
+        if (ispecies < static_cast<int>(m_species_max_rho.size())) {
+            maxima[nspecies+ispecies] = m_species_max_rho[ispecies];
+        }
+    }
+    amrex::ParallelDescriptor::ReduceRealMax(maxima.data(), static_cast<int>(maxima.size()));
+
+    const amrex::Real* dx = geom[max_level].CellSize();
+    amrex::Real dx_min = dx[0];
+    for (int idim = 1; idim < AMREX_SPACEDIM; ++idim) dx_min = std::min(dx_min, dx[idim]);
+
+    // Largest velocity, and sum of the squared plasma frequencies n q^2/(ep0 m) = |rho| |q/m|/ep0
+    amrex::Real v_max = 0._rt;
+    amrex::Real omega_p2 = 0._rt;
+    for (int ispecies = 0; ispecies < nspecies; ++ispecies) {
+        const amrex::Real u = maxima[ispecies];
+        v_max = std::max(v_max, u/std::sqrt(1._rt + u*u/(PhysConst::c*PhysConst::c)));
+        const WarpXParticleContainer& species = mypc->GetParticleContainer(ispecies);
+        if (species.getMass() > 0._rt) {
+            omega_p2 += maxima[nspecies+ispecies]*std::abs(species.getCharge()/species.getMass())
+                / PhysConst::ep0;
+        }
+    }
+
+    amrex::Real new_dt = adaptive_dt_max;
+    if (v_max > 0._rt) new_dt = std::min(new_dt, adaptive_dt_cfl*dx_min/v_max);
+    if (omega_p2 > 0._rt) new_dt = std::min(new_dt, adaptive_dt_omega_p/std::sqrt(omega_p2));
+    // Without particles, the time step is kept
+    if (v_max == 0._rt && omega_p2 == 0._rt) return;
+    // Decrease immediately, increase gradually
+    new_dt = std::min(new_dt, dt[0]*adaptive_dt_max_growth);
+    new_dt = std::max(new_dt, adaptive_dt_min);
+
+    if (new_dt != dt[0] && verbose) {
+        amrex::Print() << "Adaptive dt: " << dt[0] << " -> " << new_dt
+                       << " (v_max = " << v_max << ", omega_p = " << std::sqrt(omega_p2) << ")\n";
+    }
+    for (int lev = 0; lev <= max_level; ++lev) dt[lev] = new_dt;
+}
+
 void
 WarpX::PrintDtDxDyDz ()
 {
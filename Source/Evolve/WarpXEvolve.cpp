@@ -11,6 +11,7 @@
 #include "WarpX.H"
 
 #include "Diagnostics/BackTransformedDiagnostic.H"
+#include "Diagnostics/ComputeDiagFunctors/RhoFunctor.H"
 #include "Diagnostics/MultiDiagnostics.H"
 #include "Diagnostics/ReducedDiags/MultiReducedDiags.H"
 #include "Evolve/WarpXDtType.H"
@@ -24,10 +25,13 @@
 #include "Parallelization/GuardCellManager.H"
 #include "Particles/MultiParticleContainer.H"
 #include "Particles/ParticleBoundaryBuffer.H"
+#include "Particles/ParticleOffload.H"
 #include "Python/WarpX_py.H"
 #include "Utils/IntervalsParser.H"
 #include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXConst.H"
+#include "Utils/WarpXGpuRegions.H"
+#include "Utils/WarpXPhaseTimers.H"
 #include "Utils/WarpXProfilerWrapper.H"
 #include "Utils/WarpXUtil.H"
 
@@ -35,9 +39,11 @@
 #include <AMReX_Array.H>
 #include <AMReX_BLassert.H>
 #include <AMReX_Geometry.H>
+#include <AMReX_GpuDevice.H>
 #include <AMReX_IntVect.H>
 #include <AMReX_LayoutData.H>
 #include <AMReX_MultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_Print.H>
 #include <AMReX_REAL.H>
@@ -46,6 +52,8 @@
 
 #include <algorithm>
 #include <array>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <ostream>
 #include <vector>
@@ -70,6 +78,10 @@ WarpX::Evolve (int numsteps)
 
     static Real evolve_time = 0;
 
+    if (autotune_tile_size && m_autotune_tile_sizes.empty()) {
+        InitTileSizeAutotune();
+    }
+
     const int step_begin = istep[0];
     for (int step = istep[0]; step < numsteps_max && cur_time < stop_time; ++step)
     {
@@ -86,7 +98,15 @@ WarpX::Evolve (int numsteps)
 
         amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(0);
         if (cost) {
-            if (step > 0 && load_balance_intervals.contains(step+1))
+            if (m_costs_heuristic_calibrating) {
+                if (m_costs_calibration_nsteps == costs_heuristic_calibration_steps) {
+                    CalibrateCostsHeuristic();
+                } else {
+                    ++m_costs_calibration_nsteps;
+                }
+            }
+            // No load balance during the calibration of the heuristic costs
+            if (step > 0 && load_balance_intervals.contains(step+1) && !m_costs_heuristic_calibrating)
             {
                 LoadBalance();
 
@@ -96,7 +116,8 @@ WarpX::Evolve (int numsteps)
             for (int lev = 0; lev <= finest_level; ++lev)
             {
                 cost = WarpX::getCosts(lev);
-                if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+                if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers
+                    && !m_costs_heuristic_calibrating)
                 {
                     // Perform running average of the costs
                     // (Giving more importance to most recent costs; only needed
@@ -106,18 +127,25 @@ WarpX::Evolve (int numsteps)
                     {
                         (*cost)[i] *= (1. - 2./load_balance_intervals.localPeriod(step+1));
                     }
+                    for (auto& cb : m_costs_breakdown[lev]) {
+                        for (int i : cb->IndexArray()) {
+                            (*cb)[i] *= (1. - 2./load_balance_intervals.localPeriod(step+1));
+                        }
+                    }
                 }
             }
         }
 
+        // Time step of this step, from the particles and charge density of the last solve
+        UpdateAdaptiveDt(step);
+
         // At the beginning, we have B^{n} and E^{n}.
         // Particles have p^{n} and x^{n}.
         // is_synchronized is true.
         if (is_synchronized) {
             if (do_electrostatic == ElectrostaticSolverAlgo::None) {
                 // Not called at each iteration, so exchange all guard cells
-                FillBoundaryE(guard_cells.ng_alloc_EB);
-                FillBoundaryB(guard_cells.ng_alloc_EB);
+                FillBoundaryEB(guard_cells.ng_alloc_EB);
                 UpdateAuxilaryData();
                 FillBoundaryAux(guard_cells.ng_UpdateAux);
             }
@@ -135,26 +163,30 @@ WarpX::Evolve (int numsteps)
                 // Particles have p^{n-1/2} and x^{n}.
 
                 // E and B are up-to-date inside the domain only
-                FillBoundaryE(guard_cells.ng_FieldGather);
-                FillBoundaryB(guard_cells.ng_FieldGather);
                 // E and B: enough guard cells to update Aux or call Field Gather in fp and cp
                 // Need to update Aux on lower levels, to interpolate to higher levels.
-                if (fft_do_time_averaging)
-                {
-                    FillBoundaryE_avg(guard_cells.ng_FieldGather);
-                    FillBoundaryB_avg(guard_cells.ng_FieldGather);
-                }
-                // TODO Remove call to FillBoundaryAux before UpdateAuxilaryData?
-                if (WarpX::maxwell_solver_id != MaxwellSolverAlgo::PSATD)
+                if (OverlapFillBoundaryPush()) {
+                    // Only start the exchange here: it is completed in PushParticlesandDepose,
+                    // after the push of the particles that do not need the guard cells.
+                    // (Aux is the same as the fine patch, and needs no update.)
+                    FillBoundaryEB_nowait(guard_cells.ng_FieldGather);
+                } else {
+                    FillBoundaryEB(guard_cells.ng_FieldGather, fft_do_time_averaging);
+                    // TODO Remove call to FillBoundaryAux before UpdateAuxilaryData?
+                    if (WarpX::maxwell_solver_id != MaxwellSolverAlgo::PSATD)
+                        FillBoundaryAux(guard_cells.ng_UpdateAux);
+                    UpdateAuxilaryData();
                     FillBoundaryAux(guard_cells.ng_UpdateAux);
-                UpdateAuxilaryData();
-                FillBoundaryAux(guard_cells.ng_UpdateAux);
+                }
             }
         }
 
         // Run multi-physics modules:
         // ionization, Coulomb collisions, QED
-        doFieldIonization();
+        {
+            WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::QED);
+            doFieldIonization();
+        }
         mypc->doCollisions( cur_time );
 #ifdef WARPX_QED
         doQEDEvents();
@@ -185,8 +217,8 @@ WarpX::Evolve (int numsteps)
             // B: guard cells are NOT up-to-date
             // F: guard cells are NOT up-to-date
         }
-        // Electromagnetic case: subcycling with one level of mesh refinement
-        else if (do_subcycling == 1 && finest_level == 1)
+        // Electromagnetic case: subcycling with mesh refinement
+        else if (do_subcycling == 1 && finest_level >= 1)
         {
             OneStep_sub1(cur_time);
         }
@@ -209,13 +241,7 @@ WarpX::Evolve (int numsteps)
 
         if (cur_time + dt[0] >= stop_time - 1.e-3*dt[0] || step == numsteps_max-1) {
             // At the end of last step, push p by 0.5*dt to synchronize
-            FillBoundaryE(guard_cells.ng_FieldGather);
-            FillBoundaryB(guard_cells.ng_FieldGather);
-            if (fft_do_time_averaging)
-            {
-                FillBoundaryE_avg(guard_cells.ng_FieldGather);
-                FillBoundaryB_avg(guard_cells.ng_FieldGather);
-            }
+            FillBoundaryEB(guard_cells.ng_FieldGather, fft_do_time_averaging);
             UpdateAuxilaryData();
             FillBoundaryAux(guard_cells.ng_UpdateAux);
             for (int lev = 0; lev <= finest_level; ++lev) {
@@ -237,6 +263,7 @@ WarpX::Evolve (int numsteps)
         ShiftGalileanBoundary();
 
         if (do_back_transformed_diagnostics) {
+            WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::Diagnostics);
             std::unique_ptr<MultiFab> cell_centered_data = nullptr;
             if (WarpX::do_back_transformed_fields) {
                 cell_centered_data = GetCellCenteredData();
@@ -257,7 +284,8 @@ WarpX::Evolve (int numsteps)
         // interact the particles with EB walls (if present)
 #ifdef AMREX_USE_EB
         AMREX_ALWAYS_ASSERT(maxLevel() == 0);
-        mypc->ScrapeParticles(amrex::GetVecOfConstPtrs(m_distance_to_eb));
+        mypc->ScrapeParticles(amrex::GetVecOfConstPtrs(m_distance_to_eb),
+                              amrex::GetVecOfConstPtrs(m_distance_to_eb_min));
 #endif
 
         m_particle_boundary_buffer->gatherParticles(*mypc, amrex::GetVecOfConstPtrs(m_distance_to_eb));
@@ -280,17 +308,44 @@ WarpX::Evolve (int numsteps)
                     num_redistribute_ghost += 1;
                 }
                 mypc->RedistributeLocal(num_redistribute_ghost);
+                if (verbose && mypc->RedistributeIsBounded()) {
+                    amrex::Print() << "Redistribute: " << mypc->NumMigratedParticles()
+                                   << " particles migrated, " << mypc->NumStagedParticles()
+                                   << " staged\n";
+                }
             }
             else {
                 mypc->Redistribute();
             }
         }
 
-        if (sort_intervals.contains(step+1)) {
+        // move the inactive particles to the host, and back once they become active
+        m_particle_offload->update(*mypc, step+1, cur_time);
+
+        if (m_autotuning_tile_size) {
+            TileSizeAutotuneStep();
+        }
+
+        const bool do_sort = (do_adaptive_sort) ? AdaptiveSortIsNeeded()
+                                                : sort_intervals.contains(step+1);
+        if (do_sort) {
             if (verbose) {
                 amrex::Print() << "re-sorting particles \n";
             }
+            amrex::Real sort_time = 0._rt;
+            if (do_adaptive_sort) {
+                amrex::Gpu::synchronize();
+                sort_time = amrex::second();
+            }
             mypc->SortParticlesByBin(sort_bin_size);
+            if (do_adaptive_sort) {
+                amrex::Gpu::synchronize();
+                sort_time = amrex::second() - sort_time;
+                amrex::ParallelDescriptor::ReduceRealMax(sort_time);
+                m_adaptive_sort_cost = sort_time;
+                m_adaptive_sort_reference_time = -1._rt;
+                m_adaptive_sort_slowdown = 0._rt;
+            }
         }
 
         if( do_electrostatic != ElectrostaticSolverAlgo::None ) {
@@ -311,17 +366,27 @@ WarpX::Evolve (int numsteps)
             t_new[i] = cur_time;
         }
 
+        // The current may only be up-to-date in spectral space (see VayDeposition)
+        if (warpx_py_afterstep || multi_diags->DoComputeAndPack(step)) {
+            UpdateCurrentFromSpectralSpace();
+        }
+
         // warpx_py_afterstep runs with the updated global time. It is included
         // in the evolve timing.
         if (warpx_py_afterstep) warpx_py_afterstep();
 
-        /// reduced diags
-        if (reduced_diags->m_plot_rd != 0)
         {
-            reduced_diags->ComputeDiags(step);
-            reduced_diags->WriteToFile(step);
+            WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::Diagnostics);
+            /// reduced diags
+            if (reduced_diags->m_plot_rd != 0)
+            {
+                reduced_diags->ComputeDiags(step);
+                reduced_diags->WriteToFile(step);
+            }
+            multi_diags->FilterComputePackFlush( step );
+            // the charge densities deposited for the diagnostics of this step are not needed anymore
+            RhoFunctor::ClearCache();
         }
-        multi_diags->FilterComputePackFlush( step );
 
         // inputs: unused parameters (e.g. typos) check after step 1 has finished
         if (!early_params_checked) {
@@ -343,6 +408,13 @@ WarpX::Evolve (int numsteps)
                       << " s; Avg. per step = " << evolve_time/(step-step_begin+1) << " s\n";
         }
 
+        if (comm_precision_diagnostics) {
+            PrintCommErrorStats();
+        }
+
+        // accumulate the GPU event timers of the regions of this step that are complete
+        WarpXGpuRegions::Resolve();
+
         if (cur_time >= stop_time - 1.e-3*dt[0]) {
             break;
         }
@@ -350,11 +422,19 @@ WarpX::Evolve (int numsteps)
         // End loop on time steps
     }
 
+    UpdateCurrentFromSpectralSpace();
     multi_diags->FilterComputePackFlushLastTimestep( istep[0] );
+    RhoFunctor::ClearCache();
 
     if (do_back_transformed_diagnostics) {
         myBFD->Flush(geom[0]);
     }
+
+    if (reduced_diags->m_plot_rd != 0) {
+        reduced_diags->FinalizeDiags(istep[0]-1);
+    }
+
+    if (WarpXGpuRegions::timers_level > 0) WarpXGpuRegions::PrintTimers();
 }
 
 /* /brief Perform one PIC iteration, without subcycling
@@ -409,14 +489,15 @@ WarpX::OneStep_nosub (Real cur_time)
         PushPSATD();
 
         if (use_hybrid_QED) {
-            FillBoundaryE(guard_cells.ng_alloc_EB);
-            FillBoundaryB(guard_cells.ng_alloc_EB);
+            FillBoundaryEB(guard_cells.ng_alloc_EB);
             WarpX::Hybrid_QED_Push(dt);
             FillBoundaryE(guard_cells.ng_afterPushPSATD);
         }
         else {
-            FillBoundaryE(guard_cells.ng_afterPushPSATD);
-            FillBoundaryB(guard_cells.ng_afterPushPSATD);
+            // With psatd.overlap_comms, the guard cells of E,B are already exchanged in PushPSATD
+            if (!PSATDOverlapComms()) {
+                FillBoundaryEB(guard_cells.ng_afterPushPSATD);
+            }
             if (WarpX::do_dive_cleaning || WarpX::do_pml_dive_cleaning)
                 FillBoundaryF(guard_cells.ng_afterPushPSATD);
             if (WarpX::do_divb_cleaning || WarpX::do_pml_divb_cleaning)
@@ -431,14 +512,28 @@ WarpX::OneStep_nosub (Real cur_time)
             DampPML();
             NodalSyncPML();
         }
+    } else if (fdtd_temporal_blocking) {
+        // Push B from {n} to {n+1/2}, E from {n} to {n+1} and B from {n+1/2} to {n+1},
+        // box by box, without exchanging the guard cells in between
+        EvolveEBFused(dt[0]);
+
+        // Synchronize E and B fields on nodal points
+        NodalSync(Efield_fp, Efield_cp);
+        NodalSync(Bfield_fp, Bfield_cp);
+
+        // E and B are up-to-date in the domain, but all guard cells are
+        // outdated.
+        if (safe_guard_cells) {
+            FillBoundaryEB(guard_cells.ng_alloc_EB);
+        }
     } else {
         EvolveF(0.5_rt * dt[0], DtType::FirstHalf);
         EvolveG(0.5_rt * dt[0], DtType::FirstHalf);
-        FillBoundaryF(guard_cells.ng_FieldSolverF);
         FillBoundaryG(guard_cells.ng_FieldSolverG);
         EvolveB(0.5_rt * dt[0], DtType::FirstHalf); // We now have B^{n+1/2}
 
-        FillBoundaryB(guard_cells.ng_FieldSolver);
+        // F is only needed by the push of E: its guard cells are exchanged with those of B
+        FillBoundaryBF(guard_cells.ng_FieldSolver, guard_cells.ng_FieldSolverF);
 
         if (WarpX::em_solver_medium == MediumForEM::Vacuum) {
             // vacuum medium
@@ -463,9 +558,8 @@ WarpX::OneStep_nosub (Real cur_time)
             FillBoundaryF(guard_cells.ng_alloc_F);
             DampPML();
             NodalSyncPML();
-            FillBoundaryE(guard_cells.ng_MovingWindow);
+            FillBoundaryEB(guard_cells.ng_MovingWindow);
             FillBoundaryF(guard_cells.ng_MovingWindow);
-            FillBoundaryB(guard_cells.ng_MovingWindow);
         }
         // E and B are up-to-date in the domain, but all guard cells are
         // outdated.
@@ -534,7 +628,8 @@ WarpX::OneStep_multiJ (const amrex::Real cur_time)
         for (int i_depose = 0; i_depose < n_loop; i_depose++)
         {
             // Move rho deposited previously, from new to old
-            PSATDMoveRhoNewToRhoOld();
+            // (only when rho is deposited, otherwise rho_old and rho_new are not used)
+            if (WarpX::update_with_rho) PSATDMoveRhoNewToRhoOld();
 
             // Move J deposited previously, from new to old
             // (when using assumption of J linear in time)
@@ -583,8 +678,7 @@ WarpX::OneStep_multiJ (const amrex::Real cur_time)
             PSATDScaleAverageFields(1._rt / (2._rt*dt[0]));
             PSATDBackwardTransformEBavg();
         }
-        FillBoundaryE(guard_cells.ng_alloc_EB);
-        FillBoundaryB(guard_cells.ng_alloc_EB);
+        FillBoundaryEB(guard_cells.ng_alloc_EB);
         if (WarpX::do_dive_cleaning) FillBoundaryF(guard_cells.ng_alloc_F);
         if (WarpX::do_divb_cleaning) FillBoundaryG(guard_cells.ng_alloc_G);
 
@@ -605,18 +699,13 @@ WarpX::OneStep_multiJ (const amrex::Real cur_time)
 }
 
 /* /brief Perform one PIC iteration, with subcycling
-*  i.e. The fine patch uses a smaller timestep (and steps more often)
-*  than the coarse patch, for the field advance and particle pusher.
+*  i.e. The fine patches use a smaller timestep (and step more often)
+*  than the coarse patches, for the field advance and particle pusher.
 *
-* This version of subcycling only works for 2 levels and with a refinement
-* ratio of 2.
-* The particles and fields of the fine patch are pushed twice
-* (with dt[coarse]/2) in this routine.
-* The particles of the coarse patch and mother grid are pushed only once
-* (with dt[coarse]). The fields on the coarse patch and mother grid
-* are pushed in a way which is equivalent to pushing once only, with
-* a current which is the average of the coarse + fine current at the 2
-* steps of the fine grid.
+* This version of subcycling works for any number of levels, with a
+* refinement ratio of 2 between consecutive levels: each level lev
+* performs 2^lev iterations (with dt[lev] = dt[0]/2^lev) in this routine,
+* see OneStep_sub1(int, Real, DtType).
 *
 */
 void
@@ -629,96 +718,117 @@ WarpX::OneStep_sub1 (Real curtime)
 
     // TODO: we could save some charge depositions
 
-    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(finest_level == 1, "Must have exactly two levels");
-    const int fine_lev = 1;
-    const int coarse_lev = 0;
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(finest_level >= 1, "Must have at least two levels");
+    for (int lev = 0; lev < finest_level; ++lev) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(refRatio(lev) == IntVect(2),
+            "Subcycling method 1 only works with a refinement ratio of 2");
+    }
 
-    // i) Push particles and fields on the fine patch (first fine step)
-    PushParticlesandDepose(fine_lev, curtime, DtType::FirstHalf);
-    RestrictCurrentFromFineToCoarsePatch(fine_lev);
-    RestrictRhoFromFineToCoarsePatch(fine_lev);
-    ApplyFilterandSumBoundaryJ(fine_lev, PatchType::fine);
-    NodalSyncJ(fine_lev, PatchType::fine);
-    ApplyFilterandSumBoundaryRho(fine_lev, PatchType::fine, 0, 2*ncomps);
-    NodalSyncRho(fine_lev, PatchType::fine, 0, 2);
+    OneStep_sub1(0, curtime, DtType::Full);
+}
 
-    EvolveB(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev], DtType::FirstHalf);
-    EvolveF(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev], DtType::FirstHalf);
-    FillBoundaryB(fine_lev, PatchType::fine, guard_cells.ng_FieldSolver);
-    FillBoundaryF(fine_lev, PatchType::fine, guard_cells.ng_alloc_F);
+/* /brief Advance the particles of level `lev` and the fields of the levels
+*  `lev` and finer by dt[lev], with subcycling
+*
+* On the finest level, the particles and fields of the fine patch are pushed
+* once (with dt[lev]).
+* On the other levels, the levels finer than `lev` are advanced twice
+* (with dt[lev]/2, by calling this function recursively for lev+1) and the
+* particles of level `lev` are pushed only once (with dt[lev]). The fields on
+* the coarse patch of lev+1 and on the fine patch of lev are pushed in a way
+* which is equivalent to pushing once only, with a current which is the
+* average of the coarse + fine current at the 2 steps of the finer level.
+* As with two levels, each level only receives the current of the particles
+* of the next finer level (through the coarse patch of lev+1), and the coarse
+* patch of lev only holds the current of the particles of lev, restricted
+* before the current of lev+1 is added to the fine patch of lev.
+*
+* \param[in] lev level to advance
+* \param[in] curtime time at the beginning of the step of this level
+* \param[in] a_dt_type whether this step is the first or second half of the
+*            step of level lev-1 (DtType::Full on level 0)
+*/
+void
+WarpX::OneStep_sub1 (int lev, Real curtime, DtType a_dt_type)
+{
+    if (lev == finest_level)
+    {
+        const int fine_lev = lev;
+        // Both time levels of rho are needed by the first fine step only
+        const int nrho = (a_dt_type == DtType::SecondHalf) ? ncomps : 2*ncomps;
+
+        // Push particles and fields on the fine patch
+        PushParticlesandDepose(fine_lev, curtime, a_dt_type);
+        RestrictCurrentFromFineToCoarsePatch(fine_lev);
+        RestrictRhoFromFineToCoarsePatch(fine_lev);
+        ApplyFilterandSumBoundaryJ(fine_lev, PatchType::fine);
+        NodalSyncJ(fine_lev, PatchType::fine);
+        ApplyFilterandSumBoundaryRho(fine_lev, PatchType::fine, 0, nrho);
+        NodalSyncRho(fine_lev, PatchType::fine, 0, 2);
+
+        EvolveB(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev], DtType::FirstHalf);
+        EvolveF(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev], DtType::FirstHalf);
+        FillBoundaryBF(fine_lev, PatchType::fine, guard_cells.ng_FieldSolver, guard_cells.ng_alloc_F);
+
+        EvolveE(fine_lev, PatchType::fine, dt[fine_lev]);
+        FillBoundaryE(fine_lev, PatchType::fine, guard_cells.ng_FieldGather);
 
-    EvolveE(fine_lev, PatchType::fine, dt[fine_lev]);
-    FillBoundaryE(fine_lev, PatchType::fine, guard_cells.ng_FieldGather);
+        EvolveB(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev], DtType::SecondHalf);
+        EvolveF(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev], DtType::SecondHalf);
 
-    EvolveB(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev], DtType::SecondHalf);
-    EvolveF(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev], DtType::SecondHalf);
+        if (do_pml) {
+            FillBoundaryF(fine_lev, PatchType::fine, guard_cells.ng_alloc_F);
+            DampPML(fine_lev, PatchType::fine);
+            FillBoundaryE(fine_lev, PatchType::fine, guard_cells.ng_FieldGather);
+        }
 
-    if (do_pml) {
-        FillBoundaryF(fine_lev, PatchType::fine, guard_cells.ng_alloc_F);
-        DampPML(fine_lev, PatchType::fine);
-        FillBoundaryE(fine_lev, PatchType::fine, guard_cells.ng_FieldGather);
+        if ( safe_guard_cells )
+            FillBoundaryF(fine_lev, PatchType::fine, guard_cells.ng_FieldSolver);
+        FillBoundaryB(fine_lev, PatchType::fine, guard_cells.ng_FieldGather);
+        return;
     }
 
-    FillBoundaryB(fine_lev, PatchType::fine, guard_cells.ng_FieldGather);
+    const int fine_lev = lev+1;
+    const int coarse_lev = lev;
+
+    // i) Advance the finer levels (first fine step)
+    OneStep_sub1(fine_lev, curtime, DtType::FirstHalf);
 
     // ii) Push particles on the coarse patch and mother grid.
     // Push the fields on the coarse patch and mother grid
     // by only half a coarse step (first half)
-    PushParticlesandDepose(coarse_lev, curtime, DtType::Full);
+    PushParticlesandDepose(coarse_lev, curtime, a_dt_type);
+    if (coarse_lev > 0) {
+        // The coarse patch of coarse_lev only holds the current of its own particles
+        RestrictCurrentFromFineToCoarsePatch(coarse_lev);
+        RestrictRhoFromFineToCoarsePatch(coarse_lev);
+    }
     StoreCurrent(coarse_lev);
     AddCurrentFromFineLevelandSumBoundary(coarse_lev);
     AddRhoFromFineLevelandSumBoundary(coarse_lev, 0, ncomps);
 
     EvolveB(fine_lev, PatchType::coarse, dt[fine_lev], DtType::FirstHalf);
     EvolveF(fine_lev, PatchType::coarse, dt[fine_lev], DtType::FirstHalf);
-    FillBoundaryB(fine_lev, PatchType::coarse, guard_cells.ng_FieldGather);
-    FillBoundaryF(fine_lev, PatchType::coarse, guard_cells.ng_FieldSolverF);
+    FillBoundaryBF(fine_lev, PatchType::coarse, guard_cells.ng_FieldGather, guard_cells.ng_FieldSolverF);
 
     EvolveE(fine_lev, PatchType::coarse, dt[fine_lev]);
     FillBoundaryE(fine_lev, PatchType::coarse, guard_cells.ng_FieldGather);
 
     EvolveB(coarse_lev, PatchType::fine, 0.5_rt*dt[coarse_lev], DtType::FirstHalf);
     EvolveF(coarse_lev, PatchType::fine, 0.5_rt*dt[coarse_lev], DtType::FirstHalf);
-    FillBoundaryB(coarse_lev, PatchType::fine, guard_cells.ng_FieldGather);
-    FillBoundaryF(coarse_lev, PatchType::fine, guard_cells.ng_FieldSolverF);
+    FillBoundaryBF(coarse_lev, PatchType::fine, guard_cells.ng_FieldGather, guard_cells.ng_FieldSolverF);
 
     EvolveE(coarse_lev, PatchType::fine, 0.5_rt*dt[coarse_lev]);
     FillBoundaryE(coarse_lev, PatchType::fine, guard_cells.ng_FieldGather);
 
     // TODO Remove call to FillBoundaryAux before UpdateAuxilaryData?
     FillBoundaryAux(guard_cells.ng_UpdateAux);
-    // iii) Get auxiliary fields on the fine grid, at dt[fine_lev]
+    // iii) Get auxiliary fields on the finer levels, at curtime+dt[fine_lev]
     UpdateAuxilaryData();
     FillBoundaryAux(guard_cells.ng_UpdateAux);
 
-    // iv) Push particles and fields on the fine patch (second fine step)
-    PushParticlesandDepose(fine_lev, curtime+dt[fine_lev], DtType::SecondHalf);
-    RestrictCurrentFromFineToCoarsePatch(fine_lev);
-    RestrictRhoFromFineToCoarsePatch(fine_lev);
-    ApplyFilterandSumBoundaryJ(fine_lev, PatchType::fine);
-    NodalSyncJ(fine_lev, PatchType::fine);
-    ApplyFilterandSumBoundaryRho(fine_lev, PatchType::fine, 0, ncomps);
-    NodalSyncRho(fine_lev, PatchType::fine, 0, 2);
-
-    EvolveB(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev], DtType::FirstHalf);
-    EvolveF(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev], DtType::FirstHalf);
-    FillBoundaryB(fine_lev, PatchType::fine, guard_cells.ng_FieldSolver);
-    FillBoundaryF(fine_lev, PatchType::fine, guard_cells.ng_FieldSolverF);
-
-    EvolveE(fine_lev, PatchType::fine, dt[fine_lev]);
-    FillBoundaryE(fine_lev, PatchType::fine, guard_cells.ng_FieldSolver);
-
-    EvolveB(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev], DtType::SecondHalf);
-    EvolveF(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev], DtType::SecondHalf);
-
-    if (do_pml) {
-        DampPML(fine_lev, PatchType::fine);
-        FillBoundaryE(fine_lev, PatchType::fine, guard_cells.ng_FieldSolver);
-    }
-
-    if ( safe_guard_cells )
-        FillBoundaryF(fine_lev, PatchType::fine, guard_cells.ng_FieldSolver);
-    FillBoundaryB(fine_lev, PatchType::fine, guard_cells.ng_FieldSolver);
+    // iv) Advance the finer levels (second fine step)
+    OneStep_sub1(fine_lev, curtime+dt[fine_lev], DtType::SecondHalf);
 
     // v) Push the fields on the coarse patch and mother grid
     // by only half a coarse step (second half)
@@ -793,6 +903,7 @@ WarpX::doQEDEvents ()
 void
 WarpX::doQEDEvents (int lev)
 {
+    WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::QED);
     mypc->doQedEvents(lev,
                       *Efield_aux[lev][0],*Efield_aux[lev][1],*Efield_aux[lev][2],
                       *Bfield_aux[lev][0],*Bfield_aux[lev][1],*Bfield_aux[lev][2]);
@@ -807,6 +918,8 @@ WarpX::PushParticlesandDepose (amrex::Real cur_time, bool skip_deposition)
     for (int lev = 0; lev <= finest_level; ++lev) {
         PushParticlesandDepose(lev, cur_time, DtType::Full, skip_deposition);
     }
+    // The current is up-to-date in real space again (before the Vay deposition)
+    m_current_fp_in_spectral_space = false;
 }
 
 void
@@ -821,6 +934,20 @@ WarpX::PushParticlesandDepose (int lev, amrex::Real cur_time, DtType a_dt_type,
     amrex::MultiFab* current_z = (WarpX::do_current_centering) ? current_fp_nodal[lev][2].get()
                                                                : current_fp[lev][2].get();
 
+    amrex::Real evolve_time = 0._rt;
+    if (do_adaptive_sort || m_autotuning_tile_size) {
+        amrex::Gpu::synchronize();
+        evolve_time = amrex::second();
+    }
+
+    // If the exchange of the guard cells of E and B is still in progress
+    // (see FillBoundaryEB_nowait), it is completed within mypc->Evolve, once the
+    // particles that do not need the guard cells have been pushed
+    std::function<void()> finish_fill_boundary;
+    if (m_fill_boundary_EB_pending) {
+        finish_fill_boundary = [this] () { FillBoundaryEB_finish(); };
+    }
+
     mypc->Evolve(lev,
                  *Efield_aux[lev][0],*Efield_aux[lev][1],*Efield_aux[lev][2],
                  *Bfield_aux[lev][0],*Bfield_aux[lev][1],*Bfield_aux[lev][2],
@@ -829,7 +956,15 @@ WarpX::PushParticlesandDepose (int lev, amrex::Real cur_time, DtType a_dt_type,
                  rho_fp[lev].get(), charge_buf[lev].get(),
                  Efield_cax[lev][0].get(), Efield_cax[lev][1].get(), Efield_cax[lev][2].get(),
                  Bfield_cax[lev][0].get(), Bfield_cax[lev][1].get(), Bfield_cax[lev][2].get(),
-                 cur_time, dt[lev], a_dt_type, skip_deposition);
+                 cur_time, dt[lev], a_dt_type, skip_deposition,
+                 finish_fill_boundary, guard_cells.ng_FieldGather);
+
+    if (do_adaptive_sort || m_autotuning_tile_size) {
+        amrex::Gpu::synchronize();
+        const amrex::Real push_time = amrex::second() - evolve_time;
+        m_adaptive_sort_step_time += push_time;
+        m_autotune_step_time += push_time;
+    }
 #ifdef WARPX_DIM_RZ
     if (! skip_deposition) {
         // This is called after all particles have deposited their current and charge.
@@ -847,6 +982,138 @@ WarpX::PushParticlesandDepose (int lev, amrex::Real cur_time, DtType a_dt_type,
 #endif
 }
 
+bool
+WarpX::OverlapFillBoundaryPush () const
+{
+    if (!overlap_fillboundary_push) return false;
+    // The aux fields must be the same MultiFabs as the fine patch (no mesh refinement,
+    // and no interpolation to a nodal grid), so that they need no update after the exchange
+    const bool aux_is_nodal = (field_gathering_algo == GatheringAlgo::MomentumConserving);
+    if (finest_level > 0 || (aux_is_nodal && !do_nodal)) return false;
+    if (do_electrostatic != ElectrostaticSolverAlgo::None || do_multi_J ||
+        maxwell_solver_id == MaxwellSolverAlgo::PSATD) return false;
+    // The particles must gather the fields directly in the fine patch
+    if (use_fdtd_nci_corr || do_single_precision_comms || do_back_transformed_diagnostics) return false;
+    if (comm_precision_E != CommPrecision::Default || comm_precision_B != CommPrecision::Default) return false;
+    // The fields must not be used between the exchange and the push
+    for (int i = 0; i < mypc->nSpecies(); ++i) {
+        const auto& pc = mypc->GetParticleContainer(i);
+        if (pc.DoFieldIonization()) return false;
+#ifdef WARPX_QED
+        if (pc.has_quantum_sync() || pc.has_breit_wheeler()) return false;
+#endif
+    }
+#ifdef WARPX_QED
+    if (mypc->doQEDSchwingerEnabled()) return false;
+#endif
+    return true;
+}
+
+bool
+WarpX::AdaptiveSortIsNeeded ()
+{
+    // Use the slowest rank, so that all ranks take the same decision
+    amrex::Real step_time = m_adaptive_sort_step_time;
+    amrex::ParallelDescriptor::ReduceRealMax(step_time);
+    m_adaptive_sort_step_time = 0._rt;
+
+    if (m_adaptive_sort_reference_time < 0._rt) {
+        // First step after the last sort: this is the reference
+        m_adaptive_sort_reference_time = step_time;
+        return false;
+    }
+    m_adaptive_sort_reference_time = std::min(m_adaptive_sort_reference_time, step_time);
+    m_adaptive_sort_slowdown += step_time - m_adaptive_sort_reference_time;
+
+    return m_adaptive_sort_slowdown > m_adaptive_sort_cost;
+}
+
+void
+WarpX::InitTileSizeAutotune ()
+{
+    if (mypc->nSpecies() == 0) return;
+    const auto& pc0 = mypc->GetParticleContainer(0);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(pc0.do_tiling && amrex::Gpu::notInLaunchRegion(),
+        "warpx.autotune_tile_size = 1 requires the tiling of the particles (particles.do_tiling = 1, on CPU)");
+
+    amrex::Vector<int> candidates;
+    amrex::ParmParse pp_warpx("warpx");
+    if (pp_warpx.queryarr("autotune_tile_size_candidates", candidates)) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!candidates.empty() && candidates.size() % AMREX_SPACEDIM == 0,
+            "warpx.autotune_tile_size_candidates must contain AMREX_SPACEDIM integers per candidate");
+        for (int i = 0; i < static_cast<int>(candidates.size()); i += AMREX_SPACEDIM) {
+            amrex::IntVect tile_size;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                tile_size[idim] = candidates[i+idim];
+            }
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(tile_size.allGT(0),
+                "warpx.autotune_tile_size_candidates must be positive");
+            m_autotune_tile_sizes.push_back(tile_size);
+        }
+    } else {
+        // Around the current tile size: the first direction is usually not tiled
+        // (one tile spans the whole box), so only the other directions are varied
+        const amrex::IntVect tile_size = pc0.tile_size;
+        const int idim_min = (AMREX_SPACEDIM > 1) ? 1 : 0;
+        amrex::IntVect half = tile_size;
+        amrex::IntVect twice = tile_size;
+        for (int idim = idim_min; idim < AMREX_SPACEDIM; ++idim) {
+            half[idim] = std::max(tile_size[idim]/2, 1);
+            twice[idim] = 2*tile_size[idim];
+        }
+        const amrex::IntVect cube(tile_size[AMREX_SPACEDIM-1]);
+        for (const auto& candidate : {tile_size, half, twice, cube}) {
+            if (std::find(m_autotune_tile_sizes.begin(), m_autotune_tile_sizes.end(), candidate)
+                == m_autotune_tile_sizes.end()) {
+                m_autotune_tile_sizes.push_back(candidate);
+            }
+        }
+    }
+
+    m_autotune_tile_times.assign(m_autotune_tile_sizes.size(), std::numeric_limits<amrex::Real>::max());
+    m_autotune_nsteps = 0;
+    m_autotune_step_time = 0._rt;
+    m_autotuning_tile_size = true;
+    mypc->SetParticleTileSize(m_autotune_tile_sizes[0]);
+}
+
+void
+WarpX::TileSizeAutotuneStep ()
+{
+    // Use the slowest rank, so that all ranks take the same decision
+    amrex::Real step_time = m_autotune_step_time;
+    amrex::ParallelDescriptor::ReduceRealMax(step_time);
+    m_autotune_step_time = 0._rt;
+
+    // Keep the fastest step of each candidate, which excludes the re-tiling overhead
+    const int icandidate = m_autotune_nsteps / autotune_tile_size_steps;
+    m_autotune_tile_times[icandidate] = std::min(m_autotune_tile_times[icandidate], step_time);
+    ++m_autotune_nsteps;
+
+    const int inext = m_autotune_nsteps / autotune_tile_size_steps;
+    if (inext == icandidate) return;
+    if (inext < static_cast<int>(m_autotune_tile_sizes.size())) {
+        mypc->SetParticleTileSize(m_autotune_tile_sizes[inext]);
+        return;
+    }
+
+    const int ibest = static_cast<int>(std::min_element(m_autotune_tile_times.begin(),
+                                                        m_autotune_tile_times.end())
+                                       - m_autotune_tile_times.begin());
+    mypc->SetParticleTileSize(m_autotune_tile_sizes[ibest]);
+    m_autotuning_tile_size = false;
+
+    amrex::Print() << "Tile size autotuning (time of the particle push and deposition per step):\n";
+    for (int i = 0; i < static_cast<int>(m_autotune_tile_sizes.size()); ++i) {
+        const amrex::IntVect& t = m_autotune_tile_sizes[i];
+        amrex::Print() << "    particles.tile_size = " << AMREX_D_TERM(t[0], << " " << t[1], << " " << t[2])
+                       << " : " << m_autotune_tile_times[i] << " s\n";
+    }
+    const amrex::IntVect& t = m_autotune_tile_sizes[ibest];
+    amrex::Print() << "Using particles.tile_size = " << AMREX_D_TERM(t[0], << " " << t[1], << " " << t[2])
+                   << " for the rest of the run (set it in the input file to skip the autotuning)\n";
+}
+
 /* \brief Apply perfect mirror condition inside the box (not at a boundary).
  * In practice, set all fields to 0 on a section of the simulation domain
  * (as for a perfect conductor with a given thickness).
@@ -934,11 +1201,28 @@ WarpX::VayDeposition ()
 #ifdef WARPX_USE_PSATD
     if (WarpX::maxwell_solver_id == MaxwellSolverAlgo::PSATD)
     {
+#ifdef WARPX_DIM_RZ
         for (int lev = 0; lev <= finest_level; ++lev)
         {
             spectral_solver_fp[lev]->VayDeposition(lev, current_fp[lev]);
             if (spectral_solver_cp[lev]) spectral_solver_cp[lev]->VayDeposition(lev, current_cp[lev]);
         }
+#else
+        // Without mesh refinement, J is kept in spectral space for the PSATD push
+        // (saving a backward and a forward FFT of each component), unless it is
+        // needed in real space before the push. It is transformed back only if it
+        // is needed afterwards, in UpdateCurrentFromSpectralSpace.
+        const bool keep_spectral = (finest_level == 0) && !WarpX::J_linear_in_time &&
+            !do_back_transformed_diagnostics && !use_hybrid_QED &&
+            !(do_pml && (pml_has_particles || do_pml_j_damping)) &&
+            !warpx_py_beforeEsolve && !warpx_py_afterEsolve;
+        for (int lev = 0; lev <= finest_level; ++lev)
+        {
+            spectral_solver_fp[lev]->VayDeposition(lev, current_fp[lev], !keep_spectral);
+            if (spectral_solver_cp[lev]) spectral_solver_cp[lev]->VayDeposition(lev, current_cp[lev]);
+        }
+        m_current_fp_in_spectral_space = keep_spectral;
+#endif
     } else {
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE( false,
             "WarpX::VayDeposition: only implemented for spectral solver.");
@@ -948,3 +1232,15 @@ WarpX::VayDeposition ()
     "WarpX::CurrentCorrection: requires WarpX build with spectral solver support.");
 #endif
 }
+
+void
+WarpX::UpdateCurrentFromSpectralSpace ()
+{
+#ifdef WARPX_USE_PSATD
+    if (m_current_fp_in_spectral_space)
+    {
+        PSATDBackwardTransformJ();
+        m_current_fp_in_spectral_space = false;
+    }
+#endif
+}
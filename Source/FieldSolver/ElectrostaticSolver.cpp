@@ -7,12 +7,16 @@
 #include "WarpX.H"
 
 #include "FieldSolver/ElectrostaticSolver.H"
+#if defined(WARPX_USE_PSATD) && !defined(WARPX_DIM_RZ)
+#   include "FieldSolver/SpectralSolver/FFTPoissonSolver.H"
+#endif
 #include "Parallelization/GuardCellManager.H"
 #include "Particles/MultiParticleContainer.H"
 #include "Particles/WarpXParticleContainer.H"
 #include "Python/WarpX_py.H"
 #include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXConst.H"
+#include "Utils/WarpXPhaseTimers.H"
 #include "Utils/WarpXUtil.H"
 #include "Utils/WarpXProfilerWrapper.H"
 
@@ -35,11 +39,14 @@
 #include <AMReX_MFIter.H>
 #include <AMReX_MLMG.H>
 #include <AMReX_MultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
 #include <AMReX_REAL.H>
 #include <AMReX_SPACE.H>
 #include <AMReX_Vector.H>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <memory>
 #include <string>
 
@@ -48,6 +55,7 @@ using namespace amrex;
 void
 WarpX::ComputeSpaceChargeField (bool const reset_fields)
 {
+    WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::FieldSolve);
     WARPX_PROFILE("WarpX::ComputeSpaceChargeField");
     if (reset_fields) {
         // Reset all E and B fields to 0, before calculating space-charge fields
@@ -63,13 +71,69 @@ WarpX::ComputeSpaceChargeField (bool const reset_fields)
     if (do_electrostatic == ElectrostaticSolverAlgo::LabFrame) {
         AddSpaceChargeFieldLabFrame();
     } else {
-        // Loop over the species and add their space-charge contribution to E and B
+        // Group the species whose mean velocities agree within self_fields_beta_tolerance
+        // (with the first species of the group), so that each group needs only one
+        // Poisson solve; by default, each species is solved separately
+        Vector<WarpXParticleContainer*> self_field_species;
         for (int ispecies=0; ispecies<mypc->nSpecies(); ispecies++){
             WarpXParticleContainer& species = mypc->GetParticleContainer(ispecies);
-            if (species.initialize_self_fields ||
-                (do_electrostatic == ElectrostaticSolverAlgo::Relativistic)) {
-                AddSpaceChargeField(species);
+            if (!species.initialize_self_fields &&
+                (do_electrostatic != ElectrostaticSolverAlgo::Relativistic)) continue;
+            self_field_species.push_back(&species);
+        }
+
+        // Mean velocities of all these species, with a single reduction across MPI ranks
+        // (rather than one per species and velocity component)
+        const int n_self_field_species = static_cast<int>(self_field_species.size());
+        Vector<Real> v_sums(3*n_self_field_species);
+        Vector<Long> np_sums(n_self_field_species);
+        for (int is = 0; is < n_self_field_species; ++is) {
+            const std::array<Real, 3> v_sum = self_field_species[is]->sumParticleVelocity(np_sums[is]);
+            for (int idim = 0; idim < 3; ++idim) v_sums[3*is+idim] = v_sum[idim];
+        }
+        ParallelDescriptor::ReduceRealSum(v_sums.data(), v_sums.size());
+        ParallelDescriptor::ReduceLongSum(np_sums.data(), np_sums.size());
+
+        Vector<Vector<WarpXParticleContainer*> > groups;
+        Vector<std::array<Real, 3> > groups_first_beta;
+        Vector<std::array<Real, 3> > groups_sum_beta;
+        for (int is = 0; is < n_self_field_species; ++is) {
+            WarpXParticleContainer& species = *self_field_species[is];
+
+            // Get the particle beta vector (normalized mean velocity)
+            std::array<Real, 3> beta = {0._rt, 0._rt, 0._rt};
+            if (np_sums[is] > 0) {
+                for (int idim = 0; idim < 3; ++idim) {
+                    beta[idim] = v_sums[3*is+idim] / np_sums[is] / PhysConst::c;
+                }
             }
+
+            int igroup = -1;
+            if (self_fields_beta_tolerance >= 0._rt) {
+                for (int ig = 0; ig < static_cast<int>(groups.size()) && igroup < 0; ++ig) {
+                    Real max_diff = 0._rt;
+                    for (int idim = 0; idim < 3; ++idim) {
+                        max_diff = std::max(max_diff,
+                                            std::abs(beta[idim] - groups_first_beta[ig][idim]));
+                    }
+                    if (max_diff <= self_fields_beta_tolerance) igroup = ig;
+                }
+            }
+            if (igroup < 0) {
+                igroup = static_cast<int>(groups.size());
+                groups.emplace_back();
+                groups_first_beta.push_back(beta);
+                groups_sum_beta.push_back({0._rt, 0._rt, 0._rt});
+            }
+            groups[igroup].push_back(&species);
+            for (int idim = 0; idim < 3; ++idim) groups_sum_beta[igroup][idim] += beta[idim];
+        }
+
+        // Add the space-charge contribution of each group to E and B
+        for (int ig = 0; ig < static_cast<int>(groups.size()); ++ig) {
+            std::array<Real, 3> beta = groups_sum_beta[ig];
+            for (Real& beta_comp : beta) beta_comp /= groups[ig].size();
+            AddSpaceChargeField(groups[ig], beta);
         }
     }
     // Transfer fields from 'fp' array to 'aux' array.
@@ -81,7 +145,8 @@ WarpX::ComputeSpaceChargeField (bool const reset_fields)
 }
 
 void
-WarpX::AddSpaceChargeField (WarpXParticleContainer& pc)
+WarpX::AddSpaceChargeField (const amrex::Vector<WarpXParticleContainer*>& species_group,
+                            const std::array<amrex::Real,3>& beta)
 {
     WARPX_PROFILE("WarpX::AddSpaceChargeField");
 
@@ -112,21 +177,42 @@ WarpX::AddSpaceChargeField (WarpXParticleContainer& pc)
     bool const local = false;
     bool const reset = true;
     bool const do_rz_volume_scaling = true;
-    pc.DepositCharge(rho, local, reset, do_rz_volume_scaling);
+    species_group[0]->DepositCharge(rho, local, reset, do_rz_volume_scaling);
+    // The other species of the group are deposited separately and added (the
+    // exchange of the guard cells in DepositCharge cannot accumulate)
+    if (species_group.size() > 1) {
+        Vector<std::unique_ptr<MultiFab> > rho_species(num_levels);
+        for (int lev = 0; lev <= max_level; lev++) {
+            rho_species[lev] = std::make_unique<MultiFab>(rho[lev]->boxArray(), dmap[lev], 1, ng);
+        }
+        for (int is = 1; is < static_cast<int>(species_group.size()); ++is) {
+            species_group[is]->DepositCharge(rho_species, local, reset, do_rz_volume_scaling);
+            for (int lev = 0; lev <= max_level; lev++) {
+                MultiFab::Add(*rho[lev], *rho_species[lev], 0, 0, 1, ng);
+            }
+        }
+    }
 
-    // Get the particle beta vector
-    bool const local_average = false; // Average across all MPI ranks
-    std::array<Real, 3> beta = pc.meanParticleVelocity(local_average);
-    for (Real& beta_comp : beta) beta_comp /= PhysConst::c; // Normalize
+    // The solver parameters of the group are the strictest of its species
+    Real required_precision = species_group[0]->self_fields_required_precision;
+    Real absolute_tolerance = species_group[0]->self_fields_absolute_tolerance;
+    int max_iters = species_group[0]->self_fields_max_iters;
+    int verbosity = species_group[0]->self_fields_verbosity;
+    for (int is = 1; is < static_cast<int>(species_group.size()); ++is) {
+        required_precision = std::min(required_precision,
+                                      species_group[is]->self_fields_required_precision);
+        absolute_tolerance = std::min(absolute_tolerance,
+                                      species_group[is]->self_fields_absolute_tolerance);
+        max_iters = std::max(max_iters, species_group[is]->self_fields_max_iters);
+        verbosity = std::max(verbosity, species_group[is]->self_fields_verbosity);
+    }
 
     // Compute the potential phi, by solving the Poisson equation
-    computePhi( rho, phi, beta, pc.self_fields_required_precision,
-                pc.self_fields_absolute_tolerance, pc.self_fields_max_iters,
-                pc.self_fields_verbosity );
+    computePhi( rho, phi, beta, required_precision, absolute_tolerance,
+                max_iters, verbosity );
 
     // Compute the corresponding electric and magnetic field, from the potential phi
-    computeE( Efield_fp, phi, beta );
-    computeB( Bfield_fp, phi, beta );
+    computeEandB( Efield_fp, Bfield_fp, phi, beta );
 
 }
 
@@ -154,11 +240,34 @@ WarpX::AddSpaceChargeFieldLabFrame ()
     bool const interpolate_across_levels = false;
     bool const reset = false;
     bool const do_rz_volume_scaling = false;
-    for (int ispecies=0; ispecies<mypc->nSpecies(); ispecies++){
-        WarpXParticleContainer& species = mypc->GetParticleContainer(ispecies);
-        species.DepositCharge(
-            rho_fp, local, reset, do_rz_volume_scaling, interpolate_across_levels
-        );
+    if (adaptive_dt) {
+        // Each species is deposited separately, for its maximal charge density
+        // (the plasma frequency of the adaptive time step)
+        const int nspecies = mypc->nSpecies();
+        m_species_max_rho.assign(nspecies, 0._rt);
+        Vector<std::unique_ptr<MultiFab> > rho_species(max_level+1);
+        for (int lev = 0; lev <= max_level; lev++) {
+            rho_species[lev] = std::make_unique<MultiFab>(
+                rho_fp[lev]->boxArray(), dmap[lev], 1, rho_fp[lev]->nGrowVect());
+        }
+        for (int ispecies=0; ispecies<nspecies; ispecies++){
+            WarpXParticleContainer& species = mypc->GetParticleContainer(ispecies);
+            species.DepositCharge(
+                rho_species, local, true, do_rz_volume_scaling, interpolate_across_levels
+            );
+            for (int lev = 0; lev <= max_level; lev++) {
+                m_species_max_rho[ispecies] = std::max(m_species_max_rho[ispecies],
+                                                       rho_species[lev]->norm0(0, 0, true));
+                MultiFab::Add(*rho_fp[lev], *rho_species[lev], 0, 0, 1, rho_fp[lev]->nGrowVect());
+            }
+        }
+    } else {
+        for (int ispecies=0; ispecies<mypc->nSpecies(); ispecies++){
+            WarpXParticleContainer& species = mypc->GetParticleContainer(ispecies);
+            species.DepositCharge(
+                rho_fp, local, reset, do_rz_volume_scaling, interpolate_across_levels
+            );
+        }
     }
 #ifdef WARPX_DIM_RZ
     for (int lev = 0; lev <= max_level; lev++) {
@@ -171,22 +280,49 @@ WarpX::AddSpaceChargeFieldLabFrame ()
     // Todo: use simpler finite difference form with beta=0
     std::array<Real, 3> beta = {0._rt};
 
+    // Start the solve from the extrapolation of the previous two solutions
+    if (self_fields_warm_start) ExtrapolatePhi();
+
     // Compute the potential phi, by solving the Poisson equation
     if (warpx_py_poissonsolver) warpx_py_poissonsolver();
     else computePhi( rho_fp, phi_fp, beta, self_fields_required_precision,
                      self_fields_absolute_tolerance, self_fields_max_iters,
                      self_fields_verbosity );
 
-    // Compute the electric field. Note that if an EB is used the electric
-    // field will be calculated in the computePhi call.
+    // Compute the electric field (the magnetic field is zero since beta is
+    // zero). Note that if an EB is used the electric field will be calculated
+    // in the computePhi call.
 #ifndef AMREX_USE_EB
-    computeE( Efield_fp, phi_fp, beta );
+    computeEandB( Efield_fp, Bfield_fp, phi_fp, beta );
 #else
-    if (warpx_py_poissonsolver) computeE( Efield_fp, phi_fp, beta );
+    if (warpx_py_poissonsolver) computeEandB( Efield_fp, Bfield_fp, phi_fp, beta );
 #endif
+}
 
-    // Compute the magnetic field
-    computeB( Bfield_fp, phi_fp, beta );
+/* \brief Replace phi_fp (the solution of the previous step, phi^n), which is the
+   initial guess of the Poisson solver, by its linear extrapolation in time
+   2*phi^n - phi^{n-1}, and store phi^n in phi_fp_prev.
+   On the first call (or after a regrid), phi_fp is only stored.
+*/
+void
+WarpX::ExtrapolatePhi ()
+{
+    for (int lev = 0; lev <= max_level; lev++) {
+        MultiFab& phi = *phi_fp[lev];
+        if (!phi_fp_prev[lev] || phi_fp_prev[lev]->boxArray() != phi.boxArray() ||
+            phi_fp_prev[lev]->DistributionMap() != phi.DistributionMap())
+        {
+            phi_fp_prev[lev] = std::make_unique<MultiFab>(phi.boxArray(), phi.DistributionMap(),
+                                                          phi.nComp(), phi.nGrowVect());
+            MultiFab::Copy(*phi_fp_prev[lev], phi, 0, 0, phi.nComp(), phi.nGrowVect());
+            continue;
+        }
+        MultiFab& phi_prev = *phi_fp_prev[lev];
+        // phi_prev = 2*phi^n - phi^{n-1}, then swap phi and phi_prev
+        phi_prev.mult(-1._rt, 0, phi.nComp(), phi.nGrowVect());
+        MultiFab::Saxpy(phi_prev, 2._rt, phi, 0, 0, phi.nComp(), phi.nGrowVect());
+        MultiFab::Swap(phi, phi_prev, 0, 0, phi.nComp(), phi.nGrowVect());
+    }
 }
 
 /* Compute the potential `phi` by solving the Poisson equation with `rho` as
@@ -210,6 +346,18 @@ WarpX::computePhi (const amrex::Vector<std::unique_ptr<amrex::MultiFab> >& rho,
     computePhiRZ( rho, phi, beta, required_precision, absolute_tolerance,
                   max_iters, verbosity );
 #else
+#   if defined(WARPX_USE_PSATD) && !defined(AMREX_USE_EB)
+    if (poisson_solver_id == PoissonSolverAlgo::FFT) {
+        // Single-level solve with FFTs (no iterations: the MLMG parameters are not used)
+        if (!m_fft_poisson_solver ||
+            !m_fft_poisson_solver->isValidFor(Geom(0), phi[0]->nGrowVect(), beta)) {
+            m_fft_poisson_solver = std::make_unique<FFTPoissonSolver>(
+                Geom(0), phi[0]->nGrowVect(), beta);
+        }
+        m_fft_poisson_solver->Solve(*rho[0], *phi[0]);
+        return;
+    }
+#   endif
     computePhiCartesian( rho, phi, beta, required_precision, absolute_tolerance,
                          max_iters, verbosity );
 #endif
@@ -392,17 +540,31 @@ WarpX::computePhiCartesian (const amrex::Vector<std::unique_ptr<amrex::MultiFab>
     setPhiBC(phi, phi_bc_values_lo, phi_bc_values_hi);
 
 #ifndef AMREX_USE_EB
-    // Define the linear operator (Poisson operator)
-    MLNodeTensorLaplacian linop( Geom(), boxArray(), DistributionMap() );
+    // The linear operator and the MLMG solver are kept across the calls,
+    // and only rebuilt when the grids or beta change
+    ElectrostaticSolver::PoissonSolverCache& cache = m_poisson_solver_cache;
+    const bool rebuild_solver = !cache.isValidFor(boxArray(), DistributionMap(), beta);
+    if (rebuild_solver)
+    {
+        cache.mlmg.reset();
+
+        // Define the linear operator (Poisson operator)
+        cache.linop = std::make_unique<MLNodeTensorLaplacian>( Geom(), boxArray(), DistributionMap() );
 
-    // Set the value of beta
-    amrex::Array<amrex::Real,AMREX_SPACEDIM> beta_solver =
+        // Set the value of beta
+        amrex::Array<amrex::Real,AMREX_SPACEDIM> beta_solver =
 #   if (AMREX_SPACEDIM==2)
-        {{ beta[0], beta[2] }};  // beta_x and beta_z
+            {{ beta[0], beta[2] }};  // beta_x and beta_z
 #   else
-        {{ beta[0], beta[1], beta[2] }};
+            {{ beta[0], beta[1], beta[2] }};
 #   endif
-    linop.setBeta( beta_solver );
+        cache.linop->setBeta( beta_solver );
+        cache.linop->setDomainBC( field_boundary_handler.lobc, field_boundary_handler.hibc );
+
+        cache.grids = boxArray();
+        cache.dmap = DistributionMap();
+        cache.beta = beta;
+    }
 
 #else
 
@@ -430,7 +592,9 @@ WarpX::computePhiCartesian (const amrex::Vector<std::unique_ptr<amrex::MultiFab>
 #endif
 
     // Solve the Poisson equation
+#ifdef AMREX_USE_EB
     linop.setDomainBC( field_boundary_handler.lobc, field_boundary_handler.hibc );
+#endif
 
     amrex::Real max_norm_b = 0.0;
     for (int lev=0; lev < rho.size(); lev++){
@@ -447,7 +611,12 @@ WarpX::computePhiCartesian (const amrex::Vector<std::unique_ptr<amrex::MultiFab>
         );
     }
 
+#ifndef AMREX_USE_EB
+    if (rebuild_solver) cache.mlmg = std::make_unique<MLMG>(*cache.linop);
+    MLMG& mlmg = *cache.mlmg;
+#else
     MLMG mlmg(linop);
+#endif
     mlmg.setVerbose(verbosity);
     mlmg.setMaxIter(max_iters);
     mlmg.setAlwaysUseBNorm(always_use_bnorm);
@@ -748,6 +917,171 @@ WarpX::computeB (amrex::Vector<std::array<std::unique_ptr<amrex::MultiFab>, 3> >
     }
 }
 
+/* \brief Compute, in one sweep over `phi`, the electric and magnetic fields that
+          correspond to `phi`, and add them to the set of MultiFab `E` and `B`
+          (same finite differences as in computeE and computeB).
+
+   Each thread of the kernel (one per node of the tile) updates all the components
+   of E and B that are defined at its index, so that phi is read only once per tile.
+   The magnetic field is not computed when beta is zero (e.g. in the lab frame).
+
+   \param[inout] E Electric field on the grid
+   \param[inout] B Magnetic field on the grid
+   \param[in] phi The potential from which to compute the fields
+   \param[in] beta Represents the velocity of the source of `phi`
+*/
+void
+WarpX::computeEandB (amrex::Vector<std::array<std::unique_ptr<amrex::MultiFab>, 3> >& E,
+                     amrex::Vector<std::array<std::unique_ptr<amrex::MultiFab>, 3> >& B,
+                     const amrex::Vector<std::unique_ptr<amrex::MultiFab> >& phi,
+                     std::array<amrex::Real, 3> const beta ) const
+{
+    const bool has_beta = (beta[0] != 0._rt) || (beta[1] != 0._rt) || (beta[2] != 0._rt);
+
+    for (int lev = 0; lev <= max_level; lev++) {
+
+        const Real* dx = Geom(lev).CellSize();
+
+#ifdef AMREX_USE_OMP
+#    pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for ( MFIter mfi(*phi[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi )
+        {
+            const Real inv_dx = 1._rt/dx[0];
+#if (AMREX_SPACEDIM == 3)
+            const Real inv_dy = 1._rt/dx[1];
+            const Real inv_dz = 1._rt/dx[2];
+#else
+            const Real inv_dz = 1._rt/dx[1];
+#endif
+            // The tileboxes of all the components are contained in the nodal tilebox
+            const Box& tbn  = mfi.tilebox( IntVect::TheNodeVector() );
+            const Box& tex  = mfi.tilebox( E[lev][0]->ixType().toIntVect() );
+            const Box& tey  = mfi.tilebox( E[lev][1]->ixType().toIntVect() );
+            const Box& tez  = mfi.tilebox( E[lev][2]->ixType().toIntVect() );
+            const Box& tbx  = mfi.tilebox( B[lev][0]->ixType().toIntVect() );
+            const Box& tby  = mfi.tilebox( B[lev][1]->ixType().toIntVect() );
+            const Box& tbz  = mfi.tilebox( B[lev][2]->ixType().toIntVect() );
+
+            const auto& phi_arr = phi[lev]->const_array(mfi);
+            const auto& Ex_arr = (*E[lev][0])[mfi].array();
+            const auto& Ey_arr = (*E[lev][1])[mfi].array();
+            const auto& Ez_arr = (*E[lev][2])[mfi].array();
+            const auto& Bx_arr = (*B[lev][0])[mfi].array();
+            const auto& By_arr = (*B[lev][1])[mfi].array();
+            const auto& Bz_arr = (*B[lev][2])[mfi].array();
+
+            Real beta_x = beta[0];
+            Real beta_y = beta[1];
+            Real beta_z = beta[2];
+
+            constexpr Real inv_c = 1._rt/PhysConst::c;
+
+            // Use discretized derivatives that match the staggering of the grid.
+            amrex::ParallelFor( tbn,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+                    const IntVect iv(AMREX_D_DECL(i,j,k));
+#if (AMREX_SPACEDIM == 3)
+                    if (tex.contains(iv)) {
+                        Ex_arr(i,j,k) += -inv_dx*( phi_arr(i+1,j,k)-phi_arr(i,j,k) );
+                    }
+                    if (tey.contains(iv)) {
+                        Ey_arr(i,j,k) += -inv_dy*( phi_arr(i,j+1,k)-phi_arr(i,j,k) );
+                    }
+                    if (tez.contains(iv)) {
+                        Ez_arr(i,j,k) += -inv_dz*( phi_arr(i,j,k+1)-phi_arr(i,j,k) );
+                    }
+                    if (!has_beta) return;
+
+                    if (tex.contains(iv)) {
+                        Ex_arr(i,j,k) +=
+                            +beta_x*beta_x*inv_dx*( phi_arr(i+1,j,k)-phi_arr(i,j,k) )
+                            +beta_x*beta_y*0.25_rt*inv_dy*(phi_arr(i  ,j+1,k)-phi_arr(i  ,j-1,k)
+                                                      + phi_arr(i+1,j+1,k)-phi_arr(i+1,j-1,k))
+                            +beta_x*beta_z*0.25_rt*inv_dz*(phi_arr(i  ,j,k+1)-phi_arr(i  ,j,k-1)
+                                                      + phi_arr(i+1,j,k+1)-phi_arr(i+1,j,k-1));
+                    }
+                    if (tey.contains(iv)) {
+                        Ey_arr(i,j,k) +=
+                            +beta_y*beta_x*0.25_rt*inv_dx*(phi_arr(i+1,j  ,k)-phi_arr(i-1,j  ,k)
+                                                      + phi_arr(i+1,j+1,k)-phi_arr(i-1,j+1,k))
+                            +beta_y*beta_y*inv_dy*( phi_arr(i,j+1,k)-phi_arr(i,j,k) )
+                            +beta_y*beta_z*0.25_rt*inv_dz*(phi_arr(i,j  ,k+1)-phi_arr(i,j  ,k-1)
+                                                      + phi_arr(i,j+1,k+1)-phi_arr(i,j+1,k-1));
+                    }
+                    if (tez.contains(iv)) {
+                        Ez_arr(i,j,k) +=
+                            +beta_z*beta_x*0.25_rt*inv_dx*(phi_arr(i+1,j,k  )-phi_arr(i-1,j,k  )
+                                                      + phi_arr(i+1,j,k+1)-phi_arr(i-1,j,k+1))
+                            +beta_z*beta_y*0.25_rt*inv_dy*(phi_arr(i,j+1,k  )-phi_arr(i,j-1,k  )
+                                                      + phi_arr(i,j+1,k+1)-phi_arr(i,j-1,k+1))
+                            +beta_y*beta_z*inv_dz*( phi_arr(i,j,k+1)-phi_arr(i,j,k) );
+                    }
+                    if (tbx.contains(iv)) {
+                        Bx_arr(i,j,k) += inv_c * (
+                            -beta_y*inv_dz*0.5_rt*(phi_arr(i,j  ,k+1)-phi_arr(i,j  ,k)
+                                              + phi_arr(i,j+1,k+1)-phi_arr(i,j+1,k))
+                            +beta_z*inv_dy*0.5_rt*(phi_arr(i,j+1,k  )-phi_arr(i,j,k  )
+                                              + phi_arr(i,j+1,k+1)-phi_arr(i,j,k+1)));
+                    }
+                    if (tby.contains(iv)) {
+                        By_arr(i,j,k) += inv_c * (
+                            -beta_z*inv_dx*0.5_rt*(phi_arr(i+1,j,k  )-phi_arr(i,j,k  )
+                                              + phi_arr(i+1,j,k+1)-phi_arr(i,j,k+1))
+                            +beta_x*inv_dz*0.5_rt*(phi_arr(i  ,j,k+1)-phi_arr(i  ,j,k)
+                                              + phi_arr(i+1,j,k+1)-phi_arr(i+1,j,k)));
+                    }
+                    if (tbz.contains(iv)) {
+                        Bz_arr(i,j,k) += inv_c * (
+                            -beta_x*inv_dy*0.5_rt*(phi_arr(i  ,j+1,k)-phi_arr(i  ,j,k)
+                                              + phi_arr(i+1,j+1,k)-phi_arr(i+1,j,k))
+                            +beta_y*inv_dx*0.5_rt*(phi_arr(i+1,j  ,k)-phi_arr(i,j  ,k)
+                                              + phi_arr(i+1,j+1,k)-phi_arr(i,j+1,k)));
+                    }
+#else
+                    amrex::ignore_unused(tey, Ey_arr);
+                    if (tex.contains(iv)) {
+                        Ex_arr(i,j,k) += -inv_dx*( phi_arr(i+1,j,k)-phi_arr(i,j,k) );
+                    }
+                    if (tez.contains(iv)) {
+                        Ez_arr(i,j,k) += -inv_dz*( phi_arr(i,j+1,k)-phi_arr(i,j,k) );
+                    }
+                    if (!has_beta) return;
+
+                    if (tex.contains(iv)) {
+                        Ex_arr(i,j,k) +=
+                            +beta_x*beta_x*inv_dx*( phi_arr(i+1,j,k)-phi_arr(i,j,k) )
+                            +beta_x*beta_z*0.25_rt*inv_dz*(phi_arr(i  ,j+1,k)-phi_arr(i  ,j-1,k)
+                                                      + phi_arr(i+1,j+1,k)-phi_arr(i+1,j-1,k));
+                    }
+                    if (tez.contains(iv)) {
+                        Ez_arr(i,j,k) +=
+                            +beta_z*beta_x*0.25_rt*inv_dx*(phi_arr(i+1,j  ,k)-phi_arr(i-1,j  ,k)
+                                                      + phi_arr(i+1,j+1,k)-phi_arr(i-1,j+1,k))
+                            +beta_y*beta_z*inv_dz*( phi_arr(i,j+1,k)-phi_arr(i,j,k) );
+                    }
+                    if (tbx.contains(iv)) {
+                        Bx_arr(i,j,k) += inv_c * (
+                            -beta_y*inv_dz*( phi_arr(i,j+1,k)-phi_arr(i,j,k) ));
+                    }
+                    if (tby.contains(iv)) {
+                        By_arr(i,j,k) += inv_c * (
+                            -beta_z*inv_dx*0.5_rt*(phi_arr(i+1,j  ,k)-phi_arr(i,j  ,k)
+                                              + phi_arr(i+1,j+1,k)-phi_arr(i,j+1,k))
+                            +beta_x*inv_dz*0.5_rt*(phi_arr(i  ,j+1,k)-phi_arr(i  ,j,k)
+                                              + phi_arr(i+1,j+1,k)-phi_arr(i+1,j,k)));
+                    }
+                    if (tbz.contains(iv)) {
+                        Bz_arr(i,j,k) += inv_c * (
+                            +beta_y*inv_dx*( phi_arr(i+1,j,k)-phi_arr(i,j,k) ));
+                    }
+#endif
+                }
+            );
+        }
+    }
+}
+
 void ElectrostaticSolver::BoundaryHandler::definePhiBCs ( )
 {
 #ifdef WARPX_DIM_RZ
@@ -5,6 +5,7 @@
  * License: BSD-3-Clause-LBNL
  */
 #include "FiniteDifferenceSolver.H"
+#include "FieldSolver/FiniteDifferenceSolver/FusedComponentLoop.H"
 
 #ifndef WARPX_DIM_RZ
 #   include "FiniteDifferenceAlgorithms/CartesianYeeAlgorithm.H"
@@ -55,6 +56,7 @@ void FiniteDifferenceSolver::EvolveB (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 >& Venl,
     std::array< std::unique_ptr<amrex::iMultiFab>, 3 >& flag_info_cell,
     std::array< std::unique_ptr<amrex::LayoutData<FaceInfoBox> >, 3 >& borrowing,
+    std::array< EBTileClasses, 3 > const& face_tile_classes,
     int lev, amrex::Real const dt ) {
 
 #ifndef AMREX_USE_EB
@@ -65,20 +67,20 @@ void FiniteDifferenceSolver::EvolveB (
    // but we compile code for each algorithm, using templates)
 #ifdef WARPX_DIM_RZ
     if (m_fdtd_algo == MaxwellSolverAlgo::Yee){
-        ignore_unused(Gfield, face_areas);
+        ignore_unused(Gfield, face_areas, face_tile_classes);
         EvolveBCylindrical <CylindricalYeeAlgorithm> ( Bfield, Efield, lev, dt );
 #else
     if (m_do_nodal) {
 
-        EvolveBCartesian <CartesianNodalAlgorithm> ( Bfield, Efield, Gfield, face_areas, lev, dt );
+        EvolveBCartesian <CartesianNodalAlgorithm> ( Bfield, Efield, Gfield, face_areas, face_tile_classes, lev, dt );
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::Yee) {
 
-        EvolveBCartesian <CartesianYeeAlgorithm> ( Bfield, Efield, Gfield, face_areas, lev, dt );
+        EvolveBCartesian <CartesianYeeAlgorithm> ( Bfield, Efield, Gfield, face_areas, face_tile_classes, lev, dt );
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::CKC) {
 
-        EvolveBCartesian <CartesianCKCAlgorithm> ( Bfield, Efield, Gfield, face_areas, lev, dt );
+        EvolveBCartesian <CartesianCKCAlgorithm> ( Bfield, Efield, Gfield, face_areas, face_tile_classes, lev, dt );
 #ifdef AMREX_USE_EB
     } else if (m_fdtd_algo == MaxwellSolverAlgo::ECT) {
 
@@ -100,10 +102,14 @@ void FiniteDifferenceSolver::EvolveBCartesian (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Efield,
     std::unique_ptr<amrex::MultiFab> const& Gfield,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& face_areas,
+    std::array< EBTileClasses, 3 > const& face_tile_classes,
     int lev, amrex::Real const dt ) {
 
 #ifndef AMREX_USE_EB
-    amrex::ignore_unused(face_areas);
+    amrex::ignore_unused(face_areas, face_tile_classes);
+#else
+    // Use the classification of the tiles, when it was computed for these grids
+    const bool use_tile_classes = face_tile_classes[0].isValidFor(*Bfield[0]);
 #endif
 
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
@@ -146,60 +152,63 @@ void FiniteDifferenceSolver::EvolveBCartesian (
         Box const& tby  = mfi.tilebox(Bfield[1]->ixType().toIntVect());
         Box const& tbz  = mfi.tilebox(Bfield[2]->ixType().toIntVect());
 
-        // Loop over the cells and update the fields
-        amrex::ParallelFor(tbx, tby, tbz,
-
-            [=] AMREX_GPU_DEVICE (int i, int j, int k){
-#ifdef AMREX_USE_EB
-                // Skip field push if this cell is fully covered by embedded boundaries
-                if (Sx(i, j, k) <= 0) return;
-#endif
-                Bx(i, j, k) += dt * T_Algo::UpwardDz(Ey, coefs_z, n_coefs_z, i, j, k)
-                             - dt * T_Algo::UpwardDy(Ez, coefs_y, n_coefs_y, i, j, k);
-            },
+        // If G is not a null pointer, B is further updated with the grad(G) term
+        // (div(B) cleaning correction for errors in magnetic Gauss law), in the same pass
+        bool const use_G = static_cast<bool>(Gfield);
+        Array4<Real> G;
+        if (use_G) G = Gfield->array(mfi);
+
+        // Update of each component, in one cell
+        auto const update_Bx = [=] AMREX_GPU_DEVICE (int i, int j, int k){
+            Bx(i, j, k) += dt * T_Algo::UpwardDz(Ey, coefs_z, n_coefs_z, i, j, k)
+                         - dt * T_Algo::UpwardDy(Ez, coefs_y, n_coefs_y, i, j, k)
+                         + (use_G ? dt * T_Algo::DownwardDx(G, coefs_x, n_coefs_x, i, j, k) : 0._rt);
+        };
+        auto const update_By = [=] AMREX_GPU_DEVICE (int i, int j, int k){
+            By(i, j, k) += dt * T_Algo::UpwardDx(Ez, coefs_x, n_coefs_x, i, j, k)
+                         - dt * T_Algo::UpwardDz(Ex, coefs_z, n_coefs_z, i, j, k)
+                         + (use_G ? dt * T_Algo::DownwardDy(G, coefs_y, n_coefs_y, i, j, k) : 0._rt);
+        };
+        auto const update_Bz = [=] AMREX_GPU_DEVICE (int i, int j, int k){
+            Bz(i, j, k) += dt * T_Algo::UpwardDy(Ex, coefs_y, n_coefs_y, i, j, k)
+                         - dt * T_Algo::UpwardDx(Ey, coefs_x, n_coefs_x, i, j, k)
+                         + (use_G ? dt * T_Algo::DownwardDz(G, coefs_z, n_coefs_z, i, j, k) : 0._rt);
+        };
 
-            [=] AMREX_GPU_DEVICE (int i, int j, int k){
-#ifdef AMREX_USE_EB
-                // Skip field push if this cell is fully covered by embedded boundaries
-                if (Sy(i, j, k) <= 0) return;
-#endif
-                By(i, j, k) += dt * T_Algo::UpwardDx(Ez, coefs_x, n_coefs_x, i, j, k)
-                             - dt * T_Algo::UpwardDz(Ex, coefs_z, n_coefs_z, i, j, k);
-            },
-
-            [=] AMREX_GPU_DEVICE (int i, int j, int k){
+        // Loop over the cells and update the fields
 #ifdef AMREX_USE_EB
-                // Skip field push if this cell is fully covered by embedded boundaries
-                if (Sz(i, j, k) <= 0) return;
-#endif
-                Bz(i, j, k) += dt * T_Algo::UpwardDy(Ex, coefs_y, n_coefs_y, i, j, k)
-                             - dt * T_Algo::UpwardDx(Ey, coefs_x, n_coefs_x, i, j, k);
-            }
-        );
-
-        // div(B) cleaning correction for errors in magnetic Gauss law (div(B) = 0)
-        if (Gfield)
-        {
-            // Extract field data for this grid/tile
-            Array4<Real> G = Gfield->array(mfi);
-
-            // Loop over cells and update G
+        if (use_tile_classes) {
+            // Update the regular tiles without testing the face areas,
+            // only the open faces of the cut tiles, and skip the covered tiles
+            const int itile = mfi.LocalTileIndex();
+            ParallelForEBTile(tbx, face_tile_classes[0], itile, update_Bx);
+            ParallelForEBTile(tby, face_tile_classes[1], itile, update_By);
+            ParallelForEBTile(tbz, face_tile_classes[2], itile, update_Bz);
+        } else {
             amrex::ParallelFor(tbx, tby, tbz,
 
-                [=] AMREX_GPU_DEVICE (int i, int j, int k)
-                {
-                    Bx(i,j,k) += dt * T_Algo::DownwardDx(G, coefs_x, n_coefs_x, i, j, k);
+                [=] AMREX_GPU_DEVICE (int i, int j, int k){
+                    // Skip field push if this cell is fully covered by embedded boundaries
+                    if (Sx(i, j, k) <= 0) return;
+                    update_Bx(i, j, k);
                 },
-                [=] AMREX_GPU_DEVICE (int i, int j, int k)
-                {
-                    By(i,j,k) += dt * T_Algo::DownwardDy(G, coefs_y, n_coefs_y, i, j, k);
+
+                [=] AMREX_GPU_DEVICE (int i, int j, int k){
+                    // Skip field push if this cell is fully covered by embedded boundaries
+                    if (Sy(i, j, k) <= 0) return;
+                    update_By(i, j, k);
                 },
-                [=] AMREX_GPU_DEVICE (int i, int j, int k)
-                {
-                    Bz(i,j,k) += dt * T_Algo::DownwardDz(G, coefs_z, n_coefs_z, i, j, k);
+
+                [=] AMREX_GPU_DEVICE (int i, int j, int k){
+                    // Skip field push if this cell is fully covered by embedded boundaries
+                    if (Sz(i, j, k) <= 0) return;
+                    update_Bz(i, j, k);
                 }
             );
         }
+#else
+        FusedComponentFor(tbx, tby, tbz, update_Bx, update_By, update_Bz);
+#endif
 
         if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
         {
@@ -6,7 +6,9 @@
  */
 #include "FieldSolver/FiniteDifferenceSolver/FiniteDifferenceSolver.H"
 
+#include "BoundaryConditions/PML.H"
 #include "BoundaryConditions/PMLComponent.H"
+#include "BoundaryConditions/WarpX_PML_kernels.H"
 
 #ifndef WARPX_DIM_RZ
 #   include "FieldSolver/FiniteDifferenceSolver/FiniteDifferenceAlgorithms/CartesianYeeAlgorithm.H"
@@ -43,25 +45,30 @@ void FiniteDifferenceSolver::EvolveBPML (
     std::array< amrex::MultiFab*, 3 > Bfield,
     std::array< amrex::MultiFab*, 3 > const Efield,
     amrex::Real const dt,
-    const bool dive_cleaning) {
+    const bool dive_cleaning,
+    MultiSigmaBox const* damping_sigba,
+    const bool divb_cleaning) {
 
    // Select algorithm (The choice of algorithm is a runtime option,
    // but we compile code for each algorithm, using templates)
 #ifdef WARPX_DIM_RZ
-    amrex::ignore_unused(Bfield, Efield, dt, dive_cleaning);
+    amrex::ignore_unused(Bfield, Efield, dt, dive_cleaning, damping_sigba, divb_cleaning);
     amrex::Abort("PML are not implemented in cylindrical geometry.");
 #else
     if (m_do_nodal) {
 
-        EvolveBPMLCartesian <CartesianNodalAlgorithm> (Bfield, Efield, dt, dive_cleaning);
+        EvolveBPMLCartesian <CartesianNodalAlgorithm> (Bfield, Efield, dt, dive_cleaning,
+                                               damping_sigba, divb_cleaning);
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::Yee || m_fdtd_algo == MaxwellSolverAlgo::ECT) {
 
-        EvolveBPMLCartesian <CartesianYeeAlgorithm> (Bfield, Efield, dt, dive_cleaning);
+        EvolveBPMLCartesian <CartesianYeeAlgorithm> (Bfield, Efield, dt, dive_cleaning,
+                                               damping_sigba, divb_cleaning);
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::CKC) {
 
-        EvolveBPMLCartesian <CartesianCKCAlgorithm> (Bfield, Efield, dt, dive_cleaning);
+        EvolveBPMLCartesian <CartesianCKCAlgorithm> (Bfield, Efield, dt, dive_cleaning,
+                                               damping_sigba, divb_cleaning);
 
     } else {
         amrex::Abort("EvolveBPML: Unknown algorithm");
@@ -77,7 +84,14 @@ void FiniteDifferenceSolver::EvolveBPMLCartesian (
     std::array< amrex::MultiFab*, 3 > Bfield,
     std::array< amrex::MultiFab*, 3 > const Efield,
     amrex::Real const dt,
-    const bool dive_cleaning) {
+    const bool dive_cleaning,
+    MultiSigmaBox const* damping_sigba,
+    const bool divb_cleaning) {
+
+    const bool damp = (damping_sigba != nullptr);
+    const amrex::IntVect Bx_stag = Bfield[0]->ixType().toIntVect();
+    const amrex::IntVect By_stag = Bfield[1]->ixType().toIntVect();
+    const amrex::IntVect Bz_stag = Bfield[2]->ixType().toIntVect();
 
     // Loop through the grids, and over the tiles within each grid
 #ifdef AMREX_USE_OMP
@@ -106,6 +120,35 @@ void FiniteDifferenceSolver::EvolveBPMLCartesian (
         Box const& tby  = mfi.tilebox(Bfield[1]->ixType().ixType());
         Box const& tbz  = mfi.tilebox(Bfield[2]->ixType().ixType());
 
+        // Damping factors of the PML, if the damping is done in the same kernel
+        amrex::Real const * AMREX_RESTRICT sigma_fac_x = nullptr;
+        amrex::Real const * AMREX_RESTRICT sigma_fac_y = nullptr;
+        amrex::Real const * AMREX_RESTRICT sigma_fac_z = nullptr;
+        amrex::Real const * AMREX_RESTRICT sigma_star_fac_x = nullptr;
+        amrex::Real const * AMREX_RESTRICT sigma_star_fac_y = nullptr;
+        amrex::Real const * AMREX_RESTRICT sigma_star_fac_z = nullptr;
+        int x_lo = 0;
+        int y_lo = 0;
+        int z_lo = 0;
+        if (damp) {
+            const SigmaBox& sigbox = (*damping_sigba)[mfi];
+            sigma_fac_x = sigbox.sigma_fac[0].data();
+            sigma_star_fac_x = sigbox.sigma_star_fac[0].data();
+            x_lo = sigbox.sigma_fac[0].lo();
+#if (AMREX_SPACEDIM == 3)
+            sigma_fac_y = sigbox.sigma_fac[1].data();
+            sigma_fac_z = sigbox.sigma_fac[2].data();
+            sigma_star_fac_y = sigbox.sigma_star_fac[1].data();
+            sigma_star_fac_z = sigbox.sigma_star_fac[2].data();
+            y_lo = sigbox.sigma_fac[1].lo();
+            z_lo = sigbox.sigma_fac[2].lo();
+#else
+            sigma_fac_z = sigbox.sigma_fac[1].data();
+            sigma_star_fac_z = sigbox.sigma_star_fac[1].data();
+            z_lo = sigbox.sigma_fac[1].lo();
+#endif
+        }
+
         // Loop over the cells and update the fields
         amrex::ParallelFor(tbx, tby, tbz,
 
@@ -128,6 +171,12 @@ void FiniteDifferenceSolver::EvolveBPMLCartesian (
                     T_Algo::UpwardDy(Ez, coefs_y, n_coefs_y, i, j, k, PMLComp::zx)
                   + T_Algo::UpwardDy(Ez, coefs_y, n_coefs_y, i, j, k, PMLComp::zy)
                   + UpwardDy_Ez_zz);
+
+                if (damp) {
+                    warpx_damp_pml_bx(i, j, k, Bx, Bx_stag, sigma_fac_x, sigma_fac_y, sigma_fac_z,
+                                      sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z,
+                                      x_lo, y_lo, z_lo, divb_cleaning);
+                }
             },
 
             [=] AMREX_GPU_DEVICE (int i, int j, int k){
@@ -149,6 +198,12 @@ void FiniteDifferenceSolver::EvolveBPMLCartesian (
                     UpwardDz_Ex_xx
                   + T_Algo::UpwardDz(Ex, coefs_z, n_coefs_z, i, j, k, PMLComp::xy)
                   + T_Algo::UpwardDz(Ex, coefs_z, n_coefs_z, i, j, k, PMLComp::xz));
+
+                if (damp) {
+                    warpx_damp_pml_by(i, j, k, By, By_stag, sigma_fac_x, sigma_fac_y, sigma_fac_z,
+                                      sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z,
+                                      x_lo, y_lo, z_lo, divb_cleaning);
+                }
             },
 
             [=] AMREX_GPU_DEVICE (int i, int j, int k){
@@ -170,6 +225,12 @@ void FiniteDifferenceSolver::EvolveBPMLCartesian (
                     T_Algo::UpwardDx(Ey, coefs_x, n_coefs_x, i, j, k, PMLComp::yx)
                   + T_Algo::UpwardDx(Ey, coefs_x, n_coefs_x, i, j, k, PMLComp::yz)
                   + UpwardDx_Ey_yy);
+
+                if (damp) {
+                    warpx_damp_pml_bz(i, j, k, Bz, Bz_stag, sigma_fac_x, sigma_fac_y, sigma_fac_z,
+                                      sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z,
+                                      x_lo, y_lo, z_lo, divb_cleaning);
+                }
             }
 
         );
@@ -5,6 +5,7 @@
  * License: BSD-3-Clause-LBNL
  */
 #include "FiniteDifferenceSolver.H"
+#include "FieldSolver/FiniteDifferenceSolver/FusedComponentLoop.H"
 
 #ifndef WARPX_DIM_RZ
 #   include "FieldSolver/FiniteDifferenceSolver/FiniteDifferenceAlgorithms/CartesianYeeAlgorithm.H"
@@ -52,6 +53,7 @@ void FiniteDifferenceSolver::EvolveE (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& face_areas,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 >& ECTRhofield,
     std::unique_ptr<amrex::MultiFab> const& Ffield,
+    std::array< EBTileClasses, 3 > const& edge_tile_classes,
     int lev, amrex::Real const dt ) {
 
 #ifdef AMREX_USE_EB
@@ -66,16 +68,16 @@ void FiniteDifferenceSolver::EvolveE (
     // but we compile code for each algorithm, using templates)
 #ifdef WARPX_DIM_RZ
     if (m_fdtd_algo == MaxwellSolverAlgo::Yee){
-        ignore_unused(edge_lengths);
+        ignore_unused(edge_lengths, edge_tile_classes);
         EvolveECylindrical <CylindricalYeeAlgorithm> ( Efield, Bfield, Jfield, Ffield, lev, dt );
 #else
     if (m_do_nodal) {
 
-        EvolveECartesian <CartesianNodalAlgorithm> ( Efield, Bfield, Jfield, edge_lengths, Ffield, lev, dt );
+        EvolveECartesian <CartesianNodalAlgorithm> ( Efield, Bfield, Jfield, edge_lengths, Ffield, edge_tile_classes, lev, dt );
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::Yee || m_fdtd_algo == MaxwellSolverAlgo::ECT) {
 
-        EvolveECartesian <CartesianYeeAlgorithm> ( Efield, Bfield, Jfield, edge_lengths, Ffield, lev, dt );
+        EvolveECartesian <CartesianYeeAlgorithm> ( Efield, Bfield, Jfield, edge_lengths, Ffield, edge_tile_classes, lev, dt );
 #ifdef AMREX_USE_EB
         if (m_fdtd_algo == MaxwellSolverAlgo::ECT) {
             EvolveRhoCartesianECT(Efield, edge_lengths, face_areas, ECTRhofield, lev);
@@ -83,7 +85,7 @@ void FiniteDifferenceSolver::EvolveE (
 #endif
     } else if (m_fdtd_algo == MaxwellSolverAlgo::CKC) {
 
-        EvolveECartesian <CartesianCKCAlgorithm> ( Efield, Bfield, Jfield, edge_lengths, Ffield, lev, dt );
+        EvolveECartesian <CartesianCKCAlgorithm> ( Efield, Bfield, Jfield, edge_lengths, Ffield, edge_tile_classes, lev, dt );
 
 #endif
     } else {
@@ -102,10 +104,14 @@ void FiniteDifferenceSolver::EvolveECartesian (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Jfield,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& edge_lengths,
     std::unique_ptr<amrex::MultiFab> const& Ffield,
+    std::array< EBTileClasses, 3 > const& edge_tile_classes,
     int lev, amrex::Real const dt ) {
 
 #ifndef AMREX_USE_EB
-    amrex::ignore_unused(edge_lengths);
+    amrex::ignore_unused(edge_lengths, edge_tile_classes);
+#else
+    // Use the classification of the tiles, when it was computed for these grids
+    const bool use_tile_classes = edge_tile_classes[0].isValidFor(*Efield[0]);
 #endif
 
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
@@ -152,70 +158,69 @@ void FiniteDifferenceSolver::EvolveECartesian (
         Box const& tey  = mfi.tilebox(Efield[1]->ixType().toIntVect());
         Box const& tez  = mfi.tilebox(Efield[2]->ixType().toIntVect());
 
-        // Loop over the cells and update the fields
-        amrex::ParallelFor(tex, tey, tez,
-
-            [=] AMREX_GPU_DEVICE (int i, int j, int k){
-#ifdef AMREX_USE_EB
-                // Skip field push if this cell is fully covered by embedded boundaries
-                if (lx(i, j, k) <= 0) return;
-#endif
-                Ex(i, j, k) += c2 * dt * (
-                    - T_Algo::DownwardDz(By, coefs_z, n_coefs_z, i, j, k)
-                    + T_Algo::DownwardDy(Bz, coefs_y, n_coefs_y, i, j, k)
-                    - PhysConst::mu0 * jx(i, j, k) );
-            },
-
-            [=] AMREX_GPU_DEVICE (int i, int j, int k){
-#ifdef AMREX_USE_EB
-                // Skip field push if this cell is fully covered by embedded boundaries
-                if (ly(i,j,k) <= 0) return;
-#endif
-
-                Ey(i, j, k) += c2 * dt * (
-                    - T_Algo::DownwardDx(Bz, coefs_x, n_coefs_x, i, j, k)
-                    + T_Algo::DownwardDz(Bx, coefs_z, n_coefs_z, i, j, k)
-                    - PhysConst::mu0 * jy(i, j, k) );
-
-            },
-
-            [=] AMREX_GPU_DEVICE (int i, int j, int k){
+        // If F is not a null pointer, E is further updated with the grad(F) term
+        // (hyperbolic correction for errors in charge conservation), in the same pass
+        bool const use_F = static_cast<bool>(Ffield);
+        Array4<Real> F;
+        if (use_F) F = Ffield->array(mfi);
+
+        // Update of each component, in one cell
+        auto const update_Ex = [=] AMREX_GPU_DEVICE (int i, int j, int k){
+            Ex(i, j, k) += c2 * dt * (
+                - T_Algo::DownwardDz(By, coefs_z, n_coefs_z, i, j, k)
+                + T_Algo::DownwardDy(Bz, coefs_y, n_coefs_y, i, j, k)
+                - PhysConst::mu0 * jx(i, j, k)
+                + (use_F ? T_Algo::UpwardDx(F, coefs_x, n_coefs_x, i, j, k) : 0._rt) );
+        };
+        auto const update_Ey = [=] AMREX_GPU_DEVICE (int i, int j, int k){
+            Ey(i, j, k) += c2 * dt * (
+                - T_Algo::DownwardDx(Bz, coefs_x, n_coefs_x, i, j, k)
+                + T_Algo::DownwardDz(Bx, coefs_z, n_coefs_z, i, j, k)
+                - PhysConst::mu0 * jy(i, j, k)
+                + (use_F ? T_Algo::UpwardDy(F, coefs_y, n_coefs_y, i, j, k) : 0._rt) );
+        };
+        auto const update_Ez = [=] AMREX_GPU_DEVICE (int i, int j, int k){
+            Ez(i, j, k) += c2 * dt * (
+                - T_Algo::DownwardDy(Bx, coefs_y, n_coefs_y, i, j, k)
+                + T_Algo::DownwardDx(By, coefs_x, n_coefs_x, i, j, k)
+                - PhysConst::mu0 * jz(i, j, k)
+                + (use_F ? T_Algo::UpwardDz(F, coefs_z, n_coefs_z, i, j, k) : 0._rt) );
+        };
 
+        // Loop over the cells and update the fields
 #ifdef AMREX_USE_EB
-                // Skip field push if this cell is fully covered by embedded boundaries
-                if (lz(i,j,k) <= 0) return;
-#endif
-                Ez(i, j, k) += c2 * dt * (
-                    - T_Algo::DownwardDy(Bx, coefs_y, n_coefs_y, i, j, k)
-                    + T_Algo::DownwardDx(By, coefs_x, n_coefs_x, i, j, k)
-                    - PhysConst::mu0 * jz(i, j, k) );
-            }
-
-        );
-
-        // If F is not a null pointer, further update E using the grad(F) term
-        // (hyperbolic correction for errors in charge conservation)
-        if (Ffield) {
-
-            // Extract field data for this grid/tile
-            Array4<Real> F = Ffield->array(mfi);
-
-            // Loop over the cells and update the fields
+        if (use_tile_classes) {
+            // Update the regular tiles without testing the edge lengths,
+            // only the open edges of the cut tiles, and skip the covered tiles
+            const int itile = mfi.LocalTileIndex();
+            ParallelForEBTile(tex, edge_tile_classes[0], itile, update_Ex);
+            ParallelForEBTile(tey, edge_tile_classes[1], itile, update_Ey);
+            ParallelForEBTile(tez, edge_tile_classes[2], itile, update_Ez);
+        } else {
             amrex::ParallelFor(tex, tey, tez,
 
                 [=] AMREX_GPU_DEVICE (int i, int j, int k){
-                    Ex(i, j, k) += c2 * dt * T_Algo::UpwardDx(F, coefs_x, n_coefs_x, i, j, k);
+                    // Skip field push if this cell is fully covered by embedded boundaries
+                    if (lx(i, j, k) <= 0) return;
+                    update_Ex(i, j, k);
                 },
+
                 [=] AMREX_GPU_DEVICE (int i, int j, int k){
-                    Ey(i, j, k) += c2 * dt * T_Algo::UpwardDy(F, coefs_y, n_coefs_y, i, j, k);
+                    // Skip field push if this cell is fully covered by embedded boundaries
+                    if (ly(i, j, k) <= 0) return;
+                    update_Ey(i, j, k);
                 },
+
                 [=] AMREX_GPU_DEVICE (int i, int j, int k){
-                    Ez(i, j, k) += c2 * dt * T_Algo::UpwardDz(F, coefs_z, n_coefs_z, i, j, k);
+                    // Skip field push if this cell is fully covered by embedded boundaries
+                    if (lz(i, j, k) <= 0) return;
+                    update_Ez(i, j, k);
                 }
-
             );
-
         }
+#else
+        FusedComponentFor(tex, tey, tez, update_Ex, update_Ey, update_Ez);
+#endif
 
         if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
         {
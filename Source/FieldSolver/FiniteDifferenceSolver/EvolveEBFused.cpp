@@ -0,0 +1,199 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "FiniteDifferenceSolver.H"
+
+#ifndef WARPX_DIM_RZ
+#   include "FiniteDifferenceAlgorithms/CartesianYeeAlgorithm.H"
+#   include "FiniteDifferenceAlgorithms/CartesianCKCAlgorithm.H"
+#endif
+#include "Utils/WarpXAlgorithmSelection.H"
+#include "Utils/WarpXConst.H"
+#include "WarpX.H"
+
+#include <AMReX.H>
+#include <AMReX_Array4.H>
+#include <AMReX_BLassert.H>
+#include <AMReX_Box.H>
+#include <AMReX_Config.H>
+#include <AMReX_GpuAtomic.H>
+#include <AMReX_GpuContainers.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_GpuQualifiers.H>
+#include <AMReX_IndexType.H>
+#include <AMReX_IntVect.H>
+#include <AMReX_LayoutData.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_REAL.H>
+#include <AMReX_Utility.H>
+
+#include <AMReX_BaseFwd.H>
+
+#include <array>
+#include <memory>
+
+using namespace amrex;
+
+/**
+ * \brief Update B over dt/2, E over dt and B over dt/2, box by box
+ */
+void FiniteDifferenceSolver::EvolveEBFused (
+    std::array< std::unique_ptr<amrex::MultiFab>, 3 >& Bfield,
+    std::array< std::unique_ptr<amrex::MultiFab>, 3 >& Efield,
+    std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Jfield,
+    int lev, amrex::Real const dt ) {
+
+   // Select algorithm (The choice of algorithm is a runtime option,
+   // but we compile code for each algorithm, using templates)
+#ifdef WARPX_DIM_RZ
+    amrex::ignore_unused(Bfield, Efield, Jfield, lev, dt);
+    amrex::Abort("EvolveEBFused: not implemented in RZ geometry");
+#else
+    if (m_do_nodal) {
+
+        amrex::Abort("EvolveEBFused: not implemented for nodal grids");
+
+    } else if (m_fdtd_algo == MaxwellSolverAlgo::Yee) {
+
+        EvolveEBFusedCartesian <CartesianYeeAlgorithm> ( Bfield, Efield, Jfield, lev, dt );
+
+    } else if (m_fdtd_algo == MaxwellSolverAlgo::CKC) {
+
+        EvolveEBFusedCartesian <CartesianCKCAlgorithm> ( Bfield, Efield, Jfield, lev, dt );
+
+    } else {
+        amrex::Abort("EvolveEBFused: Unknown algorithm");
+    }
+#endif
+}
+
+
+#ifndef WARPX_DIM_RZ
+
+template<typename T_Algo>
+void FiniteDifferenceSolver::EvolveEBFusedCartesian (
+    std::array< std::unique_ptr<amrex::MultiFab>, 3 >& Bfield,
+    std::array< std::unique_ptr<amrex::MultiFab>, 3 >& Efield,
+    std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Jfield,
+    int lev, amrex::Real const dt ) {
+
+    // The stencils of the Yee and CKC algorithms extend over one cell in each direction. In
+    // order to update B over the valid cells at the end, E is updated over the valid cells
+    // and one guard cell, which requires B at half step over two guard cells, and thus E and J
+    // (at the beginning of the step) over three guard cells and one guard cell respectively.
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+        Efield[0]->nGrowVect().allGE(IntVect(3)) && Bfield[0]->nGrowVect().allGE(IntVect(2)) &&
+        Jfield[0]->nGrowVect().allGE(IntVect(1)),
+        "EvolveEBFused: not enough guard cells");
+
+    amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
+    Real constexpr c2 = PhysConst::c * PhysConst::c;
+    Real const half_dt = 0.5_rt * dt;
+
+    // Loop through the grids. The guard cells of each grid are updated as well, so that
+    // the grids cannot be split in tiles.
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for ( MFIter mfi(*Bfield[0], false); mfi.isValid(); ++mfi ) {
+        if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+        {
+            amrex::Gpu::synchronize();
+        }
+        Real wt = amrex::second();
+
+        // Extract field data for this grid
+        Array4<Real> const& Bx = Bfield[0]->array(mfi);
+        Array4<Real> const& By = Bfield[1]->array(mfi);
+        Array4<Real> const& Bz = Bfield[2]->array(mfi);
+        Array4<Real> const& Ex = Efield[0]->array(mfi);
+        Array4<Real> const& Ey = Efield[1]->array(mfi);
+        Array4<Real> const& Ez = Efield[2]->array(mfi);
+        Array4<Real> const& jx = Jfield[0]->array(mfi);
+        Array4<Real> const& jy = Jfield[1]->array(mfi);
+        Array4<Real> const& jz = Jfield[2]->array(mfi);
+
+        // Extract stencil coefficients
+        Real const * const AMREX_RESTRICT coefs_x = m_stencil_coefs_x.dataPtr();
+        int const n_coefs_x = m_stencil_coefs_x.size();
+        Real const * const AMREX_RESTRICT coefs_y = m_stencil_coefs_y.dataPtr();
+        int const n_coefs_y = m_stencil_coefs_y.size();
+        Real const * const AMREX_RESTRICT coefs_z = m_stencil_coefs_z.dataPtr();
+        int const n_coefs_z = m_stencil_coefs_z.size();
+
+        // First half step of B (over two guard cells), full step of E (over one guard cell),
+        // second half step of B (over the valid cells)
+        for (int stage = 0; stage < 3; ++stage)
+        {
+            if (stage == 1)
+            {
+                Box const tex = amrex::grow(amrex::convert(mfi.validbox(), Efield[0]->ixType()), IntVect(1));
+                Box const tey = amrex::grow(amrex::convert(mfi.validbox(), Efield[1]->ixType()), IntVect(1));
+                Box const tez = amrex::grow(amrex::convert(mfi.validbox(), Efield[2]->ixType()), IntVect(1));
+
+                amrex::ParallelFor(tex, tey, tez,
+
+                    [=] AMREX_GPU_DEVICE (int i, int j, int k){
+                        Ex(i, j, k) += c2 * dt * (
+                            - T_Algo::DownwardDz(By, coefs_z, n_coefs_z, i, j, k)
+                            + T_Algo::DownwardDy(Bz, coefs_y, n_coefs_y, i, j, k)
+                            - PhysConst::mu0 * jx(i, j, k) );
+                    },
+
+                    [=] AMREX_GPU_DEVICE (int i, int j, int k){
+                        Ey(i, j, k) += c2 * dt * (
+                            - T_Algo::DownwardDx(Bz, coefs_x, n_coefs_x, i, j, k)
+                            + T_Algo::DownwardDz(Bx, coefs_z, n_coefs_z, i, j, k)
+                            - PhysConst::mu0 * jy(i, j, k) );
+                    },
+
+                    [=] AMREX_GPU_DEVICE (int i, int j, int k){
+                        Ez(i, j, k) += c2 * dt * (
+                            - T_Algo::DownwardDy(Bx, coefs_y, n_coefs_y, i, j, k)
+                            + T_Algo::DownwardDx(By, coefs_x, n_coefs_x, i, j, k)
+                            - PhysConst::mu0 * jz(i, j, k) );
+                    }
+                );
+            }
+            else
+            {
+                IntVect const ng = (stage == 0) ? IntVect(2) : IntVect(0);
+                Box const tbx = amrex::grow(amrex::convert(mfi.validbox(), Bfield[0]->ixType()), ng);
+                Box const tby = amrex::grow(amrex::convert(mfi.validbox(), Bfield[1]->ixType()), ng);
+                Box const tbz = amrex::grow(amrex::convert(mfi.validbox(), Bfield[2]->ixType()), ng);
+
+                amrex::ParallelFor(tbx, tby, tbz,
+
+                    [=] AMREX_GPU_DEVICE (int i, int j, int k){
+                        Bx(i, j, k) += half_dt * T_Algo::UpwardDz(Ey, coefs_z, n_coefs_z, i, j, k)
+                                     - half_dt * T_Algo::UpwardDy(Ez, coefs_y, n_coefs_y, i, j, k);
+                    },
+
+                    [=] AMREX_GPU_DEVICE (int i, int j, int k){
+                        By(i, j, k) += half_dt * T_Algo::UpwardDx(Ez, coefs_x, n_coefs_x, i, j, k)
+                                     - half_dt * T_Algo::UpwardDz(Ex, coefs_z, n_coefs_z, i, j, k);
+                    },
+
+                    [=] AMREX_GPU_DEVICE (int i, int j, int k){
+                        Bz(i, j, k) += half_dt * T_Algo::UpwardDy(Ex, coefs_y, n_coefs_y, i, j, k)
+                                     - half_dt * T_Algo::UpwardDx(Ey, coefs_x, n_coefs_x, i, j, k);
+                    }
+                );
+            }
+        }
+
+        if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+        {
+            amrex::Gpu::synchronize();
+            wt = amrex::second() - wt;
+            amrex::HostDevice::Atomic::Add( &(*cost)[mfi.index()], wt);
+        }
+    }
+}
+
+#endif // corresponds to ifndef WARPX_DIM_RZ
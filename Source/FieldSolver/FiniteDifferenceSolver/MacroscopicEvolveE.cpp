@@ -15,8 +15,11 @@
 
 #include <AMReX.H>
 #include <AMReX_Array4.H>
+#include <AMReX_BaseFab.H>
 #include <AMReX_Config.H>
 #include <AMReX_Extension.H>
+#include <AMReX_FabArray.H>
+#include <AMReX_FArrayBox.H>
 #include <AMReX_GpuContainers.H>
 #include <AMReX_GpuControl.H>
 #include <AMReX_GpuLaunch.H>
@@ -47,21 +50,27 @@ void FiniteDifferenceSolver::MacroscopicEvolveE (
     amrex::ignore_unused(Efield, Bfield, Jfield, dt, macroscopic_properties, lev);
     amrex::Abort("currently macro E-push does not work for RZ");
 #else
+    // The coefficients of the update only depend on the medium and on dt:
+    // they are computed once, and again only when dt or the grids change
+    macroscopic_properties->UpdateCoefficients(lev, dt);
+    const bool single_precision = macroscopic_properties->m_single_precision_coefficients;
+
     if (m_do_nodal) {
         amrex::Abort(" macro E-push does not work for nodal ");
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::Yee) {
 
-        if (WarpX::macroscopic_solver_algo == MacroscopicSolverAlgo::LaxWendroff) {
+        if (single_precision) {
 
-            MacroscopicEvolveECartesian <CartesianYeeAlgorithm, LaxWendroffAlgo>
-                       ( Efield, Bfield, Jfield, dt, macroscopic_properties, lev );
+            MacroscopicEvolveECartesian <CartesianYeeAlgorithm, amrex::BaseFab<float>>
+                       ( Efield, Bfield, Jfield, macroscopic_properties->m_E_coefs_sp,
+                         macroscopic_properties->m_inv_mu_sp );
 
-        }
-        if (WarpX::macroscopic_solver_algo == MacroscopicSolverAlgo::BackwardEuler) {
+        } else {
 
-            MacroscopicEvolveECartesian <CartesianYeeAlgorithm, BackwardEulerAlgo>
-                       ( Efield, Bfield, Jfield, dt, macroscopic_properties, lev );
+            MacroscopicEvolveECartesian <CartesianYeeAlgorithm, amrex::FArrayBox>
+                       ( Efield, Bfield, Jfield, macroscopic_properties->m_E_coefs,
+                         macroscopic_properties->m_inv_mu );
 
         }
 
@@ -69,15 +78,17 @@ void FiniteDifferenceSolver::MacroscopicEvolveE (
 
         // Note : EvolveE is the same for CKC and Yee.
         // In the templated Yee and CKC calls, the core operations for EvolveE is the same.
-        if (WarpX::macroscopic_solver_algo == MacroscopicSolverAlgo::LaxWendroff) {
+        if (single_precision) {
 
-            MacroscopicEvolveECartesian <CartesianCKCAlgorithm, LaxWendroffAlgo>
-                       ( Efield, Bfield, Jfield, dt, macroscopic_properties, lev );
+            MacroscopicEvolveECartesian <CartesianCKCAlgorithm, amrex::BaseFab<float>>
+                       ( Efield, Bfield, Jfield, macroscopic_properties->m_E_coefs_sp,
+                         macroscopic_properties->m_inv_mu_sp );
 
-        } else if (WarpX::macroscopic_solver_algo == MacroscopicSolverAlgo::BackwardEuler) {
+        } else {
 
-            MacroscopicEvolveECartesian <CartesianCKCAlgorithm, BackwardEulerAlgo>
-                       ( Efield, Bfield, Jfield, dt, macroscopic_properties, lev );
+            MacroscopicEvolveECartesian <CartesianCKCAlgorithm, amrex::FArrayBox>
+                       ( Efield, Bfield, Jfield, macroscopic_properties->m_E_coefs,
+                         macroscopic_properties->m_inv_mu );
 
         }
 
@@ -91,28 +102,15 @@ void FiniteDifferenceSolver::MacroscopicEvolveE (
 
 #ifndef WARPX_DIM_RZ
 
-template<typename T_Algo, typename T_MacroAlgo>
+template<typename T_Algo, typename T_CoefFab>
 void FiniteDifferenceSolver::MacroscopicEvolveECartesian (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 >& Efield,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Bfield,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Jfield,
-    amrex::Real const dt,
-    std::unique_ptr<MacroscopicProperties> const& macroscopic_properties, int const lev)
+    std::array< std::unique_ptr<amrex::FabArray<T_CoefFab>>, 3 > const& E_coefs,
+    std::array< std::unique_ptr<amrex::FabArray<T_CoefFab>>, 3 > const& inv_mu)
 {
-
-    amrex::GpuArray<int, 3> const& Ex_stag = macroscopic_properties->Ex_IndexType;
-    amrex::GpuArray<int, 3> const& Ey_stag = macroscopic_properties->Ey_IndexType;
-    amrex::GpuArray<int, 3> const& Ez_stag = macroscopic_properties->Ez_IndexType;
-    amrex::GpuArray<int, 3> const& Bx_stag = macroscopic_properties->Bx_IndexType;
-    amrex::GpuArray<int, 3> const& By_stag = macroscopic_properties->By_IndexType;
-    amrex::GpuArray<int, 3> const& Bz_stag = macroscopic_properties->Bz_IndexType;
-
-    const auto getSigma = GetSigmaMacroparameter();
-    const auto getEpsilon = GetEpsilonMacroparameter();
-    const auto getMu = GetMuMacroparameter();
-    auto &warpx = WarpX::GetInstance();
-    const auto problo = warpx.Geom(lev).ProbLoArray();
-    const auto dx = warpx.Geom(lev).CellSizeArray();
+    using T = typename T_CoefFab::value_type;
 
     // Loop through the grids, and over the tiles within each grid
 #ifdef AMREX_USE_OMP
@@ -131,6 +129,11 @@ void FiniteDifferenceSolver::MacroscopicEvolveECartesian (
         Array4<Real> const& jy = Jfield[1]->array(mfi);
         Array4<Real> const& jz = Jfield[2]->array(mfi);
 
+        // Extract the precomputed coefficients (alpha in component 0, beta in component 1)
+        Array4<T const> const& cx = E_coefs[0]->const_array(mfi);
+        Array4<T const> const& cy = E_coefs[1]->const_array(mfi);
+        Array4<T const> const& cz = E_coefs[2]->const_array(mfi);
+
         // Extract stencil coefficients
         Real const * const AMREX_RESTRICT coefs_x = m_stencil_coefs_x.dataPtr();
         int const n_coefs_x = m_stencil_coefs_x.size();
@@ -139,9 +142,10 @@ void FiniteDifferenceSolver::MacroscopicEvolveECartesian (
         Real const * const AMREX_RESTRICT coefs_z = m_stencil_coefs_z.dataPtr();
         int const n_coefs_z = m_stencil_coefs_z.size();
 
-        FieldAccessorMacroscopic<GetMuMacroparameter> const Hx(Bx, getMu, Bx_stag, problo, dx);
-        FieldAccessorMacroscopic<GetMuMacroparameter> const Hy(By, getMu, By_stag, problo, dx);
-        FieldAccessorMacroscopic<GetMuMacroparameter> const Hz(Bz, getMu, Bz_stag, problo, dx);
+        // H = B/mu, with the precomputed 1/mu
+        FieldAccessorScaled<T> const Hx(Bx, inv_mu[0]->const_array(mfi));
+        FieldAccessorScaled<T> const Hy(By, inv_mu[1]->const_array(mfi));
+        FieldAccessorScaled<T> const Hz(Bz, inv_mu[2]->const_array(mfi));
 
         // Extract tileboxes for which to loop
         Box const& tex  = mfi.tilebox(Efield[0]->ixType().toIntVect());
@@ -150,13 +154,8 @@ void FiniteDifferenceSolver::MacroscopicEvolveECartesian (
         // Loop over the cells and update the fields
         amrex::ParallelFor(tex, tey, tez,
             [=] AMREX_GPU_DEVICE (int i, int j, int k){
-                amrex::Real x, y, z;
-                WarpXUtilAlgo::getCellCoordinates (i, j, k, Ex_stag, problo, dx,
-                                                   x, y, z );
-                amrex::Real const sigma = getSigma(x, y, z);
-                amrex::Real const epsilon = getEpsilon(x, y, z);
-                amrex::Real alpha = T_MacroAlgo::alpha( sigma, epsilon, dt);
-                amrex::Real beta = T_MacroAlgo::beta( sigma, epsilon, dt);
+                amrex::Real const alpha = static_cast<amrex::Real>(cx(i, j, k, 0));
+                amrex::Real const beta = static_cast<amrex::Real>(cx(i, j, k, 1));
                 Ex(i, j, k) = alpha * Ex(i, j, k)
                             + beta * ( - T_Algo::DownwardDz(Hy, coefs_z, n_coefs_z, i, j, k,0)
                                        + T_Algo::DownwardDy(Hz, coefs_y, n_coefs_y, i, j, k,0)
@@ -164,14 +163,8 @@ void FiniteDifferenceSolver::MacroscopicEvolveECartesian (
             },
 
             [=] AMREX_GPU_DEVICE (int i, int j, int k){
-                amrex::Real x, y, z;
-                WarpXUtilAlgo::getCellCoordinates (i, j, k, Ey_stag, problo, dx,
-                                                   x, y, z );
-                amrex::Real const sigma = getSigma(x, y, z);
-                amrex::Real const epsilon = getEpsilon(x, y, z);
-                amrex::Real alpha = T_MacroAlgo::alpha( sigma, epsilon, dt);
-                amrex::Real beta = T_MacroAlgo::beta( sigma, epsilon, dt);
-
+                amrex::Real const alpha = static_cast<amrex::Real>(cy(i, j, k, 0));
+                amrex::Real const beta = static_cast<amrex::Real>(cy(i, j, k, 1));
                 Ey(i, j, k) = alpha * Ey(i, j, k)
                             + beta * ( - T_Algo::DownwardDx(Hz, coefs_x, n_coefs_x, i, j, k,0)
                                        + T_Algo::DownwardDz(Hx, coefs_z, n_coefs_z, i, j, k,0)
@@ -179,14 +172,8 @@ void FiniteDifferenceSolver::MacroscopicEvolveECartesian (
             },
 
             [=] AMREX_GPU_DEVICE (int i, int j, int k){
-                amrex::Real x, y, z;
-                WarpXUtilAlgo::getCellCoordinates (i, j, k, Ez_stag, problo, dx,
-                                                   x, y, z );
-                amrex::Real const sigma = getSigma(x, y, z);
-                amrex::Real const epsilon = getEpsilon(x, y, z);
-                amrex::Real alpha = T_MacroAlgo::alpha( sigma, epsilon, dt);
-                amrex::Real beta = T_MacroAlgo::beta( sigma, epsilon, dt);
-
+                amrex::Real const alpha = static_cast<amrex::Real>(cz(i, j, k, 0));
+                amrex::Real const beta = static_cast<amrex::Real>(cz(i, j, k, 1));
                 Ez(i, j, k) = alpha * Ez(i, j, k)
                             + beta * ( - T_Algo::DownwardDy(Hx, coefs_y, n_coefs_y, i, j, k,0)
                                        + T_Algo::DownwardDx(Hy, coefs_x, n_coefs_x, i, j, k,0)
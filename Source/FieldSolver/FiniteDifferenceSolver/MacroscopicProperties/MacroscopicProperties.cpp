@@ -1,13 +1,17 @@
 #include "MacroscopicProperties.H"
 
+#include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXUtil.H"
 #include "WarpX.H"
 
 #include <AMReX_Array4.H>
+#include <AMReX_BaseFab.H>
 #include <AMReX_BoxArray.H>
 #include <AMReX_Config.H>
 #include <AMReX_DistributionMapping.H>
+#include <AMReX_FabArray.H>
 #include <AMReX_Geometry.H>
+#include <AMReX_GpuControl.H>
 #include <AMReX_GpuLaunch.H>
 #include <AMReX_IndexType.H>
 #include <AMReX_IntVect.H>
@@ -23,6 +27,92 @@
 
 using namespace amrex;
 
+namespace
+{
+    /**
+     * \brief Fill alpha (component 0) and beta (component 1) of the macroscopic E update,
+     * including in the guard cells
+     */
+    template< typename T_MacroAlgo, typename T_CoefFab >
+    void ComputeECoefficients (amrex::FabArray<T_CoefFab>& coefs,
+                               amrex::GpuArray<int, 3> const stag,
+                               amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const problo,
+                               amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const dx,
+                               amrex::Real const dt)
+    {
+        using T = typename T_CoefFab::value_type;
+        const auto getSigma = GetSigmaMacroparameter();
+        const auto getEpsilon = GetEpsilonMacroparameter();
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+        for ( MFIter mfi(coefs, TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
+            Array4<T> const& c = coefs.array(mfi);
+            amrex::ParallelFor(mfi.growntilebox(),
+                [=] AMREX_GPU_DEVICE (int i, int j, int k){
+                    amrex::Real x, y, z;
+                    WarpXUtilAlgo::getCellCoordinates (i, j, k, stag, problo, dx, x, y, z);
+                    amrex::Real const sigma = getSigma(x, y, z);
+                    amrex::Real const epsilon = getEpsilon(x, y, z);
+                    c(i, j, k, 0) = static_cast<T>(T_MacroAlgo::alpha(sigma, epsilon, dt));
+                    c(i, j, k, 1) = static_cast<T>(T_MacroAlgo::beta(sigma, epsilon, dt));
+                });
+        }
+    }
+
+    /** \brief Fill the inverse of the permeability, including in the guard cells */
+    template< typename T_CoefFab >
+    void ComputeInvMu (amrex::FabArray<T_CoefFab>& inv_mu,
+                       amrex::GpuArray<int, 3> const stag,
+                       amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const problo,
+                       amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const dx)
+    {
+        using namespace amrex::literals;
+        using T = typename T_CoefFab::value_type;
+        const auto getMu = GetMuMacroparameter();
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+        for ( MFIter mfi(inv_mu, TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
+            Array4<T> const& m = inv_mu.array(mfi);
+            amrex::ParallelFor(mfi.growntilebox(),
+                [=] AMREX_GPU_DEVICE (int i, int j, int k){
+                    amrex::Real x, y, z;
+                    WarpXUtilAlgo::getCellCoordinates (i, j, k, stag, problo, dx, x, y, z);
+                    m(i, j, k) = static_cast<T>(1._rt / getMu(x, y, z));
+                });
+        }
+    }
+
+    /** \brief Allocate and fill the coefficients of the E update, stored in FabArray<T_CoefFab> */
+    template< typename T_CoefFab >
+    void ComputeCoefficients (
+        std::array< std::unique_ptr<amrex::FabArray<T_CoefFab>>, 3 >& E_coefs,
+        std::array< std::unique_ptr<amrex::FabArray<T_CoefFab>>, 3 >& inv_mu,
+        std::array< amrex::GpuArray<int, 3>, 3 > const& E_stag,
+        std::array< amrex::GpuArray<int, 3>, 3 > const& B_stag,
+        int const lev, amrex::Real const dt)
+    {
+        auto & warpx = WarpX::GetInstance();
+        const auto problo = warpx.Geom(lev).ProbLoArray();
+        const auto dx = warpx.Geom(lev).CellSizeArray();
+        for (int i = 0; i < 3; ++i) {
+            const amrex::MultiFab& E = warpx.getEfield_fp(lev, i);
+            const amrex::MultiFab& B = warpx.getBfield_fp(lev, i);
+            E_coefs[i] = std::make_unique<amrex::FabArray<T_CoefFab>>(
+                E.boxArray(), E.DistributionMap(), 2, E.nGrowVect());
+            inv_mu[i] = std::make_unique<amrex::FabArray<T_CoefFab>>(
+                B.boxArray(), B.DistributionMap(), 1, B.nGrowVect());
+            if (WarpX::macroscopic_solver_algo == MacroscopicSolverAlgo::LaxWendroff) {
+                ComputeECoefficients<LaxWendroffAlgo>(*E_coefs[i], E_stag[i], problo, dx, dt);
+            } else {
+                ComputeECoefficients<BackwardEulerAlgo>(*E_coefs[i], E_stag[i], problo, dx, dt);
+            }
+            ComputeInvMu(*inv_mu[i], B_stag[i], problo, dx);
+        }
+    }
+}
+
 GetSigmaMacroparameter::GetSigmaMacroparameter () noexcept
 {
     auto& warpx = WarpX::GetInstance();
@@ -153,6 +243,11 @@ MacroscopicProperties::ReadParameters ()
                                  makeParser(m_str_mu_function,{"x","y","z"}));
     }
 
+
+    // The coefficients of the E update can be stored in single precision,
+    // to reduce the memory traffic of the macroscopic E update
+    pp_macroscopic.query("single_precision_coefficients", m_single_precision_coefficients);
+
 }
 
 void
@@ -188,3 +283,27 @@ MacroscopicProperties::InitData ()
 
 
 }
+
+void
+MacroscopicProperties::UpdateCoefficients (int const lev, amrex::Real const dt)
+{
+    auto & warpx = WarpX::GetInstance();
+    const amrex::BoxArray& ba = warpx.boxArray(lev);
+    const amrex::DistributionMapping& dm = warpx.DistributionMap(lev);
+    const bool allocated = m_single_precision_coefficients ? (m_E_coefs_sp[0] != nullptr)
+                                                           : (m_E_coefs[0] != nullptr);
+    // The medium does not depend on time: the coefficients only need to be
+    // recomputed when the time step or the grids (e.g. after a regrid) change
+    if (allocated && dt == m_coefs_dt && ba == m_coefs_ba && dm == m_coefs_dm) return;
+
+    const std::array< amrex::GpuArray<int, 3>, 3 > E_stag{{Ex_IndexType, Ey_IndexType, Ez_IndexType}};
+    const std::array< amrex::GpuArray<int, 3>, 3 > B_stag{{Bx_IndexType, By_IndexType, Bz_IndexType}};
+    if (m_single_precision_coefficients) {
+        ComputeCoefficients(m_E_coefs_sp, m_inv_mu_sp, E_stag, B_stag, lev, dt);
+    } else {
+        ComputeCoefficients(m_E_coefs, m_inv_mu, E_stag, B_stag, lev, dt);
+    }
+    m_coefs_dt = dt;
+    m_coefs_ba = ba;
+    m_coefs_dm = dm;
+}
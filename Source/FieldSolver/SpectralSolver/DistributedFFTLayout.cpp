@@ -0,0 +1,79 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "DistributedFFTLayout.H"
+
+#include <AMReX_BLassert.H>
+#include <AMReX_BoxList.H>
+#include <AMReX_IndexType.H>
+#include <AMReX_IntVect.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Vector.H>
+
+#include <algorithm>
+
+using namespace amrex;
+
+namespace
+{
+    /** \brief Split the box bx in (at most) nslabs slabs of nearly equal size along dim,
+     *  and assign the slab i to the MPI rank i */
+    void
+    SplitInSlabs (const Box& bx, const int dim, const int nslabs,
+                  BoxArray& ba, DistributionMapping& dm)
+    {
+        const int n = bx.length(dim);
+        const int nb = std::min(nslabs, n);
+        BoxList bl;
+        Vector<int> pmap;
+        for (int i = 0; i < nb; ++i) {
+            Box slab = bx;
+            slab.setSmall(dim, bx.smallEnd(dim) + (i*n)/nb);
+            slab.setBig(dim, bx.smallEnd(dim) + ((i+1)*n)/nb - 1);
+            bl.push_back(slab);
+            pmap.push_back(i);
+        }
+        ba.define(bl);
+        dm.define(pmap);
+    }
+}
+
+DistributedFFTLayout::DistributedFFTLayout (const Box& domain)
+    : defined(true), realspace_domain(domain)
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+        domain.ixType() == IndexType::TheCellType(),
+        "DistributedFFTLayout expects a cell-centered domain.");
+
+    const int nprocs = ParallelDescriptor::NProcs();
+    constexpr int last_dim = AMREX_SPACEDIM-1;
+#if (AMREX_SPACEDIM == 3)
+    constexpr int transposed_dim = 1;
+#else
+    constexpr int transposed_dim = 0;
+#endif
+
+    // Real-space slabs along the last dimension
+    SplitInSlabs(domain, last_dim, nprocs, real_slabs_ba, slabs_dm);
+
+    // Same slabs in spectral space: because of the real-to-complex FFTs,
+    // only the positive k are kept along the first dimension
+    const IntVect fft_size = domain.length();
+    IntVect spectral_size = fft_size;
+    spectral_size[0] = fft_size[0]/2 + 1;
+    const Box spectral_domain(IntVect::TheZeroVector(), spectral_size - IntVect::TheUnitVector());
+    BoxList complex_bl;
+    for (int i = 0; i < real_slabs_ba.size(); ++i) {
+        Box slab = spectral_domain;
+        slab.setSmall(last_dim, real_slabs_ba[i].smallEnd(last_dim) - domain.smallEnd(last_dim));
+        slab.setBig(last_dim, real_slabs_ba[i].bigEnd(last_dim) - domain.smallEnd(last_dim));
+        complex_bl.push_back(slab);
+    }
+    complex_slabs_ba.define(complex_bl);
+
+    // Transposed slabs in spectral space
+    SplitInSlabs(spectral_domain, transposed_dim, nprocs, spectral_ba, spectral_dm);
+}
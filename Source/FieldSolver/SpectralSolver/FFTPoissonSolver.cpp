@@ -0,0 +1,282 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "FFTPoissonSolver.H"
+
+#include "Utils/WarpXConst.H"
+#include "Utils/WarpXProfilerWrapper.H"
+
+#include <AMReX_Array4.H>
+#include <AMReX_BLassert.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_GpuQualifiers.H>
+#include <AMReX_IndexType.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Periodicity.H>
+#include <AMReX_Vector.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+namespace
+{
+#if (AMREX_SPACEDIM == 3)
+    /** \brief Primitive (along x, y and z) of 1/r, the potential of a point charge */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    Real PrimitiveGreenFunction (const Real x, const Real y, const Real z) noexcept
+    {
+        using namespace amrex::literals;
+        const Real r = std::sqrt(x*x + y*y + z*z);
+        return - 0.5_rt*z*z*std::atan(x*y/(z*r))
+               - 0.5_rt*y*y*std::atan(x*z/(y*r))
+               - 0.5_rt*x*x*std::atan(y*z/(x*r))
+               + y*z*std::asinh(x/std::sqrt(y*y + z*z))
+               + x*z*std::asinh(y/std::sqrt(x*x + z*z))
+               + x*y*std::asinh(z/std::sqrt(x*x + y*y));
+    }
+
+    /** \brief Potential at (x,y,z) of a uniform unit charge density in the cell of size
+     * (hx,hy,hz) centered on the origin (integrated Green function) */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    Real IntegratedGreenFunction (const Real x, const Real y, const Real z,
+                                  const Real hx, const Real hy, const Real hz) noexcept
+    {
+        using namespace amrex::literals;
+        Real G = 0._rt;
+        for (int ix = 0; ix < 2; ++ix) {
+            for (int iy = 0; iy < 2; ++iy) {
+                for (int iz = 0; iz < 2; ++iz) {
+                    const Real sign = ((ix+iy+iz) % 2 == 1) ? 1._rt : -1._rt;
+                    G += sign*PrimitiveGreenFunction(
+                        x + (ix-0.5_rt)*hx, y + (iy-0.5_rt)*hy, z + (iz-0.5_rt)*hz);
+                }
+            }
+        }
+        return G/(4._rt*MathConst::pi*PhysConst::ep0);
+    }
+#else
+    /** \brief Primitive (along x and z) of ln(x^2+z^2), the potential of a line charge */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    Real PrimitiveGreenFunction (const Real x, const Real z) noexcept
+    {
+        using namespace amrex::literals;
+        return x*z*(std::log(x*x + z*z) - 3._rt)
+               + x*x*std::atan(z/x) + z*z*std::atan(x/z);
+    }
+
+    /** \brief Potential at (x,z) of a uniform unit charge density in the cell of size
+     * (hx,hz) centered on the origin (integrated Green function) */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    Real IntegratedGreenFunction (const Real x, const Real z,
+                                  const Real hx, const Real hz) noexcept
+    {
+        using namespace amrex::literals;
+        Real G = 0._rt;
+        for (int ix = 0; ix < 2; ++ix) {
+            for (int iz = 0; iz < 2; ++iz) {
+                const Real sign = ((ix+iz) % 2 == 0) ? 1._rt : -1._rt;
+                G += sign*PrimitiveGreenFunction(x + (ix-0.5_rt)*hx, z + (iz-0.5_rt)*hz);
+            }
+        }
+        return -G/(4._rt*MathConst::pi*PhysConst::ep0);
+    }
+#endif
+}
+
+FFTPoissonSolver::FFTPoissonSolver (const Geometry& geom, const IntVect& ngrow,
+                                    const std::array<Real,3>& beta)
+    : m_geom(geom), m_ngrow(ngrow), m_beta(beta)
+{
+    m_periodic = geom.isAllPeriodic();
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_periodic || !geom.isAnyPeriodic(),
+        "warpx.poisson_solver = fft requires a domain that is either "
+        "periodic or non-periodic along all directions");
+
+    const Box& domain = geom.Domain();
+    if (m_periodic) {
+        // The last node of the domain is the periodic image of the first one
+        m_fft_box = Box(domain.smallEnd(), domain.bigEnd(), IndexType::TheNodeType());
+    } else {
+        // Nodes of the domain and of the guard cells of phi, doubled with zeros,
+        // so that the periodic convolution of the FFTs is that of the free space
+        const IntVect n_nodes = domain.length() + 1;
+        const IntVect lo = domain.smallEnd() - ngrow;
+        m_fft_box = Box(lo, lo + 2*(n_nodes + ngrow) - 1, IndexType::TheNodeType());
+    }
+
+    // One box, owned by the I/O processor
+    const BoxArray real_ba(m_fft_box);
+    const IntVect fft_size = m_fft_box.length();
+    IntVect spectral_size = fft_size;
+    spectral_size[0] = fft_size[0]/2 + 1;
+    const BoxArray spectral_ba(Box(IntVect(0), spectral_size - 1));
+    const DistributionMapping dm(Vector<int>{ParallelDescriptor::IOProcessorNumber()});
+
+    m_real_field.define(real_ba, dm, 1, 0);
+    m_spectral_field.define(spectral_ba, dm, 1, 0);
+
+    m_forward_plan = AnyFFT::FFTplans(real_ba, dm);
+    m_backward_plan = AnyFFT::FFTplans(real_ba, dm);
+    for (MFIter mfi(m_real_field); mfi.isValid(); ++mfi) {
+        m_forward_plan[mfi] = AnyFFT::CreatePlan(
+            fft_size, m_real_field[mfi].dataPtr(),
+            reinterpret_cast<AnyFFT::Complex*>(m_spectral_field[mfi].dataPtr()),
+            AnyFFT::direction::R2C, AMREX_SPACEDIM);
+        m_backward_plan[mfi] = AnyFFT::CreatePlan(
+            fft_size, m_real_field[mfi].dataPtr(),
+            reinterpret_cast<AnyFFT::Complex*>(m_spectral_field[mfi].dataPtr()),
+            AnyFFT::direction::C2R, AMREX_SPACEDIM);
+    }
+
+    if (!m_periodic) {
+        m_green.define(spectral_ba, dm, 1, 0);
+        ComputeGreenFunction();
+    }
+}
+
+FFTPoissonSolver::~FFTPoissonSolver ()
+{
+    for (MFIter mfi(m_real_field); mfi.isValid(); ++mfi) {
+        AnyFFT::DestroyPlan(m_forward_plan[mfi]);
+        AnyFFT::DestroyPlan(m_backward_plan[mfi]);
+    }
+}
+
+bool
+FFTPoissonSolver::isValidFor (const Geometry& geom, const IntVect& ngrow,
+                              const std::array<Real,3>& beta) const
+{
+    bool same_cell_size = true;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        same_cell_size = same_cell_size && (geom.CellSize(idim) == m_geom.CellSize(idim));
+    }
+    return same_cell_size && geom.Domain() == m_geom.Domain() &&
+        geom.periodicity() == m_geom.periodicity() && ngrow == m_ngrow && beta == m_beta;
+}
+
+void
+FFTPoissonSolver::ComputeGreenFunction ()
+{
+    // Cell size in the coordinates stretched by 1/sqrt(1-beta_i^2), in which the
+    // Poisson equation (with the term in beta) is the free-space Poisson equation
+    const Real hx = m_geom.CellSize(0)/std::sqrt(1._rt - m_beta[0]*m_beta[0]);
+#if (AMREX_SPACEDIM == 3)
+    const Real hy = m_geom.CellSize(1)/std::sqrt(1._rt - m_beta[1]*m_beta[1]);
+    const Real hz = m_geom.CellSize(2)/std::sqrt(1._rt - m_beta[2]*m_beta[2]);
+#else
+    const Real hz = m_geom.CellSize(1)/std::sqrt(1._rt - m_beta[2]*m_beta[2]);
+#endif
+
+    // The offsets 0 to n_half-1 are positive, and the next ones are the negative offsets
+    // (periodic images), in the box of the FFTs
+    const IntVect n_fft = m_fft_box.length();
+    const IntVect n_half = m_geom.Domain().length() + 1 + m_ngrow;
+    const IntVect lo = m_fft_box.smallEnd();
+    // Normalization of the backward FFT
+    const Real inv_n_fft = 1._rt/AMREX_D_TERM(Real(n_fft[0]), *Real(n_fft[1]), *Real(n_fft[2]));
+
+    for (MFIter mfi(m_real_field); mfi.isValid(); ++mfi) {
+        Array4<Real> const& G = m_real_field.array(mfi);
+        ParallelFor(mfi.validbox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            int di = i - lo[0];
+            if (di >= n_half[0]) di -= n_fft[0];
+            int dj = j - lo[1];
+            if (dj >= n_half[1]) dj -= n_fft[1];
+#if (AMREX_SPACEDIM == 3)
+            int dk = k - lo[2];
+            if (dk >= n_half[2]) dk -= n_fft[2];
+            G(i,j,k) = inv_n_fft*IntegratedGreenFunction(di*hx, dj*hy, dk*hz, hx, hy, hz);
+#else
+            G(i,j,k) = inv_n_fft*IntegratedGreenFunction(di*hx, dj*hz, hx, hz);
+#endif
+        });
+
+        AnyFFT::Execute(m_forward_plan[mfi]);
+        m_green[mfi].copy<RunOn::Device>(m_spectral_field[mfi]);
+    }
+}
+
+void
+FFTPoissonSolver::MultiplyGreenFunction ()
+{
+    const IntVect n_fft = m_fft_box.length();
+    const Real inv_n_fft = 1._rt/AMREX_D_TERM(Real(n_fft[0]), *Real(n_fft[1]), *Real(n_fft[2]));
+    const Real dx = m_geom.CellSize(0);
+    const Real bx = m_beta[0];
+#if (AMREX_SPACEDIM == 3)
+    const Real dy = m_geom.CellSize(1);
+    const Real dz = m_geom.CellSize(2);
+    const Real by = m_beta[1];
+#else
+    const Real dz = m_geom.CellSize(1);
+#endif
+    const Real bz = m_beta[2];
+    const bool periodic = m_periodic;
+    constexpr Real pi = MathConst::pi;
+    constexpr Real ep0 = PhysConst::ep0;
+
+    for (MFIter mfi(m_spectral_field); mfi.isValid(); ++mfi) {
+        Array4<Complex> const& fields = m_spectral_field.array(mfi);
+        Array4<Complex const> const& green = periodic ?
+            Array4<Complex const>() : m_green.const_array(mfi);
+        ParallelFor(mfi.validbox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            if (!periodic) {
+                fields(i,j,k) *= green(i,j,k);
+                return;
+            }
+            // Wavenumbers of the (nodal, second-order) finite-difference Laplacian
+            // (the real-to-complex FFT only stores the non-negative i)
+            const Real kx = 2._rt/dx*std::sin(pi*i/n_fft[0]);
+#if (AMREX_SPACEDIM == 3)
+            const int jj = (j <= n_fft[1]/2) ? j : j - n_fft[1];
+            const int kk = (k <= n_fft[2]/2) ? k : k - n_fft[2];
+            const Real ky = 2._rt/dy*std::sin(pi*jj/n_fft[1]);
+            const Real kz = 2._rt/dz*std::sin(pi*kk/n_fft[2]);
+            const Real k2 = kx*kx + ky*ky + kz*kz;
+            const Real k_dot_beta = kx*bx + ky*by + kz*bz;
+#else
+            amrex::ignore_unused(k);
+            const int jj = (j <= n_fft[1]/2) ? j : j - n_fft[1];
+            const Real kz = 2._rt/dz*std::sin(pi*jj/n_fft[1]);
+            const Real k2 = kx*kx + kz*kz;
+            const Real k_dot_beta = kx*bx + kz*bz;
+#endif
+            if (k2 > 0._rt) {
+                fields(i,j,k) *= inv_n_fft/(ep0*(k2 - k_dot_beta*k_dot_beta));
+            } else {
+                // The mean value of phi is set to 0
+                fields(i,j,k) = Complex{0._rt, 0._rt};
+            }
+        });
+    }
+}
+
+void
+FFTPoissonSolver::Solve (const MultiFab& rho, MultiFab& phi)
+{
+    WARPX_PROFILE("FFTPoissonSolver::Solve()");
+
+    // Gather rho on the box of the FFTs (the zeros of the doubled non-periodic domain
+    // are not overwritten, and the last node of the periodic domain is not copied)
+    m_real_field.setVal(0._rt);
+    m_real_field.ParallelCopy(rho, 0, 0, 1);
+
+    for (MFIter mfi(m_real_field); mfi.isValid(); ++mfi) {
+        AnyFFT::Execute(m_forward_plan[mfi]);
+    }
+    MultiplyGreenFunction();
+    for (MFIter mfi(m_real_field); mfi.isValid(); ++mfi) {
+        AnyFFT::Execute(m_backward_plan[mfi]);
+    }
+
+    // Scatter phi on the distributed grids, including the guard cells
+    // (from the periodic images for the periodic domain)
+    phi.ParallelCopy(m_real_field, 0, 0, 1, IntVect(0), m_ngrow, m_geom.periodicity());
+}
@@ -518,7 +518,8 @@ ComovingPsatdAlgorithm::CurrentCorrection (const int lev,
 void
 ComovingPsatdAlgorithm::VayDeposition (const int /*lev*/,
                                        SpectralFieldData& /*field_data*/,
-                                       std::array<std::unique_ptr<amrex::MultiFab>,3>& /*current*/)
+                                       std::array<std::unique_ptr<amrex::MultiFab>,3>& /*current*/,
+                                       const bool /*backward_transform*/)
 {
     amrex::Abort("Vay deposition not implemented for comoving PSATD");
 }
@@ -50,7 +50,7 @@ GalileanPsatdAlgorithmRZ::GalileanPsatdAlgorithmRZ (SpectralKSpaceRZ const & spe
  * The algorithm is described in https://doi.org/10.1103/PhysRevE.94.053305
  * */
 void
-GalileanPsatdAlgorithmRZ::pushSpectralFields (SpectralFieldDataRZ & f)
+GalileanPsatdAlgorithmRZ::pushSpectralFields (SpectralFieldDataRZ & f, const bool filter_sources)
 {
 
     bool const update_with_rho = m_update_with_rho;
@@ -87,6 +87,14 @@ GalileanPsatdAlgorithmRZ::pushSpectralFields (SpectralFieldDataRZ & f)
         amrex::Real const* modified_kz_arr = modified_kz_vec[mfi].dataPtr();
         int const nr = bx.length(0);
 
+        // Extract pointers for the K space filter (only used if filter_sources)
+        amrex::Real const* filter_r_arr = nullptr;
+        amrex::Real const* filter_z_arr = nullptr;
+        if (filter_sources) {
+            filter_r_arr = f.getFilter(mfi).getFilterArrayR().dataPtr();
+            filter_z_arr = f.getFilter(mfi).getFilterArrayZ().dataPtr();
+        }
+
         // Loop over indices within one box
         // Note that k = 0
         int const modes = f.n_rz_azimuthal_modes;
@@ -115,11 +123,31 @@ GalileanPsatdAlgorithmRZ::pushSpectralFields (SpectralFieldDataRZ & f)
             Complex const Bm_old = fields(i,j,k,Bm_m);
             Complex const Bz_old = fields(i,j,k,Bz_m);
             // Shortcut for the values of J and rho
-            Complex const Jp = fields(i,j,k,Jp_m);
-            Complex const Jm = fields(i,j,k,Jm_m);
-            Complex const Jz = fields(i,j,k,Jz_m);
-            Complex const rho_old = fields(i,j,k,rho_old_m);
-            Complex const rho_new = fields(i,j,k,rho_new_m);
+            Complex Jp = fields(i,j,k,Jp_m);
+            Complex Jm = fields(i,j,k,Jm_m);
+            Complex Jz = fields(i,j,k,Jz_m);
+            Complex rho_old = fields(i,j,k,rho_old_m);
+            Complex rho_new = fields(i,j,k,rho_new_m);
+
+            // Apply the K space filter to J and rho, and store the filtered values
+            // (as ApplyFilter would have done)
+            if (filter_sources)
+            {
+                amrex::Real const filter = filter_r_arr[i + nr*mode]*filter_z_arr[j];
+                Jp *= filter;
+                Jm *= filter;
+                Jz *= filter;
+                fields(i,j,k,Jp_m) = Jp;
+                fields(i,j,k,Jm_m) = Jm;
+                fields(i,j,k,Jz_m) = Jz;
+                if (update_with_rho)
+                {
+                    rho_old *= filter;
+                    rho_new *= filter;
+                    fields(i,j,k,rho_old_m) = rho_old;
+                    fields(i,j,k,rho_new_m) = rho_new;
+                }
+            }
 
             // k vector values, and coefficients
             // The k values for each mode are grouped together
@@ -26,6 +26,161 @@
 
 using namespace amrex;
 
+namespace
+{
+    /** \brief Coefficients of the PSATD update equations for one mode
+     * (see \c PsatdAlgorithm::InitializeSpectralCoefficients) */
+    struct PsatdModeCoefficients
+    {
+        amrex::Real C, S_ck;
+        Complex T2, X1, X2, X3, X4;
+    };
+
+    /**
+     * \brief Compute the coefficients of the PSATD update equations for one mode.
+     * With a zero Galilean velocity (w_c = 0), this gives T2 = 1 and X4 = -S_ck/ep0.
+     *
+     * \param[in] knorm_s norm of the staggered modified k vector
+     * \param[in] w_c dot product of the centered modified k vector with the Galilean velocity
+     * \param[in] dt time step of the simulation
+     * \param[in] update_with_rho whether the update equation for E uses rho or not
+     */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    PsatdModeCoefficients computePsatdModeCoefficients (
+        const amrex::Real knorm_s, const amrex::Real w_c, const amrex::Real dt,
+        const bool update_with_rho) noexcept
+    {
+        // Physical constants and imaginary unit
+        constexpr amrex::Real c = PhysConst::c;
+        constexpr amrex::Real ep0 = PhysConst::ep0;
+        constexpr Complex I = Complex{0._rt, 1._rt};
+
+        const amrex::Real c2 = c * c;
+        const amrex::Real dt2 = dt * dt;
+        const amrex::Real dt3 = dt2 * dt;
+
+        const amrex::Real w2_c = w_c * w_c;
+
+        const amrex::Real om_s = c * knorm_s;
+        const amrex::Real om2_s = om_s * om_s;
+
+        const Complex theta_c      = amrex::exp( I * w_c * dt * 0.5_rt);
+        const Complex theta2_c     = amrex::exp( I * w_c * dt);
+        const Complex theta_c_star = amrex::exp(-I * w_c * dt * 0.5_rt);
+
+        PsatdModeCoefficients coef;
+
+        // C
+        coef.C = std::cos(om_s * dt);
+
+        // S_ck
+        if (om_s != 0.)
+        {
+            coef.S_ck = std::sin(om_s * dt) / om_s;
+        }
+        else // om_s = 0
+        {
+            coef.S_ck = dt;
+        }
+
+        // Auxiliary variable
+        amrex::Real tmp;
+        if (om_s != 0.)
+        {
+            tmp = (1._rt - coef.C) / (ep0 * om2_s);
+        }
+        else // om_s = 0
+        {
+            tmp = 0.5_rt * dt2 / ep0;
+        }
+
+        // T2
+        coef.T2 = theta_c * theta_c;
+
+        // X1 (multiplies i*([k] \times J) in the update equation for update B)
+        if ((om_s != 0.) || (w_c != 0.))
+        {
+            coef.X1 = (1._rt - theta2_c * coef.C + I * w_c * theta2_c * coef.S_ck)
+                      / (ep0 * (om2_s - w2_c));
+        }
+        else // om_s = 0 and w_c = 0
+        {
+            coef.X1 = 0.5_rt * dt2 / ep0;
+        }
+
+        // X2 (multiplies rho_new      if update_with_rho = 1 in the update equation for E)
+        // X2 (multiplies ([k] \dot E) if update_with_rho = 0 in the update equation for E)
+        if (update_with_rho)
+        {
+            if (w_c != 0.)
+            {
+                coef.X2 = c2 * (theta_c_star * coef.X1 - theta_c * tmp)
+                          / (theta_c_star - theta_c);
+            }
+            else // w_c = 0
+            {
+                if (om_s != 0.)
+                {
+                    coef.X2 = c2 * (dt - coef.S_ck) / (ep0 * dt * om2_s);
+                }
+                else // om_s = 0 and w_c = 0
+                {
+                    coef.X2 = c2 * dt2 / (6._rt * ep0);
+                }
+            }
+        }
+        else // update_with_rho = 0
+        {
+            coef.X2 = c2 * ep0 * theta2_c * tmp;
+        }
+
+        // X3 (multiplies rho_old      if update_with_rho = 1 in the update equation for E)
+        // X3 (multiplies ([k] \dot J) if update_with_rho = 0 in the update equation for E)
+        if (update_with_rho)
+        {
+            if (w_c != 0.)
+            {
+                coef.X3 = c2 * (theta_c_star * coef.X1 - theta_c_star * tmp)
+                          / (theta_c_star - theta_c);
+            }
+            else // w_c = 0
+            {
+                if (om_s != 0.)
+                {
+                    coef.X3 = c2 * (dt * coef.C - coef.S_ck) / (ep0 * dt * om2_s);
+                }
+                else // om_s = 0 and w_c = 0
+                {
+                    coef.X3 = - c2 * dt2 / (3._rt * ep0);
+                }
+            }
+        }
+        else // update_with_rho = 0
+        {
+            if (w_c != 0.)
+            {
+                coef.X3 = I * c2 * (theta2_c * tmp - coef.X1) / w_c;
+            }
+            else // w_c = 0
+            {
+                if (om_s != 0.)
+                {
+                    coef.X3 = c2 * (coef.S_ck - dt) / (ep0 * om2_s);
+                }
+                else // om_s = 0 and w_c = 0
+                {
+                    coef.X3 = - c2 * dt3 / (6._rt * ep0);
+                }
+            }
+        }
+
+        // X4 (multiplies J in the update equation for E)
+        coef.X4 = I * w_c * coef.X1 - theta2_c * coef.S_ck / ep0;
+
+        return coef;
+    }
+}
+
 PsatdAlgorithm::PsatdAlgorithm(
     const SpectralKSpace& spectral_kspace,
     const DistributionMapping& dm,
@@ -41,7 +196,8 @@ PsatdAlgorithm::PsatdAlgorithm(
     const bool time_averaging,
     const bool J_linear_in_time,
     const bool dive_cleaning,
-    const bool divb_cleaning)
+    const bool divb_cleaning,
+    const bool on_the_fly_coefficients)
     // Initializer list
     : SpectralBaseAlgorithm(spectral_kspace, dm, spectral_index, norder_x, norder_y, norder_z, nodal, fill_guards),
     m_spectral_index(spectral_index),
@@ -61,27 +217,41 @@ PsatdAlgorithm::PsatdAlgorithm(
     m_time_averaging(time_averaging),
     m_J_linear_in_time(J_linear_in_time),
     m_dive_cleaning(dive_cleaning),
-    m_divb_cleaning(divb_cleaning)
+    m_divb_cleaning(divb_cleaning),
+    m_on_the_fly_coefficients(on_the_fly_coefficients)
 {
     const amrex::BoxArray& ba = spectral_kspace.spectralspace_ba;
 
     m_is_galilean = (v_galilean[0] != 0.) || (v_galilean[1] != 0.) || (v_galilean[2] != 0.);
 
-    // Always allocate these coefficients
-    C_coef = SpectralRealCoefficients(ba, dm, 1, 0);
-    S_ck_coef = SpectralRealCoefficients(ba, dm, 1, 0);
-    X1_coef = SpectralComplexCoefficients(ba, dm, 1, 0);
-    X2_coef = SpectralComplexCoefficients(ba, dm, 1, 0);
-    X3_coef = SpectralComplexCoefficients(ba, dm, 1, 0);
-
-    // Allocate these coefficients only with Galilean PSATD
-    if (m_is_galilean)
+    // Allocate these coefficients unless they are computed on the fly in pushSpectralFields,
+    // or unless they were already computed with the same parameters
+    if (!on_the_fly_coefficients)
     {
-        X4_coef = SpectralComplexCoefficients(ba, dm, 1, 0);
-        T2_coef = SpectralComplexCoefficients(ba, dm, 1, 0);
-    }
+        const PsatdCoefficientsKey key{ba, spectral_kspace.getGlobalSpectralBoxArray(), dm,
+            spectral_kspace.getCellSize(), {norder_x, norder_y, norder_z},
+            nodal, v_galilean, dt, update_with_rho};
+        bool is_new = false;
+        m_coefs = PsatdCoefficientsCache::GetOrCreate(key, is_new);
 
-    InitializeSpectralCoefficients(spectral_kspace, dm, dt);
+        if (is_new)
+        {
+            m_coefs->C_coef = SpectralRealCoefficients(ba, dm, 1, 0);
+            m_coefs->S_ck_coef = SpectralRealCoefficients(ba, dm, 1, 0);
+            m_coefs->X1_coef = SpectralComplexCoefficients(ba, dm, 1, 0);
+            m_coefs->X2_coef = SpectralComplexCoefficients(ba, dm, 1, 0);
+            m_coefs->X3_coef = SpectralComplexCoefficients(ba, dm, 1, 0);
+
+            // Allocate these coefficients only with Galilean PSATD
+            if (m_is_galilean)
+            {
+                m_coefs->X4_coef = SpectralComplexCoefficients(ba, dm, 1, 0);
+                m_coefs->T2_coef = SpectralComplexCoefficients(ba, dm, 1, 0);
+            }
+
+            InitializeSpectralCoefficients(spectral_kspace, dm, dt);
+        }
+    }
 
     // Allocate these coefficients only with time averaging
     if (time_averaging && !J_linear_in_time)
@@ -123,9 +293,17 @@ PsatdAlgorithm::pushSpectralFields (SpectralFieldData& f) const
     const bool dive_cleaning    = m_dive_cleaning;
     const bool divb_cleaning    = m_divb_cleaning;
     const bool is_galilean      = m_is_galilean;
+    const bool on_the_fly_coefs = m_on_the_fly_coefficients;
 
     const amrex::Real dt = m_dt;
 
+    // Extract Galilean velocity
+    const amrex::Real vg_x = m_v_galilean[0];
+#if (AMREX_SPACEDIM == 3)
+    const amrex::Real vg_y = m_v_galilean[1];
+#endif
+    const amrex::Real vg_z = m_v_galilean[2];
+
     const SpectralFieldIndex& Idx = m_spectral_index;
 
     // Loop over boxes
@@ -136,19 +314,26 @@ PsatdAlgorithm::pushSpectralFields (SpectralFieldData& f) const
         // Extract arrays for the fields to be updated
         amrex::Array4<Complex> fields = f.fields[mfi].array();
 
-        // These coefficients are always allocated
-        amrex::Array4<const amrex::Real> C_arr = C_coef[mfi].array();
-        amrex::Array4<const amrex::Real> S_ck_arr = S_ck_coef[mfi].array();
-        amrex::Array4<const Complex> X1_arr = X1_coef[mfi].array();
-        amrex::Array4<const Complex> X2_arr = X2_coef[mfi].array();
-        amrex::Array4<const Complex> X3_arr = X3_coef[mfi].array();
-
+        // These coefficients are allocated unless they are computed on the fly
+        amrex::Array4<const amrex::Real> C_arr;
+        amrex::Array4<const amrex::Real> S_ck_arr;
+        amrex::Array4<const Complex> X1_arr;
+        amrex::Array4<const Complex> X2_arr;
+        amrex::Array4<const Complex> X3_arr;
         amrex::Array4<const Complex> X4_arr;
         amrex::Array4<const Complex> T2_arr;
-        if (is_galilean)
+        if (!on_the_fly_coefs)
         {
-            X4_arr = X4_coef[mfi].array();
-            T2_arr = T2_coef[mfi].array();
+            C_arr = m_coefs->C_coef[mfi].array();
+            S_ck_arr = m_coefs->S_ck_coef[mfi].array();
+            X1_arr = m_coefs->X1_coef[mfi].array();
+            X2_arr = m_coefs->X2_coef[mfi].array();
+            X3_arr = m_coefs->X3_coef[mfi].array();
+            if (is_galilean)
+            {
+                X4_arr = m_coefs->X4_coef[mfi].array();
+                T2_arr = m_coefs->T2_coef[mfi].array();
+            }
         }
 
         // These coefficients are allocated only with averaged Galilean PSATD
@@ -184,6 +369,13 @@ PsatdAlgorithm::pushSpectralFields (SpectralFieldData& f) const
 #endif
         const amrex::Real* modified_kz_arr = modified_kz_vec[mfi].dataPtr();
 
+        // Centered k vectors (used only to compute the coefficients on the fly)
+        const amrex::Real* kx_c = modified_kx_vec_centered[mfi].dataPtr();
+#if (AMREX_SPACEDIM == 3)
+        const amrex::Real* ky_c = modified_ky_vec_centered[mfi].dataPtr();
+#endif
+        const amrex::Real* kz_c = modified_kz_vec_centered[mfi].dataPtr();
+
         // Loop over indices within one box
         ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
         {
@@ -229,14 +421,38 @@ PsatdAlgorithm::pushSpectralFields (SpectralFieldData& f) const
             constexpr Real inv_ep0 = 1._rt / PhysConst::ep0;
             constexpr Complex I = Complex{0._rt, 1._rt};
 
-            // These coefficients are initialized in the function InitializeSpectralCoefficients
-            const amrex::Real C = C_arr(i,j,k);
-            const amrex::Real S_ck = S_ck_arr(i,j,k);
-            const Complex X1 = X1_arr(i,j,k);
-            const Complex X2 = X2_arr(i,j,k);
-            const Complex X3 = X3_arr(i,j,k);
-            const Complex X4 = (is_galilean) ? X4_arr(i,j,k) : - S_ck / PhysConst::ep0;
-            const Complex T2 = (is_galilean) ? T2_arr(i,j,k) : 1.0_rt;
+            // These coefficients are initialized in the function InitializeSpectralCoefficients,
+            // or computed here from the modified k vectors
+            amrex::Real C, S_ck;
+            Complex X1, X2, X3, X4, T2;
+            if (on_the_fly_coefs)
+            {
+                const amrex::Real knorm_s = std::sqrt(kx * kx + ky * ky + kz * kz);
+#if (AMREX_SPACEDIM == 3)
+                const amrex::Real w_c = kx_c[i] * vg_x + ky_c[j] * vg_y + kz_c[k] * vg_z;
+#else
+                const amrex::Real w_c = kx_c[i] * vg_x + kz_c[j] * vg_z;
+#endif
+                const PsatdModeCoefficients coef =
+                    computePsatdModeCoefficients(knorm_s, w_c, dt, update_with_rho);
+                C = coef.C;
+                S_ck = coef.S_ck;
+                X1 = coef.X1;
+                X2 = coef.X2;
+                X3 = coef.X3;
+                X4 = coef.X4;
+                T2 = coef.T2;
+            }
+            else
+            {
+                C = C_arr(i,j,k);
+                S_ck = S_ck_arr(i,j,k);
+                X1 = X1_arr(i,j,k);
+                X2 = X2_arr(i,j,k);
+                X3 = X3_arr(i,j,k);
+                X4 = (is_galilean) ? X4_arr(i,j,k) : - S_ck / PhysConst::ep0;
+                T2 = (is_galilean) ? T2_arr(i,j,k) : 1.0_rt;
+            }
 
             // Update equations for E in the formulation with rho
             // T2 = 1 always with standard PSATD (zero Galilean velocity)
@@ -445,18 +661,18 @@ void PsatdAlgorithm::InitializeSpectralCoefficients (
         const amrex::Real* kz_c = modified_kz_vec_centered[mfi].dataPtr();
 
         // Coefficients always allocated
-        amrex::Array4<amrex::Real> C = C_coef[mfi].array();
-        amrex::Array4<amrex::Real> S_ck = S_ck_coef[mfi].array();
-        amrex::Array4<Complex> X1 = X1_coef[mfi].array();
-        amrex::Array4<Complex> X2 = X2_coef[mfi].array();
-        amrex::Array4<Complex> X3 = X3_coef[mfi].array();
+        amrex::Array4<amrex::Real> C = m_coefs->C_coef[mfi].array();
+        amrex::Array4<amrex::Real> S_ck = m_coefs->S_ck_coef[mfi].array();
+        amrex::Array4<Complex> X1 = m_coefs->X1_coef[mfi].array();
+        amrex::Array4<Complex> X2 = m_coefs->X2_coef[mfi].array();
+        amrex::Array4<Complex> X3 = m_coefs->X3_coef[mfi].array();
 
         amrex::Array4<Complex> X4;
         amrex::Array4<Complex> T2;
         if (is_galilean)
         {
-            X4 = X4_coef[mfi].array();
-            T2 = T2_coef[mfi].array();
+            X4 = m_coefs->X4_coef[mfi].array();
+            T2 = m_coefs->T2_coef[mfi].array();
         }
 
         // Extract Galilean velocity
@@ -477,15 +693,6 @@ void PsatdAlgorithm::InitializeSpectralCoefficients (
 #else
                 std::pow(kz_s[j], 2));
 #endif
-            // Physical constants and imaginary unit
-            constexpr amrex::Real c = PhysConst::c;
-            constexpr amrex::Real ep0 = PhysConst::ep0;
-            constexpr Complex I = Complex{0._rt, 1._rt};
-
-            const amrex::Real c2 = std::pow(c, 2);
-            const amrex::Real dt2 = std::pow(dt, 2);
-            const amrex::Real dt3 = std::pow(dt, 3);
-
             // Calculate the dot product of the k vector with the Galilean velocity.
             // This has to be computed always with the centered (that is, nodal) finite-order
             // modified k vectors, to work correctly for both nodal and staggered simulations.
@@ -496,126 +703,19 @@ void PsatdAlgorithm::InitializeSpectralCoefficients (
 #else
                 kz_c[j]*vg_z;
 #endif
-            const amrex::Real w2_c = std::pow(w_c, 2);
-
-            const amrex::Real om_s = c * knorm_s;
-            const amrex::Real om2_s = std::pow(om_s, 2);
+            const PsatdModeCoefficients coef =
+                computePsatdModeCoefficients(knorm_s, w_c, dt, update_with_rho);
 
-            const Complex theta_c      = amrex::exp( I * w_c * dt * 0.5_rt);
-            const Complex theta2_c     = amrex::exp( I * w_c * dt);
-            const Complex theta_c_star = amrex::exp(-I * w_c * dt * 0.5_rt);
+            C(i,j,k) = coef.C;
+            S_ck(i,j,k) = coef.S_ck;
+            X1(i,j,k) = coef.X1;
+            X2(i,j,k) = coef.X2;
+            X3(i,j,k) = coef.X3;
 
-            // C
-            C(i,j,k) = std::cos(om_s * dt);
-
-            // S_ck
-            if (om_s != 0.)
-            {
-                S_ck(i,j,k) = std::sin(om_s * dt) / om_s;
-            }
-            else // om_s = 0
-            {
-                S_ck(i,j,k) = dt;
-            }
-
-            // Auxiliary variable
-            amrex::Real tmp;
-            if (om_s != 0.)
-            {
-                tmp = (1._rt - C(i,j,k)) / (ep0 * om2_s);
-            }
-            else // om_s = 0
-            {
-                tmp = 0.5_rt * dt2 / ep0;
-            }
-
-            // T2
             if (is_galilean)
             {
-                T2(i,j,k) = theta_c * theta_c;
-            }
-
-            // X1 (multiplies i*([k] \times J) in the update equation for update B)
-            if ((om_s != 0.) || (w_c != 0.))
-            {
-                X1(i,j,k) = (1._rt - theta2_c * C(i,j,k) + I * w_c * theta2_c * S_ck(i,j,k))
-                            / (ep0 * (om2_s - w2_c));
-            }
-            else // om_s = 0 and w_c = 0
-            {
-                X1(i,j,k) = 0.5_rt * dt2 / ep0;
-            }
-
-            // X2 (multiplies rho_new      if update_with_rho = 1 in the update equation for E)
-            // X2 (multiplies ([k] \dot E) if update_with_rho = 0 in the update equation for E)
-            if (update_with_rho)
-            {
-                if (w_c != 0.)
-                {
-                    X2(i,j,k) = c2 * (theta_c_star * X1(i,j,k) - theta_c * tmp)
-                                / (theta_c_star - theta_c);
-                }
-                else // w_c = 0
-                {
-                    if (om_s != 0.)
-                    {
-                        X2(i,j,k) = c2 * (dt - S_ck(i,j,k)) / (ep0 * dt * om2_s);
-                    }
-                    else // om_s = 0 and w_c = 0
-                    {
-                        X2(i,j,k) = c2 * dt2 / (6._rt * ep0);
-                    }
-                }
-            }
-            else // update_with_rho = 0
-            {
-                X2(i,j,k) = c2 * ep0 * theta2_c * tmp;
-            }
-
-            // X3 (multiplies rho_old      if update_with_rho = 1 in the update equation for E)
-            // X3 (multiplies ([k] \dot J) if update_with_rho = 0 in the update equation for E)
-            if (update_with_rho)
-            {
-                if (w_c != 0.)
-                {
-                    X3(i,j,k) = c2 * (theta_c_star * X1(i,j,k) - theta_c_star * tmp)
-                                / (theta_c_star - theta_c);
-                }
-                else // w_c = 0
-                {
-                    if (om_s != 0.)
-                    {
-                        X3(i,j,k) = c2 * (dt * C(i,j,k) - S_ck(i,j,k)) / (ep0 * dt * om2_s);
-                    }
-                    else // om_s = 0 and w_c = 0
-                    {
-                        X3(i,j,k) = - c2 * dt2 / (3._rt * ep0);
-                    }
-                }
-            }
-            else // update_with_rho = 0
-            {
-                if (w_c != 0.)
-                {
-                    X3(i,j,k) = I * c2 * (theta2_c * tmp - X1(i,j,k)) / w_c;
-                }
-                else // w_c = 0
-                {
-                    if (om_s != 0.)
-                    {
-                        X3(i,j,k) = c2 * (S_ck(i,j,k) - dt) / (ep0 * om2_s);
-                    }
-                    else // om_s = 0 and w_c = 0
-                    {
-                        X3(i,j,k) = - c2 * dt3 / (6._rt * ep0);
-                    }
-                }
-            }
-
-            // X4 (multiplies J in the update equation for E)
-            if (is_galilean)
-            {
-                X4(i,j,k) = I * w_c * X1(i,j,k) - theta2_c * S_ck(i,j,k) / ep0;
+                T2(i,j,k) = coef.T2;
+                X4(i,j,k) = coef.X4;
             }
         });
     }
@@ -831,9 +931,6 @@ void PsatdAlgorithm::InitializeSpectralCoefficientsAvgLin (
 #endif
         const Real* kz_s = modified_kz_vec[mfi].dataPtr();
 
-        Array4<Real const> C = C_coef[mfi].array();
-        Array4<Real const> S_ck = S_ck_coef[mfi].array();
-
         Array4<Complex> X5 = X5_coef[mfi].array();
         Array4<Complex> X6 = X6_coef[mfi].array();
 
@@ -860,9 +957,14 @@ void PsatdAlgorithm::InitializeSpectralCoefficientsAvgLin (
             const Real om2_s = om_s * om_s;
             const Real om4_s = om2_s * om2_s;
 
+            // C and S_ck are computed here, since they are not stored when the
+            // coefficients of pushSpectralFields are computed on the fly
+            const Real C = std::cos(om_s * dt);
+            const Real S_ck = (om_s != 0.) ? std::sin(om_s * dt) / om_s : dt;
+
             if (om_s != 0.)
             {
-                X5(i,j,k) = c2 / ep0 * (S_ck(i,j,k) / om2_s - (1._rt - C(i,j,k)) / (om4_s * dt)
+                X5(i,j,k) = c2 / ep0 * (S_ck / om2_s - (1._rt - C) / (om4_s * dt)
                                         - 0.5_rt * dt / om2_s);
             }
             else
@@ -872,7 +974,7 @@ void PsatdAlgorithm::InitializeSpectralCoefficientsAvgLin (
 
             if (om_s != 0.)
             {
-                X6(i,j,k) = c2 / ep0 * ((1._rt - C(i,j,k)) / (om4_s * dt) - 0.5_rt * dt / om2_s);
+                X6(i,j,k) = c2 / ep0 * ((1._rt - C) / (om4_s * dt) - 0.5_rt * dt / om2_s);
             }
             else
             {
@@ -1004,7 +1106,8 @@ void
 PsatdAlgorithm::VayDeposition (
     const int lev,
     SpectralFieldData& field_data,
-    std::array<std::unique_ptr<amrex::MultiFab>,3>& current)
+    std::array<std::unique_ptr<amrex::MultiFab>,3>& current,
+    const bool backward_transform)
 {
     // Profiling
     BL_PROFILE("PsatdAlgorithm::VayDeposition()");
@@ -1073,6 +1176,9 @@ PsatdAlgorithm::VayDeposition (
         });
     }
 
+    // J can be kept in spectral space, where it is used by the PSATD push
+    if (!backward_transform) return;
+
     // Backward Fourier transform of J
     field_data.BackwardTransform(lev, *current[0], Idx.Jx, 0, fill_guards);
     field_data.BackwardTransform(lev, *current[1], Idx.Jy, 0, fill_guards);
@@ -71,7 +71,7 @@ PsatdAlgorithmRZ::PsatdAlgorithmRZ (SpectralKSpaceRZ const & spectral_kspace,
 /* Advance the E and B field in spectral space (stored in `f`)
  * over one time step */
 void
-PsatdAlgorithmRZ::pushSpectralFields(SpectralFieldDataRZ & f)
+PsatdAlgorithmRZ::pushSpectralFields(SpectralFieldDataRZ & f, const bool filter_sources)
 {
 
     const bool update_with_rho = m_update_with_rho;
@@ -116,6 +116,14 @@ PsatdAlgorithmRZ::pushSpectralFields(SpectralFieldDataRZ & f)
         amrex::Real const* kr_arr = kr_modes.dataPtr();
         amrex::Real const* modified_kz_arr = modified_kz_vec[mfi].dataPtr();
         int const nr = bx.length(0);
+
+        // Extract pointers for the K space filter (only used if filter_sources)
+        amrex::Real const* filter_r_arr = nullptr;
+        amrex::Real const* filter_z_arr = nullptr;
+        if (filter_sources) {
+            filter_r_arr = f.getFilter(mfi).getFilterArrayR().dataPtr();
+            filter_z_arr = f.getFilter(mfi).getFilterArrayZ().dataPtr();
+        }
         amrex::Real const dt = m_dt;
 
         // Loop over indices within one box
@@ -146,11 +154,31 @@ PsatdAlgorithmRZ::pushSpectralFields(SpectralFieldDataRZ & f)
             Complex const Bm_old = fields(i,j,k,Bm_m);
             Complex const Bz_old = fields(i,j,k,Bz_m);
             // Shortcut for the values of J and rho
-            Complex const Jp = fields(i,j,k,Jp_m);
-            Complex const Jm = fields(i,j,k,Jm_m);
-            Complex const Jz = fields(i,j,k,Jz_m);
-            Complex const rho_old = fields(i,j,k,rho_old_m);
-            Complex const rho_new = fields(i,j,k,rho_new_m);
+            Complex Jp = fields(i,j,k,Jp_m);
+            Complex Jm = fields(i,j,k,Jm_m);
+            Complex Jz = fields(i,j,k,Jz_m);
+            Complex rho_old = fields(i,j,k,rho_old_m);
+            Complex rho_new = fields(i,j,k,rho_new_m);
+
+            // Apply the K space filter to J and rho, and store the filtered values
+            // (as ApplyFilter would have done)
+            if (filter_sources)
+            {
+                amrex::Real const filter = filter_r_arr[i + nr*mode]*filter_z_arr[j];
+                Jp *= filter;
+                Jm *= filter;
+                Jz *= filter;
+                fields(i,j,k,Jp_m) = Jp;
+                fields(i,j,k,Jm_m) = Jm;
+                fields(i,j,k,Jz_m) = Jz;
+                if (update_with_rho || dive_cleaning)
+                {
+                    rho_old *= filter;
+                    rho_new *= filter;
+                    fields(i,j,k,rho_old_m) = rho_old;
+                    fields(i,j,k,rho_new_m) = rho_new;
+                }
+            }
 
             int Ep_avg_m;
             int Em_avg_m;
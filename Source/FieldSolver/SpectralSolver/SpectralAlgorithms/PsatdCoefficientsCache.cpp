@@ -0,0 +1,64 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "PsatdCoefficientsCache.H"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#if WARPX_USE_PSATD
+
+bool
+PsatdCoefficientsKey::operator== (const PsatdCoefficientsKey& other) const
+{
+    return ba == other.ba && global_ba == other.global_ba && dm == other.dm &&
+        dx == other.dx && norder == other.norder && nodal == other.nodal &&
+        v_galilean == other.v_galilean && dt == other.dt &&
+        update_with_rho == other.update_with_rho;
+}
+
+namespace
+{
+    // There are only a few sets of coefficients at a time (typically one per level
+    // and per patch), so that a linear search is sufficient
+    std::vector< std::pair< PsatdCoefficientsKey, std::weak_ptr<PsatdCoefficients> > >&
+    coefficients_store ()
+    {
+        static std::vector< std::pair< PsatdCoefficientsKey, std::weak_ptr<PsatdCoefficients> > > store;
+        return store;
+    }
+}
+
+std::shared_ptr<PsatdCoefficients>
+PsatdCoefficientsCache::GetOrCreate (const PsatdCoefficientsKey& key, bool& is_new)
+{
+    auto& store = coefficients_store();
+
+    // Remove the coefficients that are not used anymore
+    store.erase(std::remove_if(store.begin(), store.end(),
+        [] (const auto& entry) { return entry.second.expired(); }), store.end());
+
+    for (const auto& entry : store)
+    {
+        if (entry.first == key)
+        {
+            std::shared_ptr<PsatdCoefficients> coefs = entry.second.lock();
+            if (coefs)
+            {
+                is_new = false;
+                return coefs;
+            }
+        }
+    }
+
+    auto coefs = std::make_shared<PsatdCoefficients>();
+    store.emplace_back(key, coefs);
+    is_new = true;
+    return coefs;
+}
+
+#endif // WARPX_USE_PSATD
@@ -14,6 +14,7 @@
 #include <AMReX_BLassert.H>
 #include <AMReX_Box.H>
 #include <AMReX_BoxArray.H>
+#include <AMReX_BoxList.H>
 #include <AMReX_Dim3.H>
 #include <AMReX_FArrayBox.H>
 #include <AMReX_GpuAtomic.H>
@@ -25,13 +26,20 @@
 #include <AMReX_LayoutData.H>
 #include <AMReX_MFIter.H>
 #include <AMReX_PODVector.H>
+#include <AMReX_Periodicity.H>
 #include <AMReX_REAL.H>
 #include <AMReX_Utility.H>
 
+#include <algorithm>
+#include <limits>
+#include <memory>
+
 #if WARPX_USE_PSATD
 
 using namespace amrex;
 
+constexpr int SpectralFieldData::max_batch_size;
+
 SpectralFieldIndex::SpectralFieldIndex (const bool update_with_rho,
                                         const bool time_averaging,
                                         const bool J_linear_in_time,
@@ -105,7 +113,8 @@ SpectralFieldData::SpectralFieldData( const int lev,
                                       const SpectralKSpace& k_space,
                                       const amrex::DistributionMapping& dm,
                                       const int n_field_required,
-                                      const bool periodic_single_box)
+                                      const bool periodic_single_box,
+                                      const DistributedFFTLayout& distributed_layout)
 {
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
 
@@ -119,8 +128,24 @@ SpectralFieldData::SpectralFieldData( const int lev,
 
     // Allocate temporary arrays - in real space and spectral space
     // These arrays will store the data just before/after the FFT
-    tmpRealField = MultiFab(realspace_ba, dm, 1, 0);
-    tmpSpectralField = SpectralField(spectralspace_ba, dm, 1, 0);
+    // (for the distributed FFTs, `dm` is the distribution of the transposed slabs,
+    // and the real-space data are stored in the real-space slabs)
+    m_distributed_fft = distributed_layout.defined;
+    if (m_distributed_fft) {
+        m_layout = distributed_layout;
+        tmpRealField = MultiFab(m_layout.real_slabs_ba, m_layout.slabs_dm, 1, 0);
+        m_tmpSlabSpectralField = SpectralField(m_layout.complex_slabs_ba, m_layout.slabs_dm, 1, 0);
+        m_tmpRealFieldStaggered.resize(1 << AMREX_SPACEDIM);
+    } else if (WarpX::fft_single_precision) {
+        m_single_precision_fft = true;
+        tmpRealFieldSingle = RealFieldSingle(realspace_ba, dm, 1, 0);
+        tmpSpectralFieldSingle = SpectralFieldSingle(spectralspace_ba, dm, 1, 0);
+    } else {
+        tmpRealField = MultiFab(realspace_ba, dm, 1, 0);
+    }
+    if (!m_single_precision_fft) {
+        tmpSpectralField = SpectralField(spectralspace_ba, dm, 1, 0);
+    }
 
     // By default, we assume the FFT is done from/to a nodal grid in real space
     // It the FFT is performed from/to a cell-centered grid in real space,
@@ -145,6 +170,49 @@ SpectralFieldData::SpectralFieldData( const int lev,
                                     ShiftType::TransformToCellCentered);
 #endif
 
+    if (m_distributed_fft) {
+        // Alias of tmpSpectralField in the global indices, for the transposition of the slabs
+        m_tmpSpectralFieldGlobal.define(m_layout.spectral_ba, dm, 1, 0, MFInfo().SetAlloc(false));
+        for ( MFIter mfi(m_tmpSpectralFieldGlobal); mfi.isValid(); ++mfi ){
+            m_tmpSpectralFieldGlobal.setFab(mfi, std::make_unique<BaseFab<Complex> >(
+                m_layout.spectral_ba[mfi.index()], 1, tmpSpectralField[mfi].dataPtr()));
+        }
+
+        constexpr int last_dim = AMREX_SPACEDIM-1;
+
+        // Real-to-complex FFTs along all the dimensions but the last one,
+        // batched over the planes of each real-space slab
+        forward_plan = AnyFFT::FFTplans(m_layout.real_slabs_ba, m_layout.slabs_dm);
+        backward_plan = AnyFFT::FFTplans(m_layout.real_slabs_ba, m_layout.slabs_dm);
+        for ( MFIter mfi(tmpRealField); mfi.isValid(); ++mfi ){
+            const IntVect fft_size = tmpRealField[mfi].box().length();
+            const int nplanes = fft_size[last_dim];
+            forward_plan[mfi] = AnyFFT::CreatePlan(
+                fft_size, tmpRealField[mfi].dataPtr(),
+                reinterpret_cast<AnyFFT::Complex*>( m_tmpSlabSpectralField[mfi].dataPtr()),
+                AnyFFT::direction::R2C, AMREX_SPACEDIM-1, nplanes);
+            backward_plan[mfi] = AnyFFT::CreatePlan(
+                fft_size, tmpRealField[mfi].dataPtr(),
+                reinterpret_cast<AnyFFT::Complex*>( m_tmpSlabSpectralField[mfi].dataPtr()),
+                AnyFFT::direction::C2R, AMREX_SPACEDIM-1, nplanes);
+        }
+
+        // In-place complex-to-complex FFTs along the last dimension, in each transposed slab
+        c2c_forward_plan = AnyFFT::FFTplans(spectralspace_ba, dm);
+        c2c_backward_plan = AnyFFT::FFTplans(spectralspace_ba, dm);
+        for ( MFIter mfi(tmpSpectralField); mfi.isValid(); ++mfi ){
+            const Box& bx = tmpSpectralField[mfi].box();
+            const int n = bx.length(last_dim);
+            const int stride = static_cast<int>(bx.numPts() / n);
+            AnyFFT::Complex* p = reinterpret_cast<AnyFFT::Complex*>(tmpSpectralField[mfi].dataPtr());
+            c2c_forward_plan[mfi] = AnyFFT::CreateStridedPlanC2C(
+                n, stride, stride, p, AnyFFT::direction::C2C_forward);
+            c2c_backward_plan[mfi] = AnyFFT::CreateStridedPlanC2C(
+                n, stride, stride, p, AnyFFT::direction::C2C_backward);
+        }
+        return;
+    }
+
     // Allocate and initialize the FFT plans
     forward_plan = AnyFFT::FFTplans(spectralspace_ba, dm);
     backward_plan = AnyFFT::FFTplans(spectralspace_ba, dm);
@@ -162,15 +230,27 @@ SpectralFieldData::SpectralFieldData( const int lev,
         // the FFT plan, the valid dimensions are those of the real-space box.
         IntVect fft_size = realspace_ba[mfi].length();
 
-        forward_plan[mfi] = AnyFFT::CreatePlan(
-            fft_size, tmpRealField[mfi].dataPtr(),
-            reinterpret_cast<AnyFFT::Complex*>( tmpSpectralField[mfi].dataPtr()),
-            AnyFFT::direction::R2C, AMREX_SPACEDIM);
-
-        backward_plan[mfi] = AnyFFT::CreatePlan(
-            fft_size, tmpRealField[mfi].dataPtr(),
-            reinterpret_cast<AnyFFT::Complex*>( tmpSpectralField[mfi].dataPtr()),
-            AnyFFT::direction::C2R, AMREX_SPACEDIM);
+        if (m_single_precision_fft) {
+            forward_plan[mfi] = AnyFFT::CreatePlanSingle(
+                fft_size, tmpRealFieldSingle[mfi].dataPtr(),
+                reinterpret_cast<AnyFFT::ComplexSingle*>( tmpSpectralFieldSingle[mfi].dataPtr()),
+                AnyFFT::direction::R2C, AMREX_SPACEDIM);
+
+            backward_plan[mfi] = AnyFFT::CreatePlanSingle(
+                fft_size, tmpRealFieldSingle[mfi].dataPtr(),
+                reinterpret_cast<AnyFFT::ComplexSingle*>( tmpSpectralFieldSingle[mfi].dataPtr()),
+                AnyFFT::direction::C2R, AMREX_SPACEDIM);
+        } else {
+            forward_plan[mfi] = AnyFFT::CreatePlan(
+                fft_size, tmpRealField[mfi].dataPtr(),
+                reinterpret_cast<AnyFFT::Complex*>( tmpSpectralField[mfi].dataPtr()),
+                AnyFFT::direction::R2C, AMREX_SPACEDIM);
+
+            backward_plan[mfi] = AnyFFT::CreatePlan(
+                fft_size, tmpRealField[mfi].dataPtr(),
+                reinterpret_cast<AnyFFT::Complex*>( tmpSpectralField[mfi].dataPtr()),
+                AnyFFT::direction::C2R, AMREX_SPACEDIM);
+        }
 
         if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
         {
@@ -190,6 +270,90 @@ SpectralFieldData::~SpectralFieldData()
             AnyFFT::DestroyPlan(backward_plan[mfi]);
         }
     }
+    if (m_single_precision_fft && !tmpRealFieldSingle.empty()){
+        for ( MFIter mfi(tmpRealFieldSingle); mfi.isValid(); ++mfi ){
+            AnyFFT::DestroyPlan(forward_plan[mfi]);
+            AnyFFT::DestroyPlan(backward_plan[mfi]);
+        }
+    }
+    if (m_distributed_fft && !tmpSpectralField.empty()){
+        for ( MFIter mfi(tmpSpectralField); mfi.isValid(); ++mfi ){
+            AnyFFT::DestroyPlan(c2c_forward_plan[mfi]);
+            AnyFFT::DestroyPlan(c2c_backward_plan[mfi]);
+        }
+    }
+    DestroyBatchPlans();
+}
+
+amrex::MultiFab&
+SpectralFieldData::getStaggeredRealField (const amrex::IndexType ixtype)
+{
+    int key = 0;
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+        if (ixtype.nodeCentered(dir)) key |= (1 << dir);
+    }
+    std::unique_ptr<MultiFab>& mf = m_tmpRealFieldStaggered[key];
+    if (!mf) {
+        // Same indices as the cells of the slabs: along a nodal direction, the last
+        // node of the domain is the periodic image of the first one
+        const BoxArray& slabs_ba = tmpRealField.boxArray();
+        BoxList bl(ixtype);
+        for (int i = 0; i < slabs_ba.size(); ++i) {
+            bl.push_back(Box(slabs_ba[i].smallEnd(), slabs_ba[i].bigEnd(), ixtype));
+        }
+        mf = std::make_unique<MultiFab>(BoxArray(bl), tmpRealField.DistributionMap(), 1, 0,
+                                        MFInfo().SetAlloc(false));
+        for ( MFIter mfi(*mf); mfi.isValid(); ++mfi ){
+            mf->setFab(mfi, std::make_unique<FArrayBox>(
+                mf->boxArray()[mfi.index()], 1, tmpRealField[mfi].dataPtr()));
+        }
+    }
+    return *mf;
+}
+
+void
+SpectralFieldData::DestroyBatchPlans ()
+{
+    if (m_batch_size > 0 && !tmpRealFieldBatch.empty()){
+        for ( MFIter mfi(tmpRealFieldBatch); mfi.isValid(); ++mfi ){
+            AnyFFT::DestroyPlan(forward_plan_batch[mfi]);
+            AnyFFT::DestroyPlan(backward_plan_batch[mfi]);
+        }
+    }
+    m_batch_size = 0;
+}
+
+void
+SpectralFieldData::AllocateBatch (const int batch_size)
+{
+    if (batch_size == m_batch_size) return;
+    DestroyBatchPlans();
+
+    const BoxArray& realspace_ba = tmpRealField.boxArray();
+    const BoxArray& spectralspace_ba = tmpSpectralField.boxArray();
+    const DistributionMapping& dm = tmpRealField.DistributionMap();
+
+    // The components of a box are contiguous in memory, as expected by the batched plans
+    tmpRealFieldBatch = MultiFab(realspace_ba, dm, batch_size, 0);
+    tmpSpectralFieldBatch = SpectralField(spectralspace_ba, dm, batch_size, 0);
+
+    forward_plan_batch = AnyFFT::FFTplans(spectralspace_ba, dm);
+    backward_plan_batch = AnyFFT::FFTplans(spectralspace_ba, dm);
+    for ( MFIter mfi(spectralspace_ba, dm); mfi.isValid(); ++mfi ){
+        IntVect fft_size = realspace_ba[mfi].length();
+
+        forward_plan_batch[mfi] = AnyFFT::CreatePlan(
+            fft_size, tmpRealFieldBatch[mfi].dataPtr(),
+            reinterpret_cast<AnyFFT::Complex*>( tmpSpectralFieldBatch[mfi].dataPtr()),
+            AnyFFT::direction::R2C, AMREX_SPACEDIM, batch_size);
+
+        backward_plan_batch[mfi] = AnyFFT::CreatePlan(
+            fft_size, tmpRealFieldBatch[mfi].dataPtr(),
+            reinterpret_cast<AnyFFT::Complex*>( tmpSpectralFieldBatch[mfi].dataPtr()),
+            AnyFFT::direction::C2R, AMREX_SPACEDIM, batch_size);
+    }
+
+    m_batch_size = batch_size;
 }
 
 /* \brief Transform the component `i_comp` of MultiFab `mf`
@@ -211,6 +375,50 @@ SpectralFieldData::ForwardTransform (const int lev,
     const bool is_nodal_z = (stag[1] == amrex::IndexType::NODE) ? true : false;
 #endif
 
+    if (m_distributed_fft) {
+        // Copy the valid data of `mf` to the real-space slabs (tmpRealField)
+        // (this discards the *last* point of the domain along the nodal directions,
+        // which is the periodic image of the first one)
+        getStaggeredRealField(mf.ixType()).ParallelCopy(mf, i_comp, 0, 1);
+
+        // Perform the FFTs along all the dimensions but the last one, in each slab
+        for ( MFIter mfi(tmpRealField); mfi.isValid(); ++mfi ){
+            AnyFFT::Execute(forward_plan[mfi]);
+        }
+
+        // Transpose the slabs, to `tmpSpectralField`
+        m_tmpSpectralFieldGlobal.ParallelCopy(m_tmpSlabSpectralField, 0, 0, 1);
+
+        for ( MFIter mfi(tmpSpectralField); mfi.isValid(); ++mfi ){
+            // Perform the FFTs along the last dimension
+            AnyFFT::Execute(c2c_forward_plan[mfi]);
+
+            // Copy to the index `field_index` of `fields`, with the shift factors
+            Array4<Complex> fields_arr = SpectralFieldData::fields[mfi].array();
+            Array4<const Complex> tmp_arr = tmpSpectralField[mfi].array();
+            const Complex* xshift_arr = xshift_FFTfromCell[mfi].dataPtr();
+#if (AMREX_SPACEDIM == 3)
+            const Complex* yshift_arr = yshift_FFTfromCell[mfi].dataPtr();
+#endif
+            const Complex* zshift_arr = zshift_FFTfromCell[mfi].dataPtr();
+            const Box spectralspace_bx = tmpSpectralField[mfi].box();
+
+            ParallelFor( spectralspace_bx,
+            [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+                Complex spectral_field_value = tmp_arr(i,j,k);
+                if (is_nodal_x==false) spectral_field_value *= xshift_arr[i];
+#if (AMREX_SPACEDIM == 3)
+                if (is_nodal_y==false) spectral_field_value *= yshift_arr[j];
+                if (is_nodal_z==false) spectral_field_value *= zshift_arr[k];
+#elif (AMREX_SPACEDIM == 2)
+                if (is_nodal_z==false) spectral_field_value *= zshift_arr[j];
+#endif
+                fields_arr(i,j,k,field_index) = spectral_field_value;
+            });
+        }
+        return;
+    }
+
     // Loop over boxes
     // Note: we do NOT OpenMP parallelize here, since we use OpenMP threads for
     //       the FFTs on each box!
@@ -234,13 +442,23 @@ SpectralFieldData::ForwardTransform (const int lev,
                 realspace_bx = mf[mfi].box(); // Keep guard cells
             }
             realspace_bx.enclosedCells(); // Discard last point in nodal direction
-            AMREX_ALWAYS_ASSERT( realspace_bx.contains(tmpRealField[mfi].box()) );
             Array4<const Real> mf_arr = mf[mfi].array();
-            Array4<Real> tmp_arr = tmpRealField[mfi].array();
-            ParallelFor( tmpRealField[mfi].box(),
-            [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-                tmp_arr(i,j,k) = mf_arr(i,j,k,i_comp);
-            });
+            if (m_single_precision_fft) {
+                // Convert to single precision
+                AMREX_ALWAYS_ASSERT( realspace_bx.contains(tmpRealFieldSingle[mfi].box()) );
+                Array4<float> tmp_arr = tmpRealFieldSingle[mfi].array();
+                ParallelFor( tmpRealFieldSingle[mfi].box(),
+                [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+                    tmp_arr(i,j,k) = static_cast<float>(mf_arr(i,j,k,i_comp));
+                });
+            } else {
+                AMREX_ALWAYS_ASSERT( realspace_bx.contains(tmpRealField[mfi].box()) );
+                Array4<Real> tmp_arr = tmpRealField[mfi].array();
+                ParallelFor( tmpRealField[mfi].box(),
+                [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+                    tmp_arr(i,j,k) = mf_arr(i,j,k,i_comp);
+                });
+            }
         }
 
         // Perform Fourier transform from `tmpRealField` to `tmpSpectralField`
@@ -252,18 +470,28 @@ SpectralFieldData::ForwardTransform (const int lev,
         // from a cell-centered grid in real space instead of a nodal grid.
         {
             Array4<Complex> fields_arr = SpectralFieldData::fields[mfi].array();
-            Array4<const Complex> tmp_arr = tmpSpectralField[mfi].array();
+            const bool single_precision = m_single_precision_fft;
+            Array4<const Complex> tmp_arr;
+            Array4<const GpuComplex<float> > tmp_arr_single;
+            if (single_precision) {
+                tmp_arr_single = tmpSpectralFieldSingle[mfi].const_array();
+            } else {
+                tmp_arr = tmpSpectralField[mfi].const_array();
+            }
             const Complex* xshift_arr = xshift_FFTfromCell[mfi].dataPtr();
 #if (AMREX_SPACEDIM == 3)
             const Complex* yshift_arr = yshift_FFTfromCell[mfi].dataPtr();
 #endif
             const Complex* zshift_arr = zshift_FFTfromCell[mfi].dataPtr();
             // Loop over indices within one box
-            const Box spectralspace_bx = tmpSpectralField[mfi].box();
+            const Box spectralspace_bx = SpectralFieldData::fields[mfi].box();
 
             ParallelFor( spectralspace_bx,
             [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-                Complex spectral_field_value = tmp_arr(i,j,k);
+                // Convert back to amrex::Real precision, if needed
+                Complex spectral_field_value = (single_precision) ?
+                    Complex{tmp_arr_single(i,j,k).real(), tmp_arr_single(i,j,k).imag()} :
+                    tmp_arr(i,j,k);
                 // Apply proper shift in each dimension
                 if (is_nodal_x==false) spectral_field_value *= xshift_arr[i];
 #if (AMREX_SPACEDIM == 3)
@@ -316,6 +544,53 @@ SpectralFieldData::BackwardTransform (const int lev,
     const int sk = (is_nodal_z) ? 1 : 0;
 #endif
 
+    if (m_distributed_fft) {
+        for ( MFIter mfi(tmpSpectralField); mfi.isValid(); ++mfi ){
+            // Copy the index `field_index` of `fields` to `tmpSpectralField`,
+            // with the shift factors
+            Array4<const Complex> field_arr = SpectralFieldData::fields[mfi].array();
+            Array4<Complex> tmp_arr = tmpSpectralField[mfi].array();
+            const Complex* xshift_arr = xshift_FFTtoCell[mfi].dataPtr();
+#if (AMREX_SPACEDIM == 3)
+            const Complex* yshift_arr = yshift_FFTtoCell[mfi].dataPtr();
+#endif
+            const Complex* zshift_arr = zshift_FFTtoCell[mfi].dataPtr();
+            const Box spectralspace_bx = tmpSpectralField[mfi].box();
+
+            ParallelFor( spectralspace_bx,
+            [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+                Complex spectral_field_value = field_arr(i,j,k,field_index);
+                if (is_nodal_x==false) spectral_field_value *= xshift_arr[i];
+#if (AMREX_SPACEDIM == 3)
+                if (is_nodal_y==false) spectral_field_value *= yshift_arr[j];
+                if (is_nodal_z==false) spectral_field_value *= zshift_arr[k];
+#elif (AMREX_SPACEDIM == 2)
+                if (is_nodal_z==false) spectral_field_value *= zshift_arr[j];
+#endif
+                tmp_arr(i,j,k) = spectral_field_value;
+            });
+
+            // Perform the inverse FFTs along the last dimension
+            AnyFFT::Execute(c2c_backward_plan[mfi]);
+        }
+
+        // Transpose back to the real-space slabs
+        m_tmpSlabSpectralField.ParallelCopy(m_tmpSpectralFieldGlobal, 0, 0, 1);
+
+        // Perform the inverse FFTs along the other dimensions, in each slab
+        for ( MFIter mfi(tmpRealField); mfi.isValid(); ++mfi ){
+            AnyFFT::Execute(backward_plan[mfi]);
+        }
+
+        // Normalize, and copy to the valid points of `mf`
+        // (the last point along the nodal directions is the periodic image of the first
+        // one; the guard cells are filled afterwards with FillBoundary)
+        tmpRealField.mult(1._rt / m_layout.realspace_domain.numPts(), 0, 1);
+        mf.ParallelCopy(getStaggeredRealField(mf.ixType()), 0, i_comp, 1,
+                        IntVect(0), IntVect(0), Periodicity(m_layout.realspace_domain.length()));
+        return;
+    }
+
     // Numbers of guard cells
     const amrex::IntVect& mf_ng = mf.nGrowVect();
 
@@ -335,14 +610,21 @@ SpectralFieldData::BackwardTransform (const int lev,
         // to a cell-centered grid in real space instead of a nodal grid.
         {
             Array4<const Complex> field_arr = SpectralFieldData::fields[mfi].array();
-            Array4<Complex> tmp_arr = tmpSpectralField[mfi].array();
+            const bool single_precision = m_single_precision_fft;
+            Array4<Complex> tmp_arr;
+            Array4<GpuComplex<float> > tmp_arr_single;
+            if (single_precision) {
+                tmp_arr_single = tmpSpectralFieldSingle[mfi].array();
+            } else {
+                tmp_arr = tmpSpectralField[mfi].array();
+            }
             const Complex* xshift_arr = xshift_FFTtoCell[mfi].dataPtr();
 #if (AMREX_SPACEDIM == 3)
             const Complex* yshift_arr = yshift_FFTtoCell[mfi].dataPtr();
 #endif
             const Complex* zshift_arr = zshift_FFTtoCell[mfi].dataPtr();
             // Loop over indices within one box
-            const Box spectralspace_bx = tmpSpectralField[mfi].box();
+            const Box spectralspace_bx = SpectralFieldData::fields[mfi].box();
 
             ParallelFor( spectralspace_bx,
             [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
@@ -355,8 +637,14 @@ SpectralFieldData::BackwardTransform (const int lev,
 #elif (AMREX_SPACEDIM == 2)
                 if (is_nodal_z==false) spectral_field_value *= zshift_arr[j];
 #endif
-                // Copy field into temporary array
-                tmp_arr(i,j,k) = spectral_field_value;
+                // Copy field into temporary array (converted to single precision, if needed)
+                if (single_precision) {
+                    tmp_arr_single(i,j,k) = GpuComplex<float>{
+                        static_cast<float>(spectral_field_value.real()),
+                        static_cast<float>(spectral_field_value.imag())};
+                } else {
+                    tmp_arr(i,j,k) = spectral_field_value;
+                }
             });
         }
 
@@ -368,9 +656,19 @@ SpectralFieldData::BackwardTransform (const int lev,
         {
             amrex::Box mf_box = (m_periodic_single_box) ? mfi.validbox() : mfi.fabbox();
             amrex::Array4<amrex::Real> mf_arr = mf[mfi].array();
-            amrex::Array4<const amrex::Real> tmp_arr = tmpRealField[mfi].array();
+            const bool single_precision = m_single_precision_fft;
+            amrex::Array4<const amrex::Real> tmp_arr;
+            amrex::Array4<const float> tmp_arr_single;
+            amrex::Box tmp_box;
+            if (single_precision) {
+                tmp_arr_single = tmpRealFieldSingle[mfi].const_array();
+                tmp_box = tmpRealFieldSingle[mfi].box();
+            } else {
+                tmp_arr = tmpRealField[mfi].const_array();
+                tmp_box = tmpRealField[mfi].box();
+            }
 
-            const amrex::Real inv_N = 1._rt / tmpRealField[mfi].box().numPts();
+            const amrex::Real inv_N = 1._rt / tmp_box.numPts();
 
             // Total number of cells, including ghost cells (nj represents ny in 3D and nz in 2D)
             const int ni = mf_box.length(0);
@@ -408,8 +706,10 @@ SpectralFieldData::BackwardTransform (const int lev,
                 const int ii = (i == lo_i + ni - si) ? lo_i : i;
                 const int jj = (j == lo_j + nj - sj) ? lo_j : j;
                 const int kk = (k == lo_k + nk - sk) ? lo_k : k;
-                // Copy and normalize field
-                mf_arr(i,j,k,i_comp) = inv_N * tmp_arr(ii,jj,kk);
+                // Copy and normalize field (converted back to amrex::Real precision, if needed)
+                mf_arr(i,j,k,i_comp) = (single_precision) ?
+                    inv_N * static_cast<amrex::Real>(tmp_arr_single(ii,jj,kk)) :
+                    inv_N * tmp_arr(ii,jj,kk);
             });
         }
 
@@ -422,4 +722,262 @@ SpectralFieldData::BackwardTransform (const int lev,
     }
 }
 
+void
+SpectralFieldData::ForwardTransform (const int lev,
+                                     const amrex::Vector<TransformComponent>& components)
+{
+    const int ncomps_total = static_cast<int>(components.size());
+
+    if (!WarpX::fft_batch_transforms || m_distributed_fft || m_single_precision_fft ||
+        ncomps_total == 1) {
+        for (const auto& c : components) {
+            ForwardTransform(lev, *c.mf, c.field_index, c.i_comp);
+        }
+        return;
+    }
+
+    amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
+
+    // Transform the components by groups of at most max_batch_size
+    for (int first = 0; first < ncomps_total; first += max_batch_size)
+    {
+        const int ncomps = std::min(max_batch_size, ncomps_total - first);
+        AllocateBatch(ncomps);
+
+        // Spectral index and staggering of each component
+        GpuArray<int, max_batch_size> field_index, i_comp;
+        GpuArray<int, max_batch_size> is_nodal_x, is_nodal_y, is_nodal_z;
+        for (int n = 0; n < ncomps; ++n) {
+            const TransformComponent& c = components[first+n];
+            field_index[n] = c.field_index;
+            i_comp[n] = c.i_comp;
+            is_nodal_x[n] = c.mf->is_nodal(0);
+#if (AMREX_SPACEDIM == 3)
+            is_nodal_y[n] = c.mf->is_nodal(1);
+            is_nodal_z[n] = c.mf->is_nodal(2);
+#else
+            is_nodal_y[n] = true;
+            is_nodal_z[n] = c.mf->is_nodal(1);
+#endif
+        }
+
+        // Loop over boxes
+        // Note: we do NOT OpenMP parallelize here, since we use OpenMP threads for
+        //       the FFTs on each box!
+        for ( MFIter mfi(tmpRealFieldBatch); mfi.isValid(); ++mfi ){
+            if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+            {
+                amrex::Gpu::synchronize();
+            }
+            Real wt = amrex::second();
+
+            // Copy all the components to the multi-component buffer `tmpRealFieldBatch`
+            // (discarding the last point in the nodal directions, as in ForwardTransform)
+            {
+                GpuArray<Array4<const Real>, max_batch_size> mf_arr;
+                for (int n = 0; n < ncomps; ++n) {
+                    const MultiFab& mf = *components[first+n].mf;
+                    Box realspace_bx = (m_periodic_single_box) ?
+                        mf.boxArray()[mfi.index()] : mf[mfi].box();
+                    realspace_bx.enclosedCells();
+                    AMREX_ALWAYS_ASSERT( realspace_bx.contains(tmpRealFieldBatch[mfi].box()) );
+                    mf_arr[n] = mf[mfi].const_array();
+                }
+                Array4<Real> tmp_arr = tmpRealFieldBatch[mfi].array();
+                ParallelFor( tmpRealFieldBatch[mfi].box(), ncomps,
+                [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+                    tmp_arr(i,j,k,n) = mf_arr[n](i,j,k,i_comp[n]);
+                });
+            }
+
+            // Perform the Fourier transforms of all the components at once
+            AnyFFT::Execute(forward_plan_batch[mfi]);
+
+            // Copy each component to its index of the FabArray `fields`,
+            // with the correcting shift factors of its staggering
+            {
+                Array4<Complex> fields_arr = SpectralFieldData::fields[mfi].array();
+                Array4<const Complex> tmp_arr = tmpSpectralFieldBatch[mfi].array();
+                const Complex* xshift_arr = xshift_FFTfromCell[mfi].dataPtr();
+#if (AMREX_SPACEDIM == 3)
+                const Complex* yshift_arr = yshift_FFTfromCell[mfi].dataPtr();
+#endif
+                const Complex* zshift_arr = zshift_FFTfromCell[mfi].dataPtr();
+                const Box spectralspace_bx = tmpSpectralFieldBatch[mfi].box();
+
+                ParallelFor( spectralspace_bx, ncomps,
+                [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+                    Complex spectral_field_value = tmp_arr(i,j,k,n);
+                    if (!is_nodal_x[n]) spectral_field_value *= xshift_arr[i];
+#if (AMREX_SPACEDIM == 3)
+                    if (!is_nodal_y[n]) spectral_field_value *= yshift_arr[j];
+                    if (!is_nodal_z[n]) spectral_field_value *= zshift_arr[k];
+#elif (AMREX_SPACEDIM == 2)
+                    if (!is_nodal_z[n]) spectral_field_value *= zshift_arr[j];
+#endif
+                    fields_arr(i,j,k,field_index[n]) = spectral_field_value;
+                });
+            }
+
+            if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+            {
+                amrex::Gpu::synchronize();
+                wt = amrex::second() - wt;
+                amrex::HostDevice::Atomic::Add( &(*cost)[mfi.index()], wt);
+            }
+        }
+    }
+}
+
+void
+SpectralFieldData::BackwardTransform (const int lev,
+                                      const amrex::Vector<TransformComponent>& components,
+                                      const amrex::IntVect& fill_guards)
+{
+    const int ncomps_total = static_cast<int>(components.size());
+
+    if (!WarpX::fft_batch_transforms || m_distributed_fft || m_single_precision_fft ||
+        ncomps_total == 1) {
+        for (const auto& c : components) {
+            BackwardTransform(lev, *c.mf, c.field_index, c.i_comp, fill_guards);
+        }
+        return;
+    }
+
+    amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
+
+    // Transform the components by groups of at most max_batch_size
+    for (int first = 0; first < ncomps_total; first += max_batch_size)
+    {
+        const int ncomps = std::min(max_batch_size, ncomps_total - first);
+        AllocateBatch(ncomps);
+
+        // Spectral index and staggering of each component
+        GpuArray<int, max_batch_size> field_index, i_comp;
+        GpuArray<int, max_batch_size> is_nodal_x, is_nodal_y, is_nodal_z;
+        for (int n = 0; n < ncomps; ++n) {
+            const TransformComponent& c = components[first+n];
+            field_index[n] = c.field_index;
+            i_comp[n] = c.i_comp;
+            is_nodal_x[n] = c.mf->is_nodal(0);
+#if (AMREX_SPACEDIM == 3)
+            is_nodal_y[n] = c.mf->is_nodal(1);
+            is_nodal_z[n] = c.mf->is_nodal(2);
+#else
+            is_nodal_y[n] = true;
+            is_nodal_z[n] = c.mf->is_nodal(1);
+#endif
+        }
+
+        // Loop over boxes
+        // Note: we do NOT OpenMP parallelize here, since we use OpenMP threads for
+        //       the iFFTs on each box!
+        for ( MFIter mfi(tmpRealFieldBatch); mfi.isValid(); ++mfi ){
+            if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+            {
+                amrex::Gpu::synchronize();
+            }
+            Real wt = amrex::second();
+
+            // Copy each spectral field to the multi-component buffer `tmpSpectralFieldBatch`,
+            // with the correcting shift factors of its staggering
+            {
+                Array4<const Complex> field_arr = SpectralFieldData::fields[mfi].array();
+                Array4<Complex> tmp_arr = tmpSpectralFieldBatch[mfi].array();
+                const Complex* xshift_arr = xshift_FFTtoCell[mfi].dataPtr();
+#if (AMREX_SPACEDIM == 3)
+                const Complex* yshift_arr = yshift_FFTtoCell[mfi].dataPtr();
+#endif
+                const Complex* zshift_arr = zshift_FFTtoCell[mfi].dataPtr();
+                const Box spectralspace_bx = tmpSpectralFieldBatch[mfi].box();
+
+                ParallelFor( spectralspace_bx, ncomps,
+                [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+                    Complex spectral_field_value = field_arr(i,j,k,field_index[n]);
+                    if (!is_nodal_x[n]) spectral_field_value *= xshift_arr[i];
+#if (AMREX_SPACEDIM == 3)
+                    if (!is_nodal_y[n]) spectral_field_value *= yshift_arr[j];
+                    if (!is_nodal_z[n]) spectral_field_value *= zshift_arr[k];
+#elif (AMREX_SPACEDIM == 2)
+                    if (!is_nodal_z[n]) spectral_field_value *= zshift_arr[j];
+#endif
+                    tmp_arr(i,j,k,n) = spectral_field_value;
+                });
+            }
+
+            // Perform the inverse Fourier transforms of all the components at once
+            AnyFFT::Execute(backward_plan_batch[mfi]);
+
+            // Copy each component of the buffer to its real-space field and normalize
+            // (with the same periodic wrapping of the last nodal point and the same
+            // treatment of the guard cells as in BackwardTransform)
+            {
+                GpuArray<Array4<Real>, max_batch_size> mf_arr;
+                // Full box of each component, and box of the cells that are filled
+                GpuArray<Box, max_batch_size> full_box, fill_box;
+                IntVect lo_union(AMREX_D_DECL(std::numeric_limits<int>::max(),
+                                              std::numeric_limits<int>::max(),
+                                              std::numeric_limits<int>::max()));
+                IntVect hi_union(AMREX_D_DECL(std::numeric_limits<int>::lowest(),
+                                              std::numeric_limits<int>::lowest(),
+                                              std::numeric_limits<int>::lowest()));
+                for (int n = 0; n < ncomps; ++n) {
+                    MultiFab& mf = *components[first+n].mf;
+                    const amrex::IntVect& mf_ng = mf.nGrowVect();
+                    mf_arr[n] = mf[mfi].array();
+                    full_box[n] = (m_periodic_single_box) ? mf.boxArray()[mfi.index()] : mf[mfi].box();
+                    fill_box[n] = full_box[n];
+                    if (m_periodic_single_box == false)
+                    {
+                        for (int dir = 0; dir < AMREX_SPACEDIM; dir++)
+                        {
+                            if (static_cast<bool>(fill_guards[dir]) == false) fill_box[n].grow(dir, -mf_ng[dir]);
+                        }
+                    }
+                    lo_union.min(fill_box[n].smallEnd());
+                    hi_union.max(fill_box[n].bigEnd());
+                }
+                const Box union_box(lo_union, hi_union);
+
+                amrex::Array4<const amrex::Real> tmp_arr = tmpRealFieldBatch[mfi].const_array();
+                const amrex::Real inv_N = 1._rt / tmpRealFieldBatch[mfi].box().numPts();
+
+                ParallelFor(union_box, ncomps, [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept
+                {
+                    const IntVect iv(AMREX_D_DECL(i,j,k));
+                    if (!fill_box[n].contains(iv)) return;
+                    const Box& bx = full_box[n];
+                    // Assume periodicity and set the last outer guard cell equal to the first one
+                    // (nj represents ny in 3D and nz in 2D)
+                    const int si = (is_nodal_x[n]) ? 1 : 0;
+                    const int lo_i = bx.smallEnd(0);
+                    const int ii = (i == lo_i + bx.length(0) - si) ? lo_i : i;
+#if   (AMREX_SPACEDIM == 2)
+                    const int sj = (is_nodal_z[n]) ? 1 : 0;
+                    const int lo_j = bx.smallEnd(1);
+                    const int jj = (j == lo_j + bx.length(1) - sj) ? lo_j : j;
+                    const int kk = k;
+#elif (AMREX_SPACEDIM == 3)
+                    const int sj = (is_nodal_y[n]) ? 1 : 0;
+                    const int sk = (is_nodal_z[n]) ? 1 : 0;
+                    const int lo_j = bx.smallEnd(1);
+                    const int lo_k = bx.smallEnd(2);
+                    const int jj = (j == lo_j + bx.length(1) - sj) ? lo_j : j;
+                    const int kk = (k == lo_k + bx.length(2) - sk) ? lo_k : k;
+#endif
+                    // Copy and normalize field
+                    mf_arr[n](i,j,k,i_comp[n]) = inv_N * tmp_arr(ii,jj,kk,n);
+                });
+            }
+
+            if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+            {
+                amrex::Gpu::synchronize();
+                wt = amrex::second() - wt;
+                amrex::HostDevice::Atomic::Add( &(*cost)[mfi.index()], wt);
+            }
+        }
+    }
+}
+
 #endif // WARPX_USE_PSATD
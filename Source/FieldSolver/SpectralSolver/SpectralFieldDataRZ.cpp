@@ -41,6 +41,9 @@ SpectralFieldDataRZ::SpectralFieldDataRZ (const int lev,
     // Allocate temporary arrays - in real space and spectral space.
     // These complex arrays will store the data just before/after the z FFT.
     // Note that the realspace_ba should not include the radial guard cells.
+    // Their data is not stored in the order of the FArrayBox, but with the modes
+    // interleaved between r and z, i.e. (i,j,mode) is at i + nr*(mode + modes*j),
+    // so that the z FFTs of all the modes of a box are done with a single plan.
     tempHTransformed = SpectralField(realspace_ba, dm, n_rz_azimuthal_modes, 0);
     tmpSpectralField = SpectralField(spectralspace_ba, dm, n_rz_azimuthal_modes, 0);
 
@@ -68,16 +71,16 @@ SpectralFieldDataRZ::SpectralFieldDataRZ (const int lev,
 #if defined(AMREX_USE_CUDA)
         // Create cuFFT plan.
         // This is alway complex to complex.
-        // This plan is for one azimuthal mode only.
+        // This plan is for all the azimuthal modes at once.
         cufftResult result;
         int fft_length[] = {grid_size[1]};
         int inembed[] = {grid_size[1]};
-        int istride = grid_size[0];
+        int istride = grid_size[0]*n_rz_azimuthal_modes;
         int idist = 1;
         int onembed[] = {grid_size[1]};
-        int ostride = grid_size[0];
+        int ostride = grid_size[0]*n_rz_azimuthal_modes;
         int odist = 1;
-        int batch = grid_size[0]; // number of ffts
+        int batch = grid_size[0]*n_rz_azimuthal_modes; // number of ffts
 #  ifdef AMREX_USE_FLOAT
         auto cufft_type = CUFFT_C2C;
 #  else
@@ -92,7 +95,7 @@ SpectralFieldDataRZ::SpectralFieldDataRZ (const int lev,
         // The backward plane is the same as the forward since the direction is passed when executed.
 #elif defined(AMREX_USE_HIP)
         const std::size_t fft_length[] = {static_cast<std::size_t>(grid_size[1])};
-        const std::size_t stride[] = {static_cast<std::size_t>(grid_size[0])};
+        const std::size_t stride[] = {static_cast<std::size_t>(grid_size[0]*n_rz_azimuthal_modes)};
         rocfft_plan_description description;
         rocfft_status result;
         result = rocfft_plan_description_create(&description);
@@ -112,7 +115,7 @@ SpectralFieldDataRZ::SpectralFieldDataRZ (const int lev,
                                     rocfft_precision_double,
 #endif
                                     1, fft_length,
-                                    grid_size[0], // number of transforms
+                                    grid_size[0]*n_rz_azimuthal_modes, // number of transforms
                                     description);
         if (result != rocfft_status_success) {
             WarpX::GetInstance().RecordWarning("Spectral solver",
@@ -128,7 +131,7 @@ SpectralFieldDataRZ::SpectralFieldDataRZ (const int lev,
                                     rocfft_precision_double,
 #endif
                                     1, fft_length,
-                                    grid_size[0], // number of transforms
+                                    grid_size[0]*n_rz_azimuthal_modes, // number of transforms
                                     description);
         if (result != rocfft_status_success) {
             WarpX::GetInstance().RecordWarning("Spectral solver",
@@ -143,21 +146,18 @@ SpectralFieldDataRZ::SpectralFieldDataRZ (const int lev,
 #else
         // Create FFTW plans.
         fftw_iodim dims[1];
-        fftw_iodim howmany_dims[2];
+        fftw_iodim howmany_dims[1];
         dims[0].n = grid_size[1];
-        dims[0].is = grid_size[0];
-        dims[0].os = grid_size[0];
-        howmany_dims[0].n = n_rz_azimuthal_modes;
-        howmany_dims[0].is = grid_size[0]*grid_size[1];
-        howmany_dims[0].os = grid_size[0]*grid_size[1];
-        howmany_dims[1].n = grid_size[0];
-        howmany_dims[1].is = 1;
-        howmany_dims[1].os = 1;
+        dims[0].is = grid_size[0]*n_rz_azimuthal_modes;
+        dims[0].os = grid_size[0]*n_rz_azimuthal_modes;
+        howmany_dims[0].n = grid_size[0]*n_rz_azimuthal_modes;
+        howmany_dims[0].is = 1;
+        howmany_dims[0].os = 1;
         forward_plan[mfi] =
             // Note that AMReX FAB are Fortran-order.
             fftw_plan_guru_dft(1, // int rank
                                dims,
-                               2, // int howmany_rank,
+                               1, // int howmany_rank,
                                howmany_dims,
                                reinterpret_cast<fftw_complex*>(tempHTransformed[mfi].dataPtr()), // fftw_complex *in
                                reinterpret_cast<fftw_complex*>(tmpSpectralField[mfi].dataPtr()), // fftw_complex *out
@@ -166,7 +166,7 @@ SpectralFieldDataRZ::SpectralFieldDataRZ (const int lev,
         backward_plan[mfi] =
             fftw_plan_guru_dft(1, // int rank
                                dims,
-                               2, // int howmany_rank,
+                               1, // int howmany_rank,
                                howmany_dims,
                                reinterpret_cast<fftw_complex*>(tmpSpectralField[mfi].dataPtr()), // fftw_complex *in
                                reinterpret_cast<fftw_complex*>(tempHTransformed[mfi].dataPtr()), // fftw_complex *out
@@ -213,17 +213,21 @@ SpectralFieldDataRZ::FABZForwardTransform (amrex::MFIter const & mfi, amrex::Box
                                            amrex::MultiFab const & tempHTransformedSplit,
                                            int const field_index, const bool is_nodal_z)
 {
-    // Copy the split complex to the interleaved complex.
+    // Copy the split complex to the interleaved complex,
+    // with the modes interleaved between r and z (see the constructor).
 
     amrex::Array4<const amrex::Real> const& split_arr = tempHTransformedSplit[mfi].array();
-    amrex::Array4<Complex> const& complex_arr = tempHTransformed[mfi].array();
+    Complex* const complex_ptr = tempHTransformed[mfi].dataPtr();
 
     int const modes = n_rz_azimuthal_modes;
+    amrex::IntVect const real_lo = realspace_bx.smallEnd();
+    int const nr = realspace_bx.length(0);
     ParallelFor(realspace_bx, modes,
     [=] AMREX_GPU_DEVICE(int i, int j, int k, int mode) noexcept {
         int const mode_r = 2*mode;
         int const mode_i = 2*mode + 1;
-        complex_arr(i,j,k,mode) = Complex{split_arr(i,j,k,mode_r), split_arr(i,j,k,mode_i)};
+        int const ii = (i - real_lo[0]) + nr*(mode + modes*(j - real_lo[1]));
+        complex_ptr[ii] = Complex{split_arr(i,j,k,mode_r), split_arr(i,j,k,mode_i)};
     });
 
     // Perform Fourier transform from `tempHTransformed` to `tmpSpectralField`.
@@ -234,19 +238,17 @@ SpectralFieldDataRZ::FABZForwardTransform (amrex::MFIter const & mfi, amrex::Box
     cufftResult result;
     cudaStream_t stream = amrex::Gpu::Device::cudaStream();
     cufftSetStream(forward_plan[mfi], stream);
-    for (int mode=0 ; mode < n_rz_azimuthal_modes ; mode++) {
 #  ifdef AMREX_USE_FLOAT
-        result = cufftExecC2C(forward_plan[mfi],
+    result = cufftExecC2C(forward_plan[mfi],
 #  else
-        result = cufftExecZ2Z(forward_plan[mfi],
+    result = cufftExecZ2Z(forward_plan[mfi],
 #  endif
-                              reinterpret_cast<AnyFFT::Complex*>(tempHTransformed[mfi].dataPtr(mode)), // Complex *in
-                              reinterpret_cast<AnyFFT::Complex*>(tmpSpectralField[mfi].dataPtr(mode)), // Complex *out
-                              CUFFT_FORWARD);
-        if (result != CUFFT_SUCCESS) {
-            WarpX::GetInstance().RecordWarning("Spectral solver",
-                "forward transform using cufftExecZ2Z failed!", WarnPriority::high);
-        }
+                          reinterpret_cast<AnyFFT::Complex*>(tempHTransformed[mfi].dataPtr()), // Complex *in
+                          reinterpret_cast<AnyFFT::Complex*>(tmpSpectralField[mfi].dataPtr()), // Complex *out
+                          CUFFT_FORWARD);
+    if (result != CUFFT_SUCCESS) {
+        WarpX::GetInstance().RecordWarning("Spectral solver",
+            "forward transform using cufftExecZ2Z failed!", WarnPriority::high);
     }
 #elif defined(AMREX_USE_HIP)
     rocfft_execution_info execinfo = NULL;
@@ -257,14 +259,12 @@ SpectralFieldDataRZ::FABZForwardTransform (amrex::MFIter const & mfi, amrex::Box
     result = rocfft_execution_info_set_work_buffer(execinfo, buffer, buffersize);
     result = rocfft_execution_info_set_stream(execinfo, amrex::Gpu::gpuStream());
 
-    for (int mode=0 ; mode < n_rz_azimuthal_modes ; mode++) {
-        void* in_array[] = {(void*)(tempHTransformed[mfi].dataPtr(mode))};
-        void* out_array[] = {(void*)(tmpSpectralField[mfi].dataPtr(mode))};
-        result = rocfft_execute(forward_plan[mfi], in_array, out_array, execinfo);
-        if (result != rocfft_status_success) {
-            WarpX::GetInstance().RecordWarning("Spectral solver",
-                "forward transform using rocfft_execute failed!", WarnPriority::high);
-        }
+    void* in_array[] = {(void*)(tempHTransformed[mfi].dataPtr())};
+    void* out_array[] = {(void*)(tmpSpectralField[mfi].dataPtr())};
+    result = rocfft_execute(forward_plan[mfi], in_array, out_array, execinfo);
+    if (result != rocfft_status_success) {
+        WarpX::GetInstance().RecordWarning("Spectral solver",
+            "forward transform using rocfft_execute failed!", WarnPriority::high);
     }
 
     amrex::Gpu::streamSynchronize();
@@ -278,7 +278,7 @@ SpectralFieldDataRZ::FABZForwardTransform (amrex::MFIter const & mfi, amrex::Box
     // index of the FabArray `fields` (specified by `field_index`)
     // and apply correcting shift factor if the real space data comes
     // from a cell-centered grid in real space instead of a nodal grid.
-    amrex::Array4<const Complex> const& tmp_arr = tmpSpectralField[mfi].array();
+    Complex const* const tmp_ptr = tmpSpectralField[mfi].dataPtr();
     amrex::Array4<Complex> const& fields_arr = fields[mfi].array();
     Complex const* zshift_arr = zshift_FFTfromCell[mfi].dataPtr();
 
@@ -289,10 +289,13 @@ SpectralFieldDataRZ::FABZForwardTransform (amrex::MFIter const & mfi, amrex::Box
     int const nz = spectralspace_bx.length(1);
     amrex::Real inv_nz = 1._rt/nz;
     const int n_fields = m_n_fields;
+    amrex::IntVect const spectral_lo = spectralspace_bx.smallEnd();
+    int const nkr = spectralspace_bx.length(0);
 
     ParallelFor(spectralspace_bx, modes,
     [=] AMREX_GPU_DEVICE(int i, int j, int k, int mode) noexcept {
-        Complex spectral_field_value = tmp_arr(i,j,k,mode);
+        int const ii = (i - spectral_lo[0]) + nkr*(mode + modes*(j - spectral_lo[1]));
+        Complex spectral_field_value = tmp_ptr[ii];
         // Apply proper shift.
         if (is_nodal_z==false) spectral_field_value *= zshift_arr[j];
         // Copy field into the correct index.
@@ -319,7 +322,7 @@ SpectralFieldDataRZ::FABZBackwardTransform (amrex::MFIter const & mfi, amrex::Bo
     // and apply correcting shift factor if the real space data is on
     // a cell-centered grid in real space instead of a nodal grid.
     amrex::Array4<const Complex> const& fields_arr = fields[mfi].array();
-    amrex::Array4<Complex> const& tmp_arr = tmpSpectralField[mfi].array();
+    Complex* const tmp_ptr = tmpSpectralField[mfi].dataPtr();
     Complex const* zshift_arr = zshift_FFTtoCell[mfi].dataPtr();
 
     // Loop over indices within one box, all components.
@@ -327,14 +330,18 @@ SpectralFieldDataRZ::FABZBackwardTransform (amrex::MFIter const & mfi, amrex::Bo
 
     int const modes = n_rz_azimuthal_modes;
     const int n_fields = m_n_fields;
+    amrex::IntVect const spectral_lo = spectralspace_bx.smallEnd();
+    int const nkr = spectralspace_bx.length(0);
     ParallelFor(spectralspace_bx, modes,
     [=] AMREX_GPU_DEVICE(int i, int j, int k, int mode) noexcept {
         int const ic = field_index + mode*n_fields;
         Complex spectral_field_value = fields_arr(i,j,k,ic);
         // Apply proper shift.
         if (is_nodal_z==false) spectral_field_value *= zshift_arr[j];
-        // Copy field into the right index.
-        tmp_arr(i,j,k,mode) = spectral_field_value;
+        // Copy field into the right index
+        // (with the modes interleaved between r and z, see the constructor).
+        int const ii = (i - spectral_lo[0]) + nkr*(mode + modes*(j - spectral_lo[1]));
+        tmp_ptr[ii] = spectral_field_value;
     });
 
     // Perform Fourier transform from `tmpSpectralField` to `tempHTransformed`.
@@ -345,19 +352,17 @@ SpectralFieldDataRZ::FABZBackwardTransform (amrex::MFIter const & mfi, amrex::Bo
     cufftResult result;
     cudaStream_t stream = amrex::Gpu::Device::cudaStream();
     cufftSetStream(forward_plan[mfi], stream);
-    for (int mode=0 ; mode < n_rz_azimuthal_modes ; mode++) {
 #  ifdef AMREX_USE_FLOAT
-        result = cufftExecC2C(forward_plan[mfi],
+    result = cufftExecC2C(forward_plan[mfi],
 #  else
-        result = cufftExecZ2Z(forward_plan[mfi],
+    result = cufftExecZ2Z(forward_plan[mfi],
 #  endif
-                              reinterpret_cast<AnyFFT::Complex*>(tmpSpectralField[mfi].dataPtr(mode)), // Complex *in
-                              reinterpret_cast<AnyFFT::Complex*>(tempHTransformed[mfi].dataPtr(mode)), // Complex *out
-                              CUFFT_INVERSE);
-        if (result != CUFFT_SUCCESS) {
-            WarpX::GetInstance().RecordWarning("Spectral solver",
-                "backwardtransform using cufftExecZ2Z failed!", WarnPriority::high);
-        }
+                          reinterpret_cast<AnyFFT::Complex*>(tmpSpectralField[mfi].dataPtr()), // Complex *in
+                          reinterpret_cast<AnyFFT::Complex*>(tempHTransformed[mfi].dataPtr()), // Complex *out
+                          CUFFT_INVERSE);
+    if (result != CUFFT_SUCCESS) {
+        WarpX::GetInstance().RecordWarning("Spectral solver",
+            "backwardtransform using cufftExecZ2Z failed!", WarnPriority::high);
     }
 #elif defined(AMREX_USE_HIP)
     rocfft_execution_info execinfo = NULL;
@@ -368,14 +373,12 @@ SpectralFieldDataRZ::FABZBackwardTransform (amrex::MFIter const & mfi, amrex::Bo
     result = rocfft_execution_info_set_work_buffer(execinfo, buffer, buffersize);
     result = rocfft_execution_info_set_stream(execinfo, amrex::Gpu::gpuStream());
 
-    for (int mode=0 ; mode < n_rz_azimuthal_modes ; mode++) {
-        void* in_array[] = {(void*)(tmpSpectralField[mfi].dataPtr(mode))};
-        void* out_array[] = {(void*)(tempHTransformed[mfi].dataPtr(mode))};
-        result = rocfft_execute(backward_plan[mfi], in_array, out_array, execinfo);
-        if (result != rocfft_status_success) {
-            WarpX::GetInstance().RecordWarning("Spectral solver",
-                "forward transform using rocfft_execute failed!", WarnPriority::high);
-        }
+    void* in_array[] = {(void*)(tmpSpectralField[mfi].dataPtr())};
+    void* out_array[] = {(void*)(tempHTransformed[mfi].dataPtr())};
+    result = rocfft_execute(backward_plan[mfi], in_array, out_array, execinfo);
+    if (result != rocfft_status_success) {
+        WarpX::GetInstance().RecordWarning("Spectral solver",
+            "forward transform using rocfft_execute failed!", WarnPriority::high);
     }
 
     amrex::Gpu::streamSynchronize();
@@ -387,14 +390,17 @@ SpectralFieldDataRZ::FABZBackwardTransform (amrex::MFIter const & mfi, amrex::Bo
 
     // Copy the interleaved complex to the split complex.
     amrex::Array4<amrex::Real> const& split_arr = tempHTransformedSplit[mfi].array();
-    amrex::Array4<const Complex> const& complex_arr = tempHTransformed[mfi].array();
+    Complex const* const complex_ptr = tempHTransformed[mfi].dataPtr();
 
+    amrex::IntVect const real_lo = realspace_bx.smallEnd();
+    int const nr = realspace_bx.length(0);
     ParallelFor(realspace_bx, modes,
     [=] AMREX_GPU_DEVICE(int i, int j, int k, int mode) noexcept {
         int const mode_r = 2*mode;
         int const mode_i = 2*mode + 1;
-        split_arr(i,j,k,mode_r) = complex_arr(i,j,k,mode).real();
-        split_arr(i,j,k,mode_i) = complex_arr(i,j,k,mode).imag();
+        int const ii = (i - real_lo[0]) + nr*(mode + modes*(j - real_lo[1]));
+        split_arr(i,j,k,mode_r) = complex_ptr[ii].real();
+        split_arr(i,j,k,mode_i) = complex_ptr[ii].imag();
     });
 
 }
@@ -183,7 +183,8 @@ HankelTransform::HankelTransform (int const hankel_order,
 
 void
 HankelTransform::HankelForwardTransform (amrex::FArrayBox const& F, int const F_icomp,
-                                         amrex::FArrayBox      & G, int const G_icomp)
+                                         amrex::FArrayBox      & G, int const G_icomp,
+                                         int const ncomp)
 {
     amrex::Box const& F_box = F.box();
     amrex::Box const& G_box = G.box();
@@ -201,8 +202,10 @@ HankelTransform::HankelForwardTransform (amrex::FArrayBox const& F, int const F_
     // On CPU, the blas::gemm is significantly faster
 
     // Note that M is flagged to be transposed since it has dimensions (m_nr, m_nk)
+    // The consecutive components of F and G are contiguous, so that they are
+    // transformed together, as nz*ncomp columns
     blas::gemm(blas::Layout::ColMajor, blas::Op::Trans, blas::Op::NoTrans,
-               m_nk, nz, m_nr, 1._rt,
+               m_nk, nz*ncomp, m_nr, 1._rt,
                m_M.dataPtr(), m_nk,
                F.dataPtr(F_icomp)+ngr, nrF, 0._rt,
                G.dataPtr(G_icomp), m_nk);
@@ -218,13 +221,14 @@ HankelTransform::HankelForwardTransform (amrex::FArrayBox const& F, int const F_
 
     int const nr = m_nr;
 
-    amrex::ParallelFor(G_box,
-    [=] AMREX_GPU_DEVICE(int ik, int iz, int inotused) noexcept {
-        G_arr(ik,iz,G_icomp) = 0.;
+    amrex::ParallelFor(G_box, ncomp,
+    [=] AMREX_GPU_DEVICE(int ik, int iz, int k, int n) noexcept {
+        amrex::Real sum = 0._rt;
         for (int ir=0 ; ir < nr ; ir++) {
             int const ii = ir + ik*nr;
-            G_arr(ik,iz,G_icomp) += M_arr[ii]*F_arr(ir,iz,F_icomp);
+            sum += M_arr[ii]*F_arr(ir,iz,k,F_icomp+n);
         }
+        G_arr(ik,iz,k,G_icomp+n) = sum;
     });
 
 #endif
@@ -233,7 +237,8 @@ HankelTransform::HankelForwardTransform (amrex::FArrayBox const& F, int const F_
 
 void
 HankelTransform::HankelInverseTransform (amrex::FArrayBox const& G, int const G_icomp,
-                                         amrex::FArrayBox      & F, int const F_icomp)
+                                         amrex::FArrayBox      & F, int const F_icomp,
+                                         int const ncomp)
 {
     amrex::Box const& G_box = G.box();
     amrex::Box const& F_box = F.box();
@@ -251,8 +256,10 @@ HankelTransform::HankelInverseTransform (amrex::FArrayBox const& G, int const G_
     // On CPU, the blas::gemm is significantly faster
 
     // Note that m_invM is flagged to be transposed since it has dimensions (m_nk, m_nr)
+    // The consecutive components of F and G are contiguous, so that they are
+    // transformed together, as nz*ncomp columns
     blas::gemm(blas::Layout::ColMajor, blas::Op::Trans, blas::Op::NoTrans,
-               m_nr, nz, m_nk, 1._rt,
+               m_nr, nz*ncomp, m_nk, 1._rt,
                m_invM.dataPtr(), m_nr,
                G.dataPtr(G_icomp), m_nk, 0._rt,
                F.dataPtr(F_icomp)+ngr, nrF);
@@ -268,13 +275,14 @@ HankelTransform::HankelInverseTransform (amrex::FArrayBox const& G, int const G_
 
     int const nk = m_nk;
 
-    amrex::ParallelFor(G_box,
-    [=] AMREX_GPU_DEVICE(int ir, int iz, int inotused) noexcept {
-        F_arr(ir,iz,F_icomp) = 0.;
+    amrex::ParallelFor(G_box, ncomp,
+    [=] AMREX_GPU_DEVICE(int ir, int iz, int k, int n) noexcept {
+        amrex::Real sum = 0._rt;
         for (int ik=0 ; ik < nk ; ik++) {
             int const ii = ik + ir*nk;
-            F_arr(ir,iz,F_icomp) += invM_arr[ii]*G_arr(ik,iz,G_icomp);
+            sum += invM_arr[ii]*G_arr(ik,iz,k,G_icomp+n);
         }
+        F_arr(ir,iz,k,F_icomp+n) = sum;
     });
 
 #endif
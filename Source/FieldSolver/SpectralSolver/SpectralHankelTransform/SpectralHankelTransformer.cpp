@@ -27,9 +27,38 @@ SpectralHankelTransformer::SpectralHankelTransformer (int const nr,
     }
 
     ExtractKrArray();
+    ExtractMatrices();
 
 }
 
+/* \brief Stores the device pointers to the matrices of the transforms of all the modes */
+void
+SpectralHankelTransformer::ExtractMatrices ()
+{
+    amrex::Vector<amrex::Real const *> M0, Mp, Mm, invM0, invMp, invMm;
+    for (int mode=0 ; mode < m_n_rz_azimuthal_modes ; mode++) {
+        M0.push_back(dht0[mode]->getForwardMatrix());
+        Mp.push_back(dhtp[mode]->getForwardMatrix());
+        Mm.push_back(dhtm[mode]->getForwardMatrix());
+        invM0.push_back(dht0[mode]->getInverseMatrix());
+        invMp.push_back(dhtp[mode]->getInverseMatrix());
+        invMm.push_back(dhtm[mode]->getInverseMatrix());
+    }
+
+    const auto copy_to_device = [] (amrex::Vector<amrex::Real const *> const & h, MatrixVector & d)
+    {
+        d.resize(h.size());
+        amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, h.begin(), h.end(), d.begin());
+    };
+    copy_to_device(M0, m_M0);
+    copy_to_device(Mp, m_Mp);
+    copy_to_device(Mm, m_Mm);
+    copy_to_device(invM0, m_invM0);
+    copy_to_device(invMp, m_invMp);
+    copy_to_device(invMm, m_invMm);
+    amrex::Gpu::synchronize();
+}
+
 /* \brief Extracts the kr for all of the modes
  * This needs to be separate since the ParallelFor cannot be in the constructor. */
 void
@@ -65,6 +94,31 @@ SpectralHankelTransformer::PhysicalToSpectral_Scalar (amrex::FArrayBox const & F
     // can be done.
     // Note that F_physical does not include the imaginary part of mode 0,
     // but G_spectral does.
+#ifdef AMREX_USE_GPU
+    // On GPU, all the modes are transformed with one kernel
+    amrex::Real const * const * M_arr = m_M0.dataPtr();
+    amrex::Array4<const amrex::Real> const & F_arr = F_physical.const_array();
+    amrex::Array4<      amrex::Real> const & G_arr = G_spectral.array();
+
+    int const nr = m_nr;
+
+    amrex::ParallelFor(G_spectral.box(), 2*m_n_rz_azimuthal_modes,
+    [=] AMREX_GPU_DEVICE(int ik, int iz, int k, int n) noexcept {
+        // Imaginary part of mode 0
+        if (n == 1) {
+            G_arr(ik,iz,k,n) = 0.;
+            return;
+        }
+        int const mode = n/2;
+        int const icomp = (n == 0) ? 0 : n - 1;
+        amrex::Real const * M = M_arr[mode];
+        amrex::Real sum = 0.;
+        for (int ir=0 ; ir < nr ; ir++) {
+            sum += M[ir + ik*nr]*F_arr(ir,iz,k,icomp);
+        }
+        G_arr(ik,iz,k,n) = sum;
+    });
+#else
     for (int mode=0 ; mode < m_n_rz_azimuthal_modes ; mode++) {
         int const mode_r = 2*mode;
         int const mode_i = 2*mode + 1;
@@ -73,11 +127,12 @@ SpectralHankelTransformer::PhysicalToSpectral_Scalar (amrex::FArrayBox const & F
             dht0[mode]->HankelForwardTransform(F_physical, icomp, G_spectral, mode_r);
             G_spectral.setVal<amrex::RunOn::Device>(0., mode_i);
         } else {
+            // The real and imaginary parts are transformed together
             int const icomp = 2*mode - 1;
-            dht0[mode]->HankelForwardTransform(F_physical, icomp  , G_spectral, mode_r);
-            dht0[mode]->HankelForwardTransform(F_physical, icomp+1, G_spectral, mode_i);
+            dht0[mode]->HankelForwardTransform(F_physical, icomp, G_spectral, mode_r, 2);
         }
     }
+#endif
 }
 
 /* \brief Converts a vector field from the physical to the spectral space for all modes */
@@ -96,35 +151,61 @@ SpectralHankelTransformer::PhysicalToSpectral_Vector (amrex::Box const & box,
     amrex::Array4<amrex::Real> const & F_r_physical_array = F_r_physical.array();
     amrex::Array4<amrex::Real> const & F_t_physical_array = F_t_physical.array();
 
-    for (int mode=0 ; mode < m_n_rz_azimuthal_modes ; mode++) {
-
+    // Combine the values, for all the modes
+    amrex::ParallelFor(box, m_n_rz_azimuthal_modes,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k, int mode)
+    {
         int const mode_r = 2*mode;
         int const mode_i = 2*mode + 1;
-
-        amrex::ParallelFor(box,
-        [=] AMREX_GPU_DEVICE (int i, int j, int k)
-        {
-            amrex::Real const r_real = F_r_physical_array(i,j,k,mode_r);
-            amrex::Real const r_imag = F_r_physical_array(i,j,k,mode_i);
-            amrex::Real const t_real = F_t_physical_array(i,j,k,mode_r);
-            amrex::Real const t_imag = F_t_physical_array(i,j,k,mode_i);
-            // Combine the values
-            // temp_p = (F_r - I*F_t)/2
-            // temp_m = (F_r + I*F_t)/2
-            F_r_physical_array(i,j,k,mode_r) = 0.5_rt*(r_real + t_imag);
-            F_r_physical_array(i,j,k,mode_i) = 0.5_rt*(r_imag - t_real);
-            F_t_physical_array(i,j,k,mode_r) = 0.5_rt*(r_real - t_imag);
-            F_t_physical_array(i,j,k,mode_i) = 0.5_rt*(r_imag + t_real);
-        });
-
-        amrex::Gpu::streamSynchronize();
-
-        dhtp[mode]->HankelForwardTransform(F_r_physical, mode_r, G_p_spectral, mode_r);
-        dhtp[mode]->HankelForwardTransform(F_r_physical, mode_i, G_p_spectral, mode_i);
-        dhtm[mode]->HankelForwardTransform(F_t_physical, mode_r, G_m_spectral, mode_r);
-        dhtm[mode]->HankelForwardTransform(F_t_physical, mode_i, G_m_spectral, mode_i);
-
+        amrex::Real const r_real = F_r_physical_array(i,j,k,mode_r);
+        amrex::Real const r_imag = F_r_physical_array(i,j,k,mode_i);
+        amrex::Real const t_real = F_t_physical_array(i,j,k,mode_r);
+        amrex::Real const t_imag = F_t_physical_array(i,j,k,mode_i);
+        // Combine the values
+        // temp_p = (F_r - I*F_t)/2
+        // temp_m = (F_r + I*F_t)/2
+        F_r_physical_array(i,j,k,mode_r) = 0.5_rt*(r_real + t_imag);
+        F_r_physical_array(i,j,k,mode_i) = 0.5_rt*(r_imag - t_real);
+        F_t_physical_array(i,j,k,mode_r) = 0.5_rt*(r_real - t_imag);
+        F_t_physical_array(i,j,k,mode_i) = 0.5_rt*(r_imag + t_real);
+    });
+
+#ifdef AMREX_USE_GPU
+    // On GPU, all the modes of both fields are transformed with one kernel:
+    // the components n < ncomp are those of G_p, and the others those of G_m
+    amrex::Real const * const * Mp_arr = m_Mp.dataPtr();
+    amrex::Real const * const * Mm_arr = m_Mm.dataPtr();
+    amrex::Array4<amrex::Real> const & G_p_spectral_array = G_p_spectral.array();
+    amrex::Array4<amrex::Real> const & G_m_spectral_array = G_m_spectral.array();
+
+    int const nr = m_nr;
+    int const ncomp = 2*m_n_rz_azimuthal_modes;
+
+    amrex::ParallelFor(G_p_spectral.box(), 2*ncomp,
+    [=] AMREX_GPU_DEVICE(int ik, int iz, int k, int n) noexcept {
+        bool const is_p = (n < ncomp);
+        int const icomp = (is_p) ? n : n - ncomp;
+        int const mode = icomp/2;
+        amrex::Real const * M = (is_p) ? Mp_arr[mode] : Mm_arr[mode];
+        amrex::Array4<amrex::Real> const & F_arr = (is_p) ? F_r_physical_array : F_t_physical_array;
+        amrex::Real sum = 0.;
+        for (int ir=0 ; ir < nr ; ir++) {
+            sum += M[ir + ik*nr]*F_arr(ir,iz,k,icomp);
+        }
+        if (is_p) {
+            G_p_spectral_array(ik,iz,k,icomp) = sum;
+        } else {
+            G_m_spectral_array(ik,iz,k,icomp) = sum;
+        }
+    });
+#else
+    for (int mode=0 ; mode < m_n_rz_azimuthal_modes ; mode++) {
+        // The real and imaginary parts are transformed together
+        int const mode_r = 2*mode;
+        dhtp[mode]->HankelForwardTransform(F_r_physical, mode_r, G_p_spectral, mode_r, 2);
+        dhtm[mode]->HankelForwardTransform(F_t_physical, mode_r, G_m_spectral, mode_r, 2);
     }
+#endif
 }
 
 /* \brief Converts a scalar field from the spectral to the physical space for all modes */
@@ -140,18 +221,39 @@ SpectralHankelTransformer::SpectralToPhysical_Scalar (amrex::FArrayBox const & G
 
     amrex::Gpu::streamSynchronize();
 
+#ifdef AMREX_USE_GPU
+    // On GPU, all the modes are transformed with one kernel
+    amrex::Real const * const * invM_arr = m_invM0.dataPtr();
+    amrex::Array4<const amrex::Real> const & G_arr = G_spectral.const_array();
+    amrex::Array4<      amrex::Real> const & F_arr = F_physical.array();
+
+    int const nk = m_nr;
+
+    amrex::ParallelFor(G_spectral.box(), 2*m_n_rz_azimuthal_modes - 1,
+    [=] AMREX_GPU_DEVICE(int ir, int iz, int k, int n) noexcept {
+        // The imaginary part of mode 0 is skipped
+        int const mode = (n + 1)/2;
+        int const gcomp = (n == 0) ? 0 : n + 1;
+        amrex::Real const * invM = invM_arr[mode];
+        amrex::Real sum = 0.;
+        for (int ik=0 ; ik < nk ; ik++) {
+            sum += invM[ik + ir*nk]*G_arr(ik,iz,k,gcomp);
+        }
+        F_arr(ir,iz,k,n) = sum;
+    });
+#else
     for (int mode=0 ; mode < m_n_rz_azimuthal_modes ; mode++) {
         int const mode_r = 2*mode;
-        int const mode_i = 2*mode + 1;
         if (mode == 0) {
             int const icomp = 0;
             dht0[mode]->HankelInverseTransform(G_spectral, mode_r, F_physical, icomp);
         } else {
+            // The real and imaginary parts are transformed together
             int const icomp = 2*mode - 1;
-            dht0[mode]->HankelInverseTransform(G_spectral, mode_r, F_physical, icomp);
-            dht0[mode]->HankelInverseTransform(G_spectral, mode_i, F_physical, icomp+1);
+            dht0[mode]->HankelInverseTransform(G_spectral, mode_r, F_physical, icomp, 2);
         }
     }
+#endif
 }
 
 /* \brief Converts a vector field from the spectral to the physical space for all modes */
@@ -167,35 +269,61 @@ SpectralHankelTransformer::SpectralToPhysical_Vector (amrex::Box const & box,
     amrex::Array4<amrex::Real> const & F_r_physical_array = F_r_physical.array();
     amrex::Array4<amrex::Real> const & F_t_physical_array = F_t_physical.array();
 
+    amrex::Gpu::streamSynchronize();
+
+#ifdef AMREX_USE_GPU
+    // On GPU, all the modes of both fields are transformed with one kernel:
+    // the components n < ncomp are those of F_r (from G_p), and the others those of F_t (from G_m)
+    amrex::Real const * const * invMp_arr = m_invMp.dataPtr();
+    amrex::Real const * const * invMm_arr = m_invMm.dataPtr();
+    amrex::Array4<const amrex::Real> const & G_p_spectral_array = G_p_spectral.const_array();
+    amrex::Array4<const amrex::Real> const & G_m_spectral_array = G_m_spectral.const_array();
+
+    int const nk = m_nr;
+    int const ncomp = 2*m_n_rz_azimuthal_modes;
+
+    amrex::ParallelFor(G_p_spectral.box(), 2*ncomp,
+    [=] AMREX_GPU_DEVICE(int ir, int iz, int k, int n) noexcept {
+        bool const is_p = (n < ncomp);
+        int const icomp = (is_p) ? n : n - ncomp;
+        int const mode = icomp/2;
+        amrex::Real const * invM = (is_p) ? invMp_arr[mode] : invMm_arr[mode];
+        amrex::Array4<const amrex::Real> const & G_arr = (is_p) ? G_p_spectral_array : G_m_spectral_array;
+        amrex::Real sum = 0.;
+        for (int ik=0 ; ik < nk ; ik++) {
+            sum += invM[ik + ir*nk]*G_arr(ik,iz,k,icomp);
+        }
+        if (is_p) {
+            F_r_physical_array(ir,iz,k,icomp) = sum;
+        } else {
+            F_t_physical_array(ir,iz,k,icomp) = sum;
+        }
+    });
+#else
     for (int mode=0 ; mode < m_n_rz_azimuthal_modes ; mode++) {
+        // The real and imaginary parts are transformed together
+        int const mode_r = 2*mode;
+        dhtp[mode]->HankelInverseTransform(G_p_spectral, mode_r, F_r_physical, mode_r, 2);
+        dhtm[mode]->HankelInverseTransform(G_m_spectral, mode_r, F_t_physical, mode_r, 2);
+    }
+#endif
 
+    // Combine the values, for all the modes
+    amrex::ParallelFor(box, m_n_rz_azimuthal_modes,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k, int mode)
+    {
         int const mode_r = 2*mode;
         int const mode_i = 2*mode + 1;
-
-        amrex::Gpu::streamSynchronize();
-
-        dhtp[mode]->HankelInverseTransform(G_p_spectral, mode_r, F_r_physical, mode_r);
-        dhtp[mode]->HankelInverseTransform(G_p_spectral, mode_i, F_r_physical, mode_i);
-        dhtm[mode]->HankelInverseTransform(G_m_spectral, mode_r, F_t_physical, mode_r);
-        dhtm[mode]->HankelInverseTransform(G_m_spectral, mode_i, F_t_physical, mode_i);
-
-        amrex::Gpu::streamSynchronize();
-
-        amrex::ParallelFor(box,
-        [=] AMREX_GPU_DEVICE (int i, int j, int k)
-        {
-            amrex::Real const p_real = F_r_physical_array(i,j,k,mode_r);
-            amrex::Real const p_imag = F_r_physical_array(i,j,k,mode_i);
-            amrex::Real const m_real = F_t_physical_array(i,j,k,mode_r);
-            amrex::Real const m_imag = F_t_physical_array(i,j,k,mode_i);
-            // Combine the values
-            // F_r =    G_p + G_m
-            // F_t = I*(G_p - G_m)
-            F_r_physical_array(i,j,k,mode_r) =  p_real + m_real;
-            F_r_physical_array(i,j,k,mode_i) =  p_imag + m_imag;
-            F_t_physical_array(i,j,k,mode_r) = -p_imag + m_imag;
-            F_t_physical_array(i,j,k,mode_i) =  p_real - m_real;
-        });
-
-    }
+        amrex::Real const p_real = F_r_physical_array(i,j,k,mode_r);
+        amrex::Real const p_imag = F_r_physical_array(i,j,k,mode_i);
+        amrex::Real const m_real = F_t_physical_array(i,j,k,mode_r);
+        amrex::Real const m_imag = F_t_physical_array(i,j,k,mode_i);
+        // Combine the values
+        // F_r =    G_p + G_m
+        // F_t = I*(G_p - G_m)
+        F_r_physical_array(i,j,k,mode_r) =  p_real + m_real;
+        F_r_physical_array(i,j,k,mode_i) =  p_imag + m_imag;
+        F_t_physical_array(i,j,k,mode_r) = -p_imag + m_imag;
+        F_t_physical_array(i,j,k,mode_i) =  p_real - m_real;
+    });
 }
@@ -78,9 +78,52 @@ SpectralKSpace::SpectralKSpace( const BoxArray& realspace_ba,
     }
 }
 
+/* \brief Initialize k space object, for the distributed FFTs over the whole domain.
+ *
+ * \param layout Slab decompositions of the domain used by the distributed FFTs
+ * \param realspace_dx Cell size of the grid in real space
+ */
+SpectralKSpace::SpectralKSpace( const DistributedFFTLayout& layout,
+                                const RealVect realspace_dx )
+    : dx(realspace_dx)
+{
+    m_global_spectralspace_ba = layout.spectral_ba;
+    m_global_fft_size = layout.realspace_domain.length();
+
+    // As for the local FFTs, boxes in spectral space start at 0 in each direction
+    BoxList spectral_bl;
+    for (int i=0; i < layout.spectral_ba.size(); i++ ) {
+        const Box& global_bx = layout.spectral_ba[i];
+        spectral_bl.push_back( Box( IntVect::TheZeroVector(),
+                                    global_bx.length() - IntVect::TheUnitVector() ) );
+    }
+    spectralspace_ba.define( spectral_bl );
+
+    // Allocate the components of the k vector: kx, ky (only in 3D), kz
+    // (real-to-complex FFTs: first axis contains only the positive k)
+    for (int i_dim=0; i_dim<AMREX_SPACEDIM; i_dim++) {
+        k_vec[i_dim] = getKComponent(layout.spectral_dm, spectralspace_ba, i_dim, i_dim==0);
+    }
+}
+
+void
+SpectralKSpace::getGlobalIndexing( const int ibox, const int i_dim,
+                                   int& offset, int& n_global ) const
+{
+    if (m_global_spectralspace_ba.empty()) {
+        offset = 0;
+        n_global = spectralspace_ba[ibox].length(i_dim);
+    } else {
+        offset = m_global_spectralspace_ba[ibox].smallEnd(i_dim);
+        n_global = (i_dim == 0) ? m_global_fft_size[0]/2 + 1 : m_global_fft_size[i_dim];
+    }
+}
+
 /* For each box, in `spectralspace_ba`, which is owned by the local MPI rank
  * (as indicated by the argument `dm`), compute the values of the
  * corresponding k coordinate along the dimension specified by `i_dim`
+ * (for the distributed FFTs, `realspace_ba` is not used: the values are those
+ * of the global FFT, at the global indices of the box)
  */
 KVectorComponent
 SpectralKSpace::getKComponent( const DistributionMapping& dm,
@@ -102,31 +145,36 @@ SpectralKSpace::getKComponent( const DistributionMapping& dm,
         Real* pk = k.data();
 
         // Fill the k vector
-        IntVect fft_size = realspace_ba[mfi].length();
+        IntVect fft_size = (m_global_spectralspace_ba.empty()) ?
+            realspace_ba[mfi].length() : m_global_fft_size;
         const Real dk = 2*MathConst::pi/(fft_size[i_dim]*dx[i_dim]);
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE( bx.smallEnd(i_dim) == 0,
             "Expected box to start at 0, in spectral space.");
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE( bx.bigEnd(i_dim) == N-1,
             "Expected different box end index in spectral space.");
+        // Global index of the first point of the box, and global number of points
+        int offset, N_global;
+        getGlobalIndexing(mfi.index(), i_dim, offset, N_global);
         if (only_positive_k){
             // Fill the full axis with positive k values
             // (typically: first axis, in a real-to-complex FFT)
             amrex::ParallelFor(N, [=] AMREX_GPU_DEVICE (int i) noexcept
             {
-                pk[i] = i*dk;
+                pk[i] = (i+offset)*dk;
             });
         } else {
-            const int mid_point = (N+1)/2;
+            const int mid_point = (N_global+1)/2;
             amrex::ParallelFor(N, [=] AMREX_GPU_DEVICE (int i) noexcept
             {
-                if (i < mid_point) {
+                const int ig = i + offset;
+                if (ig < mid_point) {
                     // Fill positive values of k
                     // (FFT conventions: first half is positive)
-                    pk[i] = i*dk;
+                    pk[i] = ig*dk;
                 } else {
                     // Fill negative values of k
                     // (FFT conventions: second half is negative)
-                    pk[i] = (i-N)*dk;
+                    pk[i] = (ig-N_global)*dk;
                 }
             });
         }
@@ -235,6 +283,9 @@ SpectralKSpace::getModifiedKComponent( const DistributionMapping& dm,
             modified_k.resize(N);
             Real const* p_k = k.data();
             Real * p_modified_k = modified_k.data();
+            // Global index of the first point of the box, and global number of points
+            int offset, N_global;
+            getGlobalIndexing(mfi.index(), i_dim, offset, N_global);
 
             // Fill the modified k vector
             amrex::ParallelFor(N, [=] AMREX_GPU_DEVICE (int i) noexcept
@@ -260,13 +311,13 @@ SpectralKSpace::getModifiedKComponent( const DistributionMapping& dm,
                         // Because of the real-to-complex FFTs, the first axis (idim=0)
                         // contains only the positive k, and the Nyquist frequency is
                         // the last element of the array.
-                        if (i == N-1) {
+                        if (i+offset == N_global-1) {
                             p_modified_k[i] = 0.0_rt;
                         }
                     } else {
                         // The other axes contains both positive and negative k ;
                         // the Nyquist frequency is in the middle of the array.
-                        if (i == N/2) {
+                        if (i+offset == N_global/2) {
                             p_modified_k[i] = 0.0_rt;
                         }
                     }
@@ -6,12 +6,18 @@
  */
 #include "FieldSolver/SpectralSolver/SpectralAlgorithms/SpectralBaseAlgorithm.H"
 #include "FieldSolver/SpectralSolver/SpectralFieldData.H"
+#include "DistributedFFTLayout.H"
 #include "SpectralAlgorithms/ComovingPsatdAlgorithm.H"
 #include "SpectralAlgorithms/PMLPsatdAlgorithm.H"
 #include "SpectralAlgorithms/PsatdAlgorithm.H"
 #include "SpectralKSpace.H"
 #include "SpectralSolver.H"
 #include "Utils/WarpXProfilerWrapper.H"
+#include "Utils/WarpXUtil.H"
+#include "WarpX.H"
+
+#include <AMReX_BLassert.H>
+#include <AMReX_Box.H>
 
 #include <memory>
 
@@ -28,18 +34,34 @@ SpectralSolver::SpectralSolver(
                 const amrex::Vector<amrex::Real>& v_comoving,
                 const amrex::RealVect dx, const amrex::Real dt,
                 const bool pml, const bool periodic_single_box,
+                const bool distributed_fft,
                 const bool update_with_rho,
                 const bool fft_do_time_averaging,
                 const bool J_linear_in_time,
                 const bool dive_cleaning,
                 const bool divb_cleaning)
 {
+    const amrex::Long bytes_before = WarpXUtilMem::ArenaBytesInUse();
+
     // Initialize all structures using the same distribution mapping dm
+    // (for the distributed FFTs, the spectral space is decomposed in slabs
+    // of the whole domain, with their own distribution mapping)
+    DistributedFFTLayout distributed_layout;
+    if (distributed_fft) {
+        const amrex::Box domain = realspace_ba.minimalBox();
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+            realspace_ba.numPts() == domain.numPts(),
+            "The distributed FFTs require boxes that cover the whole domain, without guard cells");
+        distributed_layout = DistributedFFTLayout(domain);
+    }
+    const amrex::DistributionMapping& spectral_dm =
+        (distributed_fft) ? distributed_layout.spectral_dm : dm;
 
     // - Initialize k space object (Contains info about the size of
     // the spectral space corresponding to each box in `realspace_ba`,
     // as well as the value of the corresponding k coordinates)
-    const SpectralKSpace k_space= SpectralKSpace(realspace_ba, dm, dx);
+    const SpectralKSpace k_space = (distributed_fft) ?
+        SpectralKSpace(distributed_layout, dx) : SpectralKSpace(realspace_ba, dm, dx);
 
     m_spectral_index = SpectralFieldIndex(update_with_rho, fft_do_time_averaging,
                                           J_linear_in_time, dive_cleaning, divb_cleaning, pml);
@@ -49,30 +71,33 @@ SpectralSolver::SpectralSolver(
 
     if (pml) {
         algorithm = std::make_unique<PMLPsatdAlgorithm>(
-            k_space, dm, m_spectral_index, norder_x, norder_y, norder_z, nodal,
+            k_space, spectral_dm, m_spectral_index, norder_x, norder_y, norder_z, nodal,
             fill_guards, dt, dive_cleaning, divb_cleaning);
     }
     else {
         // Comoving PSATD algorithm
         if (v_comoving[0] != 0. || v_comoving[1] != 0. || v_comoving[2] != 0.) {
             algorithm = std::make_unique<ComovingPsatdAlgorithm>(
-                k_space, dm, m_spectral_index, norder_x, norder_y, norder_z, nodal,
+                k_space, spectral_dm, m_spectral_index, norder_x, norder_y, norder_z, nodal,
                 fill_guards, v_comoving, dt, update_with_rho);
         }
         // PSATD algorithms: standard, Galilean, or averaged Galilean
         else {
             algorithm = std::make_unique<PsatdAlgorithm>(
-                k_space, dm, m_spectral_index, norder_x, norder_y, norder_z, nodal, fill_guards,
+                k_space, spectral_dm, m_spectral_index, norder_x, norder_y, norder_z, nodal, fill_guards,
                 v_galilean, dt, update_with_rho, fft_do_time_averaging, J_linear_in_time,
-                dive_cleaning, divb_cleaning);
+                dive_cleaning, divb_cleaning, WarpX::psatd_on_the_fly_coefficients);
         }
     }
 
     // - Initialize arrays for fields in spectral space + FFT plans
-    field_data = SpectralFieldData(lev, realspace_ba, k_space, dm,
-                                   m_spectral_index.n_fields, periodic_single_box);
+    field_data = SpectralFieldData(lev, realspace_ba, k_space, spectral_dm,
+                                   m_spectral_index.n_fields, periodic_single_box,
+                                   distributed_layout);
 
     m_fill_guards = fill_guards;
+
+    m_bytes_allocated = WarpXUtilMem::ArenaBytesInUse() - bytes_before;
 }
 
 void
@@ -95,6 +120,22 @@ SpectralSolver::BackwardTransform( const int lev,
     field_data.BackwardTransform(lev, mf, field_index, i_comp, m_fill_guards);
 }
 
+void
+SpectralSolver::ForwardTransform( const int lev,
+                                  const amrex::Vector<SpectralFieldData::TransformComponent>& components )
+{
+    WARPX_PROFILE("SpectralSolver::ForwardTransform");
+    field_data.ForwardTransform( lev, components );
+}
+
+void
+SpectralSolver::BackwardTransform( const int lev,
+                                   const amrex::Vector<SpectralFieldData::TransformComponent>& components )
+{
+    WARPX_PROFILE("SpectralSolver::BackwardTransform");
+    field_data.BackwardTransform( lev, components, m_fill_guards );
+}
+
 void
 SpectralSolver::pushSpectralFields(){
     WARPX_PROFILE("SpectralSolver::pushSpectralFields");
@@ -9,6 +9,7 @@
 #include "SpectralKSpaceRZ.H"
 #include "SpectralSolverRZ.H"
 #include "Utils/WarpXProfilerWrapper.H"
+#include "Utils/WarpXUtil.H"
 #include "WarpX.H"
 
 /* \brief Initialize the spectral Maxwell solver
@@ -39,6 +40,8 @@ SpectralSolverRZ::SpectralSolverRZ (const int lev,
                                     const bool divb_cleaning)
     : k_space(realspace_ba, dm, dx)
 {
+    const amrex::Long bytes_before = WarpXUtilMem::ArenaBytesInUse();
+
     // Initialize all structures using the same distribution mapping dm
 
     // - The k space object contains info about the size of
@@ -67,6 +70,8 @@ SpectralSolverRZ::SpectralSolverRZ (const int lev,
     field_data = SpectralFieldDataRZ(lev, realspace_ba, k_space, dm,
                                      m_spectral_index.n_fields,
                                      n_rz_azimuthal_modes);
+
+    m_bytes_allocated = WarpXUtilMem::ArenaBytesInUse() - bytes_before;
 }
 
 /* \brief Transform the component `i_comp` of MultiFab `field_mf`
@@ -117,12 +122,12 @@ SpectralSolverRZ::BackwardTransform (const int lev,
 
 /* \brief Update the fields in spectral space, over one timestep */
 void
-SpectralSolverRZ::pushSpectralFields () {
+SpectralSolverRZ::pushSpectralFields (const bool filter_sources) {
     WARPX_PROFILE("SpectralSolverRZ::pushSpectralFields");
     // Virtual function: the actual function used here depends
     // on the sub-class of `SpectralBaseAlgorithm` that was
     // initialized in the constructor of `SpectralSolverRZ`
-    algorithm->pushSpectralFields(field_data);
+    algorithm->pushSpectralFields(field_data, filter_sources);
 }
 
 /**
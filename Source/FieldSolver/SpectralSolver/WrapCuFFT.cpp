@@ -7,27 +7,77 @@
 
 #include "AnyFFT.H"
 
+#include <AMReX.H>
+
 namespace AnyFFT
 {
 
 #ifdef AMREX_USE_FLOAT
     cufftType VendorR2C = CUFFT_R2C;
     cufftType VendorC2R = CUFFT_C2R;
+    cufftType VendorC2C = CUFFT_C2C;
 #else
     cufftType VendorR2C = CUFFT_D2Z;
     cufftType VendorC2R = CUFFT_Z2D;
+    cufftType VendorC2C = CUFFT_Z2Z;
 #endif
 
     std::string cufftErrorToString (const cufftResult& err);
 
+    namespace {
+        /** \brief Plan cache, whose plans are destroyed in amrex::Finalize
+         * (single_precision: cache of the plans created with CreatePlanSingle) */
+        PlanCache& GetPlanCache (const bool single_precision = false)
+        {
+            static PlanCache cache, cache_single;
+            static bool finalize_registered = false;
+            if (!finalize_registered) {
+                amrex::ExecOnFinalize([] () {
+                    cache.Clear([] (VendorFFTPlan& plan) { cufftDestroy(plan); });
+                    cache_single.Clear([] (VendorFFTPlan& plan) { cufftDestroy(plan); });
+                    finalize_registered = false;
+                });
+                finalize_registered = true;
+            }
+            return (single_precision) ? cache_single : cache;
+        }
+    }
+
     FFTplan CreatePlan(const amrex::IntVect& real_size, amrex::Real * const real_array,
-                       Complex * const complex_array, const direction dir, const int dim)
+                       Complex * const complex_array, const direction dir, const int dim,
+                       const int batch)
     {
         FFTplan fft_plan;
 
+        // Store meta-data in fft_plan
+        fft_plan.m_real_array = real_array;
+        fft_plan.m_complex_array = complex_array;
+        fft_plan.m_dir = dir;
+        fft_plan.m_dim = dim;
+        fft_plan.m_batch = batch;
+
+        // cuFFT plans do not depend on the arrays: reuse the plan of this shape, if any
+        fft_plan.m_key = MakePlanKey(real_size, dir, dim, 0, batch);
+        if (GetPlanCache().Find(fft_plan.m_key, fft_plan.m_plan)) {
+            fft_plan.m_cached = true;
+            return fft_plan;
+        }
+
         // Initialize fft_plan.m_plan with the vendor fft plan.
         cufftResult result;
-        if (dir == direction::R2C){
+        if (batch > 1) {
+            // Batched plan, over contiguous arrays
+            // (with null embed arguments, cuFFT uses the sizes of the transform
+            // for the distance between two consecutive arrays)
+            if (dim < 1 || dim > 3) amrex::Abort("only dim=1, dim=2 and dim=3 have been implemented");
+            int n[3];
+            for (int idim = 0; idim < dim; ++idim) {
+                // Swap dimensions: AMReX FAB are Fortran-order but cuFFT is C-order
+                n[idim] = real_size[dim-1-idim];
+            }
+            result = cufftPlanMany(&(fft_plan.m_plan), dim, n, nullptr, 1, 0, nullptr, 1, 0,
+                                   (dir == direction::R2C) ? VendorR2C : VendorC2R, batch);
+        } else if (dir == direction::R2C){
             if (dim == 3) {
                 result = cufftPlan3d(
                     &(fft_plan.m_plan), real_size[2], real_size[1], real_size[0], VendorR2C);
@@ -52,20 +102,100 @@ namespace AnyFFT
         if ( result != CUFFT_SUCCESS ) {
             amrex::Print() << " cufftplan failed! Error: " <<
                 cufftErrorToString(result) << "\n";
+        } else {
+            GetPlanCache().Insert(fft_plan.m_key, fft_plan.m_plan);
+            fft_plan.m_cached = true;
         }
 
+        return fft_plan;
+    }
+
+    FFTplan CreatePlanSingle(const amrex::IntVect& real_size, float * const real_array,
+                             ComplexSingle * const complex_array, const direction dir,
+                             const int dim)
+    {
+        FFTplan fft_plan;
+
         // Store meta-data in fft_plan
-        fft_plan.m_real_array = real_array;
-        fft_plan.m_complex_array = complex_array;
+        fft_plan.m_real_array = nullptr;
+        fft_plan.m_complex_array = nullptr;
+        fft_plan.m_real_array_single = real_array;
+        fft_plan.m_complex_array_single = complex_array;
+        fft_plan.m_single_precision = true;
         fft_plan.m_dir = dir;
         fft_plan.m_dim = dim;
+        fft_plan.m_batch = 1;
+
+        fft_plan.m_key = MakePlanKey(real_size, dir, dim, 0, 1);
+        if (GetPlanCache(true).Find(fft_plan.m_key, fft_plan.m_plan)) {
+            fft_plan.m_cached = true;
+            return fft_plan;
+        }
+
+        const cufftType type = (dir == direction::R2C) ? CUFFT_R2C : CUFFT_C2R;
+        cufftResult result;
+        if (dim == 3) {
+            result = cufftPlan3d(
+                &(fft_plan.m_plan), real_size[2], real_size[1], real_size[0], type);
+        } else if (dim == 2) {
+            result = cufftPlan2d(
+                &(fft_plan.m_plan), real_size[1], real_size[0], type);
+        } else {
+            amrex::Abort("only dim=2 and dim=3 have been implemented");
+        }
+
+        if ( result != CUFFT_SUCCESS ) {
+            amrex::Print() << " cufftplan failed! Error: " <<
+                cufftErrorToString(result) << "\n";
+        } else {
+            GetPlanCache(true).Insert(fft_plan.m_key, fft_plan.m_plan);
+            fft_plan.m_cached = true;
+        }
+
+        return fft_plan;
+    }
+
+    FFTplan CreateStridedPlanC2C(const int n, const int howmany, const int stride,
+                                 Complex * const complex_array, const direction dir)
+    {
+        FFTplan fft_plan;
+
+        // Store meta-data in fft_plan
+        fft_plan.m_real_array = nullptr;
+        fft_plan.m_complex_array = complex_array;
+        fft_plan.m_dir = dir;
+        fft_plan.m_dim = 1;
+        fft_plan.m_batch = howmany;
+
+        fft_plan.m_key = MakePlanKey(amrex::IntVect(AMREX_D_DECL(n, stride, 0)), dir, 1, 0, howmany);
+        if (GetPlanCache().Find(fft_plan.m_key, fft_plan.m_plan)) {
+            fft_plan.m_cached = true;
+            return fft_plan;
+        }
+
+        int n_embed = n;
+        cufftResult result = cufftPlanMany(&(fft_plan.m_plan), 1, &n_embed,
+                                           &n_embed, stride, 1, &n_embed, stride, 1,
+                                           VendorC2C, howmany);
+
+        if ( result != CUFFT_SUCCESS ) {
+            amrex::Print() << " cufftplan failed! Error: " <<
+                cufftErrorToString(result) << "\n";
+        } else {
+            GetPlanCache().Insert(fft_plan.m_key, fft_plan.m_plan);
+            fft_plan.m_cached = true;
+        }
 
         return fft_plan;
     }
 
     void DestroyPlan(FFTplan& fft_plan)
     {
-        cufftDestroy( fft_plan.m_plan );
+        if (fft_plan.m_cached) {
+            GetPlanCache(fft_plan.m_single_precision).Release(fft_plan.m_key);
+        } else {
+            cufftDestroy( fft_plan.m_plan );
+        }
     }
 
     void Execute(FFTplan& fft_plan){
@@ -73,7 +203,15 @@ namespace AnyFFT
         cudaStream_t stream = amrex::Gpu::Device::cudaStream();
         cufftSetStream ( fft_plan.m_plan, stream);
         cufftResult result;
-        if (fft_plan.m_dir == direction::R2C){
+        if (fft_plan.m_single_precision){
+            if (fft_plan.m_dir == direction::R2C){
+                result = cufftExecR2C(fft_plan.m_plan, fft_plan.m_real_array_single,
+                                      fft_plan.m_complex_array_single);
+            } else {
+                result = cufftExecC2R(fft_plan.m_plan, fft_plan.m_complex_array_single,
+                                      fft_plan.m_real_array_single);
+            }
+        } else if (fft_plan.m_dir == direction::R2C){
 #ifdef AMREX_USE_FLOAT
             result = cufftExecR2C(fft_plan.m_plan, fft_plan.m_real_array, fft_plan.m_complex_array);
 #else
@@ -84,9 +222,17 @@ namespace AnyFFT
             result = cufftExecC2R(fft_plan.m_plan, fft_plan.m_complex_array, fft_plan.m_real_array);
 #else
             result = cufftExecZ2D(fft_plan.m_plan, fft_plan.m_complex_array, fft_plan.m_real_array);
+#endif
+        } else if (fft_plan.m_dir == direction::C2C_forward ||
+                   fft_plan.m_dir == direction::C2C_backward){
+            const int sign = (fft_plan.m_dir == direction::C2C_forward) ? CUFFT_FORWARD : CUFFT_INVERSE;
+#ifdef AMREX_USE_FLOAT
+            result = cufftExecC2C(fft_plan.m_plan, fft_plan.m_complex_array, fft_plan.m_complex_array, sign);
+#else
+            result = cufftExecZ2Z(fft_plan.m_plan, fft_plan.m_complex_array, fft_plan.m_complex_array, sign);
 #endif
         } else {
-            amrex::Abort("direction must be AnyFFT::direction::R2C or AnyFFT::direction::C2R");
+            amrex::Abort("direction must be AnyFFT::direction::R2C, C2R, C2C_forward or C2C_backward");
         }
         if ( result != CUFFT_SUCCESS ) {
             amrex::Print() << " forward transform using cufftExec failed ! Error: " <<
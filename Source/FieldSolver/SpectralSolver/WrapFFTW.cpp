@@ -20,18 +20,66 @@ namespace AnyFFT
     const auto VendorCreatePlanC2R3D = fftwf_plan_dft_c2r_3d;
     const auto VendorCreatePlanR2C2D = fftwf_plan_dft_r2c_2d;
     const auto VendorCreatePlanC2R2D = fftwf_plan_dft_c2r_2d;
+    const auto VendorCreatePlanManyR2C = fftwf_plan_many_dft_r2c;
+    const auto VendorCreatePlanManyC2R = fftwf_plan_many_dft_c2r;
+    const auto VendorCreatePlanManyC2C = fftwf_plan_many_dft;
+    const auto VendorAlignmentOfReal = fftwf_alignment_of;
 #else
     const auto VendorCreatePlanR2C3D = fftw_plan_dft_r2c_3d;
     const auto VendorCreatePlanC2R3D = fftw_plan_dft_c2r_3d;
     const auto VendorCreatePlanR2C2D = fftw_plan_dft_r2c_2d;
     const auto VendorCreatePlanC2R2D = fftw_plan_dft_c2r_2d;
+    const auto VendorCreatePlanManyR2C = fftw_plan_many_dft_r2c;
+    const auto VendorCreatePlanManyC2R = fftw_plan_many_dft_c2r;
+    const auto VendorCreatePlanManyC2C = fftw_plan_many_dft;
+    const auto VendorAlignmentOfReal = fftw_alignment_of;
 #endif
 
+    namespace {
+        /** \brief Plan cache, whose plans are destroyed in amrex::Finalize */
+        PlanCache& GetPlanCache ()
+        {
+            static PlanCache cache;
+            static bool finalize_registered = false;
+            if (!finalize_registered) {
+                amrex::ExecOnFinalize([] () {
+#  ifdef AMREX_USE_FLOAT
+                    cache.Clear([] (VendorFFTPlan& plan) { fftwf_destroy_plan(plan); });
+#  else
+                    cache.Clear([] (VendorFFTPlan& plan) { fftw_destroy_plan(plan); });
+#  endif
+                    finalize_registered = false;
+                });
+                finalize_registered = true;
+            }
+            return cache;
+        }
+    }
+
     FFTplan CreatePlan(const amrex::IntVect& real_size, amrex::Real * const real_array,
-                       Complex * const complex_array, const direction dir, const int dim)
+                       Complex * const complex_array, const direction dir, const int dim,
+                       const int batch)
     {
         FFTplan fft_plan;
 
+        // Store meta-data in fft_plan
+        fft_plan.m_real_array = real_array;
+        fft_plan.m_complex_array = complex_array;
+        fft_plan.m_dir = dir;
+        fft_plan.m_dim = dim;
+        fft_plan.m_batch = batch;
+
+        // FFTW plans can be executed on other arrays (see Execute), provided that they have
+        // the same alignment as the arrays used to create the plan: reuse the plan of this
+        // shape and alignment, if any
+        const int alignment = VendorAlignmentOfReal(real_array)
+            + 64 * VendorAlignmentOfReal(reinterpret_cast<amrex::Real*>(complex_array));
+        fft_plan.m_key = MakePlanKey(real_size, dir, dim, alignment, batch);
+        if (GetPlanCache().Find(fft_plan.m_key, fft_plan.m_plan)) {
+            fft_plan.m_cached = true;
+            return fft_plan;
+        }
+
 #if defined(AMREX_USE_OMP) && defined(WarpX_FFTW_OMP)
 #   ifdef AMREX_USE_FLOAT
         fftwf_init_threads();
@@ -44,7 +92,27 @@ namespace AnyFFT
 
         // Initialize fft_plan.m_plan with the vendor fft plan.
         // Swap dimensions: AMReX FAB are Fortran-order but FFTW is C-order
-        if (dir == direction::R2C){
+        if (batch > 1) {
+            // Batched plan, over contiguous arrays
+            if (dim < 1 || dim > 3) amrex::Abort("only dim=1, dim=2 and dim=3 have been implemented");
+            int n[3];
+            int real_dist = 1;
+            for (int idim = 0; idim < dim; ++idim) {
+                n[idim] = real_size[dim-1-idim];
+                real_dist *= real_size[idim];
+            }
+            // The last (C-order) dimension of the complex array is n/2+1
+            const int complex_dist = (real_dist / real_size[0]) * (real_size[0]/2 + 1);
+            if (dir == direction::R2C) {
+                fft_plan.m_plan = VendorCreatePlanManyR2C(
+                    dim, n, batch, real_array, nullptr, 1, real_dist,
+                    complex_array, nullptr, 1, complex_dist, FFTW_ESTIMATE);
+            } else {
+                fft_plan.m_plan = VendorCreatePlanManyC2R(
+                    dim, n, batch, complex_array, nullptr, 1, complex_dist,
+                    real_array, nullptr, 1, real_dist, FFTW_ESTIMATE);
+            }
+        } else if (dir == direction::R2C){
             if (dim == 3) {
                 fft_plan.m_plan = VendorCreatePlanR2C3D(
                     real_size[2], real_size[1], real_size[0], real_array, complex_array, FFTW_ESTIMATE);
@@ -66,17 +134,72 @@ namespace AnyFFT
             }
         }
 
+        GetPlanCache().Insert(fft_plan.m_key, fft_plan.m_plan);
+        fft_plan.m_cached = true;
+
+        return fft_plan;
+    }
+
+    FFTplan CreatePlanSingle(const amrex::IntVect& /*real_size*/, float * const /*real_array*/,
+                             ComplexSingle * const /*complex_array*/, const direction /*dir*/,
+                             const int /*dim*/)
+    {
+        // This would require linking WarpX with the single-precision FFTW library
+        // in addition to the double-precision one
+        amrex::Abort("Single-precision FFTs are only implemented with cuFFT and rocFFT");
+        return FFTplan{};
+    }
+
+    FFTplan CreateStridedPlanC2C(const int n, const int howmany, const int stride,
+                                 Complex * const complex_array, const direction dir)
+    {
+        FFTplan fft_plan;
+
         // Store meta-data in fft_plan
-        fft_plan.m_real_array = real_array;
+        fft_plan.m_real_array = nullptr;
         fft_plan.m_complex_array = complex_array;
         fft_plan.m_dir = dir;
-        fft_plan.m_dim = dim;
+        fft_plan.m_dim = 1;
+        fft_plan.m_batch = howmany;
+
+        const int alignment = VendorAlignmentOfReal(reinterpret_cast<amrex::Real*>(complex_array));
+        fft_plan.m_key = MakePlanKey(amrex::IntVect(AMREX_D_DECL(n, stride, 0)), dir, 1,
+                                     alignment, howmany);
+        if (GetPlanCache().Find(fft_plan.m_key, fft_plan.m_plan)) {
+            fft_plan.m_cached = true;
+            return fft_plan;
+        }
+
+#if defined(AMREX_USE_OMP) && defined(WarpX_FFTW_OMP)
+#   ifdef AMREX_USE_FLOAT
+        fftwf_init_threads();
+        fftwf_plan_with_nthreads(omp_get_max_threads());
+#   else
+        fftw_init_threads();
+        fftw_plan_with_nthreads(omp_get_max_threads());
+#   endif
+#endif
+
+        // Interleaved transforms: stride between the elements of one transform,
+        // and distance 1 between two transforms
+        int n_transform = n;
+        fft_plan.m_plan = VendorCreatePlanManyC2C(
+            1, &n_transform, howmany, complex_array, nullptr, stride, 1,
+            complex_array, nullptr, stride, 1,
+            (dir == direction::C2C_forward) ? FFTW_FORWARD : FFTW_BACKWARD, FFTW_ESTIMATE);
+
+        GetPlanCache().Insert(fft_plan.m_key, fft_plan.m_plan);
+        fft_plan.m_cached = true;
 
         return fft_plan;
     }
 
     void DestroyPlan(FFTplan& fft_plan)
     {
+        if (fft_plan.m_cached) {
+            GetPlanCache().Release(fft_plan.m_key);
+            return;
+        }
 #  ifdef AMREX_USE_FLOAT
         fftwf_destroy_plan( fft_plan.m_plan );
 #  else
@@ -85,10 +208,25 @@ namespace AnyFFT
     }
 
     void Execute(FFTplan& fft_plan){
+        // The plan can be shared with other boxes: execute it on the arrays of this box
+        if (fft_plan.m_dir == direction::R2C) {
 #  ifdef AMREX_USE_FLOAT
-        fftwf_execute( fft_plan.m_plan );
+            fftwf_execute_dft_r2c( fft_plan.m_plan, fft_plan.m_real_array, fft_plan.m_complex_array );
 #  else
-        fftw_execute( fft_plan.m_plan );
+            fftw_execute_dft_r2c( fft_plan.m_plan, fft_plan.m_real_array, fft_plan.m_complex_array );
 #  endif
+        } else if (fft_plan.m_dir == direction::C2R) {
+#  ifdef AMREX_USE_FLOAT
+            fftwf_execute_dft_c2r( fft_plan.m_plan, fft_plan.m_complex_array, fft_plan.m_real_array );
+#  else
+            fftw_execute_dft_c2r( fft_plan.m_plan, fft_plan.m_complex_array, fft_plan.m_real_array );
+#  endif
+        } else {
+#  ifdef AMREX_USE_FLOAT
+            fftwf_execute_dft( fft_plan.m_plan, fft_plan.m_complex_array, fft_plan.m_complex_array );
+#  else
+            fftw_execute_dft( fft_plan.m_plan, fft_plan.m_complex_array, fft_plan.m_complex_array );
+#  endif
+        }
     }
 }
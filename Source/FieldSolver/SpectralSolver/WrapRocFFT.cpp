@@ -7,6 +7,8 @@
 
 #include "AnyFFT.H"
 
+#include <AMReX.H>
+
 namespace AnyFFT
 {
 
@@ -19,18 +21,51 @@ namespace AnyFFT
                 amrex::Abort(name + " failed! Error: " + rocfftErrorToString(status));
             }
         }
+
+        /** \brief Plan cache, whose plans are destroyed in amrex::Finalize
+         * (single_precision: cache of the plans created with CreatePlanSingle) */
+        PlanCache& GetPlanCache (const bool single_precision = false)
+        {
+            static PlanCache cache, cache_single;
+            static bool finalize_registered = false;
+            if (!finalize_registered) {
+                amrex::ExecOnFinalize([] () {
+                    cache.Clear([] (VendorFFTPlan& plan) { rocfft_plan_destroy(plan); });
+                    cache_single.Clear([] (VendorFFTPlan& plan) { rocfft_plan_destroy(plan); });
+                    finalize_registered = false;
+                });
+                finalize_registered = true;
+            }
+            return (single_precision) ? cache_single : cache;
+        }
     }
 
     FFTplan CreatePlan (const amrex::IntVect& real_size, amrex::Real * const real_array,
-                        Complex * const complex_array, const direction dir, const int dim)
+                        Complex * const complex_array, const direction dir, const int dim,
+                        const int batch)
     {
         FFTplan fft_plan;
 
+        // Store meta-data in fft_plan
+        fft_plan.m_real_array = real_array;
+        fft_plan.m_complex_array = complex_array;
+        fft_plan.m_dir = dir;
+        fft_plan.m_dim = dim;
+        fft_plan.m_batch = batch;
+
+        // rocFFT plans do not depend on the arrays: reuse the plan of this shape, if any
+        fft_plan.m_key = MakePlanKey(real_size, dir, dim, 0, batch);
+        if (GetPlanCache().Find(fft_plan.m_key, fft_plan.m_plan)) {
+            fft_plan.m_cached = true;
+            return fft_plan;
+        }
+
         const std::size_t lengths[] = {AMREX_D_DECL(std::size_t(real_size[0]),
                                                     std::size_t(real_size[1]),
                                                     std::size_t(real_size[2]))};
 
         // Initialize fft_plan.m_plan with the vendor fft plan.
+        // (without plan description, the batched arrays are contiguous)
         rocfft_status result = rocfft_plan_create(&(fft_plan.m_plan),
                                                   rocfft_placement_notinplace,
                                                   (dir == direction::R2C)
@@ -42,22 +77,123 @@ namespace AnyFFT
                                                   rocfft_precision_double,
 #endif
                                                   dim, lengths,
-                                                  1, // number of transforms,
+                                                  std::size_t(batch), // number of transforms
                                                   nullptr);
         assert_rocfft_status("rocfft_plan_create", result);
 
+        GetPlanCache().Insert(fft_plan.m_key, fft_plan.m_plan);
+        fft_plan.m_cached = true;
+
+        return fft_plan;
+    }
+
+    FFTplan CreatePlanSingle (const amrex::IntVect& real_size, float * const real_array,
+                              ComplexSingle * const complex_array, const direction dir,
+                              const int dim)
+    {
+        FFTplan fft_plan;
+
         // Store meta-data in fft_plan
-        fft_plan.m_real_array = real_array;
-        fft_plan.m_complex_array = complex_array;
+        fft_plan.m_real_array = nullptr;
+        fft_plan.m_complex_array = nullptr;
+        fft_plan.m_real_array_single = real_array;
+        fft_plan.m_complex_array_single = complex_array;
+        fft_plan.m_single_precision = true;
         fft_plan.m_dir = dir;
         fft_plan.m_dim = dim;
+        fft_plan.m_batch = 1;
+
+        fft_plan.m_key = MakePlanKey(real_size, dir, dim, 0, 1);
+        if (GetPlanCache(true).Find(fft_plan.m_key, fft_plan.m_plan)) {
+            fft_plan.m_cached = true;
+            return fft_plan;
+        }
+
+        const std::size_t lengths[] = {AMREX_D_DECL(std::size_t(real_size[0]),
+                                                    std::size_t(real_size[1]),
+                                                    std::size_t(real_size[2]))};
+
+        rocfft_status result = rocfft_plan_create(&(fft_plan.m_plan),
+                                                  rocfft_placement_notinplace,
+                                                  (dir == direction::R2C)
+                                                      ? rocfft_transform_type_real_forward
+                                                      : rocfft_transform_type_real_inverse,
+                                                  rocfft_precision_single,
+                                                  dim, lengths,
+                                                  1, // number of transforms
+                                                  nullptr);
+        assert_rocfft_status("rocfft_plan_create", result);
+
+        GetPlanCache(true).Insert(fft_plan.m_key, fft_plan.m_plan);
+        fft_plan.m_cached = true;
+
+        return fft_plan;
+    }
+
+    FFTplan CreateStridedPlanC2C (const int n, const int howmany, const int stride,
+                                  Complex * const complex_array, const direction dir)
+    {
+        FFTplan fft_plan;
+
+        // Store meta-data in fft_plan
+        fft_plan.m_real_array = nullptr;
+        fft_plan.m_complex_array = complex_array;
+        fft_plan.m_dir = dir;
+        fft_plan.m_dim = 1;
+        fft_plan.m_batch = howmany;
+
+        fft_plan.m_key = MakePlanKey(amrex::IntVect(AMREX_D_DECL(n, stride, 0)), dir, 1, 0, howmany);
+        if (GetPlanCache().Find(fft_plan.m_key, fft_plan.m_plan)) {
+            fft_plan.m_cached = true;
+            return fft_plan;
+        }
+
+        // Interleaved transforms: stride between the elements of one transform,
+        // and distance 1 between two transforms
+        rocfft_plan_description description = nullptr;
+        rocfft_status result = rocfft_plan_description_create(&description);
+        assert_rocfft_status("rocfft_plan_description_create", result);
+        const std::size_t strides[] = {std::size_t(stride)};
+        result = rocfft_plan_description_set_data_layout(description,
+                                                         rocfft_array_type_complex_interleaved,
+                                                         rocfft_array_type_complex_interleaved,
+                                                         nullptr, nullptr,
+                                                         1, strides, 1,
+                                                         1, strides, 1);
+        assert_rocfft_status("rocfft_plan_description_set_data_layout", result);
+
+        const std::size_t lengths[] = {std::size_t(n)};
+        result = rocfft_plan_create(&(fft_plan.m_plan),
+                                    rocfft_placement_inplace,
+                                    (dir == direction::C2C_forward)
+                                        ? rocfft_transform_type_complex_forward
+                                        : rocfft_transform_type_complex_inverse,
+#ifdef AMREX_USE_FLOAT
+                                    rocfft_precision_single,
+#else
+                                    rocfft_precision_double,
+#endif
+                                    1, lengths,
+                                    std::size_t(howmany), // number of transforms
+                                    description);
+        assert_rocfft_status("rocfft_plan_create", result);
+
+        result = rocfft_plan_description_destroy(description);
+        assert_rocfft_status("rocfft_plan_description_destroy", result);
+
+        GetPlanCache().Insert(fft_plan.m_key, fft_plan.m_plan);
+        fft_plan.m_cached = true;
 
         return fft_plan;
     }
 
     void DestroyPlan (FFTplan& fft_plan)
     {
-        rocfft_plan_destroy( fft_plan.m_plan );
+        if (fft_plan.m_cached) {
+            GetPlanCache(fft_plan.m_single_precision).Release(fft_plan.m_key);
+        } else {
+            rocfft_plan_destroy( fft_plan.m_plan );
+        }
     }
 
     void Execute (FFTplan& fft_plan)
@@ -77,7 +213,19 @@ namespace AnyFFT
         result = rocfft_execution_info_set_stream(execinfo, amrex::Gpu::gpuStream());
         assert_rocfft_status("rocfft_execution_info_set_stream", result);
 
-        if (fft_plan.m_dir == direction::R2C) {
+        if (fft_plan.m_single_precision) {
+            if (fft_plan.m_dir == direction::R2C) {
+                result = rocfft_execute(fft_plan.m_plan,
+                                        (void**)&(fft_plan.m_real_array_single), // in
+                                        (void**)&(fft_plan.m_complex_array_single), // out
+                                        execinfo);
+            } else {
+                result = rocfft_execute(fft_plan.m_plan,
+                                        (void**)&(fft_plan.m_complex_array_single), // in
+                                        (void**)&(fft_plan.m_real_array_single), // out
+                                        execinfo);
+            }
+        } else if (fft_plan.m_dir == direction::R2C) {
             result = rocfft_execute(fft_plan.m_plan,
                                     (void**)&(fft_plan.m_real_array), // in
                                     (void**)&(fft_plan.m_complex_array), // out
@@ -87,8 +235,14 @@ namespace AnyFFT
                                     (void**)&(fft_plan.m_complex_array), // in
                                     (void**)&(fft_plan.m_real_array), // out
                                     execinfo);
+        } else if (fft_plan.m_dir == direction::C2C_forward ||
+                   fft_plan.m_dir == direction::C2C_backward) {
+            result = rocfft_execute(fft_plan.m_plan,
+                                    (void**)&(fft_plan.m_complex_array), // in and out
+                                    nullptr,
+                                    execinfo);
         } else {
-            amrex::Abort("direction must be AnyFFT::direction::R2C or AnyFFT::direction::C2R");
+            amrex::Abort("direction must be AnyFFT::direction::R2C, C2R, C2C_forward or C2C_backward");
         }
 
         assert_rocfft_status("rocfft_execute", result);
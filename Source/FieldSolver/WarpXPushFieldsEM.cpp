@@ -11,6 +11,7 @@
 #include "BoundaryConditions/PML.H"
 #include "Evolve/WarpXDtType.H"
 #include "FieldSolver/FiniteDifferenceSolver/FiniteDifferenceSolver.H"
+#include "Parallelization/WarpXCommUtil.H"
 #if defined(WARPX_USE_PSATD)
 #   include "FieldSolver/SpectralSolver/SpectralFieldData.H"
 #   ifdef WARPX_DIM_RZ
@@ -21,6 +22,7 @@
 #endif
 #include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXConst.H"
+#include "Utils/WarpXPhaseTimers.H"
 #include "Utils/WarpXProfilerWrapper.H"
 #include "WarpXPushFieldsEM_K.H"
 #include "WarpX_FDTD.H"
@@ -42,12 +44,14 @@
 #include <AMReX_MFIter.H>
 #include <AMReX_Math.H>
 #include <AMReX_MultiFab.H>
+#include <AMReX_Periodicity.H>
 #include <AMReX_REAL.H>
 #include <AMReX_Vector.H>
 
 #include <array>
 #include <cmath>
 #include <memory>
+#include <string>
 
 using namespace amrex;
 
@@ -67,11 +71,12 @@ namespace {
     {
 #ifdef WARPX_DIM_RZ
         solver.ForwardTransform(lev, *vector_field[0], compx, *vector_field[1], compy);
+        solver.ForwardTransform(lev, *vector_field[2], compz);
 #else
-        solver.ForwardTransform(lev, *vector_field[0], compx);
-        solver.ForwardTransform(lev, *vector_field[1], compy);
+        solver.ForwardTransform(lev, {{vector_field[0].get(), compx, 0},
+                                      {vector_field[1].get(), compy, 0},
+                                      {vector_field[2].get(), compz, 0}});
 #endif
-        solver.ForwardTransform(lev, *vector_field[2], compz);
     }
 
     void
@@ -87,11 +92,12 @@ namespace {
     {
 #ifdef WARPX_DIM_RZ
         solver.BackwardTransform(lev, *vector_field[0], compx, *vector_field[1], compy);
+        solver.BackwardTransform(lev, *vector_field[2], compz);
 #else
-        solver.BackwardTransform(lev, *vector_field[0], compx);
-        solver.BackwardTransform(lev, *vector_field[1], compy);
+        solver.BackwardTransform(lev, {{vector_field[0].get(), compx, 0},
+                                       {vector_field[1].get(), compy, 0},
+                                       {vector_field[2].get(), compz, 0}});
 #endif
-        solver.BackwardTransform(lev, *vector_field[2], compz);
     }
 }
 
@@ -137,6 +143,83 @@ WarpX::PSATDBackwardTransformEB ()
     }
 }
 
+void
+WarpX::PSATDBackwardTransformEBOverlapComms (const amrex::IntVect& ng)
+{
+    const SpectralFieldIndex& Idx = spectral_solver_fp[0]->m_spectral_index;
+
+    // Start the exchange of the guard cells of the three components of a field
+    const auto fill_boundary_nowait = [ng] (std::array<std::unique_ptr<amrex::MultiFab>,3>& field,
+                                            const amrex::Periodicity& period)
+    {
+        for (auto& f : field) {
+            const amrex::IntVect nghost = (safe_guard_cells) ? f->nGrowVect() : ng;
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(nghost <= f->nGrowVect(),
+                "Error: in PSATDBackwardTransformEBOverlapComms, requested more guard cells than allocated");
+            WarpXCommUtil::FillBoundary_nowait(*f, nghost, period);
+        }
+    };
+    const auto fill_boundary_finish = [] (std::array<std::unique_ptr<amrex::MultiFab>,3>& field)
+    {
+        for (auto& f : field) WarpXCommUtil::FillBoundary_finish(*f);
+    };
+
+    // E: backward FFT and boundary conditions, then start the exchange of the guard cells
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        BackwardTransformVect(lev, *spectral_solver_fp[lev], Efield_fp[lev], Idx.Ex, Idx.Ey, Idx.Ez);
+        if (spectral_solver_cp[lev])
+        {
+            BackwardTransformVect(lev, *spectral_solver_cp[lev], Efield_cp[lev], Idx.Ex, Idx.Ey, Idx.Ez);
+        }
+        ApplyEfieldBoundary(lev, PatchType::fine);
+        fill_boundary_nowait(Efield_fp[lev], Geom(lev).periodicity());
+        if (lev > 0)
+        {
+            ApplyEfieldBoundary(lev, PatchType::coarse);
+            fill_boundary_nowait(Efield_cp[lev], Geom(lev-1).periodicity());
+        }
+    }
+
+    // B: same, while the guard cells of E are exchanged
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        BackwardTransformVect(lev, *spectral_solver_fp[lev], Bfield_fp[lev], Idx.Bx, Idx.By, Idx.Bz);
+        if (spectral_solver_cp[lev])
+        {
+            BackwardTransformVect(lev, *spectral_solver_cp[lev], Bfield_cp[lev], Idx.Bx, Idx.By, Idx.Bz);
+        }
+        ApplyBfieldBoundary(lev, PatchType::fine, DtType::FirstHalf);
+        fill_boundary_nowait(Bfield_fp[lev], Geom(lev).periodicity());
+        if (lev > 0)
+        {
+            ApplyBfieldBoundary(lev, PatchType::coarse, DtType::FirstHalf);
+            fill_boundary_nowait(Bfield_cp[lev], Geom(lev-1).periodicity());
+        }
+    }
+
+    // The averaged fields do not depend on the guard cells of E and B
+    if (WarpX::fft_do_time_averaging) PSATDBackwardTransformEBavg();
+
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        fill_boundary_finish(Efield_fp[lev]);
+        fill_boundary_finish(Bfield_fp[lev]);
+        if (lev > 0)
+        {
+            fill_boundary_finish(Efield_cp[lev]);
+            fill_boundary_finish(Bfield_cp[lev]);
+        }
+    }
+
+    // Damp the fields in the guard cells (only the guard cells outside of the domain,
+    // which are not filled by the exchange of guard cells, are damped)
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        DampFieldsInGuards(Efield_fp[lev], Bfield_fp[lev]);
+    }
+}
+
 void
 WarpX::PSATDBackwardTransformEBavg ()
 {
@@ -220,7 +303,7 @@ WarpX::PSATDBackwardTransformG ()
 }
 
 void
-WarpX::PSATDForwardTransformJ ()
+WarpX::PSATDForwardTransformJ (const bool apply_kspace_filter)
 {
     const SpectralFieldIndex& Idx = spectral_solver_fp[0]->m_spectral_index;
 
@@ -243,7 +326,7 @@ WarpX::PSATDForwardTransformJ ()
 
 #ifdef WARPX_DIM_RZ
     // Apply filter in k space if needed
-    if (WarpX::use_kspace_filter)
+    if (WarpX::use_kspace_filter && apply_kspace_filter)
     {
         for (int lev = 0; lev <= finest_level; ++lev)
         {
@@ -255,11 +338,29 @@ WarpX::PSATDForwardTransformJ ()
             }
         }
     }
+#else
+    amrex::ignore_unused(apply_kspace_filter);
 #endif
 }
 
 void
-WarpX::PSATDForwardTransformRho (const int icomp, const int dcomp)
+WarpX::PSATDBackwardTransformJ ()
+{
+    const SpectralFieldIndex& Idx = spectral_solver_fp[0]->m_spectral_index;
+
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        BackwardTransformVect(lev, *spectral_solver_fp[lev], current_fp[lev], Idx.Jx, Idx.Jy, Idx.Jz);
+
+        if (spectral_solver_cp[lev])
+        {
+            BackwardTransformVect(lev, *spectral_solver_cp[lev], current_cp[lev], Idx.Jx, Idx.Jy, Idx.Jz);
+        }
+    }
+}
+
+void
+WarpX::PSATDForwardTransformRho (const int icomp, const int dcomp, const bool apply_kspace_filter)
 {
     const SpectralFieldIndex& Idx = spectral_solver_fp[0]->m_spectral_index;
 
@@ -278,7 +379,7 @@ WarpX::PSATDForwardTransformRho (const int icomp, const int dcomp)
 
 #ifdef WARPX_DIM_RZ
     // Apply filter in k space if needed
-    if (WarpX::use_kspace_filter)
+    if (WarpX::use_kspace_filter && apply_kspace_filter)
     {
         for (int lev = 0; lev <= finest_level; ++lev)
         {
@@ -290,20 +391,32 @@ WarpX::PSATDForwardTransformRho (const int icomp, const int dcomp)
             }
         }
     }
+#else
+    amrex::ignore_unused(apply_kspace_filter);
 #endif
 }
 
 void
-WarpX::PSATDPushSpectralFields ()
+WarpX::PSATDPushSpectralFields (const bool filter_sources)
 {
     for (int lev = 0; lev <= finest_level; ++lev)
     {
+#ifdef WARPX_DIM_RZ
+        spectral_solver_fp[lev]->pushSpectralFields(filter_sources);
+
+        if (spectral_solver_cp[lev])
+        {
+            spectral_solver_cp[lev]->pushSpectralFields(filter_sources);
+        }
+#else
+        amrex::ignore_unused(filter_sources);
         spectral_solver_fp[lev]->pushSpectralFields();
 
         if (spectral_solver_cp[lev])
         {
             spectral_solver_cp[lev]->pushSpectralFields();
         }
+#endif
     }
 }
 
@@ -399,19 +512,38 @@ WarpX::PSATDScaleAverageFields (const amrex::Real scale_factor)
 void
 WarpX::PushPSATD ()
 {
+    WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::FieldSolve);
 #ifndef WARPX_USE_PSATD
     amrex::Abort("PushFieldsEM: PSATD solver selected but not built");
 #else
 
+#ifdef WARPX_DIM_RZ
+    // The k-space filter of J and rho is applied in the kernel of the spectral push,
+    // instead of in separate passes over the spectral data after their forward FFTs
+    const bool fuse_kspace_filter = WarpX::use_kspace_filter;
+#else
+    const bool fuse_kspace_filter = false;
+#endif
+
     PSATDForwardTransformEB();
-    PSATDForwardTransformJ();
+    // After the Vay deposition, J may already be in spectral space
+    if (!m_current_fp_in_spectral_space) PSATDForwardTransformJ(!fuse_kspace_filter);
     // Do rho FFTs only if needed
     if (WarpX::update_with_rho || WarpX::current_correction || WarpX::do_dive_cleaning)
     {
-        PSATDForwardTransformRho(0,0); // rho old
-        PSATDForwardTransformRho(1,1); // rho new
+        PSATDForwardTransformRho(0,0,!fuse_kspace_filter); // rho old
+        PSATDForwardTransformRho(1,1,!fuse_kspace_filter); // rho new
+    }
+    PSATDPushSpectralFields(fuse_kspace_filter);
+
+    // Without PML, the exchange of the guard cells of E,B can be overlapped with
+    // the backward FFTs (in this case, it is not done again in OneStep_nosub)
+    if (PSATDOverlapComms())
+    {
+        PSATDBackwardTransformEBOverlapComms(guard_cells.ng_afterPushPSATD);
+        return;
     }
-    PSATDPushSpectralFields();
+
     PSATDBackwardTransformEB();
     if (WarpX::fft_do_time_averaging) PSATDBackwardTransformEBavg();
 
@@ -430,6 +562,20 @@ WarpX::PushPSATD ()
 #endif
 }
 
+bool
+WarpX::UseGpuGraphs (int lev) const
+{
+    // The per-box timers of the load balance synchronize the device in the MFIter loop;
+    // the ECT and RZ solvers are not captured
+#ifdef WARPX_DIM_RZ
+    amrex::ignore_unused(lev);
+    return false;
+#else
+    return use_gpu_graphs && maxwell_solver_id != MaxwellSolverAlgo::ECT &&
+        !(costs[lev] && load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers);
+#endif
+}
+
 void
 WarpX::EvolveB (amrex::Real a_dt, DtType a_dt_type)
 {
@@ -452,26 +598,53 @@ WarpX::EvolveB (int lev, amrex::Real a_dt, DtType a_dt_type)
 void
 WarpX::EvolveB (int lev, PatchType patch_type, amrex::Real a_dt, DtType a_dt_type)
 {
+    WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::FieldSolve);
 
     // Evolve B field in regular cells
     if (patch_type == PatchType::fine) {
-        m_fdtd_solver_fp[lev]->EvolveB(Bfield_fp[lev], Efield_fp[lev], G_fp[lev],
-                                       m_face_areas[lev], m_area_mod[lev], ECTRhofield[lev], Venl[lev],
-                                       m_flag_info_face[lev], m_borrowing[lev], lev, a_dt);
+        auto push = [&] () {
+            m_fdtd_solver_fp[lev]->EvolveB(Bfield_fp[lev], Efield_fp[lev], G_fp[lev],
+                                           m_face_areas[lev], m_area_mod[lev], ECTRhofield[lev], Venl[lev],
+                                           m_flag_info_face[lev], m_borrowing[lev],
+                                           m_face_tile_classes[lev], lev, a_dt);
+        };
+        if (UseGpuGraphs(lev)) {
+            m_gpu_graphs.Run("EvolveB_fp_" + std::to_string(lev),
+                             {Bfield_fp[lev][0].get(), Bfield_fp[lev][1].get(), Bfield_fp[lev][2].get(),
+                              Efield_fp[lev][0].get(), Efield_fp[lev][1].get(), Efield_fp[lev][2].get(),
+                              G_fp[lev].get()}, a_dt, push);
+        } else {
+            push();
+        }
     } else {
-        m_fdtd_solver_cp[lev]->EvolveB(Bfield_cp[lev], Efield_cp[lev], G_cp[lev],
-                                       m_face_areas[lev], m_area_mod[lev], ECTRhofield[lev], Venl[lev],
-                                       m_flag_info_face[lev], m_borrowing[lev], lev, a_dt);
+        auto push = [&] () {
+            m_fdtd_solver_cp[lev]->EvolveB(Bfield_cp[lev], Efield_cp[lev], G_cp[lev],
+                                           m_face_areas[lev], m_area_mod[lev], ECTRhofield[lev], Venl[lev],
+                                           m_flag_info_face[lev], m_borrowing[lev],
+                                           m_face_tile_classes[lev], lev, a_dt);
+        };
+        if (UseGpuGraphs(lev)) {
+            m_gpu_graphs.Run("EvolveB_cp_" + std::to_string(lev),
+                             {Bfield_cp[lev][0].get(), Bfield_cp[lev][1].get(), Bfield_cp[lev][2].get(),
+                              Efield_cp[lev][0].get(), Efield_cp[lev][1].get(), Efield_cp[lev][2].get(),
+                              G_cp[lev].get()}, a_dt, push);
+        } else {
+            push();
+        }
     }
 
     // Evolve B field in PML cells
     if (do_pml && pml[lev]->ok()) {
+        // With do_pml_fused_damping, B is damped (once per step) with its second half push
+        const bool damp = do_pml_fused_damping && (a_dt_type == DtType::SecondHalf);
         if (patch_type == PatchType::fine) {
             m_fdtd_solver_fp[lev]->EvolveBPML(
-                pml[lev]->GetB_fp(), pml[lev]->GetE_fp(), a_dt, WarpX::do_dive_cleaning);
+                pml[lev]->GetB_fp(), pml[lev]->GetE_fp(), a_dt, WarpX::do_dive_cleaning,
+                damp ? &pml[lev]->GetMultiSigmaBox_fp() : nullptr, do_pml_divb_cleaning);
         } else {
             m_fdtd_solver_cp[lev]->EvolveBPML(
-                pml[lev]->GetB_cp(), pml[lev]->GetE_cp(), a_dt, WarpX::do_dive_cleaning);
+                pml[lev]->GetB_cp(), pml[lev]->GetE_cp(), a_dt, WarpX::do_dive_cleaning,
+                damp ? &pml[lev]->GetMultiSigmaBox_cp() : nullptr, do_pml_divb_cleaning);
         }
     }
 
@@ -502,17 +675,40 @@ WarpX::EvolveE (int lev, amrex::Real a_dt)
 void
 WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real a_dt)
 {
+    WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::FieldSolve);
     // Evolve E field in regular cells
     if (patch_type == PatchType::fine) {
-        m_fdtd_solver_fp[lev]->EvolveE(Efield_fp[lev], Bfield_fp[lev],
-                                       current_fp[lev], m_edge_lengths[lev],
-                                       m_face_areas[lev], ECTRhofield[lev],
-                                       F_fp[lev], lev, a_dt );
+        auto push = [&] () {
+            m_fdtd_solver_fp[lev]->EvolveE(Efield_fp[lev], Bfield_fp[lev],
+                                           current_fp[lev], m_edge_lengths[lev],
+                                           m_face_areas[lev], ECTRhofield[lev],
+                                           F_fp[lev], m_edge_tile_classes[lev], lev, a_dt );
+        };
+        if (UseGpuGraphs(lev)) {
+            m_gpu_graphs.Run("EvolveE_fp_" + std::to_string(lev),
+                             {Efield_fp[lev][0].get(), Efield_fp[lev][1].get(), Efield_fp[lev][2].get(),
+                              Bfield_fp[lev][0].get(), Bfield_fp[lev][1].get(), Bfield_fp[lev][2].get(),
+                              current_fp[lev][0].get(), current_fp[lev][1].get(), current_fp[lev][2].get(),
+                              F_fp[lev].get()}, a_dt, push);
+        } else {
+            push();
+        }
     } else {
-        m_fdtd_solver_cp[lev]->EvolveE(Efield_cp[lev], Bfield_cp[lev],
-                                       current_cp[lev], m_edge_lengths[lev],
-                                       m_face_areas[lev], ECTRhofield[lev],
-                                       F_cp[lev], lev, a_dt );
+        auto push = [&] () {
+            m_fdtd_solver_cp[lev]->EvolveE(Efield_cp[lev], Bfield_cp[lev],
+                                           current_cp[lev], m_edge_lengths[lev],
+                                           m_face_areas[lev], ECTRhofield[lev],
+                                           F_cp[lev], m_edge_tile_classes[lev], lev, a_dt );
+        };
+        if (UseGpuGraphs(lev)) {
+            m_gpu_graphs.Run("EvolveE_cp_" + std::to_string(lev),
+                             {Efield_cp[lev][0].get(), Efield_cp[lev][1].get(), Efield_cp[lev][2].get(),
+                              Bfield_cp[lev][0].get(), Bfield_cp[lev][1].get(), Bfield_cp[lev][2].get(),
+                              current_cp[lev][0].get(), current_cp[lev][1].get(), current_cp[lev][2].get(),
+                              F_cp[lev].get()}, a_dt, push);
+        } else {
+            push();
+        }
     }
 
     // Evolve E field in PML cells
@@ -522,13 +718,13 @@ WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real a_dt)
                 pml[lev]->GetE_fp(), pml[lev]->GetB_fp(),
                 pml[lev]->Getj_fp(), pml[lev]->GetF_fp(),
                 pml[lev]->GetMultiSigmaBox_fp(),
-                a_dt, pml_has_particles );
+                a_dt, pml_has_particles, do_pml_fused_damping, do_pml_dive_cleaning );
         } else {
             m_fdtd_solver_cp[lev]->EvolveEPML(
                 pml[lev]->GetE_cp(), pml[lev]->GetB_cp(),
                 pml[lev]->Getj_cp(), pml[lev]->GetF_cp(),
                 pml[lev]->GetMultiSigmaBox_cp(),
-                a_dt, pml_has_particles );
+                a_dt, pml_has_particles, do_pml_fused_damping, do_pml_dive_cleaning );
         }
     }
 
@@ -537,6 +733,28 @@ WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real a_dt)
 }
 
 
+void
+WarpX::EvolveEBFused (amrex::Real a_dt)
+{
+    WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::FieldSolve);
+    WARPX_PROFILE("WarpX::EvolveEBFused()");
+
+    // Temporal blocking is only available without mesh refinement, with periodic
+    // boundaries (see WarpX::ReadParameters), so that no boundary condition is applied
+    const int lev = 0;
+
+    // J is up-to-date in the valid cells only, while E is updated over one guard cell.
+    // The guard cells of E were filled (over ng_FieldGather >= 3 cells) at the
+    // beginning of the step and have not changed since.
+    const auto& period = Geom(lev).periodicity();
+    for (int i = 0; i < 3; ++i) {
+        WarpXCommUtil::FillBoundary(*current_fp[lev][i], IntVect(1), period);
+    }
+
+    m_fdtd_solver_fp[lev]->EvolveEBFused(Bfield_fp[lev], Efield_fp[lev], current_fp[lev],
+                                         lev, a_dt);
+}
+
 void
 WarpX::EvolveF (amrex::Real a_dt, DtType a_dt_type)
 {
@@ -560,6 +778,7 @@ WarpX::EvolveF (int lev, amrex::Real a_dt, DtType a_dt_type)
 void
 WarpX::EvolveF (int lev, PatchType patch_type, amrex::Real a_dt, DtType a_dt_type)
 {
+    WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::FieldSolve);
     if (!do_dive_cleaning) return;
 
     WARPX_PROFILE("WarpX::EvolveF()");
@@ -614,6 +833,7 @@ WarpX::EvolveG (int lev, amrex::Real a_dt, DtType a_dt_type)
 void
 WarpX::EvolveG (int lev, PatchType patch_type, amrex::Real a_dt, DtType /*a_dt_type*/)
 {
+    WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::FieldSolve);
     if (!do_divb_cleaning) return;
 
     WARPX_PROFILE("WarpX::EvolveG()");
@@ -665,13 +885,13 @@ WarpX::MacroscopicEvolveE (int lev, PatchType patch_type, amrex::Real a_dt) {
                 pml[lev]->GetE_fp(), pml[lev]->GetB_fp(),
                 pml[lev]->Getj_fp(), pml[lev]->GetF_fp(),
                 pml[lev]->GetMultiSigmaBox_fp(),
-                a_dt, pml_has_particles );
+                a_dt, pml_has_particles, do_pml_fused_damping, do_pml_dive_cleaning );
         } else {
             m_fdtd_solver_cp[lev]->EvolveEPML(
                 pml[lev]->GetE_cp(), pml[lev]->GetB_cp(),
                 pml[lev]->Getj_cp(), pml[lev]->GetF_cp(),
                 pml[lev]->GetMultiSigmaBox_cp(),
-                a_dt, pml_has_particles );
+                a_dt, pml_has_particles, do_pml_fused_damping, do_pml_dive_cleaning );
         }
     }
 
@@ -23,7 +23,7 @@
 using namespace amrex;
 
 namespace {
-    void compute_stencil(Gpu::DeviceVector<Real> &stencil, unsigned int npass)
+    void compute_stencil(Gpu::DeviceVector<Real> &stencil, unsigned int npass, bool compensation)
     {
         Vector<Real> old_s(1u+npass,0.);
         Vector<Real> new_s(1u+npass,0.);
@@ -53,6 +53,21 @@ namespace {
         }
         // we use old_s here to make sure the stencil
         // is corrent even when npass = 0
+        if (compensation) {
+            // Convolve with the compensation stencil (-n/4, 1+n/2, -n/4)
+            const Real c0 = 1._rt + 0.5_rt*npass;
+            const Real c1 = -0.25_rt*npass;
+            const int ns = static_cast<int>(old_s.size());
+            Vector<Real> comp_s(ns+1, 0._rt);
+            for (int j=0; j<ns+1; j++){
+                // element j-1 of old_s, with old_s[-1] = old_s[1] by symmetry
+                const Real sm = (j>=1) ? old_s[j-1] : ((ns>1) ? old_s[1] : 0._rt);
+                const Real sc = (j<ns) ? old_s[j] : 0._rt;
+                const Real sp = (j+1<ns) ? old_s[j+1] : 0._rt;
+                comp_s[j] = c0*sc + c1*(sm + sp);
+            }
+            old_s = comp_s;
+        }
         old_s[0] *= 0.5_rt; // because we will use it twice
         stencil.resize(old_s.size());
         Gpu::copyAsync(Gpu::hostToDevice,old_s.begin(),old_s.end(),stencil.begin());
@@ -66,20 +81,22 @@ void BilinearFilter::ComputeStencils(){
     for (auto el : npass_each_dir )
         stencil_length_each_dir[i++] = el;
     stencil_length_each_dir += 1.;
+    // The compensation stencil extends the stencils by one cell
+    if (compensation) stencil_length_each_dir += 1.;
 #if (AMREX_SPACEDIM == 3)
     // npass_each_dir = npass_x npass_y npass_z
     stencil_x.resize( 1u + npass_each_dir[0] );
     stencil_y.resize( 1u + npass_each_dir[1] );
     stencil_z.resize( 1u + npass_each_dir[2] );
-    compute_stencil(stencil_x, npass_each_dir[0]);
-    compute_stencil(stencil_y, npass_each_dir[1]);
-    compute_stencil(stencil_z, npass_each_dir[2]);
+    compute_stencil(stencil_x, npass_each_dir[0], compensation);
+    compute_stencil(stencil_y, npass_each_dir[1], compensation);
+    compute_stencil(stencil_z, npass_each_dir[2], compensation);
 #elif (AMREX_SPACEDIM == 2)
     // npass_each_dir = npass_x npass_z
     stencil_x.resize( 1u + npass_each_dir[0] );
     stencil_z.resize( 1u + npass_each_dir[1] );
-    compute_stencil(stencil_x, npass_each_dir[0]);
-    compute_stencil(stencil_z, npass_each_dir[1]);
+    compute_stencil(stencil_x, npass_each_dir[0], compensation);
+    compute_stencil(stencil_z, npass_each_dir[1], compensation);
 #endif
     slen = stencil_length_each_dir.dim3();
 #if (AMREX_SPACEDIM == 2)
@@ -7,7 +7,13 @@
  */
 #include "Filter.H"
 
+#include "WarpX.H"
 #include "Utils/WarpXProfilerWrapper.H"
+#ifdef WARPX_USE_PSATD
+#   include "FieldSolver/SpectralSolver/AnyFFT.H"
+#   include "Utils/WarpXConst.H"
+#   include "Utils/WarpX_Complex.H"
+#endif
 
 #include <AMReX_Array4.H>
 #include <AMReX_Box.H>
@@ -15,10 +21,14 @@
 #include <AMReX_Extension.H>
 #include <AMReX_FArrayBox.H>
 #include <AMReX_FabArray.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_GpuMemory.H>
 #include <AMReX_MFIter.H>
 #include <AMReX_MultiFab.H>
 
 #include <algorithm>
+#include <array>
 
 using namespace amrex;
 
@@ -36,6 +46,12 @@ void
 Filter::ApplyStencil (MultiFab& dstmf, const MultiFab& srcmf, const int lev, int scomp, int dcomp, int ncomp)
 {
     WARPX_PROFILE("Filter::ApplyStencil(MultiFab)");
+#ifdef WARPX_USE_PSATD
+    if (use_spectral) {
+        ApplyStencilSpectral(dstmf, srcmf, lev, scomp, dcomp, ncomp);
+        return;
+    }
+#endif
     ncomp = std::min(ncomp, srcmf.nComp());
 
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
@@ -92,6 +108,12 @@ void Filter::DoFilter (const Box& tbx,
                        Array4<Real      > const& dst,
                        int scomp, int dcomp, int ncomp)
 {
+#if defined(AMREX_USE_CUDA) || defined(AMREX_USE_HIP)
+    if (DoFilterShared(tbx, src, dst, scomp, dcomp, ncomp)) return;
+#endif
+
+    // Direct application of the full stencil, reading the source array once per point
+    // of the stencil (used with SYCL, or when the halo of the fused kernel is too large)
     amrex::Real const* AMREX_RESTRICT sx = stencil_x.data();
 #if (AMREX_SPACEDIM == 3)
     amrex::Real const* AMREX_RESTRICT sy = stencil_y.data();
@@ -158,6 +180,149 @@ void Filter::DoFilter (const Box& tbx,
 #endif
 }
 
+#if defined(AMREX_USE_CUDA) || defined(AMREX_USE_HIP)
+/* \brief Apply stencil with a fused kernel (2D/3D, CUDA/HIP)
+ *
+ * The box tbx is split into bricks, one per block and component. Each block loads its
+ * brick of src plus a halo of (stencil length - 1) cells in shared memory (zero-padded
+ * beyond the source array), applies the separable stencil along x, then y, then z in
+ * shared memory, and writes the brick of dst once. Since the stencils already combine
+ * all the passes, the source and destination arrays are swept once per call, whatever
+ * the number of passes, and the work per cell is slen.x+slen.y+slen.z instead of
+ * slen.x*slen.y*slen.z.
+ * \return false if no brick size fits in the shared memory of a block
+ */
+bool Filter::DoFilterShared (const Box& tbx,
+                             Array4<Real const> const& src,
+                             Array4<Real      > const& dst,
+                             int scomp, int dcomp, int ncomp)
+{
+    WARPX_PROFILE("Filter::DoFilterShared()");
+
+    // Stencils along the i, j and k indices of the arrays
+    // (in 2D, the stencil along z is applied along j and there is none along k)
+    amrex::Real const* s0 = stencil_x.data();
+#if (AMREX_SPACEDIM == 3)
+    amrex::Real const* s1 = stencil_y.data();
+    amrex::Real const* s2 = stencil_z.data();
+#else
+    amrex::Real const* s1 = stencil_z.data();
+    amrex::Real const* s2 = nullptr;
+#endif
+    const Dim3 len = slen;
+    const Dim3 h = {len.x-1, len.y-1, len.z-1};
+
+    // Largest brick whose buffers fit in shared memory: the source with its halo, and
+    // the result of the first direction (the second direction reuses the first buffer)
+#if (AMREX_SPACEDIM == 3)
+    const std::array<Dim3,5> candidates = {{ {32,8,4}, {32,4,4}, {16,4,4}, {8,4,4}, {8,2,2} }};
+#else
+    const std::array<Dim3,5> candidates = {{ {32,16,1}, {32,8,1}, {16,8,1}, {16,4,1}, {8,4,1} }};
+#endif
+    const auto max_bytes = static_cast<std::size_t>(amrex::Gpu::Device::sharedMemPerBlock());
+    Dim3 brick = {0,0,0};
+    int buffer_npts = 0;
+    for (const auto& b : candidates) {
+        const int npts_src = (b.x+2*h.x)*(b.y+2*h.y)*(b.z+2*h.z);
+        const int npts_x = b.x*(b.y+2*h.y)*(b.z+2*h.z);
+        if ((npts_src + npts_x)*sizeof(amrex::Real) <= max_bytes) {
+            brick = b;
+            buffer_npts = npts_src;
+            break;
+        }
+    }
+    if (buffer_npts == 0) return false;
+    const std::size_t shared_mem_bytes =
+        (buffer_npts + brick.x*(brick.y+2*h.y)*(brick.z+2*h.z))*sizeof(amrex::Real);
+
+    const Dim3 lo = amrex::lbound(tbx);
+    const Dim3 hi = amrex::ubound(tbx);
+    const Dim3 nb = {(hi.x-lo.x+brick.x)/brick.x,
+                     (hi.y-lo.y+brick.y)/brick.y,
+                     (hi.z-lo.z+brick.z)/brick.z};
+    const int nbricks = nb.x*nb.y*nb.z;
+    if (nbricks*ncomp <= 0) return true;
+
+    constexpr int threads_per_block = 256;
+    amrex::launch(nbricks*ncomp, threads_per_block, shared_mem_bytes, amrex::Gpu::gpuStream(),
+        [=] AMREX_GPU_DEVICE () noexcept
+        {
+            const int n = blockIdx.x / nbricks;
+            const int ib = blockIdx.x - n*nbricks;
+            // First cell and size of the brick (clipped to tbx)
+            const int i0 = lo.x + (ib % nb.x)*brick.x;
+            const int j0 = lo.y + ((ib / nb.x) % nb.y)*brick.y;
+            const int k0 = lo.z + (ib / (nb.x*nb.y))*brick.z;
+            const int ni = amrex::min(brick.x, hi.x-i0+1);
+            const int nj = amrex::min(brick.y, hi.y-j0+1);
+            const int nk = amrex::min(brick.z, hi.z-k0+1);
+            // Size of the brick with its halo
+            const int mi = ni+2*h.x;
+            const int mj = nj+2*h.y;
+            const int mk = nk+2*h.z;
+
+            amrex::Gpu::SharedMemory<amrex::Real> gsm;
+            amrex::Real* const buf_a = gsm.dataPtr();
+            amrex::Real* const buf_b = buf_a + buffer_npts;
+
+            // Load the brick and its halo, with zeros beyond the source array
+            for (int m = threadIdx.x; m < mi*mj*mk; m += blockDim.x) {
+                const int ii = i0 - h.x + m % mi;
+                const int jj = j0 - h.y + (m / mi) % mj;
+                const int kk = k0 - h.z + m / (mi*mj);
+                buf_a[m] = src.contains(ii,jj,kk) ? src(ii,jj,kk,scomp+n) : 0.0_rt;
+            }
+            __syncthreads();
+
+            // Along i: buf_a (mi,mj,mk) -> buf_b (ni,mj,mk)
+            for (int m = threadIdx.x; m < ni*mj*mk; m += blockDim.x) {
+                const int ii = m % ni;
+                const int jk = m / ni;
+                amrex::Real const* row = buf_a + jk*mi + ii + h.x;
+                amrex::Real d = 0.0_rt;
+                for (int ix = 0; ix < len.x; ++ix) {
+                    d += s0[ix]*(row[-ix] + row[ix]);
+                }
+                buf_b[m] = d;
+            }
+            __syncthreads();
+
+            // Along j: buf_b (ni,mj,mk) -> buf_a (ni,nj,mk)
+            for (int m = threadIdx.x; m < ni*nj*mk; m += blockDim.x) {
+                const int ii = m % ni;
+                const int jj = (m / ni) % nj;
+                const int kk = m / (ni*nj);
+                amrex::Real const* col = buf_b + (kk*mj + jj + h.y)*ni + ii;
+                amrex::Real d = 0.0_rt;
+                for (int iy = 0; iy < len.y; ++iy) {
+                    d += s1[iy]*(col[-iy*ni] + col[iy*ni]);
+                }
+                buf_a[m] = d;
+            }
+            __syncthreads();
+
+            // Along k: buf_a (ni,nj,mk) -> dst
+            for (int m = threadIdx.x; m < ni*nj*nk; m += blockDim.x) {
+                const int ii = m % ni;
+                const int jj = (m / ni) % nj;
+                const int kk = m / (ni*nj);
+                amrex::Real d;
+                if (s2) {
+                    amrex::Real const* col = buf_a + (kk + h.z)*ni*nj + jj*ni + ii;
+                    d = 0.0_rt;
+                    for (int iz = 0; iz < len.z; ++iz) {
+                        d += s2[iz]*(col[-iz*ni*nj] + col[iz*ni*nj]);
+                    }
+                } else {
+                    d = buf_a[m];
+                }
+                dst(i0+ii,j0+jj,k0+kk,dcomp+n) = d;
+            }
+        });
+    return true;
+}
+#endif
+
 #else
 
 /* \brief Apply stencil on MultiFab (CPU version, 2D/3D).
@@ -172,6 +337,12 @@ void
 Filter::ApplyStencil (amrex::MultiFab& dstmf, const amrex::MultiFab& srcmf, const int lev, int scomp, int dcomp, int ncomp)
 {
     WARPX_PROFILE("Filter::ApplyStencil(MultiFab)");
+#ifdef WARPX_USE_PSATD
+    if (use_spectral) {
+        ApplyStencilSpectral(dstmf, srcmf, lev, scomp, dcomp, ncomp);
+        return;
+    }
+#endif
     ncomp = std::min(ncomp, srcmf.nComp());
 
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
@@ -239,6 +410,12 @@ Filter::ApplyStencil (amrex::FArrayBox& dstfab, const amrex::FArrayBox& srcfab,
     DoFilter(tbx, tmpfab.array(), dstfab.array(), 0, dcomp, ncomp);
 }
 
+/* \brief Apply stencil (2D/3D, CPU version)
+ *
+ * The stencil is separable: it is applied along x from tmp to a buffer grown along the
+ * other directions, then along y, then along z to dst. Since tmp is defined on the tile
+ * plus its halo, the buffers stay in cache, and dst is written once per call.
+ */
 void Filter::DoFilter (const Box& tbx,
                        Array4<Real const> const& tmp,
                        Array4<Real      > const& dst,
@@ -252,51 +429,203 @@ void Filter::DoFilter (const Box& tbx,
     amrex::Real const* AMREX_RESTRICT sy = stencil_y.data();
 #endif
     amrex::Real const* AMREX_RESTRICT sz = stencil_z.data();
+
+    // Buffers after the stencil along x (grown along the other directions),
+    // and, in 3D, after the stencil along y (grown along z)
+    const int hj = slen.y-1;
+    const int hk = slen.z-1;
+    const Box& bx_x = amrex::grow(tbx, amrex::IntVect(AMREX_D_DECL(0,hj,hk)));
+    FArrayBox fab_x(bx_x, 1);
+    const auto& buf_x = fab_x.array();
+#if (AMREX_SPACEDIM == 3)
+    const Box& bx_y = amrex::grow(tbx, amrex::IntVect(0,0,hk));
+    FArrayBox fab_y(bx_y, 1);
+    const auto& buf_y = fab_y.array();
+#endif
+
     for (int n = 0; n < ncomp; ++n) {
-        // Set dst value to 0.
+        // Along x
+        for         (int k = lo.z-hk; k <= hi.z+hk; ++k) {
+            for     (int j = lo.y-hj; j <= hi.y+hj; ++j) {
+                AMREX_PRAGMA_SIMD
+                for (int i = lo.x; i <= hi.x; ++i) {
+                    buf_x(i,j,k) = 0.0_rt;
+                }
+                for (int ix=0; ix < slen.x; ++ix){
+                    const Real s = sx[ix];
+                    AMREX_PRAGMA_SIMD
+                    for (int i = lo.x; i <= hi.x; ++i) {
+                        buf_x(i,j,k) += s*(tmp(i-ix,j,k,scomp+n) + tmp(i+ix,j,k,scomp+n));
+                    }
+                }
+            }
+        }
+#if (AMREX_SPACEDIM == 3)
+        // Along y
+        for         (int k = lo.z-hk; k <= hi.z+hk; ++k) {
+            for     (int j = lo.y; j <= hi.y; ++j) {
+                AMREX_PRAGMA_SIMD
+                for (int i = lo.x; i <= hi.x; ++i) {
+                    buf_y(i,j,k) = 0.0_rt;
+                }
+                for (int iy=0; iy < slen.y; ++iy){
+                    const Real s = sy[iy];
+                    AMREX_PRAGMA_SIMD
+                    for (int i = lo.x; i <= hi.x; ++i) {
+                        buf_y(i,j,k) += s*(buf_x(i,j-iy,k) + buf_x(i,j+iy,k));
+                    }
+                }
+            }
+        }
+        // Along z
         for         (int k = lo.z; k <= hi.z; ++k) {
             for     (int j = lo.y; j <= hi.y; ++j) {
+                AMREX_PRAGMA_SIMD
                 for (int i = lo.x; i <= hi.x; ++i) {
-                    dst(i,j,k,dcomp+n) = 0.0;
+                    dst(i,j,k,dcomp+n) = 0.0_rt;
+                }
+                for (int iz=0; iz < slen.z; ++iz){
+                    const Real s = sz[iz];
+                    AMREX_PRAGMA_SIMD
+                    for (int i = lo.x; i <= hi.x; ++i) {
+                        dst(i,j,k,dcomp+n) += s*(buf_y(i,j,k-iz) + buf_y(i,j,k+iz));
+                    }
                 }
             }
         }
-        // 3 nested loop on 3D stencil
-        for         (int iz=0; iz < slen.z; ++iz){
-            for     (int iy=0; iy < slen.y; ++iy){
-                for (int ix=0; ix < slen.x; ++ix){
-#if (AMREX_SPACEDIM == 3)
-                    Real sss = sx[ix]*sy[iy]*sz[iz];
-#else
-                    Real sss = sx[ix]*sz[iy];
-#endif
-                    // 3 nested loop on 3D array
-                    for         (int k = lo.z; k <= hi.z; ++k) {
-                        for     (int j = lo.y; j <= hi.y; ++j) {
-                            AMREX_PRAGMA_SIMD
-                            for (int i = lo.x; i <= hi.x; ++i) {
-#if (AMREX_SPACEDIM == 3)
-                                dst(i,j,k,dcomp+n) += sss*(tmp(i-ix,j-iy,k-iz,scomp+n)
-                                                          +tmp(i+ix,j-iy,k-iz,scomp+n)
-                                                          +tmp(i-ix,j+iy,k-iz,scomp+n)
-                                                          +tmp(i+ix,j+iy,k-iz,scomp+n)
-                                                          +tmp(i-ix,j-iy,k+iz,scomp+n)
-                                                          +tmp(i+ix,j-iy,k+iz,scomp+n)
-                                                          +tmp(i-ix,j+iy,k+iz,scomp+n)
-                                                          +tmp(i+ix,j+iy,k+iz,scomp+n));
 #else
-                                dst(i,j,k,dcomp+n) += sss*(tmp(i-ix,j-iy,k,scomp+n)
-                                                          +tmp(i+ix,j-iy,k,scomp+n)
-                                                          +tmp(i-ix,j+iy,k,scomp+n)
-                                                          +tmp(i+ix,j+iy,k,scomp+n));
-#endif
-                            }
-                        }
+        // Along z (second index in 2D)
+        for         (int k = lo.z; k <= hi.z; ++k) {
+            for     (int j = lo.y; j <= hi.y; ++j) {
+                AMREX_PRAGMA_SIMD
+                for (int i = lo.x; i <= hi.x; ++i) {
+                    dst(i,j,k,dcomp+n) = 0.0_rt;
+                }
+                for (int iz=0; iz < slen.y; ++iz){
+                    const Real s = sz[iz];
+                    AMREX_PRAGMA_SIMD
+                    for (int i = lo.x; i <= hi.x; ++i) {
+                        dst(i,j,k,dcomp+n) += s*(buf_x(i,j-iz,k) + buf_x(i,j+iz,k));
                     }
                 }
             }
         }
+#endif
     }
 }
 
 #endif // #ifdef AMREX_USE_CUDA
+
+#ifdef WARPX_USE_PSATD
+
+/* \brief Apply stencil on MultiFab in k-space (CPU/GPU, 2D/3D).
+ *
+ * For each box, the source (grown by the stencil length - 1, and padded with zeros beyond
+ * the source array, as in real space) is transformed with one batched R2C FFT for all the
+ * components, multiplied by the transfer function of the separable stencil, and transformed
+ * back. Since the stencil has a compact support, the circular convolution on the grown box
+ * is the same as the real-space one on the destination box. The cost does not depend on the
+ * number of passes, which makes this cheaper than the real-space filter for many passes.
+ * \param dstmf Destination MultiFab
+ * \param srcmf source MultiFab
+ * \param[in] lev mesh refinement level
+ * \param scomp first component of srcmf on which the filter is applied
+ * \param dcomp first component of dstmf on which the filter is applied
+ * \param ncomp Number of components on which the filter is applied.
+ */
+void
+Filter::ApplyStencilSpectral (MultiFab& dstmf, const MultiFab& srcmf, const int lev, int scomp, int dcomp, int ncomp)
+{
+    WARPX_PROFILE("Filter::ApplyStencilSpectral()");
+    ncomp = std::min(ncomp, srcmf.nComp());
+
+    amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
+
+    // Stencils along the i, j and k indices of the arrays
+    // (in 2D, the stencil along z is along j and there is none along k)
+    amrex::Real const* s0 = stencil_x.data();
+#if (AMREX_SPACEDIM == 3)
+    amrex::Real const* s1 = stencil_y.data();
+    amrex::Real const* s2 = stencil_z.data();
+#else
+    amrex::Real const* s1 = stencil_z.data();
+    amrex::Real const* s2 = nullptr;
+#endif
+    const Dim3 len = slen;
+
+    // One FFT per box (no tiling)
+    for (MFIter mfi(dstmf); mfi.isValid(); ++mfi)
+    {
+        if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+        {
+            amrex::Gpu::synchronize();
+        }
+        amrex::Real wt = amrex::second();
+
+        const Box& tbx = mfi.growntilebox();
+        const Box& gbx = amrex::grow(tbx, stencil_length_each_dir-1);
+        const IntVect fft_size = gbx.length();
+        const Dim3 n3 = fft_size.dim3();
+        // Complex box of the R2C transform (half of the first dimension)
+        IntVect chi = fft_size - 1;
+        chi[0] = fft_size[0]/2;
+        const Box cbx(IntVect::TheZeroVector(), chi);
+
+        FArrayBox real_fab(gbx, ncomp, amrex::The_Async_Arena());
+        BaseFab<Complex> complex_fab(cbx, ncomp, amrex::The_Async_Arena());
+        const auto& real_arr = real_fab.array();
+        const auto& complex_arr = complex_fab.array();
+
+        // Copy the source, with zeros beyond it
+        const auto& src = srcmf.const_array(mfi);
+        amrex::ParallelFor(gbx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            real_arr(i,j,k,n) = src.contains(i,j,k) ? src(i,j,k,scomp+n) : 0.0_rt;
+        });
+
+        AnyFFT::FFTplan forward_plan = AnyFFT::CreatePlan(
+            fft_size, real_fab.dataPtr(), reinterpret_cast<AnyFFT::Complex*>(complex_fab.dataPtr()),
+            AnyFFT::direction::R2C, AMREX_SPACEDIM, ncomp);
+        AnyFFT::FFTplan backward_plan = AnyFFT::CreatePlan(
+            fft_size, real_fab.dataPtr(), reinterpret_cast<AnyFFT::Complex*>(complex_fab.dataPtr()),
+            AnyFFT::direction::C2R, AMREX_SPACEDIM, ncomp);
+
+        AnyFFT::Execute(forward_plan);
+
+        // Transfer function of the stencil, normalized by the size of the FFT
+        const amrex::Real inv_npts = 1._rt/static_cast<amrex::Real>(gbx.numPts());
+        amrex::ParallelFor(cbx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            // The stencil element 0 is stored halved (it is used twice)
+            const auto transfer = [] (amrex::Real const* s, int ns, int m, int nfft) noexcept
+            {
+                const amrex::Real kdx = 2._rt*MathConst::pi*m/nfft;
+                amrex::Real h = 0._rt;
+                for (int is = 0; is < ns; ++is) h += 2._rt*s[is]*std::cos(is*kdx);
+                return h;
+            };
+            amrex::Real filt = inv_npts * transfer(s0, len.x, i, n3.x) * transfer(s1, len.y, j, n3.y);
+            if (s2) filt *= transfer(s2, len.z, k, n3.z);
+            complex_arr(i,j,k,n) *= filt;
+        });
+
+        AnyFFT::Execute(backward_plan);
+        AnyFFT::DestroyPlan(forward_plan);
+        AnyFFT::DestroyPlan(backward_plan);
+
+        const auto& dst = dstmf.array(mfi);
+        amrex::ParallelFor(tbx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            dst(i,j,k,dcomp+n) = real_arr(i,j,k,n);
+        });
+
+        if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+        {
+            amrex::Gpu::synchronize();
+            wt = amrex::second() - wt;
+            amrex::HostDevice::Atomic::Add( &(*cost)[mfi.index()], wt);
+        }
+    }
+}
+
+#endif // WARPX_USE_PSATD
@@ -0,0 +1,258 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "ExternalFieldFromFile.H"
+
+#include <AMReX.H>
+#include <AMReX_Array4.H>
+#include <AMReX_BLProfiler.H>
+#include <AMReX_Box.H>
+#include <AMReX_GpuContainers.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_REAL.H>
+#include <AMReX_Vector.H>
+
+#ifdef WARPX_USE_OPENPMD
+#   include <openPMD/openPMD.hpp>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace amrex;
+
+#ifdef WARPX_USE_OPENPMD
+namespace
+{
+    /** Hyperslab of the file that covers one box, in the order of the axes of the file */
+    struct Hyperslab
+    {
+        openPMD::Offset offset;
+        openPMD::Extent count;
+        std::shared_ptr<float> data_float;
+        std::shared_ptr<double> data_double;
+    };
+
+    /** \brief Read one component of the mesh and interpolate it onto mf */
+    void ReadComponent (openPMD::Mesh& mesh, const std::string& comp_name, MultiFab& mf,
+                        const Geometry& geom, const MultiFab* geom_data,
+                        openPMD::Series& series)
+    {
+#if (AMREX_SPACEDIM == 3)
+        const std::vector<std::string> warpx_axes = {"x", "y", "z"};
+#else
+        const std::vector<std::string> warpx_axes = {"x", "z"};
+#endif
+        const std::vector<std::string> file_axes = mesh.axisLabels();
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(file_axes.size() == AMREX_SPACEDIM,
+            "external field file: the mesh " + comp_name + " must have as many axes as the simulation");
+        const std::vector<double> spacing = mesh.gridSpacing<double>();
+        const std::vector<double> global_offset = mesh.gridGlobalOffset();
+        const double unit_length = mesh.gridUnitSI();
+
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(mesh.contains(comp_name),
+            "external field file: the mesh has no component " + comp_name);
+        auto comp = mesh[comp_name];
+        const std::vector<double> position = comp.position<double>();
+        const openPMD::Extent extent = comp.getExtent();
+        const Real unit_field = static_cast<Real>(comp.unitSI());
+        const openPMD::Datatype dtype = comp.getDatatype();
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+            dtype == openPMD::Datatype::FLOAT || dtype == openPMD::Datatype::DOUBLE,
+            "external field file: the data must be float or double");
+
+        // Axis of the file of each dimension of the simulation, and C-order strides of the file
+        GpuArray<int, AMREX_SPACEDIM> file_axis;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const auto it = std::find(file_axes.begin(), file_axes.end(), warpx_axes[idim]);
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(it != file_axes.end(),
+                "external field file: the mesh has no axis " + warpx_axes[idim]);
+            file_axis[idim] = static_cast<int>(it - file_axes.begin());
+        }
+
+        // Position of the points of the file: x = (offset + (n + position)*spacing)*unit_length,
+        // position of the points of mf: x = prob_lo + (i + 0.5*(1-nodal))*dx
+        const IntVect nodal = mf.ixType().toIntVect();
+        GpuArray<Real, AMREX_SPACEDIM> s0, ds;
+        GpuArray<int, AMREX_SPACEDIM> npts;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const int a = file_axis[idim];
+            const double x0 = geom.ProbLo(idim) + 0.5*(1 - nodal[idim])*geom.CellSize(idim);
+            s0[idim] = static_cast<Real>((x0/unit_length - global_offset[a])/spacing[a] - position[a]);
+            ds[idim] = static_cast<Real>(geom.CellSize(idim)/unit_length/spacing[a]);
+            npts[idim] = static_cast<int>(extent[a]);
+        }
+
+        // Hyperslab of each box: the points of the file that surround the points of the box
+        Vector<Hyperslab> slabs;
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.fabbox();
+            Hyperslab slab;
+            slab.offset.assign(AMREX_SPACEDIM, 0);
+            slab.count.assign(AMREX_SPACEDIM, 0);
+            bool empty = false;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                const int a = file_axis[idim];
+                const Real slo = s0[idim] + bx.smallEnd(idim)*ds[idim];
+                const Real shi = s0[idim] + bx.bigEnd(idim)*ds[idim];
+                const int nlo = std::max(0, static_cast<int>(std::floor(slo)));
+                const int nhi = std::min(npts[idim]-1, static_cast<int>(std::floor(shi)) + 1);
+                if (nhi < nlo) empty = true;
+                slab.offset[a] = static_cast<std::uint64_t>(nlo);
+                slab.count[a] = static_cast<std::uint64_t>(std::max(nhi - nlo + 1, 0));
+            }
+            if (!empty) {
+                if (dtype == openPMD::Datatype::FLOAT) {
+                    slab.data_float = comp.loadChunk<float>(slab.offset, slab.count);
+                } else {
+                    slab.data_double = comp.loadChunk<double>(slab.offset, slab.count);
+                }
+            }
+            slabs.push_back(std::move(slab));
+        }
+        series.flush();
+
+        int islab = 0;
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi, ++islab)
+        {
+            const Box& bx = mfi.fabbox();
+            const Hyperslab& slab = slabs[islab];
+            auto const& arr = mf.array(mfi);
+#ifdef AMREX_USE_EB
+            const auto& geom_arr = geom_data->const_array(mfi);
+#else
+            amrex::ignore_unused(geom_data);
+#endif
+            std::size_t nslab = 1;
+            for (const auto c : slab.count) nslab *= c;
+            if (nslab == 0) {
+                amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+#ifdef AMREX_USE_EB
+                    if (geom_arr(i, j, k) <= 0) return;
+#endif
+                    arr(i, j, k) = 0._rt;
+                });
+                continue;
+            }
+
+            // Copy the hyperslab to the device, in the units of the simulation
+            Vector<Real> h_data(nslab);
+            for (std::size_t n = 0; n < nslab; ++n) {
+                h_data[n] = unit_field * (slab.data_float ? static_cast<Real>(slab.data_float.get()[n])
+                                                          : static_cast<Real>(slab.data_double.get()[n]));
+            }
+            Gpu::DeviceVector<Real> d_data(nslab);
+            Gpu::copyAsync(Gpu::hostToDevice, h_data.begin(), h_data.end(), d_data.begin());
+            const Real* AMREX_RESTRICT data = d_data.dataPtr();
+
+            // Offset and stride of the hyperslab along each dimension
+            GpuArray<int, AMREX_SPACEDIM> lo, stride;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                const int a = file_axis[idim];
+                lo[idim] = static_cast<int>(slab.offset[a]);
+                int st = 1;
+                for (int b = a+1; b < AMREX_SPACEDIM; ++b) st *= static_cast<int>(slab.count[b]);
+                stride[idim] = st;
+            }
+
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+#ifdef AMREX_USE_EB
+                if (geom_arr(i, j, k) <= 0) return;
+#endif
+#if (AMREX_SPACEDIM == 3)
+                const int idx[3] = {i, j, k};
+#else
+                amrex::ignore_unused(k);
+                const int idx[2] = {i, j};
+#endif
+                // Linear interpolation weights along each dimension
+                int n0[AMREX_SPACEDIM];
+                Real w[AMREX_SPACEDIM];
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    const Real s = s0[idim] + idx[idim]*ds[idim];
+                    if (npts[idim] == 1) {
+                        n0[idim] = 0;
+                        w[idim] = 0._rt;
+                        continue;
+                    }
+                    if (s < 0._rt || s > npts[idim] - 1) {
+                        arr(i, j, k) = 0._rt;
+                        return;
+                    }
+                    const int n = amrex::min(static_cast<int>(amrex::Math::floor(s)), npts[idim] - 2);
+                    n0[idim] = n - lo[idim];
+                    w[idim] = s - n;
+                }
+                Real value = 0._rt;
+                for (int corner = 0; corner < (1 << AMREX_SPACEDIM); ++corner) {
+                    Real weight = 1._rt;
+                    int offset = 0;
+                    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                        const int up = (corner >> idim) & 1;
+                        if (up && w[idim] == 0._rt) { weight = 0._rt; break; }
+                        weight *= up ? w[idim] : 1._rt - w[idim];
+                        offset += (n0[idim] + up) * stride[idim];
+                    }
+                    if (weight != 0._rt) value += weight * data[offset];
+                }
+                arr(i, j, k) = value;
+            });
+            // d_data must outlive the kernel
+            Gpu::streamSynchronize();
+        }
+    }
+}
+#endif
+
+void ReadExternalFieldFromFile (
+    const std::string& read_path, const std::string& F_name,
+    MultiFab* mfx, MultiFab* mfy, MultiFab* mfz,
+    const Geometry& geom,
+    std::array< std::unique_ptr<MultiFab>, 3 > const& geom_data)
+{
+    BL_PROFILE("ReadExternalFieldFromFile");
+#ifdef WARPX_DIM_RZ
+    amrex::Abort("Reading the external fields from a file does not work with RZ -- TO DO");
+#endif
+#ifdef WARPX_USE_OPENPMD
+    // All MPI ranks open the file: each of them reads the hyperslabs of its own boxes
+#   if defined(AMREX_USE_MPI)
+    openPMD::Series series(read_path, openPMD::Access::READ_ONLY,
+                           ParallelDescriptor::Communicator());
+#   else
+    openPMD::Series series(read_path, openPMD::Access::READ_ONLY);
+#   endif
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(series.iterations.size() == 1u,
+        "External field file " + read_path + " should contain only 1 iteration");
+    auto it = series.iterations.begin()->second;
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(it.meshes.contains(F_name),
+        "External field file " + read_path + " has no mesh " + F_name);
+    auto mesh = it.meshes[F_name];
+
+    const MultiFab* geom_x = nullptr;
+    const MultiFab* geom_y = nullptr;
+    const MultiFab* geom_z = nullptr;
+#ifdef AMREX_USE_EB
+    geom_x = geom_data[0].get();
+    geom_y = geom_data[1].get();
+    geom_z = geom_data[2].get();
+#else
+    amrex::ignore_unused(geom_data);
+#endif
+    ReadComponent(mesh, "x", *mfx, geom, geom_x, series);
+    ReadComponent(mesh, "y", *mfy, geom, geom_y, series);
+    ReadComponent(mesh, "z", *mfz, geom, geom_z, series);
+#else
+    amrex::ignore_unused(read_path, F_name, mfx, mfy, mfz, geom, geom_data);
+    amrex::Abort("WarpX has to be compiled with USE_OPENPMD=TRUE to be able"
+                 " to read the external fields from a file");
+#endif
+}
@@ -10,7 +10,10 @@
 #include "Initialization/CustomDensityProb.H"
 #include "Utils/WarpXUtil.H"
 
+#include <AMReX_Arena.H>
 #include <AMReX_BLassert.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_GpuLaunch.H>
 #include <AMReX_ParmParse.H>
 
 #include <algorithm>
@@ -27,6 +30,11 @@ void InjectorDensity::clear ()
     {
         break;
     }
+    case Type::table:
+    {
+        object.table.clear();
+        break;
+    }
     case Type::custom:
     {
         object.custom.clear();
@@ -74,3 +82,57 @@ InjectorDensityPredefined::InjectorDensityPredefined (
 void InjectorDensityPredefined::clear ()
 {
 }
+
+InjectorDensityTable::InjectorDensityTable (
+    std::string const& a_species_name, amrex::ParserExecutor<3> const& a_parser)
+{
+    ParmParse pp_species_name(a_species_name);
+
+    std::vector<int> n;
+    std::vector<amrex::Real> lo, hi;
+    getArrWithParser(pp_species_name, "density_table_n", n);
+    getArrWithParser(pp_species_name, "density_table_lo", lo);
+    getArrWithParser(pp_species_name, "density_table_hi", hi);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(n.size() == 3 && lo.size() == 3 && hi.size() == 3,
+        "density_table_n, density_table_lo and density_table_hi must have 3 components (x, y, z)");
+
+    long npts = 1;
+    for (int d = 0; d < 3; ++d) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(n[d] >= 1,
+            "density_table_n must be at least 1 in each direction");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(n[d] == 1 || hi[d] > lo[d],
+            "density_table_hi must be larger than density_table_lo");
+        m_n[d] = n[d];
+        m_lo[d] = lo[d];
+        m_dxi[d] = (n[d] > 1) ? (n[d]-1)/(hi[d]-lo[d]) : amrex::Real(0.);
+        npts *= n[d];
+    }
+
+    // Tabulate the density on the nodes of the table
+    m_table = static_cast<amrex::Real*>(amrex::The_Arena()->alloc(npts*sizeof(amrex::Real)));
+    amrex::Real* const table = m_table;
+    const auto n_arr = m_n;
+    const auto lo_arr = m_lo;
+    const auto dxi_arr = m_dxi;
+    amrex::ParallelFor(npts, [=] AMREX_GPU_DEVICE (long i) noexcept
+    {
+        const int ix = static_cast<int>(i % n_arr[0]);
+        const int iy = static_cast<int>((i / n_arr[0]) % n_arr[1]);
+        const int iz = static_cast<int>(i / (static_cast<long>(n_arr[0])*n_arr[1]));
+        const amrex::Real x = (n_arr[0] > 1) ? lo_arr[0] + ix/dxi_arr[0] : lo_arr[0];
+        const amrex::Real y = (n_arr[1] > 1) ? lo_arr[1] + iy/dxi_arr[1] : lo_arr[1];
+        const amrex::Real z = (n_arr[2] > 1) ? lo_arr[2] + iz/dxi_arr[2] : lo_arr[2];
+        table[i] = a_parser(x, y, z);
+    });
+    amrex::Gpu::streamSynchronize();
+}
+
+// Note that we are not allowed to have non-trivial destructor.
+// So we rely on clear() to free memory if needed.
+void InjectorDensityTable::clear ()
+{
+    if (m_table) {
+        amrex::The_Arena()->free(m_table);
+        m_table = nullptr;
+    }
+}
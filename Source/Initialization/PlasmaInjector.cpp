@@ -15,6 +15,7 @@
 #include "Initialization/InjectorMomentum.H"
 #include "Initialization/InjectorPosition.H"
 #include "Particles/SpeciesPhysicalProperties.H"
+#include "Utils/ParserSpecialization.H"
 #include "Utils/WarpXConst.H"
 #include "Utils/WarpXUtil.H"
 #include "WarpX.H"
@@ -35,6 +36,7 @@
 #include <cctype>
 #include <map>
 #include <memory>
+#include <regex>
 #include <sstream>
 #include <utility>
 #include <vector>
@@ -326,10 +328,18 @@ PlasmaInjector::PlasmaInjector (int ispecies, const std::string& name)
         queryWithParser(pp_species_name, "z_shift",z_shift);
 
 #ifdef WARPX_USE_OPENPMD
-        if (amrex::ParallelDescriptor::IOProcessor()) {
-            m_openpmd_input_series = std::make_unique<openPMD::Series>(
-                str_injection_file, openPMD::Access::READ_ONLY);
+        // All MPI ranks open the file: each of them reads a chunk of the particles
+        // (see PhysicalParticleContainer::AddPlasmaFromFile)
+#   if defined(AMREX_USE_MPI)
+        m_openpmd_input_series = std::make_unique<openPMD::Series>(
+            str_injection_file, openPMD::Access::READ_ONLY,
+            amrex::ParallelDescriptor::Communicator());
+#   else
+        m_openpmd_input_series = std::make_unique<openPMD::Series>(
+            str_injection_file, openPMD::Access::READ_ONLY);
+#   endif
 
+        if (amrex::ParallelDescriptor::IOProcessor()) {
             AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
                 m_openpmd_input_series->iterations.size() == 1u,
                 "External file should contain only 1 iteration\n");
@@ -471,6 +481,8 @@ void PlasmaInjector::parseDensity (amrex::ParmParse& pp)
         getWithParser(pp, "density", density);
         // Construct InjectorDensity with InjectorDensityConstant.
         h_inj_rho.reset(new InjectorDensity((InjectorDensityConstant*)nullptr, density));
+        density_is_z_invariant = true;
+        density_is_transverse_invariant = true;
     } else if (rho_prof_s == "custom") {
         // Construct InjectorDensity with InjectorDensityCustom.
         h_inj_rho.reset(new InjectorDensity((InjectorDensityCustom*)nullptr, species_name));
@@ -482,8 +494,20 @@ void PlasmaInjector::parseDensity (amrex::ParmParse& pp)
         // Construct InjectorDensity with InjectorDensityParser.
         density_parser = std::make_unique<amrex::Parser>(makeParser(
                                                               str_density_function,{"x","y","z"}));
-        h_inj_rho.reset(new InjectorDensity((InjectorDensityParser*)nullptr,
-                                            density_parser->compile<3>()));
+        if (pp.contains("density_table_n")) {
+            // Construct InjectorDensity with InjectorDensityTable,
+            // where the parser is only evaluated on the nodes of the table.
+            h_inj_rho.reset(new InjectorDensity((InjectorDensityTable*)nullptr, species_name,
+                                                density_parser->compile<3>()));
+        } else {
+            h_inj_rho.reset(new InjectorDensity((InjectorDensityParser*)nullptr,
+                compileSpecializedParser<3>(*density_parser, str_density_function, {"x","y","z"})));
+        }
+        // The density does not depend on z if the expression does not use the variable z
+        density_is_z_invariant = !std::regex_search(str_density_function, std::regex("\\bz\\b"));
+        // The density only depends on z if the expression does not use the variables x and y
+        density_is_transverse_invariant =
+            !std::regex_search(str_density_function, std::regex("\\b[xy]\\b"));
     } else {
         //No need for profile definition if external file is used
         std::string injection_style = "none";
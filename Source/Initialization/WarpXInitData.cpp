@@ -12,11 +12,13 @@
 
 #include "BoundaryConditions/PML.H"
 #include "Diagnostics/BackTransformedDiagnostic.H"
+#include "Diagnostics/ComputeDiagFunctors/RhoFunctor.H"
 #include "Diagnostics/MultiDiagnostics.H"
 #include "Diagnostics/ReducedDiags/MultiReducedDiags.H"
 #include "FieldSolver/FiniteDifferenceSolver/MacroscopicProperties/MacroscopicProperties.H"
 #include "Filter/BilinearFilter.H"
 #include "Filter/NCIGodfreyFilter.H"
+#include "Initialization/ExternalFieldFromFile.H"
 #include "Particles/MultiParticleContainer.H"
 #include "Parallelization/WarpXCommUtil.H"
 #include "Utils/WarpXAlgorithmSelection.H"
@@ -37,6 +39,7 @@
 #include <AMReX_BoxList.H>
 #include <AMReX_Config.H>
 #include <AMReX_Geometry.H>
+#include <AMReX_GpuDevice.H>
 #include <AMReX_GpuLaunch.H>
 #include <AMReX_GpuQualifiers.H>
 #include <AMReX_INT.H>
@@ -57,6 +60,7 @@
 #include <algorithm>
 #include <array>
 #include <cctype>
+#include <iomanip>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -66,6 +70,33 @@
 
 using namespace amrex;
 
+namespace
+{
+    /** Time the enclosing scope, as one phase of WarpX::InitData */
+    class StartupPhaseTimer
+    {
+    public:
+        StartupPhaseTimer (Vector<std::pair<std::string, Real> >& times, std::string name)
+            : m_times(times), m_name(std::move(name)), m_start(amrex::second())
+        {}
+
+        ~StartupPhaseTimer ()
+        {
+            // Include the kernels launched during this phase
+            amrex::Gpu::synchronize();
+            m_times.emplace_back(m_name, amrex::second() - m_start);
+        }
+
+        StartupPhaseTimer (const StartupPhaseTimer&) = delete;
+        StartupPhaseTimer& operator= (const StartupPhaseTimer&) = delete;
+
+    private:
+        Vector<std::pair<std::string, Real> >& m_times;
+        std::string m_name;
+        Real m_start;
+    };
+}
+
 void
 WarpX::PostProcessBaseGrids (BoxArray& ba0) const
 {
@@ -112,6 +143,11 @@ WarpX::InitData ()
     Print() << "PICSAR (" << WarpX::PicsarVersion() << ")\n";
 #endif
 
+    const Real strt_init = amrex::second();
+    m_startup_times.clear();
+
+    SelectRestartCheckpoint();
+
     if (restart_chkfile.empty())
     {
         ComputeDt();
@@ -120,30 +156,40 @@ WarpX::InitData ()
     }
     else
     {
-        InitFromCheckpoint();
+        {
+            StartupPhaseTimer timer(m_startup_times, "Read checkpoint");
+            InitFromCheckpoint();
+        }
         WarpX::PrintDtDxDyDz();
+        StartupPhaseTimer timer(m_startup_times, "Post-restart setup");
         PostRestart();
     }
 
     ComputeMaxStep();
 
-    ComputePMLFactors();
+    {
+        StartupPhaseTimer timer(m_startup_times, "PML factors and filters");
+        ComputePMLFactors();
 
-    if (WarpX::use_fdtd_nci_corr) {
-        WarpX::InitNCICorrector();
-    }
+        if (WarpX::use_fdtd_nci_corr) {
+            WarpX::InitNCICorrector();
+        }
 
-    if (WarpX::use_filter) {
-        WarpX::InitFilter();
-    }
+        if (WarpX::use_filter) {
+            WarpX::InitFilter();
+        }
 
-    BuildBufferMasks();
+        BuildBufferMasks();
 
-    if (WarpX::em_solver_medium==1) {
-        m_macroscopic_properties->InitData();
+        if (WarpX::em_solver_medium==1) {
+            m_macroscopic_properties->InitData();
+        }
     }
 
-    InitDiagnostics();
+    {
+        StartupPhaseTimer timer(m_startup_times, "Diagnostics setup");
+        InitDiagnostics();
+    }
 
     if (ParallelDescriptor::IOProcessor()) {
         std::cout << "\nGrids Summary:\n";
@@ -153,13 +199,18 @@ WarpX::InitData ()
     // Check that the number of guard cells is smaller than the number of valid cells for all MultiFabs
     // (example: a box with 16 valid cells and 32 guard cells in z will not be considered valid)
     CheckGuardCells();
+    if (verbose) guard_cells.PrintGuardCellVolumes(boxArray(0));
 
     if (restart_chkfile.empty())
     {
-        // Loop through species and calculate their space-charge field
-        bool const reset_fields = false; // Do not erase previous user-specified values on the grid
-        ComputeSpaceChargeField(reset_fields);
+        {
+            StartupPhaseTimer timer(m_startup_times, "Space-charge fields");
+            // Loop through species and calculate their space-charge field
+            bool const reset_fields = false; // Do not erase previous user-specified values on the grid
+            ComputeSpaceChargeField(reset_fields);
+        }
 
+        StartupPhaseTimer timer(m_startup_times, "Initial diagnostics output");
         // Write full diagnostics before the first iteration.
         multi_diags->FilterComputePackFlush( -1 );
 
@@ -169,11 +220,36 @@ WarpX::InitData ()
             reduced_diags->ComputeDiags(-1);
             reduced_diags->WriteToFile(-1);
         }
+        RhoFunctor::ClearCache();
     }
 
+    // Pre-reserve the memory for the growth of the particles and fields
+    WarpXUtilMem::ReserveArenaMemory();
+
+    m_startup_times.emplace_back("Total", amrex::second() - strt_init);
+    PrintStartupTimes();
+
     PerformanceHints();
 }
 
+void
+WarpX::PrintStartupTimes () const
+{
+    if (verbose == 0 || m_startup_times.empty()) return;
+
+    const int n = static_cast<int>(m_startup_times.size());
+    Vector<Real> times(n);
+    for (int i = 0; i < n; ++i) times[i] = m_startup_times[i].second;
+    ParallelDescriptor::ReduceRealMax(times.data(), n, ParallelDescriptor::IOProcessorNumber());
+
+    Print() << "\nInitialization times (max over MPI ranks):\n";
+    for (int i = 0; i < n; ++i) {
+        Print() << "  " << std::left << std::setw(34) << m_startup_times[i].first
+                << std::right << std::setw(12) << times[i] << " s\n";
+    }
+    Print() << "\n";
+}
+
 void
 WarpX::InitDiagnostics () {
     multi_diags->InitData();
@@ -207,11 +283,18 @@ WarpX::InitFromScratch ()
 {
     const Real time = 0.0;
 
-    AmrCore::InitFromScratch(time);  // This will call MakeNewLevelFromScratch
+    {
+        StartupPhaseTimer timer(m_startup_times, "Levels (fields, EB, field solvers)");
+        AmrCore::InitFromScratch(time);  // This will call MakeNewLevelFromScratch
+    }
 
-    mypc->AllocData();
-    mypc->InitData();
+    {
+        StartupPhaseTimer timer(m_startup_times, "Particles (injection, QED tables)");
+        mypc->AllocData();
+        mypc->InitData();
+    }
 
+    StartupPhaseTimer timer(m_startup_times, "PML");
     InitPML();
 }
 
@@ -239,7 +322,7 @@ WarpX::InitPML ()
 #endif
         pml[0] = std::make_unique<PML>(0, boxArray(0), DistributionMap(0), &Geom(0), nullptr,
                              pml_ncell, pml_delta, amrex::IntVect::TheZeroVector(),
-                             dt[0], nox_fft, noy_fft, noz_fft, do_nodal,
+                             dt[0], pml_nox_fft, pml_noy_fft, pml_noz_fft, do_nodal,
                              do_moving_window, pml_has_particles, do_pml_in_domain,
                              J_linear_in_time, do_pml_dive_cleaning, do_pml_divb_cleaning,
                              do_pml_Lo_corrected, do_pml_Hi);
@@ -267,7 +350,7 @@ WarpX::InitPML ()
             pml[lev] = std::make_unique<PML>(lev, boxArray(lev), DistributionMap(lev),
                                    &Geom(lev), &Geom(lev-1),
                                    pml_ncell, pml_delta, refRatio(lev-1),
-                                   dt[lev], nox_fft, noy_fft, noz_fft, do_nodal,
+                                   dt[lev], pml_nox_fft, pml_noy_fft, pml_noz_fft, do_nodal,
                                    do_moving_window, pml_has_particles, do_pml_in_domain,
                                    J_linear_in_time, do_pml_dive_cleaning, do_pml_divb_cleaning,
                                    do_pml_Lo_MR, do_pml_Hi_MR);
@@ -391,6 +474,8 @@ void
 WarpX::InitFilter (){
     if (WarpX::use_filter){
         WarpX::bilinear_filter.npass_each_dir = WarpX::filter_npass_each_dir.toArray<unsigned int>();
+        WarpX::bilinear_filter.compensation = WarpX::use_filter_compensation;
+        WarpX::bilinear_filter.use_spectral = WarpX::use_spectral_filter;
         WarpX::bilinear_filter.ComputeStencils();
     }
 }
@@ -488,11 +573,15 @@ WarpX::InitLevelData (int lev, Real /*time*/)
     if(lev==maxLevel()) {
         if (WarpX::maxwell_solver_id == MaxwellSolverAlgo::Yee
             || WarpX::maxwell_solver_id == MaxwellSolverAlgo::ECT) {
-            ComputeEdgeLengths();
-            ComputeFaceAreas();
-            ScaleEdges();
-            ScaleAreas();
-            ComputeDistanceToEB();
+            if (!ReadEBCache()) {
+                ComputeEdgeLengths();
+                ComputeFaceAreas();
+                ScaleEdges();
+                ScaleAreas();
+                ComputeDistanceToEB();
+                WriteEBCache();
+            }
+            ComputeEBTileClasses();
 
             const auto &period = Geom(lev).periodicity();
             WarpXCommUtil::FillBoundary(*m_edge_lengths[lev][0], guard_cells.ng_alloc_EB, period);
@@ -622,6 +711,37 @@ WarpX::InitLevelData (int lev, Real /*time*/)
        }
     }
 
+    // if the input string for the E- or B-field is "read_from_file", the field is read
+    // from the openPMD file warpx.read_fields_from_path
+    if (B_ext_grid_s == "read_from_file" || E_ext_grid_s == "read_from_file") {
+        std::string read_fields_from_path;
+        pp_warpx.get("read_fields_from_path", read_fields_from_path);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!do_moving_window,
+            "The external fields read from a file cannot be used with the moving window");
+        const amrex::Geometry geom_cp = (lev > 0) ? amrex::coarsen(geom[lev], refRatio(lev-1))
+                                                  : geom[lev];
+        if (B_ext_grid_s == "read_from_file") {
+            ReadExternalFieldFromFile(read_fields_from_path, "B", Bfield_fp[lev][0].get(),
+                Bfield_fp[lev][1].get(), Bfield_fp[lev][2].get(), geom[lev], m_face_areas[lev]);
+            if (lev > 0) {
+                ReadExternalFieldFromFile(read_fields_from_path, "B", Bfield_aux[lev][0].get(),
+                    Bfield_aux[lev][1].get(), Bfield_aux[lev][2].get(), geom[lev], m_face_areas[lev]);
+                ReadExternalFieldFromFile(read_fields_from_path, "B", Bfield_cp[lev][0].get(),
+                    Bfield_cp[lev][1].get(), Bfield_cp[lev][2].get(), geom_cp, m_face_areas[lev]);
+            }
+        }
+        if (E_ext_grid_s == "read_from_file") {
+            ReadExternalFieldFromFile(read_fields_from_path, "E", Efield_fp[lev][0].get(),
+                Efield_fp[lev][1].get(), Efield_fp[lev][2].get(), geom[lev], m_edge_lengths[lev]);
+            if (lev > 0) {
+                ReadExternalFieldFromFile(read_fields_from_path, "E", Efield_aux[lev][0].get(),
+                    Efield_aux[lev][1].get(), Efield_aux[lev][2].get(), geom[lev], m_edge_lengths[lev]);
+                ReadExternalFieldFromFile(read_fields_from_path, "E", Efield_cp[lev][0].get(),
+                    Efield_cp[lev][1].get(), Efield_cp[lev][2].get(), geom_cp, m_edge_lengths[lev]);
+            }
+        }
+    }
+
     if (F_fp[lev]) {
         F_fp[lev]->setVal(0.0);
     }
@@ -669,6 +789,10 @@ WarpX::InitializeExternalFieldsOnGridUsingParser (
     amrex::IntVect x_nodal_flag = mfx->ixType().toIntVect();
     amrex::IntVect y_nodal_flag = mfy->ixType().toIntVect();
     amrex::IntVect z_nodal_flag = mfz->ixType().toIntVect();
+    // The parsers are evaluated independently on each tile
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
     for ( MFIter mfi(*mfx, TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
        const amrex::Box& tbx = mfi.tilebox( x_nodal_flag, mfx->nGrowVect() );
@@ -17,6 +17,7 @@
 #include <AMReX_ParmParse.H>
 #include <AMReX_REAL.H>
 
+#include <limits>
 #include <memory>
 #include <set>
 #include <string>
@@ -50,6 +51,65 @@ WarpXLaserProfiles::FieldFunctionLaserProfile::init (
     for (auto const& s : symbols) { // make sure there no unknown symbols
         amrex::Abort("Laser Profile: Unknown symbol "+s);
     }
+
+    // Optional tabulation of the field function
+    ppl.query("field_function_tabulate", m_params.tabulate);
+    if (m_params.tabulate) {
+        getWithParser(ppl, "field_function_table_x_min", m_params.x_min);
+        getWithParser(ppl, "field_function_table_x_max", m_params.x_max);
+        getWithParser(ppl, "field_function_table_nx", m_params.nx);
+#if ((AMREX_SPACEDIM == 3) || (defined WARPX_DIM_RZ))
+        getWithParser(ppl, "field_function_table_y_min", m_params.y_min);
+        getWithParser(ppl, "field_function_table_y_max", m_params.y_max);
+        getWithParser(ppl, "field_function_table_ny", m_params.ny);
+        if (m_params.ny < 2) amrex::Abort("field_function_table_ny must be >= 2");
+#endif
+        getWithParser(ppl, "field_function_table_dt", m_params.dt);
+        getWithParser(ppl, "field_function_table_nt", m_params.nt);
+        if (m_params.nx < 2) amrex::Abort("field_function_table_nx must be >= 2");
+        if (m_params.nt < 2) amrex::Abort("field_function_table_nt must be >= 2");
+        if (m_params.dt <= 0.) amrex::Abort("field_function_table_dt must be positive");
+        m_params.table.resize(m_params.nx*m_params.ny*m_params.nt);
+    }
+}
+
+void
+WarpXLaserProfiles::FieldFunctionLaserProfile::update (amrex::Real /*t*/)
+{
+    if (!m_params.tabulate) return;
+    // The time passed to fill_amplitude may differ from t (in a boosted frame):
+    // the time of the next request is predicted from the last ones.
+    const Real t_last = m_params.t_last_request;
+    if (t_last == std::numeric_limits<Real>::lowest()) return;
+    const Real t_next = (m_params.t_prev_request == std::numeric_limits<Real>::lowest()) ?
+        t_last : 2._rt*t_last - m_params.t_prev_request;
+    const Real t_end = m_params.t_first + (m_params.nt-1)*m_params.dt;
+    if (t_next < m_params.t_first || t_next > t_end) {
+        internal_fill_table(amrex::min(t_last, t_next));
+    }
+}
+
+void
+WarpXLaserProfiles::FieldFunctionLaserProfile::internal_fill_table (amrex::Real t_first)
+{
+    m_params.t_first = t_first;
+    auto parser = m_parser.compile<3>();
+    const int nx = m_params.nx;
+    const int ny = m_params.ny;
+    const Real x_min = m_params.x_min;
+    const Real y_min = m_params.y_min;
+    const Real dx = (m_params.x_max - m_params.x_min)/(nx-1);
+    const Real dy = (ny > 1) ? (m_params.y_max - m_params.y_min)/(ny-1) : 0._rt;
+    const Real dt = m_params.dt;
+    Real* AMREX_RESTRICT table = m_params.table.dataPtr();
+    amrex::ParallelFor(nx*ny*m_params.nt, [=] AMREX_GPU_DEVICE (int n) noexcept
+    {
+        const int ix = n % nx;
+        const int iy = (n / nx) % ny;
+        const int it = n / (nx*ny);
+        table[n] = parser(x_min + ix*dx, y_min + iy*dy, t_first + it*dt);
+    });
+    Gpu::synchronize();
 }
 
 void
@@ -57,9 +117,74 @@ WarpXLaserProfiles::FieldFunctionLaserProfile::fill_amplitude (
     const int np, Real const * AMREX_RESTRICT const Xp, Real const * AMREX_RESTRICT const Yp,
     Real t, Real * AMREX_RESTRICT const amplitude) const
 {
+    if (m_params.tabulate) {
+        if (t != m_params.t_last_request) {
+            m_params.t_prev_request = m_params.t_last_request;
+            m_params.t_last_request = t;
+        }
+        const Real t_end = m_params.t_first + (m_params.nt-1)*m_params.dt;
+        if (t >= m_params.t_first && t <= t_end) {
+            internal_fill_amplitude_tabulated(np, Xp, Yp, t, amplitude);
+            return;
+        }
+        // Outside of the time chunk of the table (e.g. before the first update),
+        // the field function is evaluated directly
+    }
+
     auto parser = m_parser.compile<3>();
     amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (int i) noexcept
     {
         amplitude[i] = parser(Xp[i], Yp[i], t);
     });
 }
+
+void
+WarpXLaserProfiles::FieldFunctionLaserProfile::internal_fill_amplitude_tabulated (
+    const int np, Real const * AMREX_RESTRICT const Xp, Real const * AMREX_RESTRICT const Yp,
+    Real t, Real * AMREX_RESTRICT const amplitude) const
+{
+    const int nx = m_params.nx;
+    const int ny = m_params.ny;
+    const int nt = m_params.nt;
+    const Real x_min = m_params.x_min;
+    const Real x_max = m_params.x_max;
+    const Real dx = (m_params.x_max - m_params.x_min)/(nx-1);
+#if ((AMREX_SPACEDIM == 3) || (defined WARPX_DIM_RZ))
+    const Real y_min = m_params.y_min;
+    const Real y_max = m_params.y_max;
+    const Real dy = (m_params.y_max - m_params.y_min)/(ny-1);
+#endif
+    // Linear interpolation in time, between the timesteps it and it+1
+    const Real st = (t - m_params.t_first)/m_params.dt;
+    const int it = amrex::min(static_cast<int>(st), nt-2);
+    const Real wt = st - it;
+    Real const* AMREX_RESTRICT table = m_params.table.dataPtr();
+    amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (int i) noexcept
+    {
+        // The field is 0 outside of the table
+        if (Xp[i] < x_min || Xp[i] > x_max) { amplitude[i] = 0._rt; return; }
+        const Real sx = (Xp[i] - x_min)/dx;
+        const int ix = amrex::min(static_cast<int>(sx), nx-2);
+        const Real wx = sx - ix;
+#if ((AMREX_SPACEDIM == 3) || (defined WARPX_DIM_RZ))
+        if (Yp[i] < y_min || Yp[i] > y_max) { amplitude[i] = 0._rt; return; }
+        const Real sy = (Yp[i] - y_min)/dy;
+        const int iy = amrex::min(static_cast<int>(sy), ny-2);
+        const Real wy = sy - iy;
+#else
+        amrex::ignore_unused(Yp);
+        const int iy = 0;
+        const Real wy = 0._rt;
+#endif
+        Real val = 0._rt;
+        for (int jt = 0; jt < 2; ++jt) {
+            const Real ft = jt ? wt : 1._rt - wt;
+            for (int jy = 0; jy < ((ny > 1) ? 2 : 1); ++jy) {
+                const Real fy = (ny > 1) ? (jy ? wy : 1._rt - wy) : 1._rt;
+                const Real* row = table + ((it+jt)*ny + iy+jy)*nx + ix;
+                val += ft*fy*((1._rt - wx)*row[0] + wx*row[1]);
+            }
+        }
+        amplitude[i] = val;
+    });
+}
@@ -29,6 +29,7 @@
 #include <cmath>
 #include <cstdint>
 #include <fstream>
+#include <future>
 #include <iterator>
 #include <limits>
 #include <string>
@@ -38,6 +39,42 @@
 
 using namespace amrex;
 
+namespace
+{
+    /** \brief Read the field data of the timesteps [i_first, i_last] from a txye file
+    *
+    * \param file_name: name of the txye file
+    * \param header_size: size in bytes of the header (flag, sizes and coordinates)
+    * \param slice_size: number of points of one timestep (nx*ny)
+    * \param i_first: first timestep to read
+    * \param i_last: last timestep to read
+    * \param buf_size: size of the returned buffer (at least the size of the data)
+    * \return the data converted to amrex::Real, or an empty buffer if the read failed
+    */
+    Vector<Real> read_txye_field_data (
+        const std::string& file_name, std::size_t header_size, std::size_t slice_size,
+        int i_first, int i_last, std::size_t buf_size)
+    {
+        Vector<Real> h_E_data(buf_size);
+        std::ifstream inp(file_name, std::ios::binary);
+        if(!inp) return Vector<Real>();
+        inp.seekg(header_size + sizeof(double)*i_first*slice_size);
+        if(!inp) return Vector<Real>();
+        const std::size_t read_size = (i_last - i_first + 1)*slice_size;
+        Vector<double> buf_e(read_size);
+        inp.read(reinterpret_cast<char*>(buf_e.dataPtr()), read_size*sizeof(double));
+        if(!inp) return Vector<Real>();
+        std::transform(buf_e.begin(), buf_e.end(), h_E_data.begin(),
+            [](auto x) {return static_cast<amrex::Real>(x);} );
+        return h_E_data;
+    }
+}
+
+WarpXLaserProfiles::FromTXYEFileLaserProfile::~FromTXYEFileLaserProfile ()
+{
+    if (m_params.prefetch_first >= 0) wait_prefetch();
+}
+
 void
 WarpXLaserProfiles::FromTXYEFileLaserProfile::init (
     const amrex::ParmParse& ppl,
@@ -74,6 +111,9 @@ WarpXLaserProfiles::FromTXYEFileLaserProfile::init (
     //Reads the (optional) delay
     queryWithParser(ppl, "delay", m_params.t_delay);
 
+    //Whether the next time chunk is read in the background
+    ppl.query("prefetch_time_chunks", m_params.do_prefetch);
+
     //Allocate memory for E_data Vector
     const int data_size = m_params.time_chunk_size*
             m_params.nx*m_params.ny;
@@ -94,6 +134,11 @@ WarpXLaserProfiles::FromTXYEFileLaserProfile::update (amrex::Real t)
     if(t >= m_params.t_coords.back())
         return;
 
+    //Broadcast the next data chunck in the background, once it has been read
+    if(m_params.prefetch_first >= 0 && !m_params.prefetch_posted){
+        post_prefetch_broadcast();
+    }
+
     const auto idx_times = find_left_right_time_indices(t);
     const auto idx_t_left = idx_times.first;
     const auto idx_t_right = idx_times.second;
@@ -104,6 +149,12 @@ WarpXLaserProfiles::FromTXYEFileLaserProfile::update (amrex::Real t)
     }
 }
 
+Real
+WarpXLaserProfiles::FromTXYEFileLaserProfile::emission_end_time (Real /*threshold*/) const
+{
+    return m_params.t_coords.back() + m_params.t_delay;
+}
+
 void
 WarpXLaserProfiles::FromTXYEFileLaserProfile::fill_amplitude (
     const int np,
@@ -285,32 +336,37 @@ WarpXLaserProfiles::FromTXYEFileLaserProfile::read_data_t_chuck(int t_begin, int
     if(i_last-i_first+1 > static_cast<int>(m_params.E_data.size()))
         Abort("Data chunk to read from file is too large");
 
-    Vector<Real> h_E_data(m_params.E_data.size());
+    Vector<Real> h_E_data;
 
-    if(ParallelDescriptor::IOProcessor()){
-        //Read data chunk
-        std::ifstream inp(m_params.txye_file_name, std::ios::binary);
-        if(!inp) Abort("Failed to open txye file");
-        auto skip_amount = 1 +
-            3*sizeof(uint32_t) +
-            m_params.t_coords.size()*sizeof(double) +
-            m_params.h_x_coords.size()*sizeof(double) +
-            m_params.h_y_coords.size()*sizeof(double) +
-            sizeof(double)*t_begin*m_params.nx*m_params.ny;
-        inp.seekg(skip_amount);
-        if(!inp) Abort("Failed to read field data from txye file");
-        const int read_size = (i_last - i_first + 1)*
-            m_params.nx*m_params.ny;
-        Vector<double> buf_e(read_size);
-        inp.read(reinterpret_cast<char*>(buf_e.dataPtr()), read_size*sizeof(double));
-        if(!inp) Abort("Failed to read field data from txye file");
-        std::transform(buf_e.begin(), buf_e.end(), h_E_data.begin(),
-            [](auto x) {return static_cast<amrex::Real>(x);} );
+    const bool use_prefetch = (m_params.prefetch_first == i_first) &&
+        (m_params.prefetch_last == i_last);
+    if(m_params.prefetch_first >= 0){
+        //Complete the prefetch (it is discarded if it is not the requested chunk)
+        wait_prefetch();
+        if(use_prefetch) h_E_data = std::move(m_params.h_prefetch_data);
+        m_params.h_prefetch_data.clear();
     }
 
-    //Broadcast E_data
-    ParallelDescriptor::Bcast(h_E_data.dataPtr(),
-        h_E_data.size(), ParallelDescriptor::IOProcessorNumber());
+    if(!use_prefetch){
+        if(ParallelDescriptor::IOProcessor()){
+            //Read data chunk
+            const auto skip_amount = 1 +
+                3*sizeof(uint32_t) +
+                m_params.t_coords.size()*sizeof(double) +
+                m_params.h_x_coords.size()*sizeof(double) +
+                m_params.h_y_coords.size()*sizeof(double);
+            h_E_data = read_txye_field_data(m_params.txye_file_name, skip_amount,
+                m_params.nx*m_params.ny, i_first, i_last, m_params.E_data.size());
+            if(h_E_data.empty()) Abort("Failed to read field data from txye file");
+        }
+        else{
+            h_E_data.resize(m_params.E_data.size());
+        }
+
+        //Broadcast E_data
+        ParallelDescriptor::Bcast(h_E_data.dataPtr(),
+            h_E_data.size(), ParallelDescriptor::IOProcessorNumber());
+    }
 
     Gpu::copyAsync(Gpu::hostToDevice,h_E_data.begin(),h_E_data.end(),m_params.E_data.begin());
     Gpu::synchronize();
@@ -318,6 +374,62 @@ WarpXLaserProfiles::FromTXYEFileLaserProfile::read_data_t_chuck(int t_begin, int
     //Update first and last indices
     m_params.first_time_index = i_first;
     m_params.last_time_index = i_last;
+
+    //Start reading the next data chunk, that begins with the last timestep in memory
+    if(m_params.do_prefetch && i_last < m_params.nt-1){
+        start_prefetch();
+    }
+}
+
+void
+WarpXLaserProfiles::FromTXYEFileLaserProfile::start_prefetch()
+{
+    m_params.prefetch_first = m_params.last_time_index;
+    m_params.prefetch_last = min(m_params.last_time_index + m_params.time_chunk_size - 1,
+        m_params.nt - 1);
+    m_params.prefetch_posted = false;
+
+    if(ParallelDescriptor::IOProcessor()){
+        const auto skip_amount = 1 +
+            3*sizeof(uint32_t) +
+            m_params.t_coords.size()*sizeof(double) +
+            m_params.h_x_coords.size()*sizeof(double) +
+            m_params.h_y_coords.size()*sizeof(double);
+        m_params.prefetch_future = std::async(std::launch::async, read_txye_field_data,
+            m_params.txye_file_name, skip_amount, static_cast<std::size_t>(m_params.nx*m_params.ny),
+            m_params.prefetch_first, m_params.prefetch_last, m_params.E_data.size());
+    }
+}
+
+void
+WarpXLaserProfiles::FromTXYEFileLaserProfile::post_prefetch_broadcast()
+{
+    if(ParallelDescriptor::IOProcessor()){
+        m_params.h_prefetch_data = m_params.prefetch_future.get();
+        if(m_params.h_prefetch_data.empty()) Abort("Failed to read field data from txye file");
+    }
+    else{
+        m_params.h_prefetch_data.resize(m_params.E_data.size());
+    }
+#ifdef AMREX_USE_MPI
+    MPI_Ibcast(m_params.h_prefetch_data.dataPtr(), static_cast<int>(m_params.h_prefetch_data.size()),
+        ParallelDescriptor::Mpi_typemap<Real>::type(),
+        ParallelDescriptor::IOProcessorNumber(), ParallelDescriptor::Communicator(),
+        &m_params.prefetch_request);
+#endif
+    m_params.prefetch_posted = true;
+}
+
+void
+WarpXLaserProfiles::FromTXYEFileLaserProfile::wait_prefetch()
+{
+    if(!m_params.prefetch_posted) post_prefetch_broadcast();
+#ifdef AMREX_USE_MPI
+    MPI_Wait(&m_params.prefetch_request, MPI_STATUS_IGNORE);
+#endif
+    m_params.prefetch_first = -1;
+    m_params.prefetch_last = -1;
+    m_params.prefetch_posted = false;
 }
 
 void
@@ -23,6 +23,7 @@
 
 #include <cmath>
 #include <cstdlib>
+#include <limits>
 #include <numeric>
 #include <vector>
 
@@ -156,3 +157,17 @@ WarpXLaserProfiles::GaussianLaserProfile::fill_amplitude (
         }
         );
 }
+
+Real
+WarpXLaserProfiles::GaussianLaserProfile::emission_end_time (Real threshold) const
+{
+    // With spatio-temporal couplings, the time of emission depends on the position
+    if (m_params.zeta != 0._rt || m_params.beta != 0._rt) {
+        return std::numeric_limits<Real>::infinity();
+    }
+    // The amplitude is bounded by e_max*exp(-(t-t_peak)^2/tau^2), where tau is the
+    // duration stretched by phi2 (the transverse and diffraction factors are at most 1)
+    const Real a = 2._rt*m_params.phi2/(m_params.duration*m_params.duration);
+    const Real tau = m_params.duration*std::sqrt(1._rt + a*a);
+    return m_params.t_peak + tau*std::sqrt(-std::log(threshold));
+}
@@ -90,3 +90,10 @@ WarpXLaserProfiles::HarrisLaserProfile::fill_amplitude (
         }
         );
 }
+
+Real
+WarpXLaserProfiles::HarrisLaserProfile::emission_end_time (Real /*threshold*/) const
+{
+    // The Harris time envelope is 0 after the duration
+    return m_params.duration;
+}
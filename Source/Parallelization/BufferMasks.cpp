@@ -0,0 +1,78 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "BufferMasks.H"
+
+#include <AMReX_BoxList.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Periodicity.H>
+#include <AMReX_Vector.H>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace amrex;
+
+void
+BufferMasks::define (const BoxArray& ba, const DistributionMapping& dm,
+                     const Geometry& geom, int ngbuffer)
+{
+    const Periodicity& period = geom.periodicity();
+    const bool same_grids = (ba == m_ba) && (geom.Domain() == m_domain)
+        && (period.intVect() == m_period) && (ngbuffer == m_ngbuffer);
+    if (same_grids && dm == m_dm) return;
+
+    // Keep the lists of the boxes that stay on this rank, if only the mapping changed
+    std::map<int, Gpu::DeviceVector<Box> > kept;
+    if (same_grids) {
+        for (int i : m_buffer_boxes.IndexArray()) {
+            if (dm[i] == ParallelDescriptor::MyProc()) kept[i] = std::move(m_buffer_boxes[i]);
+        }
+    }
+
+    m_ba = ba;
+    m_dm = dm;
+    m_domain = geom.Domain();
+    m_period = period.intVect();
+    m_ngbuffer = ngbuffer;
+    m_buffer_boxes.define(ba, dm);
+
+    const std::vector<IntVect> shifts = period.shiftIntVect();
+    for (int i : m_buffer_boxes.IndexArray())
+    {
+        auto it = kept.find(i);
+        if (it != kept.end()) {
+            m_buffer_boxes[i] = std::move(it->second);
+            continue;
+        }
+
+        // Cells within ngbuffer+1 cells of the box that are not covered by the level
+        // (the cells outside of the domain are covered, except for their periodic images)
+        const Box& bx = ba[i];
+        const Box region = amrex::grow(bx, ngbuffer+1);
+        const Box mask_box = amrex::grow(bx, 1);
+        std::vector<Box> buffer_boxes;
+        for (const IntVect& s : shifts)
+        {
+            const Box r = region & amrex::shift(m_domain, s);
+            if (!r.ok()) continue;
+            const BoxList uncovered = ba.complementIn(amrex::shift(r, -s));
+            for (Box ub : uncovered) {
+                ub.shift(s);
+                // The buffer cells are within ngbuffer cells of the uncovered cells
+                const Box b = amrex::grow(ub, ngbuffer) & mask_box;
+                if (b.ok()) buffer_boxes.push_back(b);
+            }
+        }
+
+        auto& d_boxes = m_buffer_boxes[i];
+        d_boxes.resize(buffer_boxes.size());
+        Gpu::copyAsync(Gpu::hostToDevice, buffer_boxes.begin(), buffer_boxes.end(), d_boxes.begin());
+    }
+    Gpu::streamSynchronize();
+}
@@ -19,16 +19,36 @@
 #include "Utils/WarpXConst.H"
 #include "Utils/WarpXUtil.H"
 
+#include <AMReX_BoxArray.H>
 #include <AMReX_Config.H>
 #include <AMReX_INT.H>
 #include <AMReX_Math.H>
 #include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
 #include <AMReX_SPACE.H>
 
 #include <algorithm>
+#include <iomanip>
+#include <string>
+#include <vector>
 
 using namespace amrex;
 
+namespace
+{
+    /** Optionally override the number of guard cells ng exchanged in a phase of the
+     *  PIC loop with the runtime parameter warpx.<name>, which cannot exceed ng_alloc */
+    void QueryGuardCells (ParmParse const& pp, char const* name, IntVect& ng, IntVect const& ng_alloc)
+    {
+        std::vector<int> ng_in;
+        if (queryArrWithParser(pp, name, ng_in, 0, AMREX_SPACEDIM)) {
+            for (int i = 0; i < AMREX_SPACEDIM; i++) ng[i] = ng_in[i];
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ng.allLE(ng_alloc),
+                std::string("warpx.") + name + " cannot exceed the number of guard cells allocated");
+        }
+    }
+}
+
 void
 guardCellManager::Init (
     const amrex::Real dt,
@@ -46,9 +66,11 @@ guardCellManager::Init (
     const amrex::Vector<amrex::Real> v_galilean,
     const amrex::Vector<amrex::Real> v_comoving,
     const bool safe_guard_cells,
+    const bool fdtd_temporal_blocking,
     const int do_electrostatic,
     const int do_multi_J,
     const bool fft_do_time_averaging,
+    const bool fft_distributed,
     const amrex::Vector<amrex::IntVect>& ref_ratios)
 {
     // When using subcycling, the particles on the fine level perform two pushes
@@ -69,6 +91,15 @@ guardCellManager::Init (
       ngz_tmp += 1;
     }
 
+    // The particles staged by a bounded Redistribute stay in the guard
+    // cells of their box (see particles.redistribute_staging_cells)
+    int staging_cells = 0;
+    ParmParse pp_particles("particles");
+    pp_particles.query("redistribute_staging_cells", staging_cells);
+    ngx_tmp += staging_cells;
+    ngy_tmp += staging_cells;
+    ngz_tmp += staging_cells;
+
     // Ex, Ey, Ez, Bx, By, and Bz have the same number of ghost cells.
     // jx, jy, jz and rho have the same number of ghost cells.
     // E and B have the same number of ghost cells as j and rho if NCI filter is not used,
@@ -186,6 +217,14 @@ guardCellManager::Init (
         int ngFFt_y = do_nodal ? noy_fft : noy_fft / 2;
         int ngFFt_z = (do_nodal || galilean) ? noz_fft : noz_fft / 2;
 
+        // The distributed FFTs are performed over the whole domain:
+        // no guard cells are needed for the stencil of the solver
+        if (fft_distributed) {
+            ngFFt_x = 0;
+            ngFFt_y = 0;
+            ngFFt_z = 0;
+        }
+
         ParmParse pp_psatd("psatd");
         queryWithParser(pp_psatd, "nx_guard", ngFFt_x);
         queryWithParser(pp_psatd, "ny_guard", ngFFt_y);
@@ -246,6 +285,11 @@ guardCellManager::Init (
             ng_FieldSolverF = CartesianCKCAlgorithm::GetMaxGuardCell();
             ng_FieldSolverG = CartesianCKCAlgorithm::GetMaxGuardCell();
         }
+        // With temporal blocking, the update of B, E and B over one time step,
+        // box by box, reads E up to 3 cells outside of the box
+        if (fdtd_temporal_blocking) {
+            ng_FieldSolver.max( IntVect(AMREX_D_DECL(3,3,3)) );
+        }
     }
 #endif
 
@@ -274,7 +318,8 @@ guardCellManager::Init (
     } else {
         // Compute number of cells required for Field Gather
         int FGcell[4] = {0,1,1,2}; // Index is nox
-        IntVect ng_FieldGather_noNCI = IntVect(AMREX_D_DECL(FGcell[nox],FGcell[nox],FGcell[nox]));
+        IntVect ng_FieldGather_noNCI = IntVect(AMREX_D_DECL(FGcell[nox],FGcell[nox],FGcell[nox]))
+                                       + staging_cells;
         ng_FieldGather_noNCI = ng_FieldGather_noNCI.min(ng_alloc_EB);
         // If NCI filter, add guard cells in the z direction
         IntVect ng_NCIFilter = IntVect::TheZeroVector();
@@ -300,4 +345,54 @@ guardCellManager::Init (
             ng_MovingWindow[moving_window_dir] = 1;
         }
     }
+
+    // User overrides of the number of guard cells exchanged in each phase,
+    // e.g. to only exchange what the next operator actually reads
+    ParmParse pp_warpx("warpx");
+    QueryGuardCells(pp_warpx, "ng_field_solver", ng_FieldSolver, ng_alloc_EB);
+    QueryGuardCells(pp_warpx, "ng_field_solver_F", ng_FieldSolverF, ng_alloc_F);
+    QueryGuardCells(pp_warpx, "ng_field_solver_G", ng_FieldSolverG, ng_alloc_G);
+    QueryGuardCells(pp_warpx, "ng_field_gather", ng_FieldGather, ng_alloc_EB);
+    QueryGuardCells(pp_warpx, "ng_update_aux", ng_UpdateAux, ng_alloc_EB);
+    QueryGuardCells(pp_warpx, "ng_after_push_psatd", ng_afterPushPSATD, ng_alloc_EB);
+}
+
+void
+guardCellManager::PrintGuardCellVolumes (const amrex::BoxArray& ba) const
+{
+    // Number of guard cells of each box, summed over all boxes
+    auto guard_volume = [&ba] (IntVect const& ng) {
+        Long volume = 0;
+        for (int i = 0; i < static_cast<int>(ba.size()); ++i) {
+            volume += amrex::grow(ba[i], ng).numPts() - ba[i].numPts();
+        }
+        return volume;
+    };
+    const Long valid_volume = ba.numPts();
+
+    struct GuardCellPhase { const char* name; IntVect ng; };
+    const GuardCellPhase phases[] = {
+        {"Allocated E, B", ng_alloc_EB},
+        {"Allocated J", ng_alloc_J},
+        {"Allocated rho", ng_alloc_Rho},
+        {"Allocated F", ng_alloc_F},
+        {"Allocated G", ng_alloc_G},
+        {"Field solver (E, B)", ng_FieldSolver},
+        {"Field solver (F)", ng_FieldSolverF},
+        {"Field solver (G)", ng_FieldSolverG},
+        {"Field gather (E, B)", ng_FieldGather},
+        {"Update aux (E, B)", ng_UpdateAux},
+        {"After PSATD push (E, B)", ng_afterPushPSATD},
+        {"Moving window", ng_MovingWindow}};
+
+    amrex::Print() << "\nGuard cells (level 0, per field component, summed over "
+                   << ba.size() << " boxes of " << valid_volume << " valid cells):\n";
+    for (auto const& phase : phases) {
+        const Long volume = guard_volume(phase.ng);
+        amrex::Print() << "  " << std::left << std::setw(26) << phase.name
+                       << std::setw(14) << phase.ng << std::right << std::setw(14) << volume
+                       << "  (" << std::setprecision(3)
+                       << (valid_volume > 0 ? 100.*volume/valid_volume : 0.) << "% of valid)\n";
+    }
+    amrex::Print() << "\n";
 }
@@ -25,6 +25,7 @@
 #include <AMReX_Box.H>
 #include <AMReX_BoxArray.H>
 #include <AMReX_Config.H>
+#include <AMReX_DistributionMapping.H>
 #include <AMReX_FabArrayBase.H>
 #include <AMReX_Geometry.H>
 #include <AMReX_GpuContainers.H>
@@ -35,6 +36,7 @@
 #include <AMReX_MFIter.H>
 #include <AMReX_MakeType.H>
 #include <AMReX_MultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
 #include <AMReX_REAL.H>
 #include <AMReX_Vector.H>
 
@@ -45,6 +47,28 @@
 
 using namespace amrex;
 
+namespace
+{
+    /** \brief Temporary MultiFab on ba and dm with ncomp components and ng guard cells,
+     *  kept in buf across the calls (and only reallocated when the layout changes) */
+    MultiFab& getPersistentBuffer (std::unique_ptr<MultiFab>& buf, const BoxArray& ba,
+                                   const DistributionMapping& dm, int ncomp, const IntVect& ng)
+    {
+        if (!buf || buf->boxArray() != ba || buf->DistributionMap() != dm ||
+            buf->nComp() != ncomp || buf->nGrowVect() != ng) {
+            buf = std::make_unique<MultiFab>(ba, dm, ncomp, ng);
+        }
+        return *buf;
+    }
+
+    /** \brief Temporary MultiFab with the layout of mf and ng guard cells, kept in buf
+     *  across the calls (and only reallocated when the layout changes) */
+    MultiFab& getPersistentBuffer (std::unique_ptr<MultiFab>& buf, const MultiFab& mf, const IntVect& ng)
+    {
+        return getPersistentBuffer(buf, mf.boxArray(), mf.DistributionMap(), mf.nComp(), ng);
+    }
+}
+
 void
 WarpX::UpdateAuxilaryData ()
 {
@@ -60,6 +84,7 @@ WarpX::UpdateAuxilaryData ()
 void
 WarpX::UpdateAuxilaryDataStagToNodal ()
 {
+    WarpXCommUtil::CommSite comm_site("UpdateAuxilaryData");
 #ifndef WARPX_USE_PSATD
     if (maxwell_solver_id == MaxwellSolverAlgo::PSATD) {
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE( false,
@@ -167,16 +192,19 @@ WarpX::UpdateAuxilaryDataStagToNodal ()
 
         // Bfield
         {
-            Array<std::unique_ptr<MultiFab>,3> Btmp;
+            Array<std::unique_ptr<MultiFab>,3> Btmp_alias;
+            Array<MultiFab*,3> Btmp;
             if (Bfield_cax[lev][0]) {
                 for (int i = 0; i < 3; ++i) {
-                    Btmp[i] = std::make_unique<MultiFab>(
+                    Btmp_alias[i] = std::make_unique<MultiFab>(
                         *Bfield_cax[lev][i], amrex::make_alias, 0, 1);
+                    Btmp[i] = Btmp_alias[i].get();
                 }
             } else {
+                // Kept across the calls, and only reallocated when the grids change
                 IntVect ngtmp = Bfield_aux[lev-1][0]->nGrowVect();
                 for (int i = 0; i < 3; ++i) {
-                    Btmp[i] = std::make_unique<MultiFab>(cnba, dm, 1, ngtmp);
+                    Btmp[i] = &getPersistentBuffer(Bfield_aux_tmp[lev][i], cnba, dm, 1, ngtmp);
                 }
             }
             Btmp[0]->setVal(0.0);
@@ -223,17 +251,19 @@ WarpX::UpdateAuxilaryDataStagToNodal ()
 
         // Efield
         {
-            Array<std::unique_ptr<MultiFab>,3> Etmp;
+            Array<std::unique_ptr<MultiFab>,3> Etmp_alias;
+            Array<MultiFab*,3> Etmp;
             if (Efield_cax[lev][0]) {
                 for (int i = 0; i < 3; ++i) {
-                    Etmp[i] = std::make_unique<MultiFab>(
+                    Etmp_alias[i] = std::make_unique<MultiFab>(
                         *Efield_cax[lev][i], amrex::make_alias, 0, 1);
+                    Etmp[i] = Etmp_alias[i].get();
                 }
             } else {
+                // Kept across the calls, and only reallocated when the grids change
                 IntVect ngtmp = Efield_aux[lev-1][0]->nGrowVect();
                 for (int i = 0; i < 3; ++i) {
-                    Etmp[i] = std::make_unique<MultiFab>(
-                        cnba, dm, 1, ngtmp);
+                    Etmp[i] = &getPersistentBuffer(Efield_aux_tmp[lev][i], cnba, dm, 1, ngtmp);
                 }
             }
             Etmp[0]->setVal(0.0);
@@ -283,6 +313,7 @@ WarpX::UpdateAuxilaryDataStagToNodal ()
 void
 WarpX::UpdateAuxilaryDataSameType ()
 {
+    WarpXCommUtil::CommSite comm_site("UpdateAuxilaryData");
     for (int lev = 1; lev <= finest_level; ++lev)
     {
         const auto& crse_period = Geom(lev-1).periodicity();
@@ -291,9 +322,10 @@ WarpX::UpdateAuxilaryDataSameType ()
 
         // B field
         {
-            MultiFab dBx(Bfield_cp[lev][0]->boxArray(), dm, Bfield_cp[lev][0]->nComp(), ng);
-            MultiFab dBy(Bfield_cp[lev][1]->boxArray(), dm, Bfield_cp[lev][1]->nComp(), ng);
-            MultiFab dBz(Bfield_cp[lev][2]->boxArray(), dm, Bfield_cp[lev][2]->nComp(), ng);
+            // Kept across the calls, and only reallocated when the grids change
+            MultiFab& dBx = getPersistentBuffer(Bfield_aux_tmp[lev][0], *Bfield_cp[lev][0], ng);
+            MultiFab& dBy = getPersistentBuffer(Bfield_aux_tmp[lev][1], *Bfield_cp[lev][1], ng);
+            MultiFab& dBz = getPersistentBuffer(Bfield_aux_tmp[lev][2], *Bfield_cp[lev][2], ng);
             dBx.setVal(0.0);
             dBy.setVal(0.0);
             dBz.setVal(0.0);
@@ -356,9 +388,10 @@ WarpX::UpdateAuxilaryDataSameType ()
 
         // E field
         {
-            MultiFab dEx(Efield_cp[lev][0]->boxArray(), dm, Efield_cp[lev][0]->nComp(), ng);
-            MultiFab dEy(Efield_cp[lev][1]->boxArray(), dm, Efield_cp[lev][1]->nComp(), ng);
-            MultiFab dEz(Efield_cp[lev][2]->boxArray(), dm, Efield_cp[lev][2]->nComp(), ng);
+            // Kept across the calls, and only reallocated when the grids change
+            MultiFab& dEx = getPersistentBuffer(Efield_aux_tmp[lev][0], *Efield_cp[lev][0], ng);
+            MultiFab& dEy = getPersistentBuffer(Efield_aux_tmp[lev][1], *Efield_cp[lev][1], ng);
+            MultiFab& dEz = getPersistentBuffer(Efield_aux_tmp[lev][2], *Efield_cp[lev][2], ng);
             dEx.setVal(0.0);
             dEy.setVal(0.0);
             dEz.setVal(0.0);
@@ -535,6 +568,190 @@ WarpX::FillBoundaryE_avg (IntVect ng)
     }
 }
 
+void
+WarpX::FillBoundaryEB (IntVect ng, const bool include_avg)
+{
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        FillBoundaryEB(lev, ng, include_avg);
+    }
+}
+
+void
+WarpX::FillBoundaryEB (int lev, IntVect ng, const bool include_avg)
+{
+    FillBoundaryEB(lev, PatchType::fine, ng, include_avg);
+    if (lev > 0) FillBoundaryEB(lev, PatchType::coarse, ng, include_avg);
+}
+
+void
+WarpX::FillBoundaryEB (int lev, PatchType patch_type, IntVect ng, const bool include_avg)
+{
+    WarpXCommUtil::CommSite comm_site("FillBoundaryEB");
+    const bool fine = (patch_type == PatchType::fine);
+    const auto& E = fine ? Efield_fp[lev] : Efield_cp[lev];
+    const auto& B = fine ? Bfield_fp[lev] : Bfield_cp[lev];
+
+    if (do_pml && pml[lev]->ok())
+    {
+        if (include_avg) amrex::Abort("Averaged Galilean PSATD with PML is not yet implemented");
+        pml[lev]->ExchangeE(patch_type, { E[0].get(), E[1].get(), E[2].get() }, do_pml_in_domain);
+        pml[lev]->FillBoundaryE(patch_type);
+        pml[lev]->ExchangeB(patch_type, { B[0].get(), B[1].get(), B[2].get() }, do_pml_in_domain);
+        pml[lev]->FillBoundaryB(patch_type);
+    }
+
+    // All the components of E and B (and of their time averages) in one communication round
+    using WarpXCommUtil::CommField;
+    Vector<MultiFab*> mf{E[0].get(), E[1].get(), E[2].get(), B[0].get(), B[1].get(), B[2].get()};
+    Vector<CommField> field{CommField::E, CommField::E, CommField::E,
+                            CommField::B, CommField::B, CommField::B};
+    if (include_avg) {
+        const auto& E_avg = fine ? Efield_avg_fp[lev] : Efield_avg_cp[lev];
+        const auto& B_avg = fine ? Bfield_avg_fp[lev] : Bfield_avg_cp[lev];
+        for (int i = 0; i < 3; ++i) mf.push_back(E_avg[i].get());
+        for (int i = 0; i < 3; ++i) mf.push_back(B_avg[i].get());
+        for (int i = 0; i < 3; ++i) field.push_back(CommField::E);
+        for (int i = 0; i < 3; ++i) field.push_back(CommField::B);
+    }
+    Vector<IntVect> nghost;
+    for (auto x : mf) {
+        if (safe_guard_cells) {
+            nghost.push_back(x->nGrowVect());
+        } else {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                ng <= x->nGrowVect(),
+                "Error: in FillBoundaryEB, requested more guard cells than allocated");
+            nghost.push_back(ng);
+        }
+    }
+    const auto& period = fine ? Geom(lev).periodicity() : Geom(lev-1).periodicity();
+    WarpXCommUtil::FillBoundary(mf, nghost, period, field);
+}
+
+void
+WarpX::FillBoundaryBF (IntVect ng, IntVect ng_F)
+{
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        FillBoundaryBF(lev, ng, ng_F);
+    }
+}
+
+void
+WarpX::FillBoundaryBF (int lev, IntVect ng, IntVect ng_F)
+{
+    FillBoundaryBF(lev, PatchType::fine, ng, ng_F);
+    if (lev > 0) FillBoundaryBF(lev, PatchType::coarse, ng, ng_F);
+}
+
+void
+WarpX::FillBoundaryBF (int lev, PatchType patch_type, IntVect ng, IntVect ng_F)
+{
+    WarpXCommUtil::CommSite comm_site("FillBoundaryBF");
+    const bool fine = (patch_type == PatchType::fine);
+    const auto& B = fine ? Bfield_fp[lev] : Bfield_cp[lev];
+    const auto& F = fine ? F_fp[lev] : F_cp[lev];
+
+    if (do_pml && pml[lev]->ok())
+    {
+        pml[lev]->ExchangeB(patch_type, { B[0].get(), B[1].get(), B[2].get() }, do_pml_in_domain);
+        pml[lev]->FillBoundaryB(patch_type);
+        if (F) pml[lev]->ExchangeF(patch_type, F.get(), do_pml_in_domain);
+        pml[lev]->FillBoundaryF(patch_type);
+    }
+
+    // The components of B and F in one communication round
+    using WarpXCommUtil::CommField;
+    Vector<MultiFab*> mf{B[0].get(), B[1].get(), B[2].get()};
+    Vector<CommField> field{CommField::B, CommField::B, CommField::B};
+    Vector<IntVect> nghost;
+    for (auto x : mf) {
+        if (safe_guard_cells) {
+            nghost.push_back(x->nGrowVect());
+        } else {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                ng <= x->nGrowVect(),
+                "Error: in FillBoundaryBF, requested more guard cells than allocated");
+            nghost.push_back(ng);
+        }
+    }
+    if (F) {
+        mf.push_back(F.get());
+        field.push_back(CommField::F);
+        nghost.push_back((safe_guard_cells) ? F->nGrowVect() : ng_F);
+    }
+    const auto& period = fine ? Geom(lev).periodicity() : Geom(lev-1).periodicity();
+    WarpXCommUtil::FillBoundary(mf, nghost, period, field);
+}
+
+void
+WarpX::FillBoundaryEB_nowait (IntVect ng)
+{
+    WarpXCommUtil::CommSite comm_site("FillBoundaryEB");
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(finest_level == 0 && !m_fill_boundary_EB_pending,
+        "FillBoundaryEB_nowait: only implemented without mesh refinement");
+
+    const auto& E = Efield_fp[0];
+    const auto& B = Bfield_fp[0];
+
+    if (do_pml && pml[0]->ok())
+    {
+        pml[0]->ExchangeE(PatchType::fine, { E[0].get(), E[1].get(), E[2].get() }, do_pml_in_domain);
+        pml[0]->FillBoundaryE(PatchType::fine);
+        pml[0]->ExchangeB(PatchType::fine, { B[0].get(), B[1].get(), B[2].get() }, do_pml_in_domain);
+        pml[0]->FillBoundaryB(PatchType::fine);
+    }
+
+    const auto& period = Geom(0).periodicity();
+    for (auto x : {E[0].get(), E[1].get(), E[2].get(), B[0].get(), B[1].get(), B[2].get()}) {
+        if (safe_guard_cells) {
+            WarpXCommUtil::FillBoundary_nowait(*x, x->nGrowVect(), period);
+        } else {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                ng <= x->nGrowVect(),
+                "Error: in FillBoundaryEB_nowait, requested more guard cells than allocated");
+            WarpXCommUtil::FillBoundary_nowait(*x, ng, period);
+        }
+    }
+    m_fill_boundary_EB_pending = true;
+}
+
+void
+WarpX::PrintCommErrorStats () const
+{
+    using WarpXCommUtil::CommField;
+    const int precision[3] = {comm_precision_E, comm_precision_B, comm_precision_F};
+    const char* name[3] = {"E", "B", "F"};
+    const CommField field[3] = {CommField::E, CommField::B, CommField::F};
+    for (int i = 0; i < 3; ++i) {
+        if (precision[i] == CommPrecision::Default) continue;
+        const auto& stats = WarpXCommUtil::GetCommErrorStats(field[i]);
+        amrex::Real error = stats.max_error;
+        amrex::Real value = stats.max_value;
+        ParallelDescriptor::ReduceRealMax(error);
+        ParallelDescriptor::ReduceRealMax(value);
+        amrex::Print() << "Reduced-precision halo exchanges of " << name[i]
+                       << ": max error = " << error << ", max relative error = "
+                       << ((value > 0.) ? error/value : 0.) << "\n";
+    }
+    WarpXCommUtil::ResetCommErrorStats();
+}
+
+void
+WarpX::FillBoundaryEB_finish ()
+{
+    WarpXCommUtil::CommSite comm_site("FillBoundaryEB");
+    if (!m_fill_boundary_EB_pending) return;
+
+    const auto& E = Efield_fp[0];
+    const auto& B = Bfield_fp[0];
+    for (auto x : {E[0].get(), E[1].get(), E[2].get(), B[0].get(), B[1].get(), B[2].get()}) {
+        WarpXCommUtil::FillBoundary_finish(*x);
+    }
+    m_fill_boundary_EB_pending = false;
+}
+
 
 void
 WarpX::FillBoundaryE(int lev, IntVect ng)
@@ -546,6 +763,7 @@ WarpX::FillBoundaryE(int lev, IntVect ng)
 void
 WarpX::FillBoundaryE (int lev, PatchType patch_type, IntVect ng)
 {
+    WarpXCommUtil::CommSite comm_site("FillBoundaryE");
     if (patch_type == PatchType::fine)
     {
         if (do_pml && pml[lev]->ok())
@@ -561,14 +779,14 @@ WarpX::FillBoundaryE (int lev, PatchType patch_type, IntVect ng)
         const auto& period = Geom(lev).periodicity();
         if ( safe_guard_cells ){
             Vector<MultiFab*> mf{Efield_fp[lev][0].get(),Efield_fp[lev][1].get(),Efield_fp[lev][2].get()};
-            WarpXCommUtil::FillBoundary(mf, period);
+            WarpXCommUtil::FillBoundary(mf, period, WarpXCommUtil::CommField::E);
         } else {
             AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
                 ng <= Efield_fp[lev][0]->nGrowVect(),
                 "Error: in FillBoundaryE, requested more guard cells than allocated");
-            WarpXCommUtil::FillBoundary(*Efield_fp[lev][0], ng, period);
-            WarpXCommUtil::FillBoundary(*Efield_fp[lev][1], ng, period);
-            WarpXCommUtil::FillBoundary(*Efield_fp[lev][2], ng, period);
+            WarpXCommUtil::FillBoundary(*Efield_fp[lev][0], ng, period, WarpXCommUtil::CommField::E);
+            WarpXCommUtil::FillBoundary(*Efield_fp[lev][1], ng, period, WarpXCommUtil::CommField::E);
+            WarpXCommUtil::FillBoundary(*Efield_fp[lev][2], ng, period, WarpXCommUtil::CommField::E);
         }
     }
     else if (patch_type == PatchType::coarse)
@@ -585,15 +803,15 @@ WarpX::FillBoundaryE (int lev, PatchType patch_type, IntVect ng)
         const auto& cperiod = Geom(lev-1).periodicity();
         if ( safe_guard_cells ) {
             Vector<MultiFab*> mf{Efield_cp[lev][0].get(),Efield_cp[lev][1].get(),Efield_cp[lev][2].get()};
-            WarpXCommUtil::FillBoundary(mf, cperiod);
+            WarpXCommUtil::FillBoundary(mf, cperiod, WarpXCommUtil::CommField::E);
 
         } else {
             AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
                 ng <= Efield_cp[lev][0]->nGrowVect(),
                 "Error: in FillBoundaryE, requested more guard cells than allocated");
-            WarpXCommUtil::FillBoundary(*Efield_cp[lev][0], ng, cperiod);
-            WarpXCommUtil::FillBoundary(*Efield_cp[lev][1], ng, cperiod);
-            WarpXCommUtil::FillBoundary(*Efield_cp[lev][2], ng, cperiod);
+            WarpXCommUtil::FillBoundary(*Efield_cp[lev][0], ng, cperiod, WarpXCommUtil::CommField::E);
+            WarpXCommUtil::FillBoundary(*Efield_cp[lev][1], ng, cperiod, WarpXCommUtil::CommField::E);
+            WarpXCommUtil::FillBoundary(*Efield_cp[lev][2], ng, cperiod, WarpXCommUtil::CommField::E);
         }
     }
 }
@@ -608,6 +826,7 @@ WarpX::FillBoundaryB (int lev, IntVect ng)
 void
 WarpX::FillBoundaryB (int lev, PatchType patch_type, IntVect ng)
 {
+    WarpXCommUtil::CommSite comm_site("FillBoundaryB");
     if (patch_type == PatchType::fine)
     {
         if (do_pml && pml[lev]->ok())
@@ -622,15 +841,15 @@ WarpX::FillBoundaryB (int lev, PatchType patch_type, IntVect ng)
         const auto& period = Geom(lev).periodicity();
         if ( safe_guard_cells ) {
             Vector<MultiFab*> mf{Bfield_fp[lev][0].get(),Bfield_fp[lev][1].get(),Bfield_fp[lev][2].get()};
-            WarpXCommUtil::FillBoundary(mf, period);
+            WarpXCommUtil::FillBoundary(mf, period, WarpXCommUtil::CommField::B);
         } else {
             AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
                 ng <= Bfield_fp[lev][0]->nGrowVect(),
                 "Error: in FillBoundaryB, requested more guard cells than allocated");
 
-            WarpXCommUtil::FillBoundary(*Bfield_fp[lev][0], ng, period);
-            WarpXCommUtil::FillBoundary(*Bfield_fp[lev][1], ng, period);
-            WarpXCommUtil::FillBoundary(*Bfield_fp[lev][2], ng, period);
+            WarpXCommUtil::FillBoundary(*Bfield_fp[lev][0], ng, period, WarpXCommUtil::CommField::B);
+            WarpXCommUtil::FillBoundary(*Bfield_fp[lev][1], ng, period, WarpXCommUtil::CommField::B);
+            WarpXCommUtil::FillBoundary(*Bfield_fp[lev][2], ng, period, WarpXCommUtil::CommField::B);
         }
     }
     else if (patch_type == PatchType::coarse)
@@ -647,15 +866,15 @@ WarpX::FillBoundaryB (int lev, PatchType patch_type, IntVect ng)
         const auto& cperiod = Geom(lev-1).periodicity();
         if ( safe_guard_cells ){
             Vector<MultiFab*> mf{Bfield_cp[lev][0].get(),Bfield_cp[lev][1].get(),Bfield_cp[lev][2].get()};
-            WarpXCommUtil::FillBoundary(mf, cperiod);
+            WarpXCommUtil::FillBoundary(mf, cperiod, WarpXCommUtil::CommField::B);
         } else {
             AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
                 ng <= Bfield_cp[lev][0]->nGrowVect(),
                 "Error: in FillBoundaryB, requested more guard cells than allocated");
 
-            WarpXCommUtil::FillBoundary(*Bfield_cp[lev][0], ng, cperiod);
-            WarpXCommUtil::FillBoundary(*Bfield_cp[lev][1], ng, cperiod);
-            WarpXCommUtil::FillBoundary(*Bfield_cp[lev][2], ng, cperiod);
+            WarpXCommUtil::FillBoundary(*Bfield_cp[lev][0], ng, cperiod, WarpXCommUtil::CommField::B);
+            WarpXCommUtil::FillBoundary(*Bfield_cp[lev][1], ng, cperiod, WarpXCommUtil::CommField::B);
+            WarpXCommUtil::FillBoundary(*Bfield_cp[lev][2], ng, cperiod, WarpXCommUtil::CommField::B);
         }
     }
 }
@@ -670,6 +889,7 @@ WarpX::FillBoundaryE_avg(int lev, IntVect ng)
 void
 WarpX::FillBoundaryE_avg (int lev, PatchType patch_type, IntVect ng)
 {
+    WarpXCommUtil::CommSite comm_site("FillBoundaryE_avg");
     if (patch_type == PatchType::fine)
     {
         if (do_pml && pml[lev]->ok())
@@ -680,14 +900,14 @@ WarpX::FillBoundaryE_avg (int lev, PatchType patch_type, IntVect ng)
         const auto& period = Geom(lev).periodicity();
         if ( safe_guard_cells ){
             Vector<MultiFab*> mf{Efield_avg_fp[lev][0].get(),Efield_avg_fp[lev][1].get(),Efield_avg_fp[lev][2].get()};
-            WarpXCommUtil::FillBoundary(mf, period);
+            WarpXCommUtil::FillBoundary(mf, period, WarpXCommUtil::CommField::E);
         } else {
             AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
                 ng <= Efield_avg_fp[lev][0]->nGrowVect(),
                 "Error: in FillBoundaryE_avg, requested more guard cells than allocated");
-            WarpXCommUtil::FillBoundary(*Efield_avg_fp[lev][0], ng, period);
-            WarpXCommUtil::FillBoundary(*Efield_avg_fp[lev][1], ng, period);
-            WarpXCommUtil::FillBoundary(*Efield_avg_fp[lev][2], ng, period);
+            WarpXCommUtil::FillBoundary(*Efield_avg_fp[lev][0], ng, period, WarpXCommUtil::CommField::E);
+            WarpXCommUtil::FillBoundary(*Efield_avg_fp[lev][1], ng, period, WarpXCommUtil::CommField::E);
+            WarpXCommUtil::FillBoundary(*Efield_avg_fp[lev][2], ng, period, WarpXCommUtil::CommField::E);
         }
     }
     else if (patch_type == PatchType::coarse)
@@ -700,15 +920,15 @@ WarpX::FillBoundaryE_avg (int lev, PatchType patch_type, IntVect ng)
         const auto& cperiod = Geom(lev-1).periodicity();
         if ( safe_guard_cells ) {
             Vector<MultiFab*> mf{Efield_avg_cp[lev][0].get(),Efield_avg_cp[lev][1].get(),Efield_avg_cp[lev][2].get()};
-            WarpXCommUtil::FillBoundary(mf, cperiod);
+            WarpXCommUtil::FillBoundary(mf, cperiod, WarpXCommUtil::CommField::E);
 
         } else {
             AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
                 ng <= Efield_avg_cp[lev][0]->nGrowVect(),
                 "Error: in FillBoundaryE, requested more guard cells than allocated");
-            WarpXCommUtil::FillBoundary(*Efield_avg_cp[lev][0], ng, cperiod);
-            WarpXCommUtil::FillBoundary(*Efield_avg_cp[lev][1], ng, cperiod);
-            WarpXCommUtil::FillBoundary(*Efield_avg_cp[lev][2], ng, cperiod);
+            WarpXCommUtil::FillBoundary(*Efield_avg_cp[lev][0], ng, cperiod, WarpXCommUtil::CommField::E);
+            WarpXCommUtil::FillBoundary(*Efield_avg_cp[lev][1], ng, cperiod, WarpXCommUtil::CommField::E);
+            WarpXCommUtil::FillBoundary(*Efield_avg_cp[lev][2], ng, cperiod, WarpXCommUtil::CommField::E);
         }
     }
 }
@@ -724,6 +944,7 @@ WarpX::FillBoundaryB_avg (int lev, IntVect ng)
 void
 WarpX::FillBoundaryB_avg (int lev, PatchType patch_type, IntVect ng)
 {
+    WarpXCommUtil::CommSite comm_site("FillBoundaryB_avg");
     if (patch_type == PatchType::fine)
     {
         if (do_pml && pml[lev]->ok())
@@ -733,14 +954,14 @@ WarpX::FillBoundaryB_avg (int lev, PatchType patch_type, IntVect ng)
         const auto& period = Geom(lev).periodicity();
         if ( safe_guard_cells ) {
             Vector<MultiFab*> mf{Bfield_avg_fp[lev][0].get(),Bfield_avg_fp[lev][1].get(),Bfield_avg_fp[lev][2].get()};
-            WarpXCommUtil::FillBoundary(mf, period);
+            WarpXCommUtil::FillBoundary(mf, period, WarpXCommUtil::CommField::B);
         } else {
             AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
                 ng <= Bfield_fp[lev][0]->nGrowVect(),
                 "Error: in FillBoundaryB, requested more guard cells than allocated");
-            WarpXCommUtil::FillBoundary(*Bfield_avg_fp[lev][0], ng, period);
-            WarpXCommUtil::FillBoundary(*Bfield_avg_fp[lev][1], ng, period);
-            WarpXCommUtil::FillBoundary(*Bfield_avg_fp[lev][2], ng, period);
+            WarpXCommUtil::FillBoundary(*Bfield_avg_fp[lev][0], ng, period, WarpXCommUtil::CommField::B);
+            WarpXCommUtil::FillBoundary(*Bfield_avg_fp[lev][1], ng, period, WarpXCommUtil::CommField::B);
+            WarpXCommUtil::FillBoundary(*Bfield_avg_fp[lev][2], ng, period, WarpXCommUtil::CommField::B);
         }
     }
     else if (patch_type == PatchType::coarse)
@@ -753,14 +974,14 @@ WarpX::FillBoundaryB_avg (int lev, PatchType patch_type, IntVect ng)
         const auto& cperiod = Geom(lev-1).periodicity();
         if ( safe_guard_cells ){
             Vector<MultiFab*> mf{Bfield_avg_cp[lev][0].get(),Bfield_avg_cp[lev][1].get(),Bfield_avg_cp[lev][2].get()};
-            WarpXCommUtil::FillBoundary(mf, cperiod);
+            WarpXCommUtil::FillBoundary(mf, cperiod, WarpXCommUtil::CommField::B);
         } else {
             AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
                 ng <= Bfield_avg_cp[lev][0]->nGrowVect(),
                 "Error: in FillBoundaryB_avg, requested more guard cells than allocated");
-            WarpXCommUtil::FillBoundary(*Bfield_avg_cp[lev][0], ng, cperiod);
-            WarpXCommUtil::FillBoundary(*Bfield_avg_cp[lev][1], ng, cperiod);
-            WarpXCommUtil::FillBoundary(*Bfield_avg_cp[lev][2], ng, cperiod);
+            WarpXCommUtil::FillBoundary(*Bfield_avg_cp[lev][0], ng, cperiod, WarpXCommUtil::CommField::B);
+            WarpXCommUtil::FillBoundary(*Bfield_avg_cp[lev][1], ng, cperiod, WarpXCommUtil::CommField::B);
+            WarpXCommUtil::FillBoundary(*Bfield_avg_cp[lev][2], ng, cperiod, WarpXCommUtil::CommField::B);
         }
     }
 }
@@ -775,6 +996,7 @@ WarpX::FillBoundaryF (int lev, IntVect ng)
 void
 WarpX::FillBoundaryF (int lev, PatchType patch_type, IntVect ng)
 {
+    WarpXCommUtil::CommSite comm_site("FillBoundaryF");
     if (patch_type == PatchType::fine)
     {
         if (do_pml && pml[lev]->ok())
@@ -787,7 +1009,7 @@ WarpX::FillBoundaryF (int lev, PatchType patch_type, IntVect ng)
         {
             const amrex::Periodicity& period = Geom(lev).periodicity();
             const amrex::IntVect& nghost = (safe_guard_cells) ? F_fp[lev]->nGrowVect() : ng;
-            WarpXCommUtil::FillBoundary(*F_fp[lev], nghost, period);
+            WarpXCommUtil::FillBoundary(*F_fp[lev], nghost, period, WarpXCommUtil::CommField::F);
         }
     }
     else if (patch_type == PatchType::coarse)
@@ -802,7 +1024,7 @@ WarpX::FillBoundaryF (int lev, PatchType patch_type, IntVect ng)
         {
             const amrex::Periodicity& period = Geom(lev-1).periodicity();
             const amrex::IntVect& nghost = (safe_guard_cells) ? F_cp[lev]->nGrowVect() : ng;
-            WarpXCommUtil::FillBoundary(*F_cp[lev], nghost, period);
+            WarpXCommUtil::FillBoundary(*F_cp[lev], nghost, period, WarpXCommUtil::CommField::F);
         }
     }
 }
@@ -819,6 +1041,7 @@ void WarpX::FillBoundaryG (int lev, IntVect ng)
 
 void WarpX::FillBoundaryG (int lev, PatchType patch_type, IntVect ng)
 {
+    WarpXCommUtil::CommSite comm_site("FillBoundaryG");
     if (patch_type == PatchType::fine)
     {
         if (do_pml && pml[lev]->ok())
@@ -831,7 +1054,7 @@ void WarpX::FillBoundaryG (int lev, PatchType patch_type, IntVect ng)
         {
             const amrex::Periodicity& period = Geom(lev).periodicity();
             const amrex::IntVect& nghost = (safe_guard_cells) ? G_fp[lev]->nGrowVect() : ng;
-            WarpXCommUtil::FillBoundary(*G_fp[lev], nghost, period);
+            WarpXCommUtil::FillBoundary(*G_fp[lev], nghost, period, WarpXCommUtil::CommField::F);
         }
     }
     else if (patch_type == PatchType::coarse)
@@ -846,7 +1069,7 @@ void WarpX::FillBoundaryG (int lev, PatchType patch_type, IntVect ng)
         {
             const amrex::Periodicity& period = Geom(lev-1).periodicity();
             const amrex::IntVect& nghost = (safe_guard_cells) ? G_cp[lev]->nGrowVect() : ng;
-            WarpXCommUtil::FillBoundary(*G_cp[lev], nghost, period);
+            WarpXCommUtil::FillBoundary(*G_cp[lev], nghost, period, WarpXCommUtil::CommField::F);
         }
     }
 }
@@ -863,6 +1086,7 @@ WarpX::FillBoundaryAux (IntVect ng)
 void
 WarpX::FillBoundaryAux (int lev, IntVect ng)
 {
+    WarpXCommUtil::CommSite comm_site("FillBoundaryAux");
     const auto& period = Geom(lev).periodicity();
     WarpXCommUtil::FillBoundary(*Efield_aux[lev][0], ng, period);
     WarpXCommUtil::FillBoundary(*Efield_aux[lev][1], ng, period);
@@ -892,21 +1116,7 @@ WarpX::SyncCurrent ()
     // summing the guard cells of the fine patch
     for (int lev = 1; lev <= finest_level; ++lev)
     {
-        current_cp[lev][0]->setVal(0.0);
-        current_cp[lev][1]->setVal(0.0);
-        current_cp[lev][2]->setVal(0.0);
-
-        const IntVect& refinement_ratio = refRatio(lev-1);
-
-        std::array<const MultiFab*,3> fine { current_fp[lev][0].get(),
-                                             current_fp[lev][1].get(),
-                                             current_fp[lev][2].get() };
-        std::array<      MultiFab*,3> crse { current_cp[lev][0].get(),
-                                             current_cp[lev][1].get(),
-                                             current_cp[lev][2].get() };
-        CoarsenMR::Coarsen( *crse[0], *fine[0], refinement_ratio );
-        CoarsenMR::Coarsen( *crse[1], *fine[1], refinement_ratio );
-        CoarsenMR::Coarsen( *crse[2], *fine[2], refinement_ratio );
+        RestrictCurrentFromFineToCoarsePatch(lev);
     }
 
     // For each level
@@ -970,9 +1180,11 @@ WarpX::RestrictCurrentFromFineToCoarsePatch (int lev)
 void
 WarpX::ApplyFilterandSumBoundaryJ (int lev, PatchType patch_type)
 {
+    WarpXCommUtil::CommSite comm_site("SumBoundaryJ");
     const int glev = (patch_type == PatchType::fine) ? lev : lev-1;
     const auto& period = Geom(glev).periodicity();
     auto& j = (patch_type == PatchType::fine) ? current_fp[lev] : current_cp[lev];
+    auto& j_filtered = (patch_type == PatchType::fine) ? current_filtered_fp[lev] : current_filtered_cp[lev];
     for (int idim = 0; idim < 3; ++idim) {
         IntVect ng = j[idim]->nGrowVect();
         IntVect ng_depos_J = get_ng_depos_J();
@@ -991,7 +1203,9 @@ WarpX::ApplyFilterandSumBoundaryJ (int lev, PatchType patch_type)
             ng += bilinear_filter.stencil_length_each_dir-1;
             ng_depos_J += bilinear_filter.stencil_length_each_dir-1;
             ng_depos_J.min(ng);
-            MultiFab jf(j[idim]->boxArray(), j[idim]->DistributionMap(), j[idim]->nComp(), ng);
+            // Only the ng_depos_J guard cells of the filtered current are summed into j:
+            // the filter is only applied there.
+            MultiFab& jf = getPersistentBuffer(j_filtered[idim], *j[idim], ng_depos_J);
             bilinear_filter.ApplyStencil(jf, *j[idim], lev);
             WarpXSumGuardCells(*(j[idim]), jf, period, ng_depos_J, 0, (j[idim])->nComp());
         } else {
@@ -1017,6 +1231,7 @@ WarpX::ApplyFilterandSumBoundaryJ (int lev, PatchType patch_type)
 void
 WarpX::AddCurrentFromFineLevelandSumBoundary (int lev)
 {
+    WarpXCommUtil::CommSite comm_site("SumBoundaryJ");
     ApplyFilterandSumBoundaryJ(lev, PatchType::fine);
 
     if (lev < finest_level) {
@@ -1025,10 +1240,9 @@ WarpX::AddCurrentFromFineLevelandSumBoundary (int lev)
 
         const auto& period = Geom(lev).periodicity();
         for (int idim = 0; idim < 3; ++idim) {
-            MultiFab mf(current_fp[lev][idim]->boxArray(),
-                        current_fp[lev][idim]->DistributionMap(), current_fp[lev][idim]->nComp(), 0);
-            mf.setVal(0.0);
-            IntVect ng = current_cp[lev+1][idim]->nGrowVect();
+            MultiFab& jcp = *current_cp[lev+1][idim];
+            const int ncomp = jcp.nComp();
+            IntVect ng = jcp.nGrowVect();
             IntVect ng_depos_J = get_ng_depos_J();
             if (WarpX::do_current_centering)
             {
@@ -1041,59 +1255,61 @@ WarpX::AddCurrentFromFineLevelandSumBoundary (int lev)
                 ng_depos_J[2] += WarpX::current_centering_noz / 2;
 #endif
             }
-            if (use_filter && current_buf[lev+1][idim])
+            // Current (coarse patch and buffer of lev+1) added to the fine patch of lev
+            const MultiFab* jadd = nullptr;
+            // Filtered coarse patch of lev+1, if any, whose guard cells are summed into jcp
+            MultiFab* jsum = nullptr;
+            // Whether jsum holds the filtered sum of the coarse patch and the buffer,
+            // and must be overwritten with the filtered coarse patch once jadd is sent
+            bool filter_cp_after_add = false;
+            if (use_filter)
             {
                 // coarse patch of fine level
                 ng += bilinear_filter.stencil_length_each_dir-1;
                 ng_depos_J += bilinear_filter.stencil_length_each_dir-1;
                 ng_depos_J.min(ng);
-                MultiFab jfc(current_cp[lev+1][idim]->boxArray(),
-                             current_cp[lev+1][idim]->DistributionMap(), current_cp[lev+1][idim]->nComp(), ng);
-                bilinear_filter.ApplyStencil(jfc, *current_cp[lev+1][idim], lev);
-
-                // buffer patch of fine level
-                MultiFab jfb(current_buf[lev+1][idim]->boxArray(),
-                             current_buf[lev+1][idim]->DistributionMap(), current_buf[lev+1][idim]->nComp(), ng);
-                bilinear_filter.ApplyStencil(jfb, *current_buf[lev+1][idim], lev);
-
-                MultiFab::Add(jfb, jfc, 0, 0, current_buf[lev+1][idim]->nComp(), ng);
-                WarpXCommUtil::ParallelAdd(mf, jfb, 0, 0, current_buf[lev+1][idim]->nComp(), ng, IntVect::TheZeroVector(), period);
-
-                WarpXSumGuardCells(*current_cp[lev+1][idim], jfc, period, ng_depos_J, 0, current_cp[lev+1][idim]->nComp());
+                MultiFab& jfc = getPersistentBuffer(current_filtered_cp[lev+1][idim], jcp, ng);
+                if (current_buf[lev+1][idim])
+                {
+                    // buffer patch of fine level: since the filter is linear, the sum of the
+                    // coarse patch and of the buffer is filtered at once in jfc, instead of
+                    // filtering the buffer in a separate MultiFab
+                    MultiFab::Add(*current_buf[lev+1][idim], jcp, 0, 0, ncomp, jcp.nGrowVect());
+                    bilinear_filter.ApplyStencil(jfc, *current_buf[lev+1][idim], lev);
+                    filter_cp_after_add = true;
+                }
+                else
+                {
+                    bilinear_filter.ApplyStencil(jfc, jcp, lev);
+                }
+                jsum = &jfc;
+                jadd = &jfc;
             }
-            else if (use_filter) // but no buffer
+            else
             {
-                // coarse patch of fine level
-                ng += bilinear_filter.stencil_length_each_dir-1;
-                ng_depos_J += bilinear_filter.stencil_length_each_dir-1;
                 ng_depos_J.min(ng);
-                MultiFab jf(current_cp[lev+1][idim]->boxArray(),
-                            current_cp[lev+1][idim]->DistributionMap(), current_cp[lev+1][idim]->nComp(), ng);
-                bilinear_filter.ApplyStencil(jf, *current_cp[lev+1][idim], lev);
-
-                WarpXCommUtil::ParallelAdd(mf, jf, 0, 0, current_cp[lev+1][idim]->nComp(), ng, IntVect::TheZeroVector(), period);
-                WarpXSumGuardCells(*current_cp[lev+1][idim], jf, period, ng_depos_J, 0, current_cp[lev+1][idim]->nComp());
+                jadd = &jcp;
+                if (current_buf[lev+1][idim])
+                {
+                    MultiFab::Add(*current_buf[lev+1][idim], jcp, 0, 0, ncomp, jcp.nGrowVect());
+                    jadd = current_buf[lev+1][idim].get();
+                }
             }
-            else if (current_buf[lev+1][idim]) // but no filter
-            {
-                ng_depos_J.min(ng);
-                MultiFab::Add(*current_buf[lev+1][idim],
-                               *current_cp [lev+1][idim], 0, 0, current_buf[lev+1][idim]->nComp(),
-                               current_cp[lev+1][idim]->nGrowVect());
-                WarpXCommUtil::ParallelAdd(mf, *current_buf[lev+1][idim], 0, 0, current_buf[lev+1][idim]->nComp(),
-                                           current_buf[lev+1][idim]->nGrowVect(), IntVect::TheZeroVector(),
-                                           period);
-                WarpXSumGuardCells(*(current_cp[lev+1][idim]), period, ng_depos_J, 0, current_cp[lev+1][idim]->nComp());
+
+            // Add directly to the valid cells of the fine patch of lev, while the guard
+            // cells of the coarse patch of lev+1 are summed: the data of jadd is sent
+            // when the addition starts, so that jcp (and jadd) can be modified before it completes
+            WarpXCommUtil::ParallelAdd_nowait(*current_fp[lev][idim], *jadd, 0, 0, ncomp,
+                                              jadd->nGrowVect(), IntVect::TheZeroVector(), period);
+            if (filter_cp_after_add) {
+                bilinear_filter.ApplyStencil(*jsum, jcp, lev);
             }
-            else // no filter, no buffer
-            {
-                ng_depos_J.min(ng);
-                WarpXCommUtil::ParallelAdd(mf, *current_cp[lev+1][idim], 0, 0, current_cp[lev+1][idim]->nComp(),
-                                           current_cp[lev+1][idim]->nGrowVect(), IntVect::TheZeroVector(),
-                                           period);
-                WarpXSumGuardCells(*(current_cp[lev+1][idim]), period, ng_depos_J, 0, current_cp[lev+1][idim]->nComp());
+            if (jsum) {
+                WarpXSumGuardCells(jcp, *jsum, period, ng_depos_J, 0, ncomp);
+            } else {
+                WarpXSumGuardCells(jcp, period, ng_depos_J, 0, ncomp);
             }
-            MultiFab::Add(*current_fp[lev][idim], mf, 0, 0, current_fp[lev+1][idim]->nComp(), 0);
+            WarpXCommUtil::ParallelCopy_finish(*current_fp[lev][idim]);
         }
         NodalSyncJ(lev+1, PatchType::coarse);
     }
@@ -1122,6 +1338,7 @@ WarpX::ApplyFilterandSumBoundaryRho (int lev, PatchType patch_type, int icomp, i
 void
 WarpX::ApplyFilterandSumBoundaryRho (int /*lev*/, int glev, amrex::MultiFab& rho, int icomp, int ncomp)
 {
+    WarpXCommUtil::CommSite comm_site("SumBoundaryRho");
     const auto& period = Geom(glev).periodicity();
     IntVect ng = rho.nGrowVect();
     IntVect ng_depos_rho = get_ng_depos_rho();
@@ -1154,6 +1371,7 @@ WarpX::ApplyFilterandSumBoundaryRho (int /*lev*/, int glev, amrex::MultiFab& rho
 void
 WarpX::AddRhoFromFineLevelandSumBoundary(int lev, int icomp, int ncomp)
 {
+    WarpXCommUtil::CommSite comm_site("SumBoundaryRho");
     if (!rho_fp[lev]) return;
 
     ApplyFilterandSumBoundaryRho(lev, PatchType::fine, icomp, ncomp);
@@ -1229,6 +1447,7 @@ WarpX::AddRhoFromFineLevelandSumBoundary(int lev, int icomp, int ncomp)
 void
 WarpX::NodalSyncJ (int lev, PatchType patch_type)
 {
+    WarpXCommUtil::CommSite comm_site("NodalSyncJ");
     if (!override_sync_intervals.contains(istep[0])) return;
 
     if (patch_type == PatchType::fine)
@@ -1250,6 +1469,7 @@ WarpX::NodalSyncJ (int lev, PatchType patch_type)
 void
 WarpX::NodalSyncRho (int lev, PatchType patch_type, int icomp, int ncomp)
 {
+    WarpXCommUtil::CommSite comm_site("NodalSyncRho");
     if (!override_sync_intervals.contains(istep[0])) return;
 
     if (patch_type == PatchType::fine && rho_fp[lev])
@@ -1281,6 +1501,7 @@ void WarpX::NodalSyncPML (int lev)
 
 void WarpX::NodalSyncPML (int lev, PatchType patch_type)
 {
+    WarpXCommUtil::CommSite comm_site("NodalSyncPML");
     if (pml[lev]->ok())
     {
         const auto& pml_E = (patch_type == PatchType::fine) ? pml[lev]->GetE_fp() : pml[lev]->GetE_cp();
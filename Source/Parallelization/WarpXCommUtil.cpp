@@ -6,15 +6,357 @@
  */
 #include "WarpXCommUtil.H"
 
+#include "Utils/WarpXAlgorithmSelection.H"
+#include "Utils/WarpXPhaseTimers.H"
+
 #include <AMReX.H>
 #include <AMReX_BaseFab.H>
+#include <AMReX_Box.H>
+#include <AMReX_Extension.H>
+#include <AMReX_GpuQualifiers.H>
 #include <AMReX_IntVect.H>
 #include <AMReX_FabArray.H>
+#include <AMReX_MFIter.H>
 #include <AMReX_MultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Reduce.H>
+#include <AMReX_Utility.H>
 #include <AMReX_iMultiFab.H>
 
+#ifdef AMREX_USE_MPI
+#   include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    template <typename T>
+    struct CommBuffer
+    {
+        int slot;
+        std::unique_ptr<amrex::FabArray<amrex::BaseFab<T> > > fab;
+    };
+
+    // Maximum number of buffers kept (for each type): beyond this, the oldest buffer is released
+    constexpr int max_comm_buffers = 64;
+
+    // Reduced-precision buffers of the communications, kept until the grids change
+    template <typename T>
+    std::vector<CommBuffer<T> >& commBuffers ()
+    {
+        static std::vector<CommBuffer<T> > buffers;
+        return buffers;
+    }
+
+    /** \brief Reduced-precision FabArray with the BoxArray and DistributionMapping of mf,
+     *  ncomp components and ng guard cells, used as temporary buffer by the communications
+     *  in reduced precision. The buffers are kept across the calls (see ClearCommBuffers);
+     *  the slot distinguishes the buffers used at the same time. */
+    template <typename T = WarpXCommUtil::comm_float_type>
+    amrex::FabArray<amrex::BaseFab<T> >&
+    getCommBuffer (const amrex::MultiFab& mf, const int ncomp,
+                   const amrex::IntVect& ng, const int slot = 0)
+    {
+        auto& comm_buffers = commBuffers<T>();
+        for (auto& b : comm_buffers) {
+            if (b.slot == slot && b.fab->nComp() == ncomp && b.fab->nGrowVect() == ng &&
+                b.fab->boxArray() == mf.boxArray() &&
+                b.fab->DistributionMap() == mf.DistributionMap()) {
+                return *b.fab;
+            }
+        }
+        if (static_cast<int>(comm_buffers.size()) >= max_comm_buffers) {
+            comm_buffers.erase(comm_buffers.begin());
+        }
+        comm_buffers.push_back({slot, std::make_unique<amrex::FabArray<amrex::BaseFab<T> > >(
+            mf.boxArray(), mf.DistributionMap(), ncomp, ng)});
+        return *comm_buffers.back().fab;
+    }
+
+    /** \brief Conversion between amrex::Real and the type T used by the reduced-precision
+     *  communications */
+    template <typename T>
+    struct CommConvert
+    {
+        AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+        static T encode (const amrex::Real x) noexcept { return static_cast<T>(x); }
+
+        AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+        static amrex::Real decode (const T x) noexcept { return static_cast<amrex::Real>(x); }
+    };
+
+    /** bfloat16, stored as the 16 most significant bits of a float */
+    template <>
+    struct CommConvert<std::uint16_t>
+    {
+        AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+        static std::uint16_t encode (const amrex::Real x) noexcept
+        {
+            const float f = static_cast<float>(x);
+            std::uint32_t bits;
+            std::memcpy(&bits, &f, sizeof(bits));
+            // NaN: keep a NaN
+            if ((bits & 0x7fffffffu) > 0x7f800000u) {
+                return static_cast<std::uint16_t>((bits >> 16) | 0x40u);
+            }
+            // Round to nearest, ties to even
+            bits += 0x7fffu + ((bits >> 16) & 1u);
+            return static_cast<std::uint16_t>(bits >> 16);
+        }
+
+        AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+        static amrex::Real decode (const std::uint16_t x) noexcept
+        {
+            const std::uint32_t bits = static_cast<std::uint32_t>(x) << 16;
+            float f;
+            std::memcpy(&f, &bits, sizeof(f));
+            return static_cast<amrex::Real>(f);
+        }
+    };
+
+    std::array<WarpXCommUtil::CommErrorStats, 3> comm_error_stats;
+
+    // Statistics of the communications
+    bool comm_stats_enabled = false;
+    const char* comm_site_name = "other";
+    std::map<std::string, WarpXCommUtil::CommSiteStats> comm_stats;
+    WarpXCommUtil::CommSiteStats total_comm_stats;
+    // Depth of the nested communication operations (only the outermost one is counted)
+    int comm_depth = 0;
+
+    /** \brief Record one communication operation of WarpXCommUtil (and the time spent in it),
+     *  for the current call site, during the lifetime of this object */
+    class CommRecord
+    {
+    public:
+        CommRecord ()
+            : m_phase_scope(WarpXPhaseTimers::Phase::Comm)
+        {
+            if (comm_stats_enabled && comm_depth == 0) m_t0 = amrex::second();
+            ++comm_depth;
+        }
+        ~CommRecord ()
+        {
+            --comm_depth;
+            if (comm_stats_enabled && comm_depth == 0) {
+                auto& s = comm_stats[comm_site_name];
+                const double t = amrex::second() - m_t0;
+                s.ncalls += 1;
+                s.time += t;
+                total_comm_stats.ncalls += 1;
+                total_comm_stats.time += t;
+            }
+        }
+        CommRecord (CommRecord const&) = delete;
+        CommRecord& operator= (CommRecord const&) = delete;
+    private:
+        double m_t0 = 0.;
+        WarpXPhaseTimers::PhaseScope m_phase_scope;
+    };
+
+    /** \brief Add the messages sent by the communication described by md, for ncomp
+     *  components of size value_size, to the statistics of the current call site */
+    void addMessages (const amrex::FabArrayBase::CommMetaData& md, const int ncomp,
+                      const std::size_t value_size)
+    {
+        // (collective at the first call, so that it is done before the early return)
+        const auto& nodes = WarpXCommUtil::RankNodes();
+        if (!md.m_SndTags) return;
+        auto& s = comm_stats[comm_site_name];
+        const int my_node = nodes[amrex::ParallelDescriptor::MyProc()];
+        for (const auto& kv : *md.m_SndTags) {
+            s.nmessages += 1;
+            total_comm_stats.nmessages += 1;
+            double bytes = 0.;
+            for (const auto& tag : kv.second) {
+                bytes += static_cast<double>(tag.sbox.numPts())*ncomp*value_size;
+            }
+            s.bytes += bytes;
+            total_comm_stats.bytes += bytes;
+            if (nodes[kv.first] != my_node) {
+                s.bytes_internode += bytes;
+                total_comm_stats.bytes_internode += bytes;
+            }
+        }
+    }
+
+    /** \brief Size of the values sent by the communications in the default precision */
+    std::size_t commValueSize ()
+    {
+        return (WarpX::do_single_precision_comms) ?
+            sizeof(WarpXCommUtil::comm_float_type) : sizeof(amrex::Real);
+    }
+
+    /** \brief Record the messages of a FillBoundary of ng guard cells of fa */
+    void addFillBoundaryMessages (const amrex::FabArrayBase& fa, const int ncomp,
+                                  const amrex::IntVect& ng, const amrex::Periodicity& period,
+                                  const std::size_t value_size)
+    {
+        if (!comm_stats_enabled || amrex::ParallelDescriptor::NProcs() == 1) return;
+        addMessages(fa.getFB(ng, period), ncomp, value_size);
+    }
+
+    /** \brief Record the messages of a ParallelCopy from src to dst */
+    void addParallelCopyMessages (const amrex::FabArrayBase& dst, const amrex::FabArrayBase& src,
+                                  const int ncomp, const amrex::IntVect& src_ng,
+                                  const amrex::IntVect& dst_ng, const amrex::Periodicity& period,
+                                  const std::size_t value_size)
+    {
+        if (!comm_stats_enabled || amrex::ParallelDescriptor::NProcs() == 1) return;
+        addMessages(dst.getCPC(dst_ng, src, src_ng, period), ncomp, value_size);
+    }
+
+    int commPrecision (const WarpXCommUtil::CommField field)
+    {
+        switch (field) {
+            case WarpXCommUtil::CommField::E: return WarpX::comm_precision_E;
+            case WarpXCommUtil::CommField::B: return WarpX::comm_precision_B;
+            default: return WarpX::comm_precision_F;
+        }
+    }
+
+    /** \brief Exchange ng guard cells of mf through a temporary buffer of type T: the values
+     *  are rounded to T before the exchange, and only the guard cells of mf are updated */
+    template <typename T>
+    void reducedPrecisionFillBoundary (amrex::MultiFab& mf, const amrex::IntVect& ng,
+                                       const amrex::Periodicity& period,
+                                       WarpXCommUtil::CommErrorStats* error_stats)
+    {
+        const int ncomp = mf.nComp();
+        auto& mf_tmp = getCommBuffer<T>(mf, ncomp, ng);
+        addFillBoundaryMessages(mf, ncomp, ng, period, sizeof(T));
+
+        amrex::ReduceOps<amrex::ReduceOpMax, amrex::ReduceOpMax> reduce_op;
+        amrex::ReduceData<amrex::Real, amrex::Real> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+
+        for (amrex::MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            const amrex::Box& vbx = mfi.validbox();
+            const amrex::Box gbx = amrex::grow(vbx, ng);
+            auto const& src = mf.const_array(mfi);
+            auto const& tmp = mf_tmp.array(mfi);
+            amrex::ParallelFor(gbx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                tmp(i,j,k,n) = CommConvert<T>::encode(src(i,j,k,n));
+            });
+            if (error_stats) {
+                // Error on the values that are sent, i.e. on the valid cells
+                reduce_op.eval(vbx, ncomp, reduce_data,
+                    [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) -> ReduceTuple
+                    {
+                        const amrex::Real v = src(i,j,k,n);
+                        return {std::abs(CommConvert<T>::decode(tmp(i,j,k,n)) - v), std::abs(v)};
+                    });
+            }
+        }
+
+        mf_tmp.FillBoundary(period);
+
+        for (amrex::MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            const amrex::Box& vbx = mfi.validbox();
+            const amrex::Box gbx = amrex::grow(vbx, ng);
+            auto const& dst = mf.array(mfi);
+            auto const& tmp = mf_tmp.const_array(mfi);
+            amrex::ParallelFor(gbx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                if (!vbx.contains(i,j,k)) dst(i,j,k,n) = CommConvert<T>::decode(tmp(i,j,k,n));
+            });
+        }
+
+        if (error_stats) {
+            const ReduceTuple r = reduce_data.value();
+            error_stats->max_error = std::max(error_stats->max_error, amrex::get<0>(r));
+            error_stats->max_value = std::max(error_stats->max_value, amrex::get<1>(r));
+        }
+    }
+}
+
 namespace WarpXCommUtil {
 
+CommSite::CommSite (const char* name) noexcept
+    : m_previous_name(comm_site_name)
+{
+    comm_site_name = name;
+}
+
+CommSite::~CommSite ()
+{
+    comm_site_name = m_previous_name;
+}
+
+void EnableCommStats (bool enable)
+{
+    comm_stats_enabled = enable;
+}
+
+std::map<std::string, CommSiteStats> const& GetCommStats ()
+{
+    return comm_stats;
+}
+
+void ResetCommStats ()
+{
+    comm_stats.clear();
+}
+
+CommSiteStats const& GetTotalCommStats ()
+{
+    return total_comm_stats;
+}
+
+amrex::Vector<int> const& RankNodes ()
+{
+    static amrex::Vector<int> nodes;
+    if (!nodes.empty()) return nodes;
+
+    const int nprocs = amrex::ParallelDescriptor::NProcs();
+    nodes.assign(nprocs, 0);
+#ifdef AMREX_USE_MPI
+    // Lowest rank of the node of each rank
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(amrex::ParallelDescriptor::Communicator(), MPI_COMM_TYPE_SHARED,
+                        amrex::ParallelDescriptor::MyProc(), MPI_INFO_NULL, &node_comm);
+    int leader = amrex::ParallelDescriptor::MyProc();
+    MPI_Allreduce(MPI_IN_PLACE, &leader, 1, MPI_INT, MPI_MIN, node_comm);
+    MPI_Comm_free(&node_comm);
+    amrex::Vector<int> leaders(nprocs);
+    MPI_Allgather(&leader, 1, MPI_INT, leaders.data(), 1, MPI_INT,
+                  amrex::ParallelDescriptor::Communicator());
+    std::map<int,int> node_index;
+    for (const int l : leaders) node_index.emplace(l, 0);
+    int n = 0;
+    for (auto& kv : node_index) kv.second = n++;
+    for (int r = 0; r < nprocs; ++r) nodes[r] = node_index[leaders[r]];
+#endif
+    return nodes;
+}
+
+void ClearCommBuffers ()
+{
+    commBuffers<comm_float_type>().clear();
+    commBuffers<std::uint16_t>().clear();
+}
+
+CommErrorStats const& GetCommErrorStats (CommField field)
+{
+    return comm_error_stats[static_cast<int>(field)];
+}
+
+void ResetCommErrorStats ()
+{
+    for (auto& s : comm_error_stats) s = CommErrorStats();
+}
+
 void ParallelCopy (amrex::MultiFab&            dst,
                    const amrex::MultiFab&      src,
                    int                         src_comp,
@@ -26,21 +368,15 @@ void ParallelCopy (amrex::MultiFab&            dst,
                    amrex::FabArrayBase::CpOp   op)
 {
     BL_PROFILE("WarpXCommUtil::ParallelCopy");
-
-    using WarpXCommUtil::comm_float_type;
+    CommRecord record;
+    addParallelCopyMessages(dst, src, num_comp, src_nghost, dst_nghost, period, commValueSize());
 
     if (WarpX::do_single_precision_comms)
     {
-        amrex::FabArray<amrex::BaseFab<comm_float_type> > src_tmp(src.boxArray(),
-                                                                  src.DistributionMap(),
-                                                                  num_comp,
-                                                                  src_nghost);
+        auto& src_tmp = getCommBuffer(src, num_comp, src_nghost, 0);
         mixedCopy(src_tmp, src, src_comp, 0, num_comp, src_nghost);
 
-        amrex::FabArray<amrex::BaseFab<comm_float_type> > dst_tmp(dst.boxArray(),
-                                                                  dst.DistributionMap(),
-                                                                  num_comp,
-                                                                  dst_nghost);
+        auto& dst_tmp = getCommBuffer(dst, num_comp, dst_nghost, 1);
 
         mixedCopy(dst_tmp, dst, dst_comp, 0, num_comp, dst_nghost);
 
@@ -68,16 +404,47 @@ void ParallelAdd (amrex::MultiFab&            dst,
                                 amrex::FabArrayBase::ADD);
 }
 
+void ParallelAdd_nowait (amrex::MultiFab&            dst,
+                         const amrex::MultiFab&      src,
+                         int                         src_comp,
+                         int                         dst_comp,
+                         int                         num_comp,
+                         const amrex::IntVect&       src_nghost,
+                         const amrex::IntVect&       dst_nghost,
+                         const amrex::Periodicity&   period)
+{
+    if (WarpX::do_single_precision_comms)
+    {
+        WarpXCommUtil::ParallelAdd(dst, src, src_comp, dst_comp, num_comp, src_nghost, dst_nghost, period);
+        return;
+    }
+
+    BL_PROFILE("WarpXCommUtil::ParallelAdd_nowait");
+    CommRecord record;
+    addParallelCopyMessages(dst, src, num_comp, src_nghost, dst_nghost, period, commValueSize());
+
+    dst.ParallelAdd_nowait(src, src_comp, dst_comp, num_comp, src_nghost, dst_nghost, period);
+}
+
+void ParallelCopy_finish (amrex::MultiFab& dst)
+{
+    if (WarpX::do_single_precision_comms) return;
+
+    BL_PROFILE("WarpXCommUtil::ParallelCopy_finish");
+    CommRecord record;
+
+    dst.ParallelCopy_finish();
+}
+
 void FillBoundary (amrex::MultiFab& mf, const amrex::Periodicity& period)
 {
     BL_PROFILE("WarpXCommUtil::FillBoundary");
+    CommRecord record;
+    addFillBoundaryMessages(mf, mf.nComp(), mf.nGrowVect(), period, commValueSize());
 
     if (WarpX::do_single_precision_comms)
     {
-        amrex::FabArray<amrex::BaseFab<comm_float_type> > mf_tmp(mf.boxArray(),
-                                                                 mf.DistributionMap(),
-                                                                 mf.nComp(),
-                                                                 mf.nGrowVect());
+        auto& mf_tmp = getCommBuffer(mf, mf.nComp(), mf.nGrowVect());
 
         mixedCopy(mf_tmp, mf, 0, 0, mf.nComp(), mf.nGrowVect());
 
@@ -96,13 +463,12 @@ void FillBoundary (amrex::MultiFab&          mf,
                    const amrex::Periodicity& period)
 {
     BL_PROFILE("WarpXCommUtil::FillBoundary");
+    CommRecord record;
+    addFillBoundaryMessages(mf, mf.nComp(), ng, period, commValueSize());
 
     if (WarpX::do_single_precision_comms)
     {
-        amrex::FabArray<amrex::BaseFab<comm_float_type> > mf_tmp(mf.boxArray(),
-                                                            mf.DistributionMap(),
-                                                            mf.nComp(),
-                                                            mf.nGrowVect());
+        auto& mf_tmp = getCommBuffer(mf, mf.nComp(), mf.nGrowVect());
 
         mixedCopy(mf_tmp, mf, 0, 0, mf.nComp(), mf.nGrowVect());
 
@@ -119,6 +485,8 @@ void FillBoundary (amrex::MultiFab&          mf,
 void FillBoundary (amrex::iMultiFab& imf, const amrex::Periodicity& period)
 {
     BL_PROFILE("WarpXCommUtil::FillBoundary");
+    CommRecord record;
+    addFillBoundaryMessages(imf, imf.nComp(), imf.nGrowVect(), period, sizeof(int));
 
     imf.FillBoundary(period);
 }
@@ -128,27 +496,142 @@ void FillBoundary (amrex::iMultiFab&         imf,
                    const amrex::Periodicity& period)
 {
     BL_PROFILE("WarpXCommUtil::FillBoundary");
+    CommRecord record;
+    addFillBoundaryMessages(imf, imf.nComp(), ng, period, sizeof(int));
+
     imf.FillBoundary(ng, period);
 }
 
 void
 FillBoundary (amrex::Vector<amrex::MultiFab*> const& mf, const amrex::Periodicity& period)
 {
+    amrex::Vector<amrex::IntVect> ng;
     for (auto x : mf) {
-        WarpXCommUtil::FillBoundary(*x, period);
+        ng.push_back(x->nGrowVect());
+    }
+    WarpXCommUtil::FillBoundary(mf, ng, period);
+}
+
+void
+FillBoundary (amrex::Vector<amrex::MultiFab*> const& mf,
+              amrex::Vector<amrex::IntVect> const& ng,
+              const amrex::Periodicity& period)
+{
+    BL_PROFILE("WarpXCommUtil::FillBoundary");
+    CommRecord record;
+
+    AMREX_ALWAYS_ASSERT(mf.size() == ng.size());
+    if (WarpX::do_single_precision_comms)
+    {
+        for (int i = 0; i < static_cast<int>(mf.size()); ++i) {
+            WarpXCommUtil::FillBoundary(*mf[i], ng[i], period);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < static_cast<int>(mf.size()); ++i) {
+            addFillBoundaryMessages(*mf[i], mf[i]->nComp(), ng[i], period, commValueSize());
+            mf[i]->FillBoundary_nowait(ng[i], period);
+        }
+        for (auto x : mf) {
+            x->FillBoundary_finish();
+        }
     }
 }
 
+void FillBoundary (amrex::MultiFab&          mf,
+                   amrex::IntVect            ng,
+                   const amrex::Periodicity& period,
+                   CommField                 field)
+{
+    const int precision = commPrecision(field);
+    if (precision == CommPrecision::Default) {
+        WarpXCommUtil::FillBoundary(mf, ng, period);
+        return;
+    }
+
+    BL_PROFILE("WarpXCommUtil::FillBoundary(reduced precision)");
+    CommRecord record;
+
+    CommErrorStats* error_stats = (WarpX::comm_precision_diagnostics) ?
+        &comm_error_stats[static_cast<int>(field)] : nullptr;
+    if (precision == CommPrecision::Single) {
+        reducedPrecisionFillBoundary<comm_float_type>(mf, ng, period, error_stats);
+    } else {
+        reducedPrecisionFillBoundary<std::uint16_t>(mf, ng, period, error_stats);
+    }
+}
+
+void
+FillBoundary (amrex::Vector<amrex::MultiFab*> const& mf, const amrex::Periodicity& period,
+              CommField field)
+{
+    amrex::Vector<amrex::IntVect> ng;
+    for (auto x : mf) {
+        ng.push_back(x->nGrowVect());
+    }
+    WarpXCommUtil::FillBoundary(mf, ng, period, amrex::Vector<CommField>(mf.size(), field));
+}
+
+void
+FillBoundary (amrex::Vector<amrex::MultiFab*> const& mf,
+              amrex::Vector<amrex::IntVect> const& ng,
+              const amrex::Periodicity& period,
+              amrex::Vector<CommField> const& field)
+{
+    AMREX_ALWAYS_ASSERT(mf.size() == ng.size() && mf.size() == field.size());
+    CommRecord record;
+
+    // The MultiFabs exchanged in the default precision: in one communication round
+    amrex::Vector<amrex::MultiFab*> mf_default;
+    amrex::Vector<amrex::IntVect> ng_default;
+    for (int i = 0; i < static_cast<int>(mf.size()); ++i) {
+        if (commPrecision(field[i]) == CommPrecision::Default) {
+            mf_default.push_back(mf[i]);
+            ng_default.push_back(ng[i]);
+        }
+    }
+    if (!mf_default.empty()) WarpXCommUtil::FillBoundary(mf_default, ng_default, period);
+
+    // The others, one by one
+    for (int i = 0; i < static_cast<int>(mf.size()); ++i) {
+        if (commPrecision(field[i]) != CommPrecision::Default) {
+            WarpXCommUtil::FillBoundary(*mf[i], ng[i], period, field[i]);
+        }
+    }
+}
+
+void FillBoundary_nowait (amrex::MultiFab&          mf,
+                          amrex::IntVect            ng,
+                          const amrex::Periodicity& period)
+{
+    BL_PROFILE("WarpXCommUtil::FillBoundary_nowait");
+    CommRecord record;
+    addFillBoundaryMessages(mf, mf.nComp(), ng, period, commValueSize());
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!WarpX::do_single_precision_comms,
+        "FillBoundary_nowait is not implemented with warpx.do_single_precision_comms");
+    mf.FillBoundary_nowait(ng, period);
+}
+
+void FillBoundary_finish (amrex::MultiFab& mf)
+{
+    BL_PROFILE("WarpXCommUtil::FillBoundary_finish");
+    CommRecord record;
+
+    mf.FillBoundary_finish();
+}
+
 void SumBoundary (amrex::MultiFab& mf, const amrex::Periodicity& period)
 {
     BL_PROFILE("WarpXCommUtil::SumBoundary");
+    CommRecord record;
+    addParallelCopyMessages(mf, mf, mf.nComp(), mf.nGrowVect(), amrex::IntVect(0), period,
+                            commValueSize());
 
     if (WarpX::do_single_precision_comms)
     {
-        amrex::FabArray<amrex::BaseFab<comm_float_type> > mf_tmp(mf.boxArray(),
-                                                                 mf.DistributionMap(),
-                                                                 mf.nComp(),
-                                                                 mf.nGrowVect());
+        auto& mf_tmp = getCommBuffer(mf, mf.nComp(), mf.nGrowVect());
 
         mixedCopy(mf_tmp, mf, 0, 0, mf.nComp(), mf.nGrowVect());
 
@@ -169,13 +652,12 @@ void SumBoundary (amrex::MultiFab&          mf,
                   const amrex::Periodicity& period)
 {
     BL_PROFILE("WarpXCommUtil::SumBoundary");
+    CommRecord record;
+    addParallelCopyMessages(mf, mf, num_comps, ng, amrex::IntVect(0), period, commValueSize());
 
     if (WarpX::do_single_precision_comms)
     {
-        amrex::FabArray<amrex::BaseFab<comm_float_type> > mf_tmp(mf.boxArray(),
-                                                                 mf.DistributionMap(),
-                                                                 num_comps,
-                                                                 ng);
+        auto& mf_tmp = getCommBuffer(mf, num_comps, ng);
         mixedCopy(mf_tmp, mf, start_comp, 0, num_comps, ng);
 
         mf_tmp.SumBoundary(0, num_comps, ng, period);
@@ -196,13 +678,12 @@ void SumBoundary (amrex::MultiFab&          mf,
                   const amrex::Periodicity& period)
 {
     BL_PROFILE("WarpXCommUtil::SumBoundary");
+    CommRecord record;
+    addParallelCopyMessages(mf, mf, num_comps, src_ng, dst_ng, period, commValueSize());
 
     if (WarpX::do_single_precision_comms)
     {
-        amrex::FabArray<amrex::BaseFab<comm_float_type> > mf_tmp(mf.boxArray(),
-                                                                 mf.DistributionMap(),
-                                                                 num_comps,
-                                                                 mf.nGrowVect());
+        auto& mf_tmp = getCommBuffer(mf, num_comps, mf.nGrowVect());
         mixedCopy(mf_tmp, mf, start_comp, 0, num_comps, mf.nGrowVect());
 
         mf_tmp.SumBoundary(0, num_comps, src_ng, dst_ng, period);
@@ -220,12 +701,13 @@ void OverrideSync (amrex::MultiFab&          mf,
 {
     if (mf.ixType().cellCentered()) return;
 
+    CommRecord record;
+    addParallelCopyMessages(mf, mf, mf.nComp(), amrex::IntVect(0), amrex::IntVect(0), period,
+                            commValueSize());
+
     if (WarpX::do_single_precision_comms)
     {
-        amrex::FabArray<amrex::BaseFab<comm_float_type> > mf_tmp(mf.boxArray(),
-                                                                 mf.DistributionMap(),
-                                                                 mf.nComp(),
-                                                                 mf.nGrowVect());
+        auto& mf_tmp = getCommBuffer(mf, mf.nComp(), mf.nGrowVect());
 
         mixedCopy(mf_tmp, mf, 0, 0, mf.nComp(), mf.nGrowVect());
 
@@ -10,9 +10,12 @@
 
 #include "Diagnostics/MultiDiagnostics.H"
 #include "Diagnostics/ReducedDiags/MultiReducedDiags.H"
+#include "Parallelization/WarpXCommUtil.H"
 #include "Particles/MultiParticleContainer.H"
+#include "Particles/ParticleOffload.H"
 #include "Particles/WarpXParticleContainer.H"
 #include "Utils/WarpXAlgorithmSelection.H"
+#include "Utils/WarpXPhaseTimers.H"
 #include "Utils/WarpXProfilerWrapper.H"
 
 #include <AMReX.H>
@@ -39,33 +42,261 @@
 #include <array>
 #include <cmath>
 #include <cstddef>
+#include <map>
 #include <memory>
+#include <set>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 using namespace amrex;
 
+namespace
+{
+    /**
+     * \brief Exchange the ranks of the new distribution mapping, so that as many bytes as possible
+     * stay on the same rank; this does not change the load balance of the new mapping.
+     *
+     * \param[in] newdm new distribution mapping
+     * \param[in] olddm current distribution mapping
+     * \param[in] bytes number of bytes to be moved for each box, if it changes rank
+     */
+    Vector<int> minimizeMovedBytes (const Vector<int>& newdm, const Vector<int>& olddm,
+                                    const Vector<Real>& bytes)
+    {
+        // Number of bytes that would stay in place, for each pair (new rank, old rank)
+        std::map<std::pair<int,int>, Real> overlap;
+        for (int i = 0; i < static_cast<int>(newdm.size()); ++i) {
+            overlap[std::make_pair(newdm[i], olddm[i])] += bytes[i];
+        }
+        std::vector<std::pair<Real, std::pair<int,int> > > pairs;
+        for (const auto& kv : overlap) pairs.emplace_back(kv.second, kv.first);
+        std::stable_sort(pairs.begin(), pairs.end(),
+            [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        // Greedily match each new rank with the old rank with which it shares most bytes
+        const int nprocs = ParallelDescriptor::NProcs();
+        Vector<int> relabel(nprocs, -1);
+        Vector<int> used(nprocs, 0);
+        for (const auto& p : pairs) {
+            const int new_rank = p.second.first;
+            const int old_rank = p.second.second;
+            if (relabel[new_rank] < 0 && !used[old_rank]) {
+                relabel[new_rank] = old_rank;
+                used[old_rank] = 1;
+            }
+        }
+        int next_free = 0;
+        for (int r = 0; r < nprocs; ++r) {
+            if (relabel[r] >= 0) continue;
+            while (used[next_free]) ++next_free;
+            relabel[r] = next_free;
+            used[next_free] = 1;
+        }
+
+        Vector<int> pmap(newdm.size());
+        for (int i = 0; i < static_cast<int>(newdm.size()); ++i) {
+            pmap[i] = relabel[newdm[i]];
+        }
+        return pmap;
+    }
+
+    /**
+     * \brief Exchange the ranks of the distribution mapping pmap so that the ranks whose boxes are
+     * neighbors are on the same compute node, as far as possible; this does not change the load
+     * balance of the mapping.
+     *
+     * The ranks of pmap are grouped node by node: the group of a node starts from the rank with
+     * the smallest surface shared with the ranks not yet grouped (e.g. an end of the space-filling
+     * curve), and the rank sharing the largest surface with the group is added until the node is
+     * full. The shared surface of two ranks is the number of guard cells (within one cell) of the
+     * boxes of one rank that are valid cells of the boxes of the other rank, without periodicity.
+     *
+     * \param[in] pmap distribution mapping of the boxes of bas (numbered consecutively)
+     * \param[in] bas BoxArrays of the boxes of pmap
+     * \param[in] rank_nodes node of each rank (see WarpXCommUtil::RankNodes)
+     */
+    Vector<int> groupRanksByNode (const Vector<int>& pmap, const Vector<BoxArray>& bas,
+                                  const Vector<int>& rank_nodes)
+    {
+        const int nprocs = static_cast<int>(rank_nodes.size());
+        const int nnodes = *std::max_element(rank_nodes.begin(), rank_nodes.end()) + 1;
+        if (nnodes <= 1 || nnodes == nprocs) return pmap;
+        Vector<Vector<int> > node_ranks(nnodes);
+        for (int r = 0; r < nprocs; ++r) node_ranks[rank_nodes[r]].push_back(r);
+
+        // Surface shared by the boxes of each pair of ranks of pmap
+        Vector<std::map<int,Real> > surface(nprocs);
+        int offset = 0;
+        for (const auto& ba : bas) {
+            for (int i = 0; i < static_cast<int>(ba.size()); ++i) {
+                const int ri = pmap[offset+i];
+                for (const auto& isect : ba.intersections(amrex::grow(ba[i], 1))) {
+                    const int rj = pmap[offset+isect.first];
+                    if (rj != ri) surface[ri][rj] += static_cast<Real>(isect.second.numPts());
+                }
+            }
+            offset += static_cast<int>(ba.size());
+        }
+
+        Vector<int> relabel(nprocs, -1);
+        Vector<int> grouped(nprocs, 0);
+        Vector<Real> to_group(nprocs, 0.0_rt);
+        for (int node = 0; node < nnodes; ++node) {
+            std::fill(to_group.begin(), to_group.end(), 0.0_rt);
+            for (std::size_t k = 0; k < node_ranks[node].size(); ++k) {
+                int next = -1;
+                Real best = 0.0_rt;
+                for (int r = 0; r < nprocs; ++r) {
+                    if (grouped[r]) continue;
+                    Real s = to_group[r];
+                    if (k == 0) {
+                        s = 0.0_rt;
+                        for (const auto& kv : surface[r]) {
+                            if (!grouped[kv.first]) s += kv.second;
+                        }
+                    }
+                    if (next < 0 || (k == 0 && s < best) || (k > 0 && s > best)) {
+                        next = r;
+                        best = s;
+                    }
+                }
+                grouped[next] = 1;
+                relabel[next] = node_ranks[node][k];
+                for (const auto& kv : surface[next]) to_group[kv.first] += kv.second;
+            }
+        }
+
+        Vector<int> new_pmap(pmap.size());
+        for (std::size_t i = 0; i < pmap.size(); ++i) new_pmap[i] = relabel[pmap[i]];
+        return new_pmap;
+    }
+
+    /**
+     * \brief Assign the boxes of all the levels (numbered consecutively) to the ranks, so as to
+     * balance the total cost per rank over all the levels, while keeping together the boxes of
+     * adjacent levels that overlap.
+     *
+     * The boxes are assigned by decreasing cost (longest processing time first), each to the
+     * least loaded rank, unless a rank that already owns an overlapping box is loaded at most
+     * (1 + tolerance) times as much, once the box is added, as the least loaded rank (or as the
+     * mean cost per rank). The result is the same on all the ranks.
+     *
+     * \param[in] box_costs cost of each box
+     * \param[in] neighbors overlapping boxes of the adjacent levels, for each box
+     * \param[in] nprocs number of ranks
+     * \param[in] tolerance tolerated excess of cost for the colocation of overlapping boxes
+     * \param[out] efficiency mean cost per rank, normalized to the maximum cost per rank
+     */
+    Vector<int> makeMultiLevelMapping (const Vector<Real>& box_costs,
+                                       const Vector<Vector<int> >& neighbors,
+                                       const int nprocs, const Real tolerance, Real& efficiency)
+    {
+        const int nboxes = static_cast<int>(box_costs.size());
+        Vector<int> order(nboxes);
+        for (int i = 0; i < nboxes; ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(),
+            [&box_costs](int a, int b) { return box_costs[a] > box_costs[b]; });
+
+        Real total_cost = 0.0_rt;
+        for (const Real c : box_costs) total_cost += c;
+        const Real mean_cost = total_cost/nprocs;
+
+        // Ranks ordered by cost, then by number of boxes (for the boxes without cost)
+        Vector<Real> load(nprocs, 0.0_rt);
+        Vector<int> count(nprocs, 0);
+        std::set<std::tuple<Real,int,int> > ranks;
+        for (int r = 0; r < nprocs; ++r) ranks.emplace(0.0_rt, 0, r);
+
+        Vector<int> pmap(nboxes, -1);
+        for (const int i : order) {
+            const Real cost = box_costs[i];
+            int rank = std::get<2>(*ranks.begin());
+            const Real max_load = (1.0_rt + tolerance) * std::max(load[rank] + cost, mean_cost);
+            for (const int j : neighbors[i]) {
+                const int r = pmap[j];
+                if (r >= 0 && load[r] + cost <= max_load && (rank == std::get<2>(*ranks.begin())
+                    || load[r] < load[rank])) {
+                    rank = r;
+                }
+            }
+            ranks.erase(std::make_tuple(load[rank], count[rank], rank));
+            load[rank] += cost;
+            count[rank] += 1;
+            ranks.emplace(load[rank], count[rank], rank);
+            pmap[i] = rank;
+        }
+
+        const Real max_load = *std::max_element(load.begin(), load.end());
+        efficiency = (max_load > 0.0_rt) ? mean_cost/max_load : 1.0_rt;
+        return pmap;
+    }
+}
+
+DistributionMapping
+WarpX::MakeInitialDistributionMap (int lev, const BoxArray& ba)
+{
+    WARPX_PROFILE("WarpX::MakeInitialDistributionMap()");
+
+    const Vector<Real> nparticles = mypc->EstimateInitialParticles(
+        ba, Geom(lev), load_balance_initial_costs_sampling);
+
+    // Heuristic costs, with the default weights on CPU if they are not set
+    const Real cells_wt = (costs_heuristic_cells_wt >= 0._rt) ? costs_heuristic_cells_wt : 0.1_rt;
+    const Real particles_wt = (costs_heuristic_particles_wt >= 0._rt) ?
+        costs_heuristic_particles_wt : 0.9_rt;
+    Vector<Real> box_costs(ba.size());
+    for (int i = 0; i < static_cast<int>(ba.size()); ++i) {
+        box_costs[i] = cells_wt*static_cast<Real>(ba[i].numPts()) + particles_wt*nparticles[i];
+    }
+
+    const Real nboxes = ba.size();
+    const Real nprocs = ParallelContext::NProcsSub();
+    const int nmax = static_cast<int>(std::ceil(nboxes/nprocs*load_balance_knapsack_factor));
+    Real efficiency = 0._rt;
+    const DistributionMapping dm = (load_balance_with_sfc)
+        ? DistributionMapping::makeSFC(box_costs, ba, efficiency)
+        : DistributionMapping::makeKnapSack(box_costs, efficiency, nmax);
+    if (verbose) {
+        amrex::Print() << "Initial distribution mapping of level " << lev
+                       << " from the estimated costs: efficiency = " << efficiency << "\n";
+    }
+    return dm;
+}
+
 void
 WarpX::LoadBalance ()
 {
+    WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::LoadBalance);
     WARPX_PROFILE_REGION("LoadBalance");
     WARPX_PROFILE("WarpX::LoadBalance()");
 
     AMREX_ALWAYS_ASSERT(costs[0] != nullptr);
 
 #ifdef AMREX_USE_MPI
+    // The offloaded particles are stored by grid: return them before the grids change
+    m_particle_offload->returnAllParticles(*mypc);
+
     if (load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Heuristic)
     {
         // compute the costs on a per-rank basis
         ComputeCostsHeuristic(costs);
     }
 
+    // The nodes of the ranks are found collectively at the first call
+    if (load_balance_topology_aware) WarpXCommUtil::RankNodes();
+
     // By default, do not do a redistribute; this toggles to true if RemakeLevel
     // is called for any level
     int loadBalancedAnyLevel = false;
 
     const int nLevels = finestLevel();
-    for (int lev = 0; lev <= nLevels; ++lev)
+
+    // With mesh refinement, the levels can be balanced together instead of level by level
+    const bool multilevel = load_balance_multilevel && nLevels > 0;
+    if (multilevel) loadBalancedAnyLevel = LoadBalanceMultiLevel();
+
+    for (int lev = 0; lev <= nLevels && !multilevel; ++lev)
     {
         int doLoadBalance = false;
 
@@ -79,12 +310,59 @@ WarpX::LoadBalance ()
         amrex::Real currentEfficiency = 0.0;
         amrex::Real proposedEfficiency = 0.0;
 
+        // Balance either the costs of the last interval, or the costs predicted for the next one
+        LayoutData<Real> predicted_costs;
+        if (load_balance_costs_prediction != LoadBalanceCostsPrediction::None) {
+            predicted_costs.define(costs[lev]->boxArray(), costs[lev]->DistributionMap());
+            PredictCosts(lev, predicted_costs);
+        }
+        const LayoutData<Real>& balanced_costs =
+            (load_balance_costs_prediction != LoadBalanceCostsPrediction::None) ?
+            predicted_costs : *costs[lev];
+
+        // Re-chop the grids according to the costs: split the expensive boxes,
+        // merge the cheap neighbors, and distribute the new boxes
+        if (load_balance_rechop)
+        {
+            Vector<Real> box_costs(static_cast<std::size_t>(nboxes), 0.0_rt);
+            for (int i : balanced_costs.IndexArray()) box_costs[i] = balanced_costs[i];
+            ParallelDescriptor::ReduceRealSum(box_costs.data(), box_costs.size());
+
+            Vector<Real> new_costs;
+            const BoxArray new_ba = RechopBoxArray(lev, box_costs, new_costs);
+            if (new_ba != boxArray(lev))
+            {
+                // The new mapping is computed identically on all ranks
+                const int new_nmax = static_cast<int>(
+                    std::ceil(new_ba.size()/nprocs*load_balance_knapsack_factor));
+                DistributionMapping new_dm = (load_balance_with_sfc)
+                    ? DistributionMapping::makeSFC(new_costs, new_ba, proposedEfficiency)
+                    : DistributionMapping::makeKnapSack(new_costs, proposedEfficiency, new_nmax);
+                if (load_balance_topology_aware) {
+                    new_dm = DistributionMapping(groupRanksByNode(
+                        new_dm.ProcessorMap(), {new_ba}, WarpXCommUtil::RankNodes()));
+                }
+                if (verbose) {
+                    amrex::Print() << "Load balance (level " << lev << "): re-chopped "
+                                   << boxArray(lev).size() << " boxes into " << new_ba.size()
+                                   << " boxes\n";
+                }
+
+                RemakeLevel(lev, t_new[lev], new_ba, new_dm);
+
+                // Record the load balance efficiency
+                setLoadBalanceEfficiency(lev, proposedEfficiency);
+                loadBalancedAnyLevel = true;
+                continue;
+            }
+        }
+
         newdm = (load_balance_with_sfc)
-            ? DistributionMapping::makeSFC(*costs[lev],
+            ? DistributionMapping::makeSFC(balanced_costs,
                                            currentEfficiency, proposedEfficiency,
                                            false,
                                            ParallelDescriptor::IOProcessorNumber())
-            : DistributionMapping::makeKnapSack(*costs[lev],
+            : DistributionMapping::makeKnapSack(balanced_costs,
                                                 currentEfficiency, proposedEfficiency,
                                                 nmax,
                                                 false,
@@ -98,6 +376,59 @@ WarpX::LoadBalance ()
             doLoadBalance = (proposedEfficiency > load_balance_efficiency_ratio_threshold*currentEfficiency);
         }
 
+        // Keep the ranks whose boxes are neighbors on the same node
+        if (load_balance_topology_aware && doLoadBalance &&
+            ParallelDescriptor::MyProc() == ParallelDescriptor::IOProcessorNumber())
+        {
+            newdm = DistributionMapping(groupRanksByNode(
+                newdm.ProcessorMap(), {boxArray(lev)}, WarpXCommUtil::RankNodes()));
+        }
+
+        // Compare the savings expected from the new mapping with the cost of the migration
+        const bool migration_aware = (load_balance_migration_cost_per_byte > 0.0_rt);
+        if (migration_aware || load_balance_minimize_moves)
+        {
+            Vector<Real> bytes = MigrationBytes(lev);
+            Real total_cost = 0.0_rt;
+            for (int i : balanced_costs.IndexArray()) total_cost += balanced_costs[i];
+            ParallelDescriptor::ReduceRealSum(bytes.data(), bytes.size(),
+                                              ParallelDescriptor::IOProcessorNumber());
+            ParallelDescriptor::ReduceRealSum(total_cost, ParallelDescriptor::IOProcessorNumber());
+
+            if (doLoadBalance && ParallelDescriptor::IOProcessor())
+            {
+                const Vector<int>& oldpmap = DistributionMap(lev).ProcessorMap();
+                if (load_balance_minimize_moves && !load_balance_topology_aware) {
+                    newdm = DistributionMapping(minimizeMovedBytes(newdm.ProcessorMap(), oldpmap, bytes));
+                }
+                if (migration_aware && currentEfficiency > 0.0_rt && proposedEfficiency > 0.0_rt)
+                {
+                    Real moved_bytes = 0.0_rt;
+                    const Vector<int>& newpmap = newdm.ProcessorMap();
+                    for (int i = 0; i < static_cast<int>(newpmap.size()); ++i) {
+                        if (newpmap[i] != oldpmap[i]) moved_bytes += bytes[i];
+                    }
+                    // Decrease of the maximum cost per rank, over the next interval; the
+                    // timer-based costs are a running average over about half an interval
+                    const int period = load_balance_intervals.localPeriod(istep[0]+1);
+                    const Real steps_per_cost =
+                        (load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Heuristic) ?
+                        1.0_rt : 2.0_rt/period;
+                    const Real savings = total_cost/nprocs
+                        * (1.0_rt/currentEfficiency - 1.0_rt/proposedEfficiency)
+                        * steps_per_cost * period;
+                    const Real migration_cost = moved_bytes*load_balance_migration_cost_per_byte;
+                    doLoadBalance = (savings > migration_cost);
+                    if (verbose) {
+                        amrex::Print() << "Load balance (level " << lev << "): expected savings "
+                                       << savings << ", migration of " << moved_bytes
+                                       << " bytes, cost " << migration_cost
+                                       << (doLoadBalance ? ": accepted\n" : ": rejected\n");
+                    }
+                }
+            }
+        }
+
         ParallelDescriptor::Bcast(&doLoadBalance, 1,
                                   ParallelDescriptor::IOProcessorNumber());
 
@@ -139,10 +470,134 @@ WarpX::LoadBalance ()
 #endif
 }
 
+bool
+WarpX::LoadBalanceMultiLevel ()
+{
+    const int nLevels = finestLevel();
+    const int nprocs = ParallelContext::NProcsSub();
+
+    // Costs (balanced as in LoadBalance), current ranks and migration bytes of the boxes
+    // of all the levels, numbered consecutively
+    Vector<int> offset(nLevels+2, 0);
+    for (int lev = 0; lev <= nLevels; ++lev) offset[lev+1] = offset[lev] + costs[lev]->size();
+    const int nboxes = offset[nLevels+1];
+    Vector<Real> box_costs(nboxes, 0.0_rt);
+    Vector<int> oldpmap(nboxes);
+    Vector<Real> bytes;
+    const bool migration_aware = (load_balance_migration_cost_per_byte > 0.0_rt);
+    if (migration_aware || load_balance_minimize_moves) bytes.resize(nboxes, 0.0_rt);
+    for (int lev = 0; lev <= nLevels; ++lev)
+    {
+        LayoutData<Real> predicted_costs;
+        if (load_balance_costs_prediction != LoadBalanceCostsPrediction::None) {
+            predicted_costs.define(costs[lev]->boxArray(), costs[lev]->DistributionMap());
+            PredictCosts(lev, predicted_costs);
+        }
+        const LayoutData<Real>& balanced_costs =
+            (load_balance_costs_prediction != LoadBalanceCostsPrediction::None) ?
+            predicted_costs : *costs[lev];
+        for (int i : balanced_costs.IndexArray()) box_costs[offset[lev]+i] = balanced_costs[i];
+
+        const Vector<int>& pmap = DistributionMap(lev).ProcessorMap();
+        std::copy(pmap.begin(), pmap.end(), oldpmap.begin() + offset[lev]);
+
+        if (!bytes.empty()) {
+            const Vector<Real> lev_bytes = MigrationBytes(lev);
+            std::copy(lev_bytes.begin(), lev_bytes.end(), bytes.begin() + offset[lev]);
+        }
+    }
+    // The new mapping is computed identically on all ranks
+    ParallelDescriptor::ReduceRealSum(box_costs.data(), box_costs.size());
+    if (!bytes.empty()) ParallelDescriptor::ReduceRealSum(bytes.data(), bytes.size());
+
+    // Overlapping boxes of adjacent levels: the fine boxes of level lev, and thus their
+    // coarse patch, exchange data with the boxes of level lev-1 that they cover
+    Vector<Vector<int> > neighbors(nboxes);
+    for (int lev = 1; lev <= nLevels; ++lev)
+    {
+        const BoxArray& ba = boxArray(lev);
+        for (int i = 0; i < static_cast<int>(ba.size()); ++i) {
+            const Box cbx = amrex::coarsen(ba[i], refRatio(lev-1));
+            for (const auto& isect : boxArray(lev-1).intersections(cbx)) {
+                const int fine = offset[lev] + i;
+                const int crse = offset[lev-1] + isect.first;
+                neighbors[fine].push_back(crse);
+                neighbors[crse].push_back(fine);
+            }
+        }
+    }
+
+    Real proposedEfficiency = 0.0_rt;
+    Vector<int> newpmap = makeMultiLevelMapping(box_costs, neighbors, nprocs,
+                                                load_balance_multilevel_tolerance, proposedEfficiency);
+
+    Vector<Real> load(nprocs, 0.0_rt);
+    Real total_cost = 0.0_rt;
+    for (int i = 0; i < nboxes; ++i) {
+        load[oldpmap[i]] += box_costs[i];
+        total_cost += box_costs[i];
+    }
+    const Real max_load = *std::max_element(load.begin(), load.end());
+    const Real currentEfficiency = (max_load > 0.0_rt) ? total_cost/nprocs/max_load : 1.0_rt;
+
+    bool doLoadBalance = (load_balance_efficiency_ratio_threshold > 0.0)
+        && (proposedEfficiency > load_balance_efficiency_ratio_threshold*currentEfficiency);
+    if (verbose) {
+        amrex::Print() << "Load balance (all levels): efficiency " << currentEfficiency
+                       << " -> " << proposedEfficiency << "\n";
+    }
+
+    // The ranks are relabeled consistently over all the levels
+    if (doLoadBalance && load_balance_topology_aware) {
+        Vector<BoxArray> bas;
+        for (int lev = 0; lev <= nLevels; ++lev) bas.push_back(boxArray(lev));
+        newpmap = groupRanksByNode(newpmap, bas, WarpXCommUtil::RankNodes());
+    } else if (doLoadBalance && load_balance_minimize_moves) {
+        newpmap = minimizeMovedBytes(newpmap, oldpmap, bytes);
+    }
+    if (doLoadBalance && migration_aware && currentEfficiency > 0.0_rt && proposedEfficiency > 0.0_rt)
+    {
+        Real moved_bytes = 0.0_rt;
+        for (int i = 0; i < nboxes; ++i) {
+            if (newpmap[i] != oldpmap[i]) moved_bytes += bytes[i];
+        }
+        // Same estimate of the savings over the next interval as in LoadBalance
+        const int period = load_balance_intervals.localPeriod(istep[0]+1);
+        const Real steps_per_cost =
+            (load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Heuristic) ?
+            1.0_rt : 2.0_rt/period;
+        const Real savings = total_cost/nprocs
+            * (1.0_rt/currentEfficiency - 1.0_rt/proposedEfficiency)
+            * steps_per_cost * period;
+        const Real migration_cost = moved_bytes*load_balance_migration_cost_per_byte;
+        doLoadBalance = (savings > migration_cost);
+        if (verbose) {
+            amrex::Print() << "Load balance (all levels): expected savings "
+                           << savings << ", migration of " << moved_bytes
+                           << " bytes, cost " << migration_cost
+                           << (doLoadBalance ? ": accepted\n" : ": rejected\n");
+        }
+    }
+    if (!doLoadBalance) return false;
+
+    for (int lev = 0; lev <= nLevels; ++lev)
+    {
+        const Vector<int> pmap(newpmap.begin() + offset[lev], newpmap.begin() + offset[lev+1]);
+        if (pmap != DistributionMap(lev).ProcessorMap()) {
+            RemakeLevel(lev, t_new[lev], boxArray(lev), DistributionMapping(pmap));
+        }
+        // Record the load balance efficiency (of all the levels together)
+        setLoadBalanceEfficiency(lev, proposedEfficiency);
+    }
+    return true;
+}
 
 void
 WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const DistributionMapping& dm)
 {
+    // The buffers of the single-precision communications have the layout of the old grids
+    WarpXCommUtil::ClearCommBuffers();
+
     if (ba == boxArray(lev))
     {
         if (ParallelDescriptor::NProcs() == 1) return;
@@ -155,63 +610,36 @@ WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const Distributi
         ComputeFaceAreas();
         ScaleEdges();
         ScaleAreas();
+        ComputeEBTileClasses();
         ComputeDistanceToEB();
 #else
         m_field_factory[lev] = std::make_unique<FArrayBoxFactory>();
 #endif
 
+        // The fields are remade one at a time, and each old MultiFab is freed as soon as
+        // its data is redistributed, so that the memory overhead is bounded by the largest field
+
         // Fine patch
         for (int idim=0; idim < 3; ++idim)
         {
-            {
-                const IntVect& ng = Bfield_fp[lev][idim]->nGrowVect();
-                auto pmf = std::make_unique<MultiFab>(Bfield_fp[lev][idim]->boxArray(),
-                                                                  dm, Bfield_fp[lev][idim]->nComp(), ng);
-                pmf->Redistribute(*Bfield_fp[lev][idim], 0, 0, Bfield_fp[lev][idim]->nComp(), ng);
-                Bfield_fp[lev][idim] = std::move(pmf);
-            }
-            {
-                const IntVect& ng = Efield_fp[lev][idim]->nGrowVect();
-                auto pmf = std::make_unique<MultiFab>(Efield_fp[lev][idim]->boxArray(),
-                                                      dm, Efield_fp[lev][idim]->nComp(), ng);
-                pmf->Redistribute(*Efield_fp[lev][idim], 0, 0, Efield_fp[lev][idim]->nComp(), ng);
-                Efield_fp[lev][idim] = std::move(pmf);
-            }
-            {
-                const IntVect& ng = current_fp[lev][idim]->nGrowVect();
-                auto pmf = std::make_unique<MultiFab>(current_fp[lev][idim]->boxArray(),
-                                                      dm, current_fp[lev][idim]->nComp(), ng);
-                current_fp[lev][idim] = std::move(pmf);
-            }
-            if (current_store[lev][idim])
-            {
-                const IntVect& ng = current_store[lev][idim]->nGrowVect();
-                auto pmf = std::make_unique<MultiFab>(current_store[lev][idim]->boxArray(),
-                                                      dm, current_store[lev][idim]->nComp(), ng);
-                // no need to redistribute
-                current_store[lev][idim] = std::move(pmf);
-            }
-        }
-
-        if (F_fp[lev] != nullptr) {
-            const IntVect& ng = F_fp[lev]->nGrowVect();
-            auto pmf = std::make_unique<MultiFab>(F_fp[lev]->boxArray(),
-                                                              dm, F_fp[lev]->nComp(), ng);
-            pmf->Redistribute(*F_fp[lev], 0, 0, F_fp[lev]->nComp(), ng);
-            F_fp[lev] = std::move(pmf);
-        }
-
-        if (rho_fp[lev] != nullptr) {
-            const int nc = rho_fp[lev]->nComp();
-            const IntVect& ng = rho_fp[lev]->nGrowVect();
-            auto pmf = std::make_unique<MultiFab>(rho_fp[lev]->boxArray(),
-                                                              dm, nc, ng);
-            rho_fp[lev] = std::move(pmf);
+            RemakeMultiFab(Bfield_fp[lev][idim], dm, true);
+            RemakeMultiFab(Efield_fp[lev][idim], dm, true);
+            RemakeMultiFab(Bfield_avg_fp[lev][idim], dm, true);
+            RemakeMultiFab(Efield_avg_fp[lev][idim], dm, true);
+            RemakeMultiFab(current_fp[lev][idim], dm, false);
+            RemakeMultiFab(current_store[lev][idim], dm, false);
+            RemakeMultiFab(current_fp_nodal[lev][idim], dm, false);
+            RemakeMultiFab(current_filtered_fp[lev][idim], dm, false);
         }
+        RemakeMultiFab(F_fp[lev], dm, true);
+        RemakeMultiFab(G_fp[lev], dm, true);
+        RemakeMultiFab(rho_fp[lev], dm, false);
 
 #ifdef WARPX_USE_PSATD
         if (maxwell_solver_id == MaxwellSolverAlgo::PSATD) {
             if (spectral_solver_fp[lev] != nullptr) {
+                // The spectral fields are temporary: free them before allocating the new ones
+                spectral_solver_fp[lev].reset();
                 // Get the cell-centered box
                 BoxArray realspace_ba = ba;   // Copy box
                 realspace_ba.enclosedCells(); // Make it cell-centered
@@ -253,20 +681,9 @@ WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const Distributi
         } else {
             for (int idim=0; idim < 3; ++idim)
             {
-                {
-                    const IntVect& ng = Bfield_aux[lev][idim]->nGrowVect();
-                    auto pmf = std::make_unique<MultiFab>(Bfield_aux[lev][idim]->boxArray(),
-                                                                      dm, Bfield_aux[lev][idim]->nComp(), ng);
-                    // pmf->Redistribute(*Bfield_aux[lev][idim], 0, 0, Bfield_aux[lev][idim]->nComp(), ng);
-                    Bfield_aux[lev][idim] = std::move(pmf);
-                }
-                {
-                    const IntVect& ng = Efield_aux[lev][idim]->nGrowVect();
-                    auto pmf = std::make_unique<MultiFab>(Efield_aux[lev][idim]->boxArray(),
-                                                                      dm, Efield_aux[lev][idim]->nComp(), ng);
-                    // pmf->Redistribute(*Efield_aux[lev][idim], 0, 0, Efield_aux[lev][idim]->nComp(), ng);
-                    Efield_aux[lev][idim] = std::move(pmf);
-                }
+                // the auxiliary fields are rebuilt from the fine and coarse patches
+                RemakeMultiFab(Bfield_aux[lev][idim], dm, false);
+                RemakeMultiFab(Efield_aux[lev][idim], dm, false);
             }
         }
 
@@ -274,47 +691,21 @@ WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const Distributi
         if (lev > 0) {
             for (int idim=0; idim < 3; ++idim)
             {
-                {
-                    const IntVect& ng = Bfield_cp[lev][idim]->nGrowVect();
-                    auto pmf = std::make_unique<MultiFab>(Bfield_cp[lev][idim]->boxArray(),
-                                                                      dm, Bfield_cp[lev][idim]->nComp(), ng);
-                    pmf->Redistribute(*Bfield_cp[lev][idim], 0, 0, Bfield_cp[lev][idim]->nComp(), ng);
-                    Bfield_cp[lev][idim] = std::move(pmf);
-                }
-                {
-                    const IntVect& ng = Efield_cp[lev][idim]->nGrowVect();
-                    auto pmf = std::make_unique<MultiFab>(Efield_cp[lev][idim]->boxArray(),
-                                                                      dm, Efield_cp[lev][idim]->nComp(), ng);
-                    pmf->Redistribute(*Efield_cp[lev][idim], 0, 0, Efield_cp[lev][idim]->nComp(), ng);
-                    Efield_cp[lev][idim] = std::move(pmf);
-                }
-                {
-                    const IntVect& ng = current_cp[lev][idim]->nGrowVect();
-                    auto pmf = std::make_unique<MultiFab>(current_cp[lev][idim]->boxArray(),
-                                                                       dm, current_cp[lev][idim]->nComp(), ng);
-                    current_cp[lev][idim] = std::move(pmf);
-                }
-            }
-
-            if (F_cp[lev] != nullptr) {
-                const IntVect& ng = F_cp[lev]->nGrowVect();
-                auto pmf = std::make_unique<MultiFab>(F_cp[lev]->boxArray(),
-                                                                  dm, F_cp[lev]->nComp(), ng);
-                pmf->Redistribute(*F_cp[lev], 0, 0, F_cp[lev]->nComp(), ng);
-                F_cp[lev] = std::move(pmf);
-            }
-
-            if (rho_cp[lev] != nullptr) {
-                const int nc = rho_cp[lev]->nComp();
-                const IntVect& ng = rho_cp[lev]->nGrowVect();
-                auto pmf  = std::make_unique<MultiFab>(rho_cp[lev]->boxArray(),
-                                                                  dm, nc, ng);
-                rho_cp[lev] = std::move(pmf);
+                RemakeMultiFab(Bfield_cp[lev][idim], dm, true);
+                RemakeMultiFab(Efield_cp[lev][idim], dm, true);
+                RemakeMultiFab(Bfield_avg_cp[lev][idim], dm, true);
+                RemakeMultiFab(Efield_avg_cp[lev][idim], dm, true);
+                RemakeMultiFab(current_cp[lev][idim], dm, false);
+                RemakeMultiFab(current_filtered_cp[lev][idim], dm, false);
             }
+            RemakeMultiFab(F_cp[lev], dm, true);
+            RemakeMultiFab(G_cp[lev], dm, true);
+            RemakeMultiFab(rho_cp[lev], dm, false);
 
 #ifdef WARPX_USE_PSATD
             if (maxwell_solver_id == MaxwellSolverAlgo::PSATD) {
                 if (spectral_solver_cp[lev] != nullptr) {
+                    spectral_solver_cp[lev].reset();
                     BoxArray cba = ba;
                     cba.coarsen(refRatio(lev-1));
                     std::array<Real,3> cdx = CellSize(lev-1);
@@ -350,59 +741,11 @@ WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const Distributi
         if (lev > 0 && (n_field_gather_buffer > 0 || n_current_deposition_buffer > 0)) {
             for (int idim=0; idim < 3; ++idim)
             {
-                if (Bfield_cax[lev][idim])
-                {
-                    const IntVect& ng = Bfield_cax[lev][idim]->nGrowVect();
-                    auto pmf = std::make_unique<MultiFab>(Bfield_cax[lev][idim]->boxArray(),
-                                                                      dm, Bfield_cax[lev][idim]->nComp(), ng);
-                    // pmf->ParallelCopy(*Bfield_cax[lev][idim], 0, 0, Bfield_cax[lev][idim]->nComp(), ng, ng);
-                    Bfield_cax[lev][idim] = std::move(pmf);
-                }
-                if (Efield_cax[lev][idim])
-                {
-                    const IntVect& ng = Efield_cax[lev][idim]->nGrowVect();
-                    auto pmf = std::make_unique<MultiFab>(Efield_cax[lev][idim]->boxArray(),
-                                                                      dm, Efield_cax[lev][idim]->nComp(), ng);
-                    // pmf->ParallelCopy(*Efield_cax[lev][idim], 0, 0, Efield_cax[lev][idim]->nComp(), ng, ng);
-                    Efield_cax[lev][idim] = std::move(pmf);
-                }
-                if (current_buf[lev][idim])
-                {
-                    const IntVect& ng = current_buf[lev][idim]->nGrowVect();
-                    auto pmf = std::make_unique<MultiFab>(current_buf[lev][idim]->boxArray(),
-                                                                      dm, current_buf[lev][idim]->nComp(), ng);
-                    // pmf->ParallelCopy(*current_buf[lev][idim], 0, 0, current_buf[lev][idim]->nComp(), ng, ng);
-                    current_buf[lev][idim] = std::move(pmf);
-                }
-            }
-            if (charge_buf[lev])
-            {
-                const IntVect& ng = charge_buf[lev]->nGrowVect();
-                auto pmf = std::make_unique<MultiFab>(charge_buf[lev]->boxArray(),
-                                                                  dm, charge_buf[lev]->nComp(), ng);
-                // pmf->ParallelCopy(*charge_buf[lev][idim], 0, 0, charge_buf[lev]->nComp(), ng, ng);
-                charge_buf[lev] = std::move(pmf);
-            }
-            if (current_buffer_masks[lev])
-            {
-                const IntVect& ng = current_buffer_masks[lev]->nGrowVect();
-                auto pmf = std::make_unique<iMultiFab>(current_buffer_masks[lev]->boxArray(),
-                                                                    dm, current_buffer_masks[lev]->nComp(), ng);
-                // we can avoid this since we immediately re-build the values via BuildBufferMasks()
-                // pmf->Redistribute(*current_buffer_masks[lev], 0, 0, current_buffer_masks[lev]->nComp(), ng);
-                current_buffer_masks[lev] = std::move(pmf);
-            }
-            if (gather_buffer_masks[lev])
-            {
-                const IntVect& ng = gather_buffer_masks[lev]->nGrowVect();
-                auto pmf = std::make_unique<iMultiFab>(gather_buffer_masks[lev]->boxArray(),
-                                                                    dm, gather_buffer_masks[lev]->nComp(), ng);
-                // we can avoid this since we immediately re-build the values via BuildBufferMasks()
-                // pmf->Redistribute(*gather_buffer_masks[lev], 0, 0, gather_buffer_masks[lev]->nComp(), ng);
-                gather_buffer_masks[lev] = std::move(pmf);
+                RemakeMultiFab(Bfield_cax[lev][idim], dm, false);
+                RemakeMultiFab(Efield_cax[lev][idim], dm, false);
+                RemakeMultiFab(current_buf[lev][idim], dm, false);
             }
-            if (current_buffer_masks[lev] || gather_buffer_masks[lev])
-                BuildBufferMasks();
+            RemakeMultiFab(charge_buf[lev], dm, false);
         }
 
         if (costs[lev] != nullptr)
@@ -414,13 +757,23 @@ WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const Distributi
                 (*costs[lev])[i] = 0.0;
                 setLoadBalanceEfficiency(lev, -1);
             }
+            for (auto& cb : m_costs_breakdown[lev]) {
+                cb = std::make_unique<LayoutData<Real>>(ba, dm);
+                for (int i : cb->IndexArray()) (*cb)[i] = 0.0;
+            }
         }
 
         SetDistributionMap(lev, dm);
 
+        // The buffer masks only depend on the grids: only the lists of the boxes
+        // that change rank are recomputed
+        BuildBufferMasks();
+
     } else
     {
-        amrex::Abort("RemakeLevel: to be implemented");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(finest_level == 0,
+            "RemakeLevel: changing the grids is only implemented without mesh refinement");
+        RemakeLevelNewGrids(lev, ba, dm);
     }
 
     // Re-initialize diagnostic functors that stores pointers to the user-requested fields at level, lev.
@@ -430,6 +783,205 @@ WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const Distributi
     // not needed yet
 }
 
+template <typename MultiFabType>
+void
+WarpX::RemakeMultiFab (std::unique_ptr<MultiFabType>& mf, const DistributionMapping& dm,
+                       const bool redistribute)
+{
+    if (mf == nullptr) return;
+    const BoxArray ba = mf->boxArray();
+    const int ncomp = mf->nComp();
+    const IntVect ng = mf->nGrowVect();
+    if (redistribute)
+    {
+        auto pmf = std::make_unique<MultiFabType>(ba, dm, ncomp, ng);
+        pmf->Redistribute(*mf, 0, 0, ncomp, ng);
+        // free the old data before the next field is allocated
+        mf = std::move(pmf);
+    }
+    else
+    {
+        // the data is not needed: free it first, so that its arena block can be reused
+        mf.reset();
+        mf = std::make_unique<MultiFabType>(ba, dm, ncomp, ng);
+    }
+}
+
+void
+WarpX::RemakeLevelNewGrids (int lev, const BoxArray& ba, const DistributionMapping& dm)
+{
+    WARPX_PROFILE("WarpX::RemakeLevelNewGrids()");
+
+    // Keep the fields on the old grids
+    std::array<std::unique_ptr<MultiFab>,3> old_E, old_B, old_E_avg, old_B_avg;
+    for (int idim = 0; idim < 3; ++idim) {
+        old_E[idim] = std::move(Efield_fp[lev][idim]);
+        old_B[idim] = std::move(Bfield_fp[lev][idim]);
+        old_E_avg[idim] = std::move(Efield_avg_fp[lev][idim]);
+        old_B_avg[idim] = std::move(Bfield_avg_fp[lev][idim]);
+    }
+    std::unique_ptr<MultiFab> old_F = std::move(F_fp[lev]);
+    std::unique_ptr<MultiFab> old_G = std::move(G_fp[lev]);
+    std::unique_ptr<PML> old_pml = std::move(pml[lev]);
+
+    // Allocate the data of the level on the new grids
+    ClearLevel(lev);
+    SetBoxArray(lev, ba);
+    SetDistributionMap(lev, dm);
+    AllocLevelData(lev, ba, dm);
+#ifdef AMREX_USE_EB
+    ComputeEdgeLengths();
+    ComputeFaceAreas();
+    ScaleEdges();
+    ScaleAreas();
+    ComputeEBTileClasses();
+    ComputeDistanceToEB();
+#endif
+    if (old_pml) {
+        InitPML();
+        pml[lev]->ComputePMLFactors(dt[lev]);
+    }
+
+    // Copy the fields (valid cells) to the new grids; the new grids cover the same domain
+    const auto copy_field = [] (MultiFab* dst, const MultiFab* src) {
+        if (!dst || !src) return;
+        dst->setVal(0.0);
+        WarpXCommUtil::ParallelCopy(*dst, *src, 0, 0, dst->nComp(), IntVect(0), IntVect(0));
+    };
+    for (int idim = 0; idim < 3; ++idim) {
+        copy_field(Efield_fp[lev][idim].get(), old_E[idim].get());
+        copy_field(Bfield_fp[lev][idim].get(), old_B[idim].get());
+        copy_field(Efield_avg_fp[lev][idim].get(), old_E_avg[idim].get());
+        copy_field(Bfield_avg_fp[lev][idim].get(), old_B_avg[idim].get());
+        current_fp[lev][idim]->setVal(0.0);
+    }
+    copy_field(F_fp[lev].get(), old_F.get());
+    copy_field(G_fp[lev].get(), old_G.get());
+    if (old_pml) {
+        // The PML grids change with the grids of the level, but cover the same region
+        const auto pml_E = pml[lev]->GetE_fp();
+        const auto pml_B = pml[lev]->GetB_fp();
+        const auto old_pml_E = old_pml->GetE_fp();
+        const auto old_pml_B = old_pml->GetB_fp();
+        for (int idim = 0; idim < 3; ++idim) {
+            copy_field(pml_E[idim], old_pml_E[idim]);
+            copy_field(pml_B[idim], old_pml_B[idim]);
+        }
+        copy_field(pml[lev]->GetF_fp(), old_pml->GetF_fp());
+        copy_field(pml[lev]->GetG_fp(), old_pml->GetG_fp());
+    }
+
+    // Fill the guard cells
+    FillBoundaryEB(lev, guard_cells.ng_alloc_EB, fft_do_time_averaging);
+    FillBoundaryF(lev, guard_cells.ng_alloc_F);
+    FillBoundaryG(lev, guard_cells.ng_alloc_G);
+}
+
+amrex::BoxArray
+WarpX::RechopBoxArray (int lev, const amrex::Vector<amrex::Real>& box_costs,
+                       amrex::Vector<amrex::Real>& new_costs) const
+{
+    const BoxArray& ba = boxArray(lev);
+    const int nboxes = static_cast<int>(ba.size());
+    Real total_cost = 0.0_rt;
+    for (const Real c : box_costs) total_cost += c;
+    const Real mean_cost_per_rank = total_cost/ParallelDescriptor::NProcs();
+    const Real split_cost = load_balance_rechop_split_threshold*mean_cost_per_rank;
+    const Real merge_cost = load_balance_rechop_merge_threshold*mean_cost_per_rank;
+    const IntVect& bf = blockingFactor(lev);
+    const IntVect& mgs = maxGridSize(lev);
+
+    // Split the expensive boxes in two, along their longest direction, as long as
+    // they remain multiple of the blocking factor (the cost is assumed uniform in each box)
+    bool changed = false;
+    std::vector<std::pair<Box,Real> > work;
+    for (int i = nboxes-1; i >= 0; --i) work.emplace_back(ba[i], box_costs[i]);
+    std::vector<std::pair<Box,Real> > split;
+    while (!work.empty())
+    {
+        const Box bx = work.back().first;
+        const Real cost = work.back().second;
+        work.pop_back();
+        int dir = -1;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            if (bx.length(idim) >= 2*bf[idim] && (dir < 0 || bx.length(idim) > bx.length(dir))) {
+                dir = idim;
+            }
+        }
+        if (cost <= split_cost || dir < 0) {
+            split.emplace_back(bx, cost);
+            continue;
+        }
+        const int cut = bx.smallEnd(dir) + (bx.length(dir)/bf[dir]/2)*bf[dir];
+        Box lo_half = bx;
+        Box hi_half = bx;
+        lo_half.setBig(dir, cut-1);
+        hi_half.setSmall(dir, cut);
+        const Real lo_fraction = static_cast<Real>(lo_half.numPts())/bx.numPts();
+        // Push the high half first, so that the order of the boxes is kept
+        work.emplace_back(hi_half, cost*(1.0_rt - lo_fraction));
+        work.emplace_back(lo_half, cost*lo_fraction);
+        changed = true;
+    }
+
+    // Merge the pairs of cheap neighboring boxes whose union is a box
+    BoxList bl;
+    new_costs.clear();
+    if (merge_cost > 0.0_rt)
+    {
+        BoxList split_bl;
+        for (const auto& p : split) split_bl.push_back(p.first);
+        const BoxArray split_ba(std::move(split_bl));
+        std::vector<int> merged(split.size(), 0);
+        std::vector<std::pair<int,Box> > isects;
+        for (int i = 0; i < static_cast<int>(split.size()); ++i)
+        {
+            if (merged[i]) continue;
+            const Box& bi = split[i].first;
+            for (int idim = 0; idim < AMREX_SPACEDIM && !merged[i]; ++idim)
+            {
+                // neighbors on the high side
+                split_ba.intersections(amrex::growHi(bi, idim, 1), isects);
+                for (const auto& is : isects)
+                {
+                    const int j = is.first;
+                    if (j == i || merged[j]) continue;
+                    const Box& bj = split[j].first;
+                    const Box bu = amrex::minBox(bi, bj);
+                    if (split[i].second + split[j].second < merge_cost
+                        && bu.numPts() == bi.numPts() + bj.numPts()
+                        && bu.length(idim) <= mgs[idim])
+                    {
+                        merged[i] = merged[j] = 1;
+                        bl.push_back(bu);
+                        new_costs.push_back(split[i].second + split[j].second);
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+            if (!merged[i]) {
+                merged[i] = 1;
+                bl.push_back(bi);
+                new_costs.push_back(split[i].second);
+            }
+        }
+    }
+    else
+    {
+        for (const auto& p : split) {
+            bl.push_back(p.first);
+            new_costs.push_back(p.second);
+        }
+    }
+
+    if (!changed) {
+        new_costs = box_costs;
+        return ba;
+    }
+    return BoxArray(std::move(bl));
+}
+
 void
 WarpX::ComputeCostsHeuristic (amrex::Vector<std::unique_ptr<amrex::LayoutData<amrex::Real> > >& a_costs)
 {
@@ -460,6 +1012,164 @@ WarpX::ComputeCostsHeuristic (amrex::Vector<std::unique_ptr<amrex::LayoutData<am
     }
 }
 
+amrex::Vector<amrex::Real>
+WarpX::MigrationBytes (int lev) const
+{
+    const int nboxes = costs[lev]->size();
+    Vector<Real> bytes(nboxes, 0.0_rt);
+
+    // Fields that are copied to the new distribution mapping (only on this rank's boxes)
+    const auto add_field_bytes = [&bytes] (const MultiFab* mf) {
+        if (!mf) return;
+        for (MFIter mfi(*mf); mfi.isValid(); ++mfi) {
+            bytes[mfi.index()] += static_cast<Real>(mfi.fabbox().numPts())
+                * mf->nComp() * sizeof(Real);
+        }
+    };
+    for (int idim = 0; idim < 3; ++idim) {
+        add_field_bytes(Efield_fp[lev][idim].get());
+        add_field_bytes(Bfield_fp[lev][idim].get());
+        add_field_bytes(Efield_avg_fp[lev][idim].get());
+        add_field_bytes(Bfield_avg_fp[lev][idim].get());
+        if (lev > 0) {
+            add_field_bytes(Efield_aux[lev][idim].get());
+            add_field_bytes(Bfield_aux[lev][idim].get());
+            add_field_bytes(Efield_cp[lev][idim].get());
+            add_field_bytes(Bfield_cp[lev][idim].get());
+        }
+    }
+    add_field_bytes(F_fp[lev].get());
+    add_field_bytes(G_fp[lev].get());
+
+    // Particles
+    for (int i_s = 0; i_s < mypc->nSpecies(); ++i_s) {
+        auto& pc = mypc->GetParticleContainer(i_s);
+        const Real particle_bytes = sizeof(WarpXParticleContainer::ParticleType)
+            + pc.NumRealComps()*sizeof(ParticleReal) + pc.NumIntComps()*sizeof(int);
+        for (WarpXParIter pti(pc, lev); pti.isValid(); ++pti) {
+            bytes[pti.index()] += particle_bytes*pti.numParticles();
+        }
+    }
+
+    return bytes;
+}
+
+void
+WarpX::PredictCosts (int lev, amrex::LayoutData<amrex::Real>& predicted_costs)
+{
+    const LayoutData<Real>& cost = *costs[lev];
+    const int nboxes = cost.size();
+
+    // Costs of the last interval, for all the boxes
+    Vector<Real> last_costs(nboxes, 0.0_rt);
+    for (int i : cost.IndexArray()) {
+        last_costs[i] = cost[i];
+    }
+    ParallelDescriptor::ReduceRealSum(last_costs.data(), nboxes);
+
+    // Update the history (identically on all ranks, so that it does not depend
+    // on the distribution mapping); it restarts when the grids change
+    Vector<Real>& level = m_costs_history_level[lev];
+    Vector<Real>& trend = m_costs_history_trend[lev];
+    if (m_costs_history_ba[lev] != cost.boxArray() ||
+        static_cast<int>(level.size()) != nboxes)
+    {
+        m_costs_history_ba[lev] = cost.boxArray();
+        level = last_costs;
+        trend.assign(nboxes, 0.0_rt);
+    }
+    else
+    {
+        const Real a = load_balance_costs_smoothing;
+        const Real b = load_balance_costs_trend_smoothing;
+        const bool extrapolate =
+            (load_balance_costs_prediction == LoadBalanceCostsPrediction::Extrapolation);
+        for (int i = 0; i < nboxes; ++i) {
+            const Real previous_level = level[i];
+            if (extrapolate) {
+                level[i] = a*last_costs[i] + (1.0_rt - a)*(previous_level + trend[i]);
+                trend[i] = b*(level[i] - previous_level) + (1.0_rt - b)*trend[i];
+            } else {
+                level[i] = a*last_costs[i] + (1.0_rt - a)*previous_level;
+            }
+        }
+    }
+
+    // Expected costs of the next interval: the smoothed costs, extrapolated by one interval
+    // (with the moving window, the fields move through the boxes, so that a cost front
+    // that moves at constant speed in the window gives a linear trend in each box)
+    for (int i : predicted_costs.IndexArray()) {
+        predicted_costs[i] = std::max(level[i] + trend[i], 0.0_rt);
+    }
+}
+
+void
+WarpX::CalibrateCostsHeuristic ()
+{
+    // Normal equations of the least-squares fit of the measured costs t of the boxes,
+    // with t = w_cell*n_cell + w_particle*n_particle
+    amrex::Vector<amrex::Real> sums(5, 0.0_rt); // ncell^2, ncell*npart, npart^2, ncell*t, npart*t
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        LayoutData<Real> nparticles(costs[lev]->boxArray(), costs[lev]->DistributionMap());
+        for (int i : nparticles.IndexArray()) nparticles[i] = 0.0_rt;
+        for (int i_s = 0; i_s < mypc->nSpecies(); ++i_s) {
+            auto& pc = mypc->GetParticleContainer(i_s);
+            for (WarpXParIter pti(pc, lev); pti.isValid(); ++pti) {
+                nparticles[pti.index()] += pti.numParticles();
+            }
+        }
+        MultiFab* Ex = Efield_fp[lev][0].get();
+        for (MFIter mfi(*Ex, false); mfi.isValid(); ++mfi)
+        {
+            const Real ncell = static_cast<Real>(mfi.growntilebox().numPts());
+            const Real npart = nparticles[mfi.index()];
+            const Real t = (*costs[lev])[mfi.index()];
+            sums[0] += ncell*ncell;
+            sums[1] += ncell*npart;
+            sums[2] += npart*npart;
+            sums[3] += ncell*t;
+            sums[4] += npart*t;
+        }
+    }
+    ParallelDescriptor::ReduceRealSum(sums.data(), sums.size());
+
+    Real cells_wt = 0.0_rt;
+    Real particles_wt = 0.0_rt;
+    const Real det = sums[0]*sums[2] - sums[1]*sums[1];
+    if (std::abs(det) > 1.e-12_rt*sums[0]*sums[2]) {
+        cells_wt = (sums[3]*sums[2] - sums[4]*sums[1])/det;
+        particles_wt = (sums[4]*sums[0] - sums[3]*sums[1])/det;
+    }
+    // Without enough information, or with a negative weight: fit one weight only,
+    // keeping the one that reduces most the residual
+    if (cells_wt <= 0.0_rt || particles_wt < 0.0_rt) {
+        const Real cells_only = (sums[0] > 0.0_rt) ? sums[3]*sums[3]/sums[0] : 0.0_rt;
+        const Real particles_only = (sums[2] > 0.0_rt) ? sums[4]*sums[4]/sums[2] : 0.0_rt;
+        cells_wt = 0.0_rt;
+        particles_wt = 0.0_rt;
+        if (particles_only > cells_only) {
+            particles_wt = std::max(sums[4]/sums[2], 0.0_rt);
+        } else if (sums[0] > 0.0_rt) {
+            cells_wt = std::max(sums[3]/sums[0], 0.0_rt);
+        }
+    }
+
+    // Only the ratio of the weights matters: normalize them as the default weights
+    if (cells_wt + particles_wt > 0.0_rt) {
+        costs_heuristic_cells_wt = cells_wt/(cells_wt + particles_wt);
+        costs_heuristic_particles_wt = particles_wt/(cells_wt + particles_wt);
+    }
+    amrex::Print() << "Calibrated the heuristic costs (after " << m_costs_calibration_nsteps
+                   << " steps): algo.costs_heuristic_cells_wt = " << costs_heuristic_cells_wt
+                   << ", algo.costs_heuristic_particles_wt = " << costs_heuristic_particles_wt
+                   << "\n";
+
+    m_costs_heuristic_calibrating = false;
+    WarpX::load_balance_costs_update_algo = LoadBalanceCostsUpdateAlgo::Heuristic;
+    ResetCosts();
+}
+
 void
 WarpX::ResetCosts ()
 {
@@ -471,5 +1181,8 @@ WarpX::ResetCosts ()
             // Reset costs
             (*costs[lev])[i] = 0.0;
         }
+        for (auto& cb : m_costs_breakdown[lev]) {
+            for (int i : iarr) (*cb)[i] = 0.0;
+        }
     }
 }
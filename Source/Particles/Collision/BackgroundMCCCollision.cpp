@@ -15,8 +15,11 @@
 
 #include <AMReX_ParmParse.H>
 #include <AMReX_REAL.H>
+#include <AMReX_Reduce.H>
 #include <AMReX_Vector.H>
 
+#include <algorithm>
+#include <cmath>
 #include <string>
 
 BackgroundMCCCollision::BackgroundMCCCollision (std::string const collision_name)
@@ -28,6 +31,7 @@ BackgroundMCCCollision::BackgroundMCCCollision (std::string const collision_name
     amrex::ParmParse pp_collision_name(collision_name);
 
     queryWithParser(pp_collision_name, "background_density", m_background_density);
+    pp_collision_name.query("per_tile_nu_max", m_per_tile_nu_max);
     queryWithParser(pp_collision_name, "background_temperature", m_background_temperature);
 
     // if the neutral mass is specified use it, but if ionization is
@@ -107,6 +111,40 @@ BackgroundMCCCollision::BackgroundMCCCollision (std::string const collision_name
         m_ionization_processes_exe.push_back(p.executor());
     }
 #endif
+
+    // if the scattering processes share their energy grid (e.g. a single data set for
+    // the gas), their cross-sections are interleaved in one table, so that the collision
+    // kernel does a single lookup for all of them
+    const int nprocesses = m_scattering_processes.size();
+    m_use_interleaved_sigmas = (nprocesses > 1);
+    for (auto const& p : m_scattering_processes) {
+        m_use_interleaved_sigmas = m_use_interleaved_sigmas &&
+            p.getGridSize() == m_scattering_processes[0].getGridSize() &&
+            p.getEnergyLo() == m_scattering_processes[0].getEnergyLo() &&
+            p.getEnergyHi() == m_scattering_processes[0].getEnergyHi();
+    }
+    if (m_use_interleaved_sigmas) {
+        const int grid_size = m_scattering_processes[0].getGridSize();
+        amrex::Gpu::HostVector<amrex::Real> h_sigmas(grid_size*nprocesses);
+        for (int i = 0; i < nprocesses; ++i) {
+            auto const& sigmas = m_scattering_processes[i].getSigmas();
+            for (int ie = 0; ie < grid_size; ++ie) {
+                h_sigmas[ie*nprocesses + i] = sigmas[ie];
+            }
+        }
+        m_interleaved_sigmas.resize(h_sigmas.size());
+        amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, h_sigmas.begin(), h_sigmas.end(),
+                              m_interleaved_sigmas.begin());
+        amrex::Gpu::streamSynchronize();
+
+        m_interleaved_exe.m_sigmas_data = m_interleaved_sigmas.data();
+        m_interleaved_exe.m_nprocesses = nprocesses;
+        m_interleaved_exe.m_grid_size = grid_size;
+        m_interleaved_exe.m_energy_lo = m_scattering_processes[0].getEnergyLo();
+        m_interleaved_exe.m_energy_hi = m_scattering_processes[0].getEnergyHi();
+        m_interleaved_exe.m_dE = (m_interleaved_exe.m_energy_hi - m_interleaved_exe.m_energy_lo)
+            / (grid_size - 1.);
+    }
 }
 
 /** Calculate the maximum collision frequency using a fixed energy grid that
@@ -114,11 +152,21 @@ BackgroundMCCCollision::BackgroundMCCCollision (std::string const collision_name
  */
 amrex::Real
 BackgroundMCCCollision::get_nu_max(amrex::Vector<MCCProcess> const& mcc_processes)
+{
+    return get_nu_max_table(mcc_processes).back();
+}
+
+/** Calculate, for each energy of the fixed energy grid used in get_nu_max,
+ *  the maximum collision frequency of the energies lower than or equal to it
+ */
+amrex::Vector<amrex::Real>
+BackgroundMCCCollision::get_nu_max_table(amrex::Vector<MCCProcess> const& mcc_processes)
 {
     using namespace amrex::literals;
     amrex::Real nu, nu_max = 0.0;
+    amrex::Vector<amrex::Real> nu_max_table;
 
-    for (double E = 1e-4; E < 5000; E+=0.2) {
+    for (double E = m_nu_table_energy_min; E < m_nu_table_energy_max; E+=m_nu_table_energy_step) {
         amrex::Real sigma_E = 0.0;
 
         // loop through all collision pathways
@@ -135,8 +183,9 @@ BackgroundMCCCollision::get_nu_max(amrex::Vector<MCCProcess> const& mcc_processe
         if (nu > nu_max) {
             nu_max = nu;
         }
+        nu_max_table.push_back(nu_max);
     }
-    return nu_max;
+    return nu_max_table;
 }
 
 void
@@ -197,6 +246,13 @@ BackgroundMCCCollision::doCollisions (amrex::Real cur_time, MultiParticleContain
             m_background_mass = species1.getMass();
         }
 
+        // the collision energy of light particles (e.g. electrons) is their kinetic
+        // energy, so that the maximum collision frequency in a tile can be bounded
+        // from the maximum kinetic energy of its particles
+        if (m_per_tile_nu_max && m_background_mass / m_mass1 > 1e3) {
+            m_nu_max_table = get_nu_max_table(m_scattering_processes);
+        }
+
         amrex::Print() <<
             "Setting up collisions for " << m_species_names[0] << " with total "
             "collision probability: " <<
@@ -250,6 +306,9 @@ void BackgroundMCCCollision::doBackgroundCollisionsWithinTile
     auto scattering_processes = m_scattering_processes_exe.data();
     int const process_count   = m_scattering_processes_exe.size();
 
+    bool const use_interleaved_sigmas = m_use_interleaved_sigmas;
+    MCCInterleavedCrossSections const interleaved_sigmas = m_interleaved_exe;
+
     amrex::Real total_collision_prob = m_total_collision_prob;
     amrex::Real nu_max = m_nu_max;
 
@@ -259,6 +318,33 @@ void BackgroundMCCCollision::doBackgroundCollisionsWithinTile
     amrex::ParticleReal* const AMREX_RESTRICT uy = attribs[PIdx::uy].dataPtr();
     amrex::ParticleReal* const AMREX_RESTRICT uz = attribs[PIdx::uz].dataPtr();
 
+    // use, as the maximum collision frequency, the maximum over the energies of the
+    // particles of this tile, instead of the maximum over all energies, in order to
+    // reduce the number of null collisions
+    if (!m_nu_max_table.empty() && np > 0) {
+        amrex::ReduceOps<amrex::ReduceOpMax> reduce_op;
+        amrex::ReduceData<amrex::ParticleReal> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+        reduce_op.eval(np, reduce_data,
+            [=] AMREX_GPU_DEVICE (long ip) -> ReduceTuple
+            {
+                return {ux[ip]*ux[ip] + uy[ip]*uy[ip] + uz[ip]*uz[ip]};
+            });
+        const amrex::Real v2_max = amrex::get<0>(reduce_data.value());
+        const amrex::Real E_max = 0.5_rt * mass1 * v2_max / PhysConst::q_e;
+
+        // index of the first energy of the grid above E_max (with one more point,
+        // to be on the safe side of the round-off errors)
+        const int n_table = m_nu_max_table.size();
+        const int i_table = std::min(n_table - 1, static_cast<int>(
+            std::max(0._rt, (E_max - m_nu_table_energy_min) / m_nu_table_energy_step)) + 2);
+        nu_max = m_nu_max_table[i_table];
+        if (nu_max <= 0._rt) return;
+
+        const amrex::Real dt = WarpX::GetInstance().getdt(0);
+        total_collision_prob = 1.0_rt - std::exp(-nu_max * dt);
+    }
+
     amrex::ParallelForRNG(np,
                           [=] AMREX_GPU_HOST_DEVICE (long ip, amrex::RandomEngine const& engine)
                           {
@@ -305,12 +391,22 @@ void BackgroundMCCCollision::doBackgroundCollisionsWithinTile
                               }
                               v_coll = sqrt(v_coll2);
 
+                              // interpolation on the common energy grid, done once for all
+                              // the collision pathways
+                              int idx_1 = 0, idx_2 = 0;
+                              amrex::Real weight = 0;
+                              if (use_interleaved_sigmas) {
+                                  interleaved_sigmas.getIndices(E_coll, idx_1, idx_2, weight);
+                              }
+
                               // loop through all collision pathways
                               for (int i = 0; i < process_count; i++) {
                                   auto const& scattering_process = *(scattering_processes + i);
 
                                   // get collision cross-section
-                                  sigma_E = scattering_process.getCrossSection(E_coll);
+                                  sigma_E = (use_interleaved_sigmas) ?
+                                      interleaved_sigmas.getCrossSection(idx_1, idx_2, weight, i) :
+                                      scattering_process.getCrossSection(E_coll);
 
                                   // calculate normalized collision frequency
                                   nu_i += n_a * sigma_E * v_coll / nu_max;
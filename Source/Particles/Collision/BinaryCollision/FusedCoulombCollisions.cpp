@@ -0,0 +1,249 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "FusedCoulombCollisions.H"
+
+#include "ElasticCollisionPerez.H"
+#include "ShuffleFisherYates.H"
+#include "Particles/MultiParticleContainer.H"
+#include "Utils/WarpXAlgorithmSelection.H"
+#include "Utils/WarpXConst.H"
+#include "Utils/WarpXUtil.H"
+#include "WarpX.H"
+
+#include <AMReX.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_GpuAtomic.H>
+#include <AMReX_GpuContainers.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_LayoutData.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Random.H>
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+
+FusedCoulombCollisions::FusedCoulombCollisions (
+    amrex::Vector<std::string> const& collision_names, CollisionBinsCache* bins_cache)
+    : m_bins_cache(bins_cache)
+{
+    using namespace amrex::literals;
+
+    for (auto const& collision_name : collision_names) {
+        amrex::ParmParse pp_collision_name(collision_name);
+        amrex::Vector<std::string> species_names;
+        pp_collision_name.getarr("species", species_names);
+        if(species_names.size() != 2)
+            amrex::Abort("Binary collision " + collision_name + " must have exactly two species.");
+
+        CollisionPair pair;
+        for (int i = 0; i < 2; ++i) {
+            auto it = std::find(m_species_names.begin(), m_species_names.end(), species_names[i]);
+            if (it == m_species_names.end()) {
+                m_species_names.push_back(species_names[i]);
+                it = m_species_names.end() - 1;
+            }
+            const int ispecies = static_cast<int>(std::distance(m_species_names.begin(), it));
+            if (i == 0) pair.species_1 = ispecies;
+            else pair.species_2 = ispecies;
+        }
+        // default Coulomb log, if < 0, will be computed automatically
+        pair.CoulombLog = -1.0_rt;
+        queryWithParser(pp_collision_name, "CoulombLog", pair.CoulombLog);
+        pair.non_relativistic = false;
+        pp_collision_name.query("non_relativistic", pair.non_relativistic);
+        // number of time steps between collisions
+        pair.ndt = 1;
+        queryWithParser(pp_collision_name, "ndt", pair.ndt);
+        m_pairs.push_back(pair);
+    }
+}
+
+void
+FusedCoulombCollisions::doCollisions (amrex::Real cur_time, MultiParticleContainer* mypc)
+{
+    if (m_pairs.empty()) return;
+
+    const amrex::Real dt = WarpX::GetInstance().getdt(0);
+    const int step = int(std::floor(cur_time/dt));
+
+    // Select the collisions that are performed at this step, and the species involved
+    const int n_species = m_species_names.size();
+    amrex::Vector<int> active_index(n_species, -1);
+    amrex::Vector<std::string> species_names;
+    amrex::Vector<WarpXParticleContainer*> species;
+    amrex::Vector<CollisionPair> pairs;
+    for (auto pair : m_pairs) {
+        if (step % pair.ndt != 0) continue;
+        for (int* ispecies : {&pair.species_1, &pair.species_2}) {
+            if (active_index[*ispecies] < 0) {
+                active_index[*ispecies] = species.size();
+                species_names.push_back(m_species_names[*ispecies]);
+                species.push_back(&mypc->GetParticleContainerFromName(m_species_names[*ispecies]));
+            }
+            *ispecies = active_index[*ispecies];
+        }
+        pairs.push_back(pair);
+    }
+    const int n_pairs = pairs.size();
+    if (n_pairs == 0) return;
+
+    amrex::Gpu::DeviceVector<CollisionPair> device_pairs(n_pairs);
+    amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, pairs.begin(), pairs.end(),
+                          device_pairs.begin());
+    amrex::Gpu::streamSynchronize();
+
+    // Enable tiling
+    amrex::MFItInfo info;
+    if (amrex::Gpu::notInLaunchRegion()) info.EnableTiling(species[0]->tile_size);
+
+    // Loop over refinement levels
+    for (int lev = 0; lev <= species[0]->finestLevel(); ++lev){
+
+        amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
+
+        // Loop over all grids/tiles at this level
+#ifdef AMREX_USE_OMP
+        info.SetDynamic(true);
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+        for (amrex::MFIter mfi = species[0]->MakeMFIter(lev, info); mfi.isValid(); ++mfi){
+            if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+            {
+                amrex::Gpu::synchronize();
+            }
+            amrex::Real wt = amrex::second();
+
+            doCollisionsWithinTile(lev, mfi, species_names, species,
+                                   device_pairs.dataPtr(), n_pairs);
+
+            if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+            {
+                amrex::Gpu::synchronize();
+                wt = amrex::second() - wt;
+                amrex::HostDevice::Atomic::Add( &(*cost)[mfi.index()], wt);
+                if (auto* cb = WarpX::getCostsBreakdown(lev, CostsPhase::Collide, species[0]->getSpeciesId())) {
+                    amrex::HostDevice::Atomic::Add( &(*cb)[mfi.index()], wt);
+                }
+            }
+        }
+    }
+}
+
+void
+FusedCoulombCollisions::doCollisionsWithinTile (
+    int const lev, amrex::MFIter const& mfi,
+    amrex::Vector<std::string> const& species_names,
+    amrex::Vector<WarpXParticleContainer*> const& species,
+    CollisionPair const* pairs, int const n_pairs)
+{
+    using namespace amrex::literals;
+
+    // Extract the low-level data of the particles of each species in this tile,
+    // and find the particles that are in each cell
+    const int n_species = species.size();
+    amrex::Vector<SpeciesTileData> species_data(n_species);
+    int n_cells = 0;
+    for (int i = 0; i < n_species; ++i) {
+        auto& ptile = species[i]->ParticlesAt(lev, mfi);
+        ParticleBins& bins = m_bins_cache->getBins(species_names[i], lev, mfi, ptile);
+        species_data[i].soa = ptile.getParticleTileData();
+        species_data[i].indices = bins.permutationPtr();
+        species_data[i].cell_offsets = bins.offsetsPtr();
+        species_data[i].q = species[i]->getCharge();
+        species_data[i].m = species[i]->getMass();
+        n_cells = bins.numBins();
+    }
+    amrex::Gpu::DeviceVector<SpeciesTileData> device_species_data(n_species);
+    amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, species_data.begin(), species_data.end(),
+                          device_species_data.begin());
+    SpeciesTileData const* AMREX_RESTRICT p_species = device_species_data.dataPtr();
+
+    const amrex::Real dt = WarpX::GetInstance().getdt(lev);
+    amrex::Geometry const& geom = WarpX::GetInstance().Geom(lev);
+#if defined WARPX_DIM_XZ
+    auto dV = geom.CellSize(0) * geom.CellSize(1);
+#elif defined WARPX_DIM_RZ
+    amrex::Box const& cbx = mfi.tilebox(amrex::IntVect::TheZeroVector()); //Cell-centered box
+    const auto lo = lbound(cbx);
+    const auto hi = ubound(cbx);
+    int const nz = hi.y-lo.y+1;
+    auto dr = geom.CellSize(0);
+    auto dz = geom.CellSize(1);
+#elif (AMREX_SPACEDIM == 3)
+    auto dV = geom.CellSize(0) * geom.CellSize(1) * geom.CellSize(2);
+#endif
+
+    // Loop over cells, and perform all the collisions in each cell
+    amrex::ParallelForRNG( n_cells,
+        [=] AMREX_GPU_DEVICE (int i_cell, amrex::RandomEngine const& engine) noexcept
+        {
+#if defined WARPX_DIM_RZ
+            int ri = (i_cell - i_cell%nz) / nz;
+            auto dV = MathConst::pi*(2.0_rt*ri+1.0_rt)*dr*dr*dz;
+#endif
+            for (int i_pair = 0; i_pair < n_pairs; ++i_pair) {
+                CollisionPair const& pair = pairs[i_pair];
+                SpeciesTileData const& s1 = p_species[pair.species_1];
+                SpeciesTileData const& s2 = p_species[pair.species_2];
+                // The particles from species1 that are in the cell `i_cell` are
+                // given by the `indices_1[cell_start_1:cell_stop_1]`
+                index_type const cell_start_1 = s1.cell_offsets[i_cell];
+                index_type const cell_stop_1  = s1.cell_offsets[i_cell+1];
+
+                if (pair.species_1 == pair.species_2) {
+                    // Do not collide if there is only one particle in the cell
+                    if ( cell_stop_1 - cell_start_1 <= 1 ) continue;
+                    index_type const cell_half_1 = (cell_start_1+cell_stop_1)/2;
+
+                    // shuffle
+                    ShuffleFisherYates(s1.indices, cell_start_1, cell_half_1, engine);
+                    if (pair.non_relativistic) {
+                        ElasticCollisionPerez<true>(
+                            cell_start_1, cell_half_1, cell_half_1, cell_stop_1,
+                            s1.indices, s1.indices, s1.soa, s1.soa,
+                            s1.q, s1.q, s1.m, s1.m, amrex::Real(-1.0), amrex::Real(-1.0),
+                            dt*pair.ndt, pair.CoulombLog, dV, engine );
+                    } else {
+                        ElasticCollisionPerez<false>(
+                            cell_start_1, cell_half_1, cell_half_1, cell_stop_1,
+                            s1.indices, s1.indices, s1.soa, s1.soa,
+                            s1.q, s1.q, s1.m, s1.m, amrex::Real(-1.0), amrex::Real(-1.0),
+                            dt*pair.ndt, pair.CoulombLog, dV, engine );
+                    }
+                } else {
+                    // Same for species 2
+                    index_type const cell_start_2 = s2.cell_offsets[i_cell];
+                    index_type const cell_stop_2  = s2.cell_offsets[i_cell+1];
+
+                    // Do not collide if one species is missing in the cell
+                    if ( cell_stop_1 - cell_start_1 < 1 ||
+                         cell_stop_2 - cell_start_2 < 1 ) continue;
+
+                    // shuffle
+                    ShuffleFisherYates(s1.indices, cell_start_1, cell_stop_1, engine);
+                    ShuffleFisherYates(s2.indices, cell_start_2, cell_stop_2, engine);
+                    if (pair.non_relativistic) {
+                        ElasticCollisionPerez<true>(
+                            cell_start_1, cell_stop_1, cell_start_2, cell_stop_2,
+                            s1.indices, s2.indices, s1.soa, s2.soa,
+                            s1.q, s2.q, s1.m, s2.m, amrex::Real(-1.0), amrex::Real(-1.0),
+                            dt*pair.ndt, pair.CoulombLog, dV, engine );
+                    } else {
+                        ElasticCollisionPerez<false>(
+                            cell_start_1, cell_stop_1, cell_start_2, cell_stop_2,
+                            s1.indices, s2.indices, s1.soa, s2.soa,
+                            s1.q, s2.q, s1.m, s2.m, amrex::Real(-1.0), amrex::Real(-1.0),
+                            dt*pair.ndt, pair.CoulombLog, dV, engine );
+                    }
+                }
+            }
+        }
+    );
+    amrex::Gpu::streamSynchronize();
+}
@@ -21,4 +21,18 @@ CollisionBase::CollisionBase (std::string collision_name)
     m_ndt = 1;
     queryWithParser(pp_collision_name, "ndt", m_ndt);
 
+    // shuffle the particles of each cell in parallel over the particles
+    // (by default, only on GPU, where one thread per cell is slow for dense cells)
+#ifdef AMREX_USE_GPU
+    m_parallel_shuffle = true;
+    m_parallel_cell_moments = true;
+#else
+    m_parallel_shuffle = false;
+    m_parallel_cell_moments = false;
+#endif
+    amrex::ParmParse pp_collisions("collisions");
+    pp_collisions.query("parallel_shuffle", m_parallel_shuffle);
+    // compute the densities and temperatures of the cells in parallel over the particles
+    pp_collisions.query("parallel_cell_moments", m_parallel_cell_moments);
+
 }
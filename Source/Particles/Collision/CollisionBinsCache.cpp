@@ -0,0 +1,31 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "CollisionBinsCache.H"
+
+#include "Utils/ParticleUtils.H"
+
+CollisionBinsCache::ParticleBins&
+CollisionBinsCache::getBins (std::string const& species_name, int lev, amrex::MFIter const& mfi,
+                             WarpXParticleContainer::ParticleTileType const& ptile)
+{
+    CachedBins* cached = nullptr;
+    // Tiles may be processed by different OpenMP threads: protect the map.
+    // (References to the elements of a std::map remain valid upon insertion.)
+#ifdef AMREX_USE_OMP
+#pragma omp critical (collision_bins_cache)
+#endif
+    {
+        cached = &m_bins[std::make_tuple(species_name, lev, mfi.index(), mfi.LocalTileIndex())];
+    }
+
+    const long np = ptile.numParticles();
+    if (cached->np != np) {
+        cached->bins = ParticleUtils::findParticlesInEachCell(lev, mfi, ptile);
+        cached->np = np;
+    }
+    return cached->bins;
+}
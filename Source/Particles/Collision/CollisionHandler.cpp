@@ -8,10 +8,12 @@
 
 #include "BackgroundMCCCollision.H"
 #include "Particles/Collision/BinaryCollision/BinaryCollision.H"
+#include "Particles/Collision/BinaryCollision/FusedCoulombCollisions.H"
 #include "Particles/Collision/BinaryCollision/NuclearFusionFunc.H"
 #include "Particles/Collision/BinaryCollision/ParticleCreationFunc.H"
 #include "Particles/Collision/BinaryCollision/PairWiseCoulombCollisionFunc.H"
 
+#include <AMReX_GpuDevice.H>
 #include <AMReX_ParmParse.H>
 
 #include <vector>
@@ -23,10 +25,14 @@ CollisionHandler::CollisionHandler(MultiParticleContainer const * const mypc)
     amrex::ParmParse pp_collisions("collisions");
     pp_collisions.queryarr("collision_names", collision_names);
 
+    // Whether to perform all the pairwise Coulomb collisions in a single kernel
+    bool fuse_coulomb_collisions = false;
+    pp_collisions.query("fuse_coulomb_collisions", fuse_coulomb_collisions);
+    amrex::Vector<std::string> fused_collision_names;
+
     // Create instances based on the collision type
     auto const ncollisions = collision_names.size();
     collision_types.resize(ncollisions);
-    allcollisions.resize(ncollisions);
     for (int i = 0; i < static_cast<int>(ncollisions); ++i) {
         amrex::ParmParse pp_collision_name(collision_names[i]);
 
@@ -36,25 +42,40 @@ CollisionHandler::CollisionHandler(MultiParticleContainer const * const mypc)
         pp_collision_name.query("type", type);
         collision_types[i] = type;
 
+        // The collisions with an adaptive number of steps between collisions are not fused
+        bool ndt_adaptive = false;
+        pp_collision_name.query("ndt_adaptive", ndt_adaptive);
+
+        if (type == "pairwisecoulomb" && fuse_coulomb_collisions && !ndt_adaptive) {
+            fused_collision_names.push_back(collision_names[i]);
+            continue;
+        }
+
         if (type == "pairwisecoulomb") {
-            allcollisions[i] =
+            allcollisions.push_back(
                std::make_unique<BinaryCollision<PairWiseCoulombCollisionFunc>>(
-                                                                        collision_names[i], mypc);
+                                                                        collision_names[i], mypc));
         }
         else if (type == "background_mcc") {
-            allcollisions[i] = std::make_unique<BackgroundMCCCollision>(collision_names[i]);
+            allcollisions.push_back(std::make_unique<BackgroundMCCCollision>(collision_names[i]));
         }
         else if (type == "nuclearfusion") {
-            allcollisions[i] =
+            allcollisions.push_back(
                std::make_unique<BinaryCollision<NuclearFusionFunc, ParticleCreationFunc>>(
-                                                                        collision_names[i], mypc);
+                                                                        collision_names[i], mypc));
         }
         else{
             amrex::Abort("Unknown collision type.");
         }
+        allcollisions.back()->setBinsCache(&m_bins_cache);
 
     }
 
+    if (!fused_collision_names.empty()) {
+        m_fused_coulomb_collisions = std::make_unique<FusedCoulombCollisions>(
+                                                    fused_collision_names, &m_bins_cache);
+    }
+
 }
 
 /** Perform all collisions
@@ -66,8 +87,18 @@ CollisionHandler::CollisionHandler(MultiParticleContainer const * const mypc)
 void CollisionHandler::doCollisions ( amrex::Real cur_time, MultiParticleContainer* mypc)
 {
 
+    // The fused pairwise Coulomb collisions are performed first
+    if (m_fused_coulomb_collisions) {
+        m_fused_coulomb_collisions->doCollisions(cur_time, mypc);
+    }
+
     for (auto& collision : allcollisions) {
         collision->doCollisions(cur_time, mypc);
     }
 
+    // The particles move before the next call: the bins are outdated
+    // (wait for the kernels that use them before freeing them)
+    amrex::Gpu::streamSynchronize();
+    m_bins_cache.clear();
+
 }
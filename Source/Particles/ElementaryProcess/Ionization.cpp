@@ -31,12 +31,20 @@ IonizationFilterFunc::IonizationFilterFunc (const WarpXParIter& a_pti, int lev,
                                             const amrex::Real* const AMREX_RESTRICT a_adk_power,
                                             int a_comp,
                                             int a_atomic_number,
-                                            int a_offset) noexcept
+                                            int a_offset,
+                                            int a_adk_table_npoints,
+                                            const amrex::Real* const AMREX_RESTRICT a_adk_log_rate_table,
+                                            const amrex::Real* const AMREX_RESTRICT a_adk_table_inv_field_min,
+                                            const amrex::Real* const AMREX_RESTRICT a_adk_table_inv_field_step_inv) noexcept
 {
     m_ionization_energies = a_ionization_energies;
     m_adk_prefactor = a_adk_prefactor;
     m_adk_exp_prefactor = a_adk_exp_prefactor;
     m_adk_power = a_adk_power;
+    m_adk_table_npoints = a_adk_table_npoints;
+    m_adk_log_rate_table = a_adk_log_rate_table;
+    m_adk_table_inv_field_min = a_adk_table_inv_field_min;
+    m_adk_table_inv_field_step_inv = a_adk_table_inv_field_step_inv;
     comp = a_comp;
     m_atomic_number = a_atomic_number;
 
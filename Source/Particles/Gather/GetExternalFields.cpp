@@ -26,9 +26,19 @@ GetExternalEField::GetExternalEField (const WarpXParIter& a_pti, int a_offset) n
         m_type = Parser;
         m_time = warpx.gett_new(a_pti.GetLevel());
         m_get_position = GetParticlePosition(a_pti, a_offset);
-        m_xfield_partparser = mypc.m_Ex_particle_parser->compile<4>();
-        m_yfield_partparser = mypc.m_Ey_particle_parser->compile<4>();
-        m_zfield_partparser = mypc.m_Ez_particle_parser->compile<4>();
+        m_xfield_partparser = mypc.m_E_particle_specialized[0];
+        m_yfield_partparser = mypc.m_E_particle_specialized[1];
+        m_zfield_partparser = mypc.m_E_particle_specialized[2];
+        if (!mypc.m_E_ext_table.empty())
+        {
+            m_type = Table;
+            m_table = mypc.m_E_ext_table.dataPtr();
+            for (int idim = 0; idim < 3; ++idim) {
+                m_table_lo[idim] = mypc.m_ext_table_lo[idim];
+                m_table_dxi[idim] = 1._rt/mypc.m_ext_table_dx[idim];
+                m_table_n[idim] = mypc.m_ext_table_n[idim];
+            }
+        }
     }
     else if (mypc.m_E_ext_particle_s=="repeated_plasma_lens")
     {
@@ -68,9 +78,19 @@ GetExternalBField::GetExternalBField (const WarpXParIter& a_pti, int a_offset) n
         m_type = Parser;
         m_time = warpx.gett_new(a_pti.GetLevel());
         m_get_position = GetParticlePosition(a_pti, a_offset);
-        m_xfield_partparser = mypc.m_Bx_particle_parser->compile<4>();
-        m_yfield_partparser = mypc.m_By_particle_parser->compile<4>();
-        m_zfield_partparser = mypc.m_Bz_particle_parser->compile<4>();
+        m_xfield_partparser = mypc.m_B_particle_specialized[0];
+        m_yfield_partparser = mypc.m_B_particle_specialized[1];
+        m_zfield_partparser = mypc.m_B_particle_specialized[2];
+        if (!mypc.m_B_ext_table.empty())
+        {
+            m_type = Table;
+            m_table = mypc.m_B_ext_table.dataPtr();
+            for (int idim = 0; idim < 3; ++idim) {
+                m_table_lo[idim] = mypc.m_ext_table_lo[idim];
+                m_table_dxi[idim] = 1._rt/mypc.m_ext_table_dx[idim];
+                m_table_n[idim] = mypc.m_ext_table_n[idim];
+            }
+        }
     }
     else if (mypc.m_B_ext_particle_s=="repeated_plasma_lens")
     {
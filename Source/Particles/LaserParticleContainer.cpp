@@ -225,6 +225,14 @@ LaserParticleContainer::LaserParticleContainer (AmrCore* amr_core, int ispecies,
     common_params.p_X = m_p_X;
     common_params.nvec = m_nvec;
     m_up_laser_profile->init(pp_laser_name, ParmParse{"my_constants"}, common_params);
+
+    Real emission_threshold = 0._rt;
+    queryWithParser(pp_laser_name, "emission_threshold", emission_threshold);
+    if (emission_threshold > 0._rt) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(emission_threshold < 1._rt,
+            m_laser_name + ".emission_threshold must be smaller than 1");
+        m_emission_end_time = m_up_laser_profile->emission_end_time(emission_threshold);
+    }
 }
 
 /* \brief Check if laser particles enter the box, and inject if necessary.
@@ -491,6 +499,16 @@ LaserParticleContainer::Evolve (int lev,
         t_lab = 1._rt/WarpX::gamma_boost*t + WarpX::beta_boost*m_Z0_lab/PhysConst::c;
     }
 
+    if (t_lab > m_emission_end_time) {
+        // The laser is emitted: the antenna is not needed anymore
+        amrex::Print() << "Laser " << m_laser_name << " emitted: removing its antenna\n";
+        for (int ilev = 0; ilev < numLevels(); ++ilev) {
+            GetParticles(ilev).clear();
+        }
+        m_enabled = false;
+        return;
+    }
+
     // Update laser profile
     m_up_laser_profile->update(t);
 
@@ -19,8 +19,10 @@
 #   include "Particles/ElementaryProcess/QEDPairGeneration.H"
 #   include "Particles/ElementaryProcess/QEDPhotonEmission.H"
 #endif
+#include "Particles/Deposition/CurrentDeposition.H"
 #include "Particles/LaserParticleContainer.H"
 #include "Particles/ParticleCreation/FilterCopyTransform.H"
+#include "Particles/ParticleCreation/ParticleTileCapacity.H"
 #ifdef WARPX_QED
 #   include "Particles/ParticleCreation/FilterCreateTransformFromFAB.H"
 #endif
@@ -33,7 +35,10 @@
 #include "Particles/WarpXParticleContainer.H"
 #include "SpeciesPhysicalProperties.H"
 #include "Utils/WarpXAlgorithmSelection.H"
+#include "Utils/WarpXConst.H"
+#include "Utils/WarpXPhaseTimers.H"
 #include "Utils/WarpXProfilerWrapper.H"
+#include "Utils/WarpXUtil.H"
 #ifdef AMREX_USE_EB
 #   include "EmbeddedBoundary/ParticleScraper.H"
 #   include "EmbeddedBoundary/ParticleBoundaryProcess.H"
@@ -50,15 +55,18 @@
 #include <AMReX_FabArray.H>
 #include <AMReX_Geometry.H>
 #include <AMReX_GpuAtomic.H>
+#include <AMReX_GpuContainers.H>
 #include <AMReX_GpuDevice.H>
 #include <AMReX_IntVect.H>
 #include <AMReX_LayoutData.H>
 #include <AMReX_MultiFab.H>
 #include <AMReX_PODVector.H>
+#include <AMReX_Reduce.H>
 #include <AMReX_ParIter.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_ParticleTile.H>
+#include <AMReX_ParticleUtil.H>
 #include <AMReX_Particles.H>
 #include <AMReX_Print.H>
 #include <AMReX_StructOfArrays.H>
@@ -66,9 +74,15 @@
 #include <AMReX_Vector.H>
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
 #include <limits>
 #include <map>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -82,6 +96,82 @@ namespace
     {
         Array4< amrex::Real const > const Ex, Ey, Ez, Bx, By, Bz;
     };
+
+#ifdef WARPX_QED
+    /** \brief Whether at least one particle of the tile `ptile` has a negative
+     *  optical depth (runtime real component `opt_depth_runtime_comp`), i.e.
+     *  whether the QED event filter can select any particle of this tile.
+     *  The optical depth of a particle only decreases when its chi parameter
+     *  is above the minimum chi of the lookup tables, so this is false for the
+     *  (usually many) tiles in which no particle reaches it.
+     */
+    bool HasQEDEventCandidates (WarpXParticleContainer::ParticleTileType& ptile,
+                                int const opt_depth_runtime_comp)
+    {
+        const auto np = ptile.numParticles();
+        if (np == 0) return false;
+
+        const auto ptd = ptile.getParticleTileData();
+        ReduceOps<ReduceOpMin> reduce_op;
+        ReduceData<ParticleReal> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+        reduce_op.eval(np, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i) -> ReduceTuple
+            {
+                return {ptd.m_runtime_rdata[opt_depth_runtime_comp][i]};
+            });
+        return amrex::get<0>(reduce_data.value()) < ParticleReal(0.);
+    }
+
+    /** \brief Name of the file of the cache directory `cache_dir` in which the
+     *  QED lookup table of type `table_type`, whose parameters are described by
+     *  `table_params`, is stored. The name contains a hash of the type and
+     *  parameters of the table, and of the floating point precision, so that
+     *  tables with different parameters are stored in different files.
+     */
+    std::string QEDTableCacheFileName (std::string const& cache_dir,
+                                       std::string const& table_type,
+                                       std::string const& table_params)
+    {
+        std::string const key = table_type + ";" + std::to_string(sizeof(amrex::Real)) +
+            ";" + table_params;
+        // 64-bit FNV-1a hash
+        std::uint64_t hash = UINT64_C(0xcbf29ce484222325);
+        for (char const c : key) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= UINT64_C(0x100000001b3);
+        }
+        std::ostringstream file_name;
+        file_name << cache_dir << "/" << table_type << "_table_"
+                  << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+        return file_name.str();
+    }
+
+    /** \brief Whether the file `file_name` exists (checked by the I/O processor) */
+    bool FileExistsOnIOProcessor (std::string const& file_name)
+    {
+        int exists = 0;
+        if (ParallelDescriptor::IOProcessor()) exists = amrex::FileExists(file_name);
+        ParallelDescriptor::Bcast(&exists, 1, ParallelDescriptor::IOProcessorNumber());
+        return exists != 0;
+    }
+
+    /** \brief Store the table data `data` in the file `file_name` of the cache
+     *  directory `cache_dir`. The data is first written in a temporary file,
+     *  so that other simulations never read a partially written table.
+     */
+    void WriteQEDTableInCache (std::string const& cache_dir, std::string const& file_name,
+                               Vector<char> const& data)
+    {
+        if (!amrex::UtilCreateDirectory(cache_dir, 0755)) {
+            amrex::CreateDirectoryFailed(cache_dir);
+        }
+        std::string const tmp_file_name = file_name + ".tmp" + std::to_string(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+        WarpXUtilIO::WriteBinaryDataOnFile(tmp_file_name, data);
+        std::rename(tmp_file_name.c_str(), file_name.c_str());
+    }
+#endif
 }
 
 MultiParticleContainer::MultiParticleContainer (AmrCore* amr_core)
@@ -140,6 +230,8 @@ MultiParticleContainer::ReadParameters ()
     {
         ParmParse pp_particles("particles");
 
+        ParticleTileCapacity::ReadParameters();
+
         // allocating and initializing default values of external fields for particles
         m_E_external_particle.resize(3);
         m_B_external_particle.resize(3);
@@ -196,6 +288,12 @@ MultiParticleContainer::ReadParameters ()
                                     makeParser(str_By_ext_particle_function,{"x","y","z","t"}));
            m_Bz_particle_parser = std::make_unique<amrex::Parser>(
                                     makeParser(str_Bz_ext_particle_function,{"x","y","z","t"}));
+           m_B_particle_specialized[0] = compileSpecializedParser<4>(*m_Bx_particle_parser,
+                                    str_Bx_ext_particle_function, {"x","y","z","t"});
+           m_B_particle_specialized[1] = compileSpecializedParser<4>(*m_By_particle_parser,
+                                    str_By_ext_particle_function, {"x","y","z","t"});
+           m_B_particle_specialized[2] = compileSpecializedParser<4>(*m_Bz_particle_parser,
+                                    str_Bz_ext_particle_function, {"x","y","z","t"});
 
         }
 
@@ -221,9 +319,42 @@ MultiParticleContainer::ReadParameters ()
                                     makeParser(str_Ey_ext_particle_function,{"x","y","z","t"}));
            m_Ez_particle_parser = std::make_unique<amrex::Parser>(
                                     makeParser(str_Ez_ext_particle_function,{"x","y","z","t"}));
+           m_E_particle_specialized[0] = compileSpecializedParser<4>(*m_Ex_particle_parser,
+                                    str_Ex_ext_particle_function, {"x","y","z","t"});
+           m_E_particle_specialized[1] = compileSpecializedParser<4>(*m_Ey_particle_parser,
+                                    str_Ey_ext_particle_function, {"x","y","z","t"});
+           m_E_particle_specialized[2] = compileSpecializedParser<4>(*m_Ez_particle_parser,
+                                    str_Ez_ext_particle_function, {"x","y","z","t"});
 
         }
 
+        // the parsed external fields can be tabulated on a grid, on which they
+        // are interpolated at the positions of the particles
+        pp_particles.query("ext_particle_table", m_use_ext_particle_table);
+        if (m_use_ext_particle_table) {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                m_E_ext_particle_s == "parse_e_ext_particle_function" ||
+                m_B_ext_particle_s == "parse_b_ext_particle_function",
+                "particles.ext_particle_table requires a parsed external field on the particles");
+            amrex::Vector<amrex::Real> table_lo, table_hi;
+            amrex::Vector<int> table_n;
+            getArrWithParser(pp_particles, "ext_particle_table_lo", table_lo, 0, 3);
+            getArrWithParser(pp_particles, "ext_particle_table_hi", table_hi, 0, 3);
+            getArrWithParser(pp_particles, "ext_particle_table_n", table_n, 0, 3);
+            queryWithParser(pp_particles, "ext_particle_table_refresh_period", m_ext_table_refresh_period);
+            for (int idim = 0; idim < 3; ++idim) {
+                AMREX_ALWAYS_ASSERT_WITH_MESSAGE(table_n[idim] >= 1,
+                    "particles.ext_particle_table_n must be at least 1 in each direction");
+                m_ext_table_n[idim] = table_n[idim];
+                m_ext_table_lo[idim] = table_lo[idim];
+                if (table_n[idim] > 1) {
+                    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(table_hi[idim] > table_lo[idim],
+                        "particles.ext_particle_table_hi must be larger than particles.ext_particle_table_lo");
+                    m_ext_table_dx[idim] = (table_hi[idim] - table_lo[idim]) / (table_n[idim] - 1);
+                }
+            }
+        }
+
         // if the input string for E_ext_particle_s or B_ext_particle_s is
         // "repeated_plasma_lens" then the plasma lens properties
         // must be provided in the input file.
@@ -353,6 +484,16 @@ MultiParticleContainer::ReadParameters ()
 
         }
         pp_particles.query("use_fdtd_nci_corr", WarpX::use_fdtd_nci_corr);
+        pp_particles.query("nci_corr_in_gather", WarpX::nci_corr_in_gather);
+        pp_particles.query("do_concurrent_push", m_do_concurrent_push);
+        pp_particles.query("redistribute_max_migrants", m_redistribute_max_migrants);
+        pp_particles.query("redistribute_staging_cells", m_redistribute_staging_cells);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_redistribute_staging_cells >= 0,
+            "particles.redistribute_staging_cells must be non-negative");
+        if (m_redistribute_max_migrants > 0) {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_redistribute_staging_cells > 0,
+                "particles.redistribute_max_migrants requires particles.redistribute_staging_cells > 0");
+        }
 #ifdef WARPX_DIM_RZ
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE(WarpX::use_fdtd_nci_corr==0,
                             "ERROR: use_fdtd_nci_corr is not supported in RZ");
@@ -374,6 +515,8 @@ MultiParticleContainer::ReadParameters ()
 #endif
             queryWithParser(pp_qed_schwinger, "threshold_poisson_gaussian",
                                               m_qed_schwinger_threshold_poisson_gaussian);
+            queryWithParser(pp_qed_schwinger, "min_field_fraction",
+                                              m_qed_schwinger_min_field_fraction);
             queryWithParser(pp_qed_schwinger, "xmin", m_qed_schwinger_xmin);
             queryWithParser(pp_qed_schwinger, "xmax", m_qed_schwinger_xmax);
 #if (AMREX_SPACEDIM == 3)
@@ -417,6 +560,66 @@ MultiParticleContainer::InitData ()
 
 }
 
+namespace
+{
+    /** \brief Evaluate the 3 components of a parsed field at time t on the points of the table */
+    void TabulateExternalField (Gpu::DeviceVector<Real>& table,
+                                ParserExecutor<4> const& fx, ParserExecutor<4> const& fy,
+                                ParserExecutor<4> const& fz,
+                                const Array<Real, 3>& lo, const Array<Real, 3>& d,
+                                const Array<int, 3>& n, Real t)
+    {
+        const int nx = n[0];
+        const int ny = n[1];
+        const int npts = nx*ny*n[2];
+        const Real xlo = lo[0];
+        const Real ylo = lo[1];
+        const Real zlo = lo[2];
+        const Real dx = d[0];
+        const Real dy = d[1];
+        const Real dz = d[2];
+        table.resize(3*npts);
+        Real* AMREX_RESTRICT tab = table.dataPtr();
+        amrex::ParallelFor(npts, [=] AMREX_GPU_DEVICE (int ip) noexcept
+        {
+            const int i = ip % nx;
+            const int j = (ip / nx) % ny;
+            const int k = ip / (nx*ny);
+            const Real x = xlo + i*dx;
+            const Real y = ylo + j*dy;
+            const Real z = zlo + k*dz;
+            tab[ip] = fx(x, y, z, t);
+            tab[ip + npts] = fy(x, y, z, t);
+            tab[ip + 2*npts] = fz(x, y, z, t);
+        });
+    }
+}
+
+void
+MultiParticleContainer::UpdateExternalFieldTables (Real t)
+{
+    if (!m_use_ext_particle_table) return;
+    // A negative refresh period means that the tables are only computed once
+    if (!m_E_ext_table.empty() || !m_B_ext_table.empty()) {
+        if (m_ext_table_refresh_period < 0._rt || t == m_ext_table_time ||
+            t - m_ext_table_time < m_ext_table_refresh_period) return;
+    }
+    BL_PROFILE("MultiParticleContainer::UpdateExternalFieldTables");
+    m_ext_table_time = t;
+
+    if (m_E_ext_particle_s == "parse_e_ext_particle_function") {
+        TabulateExternalField(m_E_ext_table, m_Ex_particle_parser->compile<4>(),
+                              m_Ey_particle_parser->compile<4>(), m_Ez_particle_parser->compile<4>(),
+                              m_ext_table_lo, m_ext_table_dx, m_ext_table_n, t);
+    }
+    if (m_B_ext_particle_s == "parse_b_ext_particle_function") {
+        TabulateExternalField(m_B_ext_table, m_Bx_particle_parser->compile<4>(),
+                              m_By_particle_parser->compile<4>(), m_Bz_particle_parser->compile<4>(),
+                              m_ext_table_lo, m_ext_table_dx, m_ext_table_n, t);
+    }
+    Gpu::synchronize();
+}
+
 void
 MultiParticleContainer::Evolve (int lev,
                                 const MultiFab& Ex, const MultiFab& Ey, const MultiFab& Ez,
@@ -426,8 +629,13 @@ MultiParticleContainer::Evolve (int lev,
                                 MultiFab* rho, MultiFab* crho,
                                 const MultiFab* cEx, const MultiFab* cEy, const MultiFab* cEz,
                                 const MultiFab* cBx, const MultiFab* cBy, const MultiFab* cBz,
-                                Real t, Real dt, DtType a_dt_type, bool skip_deposition)
+                                Real t, Real dt, DtType a_dt_type, bool skip_deposition,
+                                const std::function<void()>& finish_fill_boundary,
+                                IntVect ng_gather)
 {
+    WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::Push);
+    UpdateExternalFieldTables(t);
+
     if (! skip_deposition) {
         jx.setVal(0.0);
         jy.setVal(0.0);
@@ -438,10 +646,35 @@ MultiParticleContainer::Evolve (int lev,
         if (rho) rho->setVal(0.0);
         if (crho) crho->setVal(0.0);
     }
+    if (finish_fill_boundary) {
+        // Push the particles that do not need the guard cells of the fields,
+        // while these guard cells are being exchanged
+        for (auto& pc : allcontainers) {
+            pc->PushInteriorParticles(lev, Ex, Ey, Ez, Bx, By, Bz, rho, dt, a_dt_type,
+                                      skip_deposition, ng_gather);
+        }
+        finish_fill_boundary();
+    }
+
+    // The kernels of the different species (and of the tiles of a species, which are
+    // launched on several GPU streams) can run concurrently: the deposition in J is done
+    // with atomics, and the device is only synchronized once all the species are pushed,
+    // instead of at the end of the loop over the tiles of each species.
+    // Particle splitting and the back-transformed diagnostics need the synchronizations.
+    bool concurrent_push = m_do_concurrent_push;
+    for (auto& pc : allcontainers) {
+        if (pc->do_splitting || (WarpX::do_back_transformed_diagnostics &&
+                                 pc->doBackTransformedDiagnostics())) {
+            concurrent_push = false;
+        }
+    }
+    const bool prev_no_sync = amrex::Gpu::setNoSyncRegion(concurrent_push || amrex::Gpu::inNoSyncRegion());
     for (auto& pc : allcontainers) {
         pc->Evolve(lev, Ex, Ey, Ez, Bx, By, Bz, jx, jy, jz, cjx, cjy, cjz,
                    rho, crho, cEx, cEy, cEz, cBx, cBy, cBz, t, dt, a_dt_type, skip_deposition);
     }
+    amrex::Gpu::setNoSyncRegion(prev_no_sync);
+    if (concurrent_push) amrex::Gpu::synchronize();
 }
 
 void
@@ -490,10 +723,21 @@ MultiParticleContainer::DepositCurrent (
         J[lev][2]->setVal(0.0, J[lev][2]->nGrowVect());
     }
 
-    // Call the deposition kernel for each species
-    for (auto& pc : allcontainers)
-    {
-        pc->DepositCurrent(J, dt, relative_t);
+    // On GPU, the direct deposition of all species can be done with one kernel launch per box
+    bool do_batched_deposition = false;
+#ifdef AMREX_USE_GPU
+    do_batched_deposition = WarpX::do_batched_deposition &&
+        (WarpX::current_deposition_algo == CurrentDepositionAlgo::Direct);
+#endif
+
+    if (do_batched_deposition) {
+        DepositCurrentBatched(J, dt, relative_t);
+    } else {
+        // Call the deposition kernel for each species
+        for (auto& pc : allcontainers)
+        {
+            pc->DepositCurrent(J, dt, relative_t);
+        }
     }
 
 #ifdef WARPX_DIM_RZ
@@ -504,6 +748,80 @@ MultiParticleContainer::DepositCurrent (
 #endif
 }
 
+void
+MultiParticleContainer::DepositCurrentBatched (
+    amrex::Vector<std::array< std::unique_ptr<amrex::MultiFab>, 3 > >& J,
+    const amrex::Real dt, const amrex::Real relative_t)
+{
+    WARPX_PROFILE("MultiParticleContainer::DepositCurrentBatched()");
+
+    int const finest_level = J.size() - 1;
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        // Descriptors of the particles of all species, for each (grid, tile) index
+        std::map<std::pair<int,int>, amrex::Vector<CurrentDepositionSpecies> > tile_species;
+        for (auto& pc : allcontainers)
+        {
+            pc->GetCurrentDepositionSpecies(lev, dt, *J[lev][0], tile_species);
+        }
+
+        const std::array<Real,3>& dx = WarpX::CellSize(lev);
+        const amrex::IntVect& ng_J = WarpX::GetInstance().get_ng_depos_J();
+        amrex::LayoutData<amrex::Real> * const costs = WarpX::getCosts(lev);
+
+        for (auto& kv : tile_species)
+        {
+            const int grid_index = kv.first.first;
+            const amrex::Vector<CurrentDepositionSpecies>& h_species = kv.second;
+            const int nspecies = static_cast<int>(h_species.size());
+
+            // Index of the first particle of each species in the batch
+            amrex::Vector<long> h_species_start(nspecies+1, 0);
+            for (int is = 0; is < nspecies; ++is) {
+                h_species_start[is+1] = h_species_start[is] + h_species[is].np;
+            }
+
+            amrex::Gpu::DeviceVector<CurrentDepositionSpecies> d_species(nspecies);
+            amrex::Gpu::DeviceVector<long> d_species_start(nspecies+1);
+            amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, h_species.begin(), h_species.end(),
+                                  d_species.begin());
+            amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, h_species_start.begin(),
+                                  h_species_start.end(), d_species_start.begin());
+
+            // GPU, no tiling: the tile box is the valid box of the grid
+            Box tilebox = amrex::enclosedCells(J[lev][0]->boxArray()[grid_index]);
+            tilebox.grow(ng_J);
+            const Dim3 lo = lbound(tilebox);
+
+            amrex::Real * const cost = costs ? &((*costs)[grid_index]) : nullptr;
+
+            auto& jx_fab = (*J[lev][0])[grid_index];
+            auto& jy_fab = (*J[lev][1])[grid_index];
+            auto& jz_fab = (*J[lev][2])[grid_index];
+            const long np_total = h_species_start[nspecies];
+
+            if        (WarpX::nox == 1){
+                doDepositionBatchedShapeN<1>(
+                    d_species.dataPtr(), d_species_start.dataPtr(), nspecies, np_total,
+                    jx_fab, jy_fab, jz_fab, relative_t, dx, lo, WarpX::n_rz_azimuthal_modes,
+                    cost, WarpX::load_balance_costs_update_algo);
+            } else if (WarpX::nox == 2){
+                doDepositionBatchedShapeN<2>(
+                    d_species.dataPtr(), d_species_start.dataPtr(), nspecies, np_total,
+                    jx_fab, jy_fab, jz_fab, relative_t, dx, lo, WarpX::n_rz_azimuthal_modes,
+                    cost, WarpX::load_balance_costs_update_algo);
+            } else if (WarpX::nox == 3){
+                doDepositionBatchedShapeN<3>(
+                    d_species.dataPtr(), d_species_start.dataPtr(), nspecies, np_total,
+                    jx_fab, jy_fab, jz_fab, relative_t, dx, lo, WarpX::n_rz_azimuthal_modes,
+                    cost, WarpX::load_balance_costs_update_algo);
+            }
+            // The descriptors must stay alive until the kernel is done
+            amrex::Gpu::streamSynchronize();
+        }
+    }
+}
+
 void
 MultiParticleContainer::DepositCharge (
     amrex::Vector<std::unique_ptr<amrex::MultiFab> >& rho,
@@ -566,6 +884,15 @@ MultiParticleContainer::GetChargeDensity (int lev, bool local)
 void
 MultiParticleContainer::SortParticlesByBin (amrex::IntVect bin_size)
 {
+    // The bins only cover the valid boxes: the staged particles are sent first
+    if (m_num_staged > 0) {
+        WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::Comm);
+        for (auto& pc : allcontainers) {
+            pc->Redistribute(0, 0, 0, m_redistribute_num_ghost);
+        }
+        m_num_migrated += m_num_staged;
+        m_num_staged = 0;
+    }
     for (auto& pc : allcontainers) {
         pc->SortParticlesByBin(bin_size);
     }
@@ -574,6 +901,7 @@ MultiParticleContainer::SortParticlesByBin (amrex::IntVect bin_size)
 void
 MultiParticleContainer::Redistribute ()
 {
+    WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::Comm);
     for (auto& pc : allcontainers) {
         pc->Redistribute();
     }
@@ -587,12 +915,59 @@ MultiParticleContainer::defineAllParticleTiles ()
     }
 }
 
+void
+MultiParticleContainer::SetParticleTileSize (const amrex::IntVect& tile_size)
+{
+    for (auto& pc : allcontainers) {
+        pc->tile_size = tile_size;
+    }
+    // The tile of each particle is recomputed with the new tile size
+    Redistribute();
+    defineAllParticleTiles();
+}
+
 void
 MultiParticleContainer::RedistributeLocal (const int num_ghost)
 {
+    WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::Comm);
+    if (m_redistribute_max_migrants <= 0) {
+        for (auto& pc : allcontainers) {
+            pc->Redistribute(0, 0, 0, num_ghost);
+        }
+        return;
+    }
+
+    // The staged particles can be up to m_redistribute_staging_cells further away
+    m_redistribute_num_ghost = num_ghost + m_redistribute_staging_cells;
+
+    // Number of particles out of their box, over all the ranks (so that they all take the
+    // same decision)
+    amrex::Long num_out = 0;
+    for (auto& pc : allcontainers) {
+        num_out += amrex::numParticlesOutOfRange(*pc, 0);
+    }
+
+    const bool stage = (num_out > m_redistribute_max_migrants);
+    const int ngrow = stage ? m_redistribute_staging_cells : 0;
+    m_num_staged = 0;
     for (auto& pc : allcontainers) {
-        pc->Redistribute(0, 0, 0, num_ghost);
+        pc->Redistribute(0, 0, ngrow, m_redistribute_num_ghost);
+        if (stage) m_num_staged += amrex::numParticlesOutOfRange(*pc, 0);
     }
+    m_num_migrated = num_out - m_num_staged;
+}
+
+amrex::Vector<amrex::Real>
+MultiParticleContainer::EstimateInitialParticles (const amrex::BoxArray& ba,
+                                                  const amrex::Geometry& geom,
+                                                  int sampling) const
+{
+    amrex::Vector<amrex::Real> nparticles(ba.size(), 0._rt);
+    for (auto const& pc : allcontainers) {
+        pc->EstimateInitialParticles(ba, geom, sampling, nparticles);
+    }
+    amrex::ParallelDescriptor::ReduceRealSum(nparticles.data(), static_cast<int>(nparticles.size()));
+    return nparticles;
 }
 
 void
@@ -613,7 +988,7 @@ MultiParticleContainer::GetZeroParticlesInGrid (const int lev) const
 }
 
 Vector<Long>
-MultiParticleContainer::NumberOfParticlesInGrid (int lev) const
+MultiParticleContainer::NumberOfParticlesInGrid (int lev, bool only_valid, bool only_local) const
 {
     if (allcontainers.empty())
     {
@@ -622,15 +997,15 @@ MultiParticleContainer::NumberOfParticlesInGrid (int lev) const
     }
     else
     {
-        const bool only_valid=true, only_local=true;
-        Vector<Long> r = allcontainers[0]->NumberOfParticlesInGrid(lev,only_valid,only_local);
+        const bool only_local_pc = true;
+        Vector<Long> r = allcontainers[0]->NumberOfParticlesInGrid(lev,only_valid,only_local_pc);
         for (unsigned i = 1, n = allcontainers.size(); i < n; ++i) {
-            const auto& ri = allcontainers[i]->NumberOfParticlesInGrid(lev,only_valid,only_local);
+            const auto& ri = allcontainers[i]->NumberOfParticlesInGrid(lev,only_valid,only_local_pc);
             for (unsigned j=0, m=ri.size(); j<m; ++j) {
                 r[j] += ri[j];
             }
         }
-        ParallelDescriptor::ReduceLongSum(r.data(),r.size());
+        if (!only_local) ParallelDescriptor::ReduceLongSum(r.data(),r.size());
         return r;
     }
 }
@@ -683,50 +1058,9 @@ MultiParticleContainer
     for (int i = 0; i < nspecies_back_transformed_diagnostics; ++i){
         int isp = map_species_back_transformed_diagnostics[i];
         WarpXParticleContainer* pc = allcontainers[isp].get();
-        WarpXParticleContainer::DiagnosticParticles diagnostic_particles;
-        pc->GetParticleSlice(direction, z_old, z_new, t_boost, t_lab, dt, diagnostic_particles);
-        // Here, diagnostic_particles[lev][index] is a WarpXParticleContainer::DiagnosticParticleData
-        // where "lev" is the AMR level and "index" is a [grid index][tile index] pair.
-
-        // Loop over AMR levels
-        for (int lev = 0; lev <= pc->finestLevel(); ++lev){
-            // Loop over [grid index][tile index] pairs
-            // and Fills parts[species number i] with particle data from all grids and
-            // tiles in diagnostic_particles. parts contains particles from all
-            // AMR levels indistinctly.
-            for (auto it = diagnostic_particles[lev].begin(); it != diagnostic_particles[lev].end(); ++it){
-                // it->first is the [grid index][tile index] key
-                // it->second is the corresponding
-                // WarpXParticleContainer::DiagnosticParticleData value
-                parts[i].GetRealData(DiagIdx::w).insert(  parts[i].GetRealData(DiagIdx::w  ).end(),
-                                                          it->second.GetRealData(DiagIdx::w  ).begin(),
-                                                          it->second.GetRealData(DiagIdx::w  ).end());
-
-                parts[i].GetRealData(DiagIdx::x).insert(  parts[i].GetRealData(DiagIdx::x  ).end(),
-                                                          it->second.GetRealData(DiagIdx::x  ).begin(),
-                                                          it->second.GetRealData(DiagIdx::x  ).end());
-
-                parts[i].GetRealData(DiagIdx::y).insert(  parts[i].GetRealData(DiagIdx::y  ).end(),
-                                                          it->second.GetRealData(DiagIdx::y  ).begin(),
-                                                          it->second.GetRealData(DiagIdx::y  ).end());
-
-                parts[i].GetRealData(DiagIdx::z).insert(  parts[i].GetRealData(DiagIdx::z  ).end(),
-                                                          it->second.GetRealData(DiagIdx::z  ).begin(),
-                                                          it->second.GetRealData(DiagIdx::z  ).end());
-
-                parts[i].GetRealData(DiagIdx::ux).insert(  parts[i].GetRealData(DiagIdx::ux).end(),
-                                                           it->second.GetRealData(DiagIdx::ux).begin(),
-                                                           it->second.GetRealData(DiagIdx::ux).end());
-
-                parts[i].GetRealData(DiagIdx::uy).insert(  parts[i].GetRealData(DiagIdx::uy).end(),
-                                                           it->second.GetRealData(DiagIdx::uy).begin(),
-                                                           it->second.GetRealData(DiagIdx::uy).end());
-
-                parts[i].GetRealData(DiagIdx::uz).insert(  parts[i].GetRealData(DiagIdx::uz).end(),
-                                                           it->second.GetRealData(DiagIdx::uz).begin(),
-                                                           it->second.GetRealData(DiagIdx::uz).end());
-            }
-        }
+        // The particles of all the AMR levels, grids and tiles are appended
+        // to parts[species number i] indistinctly, on device.
+        pc->GetParticleSlice(direction, z_old, z_new, t_boost, t_lab, dt, parts[i]);
     }
 }
 
@@ -867,6 +1201,7 @@ MultiParticleContainer::doFieldIonization (int lev,
                                            const MultiFab& By,
                                            const MultiFab& Bz)
 {
+    WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::QED);
     WARPX_PROFILE("MultiParticleContainer::doFieldIonization()");
 
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
@@ -901,6 +1236,11 @@ MultiParticleContainer::doFieldIonization (int lev,
             }
             Real wt = amrex::second();
 
+            // Skip the tiles in which no ion can be ionized
+            if (!phys_pc_ptr->hasIonizationCandidates(pti, Ex.nGrowVect(),
+                                                      Ex[pti], Ey[pti], Ez[pti],
+                                                      Bx[pti], By[pti], Bz[pti])) continue;
+
             auto& src_tile = pc_source ->ParticlesAt(lev, pti);
             auto& dst_tile = pc_product->ParticlesAt(lev, pti);
 
@@ -919,6 +1259,9 @@ MultiParticleContainer::doFieldIonization (int lev,
                 amrex::Gpu::synchronize();
                 wt = amrex::second() - wt;
                 amrex::HostDevice::Atomic::Add( &(*cost)[pti.index()], wt);
+                if (auto* cb = WarpX::getCostsBreakdown(lev, CostsPhase::Ionize, pc_source->getSpeciesId())) {
+                    amrex::HostDevice::Atomic::Add( &(*cb)[pti.index()], wt);
+                }
             }
         }
     }
@@ -927,6 +1270,7 @@ MultiParticleContainer::doFieldIonization (int lev,
 void
 MultiParticleContainer::doCollisions ( Real cur_time )
 {
+    WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::Collisions);
     WARPX_PROFILE("MultiParticleContainer::doCollisions()");
     collisionhandler->doCollisions(cur_time, this);
 }
@@ -953,14 +1297,34 @@ void MultiParticleContainer::CheckIonizationProductSpecies()
     }
 }
 
-void MultiParticleContainer::ScrapeParticles (const amrex::Vector<const amrex::MultiFab*>& distance_to_eb)
+void MultiParticleContainer::ScrapeParticles (
+    const amrex::Vector<const amrex::MultiFab*>& distance_to_eb,
+    const amrex::Vector<const amrex::LayoutData<amrex::Real>*>& distance_to_eb_min)
 {
 #ifdef AMREX_USE_EB
+    // The particles of a box interpolate the signed distance from the nodes of their cell:
+    // the boxes can be skipped based on the minimum over their guard cells if the particles
+    // cannot have moved out of the box (since the last Redistribute, at the previous step)
+    // by more than the guard cells, minus one
+    auto& warpx = WarpX::GetInstance();
+    amrex::Vector<const amrex::LayoutData<amrex::Real>*> min_for_skipping(distance_to_eb.size(), nullptr);
+    for (int lev = 0; lev < static_cast<int>(distance_to_eb.size()); ++lev) {
+        if (!distance_to_eb[lev] || static_cast<int>(distance_to_eb_min.size()) <= lev) continue;
+        bool can_skip = true;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const int max_cells_moved = static_cast<int>(
+                std::ceil(PhysConst::c*warpx.getdt(lev)/warpx.Geom(lev).CellSize(idim)));
+            can_skip = can_skip && (max_cells_moved + 1 <= distance_to_eb[lev]->nGrowVect()[idim]);
+        }
+        if (can_skip) min_for_skipping[lev] = distance_to_eb_min[lev];
+    }
+
     for (auto& pc : allcontainers) {
-        scrapeParticles(*pc, distance_to_eb, ParticleBoundaryProcess::Absorb());
+        scrapeParticles(*pc, distance_to_eb, min_for_skipping, 0, pc->finestLevel(),
+                        ParticleBoundaryProcess::Absorb());
     }
 #else
-    amrex::ignore_unused(distance_to_eb);
+    amrex::ignore_unused(distance_to_eb, distance_to_eb_min);
 #endif
 }
 
@@ -1129,7 +1493,9 @@ MultiParticleContainer::QuantumSyncGenerateTable ()
     ParmParse pp_qed_qs("qed_qs");
     std::string table_name;
     pp_qed_qs.query("save_table_in", table_name);
-    if(table_name.empty())
+    std::string cache_dir;
+    pp_qed_qs.query("lookup_table_cache_dir", cache_dir);
+    if(table_name.empty() && cache_dir.empty())
         amrex::Abort("qed_qs.save_table_in should be provided!");
 
     // qs_minimum_chi_part is the minimum chi parameter to be
@@ -1138,7 +1504,7 @@ MultiParticleContainer::QuantumSyncGenerateTable ()
     amrex::Real qs_minimum_chi_part;
     getWithParser(pp_qed_qs, "chi_min", qs_minimum_chi_part);
 
-    if(ParallelDescriptor::IOProcessor()){
+    {
         PicsarQuantumSyncCtrl ctrl;
 
         //==Table parameters==
@@ -1185,10 +1551,49 @@ MultiParticleContainer::QuantumSyncGenerateTable ()
         getWithParser(pp_qed_qs, "tab_em_frac_how_many", ctrl.phot_em_params.frac_how_many);
         //====================
 
-        m_shr_p_qs_engine->compute_lookup_tables(ctrl, qs_minimum_chi_part);
-        const auto data = m_shr_p_qs_engine->export_lookup_tables_data();
-        WarpXUtilIO::WriteBinaryDataOnFile(table_name,
-            Vector<char>{data.begin(), data.end()});
+        //If a table with the same parameters has already been generated
+        //(e.g. by a previous simulation), it is read from the cache
+        std::string cached_table_name;
+        if(!cache_dir.empty()){
+            std::ostringstream table_params;
+            table_params << std::hexfloat
+                << ctrl.dndt_params.chi_part_min << ";"
+                << ctrl.dndt_params.chi_part_max << ";"
+                << ctrl.dndt_params.chi_part_how_many << ";"
+                << ctrl.phot_em_params.chi_part_min << ";"
+                << ctrl.phot_em_params.chi_part_max << ";"
+                << ctrl.phot_em_params.chi_part_how_many << ";"
+                << ctrl.phot_em_params.frac_min << ";"
+                << ctrl.phot_em_params.frac_how_many;
+            cached_table_name = QEDTableCacheFileName(cache_dir, "qs", table_params.str());
+            if(FileExistsOnIOProcessor(cached_table_name)){
+                WarpX::GetInstance().RecordWarning("QED",
+                    "The Quantum Synchrotron table will be read from the cache: " + cached_table_name,
+                    WarnPriority::low);
+                Vector<char> table_data;
+                ParallelDescriptor::ReadAndBcastFile(cached_table_name, table_data);
+                ParallelDescriptor::Barrier();
+                m_shr_p_qs_engine->init_lookup_tables_from_raw_data(
+                    table_data, qs_minimum_chi_part);
+                if(!table_name.empty() && ParallelDescriptor::IOProcessor()){
+                    WarpXUtilIO::WriteBinaryDataOnFile(table_name, table_data);
+                }
+                return;
+            }
+        }
+
+        if(ParallelDescriptor::IOProcessor()){
+            m_shr_p_qs_engine->compute_lookup_tables(ctrl, qs_minimum_chi_part);
+            const auto data = m_shr_p_qs_engine->export_lookup_tables_data();
+            const auto table_data = Vector<char>{data.begin(), data.end()};
+            if(!table_name.empty()){
+                WarpXUtilIO::WriteBinaryDataOnFile(table_name, table_data);
+            }
+            if(!cached_table_name.empty()){
+                WriteQEDTableInCache(cache_dir, cached_table_name, table_data);
+            }
+        }
+        if(table_name.empty()) table_name = cached_table_name;
     }
 
     ParallelDescriptor::Barrier();
@@ -1210,7 +1615,9 @@ MultiParticleContainer::BreitWheelerGenerateTable ()
     ParmParse pp_qed_bw("qed_bw");
     std::string table_name;
     pp_qed_bw.query("save_table_in", table_name);
-    if(table_name.empty())
+    std::string cache_dir;
+    pp_qed_bw.query("lookup_table_cache_dir", cache_dir);
+    if(table_name.empty() && cache_dir.empty())
         amrex::Abort("qed_bw.save_table_in should be provided!");
 
     // bw_minimum_chi_phot is the minimum chi parameter to be
@@ -1219,7 +1626,7 @@ MultiParticleContainer::BreitWheelerGenerateTable ()
     amrex::Real bw_minimum_chi_part;
     getWithParser(pp_qed_bw, "chi_min", bw_minimum_chi_part);
 
-    if(ParallelDescriptor::IOProcessor()){
+    {
         PicsarBreitWheelerCtrl ctrl;
 
         //==Table parameters==
@@ -1262,10 +1669,48 @@ MultiParticleContainer::BreitWheelerGenerateTable ()
         getWithParser(pp_qed_bw, "tab_pair_frac_how_many", ctrl.pair_prod_params.frac_how_many);
         //====================
 
-        m_shr_p_bw_engine->compute_lookup_tables(ctrl, bw_minimum_chi_part);
-        const auto data = m_shr_p_bw_engine->export_lookup_tables_data();
-        WarpXUtilIO::WriteBinaryDataOnFile(table_name,
-            Vector<char>{data.begin(), data.end()});
+        //If a table with the same parameters has already been generated
+        //(e.g. by a previous simulation), it is read from the cache
+        std::string cached_table_name;
+        if(!cache_dir.empty()){
+            std::ostringstream table_params;
+            table_params << std::hexfloat
+                << ctrl.dndt_params.chi_phot_min << ";"
+                << ctrl.dndt_params.chi_phot_max << ";"
+                << ctrl.dndt_params.chi_phot_how_many << ";"
+                << ctrl.pair_prod_params.chi_phot_min << ";"
+                << ctrl.pair_prod_params.chi_phot_max << ";"
+                << ctrl.pair_prod_params.chi_phot_how_many << ";"
+                << ctrl.pair_prod_params.frac_how_many;
+            cached_table_name = QEDTableCacheFileName(cache_dir, "bw", table_params.str());
+            if(FileExistsOnIOProcessor(cached_table_name)){
+                WarpX::GetInstance().RecordWarning("QED",
+                    "The Breit Wheeler table will be read from the cache: " + cached_table_name,
+                    WarnPriority::low);
+                Vector<char> table_data;
+                ParallelDescriptor::ReadAndBcastFile(cached_table_name, table_data);
+                ParallelDescriptor::Barrier();
+                m_shr_p_bw_engine->init_lookup_tables_from_raw_data(
+                    table_data, bw_minimum_chi_part);
+                if(!table_name.empty() && ParallelDescriptor::IOProcessor()){
+                    WarpXUtilIO::WriteBinaryDataOnFile(table_name, table_data);
+                }
+                return;
+            }
+        }
+
+        if(ParallelDescriptor::IOProcessor()){
+            m_shr_p_bw_engine->compute_lookup_tables(ctrl, bw_minimum_chi_part);
+            const auto data = m_shr_p_bw_engine->export_lookup_tables_data();
+            const auto table_data = Vector<char>{data.begin(), data.end()};
+            if(!table_name.empty()){
+                WarpXUtilIO::WriteBinaryDataOnFile(table_name, table_data);
+            }
+            if(!cached_table_name.empty()){
+                WriteQEDTableInCache(cache_dir, cached_table_name, table_data);
+            }
+        }
+        if(table_name.empty()) table_name = cached_table_name;
     }
 
     ParallelDescriptor::Barrier();
@@ -1284,6 +1729,7 @@ MultiParticleContainer::BreitWheelerGenerateTable ()
 void
 MultiParticleContainer::doQEDSchwinger ()
 {
+    WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::QED);
     WARPX_PROFILE("MultiParticleContainer::doQEDSchwinger()");
 
     if (!m_do_qed_schwinger) {return;}
@@ -1291,9 +1737,11 @@ MultiParticleContainer::doQEDSchwinger ()
     auto & warpx = WarpX::GetInstance();
 
     AMREX_ALWAYS_ASSERT_WITH_MESSAGE(warpx.do_nodal ||
-       warpx.field_gathering_algo == GatheringAlgo::MomentumConserving,
+       (warpx.field_gathering_algo == GatheringAlgo::MomentumConserving &&
+        !warpx.do_on_the_fly_nodal_gather),
           "ERROR: Schwinger process only implemented for warpx.do_nodal = 1"
-                                 "or algo.field_gathering = momentum-conserving");
+                                 "or algo.field_gathering = momentum-conserving"
+                                 " (without warpx.do_on_the_fly_nodal_gather)");
 
     constexpr int level_0 = 0;
 
@@ -1326,6 +1774,12 @@ MultiParticleContainer::doQEDSchwinger ()
     pc_product_ele->defineAllParticleTiles();
     pc_product_pos->defineAllParticleTiles();
 
+    // Schwinger field E_S = m_e^2 c^3 / (q_e hbar)
+    constexpr double schwinger_field = static_cast<double>(PhysConst::m_e)*PhysConst::m_e
+        *PhysConst::c*PhysConst::c*PhysConst::c/(static_cast<double>(PhysConst::q_e)*PhysConst::hbar);
+    const double min_field = m_qed_schwinger_min_field_fraction*schwinger_field;
+    const auto ActiveCell = SchwingerActiveCellFunc{static_cast<amrex::Real>(min_field*min_field)};
+
     const MultiFab & Ex = warpx.getEfield(level_0,0);
     const MultiFab & Ey = warpx.getEfield(level_0,1);
     const MultiFab & Ez = warpx.getEfield(level_0,2);
@@ -1371,7 +1825,14 @@ MultiParticleContainer::doQEDSchwinger ()
         const auto Transform = SchwingerTransformFunc{m_qed_schwinger_y_size,
                             ParticleStringNames::to_index.find("w")->second};
 
-        const auto num_added = filterCreateTransformFromFAB<1>( dst_ele_tile,
+        // If requested, the pair creation rate is only computed in the cells where the
+        // electric field is above a fraction of the Schwinger field
+        const auto num_added = (m_qed_schwinger_min_field_fraction > 0._rt) ?
+            filterCreateTransformFromFABInActiveCells<1>( dst_ele_tile,
+                               dst_pos_tile, box, fieldsEB, np_ele_dst,
+                               np_pos_dst, ActiveCell, Filter, CreateEle, CreatePos,
+                               Transform) :
+            filterCreateTransformFromFAB<1>( dst_ele_tile,
                                dst_pos_tile, box, fieldsEB, np_ele_dst,
                                np_pos_dst,Filter, CreateEle, CreatePos,
                                Transform);
@@ -1494,6 +1955,8 @@ void MultiParticleContainer::doQedBreitWheeler (int lev,
 
         const auto pair_gen_functor = m_shr_p_bw_engine->build_pair_functor();
 
+        const int opt_depth_runtime_comp = pc_source->particle_runtime_comps["opticalDepthBW"];
+
         pc_source ->defineAllParticleTiles();
         pc_product_pos->defineAllParticleTiles();
         pc_product_ele->defineAllParticleTiles();
@@ -1505,6 +1968,10 @@ void MultiParticleContainer::doQedBreitWheeler (int lev,
 #endif
         for (WarpXParIter pti(*pc_source, lev, info); pti.isValid(); ++pti)
         {
+            // Skip the tiles in which no photon undergoes pair generation
+            if (!HasQEDEventCandidates(pc_source->ParticlesAt(lev, pti),
+                                       opt_depth_runtime_comp)) continue;
+
             if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
             {
                 amrex::Gpu::synchronize();
@@ -1536,6 +2003,9 @@ void MultiParticleContainer::doQedBreitWheeler (int lev,
                 amrex::Gpu::synchronize();
                 wt = amrex::second() - wt;
                 amrex::HostDevice::Atomic::Add( &(*cost)[pti.index()], wt);
+                if (auto* cb = WarpX::getCostsBreakdown(lev, CostsPhase::QED, pc_source->getSpeciesId())) {
+                    amrex::HostDevice::Atomic::Add( &(*cb)[pti.index()], wt);
+                }
             }
         }
     }
@@ -1571,6 +2041,8 @@ void MultiParticleContainer::doQedQuantumSync (int lev,
         const auto Filter   = phys_pc_ptr->getPhotonEmissionFilterFunc();
         const auto CopyPhot = copy_factory_phot.getSmartCopy();
 
+        const int opt_depth_runtime_comp = pc_source->particle_runtime_comps["opticalDepthQSR"];
+
         pc_source ->defineAllParticleTiles();
         pc_product_phot->defineAllParticleTiles();
 
@@ -1581,6 +2053,10 @@ void MultiParticleContainer::doQedQuantumSync (int lev,
 #endif
         for (WarpXParIter pti(*pc_source, lev, info); pti.isValid(); ++pti)
         {
+            // Skip the tiles in which no particle emits a photon
+            if (!HasQEDEventCandidates(pc_source->ParticlesAt(lev, pti),
+                                       opt_depth_runtime_comp)) continue;
+
             if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
             {
                 amrex::Gpu::synchronize();
@@ -1616,6 +2092,9 @@ void MultiParticleContainer::doQedQuantumSync (int lev,
                 amrex::Gpu::synchronize();
                 wt = amrex::second() - wt;
                 amrex::HostDevice::Atomic::Add( &(*cost)[pti.index()], wt);
+                if (auto* cb = WarpX::getCostsBreakdown(lev, CostsPhase::QED, pc_source->getSpeciesId())) {
+                    amrex::HostDevice::Atomic::Add( &(*cb)[pti.index()], wt);
+                }
             }
         }
     }
@@ -10,8 +10,11 @@
 #include "Particles/ParticleBoundaryBuffer.H"
 #include "Particles/MultiParticleContainer.H"
 #include "Particles/Gather/ScalarFieldGather.H"
+#include "Utils/WarpXConst.H"
 
 #include <AMReX_Geometry.H>
+#include <AMReX_GpuAtomic.H>
+#include <AMReX_ParallelDescriptor.H>
 #include <AMReX_ParmParse.H>
 
 struct IsOutsideDomainBoundary {
@@ -55,15 +58,217 @@ struct CopyAndTimestamp {
     }
 };
 
+namespace
+{
+    /** Parameters of the histograms of the scraped particles of one species */
+    struct HistogramParams {
+        int nbins;
+        amrex::Real energy_max; // in eV
+        amrex::Real mass;       // m_e for photons, whose momentum is normalized by m_e
+        bool massless;
+    };
+
+    /**
+     * \brief Add the particles [start, start+count) of the buffer tile to the histograms:
+     * energy bins first, then the angle bins (only for the domain boundaries, idim >= 0)
+     */
+    template <typename PTile>
+    void AccumulateHistograms (PTile& ptile_buffer, int start, int count, int idim,
+                               const HistogramParams& params, amrex::Real* hist)
+    {
+        if (count == 0 || params.nbins == 0) return;
+        const auto ptd = ptile_buffer.getParticleTileData();
+        const int nbins = params.nbins;
+        const amrex::Real energy_max = params.energy_max;
+        const amrex::Real mass = params.mass;
+        const bool massless = params.massless;
+        amrex::ParallelFor(count, [=] AMREX_GPU_DEVICE (int i) noexcept
+        {
+            using namespace amrex::literals;
+            constexpr auto c = PhysConst::c;
+            const int ip = start + i;
+            const amrex::ParticleReal w = ptd.m_rdata[PIdx::w][ip];
+            const amrex::ParticleReal ux = ptd.m_rdata[PIdx::ux][ip];
+            const amrex::ParticleReal uy = ptd.m_rdata[PIdx::uy][ip];
+            const amrex::ParticleReal uz = ptd.m_rdata[PIdx::uz][ip];
+            const amrex::Real u2 = ux*ux + uy*uy + uz*uz;
+
+            // kinetic energy in eV
+            const amrex::Real energy = massless ?
+                mass*c*std::sqrt(u2)/PhysConst::q_e :
+                (std::sqrt(1._rt + u2/(c*c)) - 1._rt)*mass*c*c/PhysConst::q_e;
+            const int ibin_energy = static_cast<int>(energy/energy_max*nbins);
+            if (ibin_energy >= 0 && ibin_energy < nbins) {
+                amrex::Gpu::Atomic::AddNoRet(&hist[ibin_energy], static_cast<amrex::Real>(w));
+            }
+
+            if (idim < 0 || u2 == 0._rt) return;
+            // component of the momentum along the normal to the boundary
+#if defined(WARPX_DIM_3D)
+            const amrex::Real un = (idim == 0) ? ux : ((idim == 1) ? uy : uz);
+#elif defined(WARPX_DIM_RZ)
+            const amrex::ParticleReal theta = ptd.m_rdata[PIdx::theta][ip];
+            const amrex::Real un = (idim == 0) ? ux*std::cos(theta) + uy*std::sin(theta) : uz;
+#else
+            const amrex::Real un = (idim == 0) ? ux : uz;
+#endif
+            const amrex::Real cos_angle = amrex::min(std::abs(un)/std::sqrt(u2), 1._rt);
+            const amrex::Real angle = std::acos(cos_angle);
+            const int ibin_angle = amrex::min(static_cast<int>(angle/(0.5_rt*MathConst::pi)*nbins), nbins-1);
+            amrex::Gpu::Atomic::AddNoRet(&hist[nbins + ibin_angle], static_cast<amrex::Real>(w));
+        });
+    }
+
+    template <template<class> class Allocator>
+    void DefineBuffer (ParticleBuffer::BufferType<Allocator>& buffer, const WarpXParticleContainer& pc)
+    {
+        if (!buffer.isDefined())
+        {
+            buffer = ParticleBuffer::getTmpPC<Allocator>(&pc);
+            buffer.AddIntComp(false);  // for timestamp
+        }
+    }
+
+    /**
+     * \brief Copy the particles of mypc that are outside of the domain boundaries or of the
+     * embedded boundary to the buffers, and add them to the histograms
+     */
+    template <template<class> class Allocator>
+    void GatherParticlesImpl (
+        MultiParticleContainer& mypc,
+        const amrex::Vector<const amrex::MultiFab*>& distance_to_eb,
+        std::vector<std::vector<ParticleBuffer::BufferType<Allocator> > >& containers,
+        const std::vector<std::vector<int> >& do_boundary_buffer,
+        std::vector<std::vector<amrex::Gpu::DeviceVector<amrex::Real> > >& histograms,
+        int histogram_bins, amrex::Real histogram_energy_max)
+    {
+        using PIter = amrex::ParConstIter<0,0,PIdx::nattribs>;
+        const auto& warpx_instance = WarpX::GetInstance();
+        const amrex::Geometry& geom = warpx_instance.Geom(0);
+        auto plo = geom.ProbLoArray();
+        auto phi = geom.ProbHiArray();
+        auto dxi = geom.InvCellSizeArray();
+        const int nspecies = containers[0].size();
+
+        const auto GetHistogramParams = [&] (const WarpXParticleContainer& pc)
+        {
+            const bool massless = pc.AmIA<PhysicalSpecies::photon>();
+            return HistogramParams{histogram_bins, histogram_energy_max,
+                                   massless ? PhysConst::m_e : pc.getMass(), massless};
+        };
+
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            if (geom.isPeriodic(idim)) continue;
+            for (int iside = 0; iside < 2; ++iside)
+            {
+                auto& buffer = containers[2*idim+iside];
+                for (int i = 0; i < nspecies; ++i)
+                {
+                    if (!do_boundary_buffer[2*idim+iside][i]) continue;
+                    const auto& pc = mypc.GetParticleContainer(i);
+                    DefineBuffer(buffer[i], pc);
+                    auto& species_buffer = buffer[i];
+                    const HistogramParams hist_params = GetHistogramParams(pc);
+                    amrex::Real* hist = histograms[2*idim+iside][i].dataPtr();
+                    for (int lev = 0; lev < pc.numLevels(); ++lev)
+                    {
+                        const auto& plevel = pc.GetParticles(lev);
+                        for(PIter pti(pc, lev); pti.isValid(); ++pti)
+                        {
+                            auto index = std::make_pair(pti.index(), pti.LocalTileIndex());
+                            if(plevel.find(index) == plevel.end()) continue;
+
+                            auto& ptile_buffer = species_buffer.DefineAndReturnParticleTile(
+                                                            lev, pti.index(), pti.LocalTileIndex());
+                            const auto& ptile = plevel.at(index);
+                            auto np = ptile.numParticles();
+                            if (np == 0) continue;
+
+                            auto dst_index = ptile_buffer.numParticles();
+                            ptile_buffer.resize(dst_index + np);
+
+                            int timestamp_index = ptile_buffer.NumRuntimeIntComps()-1;
+                            int timestep = warpx_instance.getistep(0);
+                            auto count = amrex::filterAndTransformParticles(ptile_buffer, ptile,
+                                                 IsOutsideDomainBoundary{plo, phi, idim, iside},
+                                                    CopyAndTimestamp{timestamp_index, timestep},
+                                                                                  0, dst_index);
+                            ptile_buffer.resize(dst_index + count);
+                            AccumulateHistograms(ptile_buffer, dst_index, count, idim, hist_params, hist);
+                        }
+                    }
+                }
+            }
+        }
+
+#ifdef AMREX_USE_EB
+        auto& buffer = containers[containers.size()-1];
+        for (int i = 0; i < nspecies; ++i)
+        {
+            const auto& pc = mypc.GetParticleContainer(i);
+            DefineBuffer(buffer[i], pc);
+            auto& species_buffer = buffer[i];
+            const HistogramParams hist_params = GetHistogramParams(pc);
+            amrex::Real* hist = histograms[containers.size()-1][i].dataPtr();
+            for (int lev = 0; lev < pc.numLevels(); ++lev)
+            {
+                const auto& plevel = pc.GetParticles(lev);
+                for(PIter pti(pc, lev); pti.isValid(); ++pti)
+                {
+                    auto phiarr = (*distance_to_eb[lev])[pti].array();  // signed distance function
+                    auto index = std::make_pair(pti.index(), pti.LocalTileIndex());
+                    if(plevel.find(index) == plevel.end()) continue;
+
+                    const auto getPosition = GetParticlePosition(pti);
+                    auto& ptile_buffer = species_buffer.DefineAndReturnParticleTile(lev, pti.index(),
+                                                                                    pti.LocalTileIndex());
+                    const auto& ptile = plevel.at(index);
+                    auto np = ptile.numParticles();
+                    if (np == 0) continue;
+
+                    auto dst_index = ptile_buffer.numParticles();
+                    ptile_buffer.resize(dst_index + np);
+
+                    int timestamp_index = ptile_buffer.NumRuntimeIntComps()-1;
+                    int timestep = warpx_instance.getistep(0);
+                    using SrcData = WarpXParticleContainer::ParticleTileType::ConstParticleTileDataType;
+                    auto count = amrex::filterAndTransformParticles(ptile_buffer, ptile,
+                        [=] AMREX_GPU_HOST_DEVICE (const SrcData& /*src*/, const int ip) noexcept
+                        {
+                            amrex::ParticleReal xp, yp, zp;
+                            getPosition(ip, xp, yp, zp);
+
+                            amrex::Real phi_value  = doGatherScalarFieldNodal(
+                                xp, yp, zp, phiarr, dxi, plo
+                            );
+                            return phi_value < 0.0 ? 1 : 0;
+                        },
+                        CopyAndTimestamp{timestamp_index, timestep}, 0, dst_index);
+                    ptile_buffer.resize(dst_index + count);
+                    AccumulateHistograms(ptile_buffer, dst_index, count, -1, hist_params, hist);
+                }
+            }
+        }
+#else
+        amrex::ignore_unused(distance_to_eb, dxi);
+#endif
+    }
+}
+
 ParticleBoundaryBuffer::ParticleBoundaryBuffer ()
 {
     m_particle_containers.resize(numBoundaries());
+    m_device_containers.resize(numBoundaries());
     m_do_boundary_buffer.resize(numBoundaries());
+    m_histograms.resize(numBoundaries());
 
     for (int i = 0; i < numBoundaries(); ++i)
     {
         m_particle_containers[i].resize(numSpecies());
+        m_device_containers[i].resize(numSpecies());
         m_do_boundary_buffer[i].resize(numSpecies(), 0);
+        m_histograms[i].resize(numSpecies());
     }
 
     for (int ispecies = 0; ispecies < numSpecies(); ++ispecies)
@@ -84,6 +289,26 @@ ParticleBoundaryBuffer::ParticleBoundaryBuffer ()
         pp_species.query("save_particles_at_eb", m_do_boundary_buffer[AMREX_SPACEDIM*2][ispecies]);
 #endif
     }
+
+    amrex::ParmParse pp_particles("particles");
+    pp_particles.query("boundary_buffer_on_device", m_on_device);
+    pp_particles.query("boundary_buffer_flush_interval", m_flush_interval);
+    pp_particles.query("boundary_buffer_max_particles", m_max_particles);
+    pp_particles.query("boundary_buffer_keep_particles", m_keep_particles);
+    pp_particles.query("boundary_buffer_histogram_bins", m_histogram_bins);
+    if (m_histogram_bins > 0) {
+        pp_particles.get("boundary_buffer_histogram_energy_max", m_histogram_energy_max);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_histogram_energy_max > 0.,
+            "particles.boundary_buffer_histogram_energy_max must be positive");
+    }
+    // Without keeping the particles, they are only gathered on the device for the histograms
+    if (!m_keep_particles) m_on_device = true;
+
+    for (auto& boundary_histograms : m_histograms) {
+        for (auto& hist : boundary_histograms) {
+            hist.resize(2*m_histogram_bins, amrex::Real(0.));
+        }
+    }
 }
 
 void ParticleBoundaryBuffer::printNumParticles () const {
@@ -92,9 +317,11 @@ void ParticleBoundaryBuffer::printNumParticles () const {
         for (int iside = 0; iside < 2; ++iside)
         {
             auto& buffer = m_particle_containers[2*idim+iside];
+            auto& device_buffer = m_device_containers[2*idim+iside];
             for (int i = 0; i < numSpecies(); ++i)
             {
                 int np = buffer[i].isDefined() ? buffer[i].TotalNumberOfParticles(false) : 0;
+                if (device_buffer[i].isDefined()) np += device_buffer[i].TotalNumberOfParticles(false);
                 amrex::Print() << "Species " << getSpeciesNames()[i] << " has "
                                << np << " particles in the boundary buffer "
                                << "for side " << iside << " of dim " << idim << "\n";
@@ -103,9 +330,11 @@ void ParticleBoundaryBuffer::printNumParticles () const {
     }
 #ifdef AMREX_USE_EB
     auto& buffer = m_particle_containers[2*AMREX_SPACEDIM];
+    auto& device_buffer = m_device_containers[2*AMREX_SPACEDIM];
     for (int i = 0; i < numSpecies(); ++i)
     {
         int np = buffer[i].isDefined() ? buffer[i].TotalNumberOfParticles(false) : 0;
+        if (device_buffer[i].isDefined()) np += device_buffer[i].TotalNumberOfParticles(false);
         amrex::Print() << "Species " << getSpeciesNames()[i] << " has "
                        << np << " particles in the EB boundary buffer \n";
     }
@@ -115,127 +344,67 @@ void ParticleBoundaryBuffer::printNumParticles () const {
 void ParticleBoundaryBuffer::clearParticles () {
     for (int i = 0; i < numBoundaries(); ++i)
     {
-        auto& buffer = m_particle_containers[i];
         for (int ispecies = 0; ispecies < numSpecies(); ++ispecies)
         {
-            auto& species_buffer = buffer[ispecies];
+            auto& species_buffer = m_particle_containers[i][ispecies];
             if (species_buffer.isDefined()) species_buffer.clearParticles();
+            auto& device_buffer = m_device_containers[i][ispecies];
+            if (device_buffer.isDefined()) device_buffer.clearParticles();
         }
     }
 }
 
-void ParticleBoundaryBuffer::gatherParticles (MultiParticleContainer& mypc,
-                                              const amrex::Vector<const amrex::MultiFab*>& distance_to_eb)
-{
-    using PIter = amrex::ParConstIter<0,0,PIdx::nattribs>;
-    const auto& warpx_instance = WarpX::GetInstance();
-    const amrex::Geometry& geom = warpx_instance.Geom(0);
-    auto plo = geom.ProbLoArray();
-    auto phi = geom.ProbHiArray();
-    auto dxi = geom.InvCellSizeArray();
-    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+void ParticleBoundaryBuffer::flushDeviceBuffers () {
+    for (int i = 0; i < numBoundaries(); ++i)
     {
-        if (geom.isPeriodic(idim)) continue;
-        for (int iside = 0; iside < 2; ++iside)
+        for (int ispecies = 0; ispecies < numSpecies(); ++ispecies)
         {
-            auto& buffer = m_particle_containers[2*idim+iside];
-            for (int i = 0; i < numSpecies(); ++i)
-            {
-                if (!m_do_boundary_buffer[2*idim+iside][i]) continue;
-                const auto& pc = mypc.GetParticleContainer(i);
-                if (!buffer[i].isDefined())
-                {
-                    buffer[i] = ParticleBuffer::getTmpPC<amrex::PinnedArenaAllocator>(&pc);
-                    buffer[i].AddIntComp(false);  // for timestamp
-                }
-                auto& species_buffer = buffer[i];
-                for (int lev = 0; lev < pc.numLevels(); ++lev)
-                {
-                    const auto& plevel = pc.GetParticles(lev);
-                    for(PIter pti(pc, lev); pti.isValid(); ++pti)
-                    {
-                        auto index = std::make_pair(pti.index(), pti.LocalTileIndex());
-                        if(plevel.find(index) == plevel.end()) continue;
-
-                        auto& ptile_buffer = species_buffer.DefineAndReturnParticleTile(
-                                                        lev, pti.index(), pti.LocalTileIndex());
-                        const auto& ptile = plevel.at(index);
-                        auto np = ptile.numParticles();
-                        if (np == 0) continue;
-
-                        auto dst_index = ptile_buffer.numParticles();
-                        ptile_buffer.resize(dst_index + np);
-
-                        int timestamp_index = ptile_buffer.NumRuntimeIntComps()-1;
-                        int timestep = warpx_instance.getistep(0);
-                        auto count = amrex::filterAndTransformParticles(ptile_buffer, ptile,
-                                             IsOutsideDomainBoundary{plo, phi, idim, iside},
-                                                CopyAndTimestamp{timestamp_index, timestep},
-                                                                              0, dst_index);
-                        ptile_buffer.resize(dst_index + count);
-                    }
-                }
+            auto& device_buffer = m_device_containers[i][ispecies];
+            if (!device_buffer.isDefined()) continue;
+            if (m_keep_particles) {
+                auto& species_buffer = m_particle_containers[i][ispecies];
+                DefineBuffer(species_buffer, WarpX::GetInstance().GetPartContainer().GetParticleContainer(ispecies));
+                // one bulk copy per tile, without redistribution
+                species_buffer.addParticles(device_buffer, true);
             }
+            device_buffer.clearParticles();
         }
     }
+}
+
+void ParticleBoundaryBuffer::gatherParticles (MultiParticleContainer& mypc,
+                                              const amrex::Vector<const amrex::MultiFab*>& distance_to_eb)
+{
+    if (!m_on_device) {
+        GatherParticlesImpl(mypc, distance_to_eb, m_particle_containers, m_do_boundary_buffer,
+                            m_histograms, m_histogram_bins, m_histogram_energy_max);
+        return;
+    }
 
-#ifdef AMREX_USE_EB
-    auto& buffer = m_particle_containers[m_particle_containers.size()-1];
-    for (int i = 0; i < numSpecies(); ++i)
-    {
-        const auto& pc = mypc.GetParticleContainer(i);
-        if (!buffer[i].isDefined())
-        {
-            buffer[i] = ParticleBuffer::getTmpPC<amrex::PinnedArenaAllocator>(&pc);
-            buffer[i].AddIntComp(false);  // for timestamp
-        }
-        auto& species_buffer = buffer[i];
-        for (int lev = 0; lev < pc.numLevels(); ++lev)
-        {
-            const auto& plevel = pc.GetParticles(lev);
-            for(PIter pti(pc, lev); pti.isValid(); ++pti)
-            {
-                auto phiarr = (*distance_to_eb[lev])[pti].array();  // signed distance function
-                auto index = std::make_pair(pti.index(), pti.LocalTileIndex());
-                if(plevel.find(index) == plevel.end()) continue;
-
-                const auto getPosition = GetParticlePosition(pti);
-                auto& ptile_buffer = species_buffer.DefineAndReturnParticleTile(lev, pti.index(),
-                                                                                pti.LocalTileIndex());
-                const auto& ptile = plevel.at(index);
-                auto np = ptile.numParticles();
-                if (np == 0) continue;
-
-                auto dst_index = ptile_buffer.numParticles();
-                ptile_buffer.resize(dst_index + np);
-
-                int timestamp_index = ptile_buffer.NumRuntimeIntComps()-1;
-                int timestep = warpx_instance.getistep(0);
-                using SrcData = WarpXParticleContainer::ParticleTileType::ConstParticleTileDataType;
-                auto count = amrex::filterAndTransformParticles(ptile_buffer, ptile,
-                    [=] AMREX_GPU_HOST_DEVICE (const SrcData& /*src*/, const int ip) noexcept
-                    {
-                        amrex::ParticleReal xp, yp, zp;
-                        getPosition(ip, xp, yp, zp);
-
-                        amrex::Real phi_value  = doGatherScalarFieldNodal(
-                            xp, yp, zp, phiarr, dxi, plo
-                        );
-                        return phi_value < 0.0 ? 1 : 0;
-                    },
-                    CopyAndTimestamp{timestamp_index, timestep}, 0, dst_index);
-                ptile_buffer.resize(dst_index + count);
+    GatherParticlesImpl(mypc, distance_to_eb, m_device_containers, m_do_boundary_buffer,
+                        m_histograms, m_histogram_bins, m_histogram_energy_max);
+
+    // Flush the device buffers in bulk, at a given interval or above a given size
+    bool flush = !m_keep_particles;
+    const int step = WarpX::GetInstance().getistep(0);
+    if (m_flush_interval > 0 && step % m_flush_interval == 0) flush = true;
+    if (m_max_particles >= 0 && !flush) {
+        long np = 0;
+        for (const auto& boundary_buffers : m_device_containers) {
+            for (const auto& device_buffer : boundary_buffers) {
+                if (device_buffer.isDefined()) np += device_buffer.TotalNumberOfParticles(false, true);
             }
         }
+        if (np > m_max_particles) flush = true;
     }
-#else
-    amrex::ignore_unused(distance_to_eb, dxi);
-#endif
+    if (flush) flushDeviceBuffers();
 }
 
 int ParticleBoundaryBuffer::getNumParticlesInContainer(
         const std::string species_name, int boundary) {
 
+    if (m_on_device) flushDeviceBuffers();
+
     auto& buffer = m_particle_containers[boundary];
     auto index = WarpX::GetInstance().GetPartContainer().getSpeciesID(species_name);
 
@@ -246,6 +415,8 @@ int ParticleBoundaryBuffer::getNumParticlesInContainer(
 ParticleBuffer::BufferType<amrex::PinnedArenaAllocator>&
 ParticleBoundaryBuffer::getParticleBuffer(const std::string species_name, int boundary) {
 
+    if (m_on_device) flushDeviceBuffers();
+
     auto& buffer = m_particle_containers[boundary];
     auto index = WarpX::GetInstance().GetPartContainer().getSpeciesID(species_name);
 
@@ -257,3 +428,19 @@ ParticleBoundaryBuffer::getParticleBuffer(const std::string species_name, int bo
 
     return buffer[index];
 }
+
+amrex::Vector<amrex::Real>
+ParticleBoundaryBuffer::getHistogram (const std::string species_name, int boundary, bool angle) {
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_histogram_bins > 0,
+        "The histograms require particles.boundary_buffer_histogram_bins > 0");
+    auto index = WarpX::GetInstance().GetPartContainer().getSpeciesID(species_name);
+    const auto& hist = m_histograms[boundary][index];
+
+    amrex::Vector<amrex::Real> h_hist(m_histogram_bins);
+    const int offset = angle ? m_histogram_bins : 0;
+    amrex::Gpu::copy(amrex::Gpu::deviceToHost, hist.begin() + offset,
+                     hist.begin() + offset + m_histogram_bins, h_hist.begin());
+    amrex::ParallelDescriptor::ReduceRealSum(h_hist.data(), m_histogram_bins);
+    return h_hist;
+}
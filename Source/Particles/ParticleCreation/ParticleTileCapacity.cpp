@@ -0,0 +1,24 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "ParticleTileCapacity.H"
+
+#include <AMReX_BLassert.H>
+#include <AMReX_ParmParse.H>
+
+namespace ParticleTileCapacity
+{
+    amrex::Real growth_factor = 1.5;
+    amrex::Long num_reallocations = 0;
+
+    void ReadParameters ()
+    {
+        amrex::ParmParse pp_particles("particles");
+        pp_particles.query("product_tile_growth_factor", growth_factor);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(growth_factor >= 1.,
+            "particles.product_tile_growth_factor must be at least 1");
+    }
+}
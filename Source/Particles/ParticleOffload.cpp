@@ -0,0 +1,179 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "Particles/ParticleOffload.H"
+
+#include "Particles/MultiParticleContainer.H"
+#include "Particles/Pusher/GetAndSetPosition.H"
+#include "Particles/WarpXParticleContainer.H"
+#include "Utils/WarpXProfilerWrapper.H"
+#include "Utils/WarpXUtil.H"
+#include "WarpX.H"
+
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_ParticleTransformation.H>
+#include <AMReX_Print.H>
+
+#include <utility>
+#include <vector>
+
+namespace
+{
+    /** Select the particles that are offloaded (m_offloaded = 1) or active (m_offloaded = 0)
+     *  according to the offload function */
+    struct IsOffloaded {
+        amrex::ParserExecutor<4> m_fun;
+        amrex::Real m_time;
+        int m_offloaded;
+
+        template <typename SrcData>
+        AMREX_GPU_DEVICE AMREX_FORCE_INLINE
+        int operator() (const SrcData& src,
+                        int ip, const amrex::RandomEngine& /*engine*/) const noexcept
+        {
+            using namespace amrex::literals;
+            const auto& p = src.getSuperParticle(ip);
+            amrex::ParticleReal x, y, z;
+            get_particle_position(p, x, y, z);
+            const int offloaded = (m_fun(x, y, z, m_time) != 0._rt) ? 1 : 0;
+            return (offloaded == m_offloaded) ? 1 : 0;
+        }
+    };
+
+    /** Move the particles of src selected by is_selected to the end of dst,
+     *  and return their number */
+    template <typename DstTile, typename SrcTile>
+    amrex::Long MoveParticles (DstTile& dst, SrcTile& src, IsOffloaded is_selected)
+    {
+        const auto np = src.numParticles();
+        if (np == 0) return 0;
+
+        const auto dst_index = dst.numParticles();
+        dst.resize(dst_index + np);
+        const auto count = amrex::filterParticles(dst, src, is_selected, 0, dst_index, np);
+        dst.resize(dst_index + count);
+        if (count == 0) return 0;
+
+        // Compact src into a new tile, with the remaining particles
+        SrcTile remaining;
+        remaining.define(src.NumRuntimeRealComps(), src.NumRuntimeIntComps());
+        remaining.resize(np - count);
+        is_selected.m_offloaded = 1 - is_selected.m_offloaded;
+        amrex::filterParticles(remaining, src, is_selected, 0, 0, np);
+        std::swap(src, remaining);
+        return count;
+    }
+}
+
+ParticleOffload::ParticleOffload ()
+{
+    std::vector<std::string> species_names;
+    amrex::ParmParse pp_particles("particles");
+    pp_particles.queryarr("species_names", species_names);
+    queryWithParser(pp_particles, "offload_interval", m_interval);
+
+    m_parsers.resize(species_names.size());
+    m_buffers.resize(species_names.size());
+    for (int i = 0; i < static_cast<int>(species_names.size()); ++i)
+    {
+        amrex::ParmParse pp_species(species_names[i]);
+        std::string str_offload_function;
+        if (pp_species.contains("offload_function(x,y,z,t)"))
+        {
+            Store_parserString(pp_species, "offload_function(x,y,z,t)", str_offload_function);
+            m_parsers[i] = std::make_unique<amrex::Parser>(
+                makeParser(str_offload_function, {"x","y","z","t"}));
+            m_active = true;
+        }
+    }
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_active || m_interval > 0,
+        "particles.offload_interval must be positive");
+}
+
+void ParticleOffload::update (MultiParticleContainer& mypc, int step, amrex::Real time)
+{
+    if (!m_active || step % m_interval != 0) return;
+    WARPX_PROFILE("ParticleOffload::update");
+
+    for (int i = 0; i < static_cast<int>(m_parsers.size()); ++i)
+    {
+        if (!m_parsers[i]) continue;
+        auto& pc = mypc.GetParticleContainer(i);
+        auto& buffer = m_buffers[i];
+        if (!buffer.isDefined()) buffer = ParticleBuffer::getTmpPC<amrex::PinnedArenaAllocator>(&pc);
+        const auto fun = m_parsers[i]->compile<4>();
+
+        // Return the offloaded particles that became active
+        amrex::Long num_returned = 0;
+        for (int lev = 0; lev < buffer.numLevels(); ++lev)
+        {
+            for (auto& kv : buffer.GetParticles(lev))
+            {
+                auto& ptile = pc.DefineAndReturnParticleTile(lev, kv.first.first, kv.first.second);
+                num_returned += MoveParticles(ptile, kv.second, IsOffloaded{fun, time, 0});
+            }
+        }
+
+        // Offload the particles that became inactive
+        amrex::Long num_offloaded = 0;
+        for (int lev = 0; lev < pc.numLevels(); ++lev)
+        {
+            for (WarpXParIter pti(pc, lev); pti.isValid(); ++pti)
+            {
+                auto& ptile_buffer = buffer.DefineAndReturnParticleTile(
+                    lev, pti.index(), pti.LocalTileIndex());
+                num_offloaded += MoveParticles(ptile_buffer, pti.GetParticleTile(),
+                                               IsOffloaded{fun, time, 1});
+            }
+        }
+        amrex::Gpu::synchronize();
+
+        // The returned particles may have moved out of their tile while they were offloaded
+        amrex::ParallelDescriptor::ReduceLongSum(num_returned);
+        if (num_returned > 0) pc.Redistribute();
+
+        if (WarpX::GetInstance().Verbose()) {
+            amrex::ParallelDescriptor::ReduceLongSum(num_offloaded);
+            amrex::Print() << "Species " << mypc.GetSpeciesNames()[i] << ": "
+                           << num_offloaded << " particles offloaded, "
+                           << num_returned << " particles returned\n";
+        }
+    }
+}
+
+void ParticleOffload::returnAllParticles (MultiParticleContainer& mypc)
+{
+    if (!m_active) return;
+
+    for (int i = 0; i < static_cast<int>(m_parsers.size()); ++i)
+    {
+        if (!m_parsers[i] || !m_buffers[i].isDefined()) continue;
+        auto& pc = mypc.GetParticleContainer(i);
+        auto& buffer = m_buffers[i];
+        for (int lev = 0; lev < buffer.numLevels(); ++lev)
+        {
+            for (auto& kv : buffer.GetParticles(lev))
+            {
+                auto& src = kv.second;
+                const auto np = src.numParticles();
+                if (np == 0) continue;
+                auto& ptile = pc.DefineAndReturnParticleTile(lev, kv.first.first, kv.first.second);
+                const auto dst_index = ptile.numParticles();
+                ptile.resize(dst_index + np);
+                amrex::copyParticles(ptile, src, 0, dst_index, np);
+            }
+        }
+        amrex::Gpu::synchronize();
+        buffer.clearParticles();
+    }
+}
+
+amrex::Long ParticleOffload::numOffloadedParticles (int ispecies) const
+{
+    const auto& buffer = m_buffers[ispecies];
+    return buffer.isDefined() ? buffer.TotalNumberOfParticles(false) : 0;
+}
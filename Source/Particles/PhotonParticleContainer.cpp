@@ -9,6 +9,7 @@
 
 #ifdef WARPX_QED
 #   include "Particles/ElementaryProcess/QEDInternals/BreitWheelerEngineWrapper.H"
+#   include "Particles/ElementaryProcess/QEDInternals/QedChiFunctions.H"
 #endif
 #include "Particles/Gather/FieldGather.H"
 #include "Particles/Gather/GetExternalFields.H"
@@ -16,7 +17,9 @@
 #include "Particles/Pusher/CopyParticleAttribs.H"
 #include "Particles/Pusher/GetAndSetPosition.H"
 #include "Particles/Pusher/UpdatePositionPhoton.H"
+#include "Particles/MultiParticleContainer.H"
 #include "Particles/WarpXParticleContainer.H"
+#include "Utils/WarpXConst.H"
 #include "WarpX.H"
 
 #include <AMReX_Array.H>
@@ -37,6 +40,8 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <limits>
 #include <map>
 #include <memory>
 
@@ -123,6 +128,7 @@ PhotonParticleContainer::PushPX (WarpXParIter& pti,
         evolve_opt = m_shr_p_bw_engine->build_evolve_functor();
         p_optical_depth_BW = pti.GetAttribs(particle_comps["opticalDepthBW"]).dataPtr() + offset;
     }
+    amrex::Real* const p_chi_extrema = GetChiExtremaPtr();
 #endif
 
     auto copyAttribs = CopyParticleAttribs(pti, tmp_particle_data);
@@ -132,6 +138,78 @@ PhotonParticleContainer::PushPX (WarpXParIter& pti,
     const auto GetPosition = GetParticlePosition(pti, offset);
     auto SetPosition = SetParticlePosition(pti, offset);
 
+    // The fields only act on photons through the Breit-Wheeler process: without it,
+    // the photons are only pushed ballistically, without any field gather
+    bool gather_fields = false;
+#ifdef WARPX_QED
+    gather_fields = local_has_breit_wheeler;
+#endif
+    if (!gather_fields) {
+        amrex::ParallelFor(
+            np_to_push,
+            [=] AMREX_GPU_DEVICE (long i) {
+                if (do_copy) copyAttribs(i);
+                ParticleReal x, y, z;
+                GetPosition(i, x, y, z);
+                UpdatePositionPhoton( x, y, z, ux[i], uy[i], uz[i], dt );
+                SetPosition(i, x, y, z);
+            }
+        );
+        return;
+    }
+
+#ifdef WARPX_QED
+    // The optical depth of a photon is not evolved if its energy is below 2 m_e c^2, or
+    // if its quantum parameter is below the minimum chi of the Breit-Wheeler engine. With an
+    // upper bound F of |E| + c|B| in the tile, chi <= gamma_photon F / E_s, so that the photons
+    // with |u| below u_min need neither the fields nor the evolution of their optical depth.
+    amrex::Real field_bound = 0._rt;
+    {
+        auto& mypc = WarpX::GetInstance().GetPartContainer();
+        amrex::Real e_max[3], b_max[3];
+        amrex::FArrayBox const* efabs[3] = {exfab, eyfab, ezfab};
+        amrex::FArrayBox const* bfabs[3] = {bxfab, byfab, bzfab};
+        for (int idir = 0; idir < 3; ++idir) {
+            // Upper bound of the field at the particles, summed over the azimuthal modes in RZ
+            e_max[idir] = 0._rt;
+            b_max[idir] = 0._rt;
+            if (!t_do_not_gather) {
+                for (int icomp = 0; icomp < efabs[idir]->nComp(); ++icomp) {
+                    e_max[idir] += efabs[idir]->maxabs<RunOn::Device>(icomp);
+                }
+                for (int icomp = 0; icomp < bfabs[idir]->nComp(); ++icomp) {
+                    b_max[idir] += bfabs[idir]->maxabs<RunOn::Device>(icomp);
+                }
+            }
+        }
+        // External fields: only the default (constant) ones can be bounded
+        const bool const_ext_E = (mypc.m_E_ext_particle_s == "constant" || mypc.m_E_ext_particle_s == "default");
+        const bool const_ext_B = (mypc.m_B_ext_particle_s == "constant" || mypc.m_B_ext_particle_s == "default");
+        if (const_ext_E && const_ext_B) {
+            for (int idir = 0; idir < 3; ++idir) {
+                e_max[idir] += std::abs(mypc.m_E_external_particle[idir]);
+                b_max[idir] += std::abs(mypc.m_B_external_particle[idir]);
+            }
+            field_bound =
+                std::sqrt(e_max[0]*e_max[0] + e_max[1]*e_max[1] + e_max[2]*e_max[2]) +
+                PhysConst::c * std::sqrt(b_max[0]*b_max[0] + b_max[1]*b_max[1] + b_max[2]*b_max[2]);
+        } else {
+            field_bound = std::numeric_limits<amrex::Real>::infinity();
+        }
+    }
+    constexpr amrex::Real schwinger_field = PhysConst::m_e*PhysConst::m_e*PhysConst::c*PhysConst::c*PhysConst::c
+                                            /(PhysConst::q_e*PhysConst::hbar);
+    amrex::Real u_min = 2._rt*PhysConst::c;
+    if (field_bound > 0._rt) {
+        u_min = std::max(u_min,
+            m_shr_p_bw_engine->get_minimum_chi_phot()*schwinger_field*PhysConst::c/field_bound);
+    } else {
+        u_min = std::numeric_limits<amrex::Real>::max();
+    }
+    // Squared, and compared with a margin that covers the rounding errors of the bound
+    const amrex::ParticleReal u_min2 = static_cast<amrex::ParticleReal>(0.99_rt*u_min*u_min);
+#endif
+
     const auto getExternalE = GetExternalEField(pti, offset);
     const auto getExternalB = GetExternalBField(pti, offset);
 
@@ -170,6 +248,11 @@ PhotonParticleContainer::PushPX (WarpXParIter& pti,
 
     const auto t_do_not_gather = do_not_gather;
 
+    // NCI Godfrey filter applied in the gather, if any
+    amrex::Real const* nci_stencil_exeybz;
+    amrex::Real const* nci_stencil_bxbyez;
+    getNCIGatherStencils(gather_lev, nci_stencil_exeybz, nci_stencil_bxbyez);
+
     amrex::ParallelFor(
         np_to_push,
         [=] AMREX_GPU_DEVICE (long i) {
@@ -177,6 +260,15 @@ PhotonParticleContainer::PushPX (WarpXParIter& pti,
             ParticleReal x, y, z;
             GetPosition(i, x, y, z);
 
+#ifdef WARPX_QED
+            // (except when chi is recorded for the diagnostics)
+            if (!p_chi_extrema && ux[i]*ux[i] + uy[i]*uy[i] + uz[i]*uz[i] < u_min2) {
+                UpdatePositionPhoton( x, y, z, ux[i], uy[i], uz[i], dt );
+                SetPosition(i, x, y, z);
+                return;
+            }
+#endif
+
             amrex::ParticleReal Exp=0, Eyp=0, Ezp=0;
             amrex::ParticleReal Bxp=0, Byp=0, Bzp=0;
 
@@ -186,15 +278,19 @@ PhotonParticleContainer::PushPX (WarpXParIter& pti,
                                ex_arr, ey_arr, ez_arr, bx_arr, by_arr, bz_arr,
                                ex_type, ey_type, ez_type, bx_type, by_type, bz_type,
                                dx_arr, xyzmin_arr, lo, n_rz_azimuthal_modes,
-                               nox, galerkin_interpolation);
+                               nox, galerkin_interpolation,
+                               nci_stencil_exeybz, nci_stencil_bxbyez);
             }
             getExternalE(i, Exp, Eyp, Ezp);
             getExternalB(i, Bxp, Byp, Bzp);
 
 #ifdef WARPX_QED
-            if (local_has_breit_wheeler) {
-                evolve_opt(ux[i], uy[i], uz[i], Exp, Eyp, Ezp, Bxp, Byp, Bzp,
-                    dt, p_optical_depth_BW[i]);
+            evolve_opt(ux[i], uy[i], uz[i], Exp, Eyp, Ezp, Bxp, Byp, Bzp,
+                dt, p_optical_depth_BW[i]);
+            if (p_chi_extrema) {
+                QedUtils::RecordChiExtrema(p_chi_extrema, QedUtils::chi_photon(
+                    ux[i]*PhysConst::m_e, uy[i]*PhysConst::m_e, uz[i]*PhysConst::m_e,
+                    Exp, Eyp, Ezp, Bxp, Byp, Bzp));
             }
 #endif
 
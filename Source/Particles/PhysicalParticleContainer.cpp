@@ -15,12 +15,16 @@
 #include "Initialization/InjectorMomentum.H"
 #include "Initialization/InjectorPosition.H"
 #include "MultiParticleContainer.H"
+#include "Parallelization/WarpXComm_K.H"
 #ifdef WARPX_QED
 #   include "Particles/ElementaryProcess/QEDInternals/BreitWheelerEngineWrapper.H"
+#   include "Particles/ElementaryProcess/QEDInternals/QedChiFunctions.H"
 #   include "Particles/ElementaryProcess/QEDInternals/QuantumSyncEngineWrapper.H"
 #endif
+#include "Particles/Deposition/CurrentDeposition.H"
 #include "Particles/Gather/FieldGather.H"
 #include "Particles/Gather/GetExternalFields.H"
+#include "Particles/ParticleCreation/ParticleIDs.H"
 #include "Particles/Pusher/CopyParticleAttribs.H"
 #include "Particles/Pusher/GetAndSetPosition.H"
 #include "Particles/Pusher/PushSelector.H"
@@ -31,6 +35,7 @@
 #include "Particles/Pusher/UpdatePosition.H"
 #include "Particles/SpeciesPhysicalProperties.H"
 #include "Particles/WarpXParticleContainer.H"
+#include "Utils/CounterBasedRandom.H"
 #include "Utils/IonizationEnergiesTable.H"
 #include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXConst.H"
@@ -40,6 +45,7 @@
 
 #include <AMReX.H>
 #include <AMReX_Algorithm.H>
+#include <AMReX_Arena.H>
 #include <AMReX_Array.H>
 #include <AMReX_Array4.H>
 #include <AMReX_ArrayOfStructs.H>
@@ -53,6 +59,7 @@
 #include <AMReX_FabArray.H>
 #include <AMReX_Geometry.H>
 #include <AMReX_GpuAtomic.H>
+#include <AMReX_GpuContainers.H>
 #include <AMReX_GpuControl.H>
 #include <AMReX_GpuDevice.H>
 #include <AMReX_GpuElixir.H>
@@ -66,6 +73,7 @@
 #include <AMReX_Math.H>
 #include <AMReX_MultiFab.H>
 #include <AMReX_PODVector.H>
+#include <AMReX_Reduce.H>
 #include <AMReX_ParGDB.H>
 #include <AMReX_ParIter.H>
 #include <AMReX_ParallelDescriptor.H>
@@ -94,6 +102,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <limits>
 #include <map>
@@ -135,6 +144,52 @@ namespace
         return z0;
     }
 
+    /**
+     * \brief Map a particle from the lab frame to the boosted frame, assuming that
+     * this happens at the start of the simulation (t_lab = 0). This boosts the particle
+     * to the boosted frame and calculates the particle time in the boosted frame.
+     * It then maps the position to the time in the boosted frame.
+     */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    void mapParticletoBoostedFrame (Real& x, Real& y, Real& z, Real& ux, Real& uy, Real& uz,
+                                    const Real gamma_boost, const Real beta_boost,
+                                    const bool do_backward_propagation,
+                                    const bool boost_adjust_transverse_positions) noexcept
+    {
+        const Real t_lab = 0._rt;
+
+        const Real uz_boost = gamma_boost*beta_boost*PhysConst::c;
+
+        // tpr is the particle's time in the boosted frame
+        Real tpr = gamma_boost*t_lab - uz_boost*z/(PhysConst::c*PhysConst::c);
+
+        // The particle's transformed location in the boosted frame
+        Real xpr = x;
+        Real ypr = y;
+        Real zpr = gamma_boost*z - uz_boost*t_lab;
+
+        // transform u and gamma to the boosted frame
+        Real gamma_lab = std::sqrt(1._rt + (ux*ux + uy*uy + uz*uz)/(PhysConst::c*PhysConst::c));
+        uz = gamma_boost*uz - uz_boost*gamma_lab;
+        Real gammapr = std::sqrt(1._rt + (ux*ux + uy*uy + uz*uz)/(PhysConst::c*PhysConst::c));
+
+        Real vxpr = ux/gammapr;
+        Real vypr = uy/gammapr;
+        Real vzpr = uz/gammapr;
+
+        if (do_backward_propagation){
+            uz = -uz;
+        }
+
+        // Move the particles to where they will be at t = 0 in the boosted frame
+        if (boost_adjust_transverse_positions) {
+            x = xpr - tpr*vxpr;
+            y = ypr - tpr*vypr;
+        }
+
+        z = zpr - tpr*vzpr;
+    }
+
     AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
     XDim3 getCellCoords (const GpuArray<Real, AMREX_SPACEDIM>& lo_corner,
                          const GpuArray<Real, AMREX_SPACEDIM>& dx,
@@ -204,6 +259,24 @@ namespace
 
         p.id() = -1;
     }
+
+    /** \brief Maximum absolute value of the field `fab` in the cells of `tilebox`
+     * (converted to the staggering of `fab`) that are in `fab` */
+    Real maxAbsInTile (const FArrayBox& fab, const Box& tilebox)
+    {
+        const Box box = amrex::convert(tilebox, fab.box().ixType()) & fab.box();
+        if (!box.ok()) return 0._rt;
+        amrex::Array4<const Real> const& arr = fab.const_array();
+        ReduceOps<ReduceOpMax> reduce_op;
+        ReduceData<Real> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+        reduce_op.eval(box, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+            {
+                return {amrex::Math::abs(arr(i,j,k))};
+            });
+        return amrex::get<0>(reduce_data.value());
+    }
 }
 
 PhysicalParticleContainer::PhysicalParticleContainer (AmrCore* amr_core, int ispecies,
@@ -232,6 +305,8 @@ PhysicalParticleContainer::PhysicalParticleContainer (AmrCore* amr_core, int isp
     pp_species_name.query("do_not_push", do_not_push);
 
     pp_species_name.query("do_continuous_injection", do_continuous_injection);
+    pp_species_name.query("do_cache_injection", m_do_cache_injection);
+    pp_species_name.query("boosted_density_table_points", m_boosted_density_table_points);
     pp_species_name.query("initialize_self_fields", initialize_self_fields);
     queryWithParser(pp_species_name, "self_fields_required_precision", self_fields_required_precision);
     queryWithParser(pp_species_name, "self_fields_absolute_tolerance", self_fields_absolute_tolerance);
@@ -357,47 +432,10 @@ void PhysicalParticleContainer::MapParticletoBoostedFrame (
     Real& x, Real& y, Real& z, Real& ux, Real& uy, Real& uz)
 {
     // Map the particles from the lab frame to the boosted frame.
-    // This boosts the particle to the lab frame and calculates
-    // the particle time in the boosted frame. It then maps
-    // the position to the time in the boosted frame.
-
     // For now, start with the assumption that this will only happen
     // at the start of the simulation.
-    const Real t_lab = 0._rt;
-
-    const Real uz_boost = WarpX::gamma_boost*WarpX::beta_boost*PhysConst::c;
-
-    // tpr is the particle's time in the boosted frame
-    Real tpr = WarpX::gamma_boost*t_lab - uz_boost*z/(PhysConst::c*PhysConst::c);
-
-    // The particle's transformed location in the boosted frame
-    Real xpr = x;
-    Real ypr = y;
-    Real zpr = WarpX::gamma_boost*z - uz_boost*t_lab;
-
-    // transform u and gamma to the boosted frame
-    Real gamma_lab = std::sqrt(1._rt + (ux*ux + uy*uy + uz*uz)/(PhysConst::c*PhysConst::c));
-    // ux = ux;
-    // uy = uy;
-    uz = WarpX::gamma_boost*uz - uz_boost*gamma_lab;
-    Real gammapr = std::sqrt(1._rt + (ux*ux + uy*uy + uz*uz)/(PhysConst::c*PhysConst::c));
-
-    Real vxpr = ux/gammapr;
-    Real vypr = uy/gammapr;
-    Real vzpr = uz/gammapr;
-
-    if (do_backward_propagation){
-        uz = -uz;
-    }
-
-    // Move the particles to where they will be at t = 0 in the boosted frame
-    if (boost_adjust_transverse_positions) {
-        x = xpr - tpr*vxpr;
-        y = ypr - tpr*vypr;
-    }
-
-    z = zpr - tpr*vzpr;
-
+    mapParticletoBoostedFrame(x, y, z, ux, uy, uz, WarpX::gamma_boost, WarpX::beta_boost,
+                              do_backward_propagation, boost_adjust_transverse_positions);
 }
 
 void
@@ -408,71 +446,138 @@ PhysicalParticleContainer::AddGaussianBeam (
     const Real q_tot, long npart,
     const int do_symmetrize) {
 
-    // Declare temporary vectors on the CPU
-    Gpu::HostVector<ParticleReal> particle_x;
-    Gpu::HostVector<ParticleReal> particle_y;
-    Gpu::HostVector<ParticleReal> particle_z;
-    Gpu::HostVector<ParticleReal> particle_ux;
-    Gpu::HostVector<ParticleReal> particle_uy;
-    Gpu::HostVector<ParticleReal> particle_uz;
-    Gpu::HostVector<ParticleReal> particle_w;
-    int np = 0;
+    WARPX_PROFILE("PhysicalParticleContainer::AddGaussianBeam()");
+
+    // If do_symmetrize, create 4x fewer particles, and
+    // Replicate each particle 4 times (x,y) (-x,y) (x,-y) (-x,-y)
+    if (do_symmetrize){
+        npart /= 4;
+    }
+    const int nsym = do_symmetrize ? 4 : 1;
+#if (defined WARPX_DIM_3D) || (defined WARPX_DIM_RZ)
+    const Real weight = q_tot/(npart*charge)/nsym;
+#elif (defined WARPX_DIM_XZ)
+    const Real weight = q_tot/(npart*charge*y_rms)/nsym;
+#endif
 
+    // Each MPI rank generates the particles of a contiguous range of indices.
+    // The positions are drawn with a counter-based random number generator,
+    // indexed by the global particle index, so that they do not depend on the
+    // number of MPI ranks. Redistribute() then moves the particles to their boxes.
+    const long nprocs = ParallelDescriptor::NProcs();
+    const long myproc = ParallelDescriptor::MyProc();
+    const long i_begin = (npart/nprocs)*myproc + std::min(myproc, npart%nprocs);
+    const long i_end = i_begin + npart/nprocs + ((myproc < npart%nprocs) ? 1 : 0);
+    const long np_range = i_end - i_begin;
+
+    // Same seed on all ranks (this follows warpx.random_seed)
+    unsigned int seed = 0;
     if (ParallelDescriptor::IOProcessor()) {
-        // If do_symmetrize, create 4x fewer particles, and
-        // Replicate each particle 4 times (x,y) (-x,y) (x,-y) (-x,-y)
-        if (do_symmetrize){
-            npart /= 4;
-        }
-        for (long i = 0; i < npart; ++i) {
+        seed = amrex::Random_int(std::numeric_limits<unsigned int>::max());
+    }
+    ParallelDescriptor::Bcast(&seed, 1, ParallelDescriptor::IOProcessorNumber());
+    const std::uint64_t rng_seed = CounterBasedRandom::Hash(seed, species_id);
+
+    const Real xmin = plasma_injector->xmin, xmax = plasma_injector->xmax;
+    const Real ymin = plasma_injector->ymin, ymax = plasma_injector->ymax;
+    const Real zmin = plasma_injector->zmin, zmax = plasma_injector->zmax;
+
+    // Position of particle i (global index)
+    const auto get_position = [=] AMREX_GPU_HOST_DEVICE (const long i, Real& x, Real& y, Real& z)
+    {
+        const std::uint64_t counter = 3*static_cast<std::uint64_t>(i);
+        x = CounterBasedRandom::Normal(rng_seed, counter, x_m, x_rms);
 #if (defined WARPX_DIM_3D) || (defined WARPX_DIM_RZ)
-            const Real weight = q_tot/(npart*charge);
-            const Real x = amrex::RandomNormal(x_m, x_rms);
-            const Real y = amrex::RandomNormal(y_m, y_rms);
-            const Real z = amrex::RandomNormal(z_m, z_rms);
+        y = CounterBasedRandom::Normal(rng_seed, counter+1, y_m, y_rms);
 #elif (defined WARPX_DIM_XZ)
-            const Real weight = q_tot/(npart*charge*y_rms);
-            const Real x = amrex::RandomNormal(x_m, x_rms);
-            constexpr Real y = 0._prt;
-            const Real z = amrex::RandomNormal(z_m, z_rms);
-#endif
-            if (plasma_injector->insideBounds(x, y, z)  &&
-                std::abs( x - x_m ) < x_cut * x_rms     &&
-                std::abs( y - y_m ) < y_cut * y_rms     &&
-                std::abs( z - z_m ) < z_cut * z_rms   ) {
-                XDim3 u = plasma_injector->getMomentum(x, y, z);
-                u.x *= PhysConst::c;
-                u.y *= PhysConst::c;
-                u.z *= PhysConst::c;
-                if (do_symmetrize){
-                    // Add four particles to the beam:
-                    CheckAndAddParticle(x, y, z, u.x, u.y, u.z, weight/4._rt,
-                                        particle_x,  particle_y,  particle_z,
-                                        particle_ux, particle_uy, particle_uz,
-                                        particle_w);
-                    CheckAndAddParticle(x, -y, z, u.x, -u.y, u.z, weight/4._rt,
-                                        particle_x,  particle_y,  particle_z,
-                                        particle_ux, particle_uy, particle_uz,
-                                        particle_w);
-                    CheckAndAddParticle(-x, y, z, -u.x, u.y, u.z, weight/4._rt,
-                                        particle_x,  particle_y,  particle_z,
-                                        particle_ux, particle_uy, particle_uz,
-                                        particle_w);
-                    CheckAndAddParticle(-x, -y, z, -u.x, -u.y, u.z, weight/4._rt,
-                                        particle_x,  particle_y,  particle_z,
-                                        particle_ux, particle_uy, particle_uz,
-                                        particle_w);
-                } else {
-                    CheckAndAddParticle(x, y, z, u.x, u.y, u.z, weight,
-                                        particle_x,  particle_y,  particle_z,
-                                        particle_ux, particle_uy, particle_uz,
-                                        particle_w);
-                }
+        y = 0._rt;
+#endif
+        z = CounterBasedRandom::Normal(rng_seed, counter+2, z_m, z_rms);
+    };
+
+    // Flag the particles that are inside the bounds of the injector and within the cuts
+    Gpu::DeviceVector<int> is_kept(np_range);
+    Gpu::DeviceVector<int> kept_index(np_range);
+    int* const p_is_kept = is_kept.dataPtr();
+    int* const p_kept_index = kept_index.dataPtr();
+    amrex::ParallelFor(np_range, [=] AMREX_GPU_DEVICE (long ip) noexcept
+    {
+        Real x, y, z;
+        get_position(i_begin + ip, x, y, z);
+        p_is_kept[ip] = (x < xmax && x >= xmin &&
+                         y < ymax && y >= ymin &&
+                         z < zmax && z >= zmin &&
+                         std::abs( x - x_m ) < x_cut * x_rms &&
+                         std::abs( y - y_m ) < y_cut * y_rms &&
+                         std::abs( z - z_m ) < z_cut * z_rms );
+    });
+    const int nkept = (np_range > 0) ?
+        Scan::ExclusiveSum(static_cast<int>(np_range), p_is_kept, p_kept_index, Scan::retSum) : 0;
+    const int np = nkept*nsym;
+
+    Gpu::DeviceVector<ParticleReal> d_x(np), d_y(np), d_z(np), d_ux(np), d_uy(np), d_uz(np);
+    ParticleReal* const px = d_x.dataPtr();
+    ParticleReal* const py = d_y.dataPtr();
+    ParticleReal* const pz = d_z.dataPtr();
+    ParticleReal* const pux = d_ux.dataPtr();
+    ParticleReal* const puy = d_uy.dataPtr();
+    ParticleReal* const puz = d_uz.dataPtr();
+
+    InjectorMomentum* inj_mom = plasma_injector->getInjectorMomentum();
+    const bool do_boost = WarpX::gamma_boost > 1.;
+    const Real gamma_boost = WarpX::gamma_boost;
+    const Real beta_boost = WarpX::beta_boost;
+    const bool backward_propagation = do_backward_propagation;
+    const bool adjust_transverse_positions = boost_adjust_transverse_positions;
+    amrex::ParallelForRNG(np_range,
+    [=] AMREX_GPU_DEVICE (long ip, amrex::RandomEngine const& engine) noexcept
+    {
+        if (!p_is_kept[ip]) return;
+
+        Real x, y, z;
+        get_position(i_begin + ip, x, y, z);
+        XDim3 u = inj_mom->getMomentum(x, y, z, engine);
+        u.x *= PhysConst::c;
+        u.y *= PhysConst::c;
+        u.z *= PhysConst::c;
+
+        for (int is = 0; is < nsym; ++is) {
+            // Symmetrized copies: (x,y) (x,-y) (-x,y) (-x,-y)
+            const Real sx = (is < 2) ? 1._rt : -1._rt;
+            const Real sy = (is % 2 == 0) ? 1._rt : -1._rt;
+            Real xs = sx*x, ys = sy*y, zs = z;
+            Real uxs = sx*u.x, uys = sy*u.y, uzs = u.z;
+            if (do_boost) {
+                mapParticletoBoostedFrame(xs, ys, zs, uxs, uys, uzs, gamma_boost, beta_boost,
+                                          backward_propagation, adjust_transverse_positions);
             }
+            const int i = p_kept_index[ip]*nsym + is;
+            px[i] = xs;
+            py[i] = ys;
+            pz[i] = zs;
+            pux[i] = uxs;
+            puy[i] = uys;
+            puz[i] = uzs;
         }
-    }
+    });
+
+    // Copy the particles to the CPU
+    Gpu::HostVector<ParticleReal> particle_x(np);
+    Gpu::HostVector<ParticleReal> particle_y(np);
+    Gpu::HostVector<ParticleReal> particle_z(np);
+    Gpu::HostVector<ParticleReal> particle_ux(np);
+    Gpu::HostVector<ParticleReal> particle_uy(np);
+    Gpu::HostVector<ParticleReal> particle_uz(np);
+    Gpu::HostVector<ParticleReal> particle_w(np, weight);
+    Gpu::copyAsync(Gpu::deviceToHost, d_x.begin(), d_x.end(), particle_x.begin());
+    Gpu::copyAsync(Gpu::deviceToHost, d_y.begin(), d_y.end(), particle_y.begin());
+    Gpu::copyAsync(Gpu::deviceToHost, d_z.begin(), d_z.end(), particle_z.begin());
+    Gpu::copyAsync(Gpu::deviceToHost, d_ux.begin(), d_ux.end(), particle_ux.begin());
+    Gpu::copyAsync(Gpu::deviceToHost, d_uy.begin(), d_uy.end(), particle_uy.begin());
+    Gpu::copyAsync(Gpu::deviceToHost, d_uz.begin(), d_uz.end(), particle_uz.begin());
+    Gpu::streamSynchronize();
+
     // Add the temporary CPU vectors to the particle structure
-    np = particle_z.size();
     AddNParticles(0,np,
                   particle_x.dataPtr(),  particle_y.dataPtr(),  particle_z.dataPtr(),
                   particle_ux.dataPtr(), particle_uy.dataPtr(), particle_uz.dataPtr(),
@@ -493,88 +598,96 @@ PhysicalParticleContainer::AddPlasmaFromFile(ParticleReal q_tot,
     Gpu::HostVector<ParticleReal> particle_uy;
 
 #ifdef WARPX_USE_OPENPMD
-    //TODO: Make changes for read/write in multiple MPI ranks
-    if (ParallelDescriptor::IOProcessor()) {
-        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(plasma_injector,
-                                         "AddPlasmaFromFile: plasma injector not initialized.\n");
-        // take ownership of the series and close it when done
-        auto series = std::move(plasma_injector->m_openpmd_input_series);
-
-        // assumption asserts: see PlasmaInjector
-        openPMD::Iteration it = series->iterations.begin()->second;
-        std::string const ps_name = it.particles.begin()->first;
-        openPMD::ParticleSpecies ps = it.particles.begin()->second;
-
-        auto const npart = ps["position"]["x"].getExtent()[0];
-        std::shared_ptr<ParticleReal> ptr_x = ps["position"]["x"].loadChunk<ParticleReal>();
-        double const position_unit_x = ps["position"]["x"].unitSI();
-        std::shared_ptr<ParticleReal> ptr_z = ps["position"]["z"].loadChunk<ParticleReal>();
-        double const position_unit_z = ps["position"]["z"].unitSI();
-        std::shared_ptr<ParticleReal> ptr_ux = ps["momentum"]["x"].loadChunk<ParticleReal>();
-        double const momentum_unit_x = ps["momentum"]["x"].unitSI();
-        std::shared_ptr<ParticleReal> ptr_uz = ps["momentum"]["z"].loadChunk<ParticleReal>();
-        double const momentum_unit_z = ps["momentum"]["z"].unitSI();
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(plasma_injector,
+                                     "AddPlasmaFromFile: plasma injector not initialized.\n");
+    // take ownership of the series and close it when done
+    auto series = std::move(plasma_injector->m_openpmd_input_series);
+
+    // assumption asserts: see PlasmaInjector
+    openPMD::Iteration it = series->iterations.begin()->second;
+    std::string const ps_name = it.particles.begin()->first;
+    openPMD::ParticleSpecies ps = it.particles.begin()->second;
+
+    auto const npart = ps["position"]["x"].getExtent()[0];
+
+    // Each MPI rank reads a contiguous chunk of the particle records.
+    // Redistribute() then moves the particles to their boxes.
+    auto const nprocs = static_cast<decltype(npart)>(ParallelDescriptor::NProcs());
+    auto const myproc = static_cast<decltype(npart)>(ParallelDescriptor::MyProc());
+    auto const chunk_begin = (npart/nprocs)*myproc + std::min(myproc, npart%nprocs);
+    auto const chunk_size = npart/nprocs + ((myproc < npart%nprocs) ? 1 : 0);
+    openPMD::Offset const chunk_offset = {chunk_begin};
+    openPMD::Extent const chunk_extent = {chunk_size};
+
+    std::shared_ptr<ParticleReal> ptr_x = ps["position"]["x"].loadChunk<ParticleReal>(chunk_offset, chunk_extent);
+    double const position_unit_x = ps["position"]["x"].unitSI();
+    std::shared_ptr<ParticleReal> ptr_z = ps["position"]["z"].loadChunk<ParticleReal>(chunk_offset, chunk_extent);
+    double const position_unit_z = ps["position"]["z"].unitSI();
+    std::shared_ptr<ParticleReal> ptr_ux = ps["momentum"]["x"].loadChunk<ParticleReal>(chunk_offset, chunk_extent);
+    double const momentum_unit_x = ps["momentum"]["x"].unitSI();
+    std::shared_ptr<ParticleReal> ptr_uz = ps["momentum"]["z"].loadChunk<ParticleReal>(chunk_offset, chunk_extent);
+    double const momentum_unit_z = ps["momentum"]["z"].unitSI();
 #   ifndef WARPX_DIM_XZ
-        std::shared_ptr<ParticleReal> ptr_y = ps["position"]["y"].loadChunk<ParticleReal>();
-        double const position_unit_y = ps["position"]["y"].unitSI();
+    std::shared_ptr<ParticleReal> ptr_y = ps["position"]["y"].loadChunk<ParticleReal>(chunk_offset, chunk_extent);
+    double const position_unit_y = ps["position"]["y"].unitSI();
 #   endif
-        std::shared_ptr<ParticleReal> ptr_uy = nullptr;
-        double momentum_unit_y = 1.0;
-        if (ps["momentum"].contains("y")) {
-            ptr_uy = ps["momentum"]["y"].loadChunk<ParticleReal>();
-             momentum_unit_y = ps["momentum"]["y"].unitSI();
-        }
-        series->flush();  // shared_ptr data can be read now
-
-        ParticleReal weight = 1.0_prt;  // base standard: no info means "real" particles
-        if (q_tot != 0.0) {
-            weight = std::abs(q_tot) / ( std::abs(charge) * ParticleReal(npart) );
-            if (ps.contains("weighting")) {
-                std::stringstream ss;
-                ss << "Both '" << ps_name << ".q_tot' and '"
-                        << ps_name << ".injection_file' specify a total charge.\n'"
-                        << ps_name << ".q_tot' will take precedence.";
-                WarpX::GetInstance().RecordWarning("Species", ss.str());
-            }
-        }
-        // ED-PIC extension?
-        else if (ps.contains("weighting")) {
-            // TODO: Add ASSERT_WITH_MESSAGE to test if weighting is a constant record
-            // TODO: Add ASSERT_WITH_MESSAGE for macroWeighted value in ED-PIC
-            ParticleReal w = ps["weighting"][openPMD::RecordComponent::SCALAR].loadChunk<ParticleReal>().get()[0];
-            double const w_unit = ps["weighting"][openPMD::RecordComponent::SCALAR].unitSI();
-            weight = w * w_unit;
+    std::shared_ptr<ParticleReal> ptr_uy = nullptr;
+    double momentum_unit_y = 1.0;
+    if (ps["momentum"].contains("y")) {
+        ptr_uy = ps["momentum"]["y"].loadChunk<ParticleReal>(chunk_offset, chunk_extent);
+         momentum_unit_y = ps["momentum"]["y"].unitSI();
+    }
+    series->flush();  // shared_ptr data can be read now
+
+    ParticleReal weight = 1.0_prt;  // base standard: no info means "real" particles
+    if (q_tot != 0.0) {
+        weight = std::abs(q_tot) / ( std::abs(charge) * ParticleReal(npart) );
+        if (ps.contains("weighting") && ParallelDescriptor::IOProcessor()) {
+            std::stringstream ss;
+            ss << "Both '" << ps_name << ".q_tot' and '"
+                    << ps_name << ".injection_file' specify a total charge.\n'"
+                    << ps_name << ".q_tot' will take precedence.";
+            WarpX::GetInstance().RecordWarning("Species", ss.str());
         }
+    }
+    // ED-PIC extension?
+    else if (ps.contains("weighting")) {
+        // TODO: Add ASSERT_WITH_MESSAGE to test if weighting is a constant record
+        // TODO: Add ASSERT_WITH_MESSAGE for macroWeighted value in ED-PIC
+        ParticleReal w = ps["weighting"][openPMD::RecordComponent::SCALAR].loadChunk<ParticleReal>().get()[0];
+        double const w_unit = ps["weighting"][openPMD::RecordComponent::SCALAR].unitSI();
+        weight = w * w_unit;
+    }
 
-        for (auto i = decltype(npart){0}; i<npart; ++i){
-            ParticleReal const x = ptr_x.get()[i]*position_unit_x;
-            ParticleReal const z = ptr_z.get()[i]*position_unit_z+z_shift;
+    for (auto i = decltype(npart){0}; i<chunk_size; ++i){
+        ParticleReal const x = ptr_x.get()[i]*position_unit_x;
+        ParticleReal const z = ptr_z.get()[i]*position_unit_z+z_shift;
 #   if (defined WARPX_DIM_3D) || (defined WARPX_DIM_RZ)
-            ParticleReal const y = ptr_y.get()[i]*position_unit_y;
+        ParticleReal const y = ptr_y.get()[i]*position_unit_y;
 #   else
-            ParticleReal const y = 0.0_prt;
+        ParticleReal const y = 0.0_prt;
 #   endif
-            if (plasma_injector->insideBounds(x, y, z)) {
-                ParticleReal const ux = ptr_ux.get()[i]*momentum_unit_x/PhysConst::m_e;
-                ParticleReal const uz = ptr_uz.get()[i]*momentum_unit_z/PhysConst::m_e;
-                ParticleReal uy = 0.0_prt;
-                if (ps["momentum"].contains("y")) {
-                    uy = ptr_uy.get()[i]*momentum_unit_y/PhysConst::m_e;
-                }
-                CheckAndAddParticle(x, y, z, ux, uy, uz, weight,
-                                    particle_x,  particle_y,  particle_z,
-                                    particle_ux, particle_uy, particle_uz,
-                                    particle_w);
+        if (plasma_injector->insideBounds(x, y, z)) {
+            ParticleReal const ux = ptr_ux.get()[i]*momentum_unit_x/PhysConst::m_e;
+            ParticleReal const uz = ptr_uz.get()[i]*momentum_unit_z/PhysConst::m_e;
+            ParticleReal uy = 0.0_prt;
+            if (ps["momentum"].contains("y")) {
+                uy = ptr_uy.get()[i]*momentum_unit_y/PhysConst::m_e;
             }
+            CheckAndAddParticle(x, y, z, ux, uy, uz, weight,
+                                particle_x,  particle_y,  particle_z,
+                                particle_ux, particle_uy, particle_uz,
+                                particle_w);
         }
-        auto const np = particle_z.size();
-        if (np < npart) {
-            WarpX::GetInstance().RecordWarning("Species",
-                "Simulation box doesn't cover all particles",
-                WarnPriority::high);
-        }
-    } // IO Processor
+    }
     auto const np = particle_z.size();
+    amrex::Long np_total = np;
+    ParallelDescriptor::ReduceLongSum(np_total);
+    if (static_cast<decltype(npart)>(np_total) < npart && ParallelDescriptor::IOProcessor()) {
+        WarpX::GetInstance().RecordWarning("Species",
+            "Simulation box doesn't cover all particles",
+            WarnPriority::high);
+    }
     AddNParticles(0, np,
                   particle_x.dataPtr(),  particle_y.dataPtr(),  particle_z.dataPtr(),
                   particle_ux.dataPtr(), particle_uy.dataPtr(), particle_uz.dataPtr(),
@@ -749,6 +862,43 @@ PhysicalParticleContainer::AddPlasma (int lev, RealBox part_realbox)
     bool radially_weighted = plasma_injector->radially_weighted;
 #endif
 
+    // With a moving window along z, a density that does not depend on z and regular
+    // positions, the density of the injected particles only depends on the transverse
+    // cell and on the index of the particle in the cell: it is computed once and cached.
+    bool use_density_cache = false;
+#if !defined(WARPX_DIM_RZ)
+    use_density_cache = m_do_cache_injection && do_continuous_injection && lev == 0 &&
+        !refine_injection && (WarpX::moving_window_dir == AMREX_SPACEDIM-1) &&
+        plasma_injector->hasRegularPositions() && plasma_injector->densityIsZInvariant();
+#endif
+    const Box& domain_box = geom.Domain();
+    const IntVect domain_lo = domain_box.smallEnd();
+    const int ncache_x = domain_box.length(0);
+#if (AMREX_SPACEDIM == 3)
+    const int ncache_y = domain_box.length(1);
+#else
+    const int ncache_y = 1;
+#endif
+    constexpr Real density_not_cached = std::numeric_limits<Real>::lowest();
+    Real* p_density_cache = nullptr;
+    if (use_density_cache) {
+        const std::size_t cache_size = static_cast<std::size_t>(ncache_x)*ncache_y*num_ppc;
+        if (m_injection_density_cache.size() != cache_size) {
+            m_injection_density_cache.resize(cache_size);
+            Real* const p_cache = m_injection_density_cache.dataPtr();
+            amrex::ParallelFor(static_cast<long>(cache_size), [=] AMREX_GPU_DEVICE (long i) noexcept
+            {
+                p_cache[i] = density_not_cached;
+            });
+        }
+        p_density_cache = m_injection_density_cache.dataPtr();
+    }
+
+    // In a boosted frame, with a density that only depends on z, the lab-frame density
+    // is tabulated along the lab-frame z of each tile and interpolated for each particle
+    const bool use_density_table = (gamma_boost > 1._rt) && (m_boosted_density_table_points > 0) &&
+        !use_density_cache && plasma_injector->densityIsTransverseInvariant();
+
     MFItInfo info;
     if (do_tiling && Gpu::notInLaunchRegion()) {
         info.EnableTiling(tile_size);
@@ -848,17 +998,49 @@ PhysicalParticleContainer::AddPlasma (int lev, RealBox part_realbox)
         // and invalid ones are then discarded
         int max_new_particles = Scan::ExclusiveSum(counts.size(), counts.data(), offset.data());
 
-        // Update NextID to include particles created in this function
-        Long pid;
-#ifdef AMREX_USE_OMP
-#pragma omp critical (add_plasma_nextid)
+        // Table of the lab-frame density, on the lab-frame z range of the cells of the tile
+        Gpu::DeviceVector<Real> density_table;
+        const Real* p_density_table = nullptr;
+        int table_n = 0;
+        Real table_zmin = 0._rt;
+        Real table_dzi = 0._rt;
+        if (use_density_table && max_new_particles > 0) {
+            ReduceOps<ReduceOpMin, ReduceOpMax> reduce_op;
+            ReduceData<Real, Real> reduce_data(reduce_op);
+            using ReduceTuple = typename decltype(reduce_data)::Type;
+            reduce_op.eval(overlap_box, reduce_data,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+                {
+                    IntVect iv(AMREX_D_DECL(i, j, k));
+                    auto lo = getCellCoords(overlap_corner, dx, {0._rt, 0._rt, 0._rt}, iv);
+                    auto hi = getCellCoords(overlap_corner, dx, {1._rt, 1._rt, 1._rt}, iv);
+                    const Real zlo = applyBallisticCorrection(lo, inj_mom, gamma_boost, beta_boost, t);
+                    const Real zhi = applyBallisticCorrection(hi, inj_mom, gamma_boost, beta_boost, t);
+#if (AMREX_SPACEDIM != 3)
+                    amrex::ignore_unused(k);
 #endif
-        {
-            pid = ParticleType::NextID();
-            ParticleType::NextID(pid+max_new_particles);
+                    return {amrex::min(zlo, zhi), amrex::max(zlo, zhi)};
+                });
+            ReduceTuple hv = reduce_data.value();
+            table_zmin = amrex::get<0>(hv);
+            const Real table_zmax = amrex::get<1>(hv);
+            if (table_zmax > table_zmin) {
+                table_n = overlap_box.length(AMREX_SPACEDIM-1)*m_boosted_density_table_points + 1;
+                table_dzi = (table_n - 1)/(table_zmax - table_zmin);
+                density_table.resize(table_n);
+                Real* const p_table = density_table.dataPtr();
+                const Real zmin = table_zmin;
+                const Real dz = 1._rt/table_dzi;
+                amrex::ParallelFor(table_n, [=] AMREX_GPU_DEVICE (int i) noexcept
+                {
+                    p_table[i] = inj_rho->getDensity(0._rt, 0._rt, zmin + i*dz);
+                });
+                p_density_table = density_table.dataPtr();
+            }
         }
-        WarpXUtilMsg::AlwaysAssert(static_cast<Long>(pid + max_new_particles) < LastParticleID,
-                                   "ERROR: overflow on particle id numbers");
+
+        // Reserve the ids of the particles created in this function
+        const Long pid = ParticleIDs::ReserveIDs<ParticleType>(max_new_particles);
 
         const int cpuid = ParallelDescriptor::MyProc();
 
@@ -972,6 +1154,20 @@ PhysicalParticleContainer::AddPlasma (int lev, RealBox part_realbox)
                 Real xb = pos.x;
                 Real yb = pos.y;
 
+                // Index of this particle in the density cache (-1 if not cached)
+                long i_cache = -1;
+                if (p_density_cache) {
+                    const int icx = i + shifted[0] - domain_lo[0];
+#if (AMREX_SPACEDIM == 3)
+                    const int icy = j + shifted[1] - domain_lo[1];
+#else
+                    const int icy = 0;
+#endif
+                    if (icx >= 0 && icx < ncache_x && icy >= 0 && icy < ncache_y) {
+                        i_cache = (static_cast<long>(icy)*ncache_x + icx)*num_ppc + i_part;
+                    }
+                }
+
 #ifdef WARPX_DIM_RZ
                 // Replace the x and y, setting an angle theta.
                 // These x and y are used to get the momentum and density
@@ -1009,7 +1205,13 @@ PhysicalParticleContainer::AddPlasma (int lev, RealBox part_realbox)
                     }
 
                     u = inj_mom->getMomentum(pos.x, pos.y, z0, engine);
-                    dens = inj_rho->getDensity(pos.x, pos.y, z0);
+                    if (i_cache >= 0 && p_density_cache[i_cache] != density_not_cached) {
+                        dens = p_density_cache[i_cache];
+                    } else {
+                        dens = inj_rho->getDensity(pos.x, pos.y, z0);
+                        // The threads that compute the same cached value store the same result
+                        if (i_cache >= 0) p_density_cache[i_cache] = dens;
+                    }
 
                     // Remove particle if density below threshold
                     if ( dens < density_min ){
@@ -1040,7 +1242,18 @@ PhysicalParticleContainer::AddPlasma (int lev, RealBox part_realbox)
                         continue;
                     }
                     // call `getDensity` with lab-frame parameters
-                    dens = inj_rho->getDensity(pos.x, pos.y, z0_lab);
+                    const Real s_table = (z0_lab - table_zmin)*table_dzi;
+                    const int i_table = p_density_table ? static_cast<int>(std::floor(s_table)) : -1;
+                    if (i_cache >= 0 && p_density_cache[i_cache] != density_not_cached) {
+                        dens = p_density_cache[i_cache];
+                    } else if (i_table >= 0 && i_table < table_n-1) {
+                        const Real w = s_table - i_table;
+                        dens = (1._rt - w)*p_density_table[i_table] + w*p_density_table[i_table+1];
+                    } else {
+                        dens = inj_rho->getDensity(pos.x, pos.y, z0_lab);
+                        // The threads that compute the same cached value store the same result
+                        if (i_cache >= 0) p_density_cache[i_cache] = dens;
+                    }
                     // Remove particle if density below threshold
                     if ( dens < density_min ){
                         ZeroInitializeAndSetNegativeID(p, pa, ip, loc_do_field_ionization, pi
@@ -1126,6 +1339,57 @@ PhysicalParticleContainer::AddPlasma (int lev, RealBox part_realbox)
     // The function that calls this is responsible for redistributing particles.
 }
 
+void
+PhysicalParticleContainer::EstimateInitialParticles (const BoxArray& ba, const Geometry& geom,
+                                                     int sampling, Vector<Real>& nparticles) const
+{
+    if (!plasma_injector || !plasma_injector->doInjection() || plasma_injector->gaussian_beam ||
+        plasma_injector->external_file) return;
+
+    InjectorPosition* inj_pos = plasma_injector->getInjectorPosition();
+    InjectorDensity*  inj_rho = plasma_injector->getInjectorDensity();
+    InjectorMomentum* inj_mom = plasma_injector->getInjectorMomentum();
+    const Real gamma_boost = WarpX::gamma_boost;
+    const Real beta_boost = WarpX::beta_boost;
+    const Real density_min = plasma_injector->density_min;
+    const Real num_ppc = plasma_injector->num_particles_per_cell;
+
+    // The plasma is created on level 0, with num_ppc particles per cell of level 0
+    const auto dx = geom.CellSizeArray();
+    const auto dx0 = Geom(0).CellSizeArray();
+    Real cell_ratio = 1._rt;
+    GpuArray<Real,AMREX_SPACEDIM> dx_sample;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        cell_ratio *= dx[idim]/dx0[idim];
+        dx_sample[idim] = dx[idim]*sampling;
+    }
+    const auto problo = geom.ProbLoArray();
+
+    // The boxes are shared between the ranks, and the sums are reduced by the caller
+    const int myproc = ParallelDescriptor::MyProc();
+    const int nprocs = ParallelDescriptor::NProcs();
+    for (int ibox = myproc; ibox < static_cast<int>(ba.size()); ibox += nprocs) {
+        const Box sample_box = amrex::coarsen(ba[ibox], sampling);
+        ReduceOps<ReduceOpSum> reduce_op;
+        ReduceData<Real> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+        reduce_op.eval(sample_box, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+            {
+                const IntVect iv(AMREX_D_DECL(i, j, k));
+                auto pos = getCellCoords(problo, dx_sample, {0.5_rt, 0.5_rt, 0.5_rt}, iv);
+                pos.z = applyBallisticCorrection(pos, inj_mom, gamma_boost, beta_boost, 0._rt);
+#if (AMREX_SPACEDIM != 3)
+                amrex::ignore_unused(k);
+#endif
+                if (!inj_pos->insideBounds(pos.x, pos.y, pos.z)) return {0._rt};
+                return {(inj_rho->getDensity(pos.x, pos.y, pos.z) >= density_min) ? 1._rt : 0._rt};
+            });
+        const Real fraction = amrex::get<0>(reduce_data.value())/static_cast<Real>(sample_box.numPts());
+        nparticles[ibox] += num_ppc*fraction*cell_ratio*static_cast<Real>(ba[ibox].numPts());
+    }
+}
+
 void
 PhysicalParticleContainer::AddPlasmaFlux (int lev, amrex::Real dt)
 {
@@ -1258,10 +1522,12 @@ PhysicalParticleContainer::AddPlasmaFlux (int lev, amrex::Real dt)
                           overlap_realbox.lo(1),
                           overlap_realbox.lo(2))};
 
-        // count the number of particles that each cell in overlap_box could add
-        Gpu::DeviceVector<int> counts(overlap_box.numPts(), 0);
-        Gpu::DeviceVector<int> offset(overlap_box.numPts());
-        auto pcounts = counts.data();
+        // count the number of particles that each cell in overlap_box could add.
+        // The buffers are freed once the kernels of this tile are done (see Elixir below),
+        // so that the tiles are processed without synchronizing the host and the device.
+        const auto ncells = overlap_box.numPts();
+        int* const pcounts = static_cast<int*>(amrex::The_Arena()->alloc(ncells*sizeof(int)));
+        int* const poffset = static_cast<int*>(amrex::The_Arena()->alloc(ncells*sizeof(int)));
         int lrrfac = rrfac;
         int lrefine_injection = refine_injection;
         Box lfine_box = fine_injection_box;
@@ -1273,9 +1539,10 @@ PhysicalParticleContainer::AddPlasmaFlux (int lev, amrex::Real dt)
 
             int num_ppc_int = static_cast<int>(num_ppc_real + amrex::Random(engine));
 
+            auto index = overlap_box.index(iv);
+            pcounts[index] = 0;
             if (inj_pos->overlapsWith(lo, hi))
             {
-                auto index = overlap_box.index(iv);
                 if (lrefine_injection) {
                     Box fine_overlap_box = overlap_box & amrex::shift(lfine_box, shifted);
                     if (fine_overlap_box.ok()) {
@@ -1292,21 +1559,17 @@ PhysicalParticleContainer::AddPlasmaFlux (int lev, amrex::Real dt)
 #endif
         });
 
-        // Max number of new particles. All of them are created,
-        // and invalid ones are then discarded
-        int max_new_particles = Scan::ExclusiveSum(counts.size(), counts.data(), offset.data());
+        // Offset of the particles of each cell. The total number of particles is not
+        // copied back to the host: the particle tile is instead resized with an upper bound
+        // of the number of new particles (all the new particles are created, and invalid
+        // ones are then discarded)
+        Scan::ExclusiveSum(static_cast<int>(ncells), pcounts, poffset, Scan::noRetSum);
+        const int max_ppc = static_cast<int>(std::ceil(num_ppc_real)) *
+            (refine_injection ? AMREX_D_TERM(rrfac,*rrfac,*rrfac) : 1);
+        const int max_new_particles = static_cast<int>(ncells) * max_ppc;
 
-        // Update NextID to include particles created in this function
-        Long pid;
-#ifdef AMREX_USE_OMP
-#pragma omp critical (add_plasma_nextid)
-#endif
-        {
-            pid = ParticleType::NextID();
-            ParticleType::NextID(pid+max_new_particles);
-        }
-        WarpXUtilMsg::AlwaysAssert(static_cast<Long>(pid + max_new_particles) < LastParticleID,
-                                   "ERROR: overflow on particle id numbers");
+        // Reserve the ids of the particles created in this function
+        const Long pid = ParticleIDs::ReserveIDs<ParticleType>(max_new_particles);
 
         const int cpuid = ParallelDescriptor::MyProc();
 
@@ -1364,11 +1627,16 @@ PhysicalParticleContainer::AddPlasmaFlux (int lev, amrex::Real dt)
         bool loc_do_field_ionization = do_field_ionization;
         int loc_ionization_initial_level = ionization_initial_level;
 
+        // The new particles beyond the actual number of injected particles are invalid
+        amrex::ParallelFor(max_new_particles, [=] AMREX_GPU_DEVICE (int ip) noexcept
+        {
+            pp[ip].id() = -1;
+        });
+
         // Loop over all new particles and inject them (creates too many
         // particles, in particular does not consider xmin, xmax etc.).
         // The invalid ones are given negative ID and are deleted during the
         // next redistribute.
-        const auto poffset = offset.data();
         amrex::ParallelForRNG(overlap_box,
         [=] AMREX_GPU_DEVICE (int i, int j, int k, amrex::RandomEngine const& engine) noexcept
         {
@@ -1495,15 +1763,20 @@ PhysicalParticleContainer::AddPlasmaFlux (int lev, amrex::Real dt)
             }
         });
 
-        amrex::Gpu::synchronize();
+        // Free the buffers of this tile once the kernels above are done
+        amrex::Gpu::Elixir counts_elixir(pcounts, amrex::The_Arena());
+        amrex::Gpu::Elixir offset_elixir(poffset, amrex::The_Arena());
 
         if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
         {
+            amrex::Gpu::synchronize();
             wt = amrex::second() - wt;
             amrex::HostDevice::Atomic::Add( &(*cost)[mfi.index()], wt);
         }
     }
 
+    amrex::Gpu::synchronize();
+
     // The function that calls this is responsible for redistributing particles.
 }
 
@@ -1526,12 +1799,36 @@ PhysicalParticleContainer::Evolve (int lev,
 
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
 
-    const iMultiFab* current_masks = WarpX::CurrentBufferMasks(lev);
-    const iMultiFab* gather_masks = WarpX::GatherBufferMasks(lev);
+    const BufferMasks* current_masks = WarpX::CurrentBufferMasks(lev);
+    const BufferMasks* gather_masks = WarpX::GatherBufferMasks(lev);
 
     bool has_buffer = cEx || cjx;
 
-    if (WarpX::do_back_transformed_diagnostics && do_back_transformed_diagnostics)
+    // Whether the particles far from the boundaries of the boxes were already pushed
+    // (and deposited their charge before the push) by PushInteriorParticles
+    const bool pushed_interior = !m_n_pushed_interior.empty();
+
+    // Whether the field gather, particle push and current deposition are done
+    // within a single kernel (only on GPU, where the particles deposit directly in J)
+#ifdef AMREX_USE_GPU
+    const bool do_fused_push_deposit = WarpX::do_fused_push_deposit &&
+        !has_buffer && !skip_deposition && !do_not_deposit && !pushed_interior &&
+        WarpX::current_deposition_algo == CurrentDepositionAlgo::Esirkepov;
+#else
+    const bool do_fused_push_deposit = false;
+#endif
+
+    // The tiles without particles are not visited by WarpXParIter; when no tile of this
+    // level has particles on this rank, skip the setup of the thread-local buffers too
+    bool has_local_particles = false;
+    for (auto const& kv : GetParticles(lev)) {
+        if (kv.second.numParticles() > 0) {
+            has_local_particles = true;
+            break;
+        }
+    }
+
+    if (has_local_particles && WarpX::do_back_transformed_diagnostics && do_back_transformed_diagnostics)
     {
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
         {
@@ -1544,9 +1841,13 @@ PhysicalParticleContainer::Evolve (int lev,
         }
     }
 
+    // Extrema of chi recorded by the push, if requested by the diagnostics for this step
+    if (!do_not_push) PrepareChiExtrema();
+
 #ifdef AMREX_USE_OMP
-#pragma omp parallel
+#pragma omp parallel if (has_local_particles)
 #endif
+    if (has_local_particles)
     {
 #ifdef AMREX_USE_OMP
         int thread_num = omp_get_thread_num();
@@ -1556,6 +1857,8 @@ PhysicalParticleContainer::Evolve (int lev,
 
         FArrayBox filtered_Ex, filtered_Ey, filtered_Ez;
         FArrayBox filtered_Bx, filtered_By, filtered_Bz;
+        FArrayBox nodal_Ex, nodal_Ey, nodal_Ez;
+        FArrayBox nodal_Bx, nodal_By, nodal_Bz;
 
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
         {
@@ -1585,8 +1888,22 @@ PhysicalParticleContainer::Evolve (int lev,
             FArrayBox const* bzfab = &Bz[pti];
 
             Elixir exeli, eyeli, ezeli, bxeli, byeli, bzeli;
+            Elixir nodal_exeli, nodal_eyeli, nodal_ezeli, nodal_bxeli, nodal_byeli, nodal_bzeli;
+
+            if (WarpX::do_on_the_fly_nodal_gather)
+            {
+                // Interpolate the staggered fields to the nodes of the tile
+                // and update the pointers exfab, ... so that they point to nodal_Ex, ...
+                const Box nodal_box = amrex::grow(pti.tilebox(), Ex.nGrowVect());
+                InterpolateFieldToNodal(nodal_box, nodal_exeli, nodal_Ex, exfab);
+                InterpolateFieldToNodal(nodal_box, nodal_eyeli, nodal_Ey, eyfab);
+                InterpolateFieldToNodal(nodal_box, nodal_ezeli, nodal_Ez, ezfab);
+                InterpolateFieldToNodal(nodal_box, nodal_bxeli, nodal_Bx, bxfab);
+                InterpolateFieldToNodal(nodal_box, nodal_byeli, nodal_By, byfab);
+                InterpolateFieldToNodal(nodal_box, nodal_bzeli, nodal_Bz, bzfab);
+            }
 
-            if (WarpX::use_fdtd_nci_corr)
+            if (WarpX::use_fdtd_nci_corr && !WarpX::nci_corr_in_gather)
             {
                 // Filter arrays Ex[pti], store the result in
                 // filtered_Ex and update pointer exfab so that it
@@ -1595,7 +1912,7 @@ PhysicalParticleContainer::Evolve (int lev,
                 applyNCIFilter(lev, pti.tilebox(), exeli, eyeli, ezeli, bxeli, byeli, bzeli,
                                filtered_Ex, filtered_Ey, filtered_Ez,
                                filtered_Bx, filtered_By, filtered_Bz,
-                               Ex[pti], Ey[pti], Ez[pti], Bx[pti], By[pti], Bz[pti],
+                               *exfab, *eyfab, *ezfab, *bxfab, *byfab, *bzfab,
                                exfab, eyfab, ezfab, bxfab, byfab, bzfab);
             }
 
@@ -1618,7 +1935,17 @@ PhysicalParticleContainer::Evolve (int lev,
 
             const long np_current = (cjx) ? nfine_current : np;
 
-            if (rho && ! skip_deposition) {
+            // Number of particles (at the beginning of the arrays) already pushed
+            const long np_pushed = pushed_interior ? m_n_pushed_interior[pti.LocalTileIndex()] : 0;
+
+            // Breakdown of the cost of this tile between push and deposition (algo.costs_breakdown)
+            amrex::LayoutData<amrex::Real>* const cost_push =
+                (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers) ?
+                WarpX::getCostsBreakdown(lev, CostsPhase::Push, species_id) : nullptr;
+            amrex::LayoutData<amrex::Real>* const cost_deposit = (cost_push) ?
+                WarpX::getCostsBreakdown(lev, CostsPhase::Deposit, species_id) : nullptr;
+
+            if (rho && ! skip_deposition && ! pushed_interior) {
                 // Deposit charge before particle push, in component 0 of MultiFab rho.
                 int* AMREX_RESTRICT ion_lev;
                 if (do_field_ionization){
@@ -1634,6 +1961,13 @@ PhysicalParticleContainer::Evolve (int lev,
                 }
             }
 
+            Real wt_push = wt;
+            if (cost_push) {
+                amrex::Gpu::synchronize();
+                wt_push = amrex::second();
+            }
+            Real wt_deposit = wt_push;
+
             if (! do_not_push)
             {
                 const long np_gather = (cEx) ? nfine_gather : np;
@@ -1644,10 +1978,24 @@ PhysicalParticleContainer::Evolve (int lev,
                 // Gather and push for particles not in the buffer
                 //
                 WARPX_PROFILE_VAR_START(blp_fg);
-                PushPX(pti, exfab, eyfab, ezfab,
-                       bxfab, byfab, bzfab,
-                       Ex.nGrowVect(), e_is_nodal,
-                       0, np_gather, lev, lev, dt, ScaleFields(false), a_dt_type);
+                if (do_fused_push_deposit) {
+                    // Gather, push and deposit current at t_{n+1/2}, in a single kernel
+                    int* AMREX_RESTRICT ion_lev;
+                    if (do_field_ionization){
+                        ion_lev = pti.GetiAttribs(particle_icomps["ionization_level"]).dataPtr();
+                    } else {
+                        ion_lev = nullptr;
+                    }
+                    PushPXAndDepositCurrent(pti, exfab, eyfab, ezfab,
+                                            bxfab, byfab, bzfab,
+                                            Ex.nGrowVect(), ion_lev, &jx, &jy, &jz,
+                                            np, lev, dt, ScaleFields(false), a_dt_type);
+                } else {
+                    PushPX(pti, exfab, eyfab, ezfab,
+                           bxfab, byfab, bzfab,
+                           Ex.nGrowVect(), e_is_nodal,
+                           np_pushed, np_gather-np_pushed, lev, lev, dt, ScaleFields(false), a_dt_type);
+                }
 
                 if (np_gather < np)
                 {
@@ -1662,7 +2010,7 @@ PhysicalParticleContainer::Evolve (int lev,
                     FArrayBox const* cbyfab = &(*cBy)[pti];
                     FArrayBox const* cbzfab = &(*cBz)[pti];
 
-                    if (WarpX::use_fdtd_nci_corr)
+                    if (WarpX::use_fdtd_nci_corr && !WarpX::nci_corr_in_gather)
                     {
                         // Filter arrays (*cEx)[pti], store the result in
                         // filtered_Ex and update pointer cexfab so that it
@@ -1687,10 +2035,15 @@ PhysicalParticleContainer::Evolve (int lev,
 
                 WARPX_PROFILE_VAR_STOP(blp_fg);
 
+                if (cost_push) {
+                    amrex::Gpu::synchronize();
+                    wt_deposit = amrex::second();
+                }
+
                 //
                 // Current Deposition
                 //
-                if (! skip_deposition) {
+                if (! skip_deposition && ! do_fused_push_deposit) {
                     int* AMREX_RESTRICT ion_lev;
                     if (do_field_ionization){
                         ion_lev = pti.GetiAttribs(particle_icomps["ionization_level"]).dataPtr();
@@ -1729,20 +2082,28 @@ PhysicalParticleContainer::Evolve (int lev,
                 }
             }
 
-            amrex::Gpu::synchronize();
-
             if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
             {
-                wt = amrex::second() - wt;
+                // The tiles are pushed concurrently (on several GPU streams) otherwise
+                amrex::Gpu::synchronize();
+                const Real wt_end = amrex::second();
+                if (cost_push) {
+                    amrex::HostDevice::Atomic::Add( &(*cost_push)[pti.index()], wt_deposit - wt_push);
+                    amrex::HostDevice::Atomic::Add( &(*cost_deposit)[pti.index()],
+                                                    (wt_push - wt) + (wt_end - wt_deposit));
+                }
+                wt = wt_end - wt;
                 amrex::HostDevice::Atomic::Add( &(*cost)[pti.index()], wt);
             }
         }
     }
+    m_n_pushed_interior.clear();
+
     // Split particles at the end of the timestep.
     // When subcycling is ON, the splitting is done on the last call to
     // PhysicalParticleContainer::Evolve on the finest level, i.e., at the
     // end of the large timestep. Otherwise, the pushes on different levels
-    // are not consistent, and the call to Redistribute (inside
+    // are not consistent, and the call to Redistribute (after
     // SplitParticles) may result in split particles to deposit twice on the
     // coarse level.
     if (do_splitting && (a_dt_type == DtType::SecondHalf || a_dt_type == DtType::Full) ){
@@ -1750,6 +2111,58 @@ PhysicalParticleContainer::Evolve (int lev,
     }
 }
 
+void
+PhysicalParticleContainer::PushInteriorParticles (int lev,
+                                                  const MultiFab& Ex, const MultiFab& Ey, const MultiFab& Ez,
+                                                  const MultiFab& Bx, const MultiFab& By, const MultiFab& Bz,
+                                                  MultiFab* rho, Real dt, DtType a_dt_type,
+                                                  bool skip_deposition, IntVect ng_gather)
+{
+    WARPX_PROFILE("PhysicalParticleContainer::PushInteriorParticles()");
+
+    m_n_pushed_interior.clear();
+    if (do_not_push) return;
+
+    {
+        WarpXParIter pti(*this, lev);
+        m_n_pushed_interior.resize(pti.length(), 0);
+    }
+
+    const int e_is_nodal = Ex.is_nodal() and Ey.is_nodal() and Ez.is_nodal();
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+    {
+#ifdef AMREX_USE_OMP
+        int thread_num = omp_get_thread_num();
+#else
+        int thread_num = 0;
+#endif
+        for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+        {
+            const long np = pti.numParticles();
+
+            // Reorder the particles, so that the n_interior first particles
+            // only gather the fields in the valid cells of the box
+            const long n_interior = PartitionInteriorParticles(pti, lev, ng_gather);
+
+            if (rho && ! skip_deposition) {
+                // Deposit charge before particle push, in component 0 of MultiFab rho.
+                // (This is done for all the particles of the tile, before any of them is pushed)
+                auto& wp = pti.GetAttribs(PIdx::w);
+                DepositCharge(pti, wp, nullptr, rho, 0, 0, np, thread_num, lev, lev);
+            }
+
+            PushPX(pti, &Ex[pti], &Ey[pti], &Ez[pti], &Bx[pti], &By[pti], &Bz[pti],
+                   Ex.nGrowVect(), e_is_nodal,
+                   0, n_interior, lev, lev, dt, ScaleFields(false), a_dt_type);
+
+            m_n_pushed_interior[pti.LocalTileIndex()] = n_interior;
+        }
+    }
+}
+
 void
 PhysicalParticleContainer::applyNCIFilter (
     int lev, const Box& box,
@@ -1823,172 +2236,220 @@ PhysicalParticleContainer::applyNCIFilter (
 #endif
 }
 
+void
+PhysicalParticleContainer::InterpolateFieldToNodal (
+    const Box& box, Elixir& eli, FArrayBox& nodal_fab, FArrayBox const * & fab_ptr)
+{
+    const FArrayBox& fab = *fab_ptr;
+    const int ncomp = fab.nComp();
+
+    const Box nodal_box = amrex::convert(box, IntVect::TheNodeVector());
+    nodal_fab.resize(nodal_box, ncomp);
+    // Safeguard for GPU
+    eli = nodal_fab.elixir();
+
+    const IntVect dst_stag = IntVect::TheNodeVector();
+    const IntVect src_stag = fab.box().ixType().toIntVect();
+
+    for (int n = 0; n < ncomp; ++n)
+    {
+        Array4<Real> const& dst = nodal_fab.array(n);
+        Array4<Real const> const& src = fab.const_array(n);
+
+        if (WarpX::maxwell_solver_id == MaxwellSolverAlgo::PSATD) {
+#ifdef WARPX_USE_PSATD
+            auto& warpx = WarpX::GetInstance();
+
+            // Order of finite-order centering of fields
+            const int fg_nox = WarpX::field_centering_nox;
+            const int fg_noy = WarpX::field_centering_noy;
+            const int fg_noz = WarpX::field_centering_noz;
+
+            // Device vectors of stencil coefficients used for finite-order centering of fields
+            Real const * stencil_coeffs_x = warpx.device_field_centering_stencil_coeffs_x.data();
+            Real const * stencil_coeffs_y = warpx.device_field_centering_stencil_coeffs_y.data();
+            Real const * stencil_coeffs_z = warpx.device_field_centering_stencil_coeffs_z.data();
+
+            amrex::ParallelFor(nodal_box, [=] AMREX_GPU_DEVICE (int j, int k, int l) noexcept
+            {
+                warpx_interp<true>(j, k, l, dst, src, dst_stag, src_stag, fg_nox, fg_noy, fg_noz,
+                                   stencil_coeffs_x, stencil_coeffs_y, stencil_coeffs_z);
+            });
+#endif
+        } else { // FDTD
+            amrex::ParallelFor(nodal_box, [=] AMREX_GPU_DEVICE (int j, int k, int l) noexcept
+            {
+                warpx_interp(j, k, l, dst, src, dst_stag, src_stag);
+            });
+        }
+    }
+
+    fab_ptr = &nodal_fab;
+}
+
+void
+PhysicalParticleContainer::getNCIGatherStencils (int gather_lev, amrex::Real const*& stencil_exeybz,
+                                                 amrex::Real const*& stencil_bxbyez) const
+{
+    stencil_exeybz = nullptr;
+    stencil_bxbyez = nullptr;
+    if (WarpX::use_fdtd_nci_corr && WarpX::nci_corr_in_gather) {
+        const auto& warpx = WarpX::GetInstance();
+        stencil_exeybz = warpx.nci_godfrey_filter_exeybz[gather_lev]->StencilZ();
+        stencil_bxbyez = warpx.nci_godfrey_filter_bxbyez[gather_lev]->StencilZ();
+    }
+}
+
 // Loop over all particles in the particle container and
 // split particles tagged with p.id()=DoSplitParticleID
 void
 PhysicalParticleContainer::SplitParticles (int lev)
 {
-    auto& mypc = WarpX::GetInstance().GetPartContainer();
-    auto& pctmp_split = mypc.GetPCtmp();
-    RealVector psplit_x, psplit_y, psplit_z, psplit_w;
-    RealVector psplit_ux, psplit_uy, psplit_uz;
-    long np_split_to_add = 0;
-    long np_split;
+    WARPX_PROFILE("PhysicalParticleContainer::SplitParticles()");
+
+    int np_split;
     if(split_type==0)
     {
         np_split = (AMREX_SPACEDIM == 3) ? 8 : 4;
     } else {
         np_split = 2*AMREX_SPACEDIM;
     }
+    const int split_type_loc = split_type;
+
+    const amrex::Vector<int> ppc_nd = plasma_injector->num_particles_per_cell_each_dim;
+    const std::array<Real,3>& dx = WarpX::CellSize(lev);
+    amrex::GpuArray<ParticleReal,3> split_offset = {dx[0]/2._rt,
+                                                    dx[1]/2._rt,
+                                                    dx[2]/2._rt};
+    if (ppc_nd[0] > 0){
+        // offset for split particles is computed as a function of cell size
+        // and number of particles per cell, so that a uniform distribution
+        // before splitting results in a uniform distribution after splitting
+        split_offset[0] /= ppc_nd[0];
+        split_offset[1] /= ppc_nd[1];
+        split_offset[2] /= ppc_nd[2];
+    }
+    const int cpu = ParallelDescriptor::MyProc();
 
     // Loop over particle interator
     for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
     {
-        const auto GetPosition = GetParticlePosition(pti);
+        const int np = pti.numParticles();
+        if (np == 0) continue;
+
+        // Count the tagged particles, and compute the index of the
+        // first child of each of them (count-scan)
+        Gpu::DeviceVector<int> is_tagged(np);
+        Gpu::DeviceVector<int> tagged_index(np);
+        int* const AMREX_RESTRICT p_is_tagged = is_tagged.dataPtr();
+        int* const AMREX_RESTRICT p_tagged_index = tagged_index.dataPtr();
+        {
+            const ParticleType* AMREX_RESTRICT pstruct = pti.GetArrayOfStructs()().dataPtr();
+            amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (int i) noexcept
+            {
+                p_is_tagged[i] = (pstruct[i].id() == DoSplitParticleID);
+            });
+        }
+        const int ntagged = Scan::ExclusiveSum(np, p_is_tagged, p_tagged_index, Scan::retSum);
+        if (ntagged == 0) continue;
+
+        // Make room for the split particles at the end of the tile
+        // (the next call to Redistribute moves them to the proper grids and tiles)
+        auto& ptile = ParticlesAt(lev, pti);
+        ptile.resize(np + ntagged*np_split);
 
-        const amrex::Vector<int> ppc_nd = plasma_injector->num_particles_per_cell_each_dim;
-        const std::array<Real,3>& dx = WarpX::CellSize(lev);
-        amrex::Vector<Real> split_offset = {dx[0]/2._rt,
-                                            dx[1]/2._rt,
-                                            dx[2]/2._rt};
-        if (ppc_nd[0] > 0){
-            // offset for split particles is computed as a function of cell size
-            // and number of particles per cell, so that a uniform distribution
-            // before splitting results in a uniform distribution after splitting
-            split_offset[0] /= ppc_nd[0];
-            split_offset[1] /= ppc_nd[1];
-            split_offset[2] /= ppc_nd[2];
+        const auto GetPosition = GetParticlePosition(pti);
+        const auto SetPosition = SetParticlePosition(pti);
+        ParticleType* AMREX_RESTRICT pstruct = pti.GetArrayOfStructs()().dataPtr();
+        auto& soa = pti.GetStructOfArrays();
+        const int nreal = soa.NumRealComps();
+        const int nint = soa.NumIntComps();
+        Gpu::DeviceVector<ParticleReal*> real_ptrs(nreal);
+        Gpu::DeviceVector<int*> int_ptrs(nint);
+        {
+            amrex::Vector<ParticleReal*> h_real_ptrs(nreal);
+            amrex::Vector<int*> h_int_ptrs(nint);
+            for (int icomp = 0; icomp < nreal; ++icomp) {
+                h_real_ptrs[icomp] = soa.GetRealData(icomp).dataPtr();
+            }
+            for (int icomp = 0; icomp < nint; ++icomp) {
+                h_int_ptrs[icomp] = soa.GetIntData(icomp).dataPtr();
+            }
+            Gpu::copyAsync(Gpu::hostToDevice, h_real_ptrs.begin(), h_real_ptrs.end(),
+                           real_ptrs.begin());
+            Gpu::copyAsync(Gpu::hostToDevice, h_int_ptrs.begin(), h_int_ptrs.end(),
+                           int_ptrs.begin());
+            Gpu::streamSynchronize();
         }
-        // particle Array Of Structs data
-        auto& particles = pti.GetArrayOfStructs();
-        // particle Struct Of Arrays data
-        auto& attribs = pti.GetAttribs();
-        auto& wp  = attribs[PIdx::w ];
-        auto& uxp = attribs[PIdx::ux];
-        auto& uyp = attribs[PIdx::uy];
-        auto& uzp = attribs[PIdx::uz];
-        const long np = pti.numParticles();
-        for(int i=0; i<np; i++){
+        ParticleReal* const* AMREX_RESTRICT p_real = real_ptrs.dataPtr();
+        int* const* AMREX_RESTRICT p_int = int_ptrs.dataPtr();
+
+        // Write the split particles directly in the tile (fill). Split particles
+        // are tagged with p.id()=NoSplitParticleID so that they are not re-split
+        // when entering a higher level.
+        amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (int i) noexcept
+        {
+            if (!p_is_tagged[i]) return;
+
             ParticleReal xp, yp, zp;
             GetPosition(i, xp, yp, zp);
-            auto& p = particles[i];
-            if (p.id() == DoSplitParticleID){
-                // If particle is tagged, split it and put the
-                // split particles in local arrays psplit_x etc.
-                np_split_to_add += np_split;
-#if (AMREX_SPACEDIM==2)
-                if (split_type==0){
+            const int first_child = np + p_tagged_index[i]*np_split;
+
+            for (int ichild = 0; ichild < np_split; ++ichild) {
+                // Offsets (in units of split_offset) of this child
+                int ishift = 0, jshift = 0, kshift = 0;
+                if (split_type_loc == 0) {
                     // Split particle in two along each diagonals
-                    // 4 particles in 2d
-                    for (int ishift = -1; ishift < 2; ishift +=2 ){
-                        for (int kshift = -1; kshift < 2; kshift +=2 ){
-                            // Add one particle with offset in x and z
-                            psplit_x.push_back( xp + ishift*split_offset[0] );
-                            psplit_y.push_back( yp );
-                            psplit_z.push_back( zp + kshift*split_offset[2] );
-                            psplit_ux.push_back( uxp[i] );
-                            psplit_uy.push_back( uyp[i] );
-                            psplit_uz.push_back( uzp[i] );
-                            psplit_w.push_back( wp[i]/np_split );
-                        }
-                    }
+                    // (4 particles in 2d, 8 particles in 3d)
+#if (AMREX_SPACEDIM==3)
+                    ishift = 2*((ichild >> 2) & 1) - 1;
+                    jshift = 2*((ichild >> 1) & 1) - 1;
+#else
+                    ishift = 2*((ichild >> 1) & 1) - 1;
+#endif
+                    kshift = 2*(ichild & 1) - 1;
                 } else {
                     // Split particle in two along each axis
-                    // 4 particles in 2d
-                    for (int ishift = -1; ishift < 2; ishift +=2 ){
-                        // Add one particle with offset in x
-                        psplit_x.push_back( xp + ishift*split_offset[0] );
-                        psplit_y.push_back( yp );
-                        psplit_z.push_back( zp );
-                        psplit_ux.push_back( uxp[i] );
-                        psplit_uy.push_back( uyp[i] );
-                        psplit_uz.push_back( uzp[i] );
-                        psplit_w.push_back( wp[i]/np_split );
-                        // Add one particle with offset in z
-                        psplit_x.push_back( xp );
-                        psplit_y.push_back( yp );
-                        psplit_z.push_back( zp + ishift*split_offset[2] );
-                        psplit_ux.push_back( uxp[i] );
-                        psplit_uy.push_back( uyp[i] );
-                        psplit_uz.push_back( uzp[i] );
-                        psplit_w.push_back( wp[i]/np_split );
-                    }
-                }
-#elif (AMREX_SPACEDIM==3)
-                if (split_type==0){
-                    // Split particle in two along each diagonals
-                    // 8 particles in 3d
-                    for (int ishift = -1; ishift < 2; ishift +=2 ){
-                        for (int jshift = -1; jshift < 2; jshift +=2 ){
-                            for (int kshift = -1; kshift < 2; kshift +=2 ){
-                                // Add one particle with offset in x, y and z
-                                psplit_x.push_back( xp + ishift*split_offset[0] );
-                                psplit_y.push_back( yp + jshift*split_offset[1] );
-                                psplit_z.push_back( zp + kshift*split_offset[2] );
-                                psplit_ux.push_back( uxp[i] );
-                                psplit_uy.push_back( uyp[i] );
-                                psplit_uz.push_back( uzp[i] );
-                                psplit_w.push_back( wp[i]/np_split );
-                            }
-                        }
-                    }
-                } else {
-                    // Split particle in two along each axis
-                    // 6 particles in 3d
-                    for (int ishift = -1; ishift < 2; ishift +=2 ){
-                        // Add one particle with offset in x
-                        psplit_x.push_back( xp + ishift*split_offset[0] );
-                        psplit_y.push_back( yp );
-                        psplit_z.push_back( zp );
-                        psplit_ux.push_back( uxp[i] );
-                        psplit_uy.push_back( uyp[i] );
-                        psplit_uz.push_back( uzp[i] );
-                        psplit_w.push_back( wp[i]/np_split );
-                        // Add one particle with offset in y
-                        psplit_x.push_back( xp );
-                        psplit_y.push_back( yp + ishift*split_offset[1] );
-                        psplit_z.push_back( zp );
-                        psplit_ux.push_back( uxp[i] );
-                        psplit_uy.push_back( uyp[i] );
-                        psplit_uz.push_back( uzp[i] );
-                        psplit_w.push_back( wp[i]/np_split );
-                        // Add one particle with offset in z
-                        psplit_x.push_back( xp );
-                        psplit_y.push_back( yp );
-                        psplit_z.push_back( zp + ishift*split_offset[2] );
-                        psplit_ux.push_back( uxp[i] );
-                        psplit_uy.push_back( uyp[i] );
-                        psplit_uz.push_back( uzp[i] );
-                        psplit_w.push_back( wp[i]/np_split );
-                    }
+                    // (4 particles in 2d, 6 particles in 3d)
+                    const int shift = 2*(ichild & 1) - 1;
+                    const int dir = ichild >> 1;
+#if (AMREX_SPACEDIM==3)
+                    if (dir == 0) ishift = shift;
+                    else if (dir == 1) jshift = shift;
+                    else kshift = shift;
+#else
+                    if (dir == 0) ishift = shift;
+                    else kshift = shift;
+#endif
                 }
+
+                const int ic = first_child + ichild;
+                ParticleType& p = pstruct[ic];
+                p.id() = NoSplitParticleID;
+                p.cpu() = cpu;
+                SetPosition(ic, xp + ishift*split_offset[0],
+                                yp + jshift*split_offset[1],
+                                zp + kshift*split_offset[2]);
+                // The split particles inherit all the attributes of their parent,
+                // except for the weight, which is shared among them
+                for (int icomp = 0; icomp < nreal; ++icomp) {
+#ifdef WARPX_DIM_RZ
+                    // theta is set by SetPosition
+                    if (icomp == PIdx::theta) continue;
 #endif
-                // invalidate the particle
-                p.id() = -p.id();
+                    p_real[icomp][ic] = p_real[icomp][i];
+                }
+                p_real[PIdx::w][ic] = p_real[PIdx::w][i]/np_split;
+                for (int icomp = 0; icomp < nint; ++icomp) {
+                    p_int[icomp][ic] = p_int[icomp][i];
+                }
             }
-        }
+
+            // invalidate the particle
+            pstruct[i].id() = -pstruct[i].id();
+        });
+        Gpu::streamSynchronize();
     }
-    // Add local arrays psplit_x etc. to the temporary
-    // particle container pctmp_split. Split particles
-    // are tagged with p.id()=NoSplitParticleID so that
-    // they are not re-split when entering a higher level
-    // AddNParticles calls Redistribute, so that particles
-    // in pctmp_split are in the proper grids and tiles
-    pctmp_split.AddNParticles(lev,
-                              np_split_to_add,
-                              psplit_x.dataPtr(),
-                              psplit_y.dataPtr(),
-                              psplit_z.dataPtr(),
-                              psplit_ux.dataPtr(),
-                              psplit_uy.dataPtr(),
-                              psplit_uz.dataPtr(),
-                              1,
-                              psplit_w.dataPtr(),
-                              1, NoSplitParticleID);
-    // Copy particles from tmp to current particle container
-    addParticles(pctmp_split,1);
-    // Clear tmp container
-    pctmp_split.clearParticles();
 }
 
 void
@@ -2006,6 +2467,9 @@ PhysicalParticleContainer::PushP (int lev, Real dt,
 #pragma omp parallel
 #endif
     {
+        FArrayBox nodal_Ex, nodal_Ey, nodal_Ez;
+        FArrayBox nodal_Bx, nodal_By, nodal_Bz;
+
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
         {
             amrex::Box box = pti.tilebox();
@@ -2014,12 +2478,23 @@ PhysicalParticleContainer::PushP (int lev, Real dt,
             const long np = pti.numParticles();
 
             // Data on the grid
-            const FArrayBox& exfab = Ex[pti];
-            const FArrayBox& eyfab = Ey[pti];
-            const FArrayBox& ezfab = Ez[pti];
-            const FArrayBox& bxfab = Bx[pti];
-            const FArrayBox& byfab = By[pti];
-            const FArrayBox& bzfab = Bz[pti];
+            FArrayBox const* exfab = &Ex[pti];
+            FArrayBox const* eyfab = &Ey[pti];
+            FArrayBox const* ezfab = &Ez[pti];
+            FArrayBox const* bxfab = &Bx[pti];
+            FArrayBox const* byfab = &By[pti];
+            FArrayBox const* bzfab = &Bz[pti];
+
+            Elixir nodal_exeli, nodal_eyeli, nodal_ezeli, nodal_bxeli, nodal_byeli, nodal_bzeli;
+            if (WarpX::do_on_the_fly_nodal_gather) {
+                // Interpolate the staggered fields to the nodes of the tile
+                InterpolateFieldToNodal(box, nodal_exeli, nodal_Ex, exfab);
+                InterpolateFieldToNodal(box, nodal_eyeli, nodal_Ey, eyfab);
+                InterpolateFieldToNodal(box, nodal_ezeli, nodal_Ez, ezfab);
+                InterpolateFieldToNodal(box, nodal_bxeli, nodal_Bx, bxfab);
+                InterpolateFieldToNodal(box, nodal_byeli, nodal_By, byfab);
+                InterpolateFieldToNodal(box, nodal_bzeli, nodal_Bz, bzfab);
+            }
 
             const auto getPosition = GetParticlePosition(pti);
 
@@ -2037,19 +2512,19 @@ PhysicalParticleContainer::PushP (int lev, Real dt,
             amrex::GpuArray<amrex::Real, 3> dx_arr = {dx[0], dx[1], dx[2]};
             amrex::GpuArray<amrex::Real, 3> xyzmin_arr = {xyzmin[0], xyzmin[1], xyzmin[2]};
 
-            amrex::Array4<const amrex::Real> const& ex_arr = exfab.array();
-            amrex::Array4<const amrex::Real> const& ey_arr = eyfab.array();
-            amrex::Array4<const amrex::Real> const& ez_arr = ezfab.array();
-            amrex::Array4<const amrex::Real> const& bx_arr = bxfab.array();
-            amrex::Array4<const amrex::Real> const& by_arr = byfab.array();
-            amrex::Array4<const amrex::Real> const& bz_arr = bzfab.array();
+            amrex::Array4<const amrex::Real> const& ex_arr = exfab->array();
+            amrex::Array4<const amrex::Real> const& ey_arr = eyfab->array();
+            amrex::Array4<const amrex::Real> const& ez_arr = ezfab->array();
+            amrex::Array4<const amrex::Real> const& bx_arr = bxfab->array();
+            amrex::Array4<const amrex::Real> const& by_arr = byfab->array();
+            amrex::Array4<const amrex::Real> const& bz_arr = bzfab->array();
 
-            amrex::IndexType const ex_type = exfab.box().ixType();
-            amrex::IndexType const ey_type = eyfab.box().ixType();
-            amrex::IndexType const ez_type = ezfab.box().ixType();
-            amrex::IndexType const bx_type = bxfab.box().ixType();
-            amrex::IndexType const by_type = byfab.box().ixType();
-            amrex::IndexType const bz_type = bzfab.box().ixType();
+            amrex::IndexType const ex_type = exfab->box().ixType();
+            amrex::IndexType const ey_type = eyfab->box().ixType();
+            amrex::IndexType const ez_type = ezfab->box().ixType();
+            amrex::IndexType const bx_type = bxfab->box().ixType();
+            amrex::IndexType const by_type = byfab->box().ixType();
+            amrex::IndexType const bz_type = bzfab->box().ixType();
 
             auto& attribs = pti.GetAttribs();
             ParticleReal* const AMREX_RESTRICT ux = attribs[PIdx::ux].dataPtr();
@@ -2128,7 +2603,7 @@ PhysicalParticleContainer::GetParticleSlice (
     const int direction, const Real z_old,
     const Real z_new, const Real t_boost,
     const Real t_lab, const Real dt,
-    DiagnosticParticles& diagnostic_particles)
+    DiagnosticParticleData& diagnostic_particles)
 {
     WARPX_PROFILE("PhysicalParticleContainer::GetParticleSlice()");
 
@@ -2145,165 +2620,184 @@ PhysicalParticleContainer::GetParticleSlice (
     AMREX_ALWAYS_ASSERT(do_back_transformed_diagnostics == 1);
 
     const int nlevs = std::max(0, finestLevel()+1);
-    diagnostic_particles.resize(finestLevel()+1);
 
+    // The copy flags of the particles of all the levels and tiles are stored
+    // contiguously (in the order of the tile offsets computed in serial first),
+    // so that a single scan gives the location of each copied particle in
+    // diagnostic_particles: the per-tile work is done in the kernels only, and
+    // all the levels and tiles require a single synchronization, for the scan.
+    amrex::Vector<std::map<std::pair<int, int>, amrex::Long> > tile_offsets(nlevs);
+    amrex::Long np_total = 0;
     for (int lev = 0; lev < nlevs; ++lev) {
-        // first we touch each map entry in serial
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
         {
             auto index = std::make_pair(pti.index(), pti.LocalTileIndex());
-            diagnostic_particles[lev][index];
+            tile_offsets[lev][index] = np_total;
+            np_total += pti.numParticles();
         }
+    }
+    if (np_total == 0) return;
 
+    // Temporary arrays to store copy_flag and copy_index
+    // for particles that cross the z-slice
+    amrex::Gpu::DeviceVector<int> FlagForPartCopy(np_total);
+    amrex::Gpu::DeviceVector<int> IndexForPartCopy(np_total);
+    int* const AMREX_RESTRICT Flag = FlagForPartCopy.dataPtr();
+    int* const AMREX_RESTRICT IndexLocation = IndexForPartCopy.dataPtr();
+
+    for (int lev = 0; lev < nlevs; ++lev) {
 #ifdef AMREX_USE_OMP
-#pragma omp parallel
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
+        for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
         {
-            // Temporary arrays to store copy_flag and copy_index
-            // for particles that cross the z-slice
-            // These arrays are defined before the WarpXParIter to prevent them
-            // from going out of scope after each iteration, while the kernels
-            // may still need access to them.
-            // Note that the destructor for WarpXParIter is synchronized.
-            amrex::Gpu::DeviceVector<int> FlagForPartCopy;
-            amrex::Gpu::DeviceVector<int> IndexForPartCopy;
-            for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+            auto index = std::make_pair(pti.index(), pti.LocalTileIndex());
+            int* const AMREX_RESTRICT tile_flag = Flag + tile_offsets[lev].at(index);
+
+            const auto GetPosition = GetParticlePosition(pti);
+            Real* const AMREX_RESTRICT
+              zpold = tmp_particle_data[lev][index][TmpIdx::zold].dataPtr();
+
+            //Flag particles that need to be copied if they cross the z_slice
+            amrex::ParallelFor(pti.numParticles(),
+            [=] AMREX_GPU_DEVICE(int i)
             {
-                auto index = std::make_pair(pti.index(), pti.LocalTileIndex());
-
-                const auto GetPosition = GetParticlePosition(pti);
-
-                auto& attribs = pti.GetAttribs();
-                Real* const AMREX_RESTRICT wpnew = attribs[PIdx::w].dataPtr();
-                Real* const AMREX_RESTRICT uxpnew = attribs[PIdx::ux].dataPtr();
-                Real* const AMREX_RESTRICT uypnew = attribs[PIdx::uy].dataPtr();
-                Real* const AMREX_RESTRICT uzpnew = attribs[PIdx::uz].dataPtr();
-
-                Real* const AMREX_RESTRICT
-                  xpold = tmp_particle_data[lev][index][TmpIdx::xold].dataPtr();
-                Real* const AMREX_RESTRICT
-                  ypold = tmp_particle_data[lev][index][TmpIdx::yold].dataPtr();
-                Real* const AMREX_RESTRICT
-                  zpold = tmp_particle_data[lev][index][TmpIdx::zold].dataPtr();
-                Real* const AMREX_RESTRICT
-                  uxpold = tmp_particle_data[lev][index][TmpIdx::uxold].dataPtr();
-                Real* const AMREX_RESTRICT
-                  uypold = tmp_particle_data[lev][index][TmpIdx::uyold].dataPtr();
-                Real* const AMREX_RESTRICT
-                  uzpold = tmp_particle_data[lev][index][TmpIdx::uzold].dataPtr();
-
-                const long np = pti.numParticles();
-
-                Real uzfrm = -WarpX::gamma_boost*WarpX::beta_boost*PhysConst::c;
-                Real inv_c2 = 1.0/PhysConst::c/PhysConst::c;
-
-                FlagForPartCopy.resize(np);
-                IndexForPartCopy.resize(np);
-
-                int* const AMREX_RESTRICT Flag = FlagForPartCopy.dataPtr();
-                int* const AMREX_RESTRICT IndexLocation = IndexForPartCopy.dataPtr();
-
-                //Flag particles that need to be copied if they cross the z_slice
-                amrex::ParallelFor(np,
-                [=] AMREX_GPU_DEVICE(int i)
+                ParticleReal xp, yp, zp;
+                GetPosition(i, xp, yp, zp);
+                tile_flag[i] = 0;
+                if ( (((zp >= z_new) && (zpold[i] <= z_old)) ||
+                      ((zp <= z_new) && (zpold[i] >= z_old))) )
                 {
-                    ParticleReal xp, yp, zp;
-                    GetPosition(i, xp, yp, zp);
-                    Flag[i] = 0;
-                    if ( (((zp >= z_new) && (zpold[i] <= z_old)) ||
-                          ((zp <= z_new) && (zpold[i] >= z_old))) )
-                    {
-                        Flag[i] = 1;
-                    }
-                });
+                    tile_flag[i] = 1;
+                }
+            });
+        }
+    }
 
-                // exclusive scan to obtain location indices using flag values
-                // These location indices are used to copy data from
-                // src to dst when the copy-flag is set to 1.
-                const int total_partdiag_size = amrex::Scan::ExclusiveSum(np,Flag,IndexLocation);
-
-                // allocate array size for diagnostic particle array
-                diagnostic_particles[lev][index].resize(total_partdiag_size);
-
-                amrex::Real gammaboost = WarpX::gamma_boost;
-                amrex::Real betaboost = WarpX::beta_boost;
-                amrex::Real Phys_c = PhysConst::c;
-
-                Real* const AMREX_RESTRICT diag_wp =
-                diagnostic_particles[lev][index].GetRealData(DiagIdx::w).data();
-                Real* const AMREX_RESTRICT diag_xp =
-                diagnostic_particles[lev][index].GetRealData(DiagIdx::x).data();
-                Real* const AMREX_RESTRICT diag_yp =
-                diagnostic_particles[lev][index].GetRealData(DiagIdx::y).data();
-                Real* const AMREX_RESTRICT diag_zp =
-                diagnostic_particles[lev][index].GetRealData(DiagIdx::z).data();
-                Real* const AMREX_RESTRICT diag_uxp =
-                diagnostic_particles[lev][index].GetRealData(DiagIdx::ux).data();
-                Real* const AMREX_RESTRICT diag_uyp =
-                diagnostic_particles[lev][index].GetRealData(DiagIdx::uy).data();
-                Real* const AMREX_RESTRICT diag_uzp =
-                diagnostic_particles[lev][index].GetRealData(DiagIdx::uz).data();
-
-                // Copy particle data to diagnostic particle array on the GPU
-                //  using flag and index values
-                amrex::ParallelFor(np,
-                [=] AMREX_GPU_DEVICE(int i)
+    // exclusive scan to obtain location indices using flag values
+    // These location indices are used to copy data from
+    // src to dst when the copy-flag is set to 1.
+    const int total_partdiag_size = amrex::Scan::ExclusiveSum(static_cast<int>(np_total),
+                                                              Flag, IndexLocation);
+    if (total_partdiag_size == 0) return;
+
+    // allocate array size for diagnostic particle array
+    // (the particles are appended to the existing ones)
+    const int init_size = diagnostic_particles.GetRealData(DiagIdx::w).size();
+    diagnostic_particles.resize(init_size + total_partdiag_size);
+
+    Real* const AMREX_RESTRICT diag_wp =
+    diagnostic_particles.GetRealData(DiagIdx::w).data() + init_size;
+    Real* const AMREX_RESTRICT diag_xp =
+    diagnostic_particles.GetRealData(DiagIdx::x).data() + init_size;
+    Real* const AMREX_RESTRICT diag_yp =
+    diagnostic_particles.GetRealData(DiagIdx::y).data() + init_size;
+    Real* const AMREX_RESTRICT diag_zp =
+    diagnostic_particles.GetRealData(DiagIdx::z).data() + init_size;
+    Real* const AMREX_RESTRICT diag_uxp =
+    diagnostic_particles.GetRealData(DiagIdx::ux).data() + init_size;
+    Real* const AMREX_RESTRICT diag_uyp =
+    diagnostic_particles.GetRealData(DiagIdx::uy).data() + init_size;
+    Real* const AMREX_RESTRICT diag_uzp =
+    diagnostic_particles.GetRealData(DiagIdx::uz).data() + init_size;
+
+    const Real uzfrm = -WarpX::gamma_boost*WarpX::beta_boost*PhysConst::c;
+    const Real inv_c2 = 1.0/PhysConst::c/PhysConst::c;
+    const amrex::Real gammaboost = WarpX::gamma_boost;
+    const amrex::Real betaboost = WarpX::beta_boost;
+    const amrex::Real Phys_c = PhysConst::c;
+
+    for (int lev = 0; lev < nlevs; ++lev) {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+        for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+        {
+            auto index = std::make_pair(pti.index(), pti.LocalTileIndex());
+            const amrex::Long offset = tile_offsets[lev].at(index);
+            const int* const AMREX_RESTRICT tile_flag = Flag + offset;
+            const int* const AMREX_RESTRICT tile_index = IndexLocation + offset;
+
+            const auto GetPosition = GetParticlePosition(pti);
+
+            auto& attribs = pti.GetAttribs();
+            Real* const AMREX_RESTRICT wpnew = attribs[PIdx::w].dataPtr();
+            Real* const AMREX_RESTRICT uxpnew = attribs[PIdx::ux].dataPtr();
+            Real* const AMREX_RESTRICT uypnew = attribs[PIdx::uy].dataPtr();
+            Real* const AMREX_RESTRICT uzpnew = attribs[PIdx::uz].dataPtr();
+
+            Real* const AMREX_RESTRICT
+              xpold = tmp_particle_data[lev][index][TmpIdx::xold].dataPtr();
+            Real* const AMREX_RESTRICT
+              ypold = tmp_particle_data[lev][index][TmpIdx::yold].dataPtr();
+            Real* const AMREX_RESTRICT
+              zpold = tmp_particle_data[lev][index][TmpIdx::zold].dataPtr();
+            Real* const AMREX_RESTRICT
+              uxpold = tmp_particle_data[lev][index][TmpIdx::uxold].dataPtr();
+            Real* const AMREX_RESTRICT
+              uypold = tmp_particle_data[lev][index][TmpIdx::uyold].dataPtr();
+            Real* const AMREX_RESTRICT
+              uzpold = tmp_particle_data[lev][index][TmpIdx::uzold].dataPtr();
+
+            // Copy particle data to diagnostic particle array on the GPU
+            //  using flag and index values
+            amrex::ParallelFor(pti.numParticles(),
+            [=] AMREX_GPU_DEVICE(int i)
+            {
+                ParticleReal xp_new, yp_new, zp_new;
+                GetPosition(i, xp_new, yp_new, zp_new);
+                if (tile_flag[i] == 1)
                 {
-                    ParticleReal xp_new, yp_new, zp_new;
-                    GetPosition(i, xp_new, yp_new, zp_new);
-                    if (Flag[i] == 1)
-                    {
-                         // Lorentz Transform particles to lab-frame
-                         const Real gamma_new_p = std::sqrt(1.0 + inv_c2*
-                                                  (uxpnew[i]*uxpnew[i]
-                                                 + uypnew[i]*uypnew[i]
-                                                 + uzpnew[i]*uzpnew[i]));
-                         const Real t_new_p = gammaboost*t_boost - uzfrm*zp_new*inv_c2;
-                         const Real z_new_p = gammaboost*(zp_new + betaboost*Phys_c*t_boost);
-                         const Real uz_new_p = gammaboost*uzpnew[i] - gamma_new_p*uzfrm;
-
-                         const Real gamma_old_p = std::sqrt(1.0 + inv_c2*
-                                                  (uxpold[i]*uxpold[i]
-                                                 + uypold[i]*uypold[i]
-                                                 + uzpold[i]*uzpold[i]));
-                         const Real t_old_p = gammaboost*(t_boost - dt)
-                                              - uzfrm*zpold[i]*inv_c2;
-                         const Real z_old_p = gammaboost*(zpold[i]
-                                              + betaboost*Phys_c*(t_boost-dt));
-                         const Real uz_old_p = gammaboost*uzpold[i]
-                                              - gamma_old_p*uzfrm;
-
-                         // interpolate in time to t_lab
-                         const Real weight_old = (t_new_p - t_lab)
-                                               / (t_new_p - t_old_p);
-                         const Real weight_new = (t_lab - t_old_p)
-                                               / (t_new_p - t_old_p);
-
-                         const Real xp = xpold[i]*weight_old + xp_new*weight_new;
-                         const Real yp = ypold[i]*weight_old + yp_new*weight_new;
-                         const Real zp = z_old_p*weight_old  + z_new_p*weight_new;
-
-                         const Real uxp = uxpold[i]*weight_old
-                                        + uxpnew[i]*weight_new;
-                         const Real uyp = uypold[i]*weight_old
-                                        + uypnew[i]*weight_new;
-                         const Real uzp = uz_old_p*weight_old
-                                        + uz_new_p  *weight_new;
-
-                         const int loc = IndexLocation[i];
-                         diag_wp[loc] = wpnew[i];
-                         diag_xp[loc] = xp;
-                         diag_yp[loc] = yp;
-                         diag_zp[loc] = zp;
-                         diag_uxp[loc] = uxp;
-                         diag_uyp[loc] = uyp;
-                         diag_uzp[loc] = uzp;
-                    }
-                });
-                Gpu::synchronize(); // because of FlagForPartCopy & IndexForPartCopy
-            }
+                     // Lorentz Transform particles to lab-frame
+                     const Real gamma_new_p = std::sqrt(1.0 + inv_c2*
+                                              (uxpnew[i]*uxpnew[i]
+                                             + uypnew[i]*uypnew[i]
+                                             + uzpnew[i]*uzpnew[i]));
+                     const Real t_new_p = gammaboost*t_boost - uzfrm*zp_new*inv_c2;
+                     const Real z_new_p = gammaboost*(zp_new + betaboost*Phys_c*t_boost);
+                     const Real uz_new_p = gammaboost*uzpnew[i] - gamma_new_p*uzfrm;
+
+                     const Real gamma_old_p = std::sqrt(1.0 + inv_c2*
+                                              (uxpold[i]*uxpold[i]
+                                             + uypold[i]*uypold[i]
+                                             + uzpold[i]*uzpold[i]));
+                     const Real t_old_p = gammaboost*(t_boost - dt)
+                                          - uzfrm*zpold[i]*inv_c2;
+                     const Real z_old_p = gammaboost*(zpold[i]
+                                          + betaboost*Phys_c*(t_boost-dt));
+                     const Real uz_old_p = gammaboost*uzpold[i]
+                                          - gamma_old_p*uzfrm;
+
+                     // interpolate in time to t_lab
+                     const Real weight_old = (t_new_p - t_lab)
+                                           / (t_new_p - t_old_p);
+                     const Real weight_new = (t_lab - t_old_p)
+                                           / (t_new_p - t_old_p);
+
+                     const Real xp = xpold[i]*weight_old + xp_new*weight_new;
+                     const Real yp = ypold[i]*weight_old + yp_new*weight_new;
+                     const Real zp = z_old_p*weight_old  + z_new_p*weight_new;
+
+                     const Real uxp = uxpold[i]*weight_old
+                                    + uxpnew[i]*weight_new;
+                     const Real uyp = uypold[i]*weight_old
+                                    + uypnew[i]*weight_new;
+                     const Real uzp = uz_old_p*weight_old
+                                    + uz_new_p  *weight_new;
+
+                     const int loc = tile_index[i];
+                     diag_wp[loc] = wpnew[i];
+                     diag_xp[loc] = xp;
+                     diag_yp[loc] = yp;
+                     diag_zp[loc] = zp;
+                     diag_uxp[loc] = uxp;
+                     diag_uyp[loc] = uyp;
+                     diag_uzp[loc] = uzp;
+                }
+            });
         }
     }
+    Gpu::synchronize(); // because of FlagForPartCopy & IndexForPartCopy
 }
 
 /* \brief Inject particles during the simulation
@@ -2332,27 +2826,22 @@ PhysicalParticleContainer::ContinuousFluxInjection (amrex::Real dt)
 /* \brief Perform the field gather and particle push operations in one fused kernel
  *
  */
+template <int pusher_algo, bool do_crr, bool do_ionization>
 void
-PhysicalParticleContainer::PushPX (WarpXParIter& pti,
-                                   amrex::FArrayBox const * exfab,
-                                   amrex::FArrayBox const * eyfab,
-                                   amrex::FArrayBox const * ezfab,
-                                   amrex::FArrayBox const * bxfab,
-                                   amrex::FArrayBox const * byfab,
-                                   amrex::FArrayBox const * bzfab,
-                                   const amrex::IntVect ngE, const int /*e_is_nodal*/,
-                                   const long offset,
-                                   const long np_to_push,
-                                   int lev, int gather_lev,
-                                   amrex::Real dt, ScaleFields scaleFields,
-                                   DtType a_dt_type)
+PhysicalParticleContainer::PushPXImpl (WarpXParIter& pti,
+                                       amrex::FArrayBox const * exfab,
+                                       amrex::FArrayBox const * eyfab,
+                                       amrex::FArrayBox const * ezfab,
+                                       amrex::FArrayBox const * bxfab,
+                                       amrex::FArrayBox const * byfab,
+                                       amrex::FArrayBox const * bzfab,
+                                       const amrex::IntVect ngE,
+                                       const long offset,
+                                       const long np_to_push,
+                                       int lev, int gather_lev,
+                                       amrex::Real dt, ScaleFields scaleFields,
+                                       DtType a_dt_type)
 {
-    AMREX_ALWAYS_ASSERT_WITH_MESSAGE((gather_lev==(lev-1)) ||
-                                     (gather_lev==(lev  )),
-                                     "Gather buffers only work for lev-1");
-    // If no particles, do not do anything
-    if (np_to_push == 0) return;
-
     // Get cell size on gather_lev
     const std::array<Real,3>& dx = WarpX::CellSize(std::max(gather_lev,0));
 
@@ -2419,7 +2908,7 @@ PhysicalParticleContainer::PushPX (WarpXParIter& pti,
                    (a_dt_type!=DtType::SecondHalf));
 
     int* AMREX_RESTRICT ion_lev = nullptr;
-    if (do_field_ionization) {
+    if (do_ionization) {
         ion_lev = pti.GetiAttribs(particle_icomps["ionization_level"]).dataPtr();
     }
 
@@ -2441,8 +2930,6 @@ PhysicalParticleContainer::PushPX (WarpXParIter& pti,
     const amrex::Real q = this->charge;
     const amrex::Real m = this-> mass;
 
-    const auto pusher_algo = WarpX::particle_pusher_algo;
-    const auto do_crr = do_classical_radiation_reaction;
 #ifdef WARPX_QED
     const auto do_sync = m_do_qed_quantum_sync;
     amrex::Real t_chi_max = 0.0;
@@ -2455,10 +2942,16 @@ PhysicalParticleContainer::PushPX (WarpXParIter& pti,
         evolve_opt = m_shr_p_qs_engine->build_evolve_functor();
         p_optical_depth_QSR = pti.GetAttribs(particle_comps["opticalDepthQSR"]).dataPtr();
     }
+    amrex::Real* const p_chi_extrema = GetChiExtremaPtr();
 #endif
 
     const auto t_do_not_gather = do_not_gather;
 
+    // NCI Godfrey filter applied in the gather, if any
+    amrex::Real const* nci_stencil_exeybz;
+    amrex::Real const* nci_stencil_bxbyez;
+    getNCIGatherStencils(gather_lev, nci_stencil_exeybz, nci_stencil_bxbyez);
+
     amrex::ParallelFor( np_to_push, [=] AMREX_GPU_DEVICE (long ip)
     {
         amrex::ParticleReal xp, yp, zp;
@@ -2481,7 +2974,285 @@ PhysicalParticleContainer::PushPX (WarpXParIter& pti,
                            ex_arr, ey_arr, ez_arr, bx_arr, by_arr, bz_arr,
                            ex_type, ey_type, ez_type, bx_type, by_type, bz_type,
                            dx_arr, xyzmin_arr, lo, n_rz_azimuthal_modes,
-                           nox, galerkin_interpolation);
+                           nox, galerkin_interpolation,
+                           nci_stencil_exeybz, nci_stencil_bxbyez);
+        }
+        // Externally applied E-field in Cartesian co-ordinates
+        getExternalE(ip, Exp, Eyp, Ezp);
+        // Externally applied B-field in Cartesian co-ordinates
+        getExternalB(ip, Bxp, Byp, Bzp);
+
+        scaleFields(xp, yp, zp, Exp, Eyp, Ezp, Bxp, Byp, Bzp);
+
+        doParticlePush<pusher_algo, do_crr, do_ionization>(
+                       getPosition, setPosition, copyAttribs, ip,
+                       ux[ip], uy[ip], uz[ip],
+                       Exp, Eyp, Ezp, Bxp, Byp, Bzp,
+                       do_ionization ? ion_lev[ip] : 0,
+                       m, q, do_copy,
+#ifdef WARPX_QED
+                       do_sync,
+                       t_chi_max,
+#endif
+                       dt);
+
+#ifdef WARPX_QED
+        if (local_has_quantum_sync) {
+            evolve_opt(ux[ip], uy[ip], uz[ip],
+                       Exp, Eyp, Ezp,Bxp, Byp, Bzp,
+                       dt, p_optical_depth_QSR[ip]);
+        }
+        if (p_chi_extrema) {
+            QedUtils::RecordChiExtrema(p_chi_extrema, QedUtils::chi_ele_pos(
+                m*ux[ip], m*uy[ip], m*uz[ip], Exp, Eyp, Ezp, Bxp, Byp, Bzp));
+        }
+#endif
+
+    });
+}
+
+void
+PhysicalParticleContainer::PushPX (WarpXParIter& pti,
+                                   amrex::FArrayBox const * exfab,
+                                   amrex::FArrayBox const * eyfab,
+                                   amrex::FArrayBox const * ezfab,
+                                   amrex::FArrayBox const * bxfab,
+                                   amrex::FArrayBox const * byfab,
+                                   amrex::FArrayBox const * bzfab,
+                                   const amrex::IntVect ngE, const int /*e_is_nodal*/,
+                                   const long offset,
+                                   const long np_to_push,
+                                   int lev, int gather_lev,
+                                   amrex::Real dt, ScaleFields scaleFields,
+                                   DtType a_dt_type)
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE((gather_lev==(lev-1)) ||
+                                     (gather_lev==(lev  )),
+                                     "Gather buffers only work for lev-1");
+    // If no particles, do not do anything
+    if (np_to_push == 0) return;
+
+    // Select the specialization of the push kernel once for the whole tile
+    const auto pusher_algo = WarpX::particle_pusher_algo;
+    const bool do_crr = do_classical_radiation_reaction;
+    const bool do_ionization = do_field_ionization;
+    if (do_crr) {
+        if (do_ionization) {
+            PushPXImpl<ParticlePusherAlgo::Boris, true, true>(
+                pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab, ngE, offset, np_to_push,
+                lev, gather_lev, dt, scaleFields, a_dt_type);
+        } else {
+            PushPXImpl<ParticlePusherAlgo::Boris, true, false>(
+                pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab, ngE, offset, np_to_push,
+                lev, gather_lev, dt, scaleFields, a_dt_type);
+        }
+    } else if (pusher_algo == ParticlePusherAlgo::Boris) {
+        if (do_ionization) {
+            PushPXImpl<ParticlePusherAlgo::Boris, false, true>(
+                pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab, ngE, offset, np_to_push,
+                lev, gather_lev, dt, scaleFields, a_dt_type);
+        } else {
+            PushPXImpl<ParticlePusherAlgo::Boris, false, false>(
+                pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab, ngE, offset, np_to_push,
+                lev, gather_lev, dt, scaleFields, a_dt_type);
+        }
+    } else if (pusher_algo == ParticlePusherAlgo::Vay) {
+        if (do_ionization) {
+            PushPXImpl<ParticlePusherAlgo::Vay, false, true>(
+                pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab, ngE, offset, np_to_push,
+                lev, gather_lev, dt, scaleFields, a_dt_type);
+        } else {
+            PushPXImpl<ParticlePusherAlgo::Vay, false, false>(
+                pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab, ngE, offset, np_to_push,
+                lev, gather_lev, dt, scaleFields, a_dt_type);
+        }
+    } else if (pusher_algo == ParticlePusherAlgo::HigueraCary) {
+        if (do_ionization) {
+            PushPXImpl<ParticlePusherAlgo::HigueraCary, false, true>(
+                pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab, ngE, offset, np_to_push,
+                lev, gather_lev, dt, scaleFields, a_dt_type);
+        } else {
+            PushPXImpl<ParticlePusherAlgo::HigueraCary, false, false>(
+                pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab, ngE, offset, np_to_push,
+                lev, gather_lev, dt, scaleFields, a_dt_type);
+        }
+    } else {
+        amrex::Abort("Unknown particle pusher");
+    }
+}
+
+template <int depos_order>
+void
+PhysicalParticleContainer::PushPXAndDepositCurrentShapeN (WarpXParIter& pti,
+                                                          amrex::FArrayBox const * exfab,
+                                                          amrex::FArrayBox const * eyfab,
+                                                          amrex::FArrayBox const * ezfab,
+                                                          amrex::FArrayBox const * bxfab,
+                                                          amrex::FArrayBox const * byfab,
+                                                          amrex::FArrayBox const * bzfab,
+                                                          const amrex::IntVect ngE,
+                                                          int const * const ion_lev,
+                                                          amrex::MultiFab * const jx,
+                                                          amrex::MultiFab * const jy,
+                                                          amrex::MultiFab * const jz,
+                                                          const long np_to_push,
+                                                          int lev, amrex::Real dt, ScaleFields scaleFields,
+                                                          DtType a_dt_type)
+{
+    WarpX& warpx = WarpX::GetInstance();
+
+    // The particles deposit directly in the J arrays: check that their shape fits
+    // within the guard cells. Since the check is done before the push, one cell
+    // is subtracted, to account for the displacement of the particles during the push.
+#if   (AMREX_SPACEDIM == 2)
+    const amrex::IntVect shape_extent = amrex::IntVect(static_cast<int>(WarpX::nox/2),
+                                                       static_cast<int>(WarpX::noz/2));
+#elif (AMREX_SPACEDIM == 3)
+    const amrex::IntVect shape_extent = amrex::IntVect(static_cast<int>(WarpX::nox/2),
+                                                       static_cast<int>(WarpX::noy/2),
+                                                       static_cast<int>(WarpX::noz/2));
+#endif
+    const amrex::IntVect range = jx->nGrowVect() - shape_extent - 1;
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+        amrex::numParticlesOutOfRange(pti, range) == 0,
+        "Particles shape does not fit within guard cells used for current deposition");
+
+    const std::array<Real,3>& dx = WarpX::CellSize(lev);
+
+    // Box from which the fields are gathered
+    Box gather_box = pti.tilebox();
+    gather_box.grow(ngE);
+    // Box in which the current is deposited
+    Box depos_box = pti.tilebox();
+    depos_box.grow(warpx.get_ng_depos_J());
+
+    const auto getPosition = GetParticlePosition(pti);
+          auto setPosition = SetParticlePosition(pti);
+
+    const auto getExternalE = GetExternalEField(pti);
+    const auto getExternalB = GetExternalBField(pti);
+
+    // Lower corners of the gather and deposition boxes (no Galilean shift with Esirkepov)
+    const amrex::Array<amrex::Real,3> galilean_shift = {0._rt, 0._rt, 0._rt};
+    const std::array<Real, 3>& xyzmin_gather = WarpX::LowerCorner(gather_box, galilean_shift, lev);
+    const std::array<Real, 3>& xyzmin_depos = WarpX::LowerCorner(depos_box, galilean_shift, lev);
+
+    const Dim3 lo_gather = lbound(gather_box);
+    const Dim3 lo_depos = lbound(depos_box);
+
+    bool galerkin_interpolation = WarpX::galerkin_interpolation;
+    int n_rz_azimuthal_modes = WarpX::n_rz_azimuthal_modes;
+
+    amrex::GpuArray<amrex::Real, 3> dx_arr = {dx[0], dx[1], dx[2]};
+    amrex::GpuArray<amrex::Real, 3> dxi_arr = {1.0_rt/dx[0], 1.0_rt/dx[1], 1.0_rt/dx[2]};
+    amrex::GpuArray<amrex::Real, 3> xyzmin_gather_arr = {
+        xyzmin_gather[0], xyzmin_gather[1], xyzmin_gather[2]};
+    amrex::GpuArray<amrex::Real, 3> xyzmin_depos_arr = {
+        xyzmin_depos[0], xyzmin_depos[1], xyzmin_depos[2]};
+
+    amrex::Array4<const amrex::Real> const& ex_arr = exfab->array();
+    amrex::Array4<const amrex::Real> const& ey_arr = eyfab->array();
+    amrex::Array4<const amrex::Real> const& ez_arr = ezfab->array();
+    amrex::Array4<const amrex::Real> const& bx_arr = bxfab->array();
+    amrex::Array4<const amrex::Real> const& by_arr = byfab->array();
+    amrex::Array4<const amrex::Real> const& bz_arr = bzfab->array();
+
+    amrex::IndexType const ex_type = exfab->box().ixType();
+    amrex::IndexType const ey_type = eyfab->box().ixType();
+    amrex::IndexType const ez_type = ezfab->box().ixType();
+    amrex::IndexType const bx_type = bxfab->box().ixType();
+    amrex::IndexType const by_type = byfab->box().ixType();
+    amrex::IndexType const bz_type = bzfab->box().ixType();
+
+    Array4<Real> const& jx_arr = jx->array(pti);
+    Array4<Real> const& jy_arr = jy->array(pti);
+    Array4<Real> const& jz_arr = jz->array(pti);
+
+    auto& attribs = pti.GetAttribs();
+    const ParticleReal* const AMREX_RESTRICT wp = attribs[PIdx::w].dataPtr();
+    ParticleReal* const AMREX_RESTRICT ux = attribs[PIdx::ux].dataPtr();
+    ParticleReal* const AMREX_RESTRICT uy = attribs[PIdx::uy].dataPtr();
+    ParticleReal* const AMREX_RESTRICT uz = attribs[PIdx::uz].dataPtr();
+
+    auto copyAttribs = CopyParticleAttribs(pti, tmp_particle_data);
+    int do_copy = (WarpX::do_back_transformed_diagnostics &&
+                          do_back_transformed_diagnostics &&
+                   (a_dt_type!=DtType::SecondHalf));
+
+    const bool save_previous_position = m_save_previous_position;
+    ParticleReal* x_old = nullptr;
+    ParticleReal* y_old = nullptr;
+    ParticleReal* z_old = nullptr;
+    if (save_previous_position) {
+        x_old = pti.GetAttribs(particle_comps["prev_x"]).dataPtr();
+#if (AMREX_SPACEDIM == 3)
+        y_old = pti.GetAttribs(particle_comps["prev_y"]).dataPtr();
+#else
+    amrex::ignore_unused(y_old);
+#endif
+        z_old = pti.GetAttribs(particle_comps["prev_z"]).dataPtr();
+    }
+
+    const amrex::Real q = this->charge;
+    const amrex::Real m = this-> mass;
+
+    const auto pusher_algo = WarpX::particle_pusher_algo;
+    const auto do_crr = do_classical_radiation_reaction;
+#ifdef WARPX_QED
+    const auto do_sync = m_do_qed_quantum_sync;
+    amrex::Real t_chi_max = 0.0;
+    if (do_sync) t_chi_max = m_shr_p_qs_engine->get_minimum_chi_part();
+
+    QuantumSynchrotronEvolveOpticalDepth evolve_opt;
+    amrex::ParticleReal* AMREX_RESTRICT p_optical_depth_QSR = nullptr;
+    const bool local_has_quantum_sync = has_quantum_sync();
+    if (local_has_quantum_sync) {
+        evolve_opt = m_shr_p_qs_engine->build_evolve_functor();
+        p_optical_depth_QSR = pti.GetAttribs(particle_comps["opticalDepthQSR"]).dataPtr();
+    }
+    amrex::Real* const p_chi_extrema = GetChiExtremaPtr();
+#endif
+
+    const auto t_do_not_gather = do_not_gather;
+    // Whether the shape factors computed in the gather are reused in the deposition
+    const bool reuse_shape_factors = WarpX::do_cache_shape_factors && !t_do_not_gather;
+
+    amrex::ParallelFor( np_to_push, [=] AMREX_GPU_DEVICE (long ip)
+    {
+        amrex::ParticleReal xp, yp, zp;
+        getPosition(ip, xp, yp, zp);
+
+        if (save_previous_position) {
+            x_old[ip] = xp;
+#if (AMREX_SPACEDIM == 3)
+            y_old[ip] = yp;
+#endif
+            z_old[ip] = zp;
+        }
+
+        amrex::ParticleReal Exp = 0._rt, Eyp = 0._rt, Ezp = 0._rt;
+        amrex::ParticleReal Bxp = 0._rt, Byp = 0._rt, Bzp = 0._rt;
+
+        // Nodal shape factors of the particle before the push
+        NodalShapeFactors<depos_order> old_shape;
+        NodalShapeFactors<depos_order>* const p_old_shape =
+            reuse_shape_factors ? &old_shape : nullptr;
+
+        if(!t_do_not_gather){
+            // first gather E and B to the particle positions
+            if (galerkin_interpolation) {
+                doGatherShapeN<depos_order,1>(xp, yp, zp, Exp, Eyp, Ezp, Bxp, Byp, Bzp,
+                               ex_arr, ey_arr, ez_arr, bx_arr, by_arr, bz_arr,
+                               ex_type, ey_type, ez_type, bx_type, by_type, bz_type,
+                               dx_arr, xyzmin_gather_arr, lo_gather, n_rz_azimuthal_modes,
+                               p_old_shape);
+            } else {
+                doGatherShapeN<depos_order,0>(xp, yp, zp, Exp, Eyp, Ezp, Bxp, Byp, Bzp,
+                               ex_arr, ey_arr, ez_arr, bx_arr, by_arr, bz_arr,
+                               ex_type, ey_type, ez_type, bx_type, by_type, bz_type,
+                               dx_arr, xyzmin_gather_arr, lo_gather, n_rz_azimuthal_modes,
+                               p_old_shape);
+            }
         }
         // Externally applied E-field in Cartesian co-ordinates
         getExternalE(ip, Exp, Eyp, Ezp);
@@ -2507,11 +3278,68 @@ PhysicalParticleContainer::PushPX (WarpXParIter& pti,
                        Exp, Eyp, Ezp,Bxp, Byp, Bzp,
                        dt, p_optical_depth_QSR[ip]);
         }
+        if (p_chi_extrema) {
+            QedUtils::RecordChiExtrema(p_chi_extrema, QedUtils::chi_ele_pos(
+                m*ux[ip], m*uy[ip], m*uz[ip], Exp, Eyp, Ezp, Bxp, Byp, Bzp));
+        }
 #endif
 
+        // Deposit the current of the particle, using the updated position and
+        // momentum that are still in registers (the Esirkepov algorithm recovers
+        // the position before the push from the momentum, or reuses the shape
+        // factors of the gather)
+        getPosition(ip, xp, yp, zp);
+        amrex::Real wq = q*wp[ip];
+        if (ion_lev) wq *= ion_lev[ip];
+
+        doEsirkepovDepositionOneParticle<depos_order>(
+            xp, yp, zp, ux[ip], uy[ip], uz[ip], wq, jx_arr, jy_arr, jz_arr,
+            dt, dxi_arr, xyzmin_depos_arr, lo_depos, n_rz_azimuthal_modes, p_old_shape);
     });
 }
 
+void
+PhysicalParticleContainer::PushPXAndDepositCurrent (WarpXParIter& pti,
+                                                    amrex::FArrayBox const * exfab,
+                                                    amrex::FArrayBox const * eyfab,
+                                                    amrex::FArrayBox const * ezfab,
+                                                    amrex::FArrayBox const * bxfab,
+                                                    amrex::FArrayBox const * byfab,
+                                                    amrex::FArrayBox const * bzfab,
+                                                    const amrex::IntVect ngE,
+                                                    int const * const ion_lev,
+                                                    amrex::MultiFab * const jx,
+                                                    amrex::MultiFab * const jy,
+                                                    amrex::MultiFab * const jz,
+                                                    const long np_to_push,
+                                                    int lev, amrex::Real dt, ScaleFields scaleFields,
+                                                    DtType a_dt_type)
+{
+    // If no particles, do not do anything
+    if (np_to_push == 0) return;
+
+    if (WarpX::do_nodal==1) {
+        amrex::Abort("The Esirkepov algorithm cannot be used with a nodal grid.");
+    }
+    if ( (m_v_galilean[0]!=0) or (m_v_galilean[1]!=0) or (m_v_galilean[2]!=0)){
+        amrex::Abort("The Esirkepov algorithm cannot be used with the Galilean algorithm.");
+    }
+
+    if        (WarpX::nox == 1){
+        PushPXAndDepositCurrentShapeN<1>(
+            pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab, ngE, ion_lev,
+            jx, jy, jz, np_to_push, lev, dt, scaleFields, a_dt_type);
+    } else if (WarpX::nox == 2){
+        PushPXAndDepositCurrentShapeN<2>(
+            pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab, ngE, ion_lev,
+            jx, jy, jz, np_to_push, lev, dt, scaleFields, a_dt_type);
+    } else if (WarpX::nox == 3){
+        PushPXAndDepositCurrentShapeN<3>(
+            pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab, ngE, ion_lev,
+            jx, jy, jz, np_to_push, lev, dt, scaleFields, a_dt_type);
+    }
+}
+
 void
 PhysicalParticleContainer::InitIonizationModule ()
 {
@@ -2527,6 +3355,11 @@ PhysicalParticleContainer::InitIonizationModule ()
     queryWithParser(pp_species_name, "ionization_initial_level", ionization_initial_level);
     pp_species_name.get("ionization_product_species", ionization_product_name);
     pp_species_name.get("physical_element", physical_element);
+    pp_species_name.query("ionization_rate_table_npoints", ionization_rate_table_npoints);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+        ionization_rate_table_npoints == 0 || ionization_rate_table_npoints >= 2,
+        species_name + ".ionization_rate_table_npoints must be 0 or at least 2");
+    pp_species_name.query("ionization_skip_low_field_tiles", ionization_skip_low_field_tiles);
     // Add runtime integer component for ionization level
     AddIntComp("ionization_level");
     // Get atomic number and ionization energies from file
@@ -2576,6 +3409,82 @@ PhysicalParticleContainer::InitIonizationModule ()
     });
 
     Gpu::synchronize();
+
+    // For each level, find the field E_min below which the ADK rate (times dt)
+    // is so small that the ionization probability rounds to 0, and the field E_max
+    // up to which the rate increases with the field (and the ADK formula is valid).
+    Vector<Real> h_adk_power(ion_atomic_number);
+    Vector<Real> h_adk_prefactor(ion_atomic_number);
+    Vector<Real> h_adk_exp_prefactor(ion_atomic_number);
+    Gpu::copyAsync(Gpu::deviceToHost, adk_power.begin(), adk_power.end(), h_adk_power.begin());
+    Gpu::copyAsync(Gpu::deviceToHost, adk_prefactor.begin(), adk_prefactor.end(),
+                   h_adk_prefactor.begin());
+    Gpu::copyAsync(Gpu::deviceToHost, adk_exp_prefactor.begin(), adk_exp_prefactor.end(),
+                   h_adk_exp_prefactor.begin());
+    Gpu::streamSynchronize();
+
+    constexpr double log_negligible_rate = -46.; // log(1.e-20)
+    const Real never = std::numeric_limits<Real>::max();
+    const int ntable = ionization_rate_table_npoints;
+    Vector<Real> h_min_field(ion_atomic_number);
+    Vector<Real> h_log_rate_table(ion_atomic_number*ntable);
+    Vector<Real> h_inv_field_min(ion_atomic_number);
+    Vector<Real> h_inv_field_step_inv(ion_atomic_number);
+    for (int i=0; i<ion_atomic_number; i++){
+        const double log_prefactor = std::log(static_cast<double>(h_adk_prefactor[i]));
+        const double power = h_adk_power[i];
+        const double exp_prefactor = h_adk_exp_prefactor[i];
+        const auto log_rate = [=] (const double E) {
+            return log_prefactor + power*std::log(E) + exp_prefactor/E;
+        };
+        double E_max = -exp_prefactor;
+        if (power < 0.) E_max = std::min(E_max, exp_prefactor/power);
+        if (log_rate(E_max) < log_negligible_rate){
+            // This level is never ionized
+            h_min_field[i] = never;
+            h_inv_field_min[i] = 0._rt;
+            h_inv_field_step_inv[i] = never;
+            continue;
+        }
+        // Bisection (in log scale) for log_rate(E_min) = log_negligible_rate
+        double E_lo = 1.e-10*E_max;
+        double E_hi = E_max;
+        for (int iter=0; iter<100; iter++){
+            const double E_mid = std::sqrt(E_lo*E_hi);
+            if (log_rate(E_mid) < log_negligible_rate) E_lo = E_mid;
+            else E_hi = E_mid;
+        }
+        h_min_field[i] = static_cast<Real>(E_lo);
+        if (ntable > 0){
+            const double u_min = 1./E_max;
+            const double du = (1./E_lo - u_min)/(ntable - 1);
+            h_inv_field_min[i] = static_cast<Real>(u_min);
+            h_inv_field_step_inv[i] = static_cast<Real>(1./du);
+            for (int k=0; k<ntable; k++){
+                h_log_rate_table[i*ntable + k] = static_cast<Real>(log_rate(1./(u_min + k*du)));
+            }
+        }
+    }
+    // The ions of level >= l cannot be ionized below the lowest E_min of these levels
+    ionization_min_field.resize(ion_atomic_number);
+    Real min_field = never;
+    for (int i=ion_atomic_number-1; i>=0; i--){
+        min_field = std::min(min_field, h_min_field[i]);
+        ionization_min_field[i] = min_field;
+    }
+
+    if (ntable > 0){
+        adk_log_rate_table.resize(ion_atomic_number*ntable);
+        adk_table_inv_field_min.resize(ion_atomic_number);
+        adk_table_inv_field_step_inv.resize(ion_atomic_number);
+        Gpu::copyAsync(Gpu::hostToDevice, h_log_rate_table.begin(), h_log_rate_table.end(),
+                       adk_log_rate_table.begin());
+        Gpu::copyAsync(Gpu::hostToDevice, h_inv_field_min.begin(), h_inv_field_min.end(),
+                       adk_table_inv_field_min.begin());
+        Gpu::copyAsync(Gpu::hostToDevice, h_inv_field_step_inv.begin(), h_inv_field_step_inv.end(),
+                       adk_table_inv_field_step_inv.begin());
+        Gpu::streamSynchronize();
+    }
 }
 
 IonizationFilterFunc
@@ -2598,7 +3507,89 @@ PhysicalParticleContainer::getIonizationFunc (const WarpXParIter& pti,
                                 adk_exp_prefactor.dataPtr(),
                                 adk_power.dataPtr(),
                                 particle_icomps["ionization_level"],
-                                ion_atomic_number);
+                                ion_atomic_number,
+                                0,
+                                ionization_rate_table_npoints,
+                                adk_log_rate_table.dataPtr(),
+                                adk_table_inv_field_min.dataPtr(),
+                                adk_table_inv_field_step_inv.dataPtr());
+}
+
+bool
+PhysicalParticleContainer::hasIonizationCandidates (const WarpXParIter& pti,
+                                                    amrex::IntVect ngE,
+                                                    const amrex::FArrayBox& Ex,
+                                                    const amrex::FArrayBox& Ey,
+                                                    const amrex::FArrayBox& Ez,
+                                                    const amrex::FArrayBox& Bx,
+                                                    const amrex::FArrayBox& By,
+                                                    const amrex::FArrayBox& Bz)
+{
+    WARPX_PROFILE("PhysicalParticleContainer::hasIonizationCandidates()");
+
+    const long np = pti.numParticles();
+    if (np == 0) return false;
+
+    // Lowest ionization level, and highest momentum of the ions that are not fully ionized
+    const int* AMREX_RESTRICT ion_lev =
+        pti.GetiAttribs(particle_icomps["ionization_level"]).dataPtr();
+    const auto& attribs = pti.GetAttribs();
+    const ParticleReal* AMREX_RESTRICT ux = attribs[PIdx::ux].dataPtr();
+    const ParticleReal* AMREX_RESTRICT uy = attribs[PIdx::uy].dataPtr();
+    const ParticleReal* AMREX_RESTRICT uz = attribs[PIdx::uz].dataPtr();
+    const int atomic_number = ion_atomic_number;
+    ReduceOps<ReduceOpMin, ReduceOpMax> reduce_op;
+    ReduceData<int, ParticleReal> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+    reduce_op.eval(np, reduce_data,
+        [=] AMREX_GPU_DEVICE (long ip) -> ReduceTuple
+        {
+            const int l = ion_lev[ip];
+            const ParticleReal u2 = (l < atomic_number) ?
+                ux[ip]*ux[ip] + uy[ip]*uy[ip] + uz[ip]*uz[ip] : 0._prt;
+            return {l, u2};
+        });
+    ReduceTuple hv = reduce_data.value();
+    const int min_lev = amrex::get<0>(hv);
+    if (min_lev >= ion_atomic_number) return false;
+
+#ifdef WARPX_DIM_RZ
+    // In RZ, the gathered field is a combination of the azimuthal modes,
+    // which is not bounded by the values of the field in each cell
+    amrex::ignore_unused(ngE, Ex, Ey, Ez, Bx, By, Bz);
+    return true;
+#else
+    if (!ionization_skip_low_field_tiles) return true;
+
+    // Only constant external fields can be bounded
+    const auto& mypc = WarpX::GetInstance().GetPartContainer();
+    const bool constant_E_ext = (mypc.m_E_ext_particle_s == "constant" ||
+                                 mypc.m_E_ext_particle_s == "default");
+    const bool constant_B_ext = (mypc.m_B_ext_particle_s == "constant" ||
+                                 mypc.m_B_ext_particle_s == "default");
+    if (!constant_E_ext || !constant_B_ext) return true;
+
+    // Upper bound of |E| and |B| at the position of the particles: the field gather
+    // is a combination of the values in the cells, with positive weights summing to 1
+    const Box box = amrex::grow(pti.tilebox(), ngE);
+    const Real mex = maxAbsInTile(Ex, box);
+    const Real mey = maxAbsInTile(Ey, box);
+    const Real mez = maxAbsInTile(Ez, box);
+    const Real mbx = maxAbsInTile(Bx, box);
+    const Real mby = maxAbsInTile(By, box);
+    const Real mbz = maxAbsInTile(Bz, box);
+    const auto& E_ext = mypc.m_E_external_particle;
+    const auto& B_ext = mypc.m_B_external_particle;
+    const Real E_bound = std::sqrt(mex*mex + mey*mey + mez*mez)
+        + std::sqrt(E_ext[0]*E_ext[0] + E_ext[1]*E_ext[1] + E_ext[2]*E_ext[2]);
+    const Real B_bound = std::sqrt(mbx*mbx + mby*mby + mbz*mbz)
+        + std::sqrt(B_ext[0]*B_ext[0] + B_ext[1]*B_ext[1] + B_ext[2]*B_ext[2]);
+
+    // The field in the frame of an ion is lower than gamma*(|E| + c|B|)
+    constexpr Real inv_c2 = 1._rt/(PhysConst::c*PhysConst::c);
+    const Real gamma_max = std::sqrt(1._rt + amrex::get<1>(hv)*inv_c2);
+    return gamma_max*(E_bound + PhysConst::c*B_bound) >= ionization_min_field[min_lev];
+#endif
 }
 
 void PhysicalParticleContainer::resample (const int timestep)
@@ -2628,6 +3619,20 @@ void PhysicalParticleContainer::resample (const int timestep)
             }
         }
     }
+    else if (m_resampler.hasTileTrigger())
+    {
+        // Only resample the tiles in which the number of particles per cell is too high
+        for (int lev = 0; lev <= maxLevel(); lev++)
+        {
+            for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+            {
+                if (m_resampler.tileTriggered(pti.numParticles(), pti.tilebox().numPts()))
+                {
+                    m_resampler(pti, lev, this);
+                }
+            }
+        }
+    }
     WARPX_PROFILE_VAR_STOP(blp_resample_actual);
 
 }
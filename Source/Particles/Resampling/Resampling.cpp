@@ -7,6 +7,7 @@
 #include "Resampling.H"
 
 #include "LevelingThinning.H"
+#include "VelocityMerging.H"
 
 #include <AMReX.H>
 #include <AMReX_ParmParse.H>
@@ -21,6 +22,10 @@ Resampling::Resampling (const std::string species_name)
     {
         m_resampling_algorithm = std::make_unique<LevelingThinning>(species_name);
     }
+    else if (resampling_algorithm_string.compare("velocity_merging") == 0)
+    {
+        m_resampling_algorithm = std::make_unique<VelocityMerging>(species_name);
+    }
     else
     { amrex::Abort("Unknown resampling algorithm."); }
 
@@ -32,6 +37,17 @@ bool Resampling::triggered (const int timestep, const amrex::Real global_numpart
     return m_resampling_trigger.triggered(timestep, global_numparts);
 }
 
+bool Resampling::hasTileTrigger () const
+{
+    return m_resampling_trigger.hasTileTrigger();
+}
+
+bool Resampling::tileTriggered (const amrex::Long tile_numparts,
+                                const amrex::Long tile_numcells) const
+{
+    return m_resampling_trigger.tileTriggered(tile_numparts, tile_numcells);
+}
+
 void Resampling::operator() (WarpXParIter& pti, const int lev, WarpXParticleContainer * const pc) const
 {
     (*m_resampling_algorithm)(pti, lev, pc);
@@ -23,6 +23,9 @@ ResamplingTrigger::ResamplingTrigger (const std::string species_name)
     m_resampling_intervals = IntervalsParser(resampling_trigger_int_string_vec);
 
     queryWithParser(pp_species_name, "resampling_trigger_max_avg_ppc", m_max_avg_ppc);
+
+    m_has_tile_trigger = queryWithParser(pp_species_name, "resampling_trigger_max_tile_ppc",
+                                         m_max_tile_ppc);
 }
 
 bool ResamplingTrigger::triggered (const int timestep, const amrex::Real global_numparts) const
@@ -34,6 +37,15 @@ bool ResamplingTrigger::triggered (const int timestep, const amrex::Real global_
             avg_ppc > m_max_avg_ppc);
 }
 
+bool ResamplingTrigger::tileTriggered (const amrex::Long tile_numparts,
+                                       const amrex::Long tile_numcells) const
+{
+    if (!m_has_tile_trigger || tile_numcells == 0) return false;
+
+    const amrex::Real tile_ppc = static_cast<amrex::Real>(tile_numparts)/tile_numcells;
+    return tile_ppc > m_max_tile_ppc;
+}
+
 void ResamplingTrigger::initialize_global_numcells () const
 {
     auto & warpx = WarpX::GetInstance();
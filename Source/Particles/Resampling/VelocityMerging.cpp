@@ -0,0 +1,240 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "VelocityMerging.H"
+
+#include "Particles/WarpXParticleContainer.H"
+#include "Utils/ParticleUtils.H"
+#include "Utils/WarpXConst.H"
+#include "Utils/WarpXUtil.H"
+
+#include <AMReX.H>
+#include <AMReX_BLassert.H>
+#include <AMReX_DenseBins.H>
+#include <AMReX_Extension.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_GpuQualifiers.H>
+#include <AMReX_Math.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Particle.H>
+#include <AMReX_ParticleTile.H>
+#include <AMReX_Particles.H>
+#include <AMReX_Random.H>
+#include <AMReX_StructOfArrays.H>
+
+#include <AMReX_BaseFwd.H>
+
+#include <cmath>
+#include <map>
+
+VelocityMerging::VelocityMerging (const std::string species_name)
+{
+    amrex::ParmParse pp_species_name(species_name);
+    queryWithParser(pp_species_name, "resampling_algorithm_n_momentum_bins", m_n_momentum_bins);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_n_momentum_bins >= 1,
+        "Resampling n_momentum_bins should be greater than or equal to 1");
+
+    queryWithParser(pp_species_name, "resampling_algorithm_min_ppc", m_min_ppc);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_min_ppc >= 1,
+                                     "Resampling min_ppc should be greater than or equal to 1");
+}
+
+void VelocityMerging::operator() (WarpXParIter& pti, const int lev,
+                                  WarpXParticleContainer * const pc) const
+{
+    using namespace amrex::literals;
+
+    auto& ptile = pc->ParticlesAt(lev, pti);
+    auto& soa = ptile.GetStructOfArrays();
+    amrex::ParticleReal * const AMREX_RESTRICT w = soa.GetRealData(PIdx::w).data();
+    amrex::ParticleReal * const AMREX_RESTRICT ux = soa.GetRealData(PIdx::ux).data();
+    amrex::ParticleReal * const AMREX_RESTRICT uy = soa.GetRealData(PIdx::uy).data();
+    amrex::ParticleReal * const AMREX_RESTRICT uz = soa.GetRealData(PIdx::uz).data();
+    WarpXParticleContainer::ParticleType * const AMREX_RESTRICT
+                                 particle_ptr = ptile.GetArrayOfStructs()().data();
+
+    // Particles of different ionization levels (i.e. of different charges) are not merged
+    const std::map<std::string, int> icomps = pc->getParticleiComps();
+    const auto it_ion_lev = icomps.find("ionization_level");
+    const int * const AMREX_RESTRICT ion_lev = (it_ion_lev == icomps.end()) ? nullptr :
+        soa.GetIntData(it_ion_lev->second).data();
+
+    // For photons, the energy is proportional to |u| instead of gamma
+    const bool is_photon = pc->AmIA<PhysicalSpecies::photon>();
+
+    auto bins = ParticleUtils::findParticlesInEachCell(lev, pti, ptile);
+
+    const int n_cells = bins.numBins();
+    const auto indices = bins.permutationPtr();
+    const auto cell_offsets = bins.offsetsPtr();
+
+    const int nb = m_n_momentum_bins;
+    const int min_ppc = m_min_ppc;
+
+    // Loop over cells
+    amrex::ParallelForRNG( n_cells,
+        [=] AMREX_GPU_DEVICE (int i_cell, amrex::RandomEngine const& engine) noexcept
+        {
+            constexpr amrex::ParticleReal c = PhysConst::c;
+            constexpr amrex::ParticleReal inv_c2 = 1._prt/(PhysConst::c*PhysConst::c);
+
+            // The particles that are in the cell `i_cell` are
+            // given by the `indices[cell_start:cell_stop]`
+            const auto cell_start = cell_offsets[i_cell];
+            const auto cell_stop = cell_offsets[i_cell+1];
+            const int cell_numparts = static_cast<int>(cell_stop - cell_start);
+
+            // do nothing for cells with less particles than min_ppc
+            // (this intentionally includes skipping empty cells, too)
+            if (cell_numparts < amrex::max(min_ppc, 3))
+                return;
+
+            // Extent of the momenta of the particles of the cell
+            amrex::ParticleReal u_min[3] = {ux[indices[cell_start]], uy[indices[cell_start]],
+                                            uz[indices[cell_start]]};
+            amrex::ParticleReal u_max[3] = {u_min[0], u_min[1], u_min[2]};
+            for (auto i = cell_start; i < cell_stop; ++i)
+            {
+                const auto ip = indices[i];
+                u_min[0] = amrex::min(u_min[0], ux[ip]); u_max[0] = amrex::max(u_max[0], ux[ip]);
+                u_min[1] = amrex::min(u_min[1], uy[ip]); u_max[1] = amrex::max(u_max[1], uy[ip]);
+                u_min[2] = amrex::min(u_min[2], uz[ip]); u_max[2] = amrex::max(u_max[2], uz[ip]);
+            }
+            amrex::ParticleReal inv_du[3];
+            for (int d = 0; d < 3; ++d)
+            {
+                inv_du[d] = (u_max[d] > u_min[d]) ? nb/(u_max[d] - u_min[d]) : 0._prt;
+            }
+
+            // Key of the momentum bin (and ionization level) of a particle
+            const auto get_key = [=] (const unsigned int ip) noexcept -> int
+            {
+                const int bx = amrex::min(static_cast<int>((ux[ip] - u_min[0])*inv_du[0]), nb-1);
+                const int by = amrex::min(static_cast<int>((uy[ip] - u_min[1])*inv_du[1]), nb-1);
+                const int bz = amrex::min(static_cast<int>((uz[ip] - u_min[2])*inv_du[2]), nb-1);
+                const int key = (bz*nb + by)*nb + bx;
+                return ion_lev ? ion_lev[ip]*nb*nb*nb + key : key;
+            };
+
+            // Sort the particles of the cell by key (insertion sort: the number of
+            // particles per cell is small)
+            for (auto i = cell_start+1; i < cell_stop; ++i)
+            {
+                const auto ip = indices[i];
+                const int key = get_key(ip);
+                auto j = i;
+                while (j > cell_start && get_key(indices[j-1]) > key)
+                {
+                    indices[j] = indices[j-1];
+                    --j;
+                }
+                indices[j] = ip;
+            }
+
+            // Merge the particles of each bin that contains at least three particles
+            auto bin_start = cell_start;
+            while (bin_start < cell_stop)
+            {
+                const int key = get_key(indices[bin_start]);
+                auto bin_stop = bin_start + 1;
+                while (bin_stop < cell_stop && get_key(indices[bin_stop]) == key) ++bin_stop;
+                if (bin_stop - bin_start < 3)
+                {
+                    bin_start = bin_stop;
+                    continue;
+                }
+
+                // Total weight, momentum and energy of the bin (the energy is
+                // (gamma - 1) for massive particles, and |u|/c for photons)
+                amrex::ParticleReal w_t = 0._prt;
+                amrex::ParticleReal p_t[3] = {0._prt, 0._prt, 0._prt};
+                amrex::ParticleReal e_t = 0._prt;
+                for (auto i = bin_start; i < bin_stop; ++i)
+                {
+                    const auto ip = indices[i];
+                    const amrex::ParticleReal u2 = ux[ip]*ux[ip] + uy[ip]*uy[ip] + uz[ip]*uz[ip];
+                    const amrex::ParticleReal e = is_photon ? std::sqrt(u2)/c :
+                        u2*inv_c2/(std::sqrt(1._prt + u2*inv_c2) + 1._prt);
+                    w_t += w[ip];
+                    p_t[0] += w[ip]*ux[ip];
+                    p_t[1] += w[ip]*uy[ip];
+                    p_t[2] += w[ip]*uz[ip];
+                    e_t += w[ip]*e;
+                }
+                if (w_t <= 0._prt)
+                {
+                    bin_start = bin_stop;
+                    continue;
+                }
+
+                // Momentum magnitude of the two new particles, from energy conservation
+                const amrex::ParticleReal e_new = e_t/w_t;
+                const amrex::ParticleReal u_new = is_photon ? e_new*c :
+                    c*std::sqrt(e_new*(e_new + 2._prt));
+                const amrex::ParticleReal p_norm = std::sqrt(p_t[0]*p_t[0] + p_t[1]*p_t[1]
+                                                             + p_t[2]*p_t[2]);
+
+                // Direction of the total momentum (e1) and of a random unit vector
+                // orthogonal to it (e2)
+                amrex::ParticleReal e1[3] = {0._prt, 0._prt, 1._prt};
+                if (p_norm > 0._prt)
+                {
+                    e1[0] = p_t[0]/p_norm; e1[1] = p_t[1]/p_norm; e1[2] = p_t[2]/p_norm;
+                }
+                // a: normalized cross product of e1 with the axis of its smallest component
+                amrex::ParticleReal a[3];
+                if (amrex::Math::abs(e1[0]) <= amrex::Math::abs(e1[1]) &&
+                    amrex::Math::abs(e1[0]) <= amrex::Math::abs(e1[2]))
+                {
+                    a[0] = 0._prt; a[1] = e1[2]; a[2] = -e1[1];
+                }
+                else if (amrex::Math::abs(e1[1]) <= amrex::Math::abs(e1[2]))
+                {
+                    a[0] = -e1[2]; a[1] = 0._prt; a[2] = e1[0];
+                }
+                else
+                {
+                    a[0] = e1[1]; a[1] = -e1[0]; a[2] = 0._prt;
+                }
+                const amrex::ParticleReal a_norm = std::sqrt(a[0]*a[0] + a[1]*a[1] + a[2]*a[2]);
+                a[0] /= a_norm; a[1] /= a_norm; a[2] /= a_norm;
+                const amrex::ParticleReal b[3] = {e1[1]*a[2] - e1[2]*a[1],
+                                                  e1[2]*a[0] - e1[0]*a[2],
+                                                  e1[0]*a[1] - e1[1]*a[0]};
+                const amrex::ParticleReal phi = 2._prt*MathConst::pi*amrex::Random(engine);
+                const amrex::ParticleReal cos_phi = std::cos(phi);
+                const amrex::ParticleReal sin_phi = std::sin(phi);
+                const amrex::ParticleReal e2[3] = {cos_phi*a[0] + sin_phi*b[0],
+                                                   cos_phi*a[1] + sin_phi*b[1],
+                                                   cos_phi*a[2] + sin_phi*b[2]};
+
+                // Angle between the momenta of the new particles and the total momentum,
+                // from momentum conservation
+                amrex::ParticleReal cos_theta = (u_new > 0._prt) ? p_norm/(w_t*u_new) : 1._prt;
+                cos_theta = amrex::min(cos_theta, 1._prt);
+                const amrex::ParticleReal sin_theta = std::sqrt(1._prt - cos_theta*cos_theta);
+
+                // The two first particles of the bin become the new particles,
+                // the other ones are removed
+                for (int n = 0; n < 2; ++n)
+                {
+                    const auto ip = indices[bin_start + n];
+                    const amrex::ParticleReal s = (n == 0) ? sin_theta : -sin_theta;
+                    w[ip] = 0.5_prt*w_t;
+                    ux[ip] = u_new*(cos_theta*e1[0] + s*e2[0]);
+                    uy[ip] = u_new*(cos_theta*e1[1] + s*e2[1]);
+                    uz[ip] = u_new*(cos_theta*e1[2] + s*e2[2]);
+                }
+                for (auto i = bin_start + 2; i < bin_stop; ++i)
+                {
+                    particle_ptr[indices[i]].id() = -1;
+                }
+
+                bin_start = bin_stop;
+            }
+        }
+    );
+}
@@ -38,6 +38,7 @@
 #include <AMReX_GpuContainers.H>
 #include <AMReX_GpuControl.H>
 #include <AMReX_GpuDevice.H>
+#include <AMReX_GpuElixir.H>
 #include <AMReX_GpuLaunch.H>
 #include <AMReX_GpuQualifiers.H>
 #include <AMReX_IndexType.H>
@@ -46,7 +47,10 @@
 #include <AMReX_PODVector.H>
 #include <AMReX_ParIter.H>
 #include <AMReX_ParmParse.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParticleReduce.H>
 #include <AMReX_Particles.H>
+#include <AMReX_Reduce.H>
 #include <AMReX_StructOfArrays.H>
 
 #include <algorithm>
@@ -164,100 +168,135 @@ RigidInjectedParticleContainer::PushPX (WarpXParIter& pti,
                                         amrex::Real dt, ScaleFields /*scaleFields*/,
                                         DtType a_dt_type)
 {
-    auto& attribs = pti.GetAttribs();
-    auto& uxp = attribs[PIdx::ux];
-    auto& uyp = attribs[PIdx::uy];
-    auto& uzp = attribs[PIdx::uz];
-
-    // Save the position and momenta, making copies
-    Gpu::DeviceVector<ParticleReal> xp_save, yp_save, zp_save;
-    RealVector uxp_save, uyp_save, uzp_save;
-
-    const auto GetPosition = GetParticlePosition(pti);
-          auto SetPosition = SetParticlePosition(pti);
-
-    ParticleReal* const AMREX_RESTRICT ux = uxp.dataPtr() + offset;
-    ParticleReal* const AMREX_RESTRICT uy = uyp.dataPtr() + offset;
-    ParticleReal* const AMREX_RESTRICT uz = uzp.dataPtr() + offset;
-
-    if (!done_injecting_lev)
-    {
-        // If the old values are not already saved, create copies here.
-        const auto np = pti.numParticles();
-
-        xp_save.resize(np);
-        yp_save.resize(np);
-        zp_save.resize(np);
-
-        uxp_save.resize(np);
-        uyp_save.resize(np);
-        uzp_save.resize(np);
-
-        amrex::Real* const AMREX_RESTRICT xp_save_ptr = xp_save.dataPtr() + offset;
-        amrex::Real* const AMREX_RESTRICT yp_save_ptr = yp_save.dataPtr() + offset;
-        amrex::Real* const AMREX_RESTRICT zp_save_ptr = zp_save.dataPtr() + offset;
-
-        amrex::Real* const AMREX_RESTRICT uxp_save_ptr = uxp_save.dataPtr() + offset;
-        amrex::Real* const AMREX_RESTRICT uyp_save_ptr = uyp_save.dataPtr() + offset;
-        amrex::Real* const AMREX_RESTRICT uzp_save_ptr = uzp_save.dataPtr() + offset;
-
-        amrex::ParallelFor( np,
-                            [=] AMREX_GPU_DEVICE (long i) {
-                                ParticleReal xp, yp, zp;
-                                GetPosition(i, xp, yp, zp);
-                                xp_save_ptr[i] = xp;
-                                yp_save_ptr[i] = yp;
-                                zp_save_ptr[i] = zp;
-                                uxp_save_ptr[i] = ux[i];
-                                uyp_save_ptr[i] = uy[i];
-                                uzp_save_ptr[i] = uz[i];
-                            });
-    }
-
     const bool do_scale = not done_injecting_lev;
     const Real v_boost = WarpX::beta_boost*PhysConst::c;
-    PhysicalParticleContainer::PushPX(pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab,
-                                      ngE, e_is_nodal, offset, np_to_push, lev, gather_lev, dt,
-                                      ScaleFields(do_scale, dt, zinject_plane_lev_previous,
-                                                  vzbeam_ave_boosted, v_boost),
-                                      a_dt_type);
+    const ScaleFields scaleFields(do_scale, dt, zinject_plane_lev_previous,
+                                  vzbeam_ave_boosted, v_boost);
+
+    if (done_injecting_lev || np_to_push == 0) {
+        PhysicalParticleContainer::PushPX(pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab,
+                                          ngE, e_is_nodal, offset, np_to_push, lev, gather_lev,
+                                          dt, scaleFields, a_dt_type);
+        return;
+    }
 
-    if (!done_injecting_lev) {
+    const auto GetPosition = GetParticlePosition(pti, offset);
+          auto SetPosition = SetParticlePosition(pti, offset);
 
-        ParticleReal* AMREX_RESTRICT x_save = xp_save.dataPtr() + offset;
-        ParticleReal* AMREX_RESTRICT y_save = yp_save.dataPtr() + offset;
-        ParticleReal* AMREX_RESTRICT z_save = zp_save.dataPtr() + offset;
-        ParticleReal* AMREX_RESTRICT ux_save = uxp_save.dataPtr() + offset;
-        ParticleReal* AMREX_RESTRICT uy_save = uyp_save.dataPtr() + offset;
-        ParticleReal* AMREX_RESTRICT uz_save = uzp_save.dataPtr() + offset;
+    auto& attribs = pti.GetAttribs();
+    ParticleReal* const AMREX_RESTRICT ux = attribs[PIdx::ux].dataPtr() + offset;
+    ParticleReal* const AMREX_RESTRICT uy = attribs[PIdx::uy].dataPtr() + offset;
+    ParticleReal* const AMREX_RESTRICT uz = attribs[PIdx::uz].dataPtr() + offset;
+
+    // Since particles move by less than c*dt, the injection plane can only be
+    // crossed in this step by the particles within c*dt of it: the others are
+    // either all pushed normally or all advanced rigidly, without saving and
+    // restoring their positions and momenta.
+    ReduceOps<ReduceOpMin, ReduceOpMax> reduce_op;
+    ReduceData<ParticleReal, ParticleReal> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+    reduce_op.eval(np_to_push, reduce_data,
+        [=] AMREX_GPU_DEVICE (long i) -> ReduceTuple
+        {
+            ParticleReal xp, yp, zp;
+            GetPosition(i, xp, yp, zp);
+            return {zp, zp};
+        });
+    ReduceTuple hv = reduce_data.value();
+    const ParticleReal zmin = amrex::get<0>(hv);
+    const ParticleReal zmax = amrex::get<1>(hv);
+    const Real z_plane_lev = zinject_plane_lev;
+    const Real cdt = PhysConst::c*dt;
+
+    if (zmin - cdt > z_plane_lev) {
+        // All the particles are injected at the end of this step
+        PhysicalParticleContainer::PushPX(pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab,
+                                          ngE, e_is_nodal, offset, np_to_push, lev, gather_lev,
+                                          dt, scaleFields, a_dt_type);
+        return;
+    }
 
-        // Undo the push for particles not injected yet.
+    const Real vz_ave_boosted = vzbeam_ave_boosted;
+    const bool rigid = rigid_advance;
+    const Real inv_csq = 1._rt/(PhysConst::c*PhysConst::c);
+
+    // The pusher also saves the previous positions and the attributes of the
+    // back-transformed diagnostics, which the rigid advance alone does not do
+    const bool only_rigid = (zmax + cdt <= z_plane_lev) && !m_save_previous_position &&
+        !(WarpX::do_back_transformed_diagnostics && do_back_transformed_diagnostics) &&
+        !has_quantum_sync();
+    if (only_rigid) {
+        // None of the particles are injected at the end of this step:
+        // no field gather and momentum push is needed.
         // The zp are advanced a fixed amount.
-        const Real z_plane_lev = zinject_plane_lev;
-        const Real vz_ave_boosted = vzbeam_ave_boosted;
-        const bool rigid = rigid_advance;
-        const Real inv_csq = 1./(PhysConst::c*PhysConst::c);
-        amrex::ParallelFor( pti.numParticles(),
+        amrex::ParallelFor( np_to_push,
                             [=] AMREX_GPU_DEVICE (long i) {
                                 ParticleReal xp, yp, zp;
                                 GetPosition(i, xp, yp, zp);
-                                if (zp <= z_plane_lev) {
-                                    ux[i] = ux_save[i];
-                                    uy[i] = uy_save[i];
-                                    uz[i] = uz_save[i];
-                                    xp = x_save[i];
-                                    yp = y_save[i];
-                                    if (rigid) {
-                                        zp = z_save[i] + dt*vz_ave_boosted;
-                                    }
-                                    else {
-                                        const Real gi = 1./std::sqrt(1. + (ux[i]*ux[i] + uy[i]*uy[i] + uz[i]*uz[i])*inv_csq);
-                                        zp = z_save[i] + dt*uz[i]*gi;
-                                    }
-                                    SetPosition(i, xp, yp, zp);
+                                if (rigid) {
+                                    zp += dt*vz_ave_boosted;
+                                }
+                                else {
+                                    const Real gi = 1._rt/std::sqrt(1._rt + (ux[i]*ux[i] + uy[i]*uy[i] + uz[i]*uz[i])*inv_csq);
+                                    zp += dt*uz[i]*gi;
                                 }
+                                SetPosition(i, xp, yp, zp);
                             });
+        return;
     }
+
+    // Save the position and momenta of the particles that are pushed, making copies
+    Gpu::DeviceVector<ParticleReal> xp_save(np_to_push), yp_save(np_to_push), zp_save(np_to_push);
+    Gpu::DeviceVector<ParticleReal> uxp_save(np_to_push), uyp_save(np_to_push), uzp_save(np_to_push);
+
+    ParticleReal* const AMREX_RESTRICT x_save = xp_save.dataPtr();
+    ParticleReal* const AMREX_RESTRICT y_save = yp_save.dataPtr();
+    ParticleReal* const AMREX_RESTRICT z_save = zp_save.dataPtr();
+    ParticleReal* const AMREX_RESTRICT ux_save = uxp_save.dataPtr();
+    ParticleReal* const AMREX_RESTRICT uy_save = uyp_save.dataPtr();
+    ParticleReal* const AMREX_RESTRICT uz_save = uzp_save.dataPtr();
+
+    amrex::ParallelFor( np_to_push,
+                        [=] AMREX_GPU_DEVICE (long i) {
+                            ParticleReal xp, yp, zp;
+                            GetPosition(i, xp, yp, zp);
+                            x_save[i] = xp;
+                            y_save[i] = yp;
+                            z_save[i] = zp;
+                            ux_save[i] = ux[i];
+                            uy_save[i] = uy[i];
+                            uz_save[i] = uz[i];
+                        });
+
+    PhysicalParticleContainer::PushPX(pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab,
+                                      ngE, e_is_nodal, offset, np_to_push, lev, gather_lev,
+                                      dt, scaleFields, a_dt_type);
+
+    // Undo the push for particles not injected yet.
+    // The zp are advanced a fixed amount.
+    amrex::ParallelFor( np_to_push,
+                        [=] AMREX_GPU_DEVICE (long i) {
+                            ParticleReal xp, yp, zp;
+                            GetPosition(i, xp, yp, zp);
+                            if (zp <= z_plane_lev) {
+                                ux[i] = ux_save[i];
+                                uy[i] = uy_save[i];
+                                uz[i] = uz_save[i];
+                                xp = x_save[i];
+                                yp = y_save[i];
+                                if (rigid) {
+                                    zp = z_save[i] + dt*vz_ave_boosted;
+                                }
+                                else {
+                                    const Real gi = 1._rt/std::sqrt(1._rt + (ux[i]*ux[i] + uy[i]*uy[i] + uz[i]*uz[i])*inv_csq);
+                                    zp = z_save[i] + dt*uz[i]*gi;
+                                }
+                                SetPosition(i, xp, yp, zp);
+                            }
+                        });
+    // Make sure that the temporary arrays are not destroyed before
+    // the GPU kernels finish running
+    Gpu::streamSynchronize();
 }
 
 void
@@ -287,6 +326,19 @@ RigidInjectedParticleContainer::Evolve (int lev,
     done_injecting_lev = ((zinject_plane_levels[lev] < plo[zdir] && WarpX::moving_window_v + WarpX::beta_boost*PhysConst::c >= 0.) ||
                            (zinject_plane_levels[lev] > phi[zdir] && WarpX::moving_window_v + WarpX::beta_boost*PhysConst::c <= 0.));
 
+    // Until then, the particles are pushed as regular particles as soon as all of
+    // them have crossed the inject plane (and will not cross it back in this step).
+    // This is checked at each step, since particles may still be injected.
+    if (!done_injecting_lev) {
+        using PType = typename WarpXParticleContainer::SuperParticleType;
+        Real zmin = ReduceMin( *this, lev,
+        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
+        { return p.pos(zdir); });
+        ParallelDescriptor::ReduceRealMin(zmin);
+        done_injecting_lev = (zmin > std::max(zinject_plane_lev_previous,
+                                              zinject_plane_lev + PhysConst::c*dt));
+    }
+
     PhysicalParticleContainer::Evolve (lev,
                                        Ex, Ey, Ez,
                                        Bx, By, Bz,
@@ -313,6 +365,9 @@ RigidInjectedParticleContainer::PushP (int lev, Real dt,
 #pragma omp parallel
 #endif
     {
+        FArrayBox nodal_Ex, nodal_Ey, nodal_Ez;
+        FArrayBox nodal_Bx, nodal_By, nodal_Bz;
+
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
         {
             amrex::Box box = pti.tilebox();
@@ -321,12 +376,23 @@ RigidInjectedParticleContainer::PushP (int lev, Real dt,
             const long np = pti.numParticles();
 
             // Data on the grid
-            const FArrayBox& exfab = Ex[pti];
-            const FArrayBox& eyfab = Ey[pti];
-            const FArrayBox& ezfab = Ez[pti];
-            const FArrayBox& bxfab = Bx[pti];
-            const FArrayBox& byfab = By[pti];
-            const FArrayBox& bzfab = Bz[pti];
+            FArrayBox const* exfab = &Ex[pti];
+            FArrayBox const* eyfab = &Ey[pti];
+            FArrayBox const* ezfab = &Ez[pti];
+            FArrayBox const* bxfab = &Bx[pti];
+            FArrayBox const* byfab = &By[pti];
+            FArrayBox const* bzfab = &Bz[pti];
+
+            Elixir nodal_exeli, nodal_eyeli, nodal_ezeli, nodal_bxeli, nodal_byeli, nodal_bzeli;
+            if (WarpX::do_on_the_fly_nodal_gather) {
+                // Interpolate the staggered fields to the nodes of the tile
+                InterpolateFieldToNodal(box, nodal_exeli, nodal_Ex, exfab);
+                InterpolateFieldToNodal(box, nodal_eyeli, nodal_Ey, eyfab);
+                InterpolateFieldToNodal(box, nodal_ezeli, nodal_Ez, ezfab);
+                InterpolateFieldToNodal(box, nodal_bxeli, nodal_Bx, bxfab);
+                InterpolateFieldToNodal(box, nodal_byeli, nodal_By, byfab);
+                InterpolateFieldToNodal(box, nodal_bzeli, nodal_Bz, bzfab);
+            }
 
             const auto getPosition = GetParticlePosition(pti);
 
@@ -344,19 +410,19 @@ RigidInjectedParticleContainer::PushP (int lev, Real dt,
             amrex::GpuArray<amrex::Real, 3> dx_arr = {dx[0], dx[1], dx[2]};
             amrex::GpuArray<amrex::Real, 3> xyzmin_arr = {xyzmin[0], xyzmin[1], xyzmin[2]};
 
-            amrex::Array4<const amrex::Real> const& ex_arr = exfab.array();
-            amrex::Array4<const amrex::Real> const& ey_arr = eyfab.array();
-            amrex::Array4<const amrex::Real> const& ez_arr = ezfab.array();
-            amrex::Array4<const amrex::Real> const& bx_arr = bxfab.array();
-            amrex::Array4<const amrex::Real> const& by_arr = byfab.array();
-            amrex::Array4<const amrex::Real> const& bz_arr = bzfab.array();
-
-            amrex::IndexType const ex_type = exfab.box().ixType();
-            amrex::IndexType const ey_type = eyfab.box().ixType();
-            amrex::IndexType const ez_type = ezfab.box().ixType();
-            amrex::IndexType const bx_type = bxfab.box().ixType();
-            amrex::IndexType const by_type = byfab.box().ixType();
-            amrex::IndexType const bz_type = bzfab.box().ixType();
+            amrex::Array4<const amrex::Real> const& ex_arr = exfab->array();
+            amrex::Array4<const amrex::Real> const& ey_arr = eyfab->array();
+            amrex::Array4<const amrex::Real> const& ez_arr = ezfab->array();
+            amrex::Array4<const amrex::Real> const& bx_arr = bxfab->array();
+            amrex::Array4<const amrex::Real> const& by_arr = byfab->array();
+            amrex::Array4<const amrex::Real> const& bz_arr = bzfab->array();
+
+            amrex::IndexType const ex_type = exfab->box().ixType();
+            amrex::IndexType const ey_type = eyfab->box().ixType();
+            amrex::IndexType const ez_type = ezfab->box().ixType();
+            amrex::IndexType const bx_type = bxfab->box().ixType();
+            amrex::IndexType const by_type = byfab->box().ixType();
+            amrex::IndexType const bz_type = bzfab->box().ixType();
 
             auto& attribs = pti.GetAttribs();
             amrex::ParticleReal* const AMREX_RESTRICT uxpp = attribs[PIdx::ux].dataPtr();
@@ -0,0 +1,229 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "Particles/WarpXParticleContainer.H"
+#include "Utils/WarpXProfilerWrapper.H"
+#include "WarpX.H"
+
+#include <AMReX_Box.H>
+#include <AMReX_DenseBins.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_GpuContainers.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_GpuQualifiers.H>
+#include <AMReX_IntVect.H>
+#include <AMReX_ParticleUtil.H>
+#include <AMReX_REAL.H>
+#include <AMReX_Scan.H>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+using namespace amrex;
+
+namespace
+{
+    using ParticleType = WarpXParticleContainer::ParticleType;
+    using index_type = DenseBins<ParticleType>::index_type;
+
+    /** \brief Number of elements of the sorted array `a` (of size n) that are strictly lower than `v` */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    int countLower (const unsigned int* a, const int n, const unsigned int v) noexcept
+    {
+        int lo = 0, hi = n;
+        while (lo < hi) {
+            const int mid = lo + (hi-lo)/2;
+            if (a[mid] < v) lo = mid+1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    /** \brief Number of elements of the sorted array `a` (of size n) that are lower than or equal to `v` */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    int countLowerOrEqual (const unsigned int* a, const int n, const unsigned int v) noexcept
+    {
+        int lo = 0, hi = n;
+        while (lo < hi) {
+            const int mid = lo + (hi-lo)/2;
+            if (a[mid] <= v) lo = mid+1;
+            else hi = mid;
+        }
+        return lo;
+    }
+}
+
+void
+WarpXParticleContainer::IncrementalSortParticlesByBin (amrex::IntVect bin_size)
+{
+    WARPX_PROFILE("WarpXParticleContainer::IncrementalSortParticlesByBin()");
+
+    // Maximum number of passes that remove the out-of-order particles
+    constexpr int max_passes = 4;
+
+    for (int lev = 0; lev <= finestLevel(); ++lev)
+    {
+        const Geometry& geom = Geom(lev);
+        const auto dxi = geom.InvCellSizeArray();
+        const auto plo = geom.ProbLoArray();
+        const Box domain = geom.Domain();
+
+        for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+        {
+            const int np = pti.numParticles();
+            if (np == 0) continue;
+
+            const Box& box = pti.validbox();
+            const int nbins = numTilesInBox(box, true, bin_size);
+            const ParticleType* AMREX_RESTRICT pstruct = pti.GetArrayOfStructs()().dataPtr();
+
+            // Same bin index as in amrex::ParticleContainer::SortParticlesByBin
+            const auto get_bin = [=] AMREX_GPU_HOST_DEVICE (const ParticleType& p) noexcept
+                -> unsigned int
+            {
+                Box tbx;
+                const IntVect iv = getParticleCell(p, plo, dxi, domain);
+                return static_cast<unsigned int>(getTileIndex(iv, box, true, bin_size, tbx));
+            };
+
+            Gpu::DeviceVector<unsigned int> bins(np);
+            unsigned int* const AMREX_RESTRICT p_bins = bins.dataPtr();
+            // Indices of the particles that are in order (initially: all particles)
+            Gpu::DeviceVector<int> stayers(np);
+            int* p_stayers = stayers.dataPtr();
+            amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (int ip) noexcept
+            {
+                p_bins[ip] = get_bin(pstruct[ip]);
+                p_stayers[ip] = ip;
+            });
+
+            // Remove both particles of each pair of neighbors that are out of order,
+            // until the remaining particles are sorted
+            const int max_movers = static_cast<int>(WarpX::incremental_sort_max_fraction*np);
+            int nstayers = np;
+            bool stayers_sorted = false;
+            Gpu::DeviceVector<int> keep;
+            Gpu::DeviceVector<int> keep_index;
+            for (int ipass = 0; ipass <= max_passes && np-nstayers <= max_movers; ++ipass)
+            {
+                keep.resize(nstayers);
+                keep_index.resize(nstayers);
+                int* const p_keep = keep.dataPtr();
+                const int ns = nstayers;
+                amrex::ParallelFor(ns, [=] AMREX_GPU_DEVICE (int j) noexcept
+                {
+                    const unsigned int b = p_bins[p_stayers[j]];
+                    const bool out_of_order = ((j > 0) && (p_bins[p_stayers[j-1]] > b)) ||
+                                              ((j < ns-1) && (b > p_bins[p_stayers[j+1]]));
+                    p_keep[j] = !out_of_order;
+                });
+                int* const p_keep_index = keep_index.dataPtr();
+                const int nkeep = Scan::ExclusiveSum(ns, p_keep, p_keep_index, Scan::retSum);
+                if (nkeep == ns) {
+                    stayers_sorted = true;
+                    break;
+                }
+
+                Gpu::DeviceVector<int> new_stayers(nkeep);
+                int* const p_new_stayers = new_stayers.dataPtr();
+                amrex::ParallelFor(ns, [=] AMREX_GPU_DEVICE (int j) noexcept
+                {
+                    if (p_keep[j]) p_new_stayers[p_keep_index[j]] = p_stayers[j];
+                });
+                Gpu::streamSynchronize();
+                stayers.swap(new_stayers);
+                p_stayers = stayers.dataPtr();
+                nstayers = nkeep;
+            }
+
+            // The particles of this tile are still sorted: nothing to do
+            if (stayers_sorted && nstayers == np) continue;
+
+            const int nmovers = np - nstayers;
+            if (!stayers_sorted || nmovers > max_movers) {
+                // Too many particles are out of order: sort all the particles of this tile
+                DenseBins<ParticleType> tile_bins;
+                tile_bins.build(np, pstruct, nbins, get_bin);
+                ReorderParticles(lev, pti, tile_bins.permutationPtr());
+                continue;
+            }
+
+            // Indices of the out-of-order particles (movers)
+            Gpu::DeviceVector<int> is_mover(np, 1);
+            Gpu::DeviceVector<int> mover_index(np);
+            int* const p_is_mover = is_mover.dataPtr();
+            int* const p_mover_index = mover_index.dataPtr();
+            amrex::ParallelFor(nstayers, [=] AMREX_GPU_DEVICE (int j) noexcept
+            {
+                p_is_mover[p_stayers[j]] = 0;
+            });
+            Scan::ExclusiveSum(np, p_is_mover, p_mover_index, Scan::noRetSum);
+            Gpu::DeviceVector<int> movers(nmovers);
+            int* const p_movers = movers.dataPtr();
+            amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (int ip) noexcept
+            {
+                if (p_is_mover[ip]) p_movers[p_mover_index[ip]] = ip;
+            });
+
+            Gpu::DeviceVector<unsigned int> mover_bins(nmovers);
+            unsigned int* const AMREX_RESTRICT p_mover_bins = mover_bins.dataPtr();
+            amrex::ParallelFor(nmovers, [=] AMREX_GPU_DEVICE (int k) noexcept
+            {
+                p_mover_bins[k] = p_bins[p_movers[k]];
+            });
+
+            // Sort the movers by bin; there are few of them, so this is done on the host
+            std::vector<int> h_movers(nmovers);
+            std::vector<unsigned int> h_mover_bins(nmovers);
+            Gpu::copyAsync(Gpu::deviceToHost, movers.begin(), movers.end(), h_movers.begin());
+            Gpu::copyAsync(Gpu::deviceToHost, mover_bins.begin(), mover_bins.end(),
+                           h_mover_bins.begin());
+            Gpu::streamSynchronize();
+            std::vector<int> order(nmovers);
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(),
+                [&h_mover_bins](int a, int b) { return h_mover_bins[a] < h_mover_bins[b]; });
+            std::vector<int> h_sorted_movers(nmovers);
+            std::vector<unsigned int> h_sorted_mover_bins(nmovers);
+            for (int k = 0; k < nmovers; ++k) {
+                h_sorted_movers[k] = h_movers[order[k]];
+                h_sorted_mover_bins[k] = h_mover_bins[order[k]];
+            }
+            Gpu::copyAsync(Gpu::hostToDevice, h_sorted_movers.begin(), h_sorted_movers.end(),
+                           movers.begin());
+            Gpu::copyAsync(Gpu::hostToDevice, h_sorted_mover_bins.begin(), h_sorted_mover_bins.end(),
+                           mover_bins.begin());
+
+            // Bins of the (sorted) stayers
+            Gpu::DeviceVector<unsigned int> stayer_bins(nstayers);
+            unsigned int* const AMREX_RESTRICT p_stayer_bins = stayer_bins.dataPtr();
+            amrex::ParallelFor(nstayers, [=] AMREX_GPU_DEVICE (int j) noexcept
+            {
+                p_stayer_bins[j] = p_bins[p_stayers[j]];
+            });
+
+            // Merge the two sorted sequences (in the same bin, the stayers come first)
+            Gpu::DeviceVector<index_type> permutation(np);
+            index_type* const AMREX_RESTRICT p_perm = permutation.dataPtr();
+            const int ns = nstayers;
+            amrex::ParallelFor(ns, [=] AMREX_GPU_DEVICE (int j) noexcept
+            {
+                const int pos = j + countLower(p_mover_bins, nmovers, p_stayer_bins[j]);
+                p_perm[pos] = static_cast<index_type>(p_stayers[j]);
+            });
+            amrex::ParallelFor(nmovers, [=] AMREX_GPU_DEVICE (int k) noexcept
+            {
+                const int pos = k + countLowerOrEqual(p_stayer_bins, ns, p_mover_bins[k]);
+                p_perm[pos] = static_cast<index_type>(p_movers[k]);
+            });
+
+            ReorderParticles(lev, pti, p_perm);
+            Gpu::streamSynchronize();
+        }
+    }
+}
@@ -11,15 +11,20 @@
 #include "WarpX.H"
 
 #include <AMReX_ArrayOfStructs.H>
+#include <AMReX_Box.H>
+#include <AMReX_DenseBins.H>
+#include <AMReX_Geometry.H>
 #include <AMReX_GpuContainers.H>
 #include <AMReX_GpuDevice.H>
 #include <AMReX_GpuLaunch.H>
+#include <AMReX_ParticleUtil.H>
 #include <AMReX_Particles.H>
 #include <AMReX_REAL.H>
 #include <AMReX_StructOfArrays.H>
 
 #include <AMReX_BaseFwd.H>
 
+#include <iterator>
 #include <utility>
 
 using namespace amrex;
@@ -55,12 +60,21 @@ void
 PhysicalParticleContainer::PartitionParticlesInBuffers(
     long& nfine_current, long& nfine_gather, long const np,
     WarpXParIter& pti, int const lev,
-    iMultiFab const* current_masks,
-    iMultiFab const* gather_masks,
+    BufferMasks const* current_masks,
+    BufferMasks const* gather_masks,
     RealVector& uxp, RealVector& uyp, RealVector& uzp, RealVector& wp)
 {
     WARPX_PROFILE("PhysicalParticleContainer::PartitionParticlesInBuffers");
 
+    // Most boxes have no buffer cell: all the particles deposit/gather in the fine patch
+    const bool has_buffer_cells = (current_masks && current_masks->hasBuffer(pti)) ||
+                                  (gather_masks && gather_masks->hasBuffer(pti));
+    if (!has_buffer_cells) {
+        nfine_current = (m_deposit_on_main_grid && lev > 0) ? 0 : np;
+        nfine_gather = (m_gather_from_main_grid && lev > 0) ? 0 : np;
+        return;
+    }
+
     // Initialize temporary arrays
     Gpu::DeviceVector<int> inexflag;
     inexflag.resize(np);
@@ -70,7 +84,7 @@ PhysicalParticleContainer::PartitionParticlesInBuffers(
     // First, partition particles into the larger buffer
 
     // - Select the larger buffer
-    iMultiFab const* bmasks =
+    BufferMasks const* bmasks =
         (WarpX::n_field_gather_buffer >= WarpX::n_current_deposition_buffer) ?
         gather_masks : current_masks;
     // - For each particle, find whether it is in the larger buffer,
@@ -79,7 +93,18 @@ PhysicalParticleContainer::PartitionParticlesInBuffers(
     // - Find the indices that reorder particles so that the last particles
     //   are in the larger buffer
     fillWithConsecutiveIntegers( pid );
-    auto const sep = stablePartition( pid.begin(), pid.end(), inexflag );
+    //   In most steps, few particles cross the border of the buffers, and the
+    //   particles are still ordered as in the previous step: in this case,
+    //   skip the partition (and the reordering of the particle arrays below)
+    bool reorder_particles = false;
+    auto sep = pid.begin();
+    int const n_fine_partitioned = partitionedCount( pid, 0, np, inexflag );
+    if (n_fine_partitioned >= 0) {
+        std::advance(sep, n_fine_partitioned);
+    } else {
+        sep = stablePartition( pid.begin(), pid.end(), inexflag );
+        reorder_particles = true;
+    }
     // At the end of this step, `pid` contains the indices that should be used to
     // reorder the particles, and `sep` is the position in the array that
     // separates the particles that deposit/gather on the fine patch (first part)
@@ -113,7 +138,14 @@ PhysicalParticleContainer::PartitionParticlesInBuffers(
             // the smaller buffer, by looking up the mask. Store the answer in `inexflag`.
             amrex::ParallelFor( np - n_fine,
                fillBufferFlagRemainingParticles(pti, bmasks, inexflag, Geom(lev), pid, n_fine) );
-            auto const sep2 = stablePartition( sep, pid.end(), inexflag );
+            auto sep2 = sep;
+            int const n_partitioned = partitionedCount( pid, n_fine, np - n_fine, inexflag );
+            if (n_partitioned >= 0) {
+                std::advance(sep2, n_partitioned);
+            } else {
+                sep2 = stablePartition( sep, pid.end(), inexflag );
+                reorder_particles = true;
+            }
 
             if (bmasks == gather_masks) {
                 nfine_gather = iteratorDistance(pid.begin(), sep2);
@@ -132,7 +164,8 @@ PhysicalParticleContainer::PartitionParticlesInBuffers(
     }
 
     // Reorder the actual particle array, using the `pid` indices
-    if (nfine_current != np || nfine_gather != np)
+    // (unless the particles were already partitioned)
+    if (reorder_particles && (nfine_current != np || nfine_gather != np))
     {
         // Temporary array for particle AoS
         ParticleVector particle_tmp;
@@ -166,3 +199,55 @@ PhysicalParticleContainer::PartitionParticlesInBuffers(
     // the GPU kernels finish running
     Gpu::streamSynchronize();
 }
+
+long
+PhysicalParticleContainer::PartitionInteriorParticles (WarpXParIter& pti, int const lev,
+                                                       amrex::IntVect const& ng_gather)
+{
+    WARPX_PROFILE("PhysicalParticleContainer::PartitionInteriorParticles");
+
+    const long np = pti.numParticles();
+    if (np == 0) return 0;
+
+    // For each particle, find whether its field gather only involves the valid
+    // cells of the box, i.e. whether it is at least ng_gather cells away from
+    // the boundaries of the box. Store the answer in `inexflag`.
+    Gpu::DeviceVector<int> inexflag(np);
+    int* const AMREX_RESTRICT p_flag = inexflag.dataPtr();
+    ParticleType const* AMREX_RESTRICT pstruct = pti.GetArrayOfStructs()().dataPtr();
+    const Geometry& geom = Geom(lev);
+    const auto plo = geom.ProbLoArray();
+    const auto dxi = geom.InvCellSizeArray();
+    const Box domain = geom.Domain();
+    const Box interior = amrex::grow(pti.validbox(), -ng_gather);
+    amrex::ParallelFor( np, [=] AMREX_GPU_DEVICE (long ip) noexcept
+    {
+        const IntVect iv = getParticleCell(pstruct[ip], plo, dxi, domain);
+        p_flag[ip] = interior.contains(iv) ? 1 : 0;
+    });
+
+    // Find the indices that reorder particles so that the interior particles come
+    // first, unless the particles are already ordered (as in most steps)
+    Gpu::DeviceVector<long> pid(np);
+    fillWithConsecutiveIntegers( pid );
+    int const n_partitioned = partitionedCount( pid, 0, np, inexflag );
+    if (n_partitioned >= 0) return n_partitioned;
+    auto const sep = stablePartition( pid.begin(), pid.end(), inexflag );
+    long const n_interior = iteratorDistance(pid.begin(), sep);
+
+    // Reorder the particle data (AoS and all the attributes)
+    using index_type = DenseBins<ParticleType>::index_type;
+    Gpu::DeviceVector<index_type> permutation(np);
+    index_type* const AMREX_RESTRICT p_perm = permutation.dataPtr();
+    long const* const AMREX_RESTRICT p_pid = pid.dataPtr();
+    amrex::ParallelFor( np, [=] AMREX_GPU_DEVICE (long ip) noexcept
+    {
+        p_perm[ip] = static_cast<index_type>(p_pid[ip]);
+    });
+    ReorderParticles(lev, pti, p_perm);
+
+    // Make sure that the temporary arrays are not destroyed before
+    // the GPU kernels finish running
+    Gpu::streamSynchronize();
+    return n_interior;
+}
@@ -11,6 +11,7 @@
 
 #include "Deposition/ChargeDeposition.H"
 #include "Deposition/CurrentDeposition.H"
+#include "ParticleCreation/ParticleIDs.H"
 #include "Pusher/GetAndSetPosition.H"
 #include "Pusher/UpdatePosition.H"
 #include "Parallelization/WarpXCommUtil.H"
@@ -18,6 +19,7 @@
 #include "Utils/CoarsenMR.H"
 #include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXConst.H"
+#include "Utils/WarpXPhaseTimers.H"
 #include "Utils/WarpXProfilerWrapper.H"
 #include "WarpX.H"
 
@@ -63,6 +65,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
+#include <vector>
 
 using namespace amrex;
 
@@ -189,12 +193,15 @@ WarpXParticleContainer::AddNParticles (int /*lev*/,
     Vector<ParticleReal> theta(np);
 #endif
 
+    // The ids of the new particles are allocated in bulk
+    const Long id0 = (id==-1) ? ParticleIDs::ReserveIDs<ParticleType>(np) : 0;
+
     for (int i = ibegin; i < iend; ++i)
     {
         ParticleType p;
         if (id==-1)
         {
-            p.id() = ParticleType::NextID();
+            p.id() = id0 + (i-ibegin);
         } else {
             p.id() = id;
         }
@@ -272,6 +279,84 @@ WarpXParticleContainer::AddNParticles (int /*lev*/,
     Redistribute();
 }
 
+void
+WarpXParticleContainer::AddNParticlesFromDevice (int /*lev*/, int n,
+                                                 const ParticleReal* x, const ParticleReal* y,
+                                                 const ParticleReal* z, const ParticleReal* ux,
+                                                 const ParticleReal* uy, const ParticleReal* uz,
+                                                 const ParticleReal* w,
+                                                 int nattr, const ParticleReal* const* attr)
+{
+    WARPX_PROFILE("WarpXParticleContainer::AddNParticlesFromDevice");
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(nattr <= NumRealComps() - PIdx::nattribs,
+        "AddNParticlesFromDevice: too many runtime attributes");
+
+    if (n > 0)
+    {
+        //  Add to grid 0 and tile 0
+        // Redistribute() will move them to proper places.
+        auto& particle_tile = DefineAndReturnParticleTile(0, 0, 0);
+        const auto old_np = particle_tile.numParticles();
+        particle_tile.resize(old_np + n);
+
+        // The ids of the new particles are allocated in bulk
+        const Long id0 = ParticleIDs::ReserveIDs<ParticleType>(n);
+        const int cpu = ParallelDescriptor::MyProc();
+
+        auto& soa = particle_tile.GetStructOfArrays();
+        ParticleType* pstruct = particle_tile.GetArrayOfStructs()().data() + old_np;
+#ifdef WARPX_DIM_RZ
+        ParticleReal* theta = soa.GetRealData(PIdx::theta).data() + old_np;
+#endif
+        amrex::ParallelFor(n, [=] AMREX_GPU_DEVICE (int i) noexcept
+        {
+            ParticleType& p = pstruct[i];
+            p.id() = id0 + i;
+            p.cpu() = cpu;
+#if (AMREX_SPACEDIM == 3)
+            p.pos(0) = x[i];
+            p.pos(1) = y[i];
+            p.pos(2) = z[i];
+#elif defined(WARPX_DIM_RZ)
+            theta[i] = std::atan2(y[i], x[i]);
+            p.pos(0) = std::sqrt(x[i]*x[i] + y[i]*y[i]);
+            p.pos(1) = z[i];
+#else
+            amrex::ignore_unused(y);
+            p.pos(0) = x[i];
+            p.pos(1) = z[i];
+#endif
+        });
+
+        Gpu::copyAsync(Gpu::deviceToDevice, w, w + n, soa.GetRealData(PIdx::w).data() + old_np);
+        Gpu::copyAsync(Gpu::deviceToDevice, ux, ux + n, soa.GetRealData(PIdx::ux).data() + old_np);
+        Gpu::copyAsync(Gpu::deviceToDevice, uy, uy + n, soa.GetRealData(PIdx::uy).data() + old_np);
+        Gpu::copyAsync(Gpu::deviceToDevice, uz, uz + n, soa.GetRealData(PIdx::uz).data() + old_np);
+        for (int comp = PIdx::uz+1; comp < NumRealComps(); ++comp)
+        {
+#ifdef WARPX_DIM_RZ
+            if (comp == PIdx::theta) continue;
+#endif
+            ParticleReal* dst_ptr = soa.GetRealData(comp).data() + old_np;
+            const int iattr = comp - PIdx::nattribs;
+            if (iattr >= 0 && iattr < nattr && attr[iattr] != nullptr) {
+                Gpu::copyAsync(Gpu::deviceToDevice, attr[iattr], attr[iattr] + n, dst_ptr);
+            } else {
+                amrex::ParallelFor(n, [=] AMREX_GPU_DEVICE (int i) noexcept { dst_ptr[i] = 0.0_prt; });
+            }
+        }
+        for (int comp = 0; comp < NumIntComps(); ++comp)
+        {
+            int* dst_ptr = soa.GetIntData(comp).data() + old_np;
+            amrex::ParallelFor(n, [=] AMREX_GPU_DEVICE (int i) noexcept { dst_ptr[i] = 0; });
+        }
+        Gpu::synchronize();
+    }
+
+    Redistribute();
+}
+
 /* \brief Current Deposition for thread thread_num
  * \param pti         : Particle iterator
  * \param wp          : Array of particle weights
@@ -304,6 +389,7 @@ WarpXParticleContainer::DepositCurrent (WarpXParIter& pti,
                                         int const thread_num, const int lev, int const depos_lev,
                                         amrex::Real const dt, amrex::Real const relative_time)
 {
+    WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::Deposit);
     AMREX_ALWAYS_ASSERT_WITH_MESSAGE((depos_lev==(lev-1)) ||
                                      (depos_lev==(lev  )),
                                      "Deposition buffers only work for lev-1");
@@ -420,7 +506,8 @@ WarpXParticleContainer::DepositCurrent (WarpXParIter& pti,
         m_v_galilean[2]*time_shift };
     const std::array<Real, 3>& xyzmin = WarpX::LowerCorner(tilebox, galilean_shift, depos_lev);
 
-    if (WarpX::current_deposition_algo == CurrentDepositionAlgo::Esirkepov) {
+    if (WarpX::current_deposition_algo == CurrentDepositionAlgo::Esirkepov ||
+        WarpX::current_deposition_algo == CurrentDepositionAlgo::EsirkepovShared) {
         if (WarpX::do_nodal==1) {
           amrex::Abort("The Esirkepov algorithm cannot be used with a nodal grid.");
         }
@@ -464,6 +551,29 @@ WarpXParticleContainer::DepositCurrent (WarpXParIter& pti,
                 WarpX::n_rz_azimuthal_modes, cost,
                 WarpX::load_balance_costs_update_algo);
         }
+    } else if (WarpX::current_deposition_algo == CurrentDepositionAlgo::EsirkepovShared) {
+        if        (WarpX::nox == 1){
+            doEsirkepovDepositionSharedShapeN<1>(
+                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                jx_arr, jy_arr, jz_arr, np_to_depose, dt, dx, xyzmin, tilebox, q,
+                WarpX::n_rz_azimuthal_modes, WarpX::shared_tilesize, cost,
+                WarpX::load_balance_costs_update_algo);
+        } else if (WarpX::nox == 2){
+            doEsirkepovDepositionSharedShapeN<2>(
+                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                jx_arr, jy_arr, jz_arr, np_to_depose, dt, dx, xyzmin, tilebox, q,
+                WarpX::n_rz_azimuthal_modes, WarpX::shared_tilesize, cost,
+                WarpX::load_balance_costs_update_algo);
+        } else if (WarpX::nox == 3){
+            doEsirkepovDepositionSharedShapeN<3>(
+                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                jx_arr, jy_arr, jz_arr, np_to_depose, dt, dx, xyzmin, tilebox, q,
+                WarpX::n_rz_azimuthal_modes, WarpX::shared_tilesize, cost,
+                WarpX::load_balance_costs_update_algo);
+        }
     } else if (WarpX::current_deposition_algo == CurrentDepositionAlgo::Vay) {
         if        (WarpX::nox == 1){
             doVayDepositionShapeN<1>(
@@ -487,6 +597,29 @@ WarpXParticleContainer::DepositCurrent (WarpXParIter& pti,
                 WarpX::n_rz_azimuthal_modes, cost,
                 WarpX::load_balance_costs_update_algo);
         }
+    } else if (WarpX::do_sorted_deposition && m_sorted_by_bin) {
+        if        (WarpX::nox == 1){
+            doDepositionSortedShapeN<1>(
+                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                jx_fab, jy_fab, jz_fab, np_to_depose, dt*relative_time, dx,
+                xyzmin, lo, q, WarpX::n_rz_azimuthal_modes, WarpX::sort_bin_size,
+                cost, WarpX::load_balance_costs_update_algo);
+        } else if (WarpX::nox == 2){
+            doDepositionSortedShapeN<2>(
+                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                jx_fab, jy_fab, jz_fab, np_to_depose, dt*relative_time, dx,
+                xyzmin, lo, q, WarpX::n_rz_azimuthal_modes, WarpX::sort_bin_size,
+                cost, WarpX::load_balance_costs_update_algo);
+        } else if (WarpX::nox == 3){
+            doDepositionSortedShapeN<3>(
+                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                jx_fab, jy_fab, jz_fab, np_to_depose, dt*relative_time, dx,
+                xyzmin, lo, q, WarpX::n_rz_azimuthal_modes, WarpX::sort_bin_size,
+                cost, WarpX::load_balance_costs_update_algo);
+        }
     } else {
         if        (WarpX::nox == 1){
             doDepositionShapeN<1>(
@@ -564,6 +697,70 @@ WarpXParticleContainer::DepositCurrent (
     }
 }
 
+void
+WarpXParticleContainer::GetCurrentDepositionSpecies (
+    const int lev, const amrex::Real dt, const amrex::MultiFab& jx,
+    std::map<std::pair<int,int>, amrex::Vector<CurrentDepositionSpecies> >& tile_species)
+{
+    // If user decides not to deposit
+    if (do_not_deposit) return;
+
+    WarpX& warpx = WarpX::GetInstance();
+    const amrex::IntVect& ng_J = warpx.get_ng_depos_J();
+
+#if   (AMREX_SPACEDIM == 2)
+    const amrex::IntVect shape_extent = amrex::IntVect(static_cast<int>(WarpX::nox/2),
+                                                       static_cast<int>(WarpX::noz/2));
+#elif (AMREX_SPACEDIM == 3)
+    const amrex::IntVect shape_extent = amrex::IntVect(static_cast<int>(WarpX::nox/2),
+                                                       static_cast<int>(WarpX::noy/2),
+                                                       static_cast<int>(WarpX::noz/2));
+#endif
+    // The batched deposition writes directly in the J arrays (as on GPU)
+    const amrex::IntVect range = jx.nGrowVect() - shape_extent;
+
+    // Take into account Galilean shift
+    Real cur_time = warpx.gett_new(lev);
+    const auto& time_of_last_gal_shift = warpx.time_of_last_gal_shift;
+    Real time_shift = (cur_time + 0.5*dt - time_of_last_gal_shift);
+    amrex::Array<amrex::Real,3> galilean_shift = {
+        m_v_galilean[0]* time_shift,
+        m_v_galilean[1]*time_shift,
+        m_v_galilean[2]*time_shift };
+
+    int* AMREX_RESTRICT ion_lev = nullptr;
+    for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+    {
+        const long np = pti.numParticles();
+        if (np == 0) continue;
+
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+            amrex::numParticlesOutOfRange(pti, range) == 0,
+            "Particles shape does not fit within guard cells used for current deposition");
+
+        if (do_field_ionization)
+        {
+            ion_lev = pti.GetiAttribs(particle_icomps["ionization_level"]).dataPtr();
+        }
+
+        Box tilebox = pti.tilebox();
+        tilebox.grow(ng_J);
+        const std::array<Real, 3>& xyzmin = WarpX::LowerCorner(tilebox, galilean_shift, lev);
+
+        CurrentDepositionSpecies species;
+        species.get_position = GetParticlePosition(pti);
+        species.wp = pti.GetAttribs(PIdx::w).dataPtr();
+        species.uxp = pti.GetAttribs(PIdx::ux).dataPtr();
+        species.uyp = pti.GetAttribs(PIdx::uy).dataPtr();
+        species.uzp = pti.GetAttribs(PIdx::uz).dataPtr();
+        species.ion_lev = ion_lev;
+        species.q = this->charge;
+        species.xyzmin = {xyzmin[0], xyzmin[1], xyzmin[2]};
+        species.np = np;
+        tile_species[std::make_pair(pti.index(), pti.LocalTileIndex())].push_back(species);
+    }
+}
+
 /* \brief Charge Deposition for thread thread_num
  * \param pti         : Particle iterator
  * \param wp          : Array of particle weights
@@ -589,6 +786,7 @@ WarpXParticleContainer::DepositCharge (WarpXParIter& pti, RealVector& wp,
                                        const long offset, const long np_to_depose,
                                        int thread_num, int lev, int depos_lev)
 {
+    WarpXPhaseTimers::PhaseScope phase_scope(WarpXPhaseTimers::Phase::Deposit);
     AMREX_ALWAYS_ASSERT_WITH_MESSAGE((depos_lev==(lev-1)) ||
                                      (depos_lev==(lev  )),
                                      "Deposition buffers only work for lev-1");
@@ -703,7 +901,24 @@ WarpXParticleContainer::DepositCharge (WarpXParIter& pti, RealVector& wp,
     amrex::LayoutData<amrex::Real>* costs = WarpX::getCosts(lev);
     amrex::Real* cost = costs ? &((*costs)[pti.index()]) : nullptr;
 
-    if        (WarpX::nox == 1){
+    if (WarpX::do_sorted_deposition && m_sorted_by_bin) {
+        if        (WarpX::nox == 1){
+            doChargeDepositionSortedShapeN<1>(GetPosition, wp.dataPtr()+offset, ion_lev,
+                                              rho_fab, np_to_depose, dx, xyzmin, lo, q,
+                                              WarpX::n_rz_azimuthal_modes, WarpX::sort_bin_size,
+                                              cost, WarpX::load_balance_costs_update_algo);
+        } else if (WarpX::nox == 2){
+            doChargeDepositionSortedShapeN<2>(GetPosition, wp.dataPtr()+offset, ion_lev,
+                                              rho_fab, np_to_depose, dx, xyzmin, lo, q,
+                                              WarpX::n_rz_azimuthal_modes, WarpX::sort_bin_size,
+                                              cost, WarpX::load_balance_costs_update_algo);
+        } else if (WarpX::nox == 3){
+            doChargeDepositionSortedShapeN<3>(GetPosition, wp.dataPtr()+offset, ion_lev,
+                                              rho_fab, np_to_depose, dx, xyzmin, lo, q,
+                                              WarpX::n_rz_azimuthal_modes, WarpX::sort_bin_size,
+                                              cost, WarpX::load_balance_costs_update_algo);
+        }
+    } else if (WarpX::nox == 1){
         doChargeDepositionShapeN<1>(GetPosition, wp.dataPtr()+offset, ion_lev,
                                     rho_fab, np_to_depose, dx, xyzmin, lo, q,
                                     WarpX::n_rz_azimuthal_modes, cost,
@@ -899,11 +1114,29 @@ Real WarpXParticleContainer::sumParticleCharge(bool local) {
 
 std::array<Real, 3> WarpXParticleContainer::meanParticleVelocity(bool local) {
 
+    amrex::Long np_total = 0;
+    std::array<Real, 3> v_total = sumParticleVelocity(np_total);
+
+    if (local == false) {
+        ParallelDescriptor::ReduceRealSum(v_total.data(), 3);
+        ParallelDescriptor::ReduceLongSum(np_total);
+    }
+
+    std::array<Real, 3> mean_v = {0._rt, 0._rt, 0._rt};
+    if (np_total > 0) {
+        for (int idim = 0; idim < 3; ++idim) mean_v[idim] = v_total[idim] / np_total;
+    }
+
+    return mean_v;
+}
+
+std::array<Real, 3> WarpXParticleContainer::sumParticleVelocity(amrex::Long& np_total) {
+
     amrex::Real vx_total = 0.0;
     amrex::Real vy_total = 0.0;
     amrex::Real vz_total = 0.0;
 
-    amrex::Long np_total = 0;
+    np_total = 0;
 
     amrex::Real inv_clight_sq = 1.0/PhysConst::c/PhysConst::c;
 
@@ -968,44 +1201,32 @@ std::array<Real, 3> WarpXParticleContainer::meanParticleVelocity(bool local) {
         }
     }
 
-    if (local == false) {
-        ParallelDescriptor::ReduceRealSum(vx_total);
-        ParallelDescriptor::ReduceRealSum(vy_total);
-        ParallelDescriptor::ReduceRealSum(vz_total);
-        ParallelDescriptor::ReduceLongSum(np_total);
-    }
-
-    std::array<Real, 3> mean_v;
-    if (np_total > 0) {
-        mean_v[0] = vx_total / np_total;
-        mean_v[1] = vy_total / np_total;
-        mean_v[2] = vz_total / np_total;
-    }
-
-    return mean_v;
+    return {vx_total, vy_total, vz_total};
 }
 
 Real WarpXParticleContainer::maxParticleVelocity(bool local) {
 
-    amrex::ParticleReal max_v = 0.0;
+    // The reduction runs on the device, where the particle data are
+    ReduceOps<ReduceOpMax> reduce_op;
+    ReduceData<amrex::ParticleReal> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
 
     const int nLevels = finestLevel();
     for (int lev = 0; lev <= nLevels; ++lev)
     {
-
-#ifdef AMREX_USE_OMP
-#pragma omp parallel reduction(max:max_v)
-#endif
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
         {
-            auto& ux = pti.GetAttribs(PIdx::ux);
-            auto& uy = pti.GetAttribs(PIdx::uy);
-            auto& uz = pti.GetAttribs(PIdx::uz);
-            for (unsigned long i = 0; i < ux.size(); i++) {
-                max_v = std::max(max_v, std::sqrt(ux[i]*ux[i] + uy[i]*uy[i] + uz[i]*uz[i]));
-            }
+            const auto uxp = pti.GetAttribs(PIdx::ux).data();
+            const auto uyp = pti.GetAttribs(PIdx::uy).data();
+            const auto uzp = pti.GetAttribs(PIdx::uz).data();
+            reduce_op.eval(pti.numParticles(), reduce_data,
+                [=] AMREX_GPU_DEVICE (int i) -> ReduceTuple
+                {
+                    return {uxp[i]*uxp[i] + uyp[i]*uyp[i] + uzp[i]*uzp[i]};
+                });
         }
     }
+    amrex::ParticleReal max_v = std::sqrt(amrex::max(amrex::get<0>(reduce_data.value()), 0._prt));
 
     if (local == false) ParallelAllReduce::Max(max_v, ParallelDescriptor::Communicator());
     return max_v;
@@ -1094,6 +1315,99 @@ void WarpXParticleContainer::defineAllParticleTiles () noexcept
     }
 }
 
+amrex::Long
+WarpXParticleContainer::BytesAllocated () const
+{
+    amrex::Long bytes = 0;
+    for (int lev = 0; lev < numLevels(); ++lev)
+    {
+        for (const auto& kv : GetParticles(lev))
+        {
+            const auto& ptile = kv.second;
+            bytes += ptile.GetArrayOfStructs()().capacity()*sizeof(ParticleType);
+            const auto& soa = ptile.GetStructOfArrays();
+            for (int i = 0; i < soa.NumRealComps(); ++i) {
+                bytes += soa.GetRealData(i).capacity()*sizeof(amrex::ParticleReal);
+            }
+            for (int i = 0; i < soa.NumIntComps(); ++i) {
+                bytes += soa.GetIntData(i).capacity()*sizeof(int);
+            }
+        }
+    }
+    for (const auto& tmp_lev : tmp_particle_data) {
+        for (const auto& kv : tmp_lev) {
+            for (const auto& v : kv.second) {
+                bytes += v.capacity()*sizeof(amrex::ParticleReal);
+            }
+        }
+    }
+    return bytes;
+}
+
+void
+WarpXParticleContainer::PrepareChiExtrema ()
+{
+    const int step = WarpX::GetInstance().getistep(0) + 1;
+    if (step != m_chi_extrema_step || step == m_chi_extrema_recorded_step) return;
+
+#ifdef AMREX_USE_OMP
+    const int nthreads = omp_get_max_threads();
+#else
+    const int nthreads = 1;
+#endif
+    std::vector<amrex::Real> init(2*nthreads);
+    for (int i = 0; i < nthreads; ++i) {
+        init[2*i] = std::numeric_limits<amrex::Real>::max();
+        init[2*i+1] = std::numeric_limits<amrex::Real>::lowest();
+    }
+    m_chi_extrema.resize(init.size());
+    amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, init.begin(), init.end(), m_chi_extrema.begin());
+    amrex::Gpu::streamSynchronize();
+    m_chi_extrema_recorded_step = step;
+}
+
+amrex::Real*
+WarpXParticleContainer::GetChiExtremaPtr ()
+{
+    if (m_chi_extrema_recorded_step != WarpX::GetInstance().getistep(0) + 1) return nullptr;
+#ifdef AMREX_USE_OMP
+    const int thread_num = omp_get_thread_num();
+#else
+    const int thread_num = 0;
+#endif
+    return m_chi_extrema.dataPtr() + 2*thread_num;
+}
+
+bool
+WarpXParticleContainer::GetChiExtrema (int step, amrex::Real& chimin, amrex::Real& chimax) const
+{
+    if (step != m_chi_extrema_recorded_step) return false;
+
+    std::vector<amrex::Real> extrema(m_chi_extrema.size());
+    amrex::Gpu::copyAsync(amrex::Gpu::deviceToHost,
+                          m_chi_extrema.begin(), m_chi_extrema.end(), extrema.begin());
+    amrex::Gpu::streamSynchronize();
+    chimin = std::numeric_limits<amrex::Real>::max();
+    chimax = std::numeric_limits<amrex::Real>::lowest();
+    for (std::size_t i = 0; i < extrema.size(); i += 2) {
+        chimin = std::min(chimin, extrema[i]);
+        chimax = std::max(chimax, extrema[i+1]);
+    }
+    return true;
+}
+
+void
+WarpXParticleContainer::SortParticlesByBin (amrex::IntVect bin_size)
+{
+    if (WarpX::do_incremental_sort && m_sorted_by_bin && bin_size == m_sort_bin_size) {
+        IncrementalSortParticlesByBin(bin_size);
+    } else {
+        amrex::ParticleContainer<0,0,PIdx::nattribs>::SortParticlesByBin(bin_size);
+    }
+    m_sorted_by_bin = true;
+    m_sort_bin_size = bin_size;
+}
+
 // This function is called in Redistribute, just after locate
 void
 WarpXParticleContainer::particlePostLocate(ParticleType& p,
@@ -1128,8 +1442,28 @@ WarpXParticleContainer::ApplyBoundaryConditions (){
 
     for (int lev = 0; lev <= finestLevel(); ++lev)
     {
+        // Since the last Redistribute, at the previous step, the particles moved with respect
+        // to the grid by at most c*dt, plus one cell for the shift of the moving window or of
+        // the Galilean grid: only the tiles that are within this distance of a non-periodic
+        // boundary of the domain can have particles out of the domain, the others are skipped
+        const Box& domain = Geom(lev).Domain();
+        IntVect max_cells_moved;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            max_cells_moved[idim] = 2 + static_cast<int>(
+                std::ceil(PhysConst::c*WarpX::GetInstance().getdt(lev)/Geom(lev).CellSize(idim)));
+        }
+
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
         {
+            const Box reach = amrex::grow(pti.tilebox(), max_cells_moved);
+            bool near_boundary = false;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                if (Geom(lev).isPeriodic(idim)) continue;
+                near_boundary = near_boundary || reach.smallEnd(idim) < domain.smallEnd(idim)
+                                              || reach.bigEnd(idim) > domain.bigEnd(idim);
+            }
+            if (!near_boundary) continue;
+
             auto GetPosition = GetParticlePosition(pti);
             auto SetPosition = SetParticlePosition(pti);
             const Real xmin = Geom(lev).ProbLo(0);
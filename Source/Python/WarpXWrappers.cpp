@@ -22,6 +22,7 @@
 #include <AMReX_FArrayBox.H>
 #include <AMReX_FabArray.H>
 #include <AMReX_Geometry.H>
+#include <AMReX_GpuContainers.H>
 #include <AMReX_GpuControl.H>
 #include <AMReX_IndexType.H>
 #include <AMReX_IntVect.H>
@@ -32,8 +33,10 @@
 #include <AMReX_Particles.H>
 #include <AMReX_StructOfArrays.H>
 
+#include <algorithm>
 #include <array>
 #include <cstdlib>
+#include <string>
 
 namespace
 {
@@ -98,6 +101,23 @@ namespace
         }
         return nodal_flag_data;
     }
+
+    /** Indices of the components comp_names of the species, and number of particles of each
+     *  tile of level lev (in the order of WarpXParIter) */
+    void getBulkParticleLayout (WarpXParticleContainer& pc, int lev, int ncomps,
+                                const char** comp_names, amrex::Vector<int>& comps,
+                                amrex::Vector<long>& tile_np)
+    {
+        auto particle_comps = pc.getParticleComps();
+        comps.resize(ncomps);
+        for (int c = 0; c < ncomps; ++c) {
+            comps[c] = particle_comps.at(std::string(comp_names[c]));
+        }
+        tile_np.clear();
+        for (WarpXParIter pti(pc, lev); pti.isValid(); ++pti) {
+            tile_np.push_back(pti.numParticles());
+        }
+    }
 }
 
 extern "C"
@@ -147,6 +167,15 @@ extern "C"
         return AMREX_SPACEDIM;
     }
 
+    int warpx_UseGpu()
+    {
+#ifdef AMREX_USE_GPU
+        return 1;
+#else
+        return 0;
+#endif
+    }
+
     void amrex_init (int argc, char* argv[])
     {
         warpx_amrex_init(argc, argv);
@@ -248,6 +277,20 @@ extern "C"
         myspc.AddNParticles(lev, lenx, x, y, z, vx, vy, vz, nattr, attr, uniqueparticles);
     }
 
+    void warpx_addNParticlesFromDevice(
+        const char* char_species_name, int n, amrex::ParticleReal const * x,
+        amrex::ParticleReal const * y, amrex::ParticleReal const * z,
+        amrex::ParticleReal const * ux, amrex::ParticleReal const * uy,
+        amrex::ParticleReal const * uz, amrex::ParticleReal const * w, int nattr,
+        amrex::ParticleReal const * const * attr)
+    {
+        auto & mypc = WarpX::GetInstance().GetPartContainer();
+        const std::string species_name(char_species_name);
+        auto & myspc = mypc.GetParticleContainerFromName(species_name);
+        const int lev = 0;
+        myspc.AddNParticlesFromDevice(lev, n, x, y, z, ux, uy, uz, w, nattr, attr);
+    }
+
     void warpx_ConvertLabParamsToBoost()
     {
       ConvertLabParamsToBoost();
@@ -519,6 +562,92 @@ extern "C"
         return data;
     }
 
+    long warpx_getParticleTileOffsets (
+            const char* char_species_name, int lev, int* num_tiles, long** tile_offsets ) {
+
+        const auto & mypc = WarpX::GetInstance().GetPartContainer();
+        auto & myspc = mypc.GetParticleContainerFromName(std::string(char_species_name));
+
+        amrex::Vector<int> comps;
+        amrex::Vector<long> tile_np;
+        getBulkParticleLayout(myspc, lev, 0, nullptr, comps, tile_np);
+
+        *num_tiles = static_cast<int>(tile_np.size());
+        *tile_offsets = (long*) malloc((*num_tiles+1)*sizeof(long));
+        (*tile_offsets)[0] = 0;
+        for (int i = 0; i < *num_tiles; ++i) {
+            (*tile_offsets)[i+1] = (*tile_offsets)[i] + tile_np[i];
+        }
+        return (*tile_offsets)[*num_tiles];
+    }
+
+    long warpx_gatherParticleArrays (
+            const char* char_species_name, int lev, int ncomps, const char** comp_names,
+            amrex::ParticleReal* buffer, long buffer_size, int on_device ) {
+
+        const auto & mypc = WarpX::GetInstance().GetPartContainer();
+        auto & myspc = mypc.GetParticleContainerFromName(std::string(char_species_name));
+
+        amrex::Vector<int> comps;
+        amrex::Vector<long> tile_np;
+        getBulkParticleLayout(myspc, lev, ncomps, comp_names, comps, tile_np);
+        long np = 0;
+        for (auto n : tile_np) np += n;
+        // Only the size is returned when the buffer is too small
+        if (buffer == nullptr || buffer_size < ncomps*np) return np;
+
+        long offset = 0;
+        for (WarpXParIter pti(myspc, lev); pti.isValid(); ++pti) {
+            auto& soa = pti.GetStructOfArrays();
+            for (int c = 0; c < ncomps; ++c) {
+                auto const& data = soa.GetRealData(comps[c]);
+                amrex::ParticleReal* dst = buffer + c*np + offset;
+                if (on_device) {
+                    amrex::Gpu::copyAsync(amrex::Gpu::deviceToDevice, data.begin(), data.end(), dst);
+                } else {
+                    amrex::Gpu::copyAsync(amrex::Gpu::deviceToHost, data.begin(), data.end(), dst);
+                }
+            }
+            offset += pti.numParticles();
+        }
+        amrex::Gpu::streamSynchronize();
+        return np;
+    }
+
+    long warpx_scatterParticleArrays (
+            const char* char_species_name, int lev, int ncomps, const char** comp_names,
+            const amrex::ParticleReal* buffer, long buffer_np, int on_device ) {
+
+        const auto & mypc = WarpX::GetInstance().GetPartContainer();
+        auto & myspc = mypc.GetParticleContainerFromName(std::string(char_species_name));
+
+        amrex::Vector<int> comps;
+        amrex::Vector<long> tile_np;
+        getBulkParticleLayout(myspc, lev, ncomps, comp_names, comps, tile_np);
+        long np = 0;
+        for (auto n : tile_np) np += n;
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(buffer_np == np,
+            "warpx_scatterParticleArrays: the number of particles changed since the gather");
+
+        long offset = 0;
+        for (WarpXParIter pti(myspc, lev); pti.isValid(); ++pti) {
+            auto& soa = pti.GetStructOfArrays();
+            const long n = pti.numParticles();
+            for (int c = 0; c < ncomps; ++c) {
+                auto& data = soa.GetRealData(comps[c]);
+                const amrex::ParticleReal* src = buffer + c*np + offset;
+                if (on_device) {
+                    amrex::Gpu::copyAsync(amrex::Gpu::deviceToDevice, src, src + n, data.begin());
+                } else {
+                    amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, src, src + n, data.begin());
+                }
+            }
+            offset += n;
+        }
+        amrex::Gpu::streamSynchronize();
+        return np;
+    }
+
     int warpx_getParticleCompIndex (
          const char* char_species_name, const char* char_comp_name )
     {
@@ -636,6 +765,20 @@ extern "C"
         particle_buffers.clearParticles();
     }
 
+    int warpx_getParticleBoundaryBufferHistogramBins () {
+        auto& particle_buffers = WarpX::GetInstance().GetParticleBoundaryBuffer();
+        return particle_buffers.numHistogramBins();
+    }
+
+    void warpx_getParticleBoundaryBufferHistogram (
+        const char* species_name, int boundary, int angle, amrex::Real* histogram)
+    {
+        const std::string name(species_name);
+        auto& particle_buffers = WarpX::GetInstance().GetParticleBoundaryBuffer();
+        const auto h = particle_buffers.getHistogram(name, boundary, angle);
+        std::copy(h.begin(), h.end(), histogram);
+    }
+
     void warpx_ComputeDt () {
         WarpX& warpx = WarpX::GetInstance();
         warpx.ComputeDt ();
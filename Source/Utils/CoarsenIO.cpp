@@ -4,6 +4,7 @@
 #include <AMReX_BLassert.H>
 #include <AMReX_Box.H>
 #include <AMReX_BoxArray.H>
+#include <AMReX_BoxList.H>
 #include <AMReX_Config.H>
 #include <AMReX_DistributionMapping.H>
 #include <AMReX_FArrayBox.H>
@@ -13,6 +14,9 @@
 #include <AMReX_IndexType.H>
 #include <AMReX_MFIter.H>
 #include <AMReX_MultiFab.H>
+#include <AMReX_Vector.H>
+
+#include <utility>
 
 using namespace amrex;
 
@@ -23,7 +27,9 @@ CoarsenIO::Loop ( MultiFab& mf_dst,
                   const int scomp,
                   const int ncomp,
                   const IntVect ngrowvect,
-                  const IntVect crse_ratio )
+                  const IntVect crse_ratio,
+                  const bool sum_modes,
+                  const Vector<int>& src_index )
 {
     // Staggering of source fine MultiFab and destination coarse MultiFab
     const IntVect stag_src = mf_src.boxArray().ixType().toIntVect();
@@ -35,6 +41,11 @@ CoarsenIO::Loop ( MultiFab& mf_dst,
     AMREX_ALWAYS_ASSERT_WITH_MESSAGE( mf_src.nGrowVect() >= stag_dst-stag_src+ngrowvect,
         "source fine MultiFab does not have enough guard cells for this interpolation" );
 
+    if ( sum_modes ) AMREX_ALWAYS_ASSERT_WITH_MESSAGE( ncomp == 1,
+        "the sum over the azimuthal modes must be written into one single component" );
+    // Last component of the source fine MultiFab summed over, if sum_modes
+    const int scomp_end = mf_src.nComp();
+
     // Auxiliary integer arrays (always 3D)
     GpuArray<int,3> sf; // staggering of source fine MultiFab
     GpuArray<int,3> sc; // staggering of destination coarse MultiFab
@@ -73,13 +84,27 @@ CoarsenIO::Loop ( MultiFab& mf_dst,
         // Tiles defined at the coarse level
         const Box& bx = mfi.growntilebox( ngrowvect );
         Array4<Real> const& arr_dst = mf_dst.array( mfi );
-        Array4<Real const> const& arr_src = mf_src.const_array( mfi );
-        ParallelFor( bx, ncomp,
-                     [=] AMREX_GPU_DEVICE( int i, int j, int k, int n )
-                     {
-                         arr_dst(i,j,k,n+dcomp) = CoarsenIO::Interp(
-                             arr_src, sf, sc, cr, i, j, k, n+scomp );
-                     } );
+        const int isrc = src_index.empty() ? mfi.index() : src_index[mfi.index()];
+        Array4<Real const> const& arr_src = mf_src.const_array( isrc );
+        if ( sum_modes ) {
+            // The interpolation is linear: interpolate each mode and sum the results
+            ParallelFor( bx,
+                         [=] AMREX_GPU_DEVICE( int i, int j, int k )
+                         {
+                             Real c = CoarsenIO::Interp( arr_src, sf, sc, cr, i, j, k, scomp );
+                             for ( int n = scomp+1; n < scomp_end; n += 2 ) {
+                                 c += CoarsenIO::Interp( arr_src, sf, sc, cr, i, j, k, n );
+                             }
+                             arr_dst(i,j,k,dcomp) = c;
+                         } );
+        } else {
+            ParallelFor( bx, ncomp,
+                         [=] AMREX_GPU_DEVICE( int i, int j, int k, int n )
+                         {
+                             arr_dst(i,j,k,n+dcomp) = CoarsenIO::Interp(
+                                 arr_src, sf, sc, cr, i, j, k, n+scomp );
+                         } );
+        }
     }
 }
 
@@ -109,7 +134,8 @@ CoarsenIO::Coarsen ( MultiFab& mf_dst,
                      const int scomp,
                      const int ncomp,
                      const IntVect ngrowvect,
-                     const IntVect crse_ratio )
+                     const IntVect crse_ratio,
+                     const bool sum_modes )
 {
     BL_PROFILE("CoarsenIO::Coarsen()");
 
@@ -120,15 +146,51 @@ CoarsenIO::Coarsen ( MultiFab& mf_dst,
     ba_tmp.coarsen( crse_ratio );
 
     if ( ba_tmp == mf_dst.boxArray() and mf_src.DistributionMap() == mf_dst.DistributionMap() )
-        CoarsenIO::Loop( mf_dst, mf_src, dcomp, scomp, ncomp, ngrowvect, crse_ratio );
+        CoarsenIO::Loop( mf_dst, mf_src, dcomp, scomp, ncomp, ngrowvect, crse_ratio, sum_modes );
     else
     {
         // Cannot coarsen into MultiFab with different BoxArray or DistributionMapping:
-        // 1) create temporary MultiFab on coarsened version of source BoxArray with same DistributionMapping
-        MultiFab mf_tmp( ba_tmp, mf_src.DistributionMap(), ncomp, 0, MFInfo(), FArrayBoxFactory() );
+        // 1) create temporary MultiFab on coarsened version of source BoxArray with same DistributionMapping,
+        //    restricted to the boxes (cropped) that intersect the extent of the destination MultiFab
+        const Box dst_box = mf_dst.boxArray().minimalBox();
+        const DistributionMapping& dm_src = mf_src.DistributionMap();
+        BoxList bl_tmp(ba_tmp.ixType());
+        Vector<int> pmap_tmp;
+        Vector<int> src_index;
+        bool cropped = false;
+        for (int i = 0; i < ba_tmp.size(); ++i) {
+            const Box b = ba_tmp[i] & dst_box;
+            if (b != ba_tmp[i]) cropped = true;
+            if (b.ok()) {
+                bl_tmp.push_back(b);
+                pmap_tmp.push_back(dm_src[i]);
+                src_index.push_back(i);
+            }
+        }
+        if (src_index.empty()) return;
+        if (cropped) {
+            MultiFab mf_tmp( BoxArray(std::move(bl_tmp)), DistributionMapping(std::move(pmap_tmp)),
+                             ncomp, 0, MFInfo(), FArrayBoxFactory() );
+            // 2) interpolate from mf_src to mf_tmp (start writing into component 0)
+            CoarsenIO::Loop( mf_tmp, mf_src, 0, scomp, ncomp, ngrowvect, crse_ratio, sum_modes, src_index );
+            // 3) copy from mf_tmp to mf_dst (with different BoxArray or DistributionMapping)
+            mf_dst.ParallelCopy( mf_tmp, 0, dcomp, ncomp );
+            return;
+        }
+        MultiFab mf_tmp( ba_tmp, dm_src, ncomp, 0, MFInfo(), FArrayBoxFactory() );
         // 2) interpolate from mf_src to mf_tmp (start writing into component 0)
-        CoarsenIO::Loop( mf_tmp, mf_src, 0, scomp, ncomp, ngrowvect, crse_ratio );
+        CoarsenIO::Loop( mf_tmp, mf_src, 0, scomp, ncomp, ngrowvect, crse_ratio, sum_modes );
         // 3) copy from mf_tmp to mf_dst (with different BoxArray or DistributionMapping)
         mf_dst.ParallelCopy( mf_tmp, 0, dcomp, ncomp );
     }
 }
+
+void
+CoarsenIO::CoarsenSumModes ( MultiFab& mf_dst,
+                             const MultiFab& mf_src,
+                             const int dcomp,
+                             const int ngrow,
+                             const IntVect crse_ratio )
+{
+    Coarsen( mf_dst, mf_src, dcomp, 0, 1, IntVect(ngrow), crse_ratio, true );
+}
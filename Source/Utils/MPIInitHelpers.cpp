@@ -16,9 +16,26 @@
 #   include <mpi.h>
 #endif
 
+#include <cstdlib>
+#include <iostream>
 #include <string>
 #include <utility>
 #include <sstream>
+#include <vector>
+
+namespace
+{
+    /** Abort before the initialization of AMReX */
+    [[noreturn]] void
+    ensemble_abort (int const rank, std::string const& msg)
+    {
+        if (rank == 0) std::cerr << "ERROR: " << msg << std::endl;
+#ifdef AMREX_USE_MPI
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+#endif
+        std::exit(EXIT_FAILURE);
+    }
+}
 
 namespace utils
 {
@@ -70,4 +87,53 @@ namespace utils
 #endif
     }
 
+    MPI_Comm
+    warpx_ensemble_split (int& argc, char**& argv)
+    {
+        if (argc < 2 || std::string(argv[1]) != "--ensemble") return MPI_COMM_WORLD;
+
+        int rank = 0;
+        int nranks = 1;
+#ifdef AMREX_USE_MPI
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+#endif
+
+        int nmembers = 0;
+        if (argc > 2) nmembers = std::atoi(argv[2]);
+        if (nmembers < 1 || argc < 3 + nmembers) {
+            ensemble_abort(rank, "usage: <executable> --ensemble <n> <input_file_0> ... "
+                                 "<input_file_n-1> [<parameters>]");
+        }
+        if (nranks < nmembers) {
+            ensemble_abort(rank, "an ensemble run needs at least one MPI rank per member");
+        }
+
+        // Contiguous groups of ranks, so that the members are spread over the nodes evenly
+        int const member = static_cast<int>((static_cast<long>(rank) * nmembers) / nranks);
+        MPI_Comm comm = MPI_COMM_WORLD;
+#ifdef AMREX_USE_MPI
+        MPI_Comm_split(MPI_COMM_WORLD, member, rank, &comm);
+#endif
+
+        // amrex::Initialize keeps pointers to the arguments: they must outlive it
+        static std::vector<std::string> member_args;
+        static std::vector<char*> member_argv;
+        member_args.clear();
+        member_args.emplace_back(argv[0]);
+        member_args.emplace_back(argv[3 + member]);
+        for (int i = 3 + nmembers; i < argc; ++i) {
+            member_args.emplace_back(argv[i]);
+        }
+        member_argv.clear();
+        for (auto& arg : member_args) {
+            member_argv.push_back(&arg[0]);
+        }
+        member_argv.push_back(nullptr);
+
+        argc = static_cast<int>(member_args.size());
+        argv = member_argv.data();
+        return comm;
+    }
+
 } // namespace utils
@@ -14,9 +14,10 @@
 #endif
 #include <AMReX_Print.H>
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
-#include <numeric>
+#include <utility>
 
 using namespace Utils::MsgLogger;
 
@@ -25,72 +26,46 @@ using namespace Utils::MsgLogger;
 namespace
 {
     /**
-    * \brief This collective function returns the messages of the "gather rank"
-    * as a byte array.
-    *
-    * @param[in] my_msgs the messages of the current rank
-    * @param[in] gather_rank the ID of the "gather rank"
-    * @param[in] my_rank the ID of the current rank
-    * @return the messages of the "gather rank" as a byte array
+    * This struct represents the counter of a message aggregated over a set
+    * of ranks, together with these ranks. The ranks are stored as a list of
+    * ranges [first, last] of ranks relative to the I/O rank: since the
+    * messages are merged along a binomial tree, the ranks of a
+    * subtree are contiguous and a message emitted by all of them is a single range.
     */
-    std::vector<char>
-    get_serialized_gather_rank_msgs(
-        const std::vector<Msg>& my_msgs,
-        const int gather_rank,
-        const int my_rank);
-
-    /**
-    * \brief This function generates data to send back to the "gather rank"
-    *
-    * @param[in] serialized_gather_rank_msgs the serialized messages of the gather rank
-    * @param[in] gather_rank_how_many_msgs number of messages of the "gather rank"
-    * @param[in] my_msg_map messages and counters of the current rank (as a map)
-    * @param[in] is_gather_rank true if the rank is the "gather rank", false otherwise
-    * @return a byte array to send back to the "gather rank" (or a dummy vector in case is_gather_rank is true)
-    */
-    std::vector<char>
-    compute_package_for_gather_rank(
-        const std::vector<char>& serialized_gather_rank_msgs,
-        const std::int64_t gather_rank_how_many_msgs,
-        const std::map<Msg, std::int64_t>& my_msg_map,
-        const bool is_gather_rank
-    );
+    struct MsgAggregate
+    {
+        std::int64_t counter = 0    /*! The aggregated counter*/;
+        std::vector<int> rank_ranges /*! Pairs of relative ranks [first, last]*/;
+    };
 
     /**
-    * \brief This collective function gathers data generated with compute_package_for_gather_rank
-    * to the gather rank.
-    * If my_rank != gather_rank the function returns dummy data. Otherwise the function returns
-    * a pair containing:
-    * 1) a byte array containing info on messages seen by other ranks
-    * 2) a vector of displacements to access data corresponding to a given rank
+    * \brief This function converts a map of aggregated messages into a byte array
     *
-    * @param[in] package_for_gather_rank a byte array generated by compute_package_for_gather_rank
-    * @param[in] gather_rank the ID of the "gather rank"
-    * @param[in] my_rank the ID of the current rank
-    * @return (see function description)
+    * @param[in] msg_map the map of aggregated messages
+    * @return a byte array
     */
-    std::pair<std::vector<char>, std::vector<int>>
-    gather_all_data(
-        const std::vector<char>& package_for_gather_rank,
-        const int gather_rank, const int my_rank);
+    std::vector<char> serialize_aggregates(
+        const std::map<Msg, MsgAggregate>& msg_map);
 
     /**
-    * \brief This function converts a vector of Msg struct into a byte array
+    * \brief This function converts a byte array into a map of aggregated messages
     *
-    * @param[in] msgs the vector of Msg struct
-    * @return a byte array
+    * @param[in] serialized the byte array
+    * @return a map of aggregated messages
     */
-    std::vector<char> serialize_msgs(
-        const std::vector<Msg>& msgs);
+    std::map<Msg, MsgAggregate> deserialize_aggregates(
+        const std::vector<char>& serialized);
 
     /**
-    * \brief This function converts a byte array into a vector of Msg struct
+    * \brief This function merges the aggregated messages of a subtree into those of
+    * the current subtree. The ranks of the former must all follow the ranks of the latter.
     *
-    * @param[in] serialized the byte array
-    * @return a vector of Msg struct
+    * @param[in, out] msg_map the aggregated messages of the current subtree
+    * @param[in] other_map the aggregated messages of the subtree to merge
     */
-    std::vector<Msg> deserialize_msgs(
-        const std::vector<char>& serialized);
+    void merge_aggregates(
+        std::map<Msg, MsgAggregate>& msg_map,
+        std::map<Msg, MsgAggregate>&& other_map);
 }
 #endif
 
@@ -248,53 +223,61 @@ Logger::collective_gather_msgs_with_counter_and_ranks() const
     if (m_num_procs == 1)
         return one_rank_gather_msgs_with_counter_and_ranks();
 
-    // Find out who is the "gather rank" and how many messages it has
-    const auto my_msgs = get_msgs();
-    const auto how_many_msgs = my_msgs.size();
-    int gather_rank = 0;
-    std::int64_t gather_rank_how_many_msgs = 0;
-    std::tie(gather_rank, gather_rank_how_many_msgs) =
-        find_gather_rank_and_its_msgs(how_many_msgs);
-
-    // If the "gather rank" has zero messages there are no messages at all
-    if(gather_rank_how_many_msgs == 0)
-        return std::vector<MsgWithCounterAndRanks>{};
-
-    // All the ranks receive the msgs of the "gather rank" as a byte array
-    const auto serialized_gather_rank_msgs =
-        ::get_serialized_gather_rank_msgs(my_msgs, gather_rank, m_rank);
-
-    // Each rank assembles a message to send back to the "gather rank"
-    const bool is_gather_rank = (gather_rank == m_rank);
-    const auto package_for_gather_rank =
-        ::compute_package_for_gather_rank(
-            serialized_gather_rank_msgs,
-            gather_rank_how_many_msgs,
-            m_messages, is_gather_rank);
-
-    // Send back all the data to the "gather rank"
-    auto all_data = std::vector<char>{};
-    auto displacements = std::vector<int>{};
-    std::tie(all_data, displacements) =
-        ::gather_all_data(
-            package_for_gather_rank,
-            gather_rank, m_rank);
-
-    // Use the gathered data to generate (on the "gather rank") a vector of all the
-    // messages seen by all the ranks with the corresponding counters and
-    // emitting rank lists.
-    auto msgs_with_counter_and_ranks =
-        compute_msgs_with_counter_and_ranks(
-            m_messages,
-            all_data,
-            displacements,
-            gather_rank);
-
-    // If the current rank is not the I/O rank, send msgs_with_counter_and_ranks
-    // to the I/O rank
-    swap_with_io_rank(
-        msgs_with_counter_and_ranks,
-        gather_rank);
+    // Each rank starts with its own messages, all emitted by the rank itself
+    const int my_rel_rank = (m_rank - m_io_rank + m_num_procs) % m_num_procs;
+    auto msg_map = std::map<Msg, MsgAggregate>{};
+    for (const auto& el : m_messages)
+        msg_map[el.first] = MsgAggregate{el.second, std::vector<int>{my_rel_rank, my_rel_rank}};
+
+    // Binomial tree reduction rooted at the I/O rank: at the step "mask", the ranks
+    // (relative to the I/O rank) having the bit "mask" set send their deduplicated
+    // messages to the rank "mask" below and leave, while the others merge what they
+    // receive. Neighboring ranks, which usually share a node, are merged first, and
+    // the I/O rank receives log2(m_num_procs) packages.
+    const auto abs_rank = [&](const int rel_rank){
+        return (rel_rank + m_io_rank) % m_num_procs;};
+    for (int mask = 1; mask < m_num_procs; mask <<= 1){
+        if (my_rel_rank & mask){
+            const auto package = ::serialize_aggregates(msg_map);
+            const auto package_size = static_cast<int>(package.size());
+            const int dest = abs_rank(my_rel_rank - mask);
+            amrex::ParallelDescriptor::Send(&package_size, 1, dest, 0);
+            amrex::ParallelDescriptor::Send(package, dest, 1);
+            break;
+        }
+        else if (my_rel_rank + mask < m_num_procs){
+            const int src = abs_rank(my_rel_rank + mask);
+            int package_size = 0;
+            amrex::ParallelDescriptor::Recv(&package_size, 1, src, 0);
+            auto package = std::vector<char>(package_size);
+            amrex::ParallelDescriptor::Recv(package, src, 1);
+            ::merge_aggregates(msg_map, ::deserialize_aggregates(package));
+        }
+    }
+
+    if (!m_am_i_io) return std::vector<MsgWithCounterAndRanks>{};
+
+    // Generate on the I/O rank the list of all the messages, with the corresponding
+    // global counters and emitting ranks
+    auto msgs_with_counter_and_ranks = std::vector<MsgWithCounterAndRanks>{};
+    for (const auto& el : msg_map){
+        const auto& ranges = el.second.rank_ranges;
+        const bool all_ranks = (ranges.size() == 2) &&
+            (ranges[0] == 0) && (ranges[1] == m_num_procs-1);
+        auto ranks = std::vector<int>{};
+        if (!all_ranks){
+            for (std::size_t i = 0; i < ranges.size(); i += 2){
+                for (int rr = ranges[i]; rr <= ranges[i+1]; ++rr)
+                    ranks.push_back(abs_rank(rr));
+            }
+            std::sort(ranks.begin(), ranks.end());
+        }
+        msgs_with_counter_and_ranks.emplace_back(
+            MsgWithCounterAndRanks{
+                MsgWithCounter{el.first, el.second.counter},
+                all_ranks,
+                ranks});
+    }
 
     return msgs_with_counter_and_ranks;
 #else
@@ -319,333 +302,63 @@ Logger::one_rank_gather_msgs_with_counter_and_ranks() const
 
 #ifdef AMREX_USE_MPI
 
-std::pair<int,int> Logger::find_gather_rank_and_its_msgs(int how_many_msgs) const
-{
-    int max_items = 0;
-    int max_rank = 0;
-
-    const auto num_msg =
-        amrex::ParallelDescriptor::Gather(how_many_msgs, m_io_rank);
-
-    if (m_am_i_io){
-        const auto it_max = std::max_element(num_msg.begin(), num_msg.end());
-        max_items = *it_max;
-
-        //In case of an "ex aequo" the I/O rank should be the gather rank
-        max_rank = (max_items == how_many_msgs) ?
-            m_io_rank : it_max - num_msg.begin();
-    }
-
-    auto package = std::array<int,2>{max_rank, max_items};
-    amrex::ParallelDescriptor::Bcast(package.data(), 2, m_io_rank);
-
-    return std::make_pair(package[0], package[1]);
-}
-
-std::vector<MsgWithCounterAndRanks>
-Logger::compute_msgs_with_counter_and_ranks(
-    const std::map<Msg,std::int64_t>& my_msg_map,
-    const std::vector<char>& all_data,
-    const std::vector<int>& displacements,
-    const int gather_rank) const
-{
-    if(m_rank != gather_rank) return std::vector<MsgWithCounterAndRanks>{};
-
-    std::vector<MsgWithCounterAndRanks> msgs_with_counter_and_ranks;
-
-    // Put messages of the gather rank in msgs_with_counter_and_ranks
-    for (const auto& el : my_msg_map)
-    {
-        msgs_with_counter_and_ranks.emplace_back(
-            MsgWithCounterAndRanks{
-                MsgWithCounter{el.first, el.second},
-                false,
-                std::vector<int>{m_rank}});
-    }
-
-    // We need a temporary map
-    std::map<Msg, MsgWithCounterAndRanks> tmap;
-
-#ifdef AMREX_USE_OMP
-    #pragma omp parallel for
-#endif
-    for(int rr = 0; rr < m_num_procs; ++rr){ //for each rank
-        if(rr == gather_rank) // (skip gather_rank)
-            continue;
-
-        // get counters generated by rank rr
-        auto it = all_data.begin() + displacements[rr];
-        const auto counters_rr = get_out_vec<std::int64_t>(it);
-
-         //for each counter from rank rr
-        std::int64_t c = 0;
-        for (const auto& counter : counters_rr){
-#ifdef AMREX_USE_OMP
-            #pragma omp atomic
-#endif
-            msgs_with_counter_and_ranks[c].msg_with_counter.counter +=
-                counter; //update corresponding global counter
-
-            //and add rank to rank list if it has emitted the message
-            if (counter > 0){
-#ifdef AMREX_USE_OMP
-            #pragma omp critical
-#endif
-                {
-                    msgs_with_counter_and_ranks[c].ranks.push_back(rr);
-                }
-            }
-            c++;
-        }
-
-        // for each additional message coming from rank rr
-        const auto how_many_additional_msgs_with_counter = get_out<int>(it);
-        for(int i = 0; i < how_many_additional_msgs_with_counter; ++i){
-
-            //deserialize the message
-            const auto serialized_msg_with_counter = get_out_vec<char>(it);
-            auto msg_with_counter =
-                MsgWithCounter::deserialize(serialized_msg_with_counter.begin());
-
-            //and eventually add it to the temporary map
-#ifdef AMREX_USE_OMP
-            #pragma omp critical
-#endif
-            {
-                if (tmap.find(msg_with_counter.msg) == tmap.end()){
-                    const auto msg_with_counter_and_ranks =
-                        MsgWithCounterAndRanks{
-                            msg_with_counter,
-                            false,
-                            std::vector<int>{rr}
-                        };
-                    tmap[msg_with_counter.msg] = msg_with_counter_and_ranks;
-                }
-                else{
-                    tmap[msg_with_counter.msg].msg_with_counter.counter +=
-                        msg_with_counter.counter;
-                    tmap[msg_with_counter.msg].ranks.push_back(rr);
-                }
-            }
-        }
-    }
-
-    // Check if messages emitted by "gather rank" are actually emitted by all ranks
-    const auto ssize = static_cast<int>(msgs_with_counter_and_ranks.size());
-    for (int i = 0; i < ssize; ++i){
-        const auto how_many =
-            static_cast<int>(msgs_with_counter_and_ranks[i].ranks.size());
-        if(how_many == m_num_procs){
-            msgs_with_counter_and_ranks[i].all_ranks = true;
-            // trick to force free memory
-            std::vector<int>{}.swap(msgs_with_counter_and_ranks[i].ranks);
-        }
-    }
-
-    // Add elements from the temporary map
-    for(const auto& el : tmap){
-        msgs_with_counter_and_ranks.push_back(el.second);
-    }
-
-    // Sort affected ranks lists
-    for(auto& el : msgs_with_counter_and_ranks){
-        std::sort(el.ranks.begin(), el.ranks.end());
-    }
-
-    return msgs_with_counter_and_ranks;
-}
-
-void Logger::swap_with_io_rank(
-    std::vector<MsgWithCounterAndRanks>& msgs_with_counter_and_ranks,
-    int gather_rank) const
-{
-    if (gather_rank != m_io_rank){
-        if(m_rank == gather_rank){
-            auto package = std::vector<char>{};
-            for (const auto& el: msgs_with_counter_and_ranks)
-                put_in_vec<char>(el.serialize(), package);
-
-            auto package_size = static_cast<int>(package.size());
-            amrex::ParallelDescriptor::Send(&package_size, 1, m_io_rank, 0);
-            amrex::ParallelDescriptor::Send(package, m_io_rank, 1);
-            int list_size = static_cast<int>(msgs_with_counter_and_ranks.size());
-            amrex::ParallelDescriptor::Send(&list_size, 1, m_io_rank, 2);
-        }
-        else if (m_rank == m_io_rank){
-            int vec_size = 0;
-            amrex::ParallelDescriptor::Recv(&vec_size, 1, gather_rank, 0);
-            std::vector<char> package(vec_size);
-            amrex::ParallelDescriptor::Recv(package, gather_rank, 1);
-            int list_size = 0;
-            amrex::ParallelDescriptor::Recv(&list_size, 1, gather_rank, 2);
-            auto it = package.cbegin();
-            for (int i = 0; i < list_size; ++i){
-                const auto vec = get_out_vec<char>(it);
-                msgs_with_counter_and_ranks.emplace_back(
-                    MsgWithCounterAndRanks::deserialize(vec.begin())
-                );
-            }
-        }
-    }
-}
-
 namespace
 {
-std::vector<char>
-get_serialized_gather_rank_msgs(
-    const std::vector<Msg>& my_msgs,
-    const int gather_rank,
-    const int my_rank)
-{
-    const bool is_gather_rank = (my_rank == gather_rank);
-
-    auto serialized_gather_rank_msgs = std::vector<char>{};
-    int size_serialized_gather_rank_msgs = 0;
-
-    if (is_gather_rank){
-        serialized_gather_rank_msgs = ::serialize_msgs(my_msgs);
-        size_serialized_gather_rank_msgs = static_cast<int>(
-            serialized_gather_rank_msgs.size());
-    }
-
-    amrex::ParallelDescriptor::Bcast(
-        &size_serialized_gather_rank_msgs, 1, gather_rank);
-
-    if (!is_gather_rank)
-        serialized_gather_rank_msgs.resize(
-            size_serialized_gather_rank_msgs);
-
-    amrex::ParallelDescriptor::Bcast(
-        serialized_gather_rank_msgs.data(),
-        size_serialized_gather_rank_msgs, gather_rank);
-
-    return serialized_gather_rank_msgs;
-}
-
-std::vector<char>
-compute_package_for_gather_rank(
-    const std::vector<char>& serialized_gather_rank_msgs,
-    const std::int64_t gather_rank_how_many_msgs,
-    const std::map<Msg, std::int64_t>& my_msg_map,
-    const bool is_gather_rank)
-{
-    if(!is_gather_rank){
-        auto package = std::vector<char>{};
-
-        //generates a copy of the message map
-        auto msgs_to_send = std::map<Msg, std::int64_t>{my_msg_map};
-
-        // For each message of the "gather rank" store how many times
-        // the message has been emitted by the current ranks.
-        const auto gather_rank_msgs =
-            ::deserialize_msgs(serialized_gather_rank_msgs);
-        std::vector<std::int64_t> gather_rank_msg_counters(gather_rank_how_many_msgs);
-        std::int64_t counter = 0;
-        for (const auto& msg : gather_rank_msgs){
-            const auto pp = msgs_to_send.find(msg);
-            if (pp != msgs_to_send.end()){
-                gather_rank_msg_counters[counter] += pp->second;
-                // Remove messages already seen by "gather rank" from
-                // the messages to send back
-                msgs_to_send.erase(msg);
-            }
-            counter++;
-        }
-        put_in_vec(gather_rank_msg_counters, package);
-
-        // Add the additional messages seen by the current rank to the package
-        put_in(static_cast<int>(msgs_to_send.size()), package);
-        for (const auto& el : msgs_to_send)
-            put_in_vec<char>(
-                MsgWithCounter{el.first, el.second}.serialize(), package);
-
-        return package;
-    }
-
-    return std::vector<char>{};
-}
-
-std::pair<std::vector<char>, std::vector<int>>
-gather_all_data(
-    const std::vector<char>& package_for_gather_rank,
-    const int gather_rank, const int my_rank)
-{
-    auto package_lengths = std::vector<int>{};
-    auto all_data = std::vector<char>{};
-    auto displacements = std::vector<int>{};
-
-    if(gather_rank != my_rank){
-        amrex::ParallelDescriptor::Gather(
-            static_cast<int>(package_for_gather_rank.size()), gather_rank);
-        amrex::ParallelDescriptor::Gatherv(
-            package_for_gather_rank.data(),
-            package_for_gather_rank.size(),
-            all_data.data(),
-            package_lengths,
-            displacements,
-            gather_rank);
-    }
-    else{
-        const int zero_size = 0;
-        package_lengths =
-            amrex::ParallelDescriptor::Gather(zero_size, gather_rank);
-
-        // Compute displacements
-        // Given (n1, n2, n3, n4, ..., n_n) we need (0, n1, n1+n2, n1+n2+n3, ...),
-        // but partial_sum gives us (n1,n1+n2, n1+n2+n3, n1+n2+n3+n4, ...).
-        // Rotating this last vector by one is just shifting: (n1+n2+n3+n4+...,n1, n1+n2, n1+n2+n3, ...).
-        // Then we just need to replace the first element with zero: (0,n1, n1+n2, n1+n2+n3, ...).
-        displacements.resize(package_lengths.size());
-        std::partial_sum(package_lengths.begin(), package_lengths.end(),
-            displacements.begin());
-        const auto total_sum = displacements.back();
-        std::rotate(displacements.rbegin(),
-            displacements.rbegin()+1,
-            displacements.rend());
-        displacements[0] = 0;
-
-        all_data.resize(total_sum);
-
-        amrex::ParallelDescriptor::Gatherv(
-            static_cast<char*>(nullptr),
-            0,
-            all_data.data(),
-            package_lengths,
-            displacements,
-            gather_rank);
-    }
-    return std::make_pair(all_data, displacements);
-}
-
-std::vector<char> serialize_msgs(
-    const std::vector<Msg>& msgs)
+std::vector<char> serialize_aggregates(
+    const std::map<Msg, MsgAggregate>& msg_map)
 {
     auto serialized = std::vector<char>{};
 
-    const auto how_many = static_cast<int> (msgs.size());
-    put_in (how_many, serialized);
-
-    for (auto msg : msgs){
-        put_in_vec(msg.serialize(), serialized);
+    put_in(static_cast<int>(msg_map.size()), serialized);
+    for (const auto& el : msg_map){
+        put_in_vec(el.first.serialize(), serialized);
+        put_in(el.second.counter, serialized);
+        put_in_vec(el.second.rank_ranges, serialized);
     }
     return serialized;
 }
 
-std::vector<Msg> deserialize_msgs(
+std::map<Msg, MsgAggregate> deserialize_aggregates(
     const std::vector<char>& serialized)
 {
     auto it = serialized.begin();
 
     const auto how_many = get_out<int>(it);
-    auto msgs = std::vector<Msg>{};
-    msgs.reserve(how_many);
+    auto msg_map = std::map<Msg, MsgAggregate>{};
 
     for (int i = 0; i < how_many; ++i){
         const auto vv = get_out_vec<char>(it);
-        msgs.emplace_back(Msg::deserialize(vv.begin()));
+        const auto msg = Msg::deserialize(vv.begin());
+        auto& aggregate = msg_map[msg];
+        aggregate.counter = get_out<std::int64_t>(it);
+        aggregate.rank_ranges = get_out_vec<int>(it);
     }
 
-    return msgs;
+    return msg_map;
+}
+
+void merge_aggregates(
+    std::map<Msg, MsgAggregate>& msg_map,
+    std::map<Msg, MsgAggregate>&& other_map)
+{
+    for (auto& el : other_map){
+        const auto pp = msg_map.find(el.first);
+        if (pp == msg_map.end()){
+            msg_map.emplace(el.first, std::move(el.second));
+            continue;
+        }
+        auto& ranges = pp->second.rank_ranges;
+        const auto& other_ranges = el.second.rank_ranges;
+        pp->second.counter += el.second.counter;
+        // Join the last range with the first range of the other subtree if contiguous
+        auto other_begin = other_ranges.begin();
+        if (!ranges.empty() && !other_ranges.empty() &&
+            ranges.back() + 1 == other_ranges.front()){
+            ranges.back() = other_ranges[1];
+            other_begin += 2;
+        }
+        ranges.insert(ranges.end(), other_begin, other_ranges.end());
+    }
 }
 }
 
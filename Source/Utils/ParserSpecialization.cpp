@@ -0,0 +1,301 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "ParserSpecialization.H"
+
+#include "Utils/WarpXUtil.H"
+
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+    /** Polynomial of (at most) one variable, possibly within an exponential:
+     *  amp*exp(sum c[i] v^i) if is_exp, sum c[i] v^i otherwise */
+    struct Poly
+    {
+        int var = -1; //!< index of the variable, -1 for a constant
+        std::vector<double> c = {0.};
+        bool is_exp = false;
+        double amp = 1.;
+
+        bool isConstant () const { return !is_exp && (var < 0 || c.size() == 1); }
+    };
+
+    Poly makeConstant (double value)
+    {
+        Poly p;
+        p.c = {value};
+        return p;
+    }
+
+    /** Recursive descent parser of the subset of the amrex::Parser grammar made of
+     *  the operators + - * / ^ ** and of function calls */
+    class ShapeParser
+    {
+    public:
+        ShapeParser (std::string const& expr, amrex::Vector<std::string> const& varnames)
+            : m_s(expr), m_vars(varnames) {}
+
+        bool parse (Poly& result)
+        {
+            result = expr();
+            skip();
+            return m_ok && m_pos == m_s.size();
+        }
+
+    private:
+        std::string const& m_s;
+        amrex::Vector<std::string> const& m_vars;
+        std::size_t m_pos = 0;
+        bool m_ok = true;
+
+        Poly fail () { m_ok = false; return Poly(); }
+
+        void skip () { while (m_pos < m_s.size() && std::isspace(m_s[m_pos])) ++m_pos; }
+
+        char peek () { skip(); return (m_pos < m_s.size()) ? m_s[m_pos] : '\0'; }
+
+        Poly expr ()
+        {
+            Poly a = term();
+            while (m_ok) {
+                const char op = peek();
+                if (op != '+' && op != '-') break;
+                ++m_pos;
+                Poly b = term();
+                if (op == '-') b = scale(b, -1.);
+                a = add(a, b);
+            }
+            return a;
+        }
+
+        Poly term ()
+        {
+            Poly a = unary();
+            while (m_ok) {
+                const char op = peek();
+                if (op == '*' && m_s.compare(m_pos, 2, "**") != 0) {
+                    ++m_pos;
+                    a = mul(a, unary());
+                } else if (op == '/') {
+                    ++m_pos;
+                    const Poly b = unary();
+                    if (!b.isConstant() || b.c[0] == 0.) return fail();
+                    a = scale(a, 1./b.c[0]);
+                } else {
+                    break;
+                }
+            }
+            return a;
+        }
+
+        Poly unary ()
+        {
+            const char op = peek();
+            if (op == '-') { ++m_pos; return scale(unary(), -1.); }
+            if (op == '+') { ++m_pos; return unary(); }
+            return power();
+        }
+
+        Poly power ()
+        {
+            Poly a = primary();
+            if (!m_ok) return a;
+            skip();
+            if (m_s.compare(m_pos, 2, "**") == 0) {
+                m_pos += 2;
+            } else if (peek() == '^') {
+                ++m_pos;
+            } else {
+                return a;
+            }
+            const Poly b = unary();
+            if (!m_ok || !b.isConstant()) return fail();
+            if (a.isConstant()) return makeConstant(std::pow(a.c[0], b.c[0]));
+            if (b.c[0] < 0. || b.c[0] > parser_shape_max_degree) return fail();
+            const int n = static_cast<int>(b.c[0]);
+            if (n != b.c[0]) return fail();
+            Poly result = makeConstant(1.);
+            for (int i = 0; i < n; ++i) result = mul(result, a);
+            return result;
+        }
+
+        Poly primary ()
+        {
+            const char ch = peek();
+            if (ch == '(') {
+                ++m_pos;
+                Poly a = expr();
+                if (peek() != ')') return fail();
+                ++m_pos;
+                return a;
+            }
+            if (std::isdigit(ch) || ch == '.') {
+                const char* begin = m_s.c_str() + m_pos;
+                char* end = nullptr;
+                const double value = std::strtod(begin, &end);
+                if (end == begin) return fail();
+                m_pos += static_cast<std::size_t>(end - begin);
+                return makeConstant(value);
+            }
+            if (std::isalpha(ch) || ch == '_') {
+                const std::size_t begin = m_pos;
+                while (m_pos < m_s.size() && (std::isalnum(m_s[m_pos]) || m_s[m_pos] == '_')) ++m_pos;
+                const std::string name = m_s.substr(begin, m_pos - begin);
+                if (peek() == '(') return call(name, begin);
+                for (int i = 0; i < static_cast<int>(m_vars.size()); ++i) {
+                    if (name == m_vars[i]) {
+                        Poly p;
+                        p.var = i;
+                        p.c = {0., 1.};
+                        return p;
+                    }
+                }
+                // User-defined or built-in constant
+                return makeConstant(parseStringtoReal(name));
+            }
+            return fail();
+        }
+
+        /** Function call name(args), starting at begin in the expression */
+        Poly call (std::string const& name, std::size_t const begin)
+        {
+            ++m_pos; // '('
+            std::vector<Poly> args;
+            args.push_back(expr());
+            while (m_ok && peek() == ',') {
+                ++m_pos;
+                args.push_back(expr());
+            }
+            if (!m_ok || peek() != ')') return fail();
+            ++m_pos;
+
+            bool constant_args = true;
+            for (auto const& arg : args) constant_args = constant_args && arg.isConstant();
+            if (constant_args) {
+                // Function of constants: evaluated by the parser
+                return makeConstant(parseStringtoReal(m_s.substr(begin, m_pos - begin)));
+            }
+            if (name == "exp" && args.size() == 1 && !args[0].is_exp) {
+                Poly p = args[0];
+                p.is_exp = true;
+                p.amp = 1.;
+                return p;
+            }
+            return fail();
+        }
+
+        Poly scale (Poly a, double const factor)
+        {
+            if (a.is_exp) {
+                a.amp *= factor;
+            } else {
+                for (auto& ci : a.c) ci *= factor;
+            }
+            return a;
+        }
+
+        Poly add (Poly const& a, Poly const& b)
+        {
+            if (!m_ok) return a;
+            if (a.is_exp || b.is_exp) {
+                // Only the addition of 0 is supported
+                if (b.isConstant() && b.c[0] == 0.) return a;
+                if (a.isConstant() && a.c[0] == 0.) return b;
+                return fail();
+            }
+            if (a.var >= 0 && b.var >= 0 && a.var != b.var) return fail();
+            Poly result;
+            result.var = (a.var >= 0) ? a.var : b.var;
+            result.c.assign(std::max(a.c.size(), b.c.size()), 0.);
+            for (std::size_t i = 0; i < a.c.size(); ++i) result.c[i] += a.c[i];
+            for (std::size_t i = 0; i < b.c.size(); ++i) result.c[i] += b.c[i];
+            return result;
+        }
+
+        Poly mul (Poly const& a, Poly const& b)
+        {
+            if (!m_ok) return a;
+            if (a.isConstant()) return scale(b, a.c[0]);
+            if (b.isConstant()) return scale(a, b.c[0]);
+            if (a.is_exp != b.is_exp) return fail();
+            if (a.is_exp) {
+                // exp(P)*exp(Q) = exp(P+Q)
+                Poly pa = a, pb = b;
+                pa.is_exp = pb.is_exp = false;
+                Poly result = add(pa, pb);
+                result.is_exp = true;
+                result.amp = a.amp*b.amp;
+                return result;
+            }
+            if (a.var != b.var) return fail();
+            if (a.c.size() + b.c.size() - 2 > parser_shape_max_degree) return fail();
+            Poly result;
+            result.var = a.var;
+            result.c.assign(a.c.size() + b.c.size() - 1, 0.);
+            for (std::size_t i = 0; i < a.c.size(); ++i) {
+                for (std::size_t j = 0; j < b.c.size(); ++j) {
+                    result.c[i+j] += a.c[i]*b.c[j];
+                }
+            }
+            return result;
+        }
+    };
+}
+
+ParserShape
+RecognizeParserShape (std::string const& expr, amrex::Vector<std::string> const& varnames)
+{
+    ParserShape shape;
+    Poly poly;
+    ShapeParser shape_parser(expr, varnames);
+    if (!shape_parser.parse(poly)) return shape;
+    if (static_cast<int>(poly.c.size()) > parser_shape_max_degree+1) return shape;
+
+    shape.kind = poly.is_exp ? ParserShapeKind::exp_polynomial : ParserShapeKind::polynomial;
+    shape.var = std::max(poly.var, 0);
+    shape.degree = static_cast<int>(poly.c.size()) - 1;
+    for (int i = 0; i <= shape.degree; ++i) {
+        shape.coef[i] = static_cast<amrex::Real>(poly.c[i]);
+    }
+    shape.amp = static_cast<amrex::Real>(poly.amp);
+    return shape;
+}
+
+template <int N>
+SpecializedParser<N>
+compileSpecializedParser (amrex::Parser const& parser, std::string const& expr,
+                          amrex::Vector<std::string> const& varnames)
+{
+    SpecializedParser<N> specialized;
+    specialized.m_exe = parser.compile<N>();
+
+    bool specialize_parsers = false;
+    amrex::ParmParse pp_warpx("warpx");
+    pp_warpx.query("specialize_parsers", specialize_parsers);
+    if (specialize_parsers) {
+        specialized.m_shape = RecognizeParserShape(expr, varnames);
+        if (specialized.m_shape.kind != ParserShapeKind::interpreter) {
+            amrex::Print() << "Parser: the expression " << expr << " is evaluated as "
+                           << ((specialized.m_shape.kind == ParserShapeKind::polynomial) ?
+                               "a polynomial" : "the exponential of a polynomial")
+                           << " of " << varnames[specialized.m_shape.var] << "\n";
+        }
+    }
+    return specialized;
+}
+
+template SpecializedParser<3> compileSpecializedParser<3> (
+    amrex::Parser const&, std::string const&, amrex::Vector<std::string> const&);
+template SpecializedParser<4> compileSpecializedParser<4> (
+    amrex::Parser const&, std::string const&, amrex::Vector<std::string> const&);
@@ -37,6 +37,18 @@ const std::map<std::string, int> electrostatic_solver_algo_to_int = {
     {"default", ElectrostaticSolverAlgo::None }
 };
 
+const std::map<std::string, int> poisson_solver_algo_to_int = {
+    {"multigrid", PoissonSolverAlgo::Multigrid },
+    {"fft",       PoissonSolverAlgo::FFT },
+    {"default",   PoissonSolverAlgo::Multigrid }
+};
+
+const std::map<std::string, int> comm_precision_algo_to_int = {
+    {"single",   CommPrecision::Single },
+    {"bfloat16", CommPrecision::BFloat16 },
+    {"default",  CommPrecision::Default }
+};
+
 const std::map<std::string, int> particle_pusher_algo_to_int = {
     {"boris",   ParticlePusherAlgo::Boris },
     {"vay",     ParticlePusherAlgo::Vay },
@@ -48,6 +60,7 @@ const std::map<std::string, int> current_deposition_algo_to_int = {
     {"esirkepov", CurrentDepositionAlgo::Esirkepov },
     {"direct",    CurrentDepositionAlgo::Direct },
     {"vay",       CurrentDepositionAlgo::Vay },
+    {"esirkepov_shared", CurrentDepositionAlgo::EsirkepovShared },
     {"default",   CurrentDepositionAlgo::Esirkepov } // NOTE: overwritten for PSATD below
 };
 
@@ -69,6 +82,13 @@ const std::map<std::string, int> load_balance_costs_update_algo_to_int = {
     {"default",   LoadBalanceCostsUpdateAlgo::Timers }
 };
 
+const std::map<std::string, int> load_balance_costs_prediction_to_int = {
+    {"none",          LoadBalanceCostsPrediction::None },
+    {"smoothing",     LoadBalanceCostsPrediction::Smoothing },
+    {"extrapolation", LoadBalanceCostsPrediction::Extrapolation },
+    {"default",       LoadBalanceCostsPrediction::None }
+};
+
 const std::map<std::string, int> MaxwellSolver_medium_algo_to_int = {
     {"vacuum", MediumForEM::Vacuum},
     {"macroscopic", MediumForEM::Macroscopic},
@@ -121,6 +141,12 @@ GetAlgorithmInteger( amrex::ParmParse& pp, const char* pp_search_key ){
         algo_to_int = maxwell_solver_algo_to_int;
     } else if (0 == std::strcmp(pp_search_key, "do_electrostatic")) {
         algo_to_int = electrostatic_solver_algo_to_int;
+    } else if (0 == std::strcmp(pp_search_key, "poisson_solver")) {
+        algo_to_int = poisson_solver_algo_to_int;
+    } else if (0 == std::strcmp(pp_search_key, "comm_precision_E") ||
+               0 == std::strcmp(pp_search_key, "comm_precision_B") ||
+               0 == std::strcmp(pp_search_key, "comm_precision_F")) {
+        algo_to_int = comm_precision_algo_to_int;
     } else if (0 == std::strcmp(pp_search_key, "particle_pusher")) {
         algo_to_int = particle_pusher_algo_to_int;
     } else if (0 == std::strcmp(pp_search_key, "current_deposition")) {
@@ -133,6 +159,8 @@ GetAlgorithmInteger( amrex::ParmParse& pp, const char* pp_search_key ){
         algo_to_int = gathering_algo_to_int;
     } else if (0 == std::strcmp(pp_search_key, "load_balance_costs_update")) {
         algo_to_int = load_balance_costs_update_algo_to_int;
+    } else if (0 == std::strcmp(pp_search_key, "load_balance_costs_prediction")) {
+        algo_to_int = load_balance_costs_prediction_to_int;
     } else if (0 == std::strcmp(pp_search_key, "em_solver_medium")) {
         algo_to_int = MaxwellSolver_medium_algo_to_int;
     } else if (0 == std::strcmp(pp_search_key, "macroscopic_sigma_method")) {
@@ -0,0 +1,121 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "WarpXGpuGraph.H"
+
+#include <AMReX.H>
+#include <AMReX_BLProfiler.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_GpuError.H>
+#include <AMReX_MFIter.H>
+
+#include <utility>
+
+GpuGraphs::~GpuGraphs ()
+{
+    Clear();
+}
+
+bool
+GpuGraphs::Available ()
+{
+#if defined(AMREX_USE_CUDA) || defined(AMREX_USE_HIP)
+    // The kernels of the MFIter loops are launched on several streams otherwise
+    return amrex::Gpu::numGpuStreams() == 1;
+#else
+    return false;
+#endif
+}
+
+std::vector<const void*>
+GpuGraphs::MakeKey (const std::vector<const amrex::MultiFab*>& mfs)
+{
+    std::vector<const void*> key;
+    for (const amrex::MultiFab* mf : mfs) {
+        if (!mf) {
+            key.push_back(nullptr);
+            continue;
+        }
+        key.push_back(mf);
+        for (amrex::MFIter mfi(*mf); mfi.isValid(); ++mfi) {
+            key.push_back((*mf)[mfi].dataPtr());
+        }
+    }
+    return key;
+}
+
+void
+GpuGraphs::Run (const std::string& name, const std::vector<const amrex::MultiFab*>& mfs,
+                amrex::Real dt, const std::function<void()>& f)
+{
+#if defined(AMREX_USE_CUDA) || defined(AMREX_USE_HIP)
+    if (!Available()) {
+        f();
+        return;
+    }
+
+    std::vector<const void*> key = MakeKey(mfs);
+    auto it = m_graphs.find(name);
+    if (it != m_graphs.end() && (it->second.key != key || it->second.dt != dt)) {
+        Destroy(it->second);
+        m_graphs.erase(it);
+        it = m_graphs.end();
+    }
+
+    if (it == m_graphs.end()) {
+        BL_PROFILE("GpuGraphs::Capture");
+        Graph graph;
+        graph.key = std::move(key);
+        graph.dt = dt;
+        // The MFIter loops must not synchronize the stream while it is captured
+        amrex::Gpu::NoSyncRegion no_sync;
+#   if defined(AMREX_USE_CUDA)
+        cudaGraph_t g;
+        AMREX_CUDA_SAFE_CALL(cudaStreamBeginCapture(amrex::Gpu::gpuStream(), cudaStreamCaptureModeRelaxed));
+        f();
+        AMREX_CUDA_SAFE_CALL(cudaStreamEndCapture(amrex::Gpu::gpuStream(), &g));
+        AMREX_CUDA_SAFE_CALL(cudaGraphInstantiate(&graph.exec, g, nullptr, nullptr, 0));
+        AMREX_CUDA_SAFE_CALL(cudaGraphDestroy(g));
+#   else
+        hipGraph_t g;
+        AMREX_HIP_SAFE_CALL(hipStreamBeginCapture(amrex::Gpu::gpuStream(), hipStreamCaptureModeRelaxed));
+        f();
+        AMREX_HIP_SAFE_CALL(hipStreamEndCapture(amrex::Gpu::gpuStream(), &g));
+        AMREX_HIP_SAFE_CALL(hipGraphInstantiate(&graph.exec, g, nullptr, nullptr, 0));
+        AMREX_HIP_SAFE_CALL(hipGraphDestroy(g));
+#   endif
+        it = m_graphs.emplace(name, std::move(graph)).first;
+    }
+
+#   if defined(AMREX_USE_CUDA)
+    AMREX_CUDA_SAFE_CALL(cudaGraphLaunch(it->second.exec, amrex::Gpu::gpuStream()));
+#   else
+    AMREX_HIP_SAFE_CALL(hipGraphLaunch(it->second.exec, amrex::Gpu::gpuStream()));
+#   endif
+#else
+    amrex::ignore_unused(name, mfs, dt);
+    f();
+#endif
+}
+
+void
+GpuGraphs::Destroy (Graph& graph)
+{
+#if defined(AMREX_USE_CUDA)
+    AMREX_CUDA_SAFE_CALL(cudaGraphExecDestroy(graph.exec));
+#elif defined(AMREX_USE_HIP)
+    AMREX_HIP_SAFE_CALL(hipGraphExecDestroy(graph.exec));
+#else
+    amrex::ignore_unused(graph);
+#endif
+}
+
+void
+GpuGraphs::Clear ()
+{
+    for (auto& g : m_graphs) Destroy(g.second);
+    m_graphs.clear();
+}
@@ -0,0 +1,198 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "WarpXGpuRegions.H"
+
+#include <AMReX.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_Print.H>
+
+#if defined(WARPX_USE_GPU_RANGES) && defined(AMREX_USE_CUDA)
+#   include <nvtx3/nvToolsExt.h>
+#elif defined(WARPX_USE_GPU_RANGES) && defined(AMREX_USE_HIP)
+#   include <roctracer/roctx.h>
+#endif
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+#if defined(WARPX_USE_GPU_RANGES) && (defined(AMREX_USE_CUDA) || defined(AMREX_USE_HIP))
+#   if defined(AMREX_USE_CUDA)
+    using GpuEvent = cudaEvent_t;
+#   else
+    using GpuEvent = hipEvent_t;
+#   endif
+
+    struct PendingRegion
+    {
+        std::string name;
+        bool range = false;
+        bool timer = false;
+        GpuEvent start;
+        GpuEvent stop;
+        bool ended = false;
+    };
+
+    std::vector<PendingRegion> pending;       /**< regions begun, indexed by handle */
+    std::vector<int> free_handles;            /**< handles of resolved regions */
+    std::vector<GpuEvent> event_pool;         /**< events that can be reused */
+    std::map<std::string, std::pair<long, double> > timers; /**< calls and GPU time (s) */
+
+    GpuEvent NewEvent ()
+    {
+        GpuEvent e;
+        if (!event_pool.empty()) {
+            e = event_pool.back();
+            event_pool.pop_back();
+        } else {
+#   if defined(AMREX_USE_CUDA)
+            AMREX_CUDA_SAFE_CALL(cudaEventCreate(&e));
+#   else
+            AMREX_HIP_SAFE_CALL(hipEventCreate(&e));
+#   endif
+        }
+        return e;
+    }
+
+    void RecordEvent (GpuEvent e)
+    {
+#   if defined(AMREX_USE_CUDA)
+        AMREX_CUDA_SAFE_CALL(cudaEventRecord(e, amrex::Gpu::gpuStream()));
+#   else
+        AMREX_HIP_SAFE_CALL(hipEventRecord(e, amrex::Gpu::gpuStream()));
+#   endif
+    }
+
+    /** Time between the two events in s, or a negative value if they are not complete */
+    double ElapsedTime (GpuEvent start, GpuEvent stop, bool wait)
+    {
+        float ms = 0.f;
+#   if defined(AMREX_USE_CUDA)
+        if (wait) AMREX_CUDA_SAFE_CALL(cudaEventSynchronize(stop));
+        if (cudaEventQuery(stop) != cudaSuccess) return -1.;
+        AMREX_CUDA_SAFE_CALL(cudaEventElapsedTime(&ms, start, stop));
+#   else
+        if (wait) AMREX_HIP_SAFE_CALL(hipEventSynchronize(stop));
+        if (hipEventQuery(stop) != hipSuccess) return -1.;
+        AMREX_HIP_SAFE_CALL(hipEventElapsedTime(&ms, start, stop));
+#   endif
+        return 1.e-3*ms;
+    }
+
+    void ResolveRegions (bool wait)
+    {
+        for (int h = 0; h < static_cast<int>(pending.size()); ++h) {
+            auto& r = pending[h];
+            if (!r.ended || !r.timer) continue;
+            const double t = ElapsedTime(r.start, r.stop, wait);
+            if (t < 0.) continue;
+            auto& timer = timers[r.name];
+            timer.first += 1;
+            timer.second += t;
+            event_pool.push_back(r.start);
+            event_pool.push_back(r.stop);
+            r.timer = false;
+            free_handles.push_back(h);
+        }
+    }
+#endif
+}
+
+namespace WarpXGpuRegions
+{
+    int ranges_level = 0;
+    int timers_level = 0;
+
+    int Begin (const char* name, bool do_range, bool do_timer)
+    {
+#if defined(WARPX_USE_GPU_RANGES) && (defined(AMREX_USE_CUDA) || defined(AMREX_USE_HIP))
+        int h;
+        if (!free_handles.empty()) {
+            h = free_handles.back();
+            free_handles.pop_back();
+        } else {
+            h = static_cast<int>(pending.size());
+            pending.emplace_back();
+        }
+        auto& r = pending[h];
+        r.range = do_range;
+        r.timer = do_timer;
+        r.ended = false;
+        if (do_range) {
+#   if defined(AMREX_USE_CUDA)
+            nvtxRangePushA(name);
+#   else
+            roctxRangePushA(name);
+#   endif
+        }
+        if (do_timer) {
+            r.name = name;
+            r.start = NewEvent();
+            r.stop = NewEvent();
+            RecordEvent(r.start);
+        }
+        return h;
+#else
+        amrex::ignore_unused(name, do_range, do_timer);
+        return -1;
+#endif
+    }
+
+    void End (int handle)
+    {
+#if defined(WARPX_USE_GPU_RANGES) && (defined(AMREX_USE_CUDA) || defined(AMREX_USE_HIP))
+        if (handle < 0) return;
+        auto& r = pending[handle];
+        if (r.range) {
+#   if defined(AMREX_USE_CUDA)
+            nvtxRangePop();
+#   else
+            roctxRangePop();
+#   endif
+        }
+        r.ended = true;
+        if (r.timer) {
+            RecordEvent(r.stop);
+        } else {
+            free_handles.push_back(handle);
+        }
+#else
+        amrex::ignore_unused(handle);
+#endif
+    }
+
+    void Resolve ()
+    {
+#if defined(WARPX_USE_GPU_RANGES) && (defined(AMREX_USE_CUDA) || defined(AMREX_USE_HIP))
+        ResolveRegions(false);
+#endif
+    }
+
+    void PrintTimers ()
+    {
+#if defined(WARPX_USE_GPU_RANGES) && (defined(AMREX_USE_CUDA) || defined(AMREX_USE_HIP))
+        ResolveRegions(true);
+
+        if (timers.empty()) return;
+
+        // The timers of the IO processor are printed (the regions may differ between ranks)
+        std::vector<std::pair<std::string, std::pair<long, double> > > sorted(timers.begin(), timers.end());
+        std::sort(sorted.begin(), sorted.end(),
+                  [] (const auto& a, const auto& b) { return a.second.second > b.second.second; });
+        amrex::Print() << "\nGPU time of the profiler regions (IO processor, stream of each region):\n";
+        for (const auto& t : sorted) {
+            amrex::Print() << "  " << std::left << std::setw(70) << t.first
+                           << std::right << std::setw(10) << t.second.first
+                           << std::setw(14) << std::setprecision(6) << t.second.second << " s\n";
+        }
+#endif
+    }
+}
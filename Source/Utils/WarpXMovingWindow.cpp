@@ -40,8 +40,10 @@
 
 #include <AMReX_BaseFwd.H>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdlib>
 #include <memory>
 #include <string>
 
@@ -280,6 +282,7 @@ WarpX::shiftMF (MultiFab& mf, const Geometry& geom, int num_shift, int dir,
                 amrex::Real external_field, bool useparser,
                 ParserExecutor<3> const& field_parser)
 {
+    WarpXCommUtil::CommSite comm_site("MovingWindow");
     WARPX_PROFILE("WarpX::shiftMF()");
     const BoxArray& ba = mf.boxArray();
     const DistributionMapping& dm = mf.DistributionMap();
@@ -288,12 +291,18 @@ WarpX::shiftMF (MultiFab& mf, const Geometry& geom, int num_shift, int dir,
 
     AMREX_ALWAYS_ASSERT(ng[dir] >= num_shift);
 
-    MultiFab tmpmf(ba, dm, nc, ng);
-    MultiFab::Copy(tmpmf, mf, 0, 0, nc, ng);
+    // With moving_window_shift_in_place, the data is shifted within mf, without
+    // a temporary copy of the whole field: only the guard cells are communicated
+    MultiFab tmpmf;
+    if (!moving_window_shift_in_place) {
+        tmpmf.define(ba, dm, nc, ng);
+        MultiFab::Copy(tmpmf, mf, 0, 0, nc, ng);
+    }
+    MultiFab& srcmf = (moving_window_shift_in_place) ? mf : tmpmf;
 
     if ( WarpX::safe_guard_cells ) {
         // Fill guard cells.
-        WarpXCommUtil::FillBoundary(tmpmf, geom.periodicity());
+        WarpXCommUtil::FillBoundary(srcmf, geom.periodicity());
     } else {
         IntVect ng_mw = IntVect::TheUnitVector();
         // Enough guard cells in the MW direction
@@ -301,7 +310,7 @@ WarpX::shiftMF (MultiFab& mf, const Geometry& geom, int num_shift, int dir,
         // Make sure we don't exceed number of guard cells allocated
         ng_mw = ng_mw.min(ng);
         // Fill guard cells.
-        WarpXCommUtil::FillBoundary(tmpmf, ng_mw, geom.periodicity());
+        WarpXCommUtil::FillBoundary(srcmf, ng_mw, geom.periodicity());
     }
 
     // Make a box that covers the region that the window moved into
@@ -340,10 +349,10 @@ WarpX::shiftMF (MultiFab& mf, const Geometry& geom, int num_shift, int dir,
 #endif
 
 
-    for (MFIter mfi(tmpmf); mfi.isValid(); ++mfi )
+    for (MFIter mfi(srcmf); mfi.isValid(); ++mfi )
     {
         auto const& dstfab = mf.array(mfi);
-        auto const& srcfab = tmpmf.array(mfi);
+        auto const& srcfab = srcmf.array(mfi);
 
         const Box& outbox = mfi.fabbox() & adjBox;
 
@@ -355,7 +364,7 @@ WarpX::shiftMF (MultiFab& mf, const Geometry& geom, int num_shift, int dir,
                 })
             } else if (useparser == true) {
                 // index type of the src mf
-                auto const& mf_IndexType = (tmpmf).ixType();
+                auto const& mf_IndexType = (srcmf).ixType();
                 IntVect mf_type(AMREX_D_DECL(0,0,0));
                 for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
                     mf_type[idim] = mf_IndexType.nodeCentered(idim);
@@ -389,10 +398,33 @@ WarpX::shiftMF (MultiFab& mf, const Geometry& geom, int num_shift, int dir,
         } else {
             dstBox.growLo(dir,  num_shift);
         }
-        AMREX_PARALLEL_FOR_4D ( dstBox, nc, i, j, k, n,
-        {
-            dstfab(i,j,k,n) = srcfab(i+shift.x,j+shift.y,k+shift.z,n);
-        })
+        if (!moving_window_shift_in_place) {
+            AMREX_PARALLEL_FOR_4D ( dstBox, nc, i, j, k, n,
+            {
+                dstfab(i,j,k,n) = srcfab(i+shift.x,j+shift.y,k+shift.z,n);
+            })
+        } else {
+            // Shift the data in slabs of |num_shift| planes, starting from the side of
+            // the shift: each slab reads the next one, which has not been overwritten yet
+            const int nslab = std::abs(num_shift);
+            const int lo = dstBox.smallEnd(dir);
+            const int hi = dstBox.bigEnd(dir);
+            for (int islab = 0; islab*nslab <= hi-lo; ++islab)
+            {
+                Box slab = dstBox;
+                if (num_shift > 0) {
+                    slab.setSmall(dir, lo + islab*nslab);
+                    slab.setBig(dir, std::min(lo + (islab+1)*nslab - 1, hi));
+                } else {
+                    slab.setBig(dir, hi - islab*nslab);
+                    slab.setSmall(dir, std::max(hi - (islab+1)*nslab + 1, lo));
+                }
+                AMREX_PARALLEL_FOR_4D ( slab, nc, i, j, k, n,
+                {
+                    dstfab(i,j,k,n) = dstfab(i+shift.x,j+shift.y,k+shift.z,n);
+                })
+            }
+        }
     }
 }
 
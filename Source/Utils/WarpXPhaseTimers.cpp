@@ -0,0 +1,97 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "WarpXPhaseTimers.H"
+
+#include "WarpX.H"
+
+#include <AMReX_GpuDevice.H>
+#include <AMReX_Utility.H>
+
+#ifdef AMREX_USE_OMP
+#   include <omp.h>
+#endif
+
+namespace
+{
+    bool phase_timers_enabled = false;
+    WarpXPhaseTimers::Phase current_phase = WarpXPhaseTimers::Phase::Other;
+    double phase_t0 = 0.;
+    std::array<double, WarpXPhaseTimers::nPhases> phase_times = {};
+    std::array<double, WarpXPhaseTimers::nPhases> total_phase_times = {};
+
+    /** \brief Add the time since the last switch to the current phase, and switch to phase */
+    void SwitchPhase (WarpXPhaseTimers::Phase phase)
+    {
+        if (phase_timers_enabled) {
+            // Wait for the kernels of the current phase, as for the profiler regions
+            if (WarpX::do_device_synchronize) amrex::Gpu::synchronize();
+            const double t = amrex::second();
+            phase_times[static_cast<int>(current_phase)] += t - phase_t0;
+            total_phase_times[static_cast<int>(current_phase)] += t - phase_t0;
+            phase_t0 = t;
+        }
+        current_phase = phase;
+    }
+}
+
+namespace WarpXPhaseTimers
+{
+    const char* PhaseName (Phase phase)
+    {
+        switch (phase) {
+            case Phase::Push: return "push";
+            case Phase::Deposit: return "deposit";
+            case Phase::FieldSolve: return "field_solve";
+            case Phase::Comm: return "communication";
+            case Phase::Collisions: return "collisions";
+            case Phase::QED: return "qed";
+            case Phase::Diagnostics: return "diagnostics";
+            case Phase::LoadBalance: return "load_balance";
+            default: return "other";
+        }
+    }
+
+    PhaseScope::PhaseScope (Phase phase)
+        : m_previous_phase(current_phase), m_active(true)
+    {
+#ifdef AMREX_USE_OMP
+        m_active = !omp_in_parallel();
+#endif
+        if (m_active && phase != current_phase) SwitchPhase(phase);
+    }
+
+    PhaseScope::~PhaseScope ()
+    {
+        if (m_active && m_previous_phase != current_phase) SwitchPhase(m_previous_phase);
+    }
+
+    void Enable (bool enable)
+    {
+        phase_timers_enabled = enable;
+        phase_t0 = amrex::second();
+    }
+
+    std::array<double, nPhases> const& GetPhaseTimes ()
+    {
+        // Include the time spent in the current phase so far
+        SwitchPhase(current_phase);
+        return phase_times;
+    }
+
+    void ResetPhaseTimes ()
+    {
+        // The time of the current phase so far is still counted in the total
+        SwitchPhase(current_phase);
+        phase_times.fill(0.);
+    }
+
+    std::array<double, nPhases> const& GetTotalPhaseTimes ()
+    {
+        SwitchPhase(current_phase);
+        return total_phase_times;
+    }
+}
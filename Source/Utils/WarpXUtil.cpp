@@ -17,6 +17,7 @@
 #include <AMReX_Array4.H>
 #include <AMReX_BLassert.H>
 #include <AMReX_Box.H>
+#include <AMReX_CArena.H>
 #include <AMReX_Config.H>
 #include <AMReX_FArrayBox.H>
 #include <AMReX_FabArray.H>
@@ -24,8 +25,10 @@
 #include <AMReX_GpuLaunch.H>
 #include <AMReX_MFIter.H>
 #include <AMReX_MultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_Parser.H>
+#include <AMReX_Print.H>
 
 #include <algorithm>
 #include <array>
@@ -692,6 +695,75 @@ void AlwaysAssert(bool is_expression_true, const std::string& msg = "ERROR!")
 
 }
 
+namespace WarpXUtilMem
+{
+    amrex::Long MultiFabBytes (const amrex::MultiFab* mf)
+    {
+        if (!mf) return 0;
+        amrex::Long bytes = 0;
+        for (int li = 0; li < mf->local_size(); ++li) {
+            bytes += static_cast<amrex::Long>(mf->atLocalIdx(li).nBytesOwned());
+        }
+        return bytes;
+    }
+
+    amrex::Long ArenaBytesInUse (const amrex::Arena* arena)
+    {
+        const auto* carena = dynamic_cast<const amrex::CArena*>(arena);
+        return (carena) ? static_cast<amrex::Long>(carena->heap_space_actually_used()) : 0;
+    }
+
+    amrex::Long ArenaBytesReserved (const amrex::Arena* arena)
+    {
+        const auto* carena = dynamic_cast<const amrex::CArena*>(arena);
+        return (carena) ? static_cast<amrex::Long>(carena->heap_space_used()) : 0;
+    }
+
+    amrex::Arena* TransientArena ()
+    {
+        static amrex::Arena* transient_arena = nullptr;
+        static bool initialized = false;
+        if (!initialized)
+        {
+            initialized = true;
+            bool use_transient_arena = false;
+            amrex::ParmParse pp_warpx("warpx");
+            pp_warpx.query("use_transient_arena", use_transient_arena);
+            if (use_transient_arena)
+            {
+                transient_arena = new amrex::CArena(0, amrex::ArenaInfo().SetDeviceMemory());
+                // the arena must release its memory before the device is finalized
+                amrex::ExecOnFinalize([] () {
+                    delete transient_arena;
+                    transient_arena = nullptr;
+                    initialized = false;
+                });
+            }
+        }
+        return (transient_arena) ? transient_arena : amrex::The_Arena();
+    }
+
+    void ReserveArenaMemory ()
+    {
+        amrex::Real reserve_factor = 1._rt;
+        amrex::ParmParse pp_warpx("warpx");
+        queryWithParser(pp_warpx, "arena_reserve_factor", reserve_factor);
+        if (reserve_factor <= 1._rt) return;
+
+        const amrex::Long in_use = ArenaBytesInUse();
+        const amrex::Long reserved = ArenaBytesReserved();
+        const auto target = static_cast<amrex::Long>(reserve_factor * static_cast<amrex::Real>(in_use));
+        // A block allocated and freed stays in the free list of the arena
+        if (target > reserved)
+        {
+            void* p = amrex::The_Arena()->alloc(static_cast<std::size_t>(target - in_use));
+            amrex::The_Arena()->free(p);
+        }
+        amrex::Print() << "Arena: " << ArenaBytesReserved() << " bytes reserved for "
+                       << in_use << " bytes in use (on the I/O rank)\n";
+    }
+}
+
 namespace WarpXUtilStr
 {
     bool is_in(const std::vector<std::string>& vect,
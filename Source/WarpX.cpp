@@ -22,17 +22,22 @@
 #   ifdef WARPX_DIM_RZ
 #       include "FieldSolver/SpectralSolver/SpectralSolverRZ.H"
 #   else
+#       include "FieldSolver/SpectralSolver/FFTPoissonSolver.H"
 #       include "FieldSolver/SpectralSolver/SpectralSolver.H"
 #   endif // RZ ifdef
 #endif // use PSATD ifdef
 #include "FieldSolver/WarpX_FDTD.H"
 #include "Filter/NCIGodfreyFilter.H"
+#include "Parallelization/WarpXCommUtil.H"
+#include "Particles/Deposition/DepositionUtils.H"
 #include "Particles/MultiParticleContainer.H"
 #include "Particles/ParticleBoundaryBuffer.H"
+#include "Particles/ParticleOffload.H"
 #include "Utils/MsgLogger/MsgLogger.H"
 #include "Utils/WarnManager.H"
 #include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXConst.H"
+#include "Utils/WarpXGpuRegions.H"
 #include "Utils/WarpXProfilerWrapper.H"
 #include "Utils/WarpXUtil.H"
 
@@ -98,8 +103,13 @@ int WarpX::start_moving_window_step = 0;
 int WarpX::end_moving_window_step = -1;
 int WarpX::moving_window_dir = -1;
 Real WarpX::moving_window_v = std::numeric_limits<amrex::Real>::max();
+bool WarpX::moving_window_shift_in_place = false;
 
 bool WarpX::fft_do_time_averaging = false;
+bool WarpX::fft_batch_transforms = false;
+bool WarpX::fft_single_precision = false;
+bool WarpX::fft_overlap_comms = false;
+bool WarpX::psatd_on_the_fly_coefficients = false;
 
 amrex::IntVect WarpX::fill_guards = amrex::IntVect(0);
 
@@ -120,7 +130,12 @@ bool WarpX::do_dive_cleaning = 0;
 bool WarpX::do_divb_cleaning = 0;
 int WarpX::em_solver_medium;
 int WarpX::macroscopic_solver_algo;
+bool WarpX::fdtd_temporal_blocking = false;
 int WarpX::do_single_precision_comms=0;
+int WarpX::comm_precision_E = CommPrecision::Default;
+int WarpX::comm_precision_B = CommPrecision::Default;
+int WarpX::comm_precision_F = CommPrecision::Default;
+bool WarpX::comm_precision_diagnostics = false;
 amrex::Vector<int> WarpX::field_boundary_lo(AMREX_SPACEDIM,0);
 amrex::Vector<int> WarpX::field_boundary_hi(AMREX_SPACEDIM,0);
 amrex::Vector<ParticleBoundaryType> WarpX::particle_boundary_lo(AMREX_SPACEDIM,ParticleBoundaryType::Absorbing);
@@ -147,11 +162,13 @@ int WarpX::current_centering_noy = 2;
 int WarpX::current_centering_noz = 2;
 
 bool WarpX::use_fdtd_nci_corr = false;
+bool WarpX::nci_corr_in_gather = false;
 bool WarpX::galerkin_interpolation = true;
 
 bool WarpX::use_filter = true;
 bool WarpX::use_kspace_filter       = true;
 bool WarpX::use_filter_compensation = false;
+bool WarpX::use_spectral_filter = false;
 
 bool WarpX::serialize_ics     = false;
 bool WarpX::refine_plasma     = false;
@@ -160,6 +177,19 @@ int WarpX::num_mirrors = 0;
 
 IntervalsParser WarpX::sort_intervals;
 amrex::IntVect WarpX::sort_bin_size(AMREX_D_DECL(1,1,1));
+bool WarpX::do_adaptive_sort = false;
+bool WarpX::do_sorted_deposition = false;
+bool WarpX::do_fused_push_deposit = false;
+bool WarpX::overlap_fillboundary_push = false;
+bool WarpX::do_cache_shape_factors = false;
+bool WarpX::do_batched_deposition = false;
+bool WarpX::do_incremental_sort = false;
+amrex::Real WarpX::incremental_sort_max_fraction = 0.1_rt;
+#if (AMREX_SPACEDIM == 3)
+amrex::IntVect WarpX::shared_tilesize(AMREX_D_DECL(4,4,4));
+#else
+amrex::IntVect WarpX::shared_tilesize(AMREX_D_DECL(8,8,8));
+#endif
 
 bool WarpX::do_back_transformed_diagnostics = false;
 std::string WarpX::lab_data_directory = "lab_frame_data";
@@ -175,10 +205,13 @@ Real WarpX::particle_slice_width_lab = 0.0_rt;
 bool WarpX::do_dynamic_scheduling = true;
 
 int WarpX::do_electrostatic;
+int WarpX::poisson_solver_id = PoissonSolverAlgo::Multigrid;
 Real WarpX::self_fields_required_precision = 1.e-11_rt;
 Real WarpX::self_fields_absolute_tolerance = 0.0_rt;
 int WarpX::self_fields_max_iters = 200;
 int WarpX::self_fields_verbosity = 2;
+bool WarpX::self_fields_warm_start = false;
+Real WarpX::self_fields_beta_tolerance = -1._rt;
 
 int WarpX::do_subcycling = 0;
 int WarpX::do_multi_J = 0;
@@ -192,6 +225,7 @@ int WarpX::n_field_gather_buffer = -1;
 int WarpX::n_current_deposition_buffer = -1;
 
 int WarpX::do_nodal = false;
+bool WarpX::do_on_the_fly_nodal_gather = false;
 
 #ifdef AMREX_USE_GPU
 int WarpX::do_device_synchronize = 1;
@@ -199,6 +233,8 @@ int WarpX::do_device_synchronize = 1;
 int WarpX::do_device_synchronize = 0;
 #endif
 
+bool WarpX::use_gpu_graphs = false;
+
 WarpX* WarpX::m_instance = nullptr;
 
 WarpX&
@@ -265,6 +301,9 @@ WarpX::WarpX ()
     // Particle Boundary Buffer (i.e., scraped particles on boundary)
     m_particle_boundary_buffer = std::make_unique<ParticleBoundaryBuffer>();
 
+    // Out-of-core storage of the inactive particles
+    m_particle_offload = std::make_unique<ParticleOffload>();
+
     // Diagnostics
     multi_diags = std::make_unique<MultiDiagnostics>();
 
@@ -278,6 +317,7 @@ WarpX::WarpX ()
     G_fp.resize(nlevs_max);
     rho_fp.resize(nlevs_max);
     phi_fp.resize(nlevs_max);
+    phi_fp_prev.resize(nlevs_max);
     current_fp.resize(nlevs_max);
     Efield_fp.resize(nlevs_max);
     Bfield_fp.resize(nlevs_max);
@@ -286,7 +326,10 @@ WarpX::WarpX ()
 
     m_edge_lengths.resize(nlevs_max);
     m_face_areas.resize(nlevs_max);
+    m_edge_tile_classes.resize(nlevs_max);
+    m_face_tile_classes.resize(nlevs_max);
     m_distance_to_eb.resize(nlevs_max);
+    m_distance_to_eb_min.resize(nlevs_max);
     m_flag_info_face.resize(nlevs_max);
     m_flag_ext_face.resize(nlevs_max);
     m_borrowing.resize(nlevs_max);
@@ -296,6 +339,10 @@ WarpX::WarpX ()
     Venl.resize(nlevs_max);
 
     current_store.resize(nlevs_max);
+    current_filtered_fp.resize(nlevs_max);
+    current_filtered_cp.resize(nlevs_max);
+    Efield_aux_tmp.resize(nlevs_max);
+    Bfield_aux_tmp.resize(nlevs_max);
 
     if (do_current_centering)
     {
@@ -320,6 +367,10 @@ WarpX::WarpX ()
 
     pml.resize(nlevs_max);
     costs.resize(nlevs_max);
+    m_costs_breakdown.resize(nlevs_max);
+    m_costs_history_ba.resize(nlevs_max);
+    m_costs_history_level.resize(nlevs_max);
+    m_costs_history_trend.resize(nlevs_max);
     load_balance_efficiency.resize(nlevs_max);
 
     m_field_factory.resize(nlevs_max);
@@ -376,6 +427,15 @@ WarpX::WarpX ()
 #endif // AMREX_USE_GPU
     }
 
+    // Calibration of the weights of the heuristic costs: the costs are first measured
+    // with the timers (see CalibrateCostsHeuristic)
+    if (costs_heuristic_calibration_steps > 0
+        && WarpX::load_balance_costs_update_algo==LoadBalanceCostsUpdateAlgo::Heuristic)
+    {
+        m_costs_heuristic_calibrating = true;
+        WarpX::load_balance_costs_update_algo = LoadBalanceCostsUpdateAlgo::Timers;
+    }
+
     // Allocate field solver objects
 #ifdef WARPX_USE_PSATD
     if (WarpX::maxwell_solver_id == MaxwellSolverAlgo::PSATD) {
@@ -401,7 +461,8 @@ WarpX::WarpX ()
         AMREX_ALWAYS_ASSERT(do_subcycling == 0);
     }
 
-    if (WarpX::current_deposition_algo != CurrentDepositionAlgo::Esirkepov) {
+    if (WarpX::current_deposition_algo != CurrentDepositionAlgo::Esirkepov &&
+        WarpX::current_deposition_algo != CurrentDepositionAlgo::EsirkepovShared) {
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
             use_fdtd_nci_corr == 0,
             "The NCI corrector should only be used with Esirkepov deposition");
@@ -475,6 +536,7 @@ WarpX::ReadParameters ()
         ParmParse pp_amr("amr");
 
         pp_amr.query("restart", restart_chkfile);
+        pp_amr.query("restart_local_dir", restart_local_dir);
     }
 
     {
@@ -539,12 +601,19 @@ WarpX::ReadParameters ()
         pp_warpx.queryarr("override_sync_intervals", override_sync_intervals_string_vec);
         override_sync_intervals = IntervalsParser(override_sync_intervals_string_vec);
 
-        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(do_subcycling != 1 || max_level <= 1,
-                                         "Subcycling method 1 only works for 2 levels.");
-
         ReadBoostedFrameParameters(gamma_boost, beta_boost, boost_direction);
 
         pp_warpx.query("do_device_synchronize", do_device_synchronize);
+        pp_warpx.query("do_gpu_ranges", WarpXGpuRegions::ranges_level);
+        pp_warpx.query("do_gpu_timers", WarpXGpuRegions::timers_level);
+
+        pp_warpx.query("use_gpu_graphs", use_gpu_graphs);
+        if (use_gpu_graphs && !GpuGraphs::Available()) {
+            this->RecordWarning("Performance",
+                "warpx.use_gpu_graphs requires a CUDA or HIP build with "
+                "amrex.max_gpu_streams=1, and is ignored.");
+            use_gpu_graphs = false;
+        }
 
         // queryWithParser returns 1 if argument zmax_plasma_to_compute_max_step is
         // specified by the user, 0 otherwise.
@@ -582,6 +651,8 @@ WarpX::ReadParameters ()
 
             getWithParser(pp_warpx, "moving_window_v", moving_window_v);
             moving_window_v *= PhysConst::c;
+
+            pp_warpx.query("moving_window_shift_in_place", moving_window_shift_in_place);
         }
 
         pp_warpx.query("do_back_transformed_diagnostics", do_back_transformed_diagnostics);
@@ -632,6 +703,19 @@ WarpX::ReadParameters ()
             queryWithParser(pp_warpx, "self_fields_absolute_tolerance", self_fields_absolute_tolerance);
             queryWithParser(pp_warpx, "self_fields_max_iters", self_fields_max_iters);
             pp_warpx.query("self_fields_verbosity", self_fields_verbosity);
+            pp_warpx.query("self_fields_warm_start", self_fields_warm_start);
+        }
+        queryWithParser(pp_warpx, "self_fields_beta_tolerance", self_fields_beta_tolerance);
+        if (do_electrostatic != ElectrostaticSolverAlgo::None) {
+            poisson_solver_id = GetAlgorithmInteger(pp_warpx, "poisson_solver");
+        }
+        if (poisson_solver_id == PoissonSolverAlgo::FFT) {
+#if !defined(WARPX_USE_PSATD) || defined(WARPX_DIM_RZ) || defined(AMREX_USE_EB)
+            amrex::Abort("warpx.poisson_solver = fft requires a Cartesian build with PSATD "
+                         "(for the FFT library) and without embedded boundaries");
+#endif
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(max_level == 0,
+                "warpx.poisson_solver = fft is not implemented with mesh refinement");
         }
         // Parse the input file for domain boundary potentials
         ParmParse pp_boundary("boundary");
@@ -646,6 +730,22 @@ WarpX::ReadParameters ()
 
         queryWithParser(pp_warpx, "const_dt", const_dt);
 
+        pp_warpx.query("adaptive_dt", adaptive_dt);
+        if (adaptive_dt) {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(do_electrostatic == ElectrostaticSolverAlgo::LabFrame,
+                "warpx.adaptive_dt requires warpx.do_electrostatic = labframe");
+            queryWithParser(pp_warpx, "adaptive_dt_interval", adaptive_dt_interval);
+            queryWithParser(pp_warpx, "adaptive_dt_cfl", adaptive_dt_cfl);
+            queryWithParser(pp_warpx, "adaptive_dt_omega_p", adaptive_dt_omega_p);
+            queryWithParser(pp_warpx, "adaptive_dt_min", adaptive_dt_min);
+            queryWithParser(pp_warpx, "adaptive_dt_max", adaptive_dt_max);
+            queryWithParser(pp_warpx, "adaptive_dt_max_growth", adaptive_dt_max_growth);
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(adaptive_dt_interval > 0 && adaptive_dt_max_growth >= 1.,
+                "warpx.adaptive_dt_interval must be positive and warpx.adaptive_dt_max_growth at least 1");
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(adaptive_dt_min <= adaptive_dt_max,
+                "warpx.adaptive_dt_min must not be larger than warpx.adaptive_dt_max");
+        }
+
         // Filter currently not working with FDTD solver in RZ geometry: turn OFF by default
         // (see https://github.com/ECP-WarpX/WarpX/issues/1943)
 #ifdef WARPX_DIM_RZ
@@ -656,6 +756,11 @@ WarpX::ReadParameters ()
         // proper size for AMREX_SPACEDIM
         pp_warpx.query("use_filter", use_filter);
         pp_warpx.query("use_filter_compensation", use_filter_compensation);
+        pp_warpx.query("use_spectral_filter", use_spectral_filter);
+#ifndef WARPX_USE_PSATD
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!use_spectral_filter,
+            "warpx.use_spectral_filter = 1 requires to compile WarpX with PSATD support (FFT library)");
+#endif
         Vector<int> parse_filter_npass_each_dir(AMREX_SPACEDIM,1);
         queryArrWithParser(pp_warpx, "filter_npass_each_dir", parse_filter_npass_each_dir, 0, AMREX_SPACEDIM);
         filter_npass_each_dir[0] = parse_filter_npass_each_dir[0];
@@ -703,6 +808,10 @@ WarpX::ReadParameters ()
                                " to be 0, since WarpX was built in single precision.");
         }
 #endif
+        comm_precision_E = GetAlgorithmInteger(pp_warpx, "comm_precision_E");
+        comm_precision_B = GetAlgorithmInteger(pp_warpx, "comm_precision_B");
+        comm_precision_F = GetAlgorithmInteger(pp_warpx, "comm_precision_F");
+        pp_warpx.query("comm_precision_diagnostics", comm_precision_diagnostics);
 
         pp_warpx.query("serialize_ics", serialize_ics);
         pp_warpx.query("refine_plasma", refine_plasma);
@@ -742,6 +851,10 @@ WarpX::ReadParameters ()
         pp_warpx.query("pml_has_particles", pml_has_particles);
         pp_warpx.query("do_pml_j_damping", do_pml_j_damping);
         pp_warpx.query("do_pml_in_domain", do_pml_in_domain);
+        pp_warpx.query("do_pml_fused_damping", do_pml_fused_damping);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!do_pml_fused_damping ||
+            (maxwell_solver_id != MaxwellSolverAlgo::PSATD && do_subcycling == 0),
+            "warpx.do_pml_fused_damping = 1 is only implemented for FDTD solvers, without subcycling");
 
         if (do_multi_J && isAnyBoundaryPML())
         {
@@ -908,6 +1021,15 @@ WarpX::ReadParameters ()
         if (field_gathering_algo == GatheringAlgo::MomentumConserving) {
             // Use same shape factors in all directions, for gathering
             galerkin_interpolation = false;
+
+            ParmParse pp_warpx("warpx");
+            pp_warpx.query("do_on_the_fly_nodal_gather", do_on_the_fly_nodal_gather);
+            // The fields are already nodal with warpx.do_nodal = 1
+            if (do_nodal) do_on_the_fly_nodal_gather = false;
+            if (do_on_the_fly_nodal_gather) {
+                AMREX_ALWAYS_ASSERT_WITH_MESSAGE(maxLevel() == 0,
+                    "warpx.do_on_the_fly_nodal_gather = 1 is not implemented with mesh refinement");
+            }
         }
 
         em_solver_medium = GetAlgorithmInteger(pp_algo, "em_solver_medium");
@@ -915,6 +1037,28 @@ WarpX::ReadParameters ()
             macroscopic_solver_algo = GetAlgorithmInteger(pp_algo,"macroscopic_sigma_method");
         }
 
+        pp_algo.query("fdtd_temporal_blocking", fdtd_temporal_blocking);
+        if (fdtd_temporal_blocking) {
+#if defined(WARPX_DIM_RZ) || defined(AMREX_USE_EB)
+            amrex::Abort("algo.fdtd_temporal_blocking is not implemented in RZ geometry"
+                         " nor with embedded boundaries");
+#endif
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                (maxwell_solver_id == MaxwellSolverAlgo::Yee ||
+                 maxwell_solver_id == MaxwellSolverAlgo::CKC) && !do_nodal,
+                "algo.fdtd_temporal_blocking requires the Yee or CKC solver on a staggered grid");
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                em_solver_medium == MediumForEM::Vacuum && !do_dive_cleaning && !do_divb_cleaning,
+                "algo.fdtd_temporal_blocking is not implemented with a macroscopic medium"
+                " nor with divergence cleaning");
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                maxLevel() == 0 && do_subcycling == 0,
+                "algo.fdtd_temporal_blocking is not implemented with mesh refinement");
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                Geom(0).isAllPeriodic(),
+                "algo.fdtd_temporal_blocking requires periodic field boundaries in all directions");
+        }
+
         // Load balancing parameters
         std::vector<std::string> load_balance_intervals_string_vec = {"0"};
         pp_algo.queryarr("load_balance_intervals", load_balance_intervals_string_vec);
@@ -924,8 +1068,51 @@ WarpX::ReadParameters ()
         queryWithParser(pp_algo, "load_balance_efficiency_ratio_threshold",
                         load_balance_efficiency_ratio_threshold);
         load_balance_costs_update_algo = GetAlgorithmInteger(pp_algo, "load_balance_costs_update");
+        queryWithParser(pp_algo, "load_balance_migration_cost_per_byte",
+                        load_balance_migration_cost_per_byte);
+        pp_algo.query("load_balance_minimize_moves", load_balance_minimize_moves);
+        pp_algo.query("load_balance_topology_aware", load_balance_topology_aware);
+        pp_algo.query("load_balance_initial_costs", load_balance_initial_costs);
+        if (load_balance_initial_costs) {
+            pp_algo.query("load_balance_initial_costs_sampling", load_balance_initial_costs_sampling);
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(load_balance_initial_costs_sampling > 0,
+                "algo.load_balance_initial_costs_sampling must be positive");
+        }
+        pp_algo.query("load_balance_multilevel", load_balance_multilevel);
+        if (load_balance_multilevel) {
+            queryWithParser(pp_algo, "load_balance_multilevel_tolerance",
+                            load_balance_multilevel_tolerance);
+        }
+        pp_algo.query("load_balance_rechop", load_balance_rechop);
+        if (load_balance_rechop) {
+            queryWithParser(pp_algo, "load_balance_rechop_split_threshold",
+                            load_balance_rechop_split_threshold);
+            queryWithParser(pp_algo, "load_balance_rechop_merge_threshold",
+                            load_balance_rechop_merge_threshold);
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(maxLevel() == 0,
+                "algo.load_balance_rechop is not implemented with mesh refinement");
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(em_solver_medium == MediumForEM::Vacuum,
+                "algo.load_balance_rechop is not implemented with a macroscopic medium");
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                load_balance_rechop_merge_threshold < load_balance_rechop_split_threshold,
+                "algo.load_balance_rechop_merge_threshold must be lower than"
+                " algo.load_balance_rechop_split_threshold");
+        }
+        load_balance_costs_prediction = GetAlgorithmInteger(pp_algo, "load_balance_costs_prediction");
+        if (load_balance_costs_prediction != LoadBalanceCostsPrediction::None) {
+            queryWithParser(pp_algo, "load_balance_costs_smoothing", load_balance_costs_smoothing);
+            queryWithParser(pp_algo, "load_balance_costs_trend_smoothing",
+                            load_balance_costs_trend_smoothing);
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                load_balance_costs_smoothing > 0._rt && load_balance_costs_smoothing <= 1._rt &&
+                load_balance_costs_trend_smoothing > 0._rt && load_balance_costs_trend_smoothing <= 1._rt,
+                "algo.load_balance_costs_smoothing and algo.load_balance_costs_trend_smoothing"
+                " must be in (0,1]");
+        }
         queryWithParser(pp_algo, "costs_heuristic_cells_wt", costs_heuristic_cells_wt);
         queryWithParser(pp_algo, "costs_heuristic_particles_wt", costs_heuristic_particles_wt);
+        queryWithParser(pp_algo, "costs_heuristic_calibration_steps", costs_heuristic_calibration_steps);
+        pp_algo.query("costs_breakdown", costs_breakdown);
 
         // Parse algo.particle_shape and check that input is acceptable
         // (do this only if there is at least one particle or laser species)
@@ -978,6 +1165,11 @@ WarpX::ReadParameters ()
         amrex::ParmParse pp_warpx("warpx");
         pp_warpx.queryarr("sort_intervals", sort_intervals_string_vec);
         sort_intervals = IntervalsParser(sort_intervals_string_vec);
+        pp_warpx.query("do_adaptive_sort", do_adaptive_sort);
+        pp_warpx.query("autotune_tile_size", autotune_tile_size);
+        pp_warpx.query("autotune_tile_size_steps", autotune_tile_size_steps);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(autotune_tile_size_steps > 0,
+            "warpx.autotune_tile_size_steps must be positive");
 
         Vector<int> vect_sort_bin_size(AMREX_SPACEDIM,1);
         bool sort_bin_size_is_specified = queryArrWithParser(pp_warpx, "sort_bin_size",
@@ -986,6 +1178,34 @@ WarpX::ReadParameters ()
             for (int i=0; i<AMREX_SPACEDIM; i++)
                 sort_bin_size[i] = vect_sort_bin_size[i];
         }
+
+        Vector<int> vect_shared_tilesize(AMREX_SPACEDIM,1);
+        bool shared_tilesize_is_specified = queryArrWithParser(pp_warpx, "shared_tilesize",
+                                                            vect_shared_tilesize, 0, AMREX_SPACEDIM);
+        if (shared_tilesize_is_specified){
+            for (int i=0; i<AMREX_SPACEDIM; i++)
+                shared_tilesize[i] = vect_shared_tilesize[i];
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(shared_tilesize.allGT(0),
+                "warpx.shared_tilesize must be strictly positive");
+        }
+
+        pp_warpx.query("do_sorted_deposition", do_sorted_deposition);
+        if (do_sorted_deposition) {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(sortedDepositionFits(sort_bin_size, nox),
+                "warpx.do_sorted_deposition = 1: warpx.sort_bin_size is too large for the "
+                "local buffers of the sorted deposition, please reduce it");
+        }
+
+        pp_warpx.query("do_fused_push_deposit", do_fused_push_deposit);
+        pp_warpx.query("do_cache_shape_factors", do_cache_shape_factors);
+        pp_warpx.query("do_batched_deposition", do_batched_deposition);
+        pp_warpx.query("overlap_fillboundary_push", overlap_fillboundary_push);
+
+        pp_warpx.query("do_incremental_sort", do_incremental_sort);
+        queryWithParser(pp_warpx, "incremental_sort_max_fraction", incremental_sort_max_fraction);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+            incremental_sort_max_fraction >= 0._rt && incremental_sort_max_fraction <= 1._rt,
+            "warpx.incremental_sort_max_fraction must be between 0 and 1");
     }
 
     {
@@ -1046,6 +1266,14 @@ WarpX::ReadParameters ()
     {
         ParmParse pp_psatd("psatd");
         pp_psatd.query("periodic_single_box_fft", fft_periodic_single_box);
+        pp_psatd.query("distributed_fft", fft_distributed);
+#ifdef WARPX_DIM_RZ
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!fft_distributed,
+            "psatd.distributed_fft is not implemented in RZ geometry");
+#endif
+        // The distributed FFTs are global FFTs over the periodic domain, as with
+        // psatd.periodic_single_box_fft, but without the restriction to one single box
+        if (fft_distributed) fft_periodic_single_box = true;
 
         std::string nox_str;
         std::string noy_str;
@@ -1078,8 +1306,35 @@ WarpX::ReadParameters ()
             AMREX_ALWAYS_ASSERT_WITH_MESSAGE(noz_fft > 0, "PSATD order must be finite unless psatd.periodic_single_box_fft is used");
         }
 
+        // Orders of the PSATD solver in the PML
+        pml_nox_fft = nox_fft;
+        pml_noy_fft = noy_fft;
+        pml_noz_fft = noz_fft;
+        queryWithParser(pp_psatd, "pml_nox", pml_nox_fft);
+        queryWithParser(pp_psatd, "pml_noy", pml_noy_fft);
+        queryWithParser(pp_psatd, "pml_noz", pml_noz_fft);
+        if (!fft_periodic_single_box) {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                pml_nox_fft > 0 && pml_noy_fft > 0 && pml_noz_fft > 0,
+                "psatd.pml_nox, psatd.pml_noy and psatd.pml_noz must be finite");
+        }
+
         pp_psatd.query("current_correction", current_correction);
         pp_psatd.query("do_time_averaging", fft_do_time_averaging);
+        pp_psatd.query("batch_transforms", fft_batch_transforms);
+        pp_psatd.query("single_precision_fft", fft_single_precision);
+        pp_psatd.query("overlap_comms", fft_overlap_comms);
+#if !defined(AMREX_USE_CUDA) && !defined(AMREX_USE_HIP)
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!fft_single_precision,
+            "psatd.single_precision_fft is only implemented with cuFFT and rocFFT");
+#endif
+#ifdef WARPX_DIM_RZ
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!fft_single_precision,
+            "psatd.single_precision_fft is not implemented in RZ geometry");
+#endif
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!(fft_single_precision && fft_distributed),
+            "psatd.single_precision_fft cannot be used with psatd.distributed_fft");
+        pp_psatd.query("on_the_fly_coefficients", psatd_on_the_fly_coefficients);
         pp_psatd.query("J_linear_in_time", J_linear_in_time);
 
         if (!fft_periodic_single_box && current_correction)
@@ -1126,7 +1381,8 @@ WarpX::ReadParameters ()
         for (int i=0; i<3; i++) m_v_comoving[i] *= PhysConst::c;
 
         // The comoving PSATD algorithm is not implemented nor tested with Esirkepov current deposition
-        if (current_deposition_algo == CurrentDepositionAlgo::Esirkepov) {
+        if (current_deposition_algo == CurrentDepositionAlgo::Esirkepov ||
+            current_deposition_algo == CurrentDepositionAlgo::EsirkepovShared) {
             if (m_v_comoving[0] != 0. || m_v_comoving[1] != 0. || m_v_comoving[2] != 0.) {
                 amrex::Abort("Esirkepov current deposition cannot be used with the comoving PSATD algorithm");
             }
@@ -1364,13 +1620,22 @@ void
 WarpX::MakeNewLevelFromScratch (int lev, Real time, const BoxArray& new_grids,
                                 const DistributionMapping& new_dmap)
 {
-    AllocLevelData(lev, new_grids, new_dmap);
+    // The particles do not exist yet: the mapping is weighted by their estimated number
+    if (load_balance_initial_costs) {
+        const DistributionMapping dmap = MakeInitialDistributionMap(lev, new_grids);
+        SetDistributionMap(lev, dmap);
+        AllocLevelData(lev, new_grids, dmap);
+    } else {
+        AllocLevelData(lev, new_grids, new_dmap);
+    }
     InitLevelData(lev, time);
 }
 
 void
 WarpX::ClearLevel (int lev)
 {
+    WarpXCommUtil::ClearCommBuffers();
+
     for (int i = 0; i < 3; ++i) {
         Efield_aux[lev][i].reset();
         Bfield_aux[lev][i].reset();
@@ -1380,6 +1645,10 @@ WarpX::ClearLevel (int lev)
         Bfield_fp [lev][i].reset();
 
         current_store[lev][i].reset();
+        current_filtered_fp[lev][i].reset();
+        current_filtered_cp[lev][i].reset();
+        Efield_aux_tmp[lev][i].reset();
+        Bfield_aux_tmp[lev][i].reset();
 
         if (do_current_centering)
         {
@@ -1404,6 +1673,7 @@ WarpX::ClearLevel (int lev)
     G_fp  [lev].reset();
     rho_fp[lev].reset();
     phi_fp[lev].reset();
+    phi_fp_prev[lev].reset();
     F_cp  [lev].reset();
     G_cp  [lev].reset();
     rho_cp[lev].reset();
@@ -1416,9 +1686,87 @@ WarpX::ClearLevel (int lev)
 #endif
 
     costs[lev].reset();
+    m_costs_breakdown[lev].clear();
     load_balance_efficiency[lev] = -1;
 }
 
+std::vector<std::pair<std::string, amrex::Long> >
+WarpX::FieldMemoryUsage () const
+{
+    using VectorField = amrex::Vector<std::array<std::unique_ptr<amrex::MultiFab>, 3> >;
+    using ScalarField = amrex::Vector<std::unique_ptr<amrex::MultiFab> >;
+
+    std::vector<std::pair<std::string, amrex::Long> > usage;
+    const auto add_vector = [&] (const std::string& name, const VectorField& field) {
+        amrex::Long bytes = 0;
+        for (const auto& f : field) {
+            for (const auto& mf : f) bytes += WarpXUtilMem::MultiFabBytes(mf.get());
+        }
+        usage.emplace_back(name, bytes);
+    };
+    const auto add_scalar = [&] (const std::string& name, const ScalarField& field) {
+        amrex::Long bytes = 0;
+        for (const auto& mf : field) bytes += WarpXUtilMem::MultiFabBytes(mf.get());
+        usage.emplace_back(name, bytes);
+    };
+
+    add_vector("Efield_fp", Efield_fp);
+    add_vector("Bfield_fp", Bfield_fp);
+    add_vector("current_fp", current_fp);
+    add_scalar("rho_fp", rho_fp);
+    add_scalar("F_fp", F_fp);
+    add_scalar("G_fp", G_fp);
+    add_scalar("phi_fp", phi_fp);
+    add_scalar("phi_fp_prev", phi_fp_prev);
+    add_vector("Efield_avg_fp", Efield_avg_fp);
+    add_vector("Bfield_avg_fp", Bfield_avg_fp);
+    add_vector("Efield_aux", Efield_aux);
+    add_vector("Bfield_aux", Bfield_aux);
+    add_vector("current_store", current_store);
+    add_vector("current_fp_nodal", current_fp_nodal);
+    add_vector("current_filtered_fp", current_filtered_fp);
+    add_vector("current_filtered_cp", current_filtered_cp);
+    add_vector("Efield_cp", Efield_cp);
+    add_vector("Bfield_cp", Bfield_cp);
+    add_vector("current_cp", current_cp);
+    add_scalar("rho_cp", rho_cp);
+    add_scalar("F_cp", F_cp);
+    add_scalar("G_cp", G_cp);
+    add_vector("Efield_avg_cp", Efield_avg_cp);
+    add_vector("Bfield_avg_cp", Bfield_avg_cp);
+    add_vector("Efield_cax", Efield_cax);
+    add_vector("Bfield_cax", Bfield_cax);
+    add_vector("current_buf", current_buf);
+    add_scalar("charge_buf", charge_buf);
+    add_vector("Venl", Venl);
+    add_vector("edge_lengths", m_edge_lengths);
+    add_vector("face_areas", m_face_areas);
+    add_vector("area_mod", m_area_mod);
+    add_vector("ECTRhofield", ECTRhofield);
+    add_scalar("distance_to_eb", m_distance_to_eb);
+
+    amrex::Long pml_bytes = 0;
+    for (const auto& p : pml) {
+        if (p) pml_bytes += p->BytesAllocated();
+    }
+    usage.emplace_back("pml", pml_bytes);
+
+    amrex::Long spectral_bytes = 0;
+#ifdef WARPX_USE_PSATD
+    if (WarpX::maxwell_solver_id == MaxwellSolverAlgo::PSATD) {
+        for (const auto& ss : spectral_solver_fp) {
+            if (ss) spectral_bytes += ss->BytesAllocated();
+        }
+        for (const auto& ss : spectral_solver_cp) {
+            if (ss) spectral_bytes += ss->BytesAllocated();
+        }
+    }
+#endif
+    usage.emplace_back("spectral", spectral_bytes);
+
+    return usage;
+}
+
 void
 WarpX::AllocLevelData (int lev, const BoxArray& ba, const DistributionMapping& dm)
 {
@@ -1454,9 +1802,11 @@ WarpX::AllocLevelData (int lev, const BoxArray& ba, const DistributionMapping& d
         WarpX::m_v_galilean,
         WarpX::m_v_comoving,
         safe_guard_cells,
+        fdtd_temporal_blocking,
         WarpX::do_electrostatic,
         WarpX::do_multi_J,
         WarpX::fft_do_time_averaging,
+        fft_distributed,
         this->refRatio());
 
     if (mypc->nSpeciesDepositOnMainGrid() && n_current_deposition_buffer == 0) {
@@ -1670,7 +2020,7 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
         phi_fp[lev]->setVal(0.);
     }
 
-    if (do_subcycling == 1 && lev == 0)
+    if (do_subcycling == 1 && lev < maxLevel())
     {
         current_store[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,jx_nodal_flag),dm,ncomps,ngJ,tag("current_store[x]"));
         current_store[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,jy_nodal_flag),dm,ncomps,ngJ,tag("current_store[y]"));
@@ -1703,10 +2053,16 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
                 && ba.size() == 1 && lev == 0, // domain is decomposed in a single box
                 "The option `psatd.periodic_single_box_fft` can only be used for a periodic domain, decomposed in a single box");
 #   else
-            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
-                geom[0].isAllPeriodic()        // domain is periodic in all directions
-                && ba.size() == 1 && lev == 0, // domain is decomposed in a single box
-                "The option `psatd.periodic_single_box_fft` can only be used for a periodic domain, decomposed in a single box");
+            if (fft_distributed) {
+                AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                    geom[0].isAllPeriodic() && lev == 0, // domain is periodic in all directions
+                    "The option `psatd.distributed_fft` can only be used for a periodic domain, without mesh refinement");
+            } else {
+                AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                    geom[0].isAllPeriodic()        // domain is periodic in all directions
+                    && ba.size() == 1 && lev == 0, // domain is decomposed in a single box
+                    "The option `psatd.periodic_single_box_fft` can only be used for a periodic domain, decomposed in a single box");
+            }
 #   endif
         }
         // Get the cell-centered box
@@ -1743,7 +2099,7 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
     //
     // The Aux patch (i.e., the full solution)
     //
-    if (aux_is_nodal and !do_nodal)
+    if (aux_is_nodal and !do_nodal and !do_on_the_fly_nodal_gather)
     {
         // Create aux multifabs on Nodal Box Array
         BoxArray const nba = amrex::convert(ba,IntVect::TheNodeVector());
@@ -1910,8 +2266,8 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
                 Efield_cax[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Ez_nodal_flag),dm,ncomps,ngE,tag("Efield_cax[z]"));
             }
 
-            gather_buffer_masks[lev] = std::make_unique<iMultiFab>(ba, dm, ncomps, 1 );
-            // Gather buffer masks have 1 ghost cell, because of the fact
+            gather_buffer_masks[lev] = std::make_unique<BufferMasks>();
+            // Gather buffer masks cover 1 ghost cell, because of the fact
             // that particles may move by more than one cell when using subcycling.
         }
 
@@ -1922,8 +2278,8 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
             if (rho_cp[lev]) {
                 charge_buf[lev] = std::make_unique<MultiFab>(amrex::convert(cba,rho_nodal_flag),dm,2*ncomps,ngRho,tag("charge_buf"));
             }
-            current_buffer_masks[lev] = std::make_unique<iMultiFab>(ba, dm, ncomps, 1);
-            // Current buffer masks have 1 ghost cell, because of the fact
+            current_buffer_masks[lev] = std::make_unique<BufferMasks>();
+            // Current buffer masks cover 1 ghost cell, because of the fact
             // that particles may move by more than one cell when using subcycling.
         }
     }
@@ -1932,6 +2288,13 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
     {
         costs[lev] = std::make_unique<LayoutData<Real>>(ba, dm);
         load_balance_efficiency[lev] = -1;
+        if (costs_breakdown) {
+            m_costs_breakdown[lev].resize(CostsPhase::NPhases*mypc->nSpecies());
+            for (auto& cb : m_costs_breakdown[lev]) {
+                cb = std::make_unique<LayoutData<Real>>(ba, dm);
+                for (int i : cb->IndexArray()) (*cb)[i] = 0.0_rt;
+            }
+        }
     }
 }
 
@@ -2025,6 +2388,7 @@ void WarpX::AllocLevelSpectralSolver (amrex::Vector<std::unique_ptr<SpectralSolv
                                                 solver_dt,
                                                 pml_flag,
                                                 fft_periodic_single_box,
+                                                fft_distributed,
                                                 update_with_rho,
                                                 fft_do_time_averaging,
                                                 J_linear_in_time,
@@ -2230,6 +2594,19 @@ WarpX::getCosts (int lev)
     }
 }
 
+amrex::LayoutData<amrex::Real>*
+WarpX::getCostsBreakdown (int lev, int phase, int species)
+{
+    if (m_instance && !m_instance->m_costs_breakdown[lev].empty())
+    {
+        const int nspecies = m_instance->mypc->nSpecies();
+        return m_instance->m_costs_breakdown[lev][phase*nspecies + species].get();
+    } else
+    {
+        return nullptr;
+    }
+}
+
 void
 WarpX::BuildBufferMasks ()
 {
@@ -2238,82 +2615,13 @@ WarpX::BuildBufferMasks ()
         for (int ipass = 0; ipass < 2; ++ipass)
         {
             int ngbuffer = (ipass == 0) ? n_current_deposition_buffer : n_field_gather_buffer;
-            iMultiFab* bmasks = (ipass == 0) ? current_buffer_masks[lev].get() : gather_buffer_masks[lev].get();
+            BufferMasks* bmasks = (ipass == 0) ? current_buffer_masks[lev].get() : gather_buffer_masks[lev].get();
             if (bmasks)
             {
-                const IntVect ngtmp = ngbuffer + bmasks->nGrowVect();
-                iMultiFab tmp(bmasks->boxArray(), bmasks->DistributionMap(), 1, ngtmp);
-                const int covered = 1;
-                const int notcovered = 0;
-                const int physbnd = 1;
-                const int interior = 1;
-                const Box& dom = Geom(lev).Domain();
-                const auto& period = Geom(lev).periodicity();
-                tmp.BuildMask(dom, period, covered, notcovered, physbnd, interior);
-#ifdef AMREX_USE_OMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-                for (MFIter mfi(*bmasks, true); mfi.isValid(); ++mfi)
-                {
-                    const Box tbx = mfi.growntilebox();
-                    BuildBufferMasksInBox( tbx, (*bmasks)[mfi], tmp[mfi], ngbuffer );
-                }
-            }
-        }
-    }
-}
-
-/**
- * \brief Build buffer mask within given FArrayBox
- *
- * \param tbx         Current FArrayBox
- * \param buffer_mask Buffer mask to be set
- * \param guard_mask  Guard mask used to set buffer_mask
- * \param ng          Number of guard cells
- */
-void
-WarpX::BuildBufferMasksInBox ( const amrex::Box tbx, amrex::IArrayBox &buffer_mask,
-                               const amrex::IArrayBox &guard_mask, const int ng )
-{
-    bool setnull;
-    const auto lo = amrex::lbound( tbx );
-    const auto hi = amrex::ubound( tbx );
-    Array4<int> msk = buffer_mask.array();
-    Array4<int const> gmsk = guard_mask.array();
-#if (AMREX_SPACEDIM == 2)
-    int k = lo.z;
-    for     (int j = lo.y; j <= hi.y; ++j) {
-        for (int i = lo.x; i <= hi.x; ++i) {
-            setnull = false;
-            // If gmsk=0 for any neighbor within ng cells, current cell is in the buffer region
-            for     (int jj = j-ng; jj <= j+ng; ++jj) {
-                for (int ii = i-ng; ii <= i+ng; ++ii) {
-                    if ( gmsk(ii,jj,k) == 0 ) setnull = true;
-                }
+                bmasks->define(boxArray(lev), DistributionMap(lev), Geom(lev), ngbuffer);
             }
-            if ( setnull ) msk(i,j,k) = 0;
-            else           msk(i,j,k) = 1;
         }
     }
-#elif (AMREX_SPACEDIM == 3)
-    for         (int k = lo.z; k <= hi.z; ++k) {
-        for     (int j = lo.y; j <= hi.y; ++j) {
-            for (int i = lo.x; i <= hi.x; ++i) {
-                setnull = false;
-                // If gmsk=0 for any neighbor within ng cells, current cell is in the buffer region
-                for         (int kk = k-ng; kk <= k+ng; ++kk) {
-                    for     (int jj = j-ng; jj <= j+ng; ++jj) {
-                        for (int ii = i-ng; ii <= i+ng; ++ii) {
-                            if ( gmsk(ii,jj,kk) == 0 ) setnull = true;
-                        }
-                    }
-                }
-                if ( setnull ) msk(i,j,k) = 0;
-                else           msk(i,j,k) = 1;
-            }
-        }
-    }
-#endif
 }
 
 #ifdef WARPX_USE_PSATD
@@ -2388,13 +2696,13 @@ void WarpX::AllocateCenteringCoefficients (amrex::Gpu::DeviceVector<amrex::Real>
 }
 #endif
 
-const iMultiFab*
+const BufferMasks*
 WarpX::CurrentBufferMasks (int lev)
 {
     return GetInstance().getCurrentBufferMasks(lev);
 }
 
-const iMultiFab*
+const BufferMasks*
 WarpX::GatherBufferMasks (int lev)
 {
     return GetInstance().getGatherBufferMasks(lev);
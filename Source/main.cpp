@@ -38,7 +38,9 @@ int main(int argc, char* argv[])
 
     auto mpi_thread_levels = utils::warpx_mpi_init(argc, argv);
 
-    warpx_amrex_init(argc, argv);
+    MPI_Comm mpi_comm = utils::warpx_ensemble_split(argc, argv);
+
+    warpx_amrex_init(argc, argv, true, mpi_comm);
 
     utils::warpx_check_mpi_thread_level(mpi_thread_levels);
 
@@ -83,6 +85,7 @@ int main(int argc, char* argv[])
 
     Finalize();
 #if defined(AMREX_USE_MPI)
+    if (mpi_comm != MPI_COMM_WORLD) MPI_Comm_free(&mpi_comm);
     MPI_Finalize();
 #endif
 }
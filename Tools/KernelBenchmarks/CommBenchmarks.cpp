@@ -0,0 +1,301 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+/*
+ * Standalone microbenchmarks of the guard-cell communications of WarpX
+ * (WarpXCommUtil::FillBoundary, SumBoundary, ParallelCopy and OverrideSync, i.e. the
+ * nodal synchronization), for the field layouts used by WarpX and over ranges of
+ * box sizes and numbers of guard cells.
+ *
+ * Usage: mpiexec -n <N> comm_benchmarks [inputs] [bench.<parameter>=<value> ...]
+ * (see the section on communication microbenchmarks in Docs/source/developers/profiling.rst)
+ */
+#include "Parallelization/WarpXCommUtil.H"
+
+#include <AMReX.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_BoxList.H>
+#include <AMReX_DistributionMapping.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_IntVect.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Periodicity.H>
+#include <AMReX_Print.H>
+#include <AMReX_REAL.H>
+#include <AMReX_RealBox.H>
+#include <AMReX_Utility.H>
+#include <AMReX_Vector.H>
+
+#include <array>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace amrex;
+
+namespace
+{
+    /** Parameters of the benchmarks (prefix bench. in the inputs) */
+    struct BenchmarkSetup
+    {
+        IntVect n_cell = IntVect(AMREX_D_DECL(128,128,128));
+        std::vector<int> max_grid_sizes = {32, 64};
+        std::vector<int> ngrows = {1, 2, 4, 8};
+        int pml_ncell = 10;
+        int nrepeat = 10;
+        std::vector<std::string> layouts = {"E", "B", "J", "J_nodal", "pml",
+                                            "fine_patch", "coarse_patch"};
+    };
+
+    BenchmarkSetup ReadSetup ()
+    {
+        BenchmarkSetup setup;
+        ParmParse pp_bench("bench");
+
+        Vector<int> n_cell;
+        if (pp_bench.queryarr("n_cell", n_cell)) {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(n_cell.size() == AMREX_SPACEDIM,
+                "bench.n_cell must have one value per dimension");
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) setup.n_cell[idim] = n_cell[idim];
+        }
+        pp_bench.queryarr("max_grid_size", setup.max_grid_sizes);
+        pp_bench.queryarr("ngrow", setup.ngrows);
+        pp_bench.query("pml_ncell", setup.pml_ncell);
+        pp_bench.query("nrepeat", setup.nrepeat);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(setup.nrepeat > 0, "bench.nrepeat must be positive");
+        pp_bench.queryarr("layouts", setup.layouts);
+        return setup;
+    }
+
+    /** Index types of the components of E and B on the Yee grid */
+    std::array<IntVect,3> StaggeringE ()
+    {
+#if defined(WARPX_DIM_3D)
+        return {IntVect(0,1,1), IntVect(1,0,1), IntVect(1,1,0)};
+#else
+        return {IntVect(0,1), IntVect(1,1), IntVect(1,0)};
+#endif
+    }
+
+    std::array<IntVect,3> StaggeringB ()
+    {
+#if defined(WARPX_DIM_3D)
+        return {IntVect(1,0,0), IntVect(0,1,0), IntVect(0,0,1)};
+#else
+        return {IntVect(1,0), IntVect(0,0), IntVect(0,1)};
+#endif
+    }
+
+    /** Three MultiFabs (one per component of a vector field) with the index types stag */
+    Vector<std::unique_ptr<MultiFab> > MakeVectorField (
+        const BoxArray& ba, const DistributionMapping& dm, const std::array<IntVect,3>& stag,
+        int ncomp, int ngrow)
+    {
+        Vector<std::unique_ptr<MultiFab> > field;
+        for (const IntVect& s : stag) {
+            field.push_back(std::make_unique<MultiFab>(amrex::convert(ba, s), dm, ncomp, ngrow));
+            field.back()->setVal(1._rt);
+        }
+        return field;
+    }
+
+    /** Bytes of the guard cells (the data exchanged, at most) of the MultiFabs of field */
+    double GuardBytes (const Vector<std::unique_ptr<MultiFab> >& field)
+    {
+        double bytes = 0.;
+        for (const auto& mf : field) {
+            const BoxArray& ba = mf->boxArray();
+            for (int i = 0; i < ba.size(); ++i) {
+                const Box& bx = ba[i];
+                bytes += (amrex::grow(bx, mf->nGrowVect()).numPts() - bx.numPts())
+                         * mf->nComp() * sizeof(Real);
+            }
+        }
+        return bytes;
+    }
+
+    /**
+     * \brief Wall time of the operations, averaged over the repetitions irep = 0, ..., nrepeat-1
+     * (the repetition irep = -1 is a warm-up) and maximum over the MPI ranks
+     */
+    class RepeatTimer
+    {
+    public:
+        explicit RepeatTimer (int nrepeat) : m_nrepeat(nrepeat) {}
+
+        /** \brief Call at the beginning of each repetition irep */
+        void start (int irep)
+        {
+            if (irep == 0) {
+                Gpu::synchronize();
+                ParallelDescriptor::Barrier();
+                m_t0 = amrex::second();
+            }
+        }
+
+        /** \brief Average time per repetition, to be called after the last one */
+        Real stop () const
+        {
+            Gpu::synchronize();
+            Real time = static_cast<Real>((amrex::second() - m_t0) / m_nrepeat);
+            ParallelDescriptor::ReduceRealMax(time);
+            return time;
+        }
+
+    private:
+        int m_nrepeat;
+        double m_t0 = 0.;
+    };
+
+    void PrintResult (const std::string& layout, const std::string& op, int max_grid_size,
+                      int ngrow, int nboxes, Real time, double bytes)
+    {
+        amrex::Print() << std::setw(14) << layout << std::setw(14) << op
+                       << std::setw(8) << max_grid_size << std::setw(7) << ngrow
+                       << std::setw(8) << nboxes
+                       << std::setw(14) << std::scientific << std::setprecision(4) << time
+                       << std::setw(12) << std::fixed << std::setprecision(2) << bytes/time*1.e-9
+                       << std::defaultfloat << "\n";
+    }
+
+    /** \brief Time the guard-cell exchange of each component of field */
+    void TimeFillBoundary (const BenchmarkSetup& setup, const std::string& layout,
+                           Vector<std::unique_ptr<MultiFab> >& field, const Periodicity& period,
+                           int max_grid_size, int ngrow)
+    {
+        RepeatTimer timer(setup.nrepeat);
+        for (int irep = -1; irep < setup.nrepeat; ++irep) {
+            timer.start(irep);
+            for (auto& mf : field) WarpXCommUtil::FillBoundary(*mf, mf->nGrowVect(), period);
+        }
+        PrintResult(layout, "FillBoundary", max_grid_size, ngrow, field[0]->boxArray().size(),
+                    timer.stop(), GuardBytes(field));
+    }
+
+    /** \brief Time the sum of the guard cells, and the nodal synchronization, of each component of field */
+    void TimeSumBoundary (const BenchmarkSetup& setup, const std::string& layout,
+                          Vector<std::unique_ptr<MultiFab> >& field, const Periodicity& period,
+                          int max_grid_size, int ngrow)
+    {
+        RepeatTimer sum_timer(setup.nrepeat);
+        for (int irep = -1; irep < setup.nrepeat; ++irep) {
+            sum_timer.start(irep);
+            for (auto& mf : field) {
+                WarpXCommUtil::SumBoundary(*mf, 0, mf->nComp(), mf->nGrowVect(), period);
+            }
+        }
+        PrintResult(layout, "SumBoundary", max_grid_size, ngrow, field[0]->boxArray().size(),
+                    sum_timer.stop(), GuardBytes(field));
+
+        RepeatTimer sync_timer(setup.nrepeat);
+        for (int irep = -1; irep < setup.nrepeat; ++irep) {
+            sync_timer.start(irep);
+            for (auto& mf : field) WarpXCommUtil::OverrideSync(*mf, period);
+        }
+        PrintResult(layout, "NodalSync", max_grid_size, ngrow, field[0]->boxArray().size(),
+                    sync_timer.stop(), GuardBytes(field));
+    }
+
+    void RunBenchmarks ()
+    {
+        const BenchmarkSetup setup = ReadSetup();
+
+        const Box domain(IntVect::TheZeroVector(), setup.n_cell - 1);
+        const RealBox real_box({AMREX_D_DECL(0._rt, 0._rt, 0._rt)}, {AMREX_D_DECL(1._rt, 1._rt, 1._rt)});
+        const Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,1,1)};
+        const Geometry geom(domain, real_box, 0, is_periodic);
+        const Periodicity period = geom.periodicity();
+
+        amrex::Print() << "Communication benchmarks: " << domain.numPts() << " cells, "
+                       << ParallelDescriptor::NProcs() << " MPI ranks, "
+                       << setup.nrepeat << " repetitions\n"
+                       << std::setw(14) << "layout" << std::setw(14) << "operation"
+                       << std::setw(8) << "mgs" << std::setw(7) << "ngrow"
+                       << std::setw(8) << "boxes" << std::setw(14) << "time/call(s)"
+                       << std::setw(12) << "GB/s" << "\n";
+
+        for (int max_grid_size : setup.max_grid_sizes)
+        {
+            BoxArray ba(domain);
+            ba.maxSize(max_grid_size);
+            const DistributionMapping dm(ba);
+
+            // PML: layers of pml_ncell cells around the domain, with split fields (3 components)
+            BoxList pml_boxes = amrex::boxDiff(amrex::grow(domain, setup.pml_ncell), domain);
+            BoxArray pml_ba(pml_boxes);
+            pml_ba.maxSize(max_grid_size);
+            const DistributionMapping pml_dm(pml_ba);
+
+            // Mesh refinement: fine patch on the central half of the domain (refinement
+            // ratio 2), and the corresponding coarse patch
+            const Box fine_region = amrex::refine(
+                Box(domain.smallEnd() + setup.n_cell/4, domain.bigEnd() - setup.n_cell/4), 2);
+            BoxArray fine_ba(fine_region);
+            fine_ba.maxSize(max_grid_size);
+            const DistributionMapping fine_dm(fine_ba);
+            const BoxArray coarse_ba = amrex::coarsen(fine_ba, 2);
+
+            for (int ngrow : setup.ngrows)
+            {
+                for (const auto& layout : setup.layouts)
+                {
+                    if (layout == "E" || layout == "B") {
+                        auto field = MakeVectorField(ba, dm, (layout == "E") ? StaggeringE() : StaggeringB(),
+                                                     1, ngrow);
+                        TimeFillBoundary(setup, layout, field, period, max_grid_size, ngrow);
+                    } else if (layout == "J" || layout == "J_nodal") {
+                        const auto stag = (layout == "J") ? StaggeringE() :
+                            std::array<IntVect,3>{IntVect::TheNodeVector(), IntVect::TheNodeVector(),
+                                                  IntVect::TheNodeVector()};
+                        auto field = MakeVectorField(ba, dm, stag, 1, ngrow);
+                        TimeSumBoundary(setup, layout, field, period, max_grid_size, ngrow);
+                    } else if (layout == "pml") {
+                        auto field = MakeVectorField(pml_ba, pml_dm, StaggeringE(), 3, ngrow);
+                        TimeFillBoundary(setup, layout, field, Periodicity::NonPeriodic(),
+                                         max_grid_size, ngrow);
+                    } else if (layout == "fine_patch") {
+                        auto field = MakeVectorField(fine_ba, fine_dm, StaggeringE(), 1, ngrow);
+                        TimeFillBoundary(setup, layout, field, Periodicity::NonPeriodic(),
+                                         max_grid_size, ngrow);
+                    } else if (layout == "coarse_patch") {
+                        // Copy of the fields of the coarse level to the coarse patch
+                        // (with its guard cells), as with a coarse/fine interpolation
+                        auto src = MakeVectorField(ba, dm, StaggeringE(), 1, ngrow);
+                        auto dst = MakeVectorField(coarse_ba, fine_dm, StaggeringE(), 1, ngrow);
+                        RepeatTimer timer(setup.nrepeat);
+                        for (int irep = -1; irep < setup.nrepeat; ++irep) {
+                            timer.start(irep);
+                            for (int i = 0; i < 3; ++i) {
+                                WarpXCommUtil::ParallelCopy(*dst[i], *src[i], 0, 0, 1,
+                                                            IntVect::TheZeroVector(),
+                                                            dst[i]->nGrowVect(), period);
+                            }
+                        }
+                        double bytes = 0.;
+                        for (const auto& mf : dst) bytes += mf->boxArray().numPts()*sizeof(Real);
+                        bytes += GuardBytes(dst);
+                        PrintResult(layout, "ParallelCopy", max_grid_size, ngrow,
+                                    coarse_ba.size(), timer.stop(), bytes);
+                    } else {
+                        amrex::Abort("Unknown layout " + layout + " in bench.layouts");
+                    }
+                }
+            }
+        }
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    RunBenchmarks();
+    amrex::Finalize();
+    return 0;
+}
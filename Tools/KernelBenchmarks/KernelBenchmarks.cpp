@@ -0,0 +1,463 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+/*
+ * Standalone microbenchmarks of the particle kernels of WarpX (current deposition,
+ * field gather and momentum pushers), run in isolation on synthetic particle
+ * distributions in a single box, for the shape orders given in the inputs.
+ *
+ * Usage: kernel_benchmarks [inputs] [bench.<parameter>=<value> ...]
+ * (see the section on kernel microbenchmarks in Docs/source/developers/profiling.rst)
+ */
+#include "Particles/Deposition/CurrentDeposition.H"
+#include "Particles/Gather/FieldGather.H"
+#include "Particles/Pusher/GetAndSetPosition.H"
+#include "Particles/Pusher/UpdateMomentumBoris.H"
+#include "Particles/Pusher/UpdateMomentumHigueraCary.H"
+#include "Particles/Pusher/UpdateMomentumVay.H"
+#include "Particles/WarpXParticleContainer.H"
+#include "Utils/WarpXAlgorithmSelection.H"
+#include "Utils/WarpXConst.H"
+
+#include <AMReX.H>
+#include <AMReX_Box.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_GpuContainers.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_GpuQualifiers.H>
+#include <AMReX_IntVect.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_REAL.H>
+#include <AMReX_Utility.H>
+#include <AMReX_Vector.H>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace amrex;
+
+namespace
+{
+    using ParticleType = WarpXParticleContainer::ParticleType;
+    using ParticleTileType = WarpXParticleContainer::ParticleTileType;
+
+    /** Parameters of the benchmarks (prefix bench. in the inputs) */
+    struct BenchmarkSetup
+    {
+        IntVect n_cell = IntVect(AMREX_D_DECL(32,32,32));
+        int ppc = 8;
+        std::string distribution = "uniform";
+        bool sorted = false;
+        int nrepeat = 10;
+        std::vector<int> shape_orders = {1, 2, 3};
+        std::vector<std::string> kernels = {"deposition", "esirkepov", "gather",
+                                            "boris", "vay", "higuera"};
+    };
+
+    BenchmarkSetup ReadSetup ()
+    {
+        BenchmarkSetup setup;
+        ParmParse pp_bench("bench");
+
+        Vector<int> n_cell;
+        if (pp_bench.queryarr("n_cell", n_cell)) {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(n_cell.size() == AMREX_SPACEDIM,
+                "bench.n_cell must have one value per dimension");
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) setup.n_cell[idim] = n_cell[idim];
+        }
+        pp_bench.query("ppc", setup.ppc);
+        pp_bench.query("distribution", setup.distribution);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+            setup.distribution == "uniform" || setup.distribution == "clustered",
+            "bench.distribution must be uniform or clustered");
+        pp_bench.query("sorted", setup.sorted);
+        pp_bench.query("nrepeat", setup.nrepeat);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(setup.nrepeat > 0, "bench.nrepeat must be positive");
+        pp_bench.queryarr("shape_orders", setup.shape_orders);
+        for (int order : setup.shape_orders) {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(order >= 1 && order <= 3,
+                "bench.shape_orders must be between 1 and 3");
+        }
+        pp_bench.queryarr("kernels", setup.kernels);
+        return setup;
+    }
+
+    /** Dimension of the 3D arrays (dx, xyzmin, ...) used by the kernels for the index idim */
+    constexpr int KernelDim (int idim)
+    {
+        return (AMREX_SPACEDIM == 2 && idim == 1) ? 2 : idim;
+    }
+
+    /**
+     * \brief Fill tile with ppc particles per cell of domain (on average), either uniformly
+     * distributed or clustered around the center of the domain, in random order or sorted by cell
+     */
+    void InitParticles (const BenchmarkSetup& setup, const Box& domain,
+                        const std::array<Real,3>& dx, ParticleTileType& tile)
+    {
+        const long np = domain.numPts() * setup.ppc;
+
+        std::mt19937 gen(1234);
+        std::uniform_real_distribution<double> uniform(0., 1.);
+        std::normal_distribution<double> normal(0., 1.);
+
+        // Positions in units of the cell sizes
+        std::vector<std::array<double,AMREX_SPACEDIM> > xi(np);
+        for (auto& x : xi) {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                const double length = domain.length(idim);
+                if (setup.distribution == "clustered") {
+                    // Gaussian with an rms width of an eighth of the domain, cut at its edges
+                    do {
+                        x[idim] = 0.5*length + 0.125*length*normal(gen);
+                    } while (x[idim] < 0. || x[idim] >= length);
+                } else {
+                    x[idim] = length*uniform(gen);
+                }
+            }
+        }
+
+        std::vector<long> order(np);
+        std::iota(order.begin(), order.end(), 0);
+        if (setup.sorted) {
+            std::vector<long> cell(np);
+            for (long ip = 0; ip < np; ++ip) {
+                IntVect iv;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    iv[idim] = static_cast<int>(xi[ip][idim]);
+                }
+                cell[ip] = domain.index(iv);
+            }
+            std::stable_sort(order.begin(), order.end(),
+                             [&cell] (long a, long b) { return cell[a] < cell[b]; });
+        }
+
+        const double uth = 0.1*PhysConst::c;
+        std::vector<ParticleType> particles(np);
+        std::array<std::vector<ParticleReal>,PIdx::nattribs> attribs;
+        for (auto& a : attribs) a.resize(np);
+        for (long ip = 0; ip < np; ++ip) {
+            ParticleType& p = particles[ip];
+            p.id() = static_cast<int>(ip + 1);
+            p.cpu() = 0;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                p.pos(idim) = static_cast<ParticleReal>(xi[order[ip]][idim]*dx[KernelDim(idim)]);
+            }
+            attribs[PIdx::w][ip] = 1.e10_prt;
+            attribs[PIdx::ux][ip] = static_cast<ParticleReal>(uth*normal(gen));
+            attribs[PIdx::uy][ip] = static_cast<ParticleReal>(uth*normal(gen));
+            attribs[PIdx::uz][ip] = static_cast<ParticleReal>(uth*normal(gen));
+#ifdef WARPX_DIM_RZ
+            attribs[PIdx::theta][ip] = static_cast<ParticleReal>(2.*MathConst::pi*uniform(gen));
+#endif
+        }
+
+        tile.resize(np);
+        Gpu::copyAsync(Gpu::hostToDevice, particles.begin(), particles.end(),
+                       tile.GetArrayOfStructs()().begin());
+        for (int comp = 0; comp < PIdx::nattribs; ++comp) {
+            Gpu::copyAsync(Gpu::hostToDevice, attribs[comp].begin(), attribs[comp].end(),
+                           tile.GetStructOfArrays().GetRealData(comp).begin());
+        }
+        Gpu::streamSynchronize();
+    }
+
+    /**
+     * \brief Wall time of the kernels, averaged over the repetitions irep = 0, ..., nrepeat-1
+     * (the repetition irep = -1 is a warm-up)
+     */
+    class RepeatTimer
+    {
+    public:
+        explicit RepeatTimer (int nrepeat) : m_nrepeat(nrepeat) {}
+
+        /** \brief Call at the beginning of each repetition irep */
+        void start (int irep)
+        {
+            if (irep == 0) {
+                Gpu::synchronize();
+                m_t0 = amrex::second();
+            }
+        }
+
+        /** \brief Average time per repetition, to be called after the last one */
+        double stop () const
+        {
+            Gpu::synchronize();
+            return (amrex::second() - m_t0) / m_nrepeat;
+        }
+
+    private:
+        int m_nrepeat;
+        double m_t0 = 0.;
+    };
+
+    void PrintResult (const std::string& kernel, int shape_order, long np,
+                      double time, double bytes)
+    {
+        amrex::Print() << std::setw(12) << kernel
+                       << std::setw(7) << ((shape_order > 0) ? std::to_string(shape_order) : "-")
+                       << std::setw(12) << np
+                       << std::setw(14) << std::scientific << std::setprecision(4) << time
+                       << std::setw(14) << np/time
+                       << std::setw(12) << std::fixed << std::setprecision(2) << bytes/time*1.e-9
+                       << std::defaultfloat << "\n";
+    }
+
+    /** Electromagnetic fields and currents on the Yee grid, with guard cells */
+    struct BenchmarkFields
+    {
+        FArrayBox Ex, Ey, Ez, Bx, By, Bz, jx, jy, jz;
+    };
+
+    template <int depos_order>
+    void RunShapeOrder (const BenchmarkSetup& setup, const ParticleTileType& tile,
+                        BenchmarkFields& f, const std::array<Real,3>& dx,
+                        const std::array<Real,3>& xyzmin, const Dim3 lo, const Real dt,
+                        Gpu::DeviceVector<ParticleReal>* fields_on_particles)
+    {
+        const long np = tile.numParticles();
+        const auto& soa = tile.GetStructOfArrays();
+        const ParticleReal* wp = soa.GetRealData(PIdx::w).dataPtr();
+        const ParticleReal* uxp = soa.GetRealData(PIdx::ux).dataPtr();
+        const ParticleReal* uyp = soa.GetRealData(PIdx::uy).dataPtr();
+        const ParticleReal* uzp = soa.GetRealData(PIdx::uz).dataPtr();
+        const auto GetPosition = GetParticlePosition(tile);
+        const Real q = -PhysConst::q_e;
+        const int n_rz_azimuthal_modes = 1;
+        const long costs_algo = LoadBalanceCostsUpdateAlgo::Timers;
+
+        // Bytes read and written per particle, and on the grid
+        const double particle_bytes = sizeof(ParticleType) + (PIdx::nattribs)*sizeof(ParticleReal);
+        const double current_bytes = 2.*(f.jx.nBytes() + f.jy.nBytes() + f.jz.nBytes());
+        const double field_bytes = f.Ex.nBytes() + f.Ey.nBytes() + f.Ez.nBytes()
+                                 + f.Bx.nBytes() + f.By.nBytes() + f.Bz.nBytes();
+
+        for (const auto& kernel : setup.kernels)
+        {
+            double time = -1.;
+            double bytes = 0.;
+            if (kernel == "deposition") {
+                RepeatTimer timer(setup.nrepeat);
+                for (int irep = -1; irep < setup.nrepeat; ++irep) {
+                    timer.start(irep);
+                    doDepositionShapeN<depos_order>(
+                        GetPosition, wp, uxp, uyp, uzp, nullptr, f.jx, f.jy, f.jz, np,
+                        -0.5_rt*dt, dx, xyzmin, lo, q, n_rz_azimuthal_modes,
+                        nullptr, costs_algo);
+                }
+                time = timer.stop();
+                bytes = np*particle_bytes + current_bytes;
+            } else if (kernel == "esirkepov") {
+                const Array4<Real> jx_arr = f.jx.array();
+                const Array4<Real> jy_arr = f.jy.array();
+                const Array4<Real> jz_arr = f.jz.array();
+                RepeatTimer timer(setup.nrepeat);
+                for (int irep = -1; irep < setup.nrepeat; ++irep) {
+                    timer.start(irep);
+                    doEsirkepovDepositionShapeN<depos_order>(
+                        GetPosition, wp, uxp, uyp, uzp, nullptr, jx_arr, jy_arr, jz_arr, np,
+                        dt, dx, xyzmin, lo, q, n_rz_azimuthal_modes,
+                        nullptr, costs_algo);
+                }
+                time = timer.stop();
+                bytes = np*particle_bytes + current_bytes;
+            } else if (kernel == "gather") {
+                const Array4<Real const> ex_arr = f.Ex.const_array();
+                const Array4<Real const> ey_arr = f.Ey.const_array();
+                const Array4<Real const> ez_arr = f.Ez.const_array();
+                const Array4<Real const> bx_arr = f.Bx.const_array();
+                const Array4<Real const> by_arr = f.By.const_array();
+                const Array4<Real const> bz_arr = f.Bz.const_array();
+                const IndexType ex_type = f.Ex.box().ixType();
+                const IndexType ey_type = f.Ey.box().ixType();
+                const IndexType ez_type = f.Ez.box().ixType();
+                const IndexType bx_type = f.Bx.box().ixType();
+                const IndexType by_type = f.By.box().ixType();
+                const IndexType bz_type = f.Bz.box().ixType();
+                const GpuArray<Real,3> dx_arr = {dx[0], dx[1], dx[2]};
+                const GpuArray<Real,3> xyzmin_arr = {xyzmin[0], xyzmin[1], xyzmin[2]};
+                ParticleReal* const Exp = fields_on_particles[0].dataPtr();
+                ParticleReal* const Eyp = fields_on_particles[1].dataPtr();
+                ParticleReal* const Ezp = fields_on_particles[2].dataPtr();
+                ParticleReal* const Bxp = fields_on_particles[3].dataPtr();
+                ParticleReal* const Byp = fields_on_particles[4].dataPtr();
+                ParticleReal* const Bzp = fields_on_particles[5].dataPtr();
+                RepeatTimer timer(setup.nrepeat);
+                for (int irep = -1; irep < setup.nrepeat; ++irep) {
+                    timer.start(irep);
+                    amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (long ip)
+                    {
+                        ParticleReal xp, yp, zp;
+                        GetPosition(ip, xp, yp, zp);
+                        ParticleReal ex = 0._prt, ey = 0._prt, ez = 0._prt;
+                        ParticleReal bx = 0._prt, by = 0._prt, bz = 0._prt;
+                        doGatherShapeN(xp, yp, zp, ex, ey, ez, bx, by, bz,
+                                       ex_arr, ey_arr, ez_arr, bx_arr, by_arr, bz_arr,
+                                       ex_type, ey_type, ez_type, bx_type, by_type, bz_type,
+                                       dx_arr, xyzmin_arr, lo, n_rz_azimuthal_modes,
+                                       depos_order, false);
+                        Exp[ip] = ex;
+                        Eyp[ip] = ey;
+                        Ezp[ip] = ez;
+                        Bxp[ip] = bx;
+                        Byp[ip] = by;
+                        Bzp[ip] = bz;
+                    });
+                }
+                time = timer.stop();
+                bytes = np*(sizeof(ParticleType) + 6.*sizeof(ParticleReal)) + field_bytes;
+            }
+            if (time >= 0.) PrintResult(kernel, depos_order, np, time, bytes);
+        }
+    }
+
+    void RunPushers (const BenchmarkSetup& setup, ParticleTileType& tile, const Real dt,
+                     Gpu::DeviceVector<ParticleReal>* fields_on_particles)
+    {
+        const long np = tile.numParticles();
+        auto& soa = tile.GetStructOfArrays();
+        ParticleReal* const ux = soa.GetRealData(PIdx::ux).dataPtr();
+        ParticleReal* const uy = soa.GetRealData(PIdx::uy).dataPtr();
+        ParticleReal* const uz = soa.GetRealData(PIdx::uz).dataPtr();
+        const ParticleReal* const Exp = fields_on_particles[0].dataPtr();
+        const ParticleReal* const Eyp = fields_on_particles[1].dataPtr();
+        const ParticleReal* const Ezp = fields_on_particles[2].dataPtr();
+        const ParticleReal* const Bxp = fields_on_particles[3].dataPtr();
+        const ParticleReal* const Byp = fields_on_particles[4].dataPtr();
+        const ParticleReal* const Bzp = fields_on_particles[5].dataPtr();
+        const Real q = -PhysConst::q_e;
+        const Real m = PhysConst::m_e;
+
+        // The momenta are read and written, the fields on the particles are read
+        const double bytes = np*12.*sizeof(ParticleReal);
+
+        for (const auto& kernel : setup.kernels)
+        {
+            double time = -1.;
+            if (kernel == "boris") {
+                RepeatTimer timer(setup.nrepeat);
+                for (int irep = -1; irep < setup.nrepeat; ++irep) {
+                    timer.start(irep);
+                    amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (long ip)
+                    {
+                        UpdateMomentumBoris(ux[ip], uy[ip], uz[ip], Exp[ip], Eyp[ip], Ezp[ip],
+                                            Bxp[ip], Byp[ip], Bzp[ip], q, m, dt);
+                    });
+                }
+                time = timer.stop();
+            } else if (kernel == "vay") {
+                RepeatTimer timer(setup.nrepeat);
+                for (int irep = -1; irep < setup.nrepeat; ++irep) {
+                    timer.start(irep);
+                    amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (long ip)
+                    {
+                        UpdateMomentumVay(ux[ip], uy[ip], uz[ip], Exp[ip], Eyp[ip], Ezp[ip],
+                                          Bxp[ip], Byp[ip], Bzp[ip], q, m, dt);
+                    });
+                }
+                time = timer.stop();
+            } else if (kernel == "higuera") {
+                RepeatTimer timer(setup.nrepeat);
+                for (int irep = -1; irep < setup.nrepeat; ++irep) {
+                    timer.start(irep);
+                    amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (long ip)
+                    {
+                        UpdateMomentumHigueraCary(ux[ip], uy[ip], uz[ip], Exp[ip], Eyp[ip], Ezp[ip],
+                                                  Bxp[ip], Byp[ip], Bzp[ip], q, m, dt);
+                    });
+                }
+                time = timer.stop();
+            }
+            if (time >= 0.) PrintResult(kernel, 0, np, time, bytes);
+        }
+    }
+
+    void RunBenchmarks ()
+    {
+        const BenchmarkSetup setup = ReadSetup();
+
+        const Box domain(IntVect::TheZeroVector(), setup.n_cell - 1);
+        const std::array<Real,3> dx = {1.e-6_rt, 1.e-6_rt, 1.e-6_rt};
+        // Time step at half the CFL limit of the Yee solver (with the same cell size in all directions)
+        const Real dt = 0.5_rt * dx[0] / (PhysConst::c * std::sqrt(static_cast<Real>(AMREX_SPACEDIM)));
+
+        ParticleTileType tile;
+        InitParticles(setup, domain, dx, tile);
+        const long np = tile.numParticles();
+
+        // Fields on the Yee grid, with enough guard cells for the highest shape order
+        const int ng = 4;
+        const Box gbx = amrex::grow(domain, ng);
+#if defined(WARPX_DIM_3D)
+        const IntVect ex_stag(0,1,1), ey_stag(1,0,1), ez_stag(1,1,0);
+        const IntVect bx_stag(1,0,0), by_stag(0,1,0), bz_stag(0,0,1);
+#else
+        const IntVect ex_stag(0,1), ey_stag(1,1), ez_stag(1,0);
+        const IntVect bx_stag(1,0), by_stag(0,0), bz_stag(0,1);
+#endif
+        BenchmarkFields f;
+        f.Ex.resize(amrex::convert(gbx, ex_stag));
+        f.Ey.resize(amrex::convert(gbx, ey_stag));
+        f.Ez.resize(amrex::convert(gbx, ez_stag));
+        f.Bx.resize(amrex::convert(gbx, bx_stag));
+        f.By.resize(amrex::convert(gbx, by_stag));
+        f.Bz.resize(amrex::convert(gbx, bz_stag));
+        f.jx.resize(amrex::convert(gbx, ex_stag));
+        f.jy.resize(amrex::convert(gbx, ey_stag));
+        f.jz.resize(amrex::convert(gbx, ez_stag));
+        for (FArrayBox* fab : {&f.Ex, &f.Ey, &f.Ez}) fab->setVal<RunOn::Device>(1.e6_rt);
+        for (FArrayBox* fab : {&f.Bx, &f.By, &f.Bz}) fab->setVal<RunOn::Device>(1.e-2_rt);
+        for (FArrayBox* fab : {&f.jx, &f.jy, &f.jz}) fab->setVal<RunOn::Device>(0._rt);
+
+        // Lower corner (including the guard cells) and lower index of the field arrays
+        std::array<Real,3> xyzmin = {0._rt, 0._rt, 0._rt};
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            xyzmin[KernelDim(idim)] = gbx.smallEnd(idim)*dx[KernelDim(idim)];
+        }
+        const Dim3 lo = amrex::lbound(gbx);
+
+        Gpu::DeviceVector<ParticleReal> fields_on_particles[6];
+        for (auto& v : fields_on_particles) {
+            v.resize(np, 0._prt);
+        }
+
+        amrex::Print() << "Kernel benchmarks: " << np << " particles in " << domain.numPts()
+                       << " cells (" << setup.distribution << ", "
+                       << (setup.sorted ? "sorted" : "unsorted") << "), "
+                       << setup.nrepeat << " repetitions\n"
+                       << std::setw(12) << "kernel" << std::setw(7) << "order"
+                       << std::setw(12) << "particles" << std::setw(14) << "time/call(s)"
+                       << std::setw(14) << "particles/s" << std::setw(12) << "GB/s" << "\n";
+
+        for (int order : setup.shape_orders) {
+            if (order == 1) {
+                RunShapeOrder<1>(setup, tile, f, dx, xyzmin, lo, dt, fields_on_particles);
+            } else if (order == 2) {
+                RunShapeOrder<2>(setup, tile, f, dx, xyzmin, lo, dt, fields_on_particles);
+            } else if (order == 3) {
+                RunShapeOrder<3>(setup, tile, f, dx, xyzmin, lo, dt, fields_on_particles);
+            }
+        }
+        RunPushers(setup, tile, dt, fields_on_particles);
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    RunBenchmarks();
+    amrex::Finalize();
+    return 0;
+}
@@ -0,0 +1,258 @@
+#!/usr/bin/env python3
+#
+# Copyright 2022 The WarpX Community
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+Portable performance regression harness.
+
+Runs a set of input decks (``perf_regression_tests.json``) at a fixed number of
+steps, extracts the TinyProfiler timings of each run (per region and per phase
+of the PIC loop, normalized per step) into a JSON file, and compares such a
+file against a stored baseline with relative thresholds.
+
+Only the Python standard library is needed: no machine-specific modules.
+
+    # run the tests, store the timings
+    python perf_regression.py run --exe /path/to/warpx.3d --output new.json \
+        --launcher "mpiexec -n 2"
+    # extract the timings of an existing run (standard output of WarpX)
+    python perf_regression.py parse --log run.log --n_step 10 --output new.json
+    # compare against a baseline (exits with 1 in case of a regression)
+    python perf_regression.py compare --baseline baseline.json --new new.json
+"""
+
+import argparse
+import datetime
+import json
+import os
+import re
+import shlex
+import socket
+import subprocess
+import sys
+
+# Phases of the PIC loop: each TinyProfiler region is counted (with its
+# exclusive time) in the first phase whose pattern matches its name
+phase_patterns = [
+    ('push', r'GatherAndPush|ParticlePush|PushP|PushX|PushInteriorParticles'),
+    ('deposition', r'CurrentDeposition|ChargeDeposition|DepositCurrent|DepositCharge'),
+    ('field_solve', r'EvolveE|EvolveB|EvolveF|EvolveG|EvolveEBFused|SpectralSolver|'
+                    r'DampPML|DampJPML|Hybrid_QED_Push|FFTPoissonSolver|Filter::'),
+    ('communication', r'FillBoundary|ParallelCopy|SumBoundary|ParallelAdd|Redistribute|'
+                      r'PML::Exchange|SyncCurrent|SyncRho|UpdateAuxilaryData|OverrideSync|'
+                      r'WarpXCommUtil'),
+    ('diagnostics', r'Diagnostics|FlushFormat|OpenPMD|BackTransformed|Plotfile|VisMF|'
+                    r'^output_|WriteParticles|Checkpoint'),
+    ('load_balance', r'LoadBalance|RemakeLevel'),
+    ('collisions_qed', r'Collision|Ionization|doQed|Schwinger|Resampling'),
+]
+
+def parse_tiny_profiler(text):
+    """
+    Return the total time and the exclusive and inclusive tables of the
+    TinyProfiler output in text, as dictionaries
+    {region: {'ncalls', 'min', 'avg', 'max'}} (times in seconds)
+    """
+    match = re.search(r'TinyProfiler total time across processes \[min\.\.\.avg\.\.\.max\]: '
+                      r'(\S+) \.\.\. (\S+) \.\.\. (\S+)', text)
+    if match is None:
+        raise RuntimeError('No TinyProfiler output found '
+                           '(was WarpX compiled with AMReX_TINY_PROFILE?)')
+    total_time = float(match.group(3))
+
+    tables = {}
+    for kind in ['Excl', 'Incl']:
+        header = re.search(r'\n\s*Name\s+NCalls\s+' + kind + r'\. Min\s+' + kind +
+                           r'\. Avg\s+' + kind + r'\. Max\s+Max %', text)
+        regions = {}
+        if header is not None:
+            lines = text[header.end():].split('\n')
+            # Skip the separator after the header, stop at the one after the table
+            for line in lines[2:]:
+                if line.startswith('---') or not line.strip():
+                    break
+                words = line.split()
+                if len(words) < 6:
+                    break
+                name = ' '.join(words[:-5])
+                regions[name] = {'ncalls': int(words[-5]),
+                                 'min': float(words[-4]),
+                                 'avg': float(words[-3]),
+                                 'max': float(words[-2])}
+        tables[kind] = regions
+    return total_time, tables['Excl'], tables['Incl']
+
+def extract_timings(text, n_step):
+    """Timings of a run (standard output text, n_step steps), per step where relevant"""
+    total_time, exclusive, inclusive = parse_tiny_profiler(text)
+    evolve = inclusive.get('WarpX::Evolve()', {'max': 0.})['max']
+
+    phases = {name: 0. for name, _ in phase_patterns}
+    phases['other'] = 0.
+    for region, timing in exclusive.items():
+        for name, pattern in phase_patterns:
+            if re.search(pattern, region):
+                phases[name] += timing['max']
+                break
+        else:
+            phases['other'] += timing['max']
+
+    return {
+        'n_step': n_step,
+        'total_time': total_time,
+        'init_time': total_time - evolve,
+        'time_per_step': evolve / n_step,
+        'phases_per_step': {name: t / n_step for name, t in phases.items()},
+        'regions_per_step': {region: {key: (value / n_step if key != 'ncalls' else value)
+                                      for key, value in timing.items()}
+                             for region, timing in exclusive.items()},
+    }
+
+def get_metadata(exe=None, launcher=None):
+    metadata = {'date': datetime.datetime.now().isoformat(timespec='seconds'),
+                'hostname': socket.gethostname()}
+    if exe is not None:
+        metadata['executable'] = os.path.abspath(exe)
+    if launcher is not None:
+        metadata['launcher'] = launcher
+    source_dir = os.path.dirname(os.path.abspath(__file__))
+    try:
+        metadata['git_hash'] = subprocess.check_output(
+            ['git', 'rev-parse', 'HEAD'], cwd=source_dir,
+            stderr=subprocess.DEVNULL).decode().strip()
+    except (OSError, subprocess.CalledProcessError):
+        pass
+    return metadata
+
+def write_results(filename, results):
+    with open(filename, 'w') as f:
+        json.dump(results, f, indent=2, sort_keys=True)
+    print('Timings written to ' + filename)
+
+def run_tests(args):
+    this_dir = os.path.dirname(os.path.abspath(__file__))
+    with open(args.tests_file) as f:
+        tests = json.load(f)
+    if args.tests:
+        tests = [test for test in tests if test['name'] in args.tests.split(',')]
+
+    results = {'metadata': get_metadata(args.exe, args.launcher), 'tests': {}}
+    for test in tests:
+        run_dir = os.path.join(os.path.abspath(args.run_dir), test['name'])
+        os.makedirs(run_dir, exist_ok=True)
+        n_step = test['n_step'] if args.n_step is None else args.n_step
+        command = shlex.split(args.launcher) if args.launcher else []
+        command += [os.path.abspath(args.exe),
+                    os.path.join(this_dir, test['input_file']),
+                    'max_step=' + str(n_step),
+                    'amr.n_cell=' + ' '.join(str(n) for n in test['n_cell']),
+                    'amr.max_grid_size=' + str(test['max_grid_size']),
+                    'amr.blocking_factor=' + str(test['blocking_factor'])]
+        command += shlex.split(args.extra_args)
+        print('Running ' + test['name'] + ': ' + ' '.join(command))
+        process = subprocess.run(command, cwd=run_dir, stdout=subprocess.PIPE,
+                                 stderr=subprocess.STDOUT)
+        output = process.stdout.decode(errors='replace')
+        with open(os.path.join(run_dir, 'output.txt'), 'w') as f:
+            f.write(output)
+        if process.returncode != 0:
+            print('  failed with exit code ' + str(process.returncode) +
+                  ' (see ' + os.path.join(run_dir, 'output.txt') + ')')
+            continue
+        results['tests'][test['name']] = extract_timings(output, n_step)
+        print('  {:.4g} s per step'.format(results['tests'][test['name']]['time_per_step']))
+    write_results(args.output, results)
+
+def parse_log(args):
+    with open(args.log) as f:
+        text = f.read()
+    name = args.name if args.name else os.path.splitext(os.path.basename(args.log))[0]
+    results = {'metadata': get_metadata(), 'tests': {name: extract_timings(text, args.n_step)}}
+    write_results(args.output, results)
+
+def compare(args):
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    with open(args.new) as f:
+        new = json.load(f)
+
+    regressions = []
+    print('{:<24} {:<44} {:>12} {:>12} {:>9}'.format(
+        'test', 'timer (per step)', 'baseline (s)', 'new (s)', 'change'))
+    for test, base in sorted(baseline['tests'].items()):
+        if test not in new['tests']:
+            print('{:<24} missing from {}'.format(test, args.new))
+            regressions.append((test, 'missing'))
+            continue
+        current = new['tests'][test]
+        timers = [('time_per_step', base['time_per_step'], current['time_per_step'])]
+        timers += [('phase ' + phase, t, current['phases_per_step'].get(phase, 0.))
+                   for phase, t in sorted(base['phases_per_step'].items())]
+        if args.regions:
+            timers += [(region, t['max'], current['regions_per_step'].get(region, {'max': 0.})['max'])
+                       for region, t in sorted(base['regions_per_step'].items())]
+        for timer, t_base, t_new in timers:
+            # Timers that are too small are dominated by noise
+            if max(t_base, t_new) < args.min_time:
+                continue
+            change = (t_new - t_base) / t_base if t_base > 0. else float('inf')
+            flag = ''
+            if change > args.threshold:
+                flag = '  <-- regression'
+                regressions.append((test, timer))
+            print('{:<24} {:<44} {:>12.4g} {:>12.4g} {:>+8.1f}%{}'.format(
+                test, timer[:44], t_base, t_new, 100.*change, flag))
+
+    if regressions:
+        print('\n{} timer(s) slower than the baseline by more than {:.0f}%'.format(
+            len(regressions), 100.*args.threshold))
+        sys.exit(1)
+    print('\nNo performance regression (threshold: {:.0f}%)'.format(100.*args.threshold))
+
+if __name__ == '__main__':
+    this_dir = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description='WarpX performance regression harness')
+    subparsers = parser.add_subparsers(dest='command')
+    subparsers.required = True
+
+    parser_run = subparsers.add_parser('run', help='run the tests and store their timings')
+    parser_run.add_argument('--exe', required=True, help='WarpX executable')
+    parser_run.add_argument('--launcher', default='',
+                            help='MPI launcher command, e.g. "mpiexec -n 4"')
+    parser_run.add_argument('--tests_file', default=os.path.join(this_dir, 'perf_regression_tests.json'),
+                            help='JSON file with the list of tests')
+    parser_run.add_argument('--tests', default=None,
+                            help='comma-separated names of the tests to run (default: all)')
+    parser_run.add_argument('--n_step', type=int, default=None,
+                            help='number of steps of each test (default: from the tests file)')
+    parser_run.add_argument('--extra_args', default='',
+                            help='additional runtime parameters passed to WarpX')
+    parser_run.add_argument('--run_dir', default='perf_regression_runs',
+                            help='directory in which the tests are run')
+    parser_run.add_argument('--output', default='perf_regression.json', help='output JSON file')
+    parser_run.set_defaults(func=run_tests)
+
+    parser_parse = subparsers.add_parser('parse', help='extract the timings of an existing run')
+    parser_parse.add_argument('--log', required=True, help='standard output of the run')
+    parser_parse.add_argument('--n_step', type=int, required=True, help='number of steps of the run')
+    parser_parse.add_argument('--name', default=None, help='name of the test (default: from the log)')
+    parser_parse.add_argument('--output', default='perf_regression.json', help='output JSON file')
+    parser_parse.set_defaults(func=parse_log)
+
+    parser_compare = subparsers.add_parser('compare', help='compare timings against a baseline')
+    parser_compare.add_argument('--baseline', required=True, help='JSON file of the baseline')
+    parser_compare.add_argument('--new', required=True, help='JSON file of the new timings')
+    parser_compare.add_argument('--threshold', type=float, default=0.1,
+                                help='relative slowdown above which a timer is a regression')
+    parser_compare.add_argument('--min_time', type=float, default=1.e-3,
+                                help='timers below this time per step (s) are ignored')
+    parser_compare.add_argument('--regions', action='store_true',
+                                help='also compare each TinyProfiler region')
+    parser_compare.set_defaults(func=compare)
+
+    args = parser.parse_args()
+    args.func(args)
@@ -182,6 +182,10 @@ function(set_warpx_binary_name)
             set_property(TARGET ${tgt} APPEND_STRING PROPERTY OUTPUT_NAME ".SP")
         endif()
 
+        if(NOT WarpX_PARTICLE_PRECISION STREQUAL WarpX_PRECISION)
+            set_property(TARGET ${tgt} APPEND_STRING PROPERTY OUTPUT_NAME ".pSP")
+        endif()
+
         if(WarpX_ASCENT)
             set_property(TARGET ${tgt} APPEND_STRING PROPERTY OUTPUT_NAME ".ASCENT")
         endif()
@@ -343,6 +347,7 @@ function(warpx_print_summary)
     message("    Embedded Boundary: ${WarpX_EB}")
     message("    GPU clock timers: ${WarpX_GPUCLOCK}")
     message("    IPO/LTO: ${WarpX_IPO}")
+    message("    Kernel benchmarks: ${WarpX_KERNEL_BENCHMARKS}")
     message("    LIB: ${WarpX_LIB}${LIB_TYPE}")
     message("    MPI: ${WarpX_MPI}")
     if(MPI)
@@ -350,6 +355,7 @@ function(warpx_print_summary)
     endif()
     message("    PSATD: ${WarpX_PSATD}")
     message("    PRECISION: ${WarpX_PRECISION}")
+    message("    PARTICLE PRECISION: ${WarpX_PARTICLE_PRECISION}")
     message("    OPENPMD: ${WarpX_OPENPMD}")
     message("    QED: ${WarpX_QED}")
     message("    QED table generation: ${WarpX_QED_TABLE_GEN}")
@@ -90,6 +90,7 @@ class CMakeBuild(build_ext):
             '-DWarpX_EB:BOOL=' + WARPX_EB,
             '-DWarpX_OPENPMD:BOOL=' + WARPX_OPENPMD,
             '-DWarpX_PRECISION=' + WARPX_PRECISION,
+            '-DWarpX_PARTICLE_PRECISION=' + WARPX_PARTICLE_PRECISION,
             '-DWarpX_PSATD:BOOL=' + WARPX_PSATD,
             '-DWarpX_QED:BOOL=' + WARPX_QED,
             '-DWarpX_QED_TABLE_GEN:BOOL=' + WARPX_QED_TABLE_GEN,
@@ -186,6 +187,7 @@ WARPX_MPI = env.pop('WARPX_MPI', 'OFF')
 WARPX_EB = env.pop('WARPX_EB', 'OFF')
 WARPX_OPENPMD = env.pop('WARPX_OPENPMD', 'OFF')
 WARPX_PRECISION = env.pop('WARPX_PRECISION', 'DOUBLE')
+WARPX_PARTICLE_PRECISION = env.pop('WARPX_PARTICLE_PRECISION', WARPX_PRECISION)
 WARPX_PSATD = env.pop('WARPX_PSATD', 'OFF')
 WARPX_QED = env.pop('WARPX_QED', 'ON')
 WARPX_QED_TABLE_GEN = env.pop('WARPX_QED_TABLE_GEN', 'OFF')